@@ -0,0 +1,482 @@
+/**
+ * OpenMP Construct Overhead Microbenchmark
+ * Measures what each OpenMP construct costs, in the style of the EPCC
+ * syncbench/schedbench suites
+ *
+ * Every test runs a short delay loop inside the construct, innerReps times.
+ * The same delays run sequentially are the reference, and
+ *     overhead = (test time - reference time) / innerReps
+ * innerReps is doubled until one test takes the target time (1 ms by default),
+ * and each test is repeated outerReps times for the mean, standard deviation
+ * and minimum.
+ *
+ * Compilation instructions:
+ * - For GCC/G++: g++ -O2 -fopenmp openmp_overhead_bench.cpp -o openmp_overhead_bench
+ * - For MSVC: cl /O2 /EHsc /openmp:llvm openmp_overhead_bench.cpp
+ *   (plain /openmp is OpenMP 2.0: the task test is skipped)
+ *
+ * Usage:
+ *   openmp_overhead_bench [--threads 1,2,4,8] [--wait-policy current|active|passive|both]
+ *                         [--outer-reps 20] [--target-us 1000] [--delay-us 0.1]
+ *                         [--json construct_overheads.json]
+ */
+
+#include <algorithm>  // For std::min_element
+#include <cmath>      // For std::sqrt
+#include <cstdio>     // For std::remove
+#include <cstdlib>    // For std::getenv, std::system, std::atoi
+#include <fstream>    // For the JSON file
+#include <functional> // For std::function
+#include <iomanip>    // For table formatting
+#include <iostream>   // For standard input/output operations
+#include <sstream>    // For reading back child results
+#include <string>
+#include <vector>
+#include <omp.h>      // OpenMP header for parallel programming directives
+
+namespace {
+
+struct Options {
+    std::vector<int> threads;               // Empty: powers of two up to the number of processors
+    std::vector<std::string> policies;      // Empty: the policy this process was started with
+    int outerReps = 20;
+    double targetUs = 1000.0;               // Length of one timed test
+    double delayUs = 0.1;                   // Work inside each construct
+    std::string jsonFile = "construct_overheads.json";
+    bool child = false;                     // Started by a --wait-policy sweep; write one run object
+};
+
+struct Result {
+    std::string construct;
+    int threads;
+    long innerReps;
+    double overheadNs;                      // Mean test time per repetition minus the reference
+    double stddevNs;
+    double minNs;                           // Fastest test per repetition minus the reference
+};
+
+// Sink for the delay loop, so the compiler keeps it
+volatile double g_sink = 0.0;
+
+// EPCC delay: a floating-point add chain the compiler cannot shorten
+void delay(int length) {
+    double a = 0.0;
+    for (int i = 0; i < length; i++) {
+        a += i;
+    }
+    if (a < 0.0) {
+        g_sink = a;
+    }
+}
+
+// Delay loop length that takes delayUs
+int calibrateDelay(double delayUs) {
+    const int reps = 10000;
+    int length = 1;
+    for (;;) {
+        double start = omp_get_wtime();
+        for (int i = 0; i < reps; i++) {
+            delay(length);
+        }
+        double perDelayUs = (omp_get_wtime() - start) * 1e6 / reps;
+        if (perDelayUs >= delayUs) {
+            return length;
+        }
+        length = static_cast<int>(length * 1.1) + 1;
+    }
+}
+
+class OverheadBench {
+public:
+    using Test = std::function<void(long innerReps)>;
+
+    OverheadBench(const Options& options, int delayLength)
+        : m_options(options), m_delayLength(delayLength) {}
+
+    int delayLength() const { return m_delayLength; }
+
+    // Smallest power-of-two innerReps whose test takes the target time
+    long calibrate(const Test& test) const {
+        long innerReps = 1;
+        for (;;) {
+            double start = omp_get_wtime();
+            test(innerReps);
+            double elapsedUs = (omp_get_wtime() - start) * 1e6;
+            if (elapsedUs >= m_options.targetUs || innerReps >= (1L << 30)) {
+                return innerReps;
+            }
+            innerReps *= 2;
+        }
+    }
+
+    // Mean, standard deviation and minimum test time per repetition, in nanoseconds
+    void time(const Test& test, long innerReps, double& meanNs, double& stddevNs, double& minNs) const {
+        std::vector<double> samples;
+        test(innerReps);    // Warm up: threads created, pages touched
+        for (int rep = 0; rep < m_options.outerReps; rep++) {
+            double start = omp_get_wtime();
+            test(innerReps);
+            samples.push_back((omp_get_wtime() - start) * 1e9 / innerReps);
+        }
+        double sum = 0.0;
+        for (double sample : samples) {
+            sum += sample;
+        }
+        meanNs = sum / samples.size();
+        double squares = 0.0;
+        for (double sample : samples) {
+            squares += (sample - meanNs) * (sample - meanNs);
+        }
+        stddevNs = samples.size() > 1 ? std::sqrt(squares / (samples.size() - 1)) : 0.0;
+        minNs = *std::min_element(samples.begin(), samples.end());
+    }
+
+    Result measure(const std::string& construct, int threads, const Test& test, double referenceNs) const {
+        Result result;
+        result.construct = construct;
+        result.threads = threads;
+        result.innerReps = calibrate(test);
+        double meanNs = 0.0;
+        time(test, result.innerReps, meanNs, result.stddevNs, result.minNs);
+        result.overheadNs = meanNs - referenceNs;
+        result.minNs -= referenceNs;
+        return result;
+    }
+
+private:
+    const Options& m_options;
+    int m_delayLength;
+};
+
+std::string waitPolicyName() {
+    const char* policy = std::getenv("OMP_WAIT_POLICY");
+    return policy ? policy : "default";
+}
+
+// Every construct at one thread count
+std::vector<Result> runConstructs(const OverheadBench& bench, int threads) {
+    const int length = bench.delayLength();
+    omp_set_num_threads(threads);
+    std::vector<Result> results;
+
+    // Reference: the delays alone, on one thread
+    double referenceNs = 0.0;
+    double stddevNs = 0.0;
+    double minNs = 0.0;
+    OverheadBench::Test reference = [length](long n) {
+        for (long j = 0; j < n; j++) {
+            delay(length);
+        }
+    };
+    bench.time(reference, bench.calibrate(reference), referenceNs, stddevNs, minNs);
+
+    // Fork and join of a team
+    results.push_back(bench.measure("parallel", threads, [length](long n) {
+        for (long j = 0; j < n; j++) {
+            #pragma omp parallel
+            {
+                delay(length);
+            }
+        }
+    }, referenceNs));
+
+    // Work-sharing loop, one iteration per thread, with its implicit barrier
+    results.push_back(bench.measure("for (static)", threads, [length](long n) {
+        #pragma omp parallel
+        {
+            int team = omp_get_num_threads();
+            for (long j = 0; j < n; j++) {
+                #pragma omp for schedule(static)
+                for (int i = 0; i < team; i++) {
+                    delay(length);
+                }
+            }
+        }
+    }, referenceNs));
+
+    results.push_back(bench.measure("for (dynamic,1)", threads, [length](long n) {
+        #pragma omp parallel
+        {
+            int team = omp_get_num_threads();
+            for (long j = 0; j < n; j++) {
+                #pragma omp for schedule(dynamic, 1)
+                for (int i = 0; i < team; i++) {
+                    delay(length);
+                }
+            }
+        }
+    }, referenceNs));
+
+    results.push_back(bench.measure("barrier", threads, [length](long n) {
+        #pragma omp parallel
+        {
+            for (long j = 0; j < n; j++) {
+                delay(length);
+                #pragma omp barrier
+            }
+        }
+    }, referenceNs));
+
+    results.push_back(bench.measure("single", threads, [length](long n) {
+        #pragma omp parallel
+        {
+            for (long j = 0; j < n; j++) {
+                #pragma omp single
+                {
+                    delay(length);
+                }
+            }
+        }
+    }, referenceNs));
+
+    // Mutual exclusion: n delays in total, split over the team, all serialized
+    results.push_back(bench.measure("critical", threads, [length](long n) {
+        #pragma omp parallel
+        {
+            long mine = n / omp_get_num_threads();
+            for (long j = 0; j < mine; j++) {
+                #pragma omp critical
+                {
+                    delay(length);
+                }
+            }
+        }
+    }, referenceNs));
+
+    omp_lock_t lock;
+    omp_init_lock(&lock);
+    results.push_back(bench.measure("lock/unlock", threads, [length, &lock](long n) {
+        #pragma omp parallel
+        {
+            long mine = n / omp_get_num_threads();
+            for (long j = 0; j < mine; j++) {
+                omp_set_lock(&lock);
+                delay(length);
+                omp_unset_lock(&lock);
+            }
+        }
+    }, referenceNs));
+    omp_destroy_lock(&lock);
+
+    // Atomic update against a plain one; no delay, the update is the work
+    double shared = 0.0;
+    double atomicReferenceNs = 0.0;
+    OverheadBench::Test plainUpdate = [&shared](long n) {
+        for (long j = 0; j < n; j++) {
+            shared += 1.0;
+            g_sink = shared;
+        }
+    };
+    bench.time(plainUpdate, bench.calibrate(plainUpdate), atomicReferenceNs, stddevNs, minNs);
+    results.push_back(bench.measure("atomic", threads, [&shared](long n) {
+        #pragma omp parallel
+        {
+            long mine = n / omp_get_num_threads();
+            for (long j = 0; j < mine; j++) {
+                #pragma omp atomic
+                shared += 1.0;
+            }
+        }
+    }, atomicReferenceNs));
+
+    // Reduction clause, including the fork and join it comes with
+    results.push_back(bench.measure("reduction", threads, [length](long n) {
+        double total = 0.0;
+        for (long j = 0; j < n; j++) {
+            #pragma omp parallel reduction(+:total)
+            {
+                delay(length);
+                total += 1.0;
+            }
+        }
+        g_sink = total;
+    }, referenceNs));
+
+#if _OPENMP >= 200805
+    // Task creation and execution: every thread spawns n tasks
+    results.push_back(bench.measure("task spawn", threads, [length](long n) {
+        #pragma omp parallel
+        {
+            for (long j = 0; j < n; j++) {
+                #pragma omp task
+                {
+                    delay(length);
+                }
+            }
+        }
+    }, referenceNs));
+#endif
+
+    return results;
+}
+
+void printTable(const std::vector<Result>& results, const std::string& policy) {
+    std::cout << "\nOMP_WAIT_POLICY=" << policy << std::endl;
+    std::cout << std::left << std::setw(18) << "Construct"
+              << std::right << std::setw(8) << "Threads"
+              << std::right << std::setw(14) << "Overhead(ns)"
+              << std::right << std::setw(12) << "StdDev(ns)"
+              << std::right << std::setw(12) << "Min(ns)"
+              << std::right << std::setw(12) << "InnerReps" << std::endl;
+    std::cout << std::string(76, '-') << std::endl;
+    for (const Result& r : results) {
+        std::cout << std::left << std::setw(18) << r.construct
+                  << std::right << std::setw(8) << r.threads
+                  << std::right << std::setw(14) << std::fixed << std::setprecision(1) << r.overheadNs
+                  << std::right << std::setw(12) << std::fixed << std::setprecision(1) << r.stddevNs
+                  << std::right << std::setw(12) << std::fixed << std::setprecision(1) << r.minNs
+                  << std::right << std::setw(12) << r.innerReps << std::endl;
+    }
+}
+
+// One run object: {"wait_policy": ..., "results": [...]}
+std::string runJson(const std::vector<Result>& results, const std::string& policy) {
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(1);
+    json << "    {\n      \"wait_policy\": \"" << policy << "\",\n      \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        json << "        {\"construct\": \"" << r.construct << "\", \"threads\": " << r.threads
+             << ", \"inner_reps\": " << r.innerReps << ", \"overhead_ns\": " << r.overheadNs
+             << ", \"stddev_ns\": " << r.stddevNs << ", \"min_ns\": " << r.minNs << "}"
+             << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    json << "      ]\n    }";
+    return json.str();
+}
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+std::string joinThreads(const std::vector<int>& threads) {
+    std::string text;
+    for (size_t i = 0; i < threads.size(); i++) {
+        text += (i > 0 ? "," : "") + std::to_string(threads[i]);
+    }
+    return text;
+}
+
+// OMP_WAIT_POLICY is read once at startup, so each policy needs its own process
+bool runWithPolicy(const char* program, const Options& options, const std::string& policy,
+                   const std::string& runFile) {
+    std::ostringstream args;
+    args << "\"" << program << "\" --child --threads " << joinThreads(options.threads)
+         << " --outer-reps " << options.outerReps << " --target-us " << options.targetUs
+         << " --delay-us " << options.delayUs << " --json \"" << runFile << "\"";
+#ifdef _WIN32
+    std::string command = "cmd /C \"set OMP_WAIT_POLICY=" + policy + "&& " + args.str() + "\"";
+#else
+    std::string command = "OMP_WAIT_POLICY=" + policy + " " + args.str();
+#endif
+    return std::system(command.c_str()) == 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        std::string value = i + 1 < argc ? argv[i + 1] : "";
+        if (arg == "--threads") {
+            for (const std::string& item : splitList(value)) {
+                options.threads.push_back(std::max(1, std::atoi(item.c_str())));
+            }
+            i++;
+        } else if (arg == "--wait-policy") {
+            if (value == "both") {
+                options.policies = {"active", "passive"};
+            } else if (value != "current") {
+                options.policies = {value};
+            }
+            i++;
+        } else if (arg == "--outer-reps") {
+            options.outerReps = std::max(1, std::atoi(value.c_str()));
+            i++;
+        } else if (arg == "--target-us") {
+            options.targetUs = std::atof(value.c_str());
+            i++;
+        } else if (arg == "--delay-us") {
+            options.delayUs = std::atof(value.c_str());
+            i++;
+        } else if (arg == "--json") {
+            options.jsonFile = value;
+            i++;
+        } else if (arg == "--child") {
+            options.child = true;
+        } else {
+            std::cout << "Usage: " << argv[0] << " [--threads 1,2,4] [--wait-policy current|active|passive|both]\n"
+                      << "       [--outer-reps 20] [--target-us 1000] [--delay-us 0.1] [--json FILE]" << std::endl;
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if (options.threads.empty()) {
+        for (int n = 1; n < omp_get_num_procs(); n *= 2) {
+            options.threads.push_back(n);
+        }
+        options.threads.push_back(omp_get_num_procs());
+    }
+
+    std::ostringstream runs;
+    if (options.policies.empty() || options.child) {
+        // Measure in this process, under the policy it was started with
+        const std::string policy = waitPolicyName();
+        if (!options.child) {
+            std::cout << "OpenMP construct overheads (" << options.outerReps << " outer repetitions, "
+                      << options.targetUs << " us per test, " << options.delayUs << " us delay)" << std::endl;
+        }
+        OverheadBench bench(options, calibrateDelay(options.delayUs));
+        std::vector<Result> results;
+        for (int threads : options.threads) {
+            std::vector<Result> atCount = runConstructs(bench, threads);
+            results.insert(results.end(), atCount.begin(), atCount.end());
+        }
+        printTable(results, policy);
+        runs << runJson(results, policy);
+
+        if (options.child) {
+            std::ofstream(options.jsonFile) << runs.str();
+            return 0;
+        }
+    } else {
+        std::cout << "OpenMP construct overheads (" << options.outerReps << " outer repetitions, "
+                  << options.targetUs << " us per test, " << options.delayUs << " us delay)" << std::endl;
+        bool first = true;
+        for (const std::string& policy : options.policies) {
+            const std::string runFile = options.jsonFile + "." + policy + ".part";
+            std::cout.flush();
+            if (!runWithPolicy(argv[0], options, policy, runFile)) {
+                std::cerr << "Run with OMP_WAIT_POLICY=" << policy << " failed" << std::endl;
+                continue;
+            }
+            std::ifstream part(runFile);
+            std::stringstream text;
+            text << part.rdbuf();
+            part.close();
+            std::remove(runFile.c_str());
+            runs << (first ? "" : ",\n") << text.str();
+            first = false;
+        }
+    }
+
+    std::ofstream json(options.jsonFile);
+    json << "{\n  \"benchmark\": \"openmp_construct_overheads\",\n"
+         << "  \"openmp\": " << _OPENMP << ",\n"
+         << "  \"outer_reps\": " << options.outerReps << ",\n"
+         << "  \"target_us\": " << options.targetUs << ",\n"
+         << "  \"delay_us\": " << options.delayUs << ",\n"
+         << "  \"runs\": [\n" << runs.str() << "\n  ]\n}\n";
+    std::cout << "\nResults written to " << options.jsonFile << std::endl;
+    std::cout << "A loop pays off in parallel only when each thread's share of one execution "
+              << "is well above the 'for' or 'parallel' overhead." << std::endl;
+    return 0;
+}
@@ -1,8 +1,69 @@
 #include <iostream>
 #include <omp.h>
-#include <chrono>
 #include <vector>
 #include <iomanip>
+#include <algorithm>
+#include "bench_core.h"
+
+// Timings of the vector addition at one size, in milliseconds per call
+struct OffloadTiming {
+    size_t size;
+    double host_ms;         // Host parallel for
+    double to_device_ms;    // a and b copied in, c allocated
+    double kernel_ms;       // Device kernel on resident data
+    double from_device_ms;  // c copied back
+};
+
+// Times c = a + b on the host and on the default device with the data kept resident
+OffloadTiming measureOffload(size_t n, int repeats, bool use_device) {
+    OffloadTiming timing = {n, 0.0, 0.0, 0.0, 0.0};
+    std::vector<double> a(n, 1.0);
+    std::vector<double> b(n, 2.0);
+    std::vector<double> c(n, 0.0);
+    double* pa = a.data();
+    double* pb = b.data();
+    double* pc = c.data();
+    const long long count = static_cast<long long>(n);
+
+    double start = omp_get_wtime();
+    for (int r = 0; r < repeats; ++r) {
+        #pragma omp parallel for
+        for (long long i = 0; i < count; ++i) {
+            pc[i] = pa[i] + pb[i];
+        }
+    }
+    timing.host_ms = (omp_get_wtime() - start) * 1000.0 / repeats;
+
+#if _OPENMP >= 201307
+    // Copy in once; the kernels below find the arrays present and transfer nothing
+    start = omp_get_wtime();
+    #pragma omp target enter data map(to: pa[0:n], pb[0:n]) map(alloc: pc[0:n]) if(use_device)
+    timing.to_device_ms = (omp_get_wtime() - start) * 1000.0;
+
+    // The first launch also loads the device image; keep it out of the kernel time
+    for (int r = 0; r <= repeats; ++r) {
+        if (r == 1) {
+            start = omp_get_wtime();
+        }
+        #pragma omp target teams distribute parallel for simd map(to: pa[0:n], pb[0:n]) map(tofrom: pc[0:n]) if(target: use_device)
+        for (long long i = 0; i < count; ++i) {
+            pc[i] = pa[i] + pb[i];
+        }
+    }
+    timing.kernel_ms = (omp_get_wtime() - start) * 1000.0 / repeats;
+
+    start = omp_get_wtime();
+    #pragma omp target exit data map(from: pc[0:n]) map(release: pa[0:n], pb[0:n]) if(use_device)
+    timing.from_device_ms = (omp_get_wtime() - start) * 1000.0;
+#else
+    (void)use_device;
+#endif
+
+    if (c[0] != 3.0 || c[n - 1] != 3.0) {
+        std::cerr << "Offload result mismatch at size " << n << std::endl;
+    }
+    return timing;
+}
 
 int main() {
     // Check if OpenMP is available
@@ -66,31 +127,33 @@ int main() {
     std::vector<double> b(vector_size, 2.0);
     std::vector<double> c(vector_size, 0.0);
     
-    // Sequential execution
-    auto start_sequential = std::chrono::high_resolution_clock::now();
-    
-    for (size_t i = 0; i < vector_size; ++i) {
-        c[i] = a[i] + b[i];
-    }
+    // Both versions run under the shared repetition policy (bench_core.h): a
+    // warmup run faults in the pages, then the median of the timed runs is kept
+    const bench::RunPolicy policy = bench::RunPolicy::fromEnvironment();
     
-    auto end_sequential = std::chrono::high_resolution_clock::now();
-    auto time_sequential = std::chrono::duration_cast<std::chrono::milliseconds>(
-        end_sequential - start_sequential).count();
+    // Sequential execution
+    std::vector<double> samples_sequential;
+    const double time_sequential = bench::measure([&]() {
+        for (size_t i = 0; i < vector_size; ++i) {
+            c[i] = a[i] + b[i];
+        }
+    }, policy, &samples_sequential).medianMs;
     
     // Reset result vector
     std::fill(c.begin(), c.end(), 0.0);
     
     // Parallel execution
-    auto start_parallel = std::chrono::high_resolution_clock::now();
-    
-    #pragma omp parallel for
-    for (long long i = 0; i < static_cast<long long>(vector_size); ++i) {
-        c[i] = a[i] + b[i];
-    }
+    std::vector<double> samples_parallel;
+    const double time_parallel = bench::measure([&]() {
+        #pragma omp parallel for
+        for (long long i = 0; i < static_cast<long long>(vector_size); ++i) {
+            c[i] = a[i] + b[i];
+        }
+    }, policy, &samples_parallel).medianMs;
     
-    auto end_parallel = std::chrono::high_resolution_clock::now();
-    auto time_parallel = std::chrono::duration_cast<std::chrono::milliseconds>(
-        end_parallel - start_parallel).count();
+    bench::record("vector_add", "sequential", static_cast<long long>(vector_size), 1, samples_sequential);
+    bench::record("vector_add", "parallel for", static_cast<long long>(vector_size), NUM_THREADS, samples_parallel,
+                  {{"speedup", time_sequential / time_parallel}});
     
     // Check result for one element
     std::cout << "Vector addition result (element 0): " << c[0] << std::endl;
@@ -98,11 +161,63 @@ int main() {
     std::cout << "Parallel execution time: " << time_parallel << " ms" << std::endl;
     
     if (time_sequential > 0) {
-        double speedup = static_cast<double>(time_sequential) / time_parallel;
+        double speedup = time_sequential / time_parallel;
         std::cout << "Speedup: " << std::fixed << std::setprecision(2) << speedup << "x" << std::endl;
         std::cout << "Efficiency: " << std::fixed << std::setprecision(2) 
                   << (speedup / NUM_THREADS) * 100 << "%" << std::endl;
     }
     
+    std::cout << "\n=== GPU Offload Demo ===" << std::endl;
+    
+    // Release the host vectors before the offload sweep allocates its own
+    std::vector<double>().swap(a);
+    std::vector<double>().swap(b);
+    std::vector<double>().swap(c);
+    
+#if _OPENMP >= 201307
+    const bool use_device = omp_get_num_devices() > 0;
+    if (use_device) {
+        std::cout << "Offloading to device " << omp_get_default_device() << " of "
+                  << omp_get_num_devices() << std::endl;
+    } else {
+        std::cout << "No offload device found; target regions fall back to the host" << std::endl;
+    }
+#else
+    const bool use_device = false;
+    std::cout << "OpenMP " << _OPENMP << " has no target construct; timing the host only" << std::endl;
+#endif
+    
+    // Offload pays off once the kernel savings over repeated calls cover the transfers
+    std::cout << std::setw(12) << "Size"
+              << std::setw(12) << "Host (ms)"
+              << std::setw(12) << "H2D (ms)"
+              << std::setw(12) << "Kernel (ms)"
+              << std::setw(12) << "D2H (ms)"
+              << std::setw(20) << "Calls to amortize" << std::endl;
+    for (size_t n = 10000; n <= vector_size; n *= 10) {
+        const int repeats = static_cast<int>(std::max<size_t>(5, std::min<size_t>(100, 100000000 / n)));
+        OffloadTiming timing = measureOffload(n, repeats, use_device);
+        const double transfer_ms = timing.to_device_ms + timing.from_device_ms;
+        const double saved_ms = timing.host_ms - timing.kernel_ms;
+        bench::record("offload_vector_add", use_device ? "device" : "host fallback", static_cast<long long>(n),
+                      omp_get_max_threads(), {timing.kernel_ms},
+                      {{"host_ms", timing.host_ms}, {"to_device_ms", timing.to_device_ms},
+                       {"from_device_ms", timing.from_device_ms}});
+        
+        std::cout << std::setw(12) << n << std::fixed << std::setprecision(3)
+                  << std::setw(12) << timing.host_ms
+                  << std::setw(12) << timing.to_device_ms
+                  << std::setw(12) << timing.kernel_ms
+                  << std::setw(12) << timing.from_device_ms;
+        if (!use_device) {
+            std::cout << std::setw(20) << "-";
+        } else if (saved_ms > 0.0) {
+            std::cout << std::setw(20) << std::setprecision(1) << transfer_ms / saved_ms;
+        } else {
+            std::cout << std::setw(20) << "never";
+        }
+        std::cout << std::endl;
+    }
+    
     return 0;
 } 
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef FIRST_TOUCH_ARRAY_H
+#define FIRST_TOUCH_ARRAY_H
+
+#include <cstddef>
+#include <string>
+
+// Allocation modes for the large demo arrays. std::make_unique<int[]> zero-fills the
+// array on the calling thread, so every page is faulted in (and, on a NUMA machine,
+// placed) before any parallel loop runs. The untouched modes take pages straight from
+// the operating system and leave the first write to the initialization loop, which
+// uses the same static schedule as the compute loops: each thread faults in, and owns,
+// exactly the pages it later reads.
+
+enum class AllocMode {
+    ValueInit,      // std::make_unique<int[]>: serial zero-fill
+    FirstTouch,     // Untouched pages, first touched by the parallel init loop
+    FirstTouchHuge  // As FirstTouch, with transparent huge pages requested
+};
+
+// "value-init", "first-touch" or "first-touch+huge"
+const char* allocModeName(AllocMode mode);
+
+// Size of a transparent huge page on x86-64 Linux
+constexpr size_t HUGE_PAGE_BYTES = 2 * 1024 * 1024;
+
+// Owning int array whose storage follows an AllocMode; not copyable
+class FirstTouchArray {
+public:
+    // Throws std::bad_alloc when the memory cannot be obtained
+    FirstTouchArray(long long count, AllocMode mode);
+    ~FirstTouchArray();
+
+    FirstTouchArray(const FirstTouchArray&) = delete;
+    FirstTouchArray& operator=(const FirstTouchArray&) = delete;
+
+    int* data() { return data_; }
+    const int* data() const { return data_; }
+    int& operator[](long long i) { return data_[i]; }
+    long long size() const { return count_; }
+    AllocMode mode() const { return mode_; }
+
+    // False when huge pages were requested but the OS hint could not be applied
+    // (Windows large pages need the "Lock pages in memory" privilege, so there the
+    // request is ignored)
+    bool hugePagesApplied() const { return huge_applied_; }
+
+private:
+    int* data_ = nullptr;
+    long long count_ = 0;
+    size_t bytes_ = 0;
+    AllocMode mode_;
+    bool huge_applied_ = false;
+};
+
+// Page faults (minor + major) taken by this process so far; -1 if unavailable
+long long processPageFaults();
+
+#endif // FIRST_TOUCH_ARRAY_H
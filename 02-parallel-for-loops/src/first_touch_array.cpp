@@ -0,0 +1,79 @@
+#include "first_touch_array.h"
+
+#include <new>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/mman.h>
+#include <sys/resource.h>
+#endif
+
+const char* allocModeName(AllocMode mode) {
+    switch (mode) {
+        case AllocMode::FirstTouch: return "first-touch";
+        case AllocMode::FirstTouchHuge: return "first-touch+huge";
+        default: return "value-init";
+    }
+}
+
+FirstTouchArray::FirstTouchArray(long long count, AllocMode mode)
+    : count_(count), bytes_(static_cast<size_t>(count) * sizeof(int)), mode_(mode) {
+    if (mode == AllocMode::ValueInit) {
+        data_ = new int[static_cast<size_t>(count)]();
+        return;
+    }
+
+#ifdef _WIN32
+    // VirtualAlloc commits zero pages lazily; nothing is touched until the first write
+    void* ptr = VirtualAlloc(nullptr, bytes_, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+#else
+    void* ptr = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+#ifdef MADV_HUGEPAGE
+    // Best effort: the kernel backs every aligned 2 MB stretch with one huge page
+    // when THP is in "madvise" or "always" mode
+    if (mode == AllocMode::FirstTouchHuge && bytes_ >= HUGE_PAGE_BYTES) {
+        huge_applied_ = madvise(ptr, bytes_, MADV_HUGEPAGE) == 0;
+    }
+#endif
+#endif
+    data_ = static_cast<int*>(ptr);
+}
+
+FirstTouchArray::~FirstTouchArray() {
+    if (mode_ == AllocMode::ValueInit) {
+        delete[] data_;
+        return;
+    }
+#ifdef _WIN32
+    VirtualFree(data_, 0, MEM_RELEASE);
+#else
+    munmap(data_, bytes_);
+#endif
+}
+
+long long processPageFaults() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return -1;
+    }
+    return static_cast<long long>(counters.PageFaultCount);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return -1;
+    }
+    return static_cast<long long>(usage.ru_minflt) + usage.ru_majflt;
+#endif
+}
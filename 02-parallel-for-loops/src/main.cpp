@@ -1,37 +1,39 @@
 #include <iostream>
 #include <omp.h>
 #include <vector>
-#include <chrono>
 #include <iomanip>
 #include <random>
 #include <algorithm>
 #include <memory>
 #include <string>
 #include <stdexcept>
+#include "first_touch_array.h"
+#include "perf_markers.h"
+#include "bench_core.h"
 
 // Utility function for timing measurements
 class Timer {
 private:
-    std::chrono::high_resolution_clock::time_point start_time;
+    bench::Timer timer;
     std::string operation_name;
 
 public:
     Timer(const std::string& name) : operation_name(name) {
-        start_time = std::chrono::high_resolution_clock::now();
         std::cout << "Starting " << operation_name << "..." << std::endl;
+        timer.start();
     }
 
     ~Timer() {
-        auto end_time = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-            end_time - start_time).count();
-        std::cout << operation_name << " completed in " << duration << " ms" << std::endl;
+        std::cout << operation_name << " completed in " << elapsed_ms() << " ms" << std::endl;
     }
 
     long long elapsed_ms() {
-        auto end_time = std::chrono::high_resolution_clock::now();
-        return std::chrono::duration_cast<std::chrono::milliseconds>(
-            end_time - start_time).count();
+        return static_cast<long long>(timer.elapsedMilliseconds());
+    }
+
+    // Append the time so far to the shared results file (BENCH_RESULTS)
+    void record(const std::string& benchmark, const std::string& variant, long long size, int threads) {
+        bench::record(benchmark, variant, size, threads, {timer.elapsedMilliseconds()});
     }
 };
 
@@ -65,6 +67,81 @@ void visualize_thread_distribution(int num_threads, long long array_size) {
     std::cout << std::endl;
 }
 
+// Allocate, first-touch and sum one array in the given allocation mode, reporting
+// page faults and effective bandwidth for the init and sum phases
+bool run_allocation_mode(AllocMode mode, long long array_size, long long expected_sum) {
+    using clock = bench::Clock;
+    const double gigabytes = static_cast<double>(array_size) * sizeof(int) / 1e9;
+    
+    std::cout << "\n--- " << allocModeName(mode) << " ---" << std::endl;
+    
+    auto start = clock::now();
+    long long faults_before = processPageFaults();
+    std::unique_ptr<FirstTouchArray> array;
+    try {
+        array = std::make_unique<FirstTouchArray>(array_size, mode);
+    }
+    catch (const std::bad_alloc& e) {
+        std::cerr << "Memory allocation failed: " << e.what() << std::endl;
+        return false;
+    }
+    double alloc_ms = clock::toMilliseconds(clock::now() - start);
+    long long alloc_faults = processPageFaults() - faults_before;
+    if (mode == AllocMode::FirstTouchHuge && !array->hugePagesApplied()) {
+        std::cout << "(huge pages not available; running with normal pages)" << std::endl;
+    }
+    
+    // First touch: the same static schedule as the sum below, so each thread
+    // faults in the pages it will read
+    int* data = array->data();
+    faults_before = processPageFaults();
+    start = clock::now();
+    PERF_TASK_BEGIN("First-touch init");
+    #pragma omp parallel for schedule(static)
+    for (long long i = 0; i < array_size; ++i) {
+        data[i] = static_cast<int>(i % 100);
+    }
+    PERF_TASK_END();
+    double init_ms = clock::toMilliseconds(clock::now() - start);
+    long long init_faults = processPageFaults() - faults_before;
+    
+    long long sum = 0;
+    faults_before = processPageFaults();
+    start = clock::now();
+    PERF_TASK_BEGIN("Parallel sum");
+    #pragma omp parallel for schedule(static) reduction(+:sum)
+    for (long long i = 0; i < array_size; ++i) {
+        sum += data[i];
+    }
+    PERF_TASK_END();
+    double sum_ms = clock::toMilliseconds(clock::now() - start);
+    long long sum_faults = processPageFaults() - faults_before;
+    
+    const int threads = omp_get_max_threads();
+    bench::record("first_touch_init", allocModeName(mode), array_size, threads, {init_ms},
+                  {{"page_faults", static_cast<double>(init_faults)}, {"alloc_ms", alloc_ms},
+                   {"GB_per_s", init_ms > 0 ? gigabytes / (init_ms / 1000.0) : 0.0}});
+    bench::record("first_touch_sum", allocModeName(mode), array_size, threads, {sum_ms},
+                  {{"page_faults", static_cast<double>(sum_faults)},
+                   {"GB_per_s", sum_ms > 0 ? gigabytes / (sum_ms / 1000.0) : 0.0}});
+    
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  Allocation: " << std::setw(8) << alloc_ms << " ms, "
+              << std::setw(8) << alloc_faults << " page faults" << std::endl;
+    std::cout << "  Init:       " << std::setw(8) << init_ms << " ms, "
+              << std::setw(8) << init_faults << " page faults, "
+              << std::setw(6) << (init_ms > 0 ? gigabytes / (init_ms / 1000.0) : 0.0) << " GB/s" << std::endl;
+    std::cout << "  Sum:        " << std::setw(8) << sum_ms << " ms, "
+              << std::setw(8) << sum_faults << " page faults, "
+              << std::setw(6) << (sum_ms > 0 ? gigabytes / (sum_ms / 1000.0) : 0.0) << " GB/s" << std::endl;
+    
+    if (sum != expected_sum) {
+        std::cerr << "❌ Error: sum " << sum << " does not match " << expected_sum << std::endl;
+        return false;
+    }
+    return true;
+}
+
 int main() {
     // Check if OpenMP is available
     #ifdef _OPENMP
@@ -111,6 +188,7 @@ int main() {
             array[i] = static_cast<int>(i % 100); // Simple pattern
         }
         time_seq_init = timer.elapsed_ms();
+        timer.record("init", "sequential", ARRAY_SIZE, 1);
     }
     
     // Sequential sum calculation
@@ -121,6 +199,7 @@ int main() {
             sum_sequential += array[i];
         }
         time_seq_sum = timer.elapsed_ms();
+        timer.record("sum", "sequential", ARRAY_SIZE, 1);
     }
     std::cout << "Sequential sum result: " << sum_sequential << std::endl;
     
@@ -138,6 +217,7 @@ int main() {
             array[i] = static_cast<int>(i % 100); // Same pattern as sequential
         }
         time_par_init = timer.elapsed_ms();
+        timer.record("init", "parallel for", ARRAY_SIZE, max_threads);
     }
     
     // Display thread distribution visualization
@@ -155,6 +235,7 @@ int main() {
             sum_parallel += array[i];
         }
         time_par_sum = timer.elapsed_ms();
+        timer.record("sum", "parallel for reduction", ARRAY_SIZE, max_threads);
     }
     std::cout << "Parallel sum result: " << sum_parallel << std::endl;
     
@@ -197,5 +278,19 @@ int main() {
     std::cout << "\nNote: Efficiency less than 100% is normal due to threading overhead, "
               << "memory bandwidth limitations, and other factors." << std::endl;
     
+    // Allocation modes: the arrays above were zero-filled by make_unique on one
+    // thread, so the "parallel" init mostly rewrote pages that were already mapped
+    array.reset();
+    std::cout << "\n=== Allocation Modes (static schedule first touch) ===" << std::endl;
+    std::cout << "Page faults are counted per phase; GB/s is array bytes / phase time." << std::endl;
+    for (AllocMode mode : {AllocMode::ValueInit, AllocMode::FirstTouch, AllocMode::FirstTouchHuge}) {
+        if (!run_allocation_mode(mode, ARRAY_SIZE, sum_sequential)) {
+            return 1;
+        }
+    }
+    std::cout << "\nNote: with first touch the init loop pays the page faults; value-init pays "
+              << "them serially during allocation and leaves every page on the allocating "
+              << "thread's NUMA node." << std::endl;
+    
     return 0;
 } 
\ No newline at end of file
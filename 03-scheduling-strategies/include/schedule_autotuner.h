@@ -0,0 +1,88 @@
+#ifndef SCHEDULE_AUTOTUNER_H
+#define SCHEDULE_AUTOTUNER_H
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+// Autotuner for loops written with schedule(runtime). Each loop site has an ID; over
+// its first invocations the tuner sets a different schedule kind and chunk size
+// before each run (omp_set_schedule) and times it, then locks in the fastest. The
+// decision is keyed by loop ID, thread count and trip-count bucket and saved to a
+// profile file, so later runs start with the tuned schedule.
+
+enum class ScheduleKind {
+    Static,
+    Dynamic,
+    Guided
+};
+
+struct ScheduleChoice {
+    ScheduleKind kind = ScheduleKind::Static;
+    int chunk = 0;  // 0 is the kind's default
+};
+
+// "static", "dynamic" or "guided", as visualizeIterationPattern expects
+const char* scheduleKindName(ScheduleKind kind);
+
+class ScheduleAutotuner {
+public:
+    // Loads profile_path if it exists. Each candidate is timed trials_per_candidate
+    // times before the choice is locked.
+    explicit ScheduleAutotuner(const std::string& profile_path = "schedule_profile.txt",
+                               int trials_per_candidate = 1);
+
+    // Run loop() (which must use schedule(runtime)) under the next schedule to try,
+    // or the locked one; returns its time in milliseconds. loop_id must not contain
+    // whitespace.
+    template <typename Loop>
+    double run(const std::string& loop_id, long long trip_count, Loop loop) {
+        prepare(loop_id, trip_count);
+        const auto start = std::chrono::high_resolution_clock::now();
+        loop();
+        const double elapsed = std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - start).count();
+        record(loop_id, trip_count, elapsed);
+        return elapsed;
+    }
+
+    bool isLocked(const std::string& loop_id, long long trip_count) const;
+
+    // The locked choice, or the best seen so far while still exploring
+    ScheduleChoice bestChoice(const std::string& loop_id, long long trip_count) const;
+
+    // Invocations spent exploring (0 when the choice came from the profile file)
+    int explorationRuns(const std::string& loop_id, long long trip_count) const;
+
+    const std::vector<ScheduleChoice>& candidates() const { return candidates_; }
+
+    // Write all locked decisions to the profile file; false on I/O failure
+    bool save() const;
+
+private:
+    struct LoopProfile {
+        std::vector<double> best_ms;  // Per candidate; negative until timed
+        int invocations = 0;
+        bool locked = false;
+        ScheduleChoice choice;
+        double choice_ms = 0.0;
+    };
+
+    // Thread count and log2 of the trip count join the ID: the best schedule for
+    // 100 iterations on 4 threads says little about 10^6 iterations on 16
+    std::string key(const std::string& loop_id, long long trip_count) const;
+    LoopProfile& profileFor(const std::string& loop_id, long long trip_count);
+    const LoopProfile* findProfile(const std::string& loop_id, long long trip_count) const;
+
+    ScheduleChoice prepare(const std::string& loop_id, long long trip_count);
+    void record(const std::string& loop_id, long long trip_count, double ms);
+    void load();
+
+    std::string profile_path_;
+    int trials_per_candidate_;
+    std::vector<ScheduleChoice> candidates_;
+    std::map<std::string, LoopProfile> profiles_;
+};
+
+#endif // SCHEDULE_AUTOTUNER_H
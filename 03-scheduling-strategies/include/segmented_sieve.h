@@ -0,0 +1,28 @@
+#ifndef SEGMENTED_SIEVE_H
+#define SEGMENTED_SIEVE_H
+
+#include <cstdint>
+#include <vector>
+
+// Segmented Sieve of Eratosthenes: a prime-counting engine that is bound by memory
+// traffic rather than by division like isPrime. Only odd numbers are stored, one bit
+// each, and the range is cut into cache-sized segments that the threads share out
+// under the chosen schedule.
+
+enum class SieveSchedule {
+    Static,
+    Dynamic,
+    Guided
+};
+
+// Bytes of bit storage per segment: 32 KB fits in L1 and covers 524288 numbers
+constexpr int SIEVE_SEGMENT_BYTES = 32 * 1024;
+constexpr long long SIEVE_SEGMENT_BITS = SIEVE_SEGMENT_BYTES * 8LL;
+
+// Number of primes <= limit. chunk is the schedule's chunk size in segments (0 for
+// the default). num_threads = 0 uses the default team size. If segments_per_thread
+// is given, it receives how many segments each thread sieved.
+long long countPrimesSieve(long long limit, SieveSchedule schedule, int chunk = 0, int num_threads = 0,
+                           std::vector<int>* segments_per_thread = nullptr);
+
+#endif // SEGMENTED_SIEVE_H
@@ -0,0 +1,56 @@
+#ifndef WEIGHTED_SCHEDULE_H
+#define WEIGHTED_SCHEDULE_H
+
+#include <functional>
+#include <vector>
+#include <omp.h>
+
+// Cost-model-driven static scheduling: estimate what each iteration costs, then cut
+// the iteration space into one contiguous range per thread with nearly equal total
+// cost. Balance like schedule(dynamic), overhead like schedule(static).
+
+// Estimated cost of one iteration, given its problem size
+using CostFunction = std::function<double(int)>;
+
+// cost(size) = scale * size^exponent
+struct PowerLawCostModel {
+    double scale = 1.0;
+    double exponent = 1.0;
+
+    double operator()(int size) const;
+};
+
+// Time kernel(size) at `probes` sizes spaced geometrically over [min_size, max_size]
+// and fit a power law by least squares in log-log space. The time spent profiling is
+// written to profile_ms when given.
+PowerLawCostModel profileCostModel(const std::function<void(int)>& kernel, int min_size, int max_size,
+                                   int probes = 6, double* profile_ms = nullptr);
+
+// Cost of every iteration: cost(sizes[i])
+std::vector<double> estimateCosts(const std::vector<int>& sizes, const CostFunction& cost);
+
+// Split [0, costs.size()) into num_threads contiguous ranges of nearly equal total
+// cost. Returns num_threads + 1 bounds; range t is [bounds[t], bounds[t + 1]).
+std::vector<int> buildWeightedPartition(const std::vector<double>& costs, int num_threads);
+
+// Run body(i) over a partition from buildWeightedPartition, one range per thread.
+// If the team is smaller than the partition, threads take ranges round-robin.
+template <typename Body>
+void weightedStaticFor(const std::vector<int>& bounds, Body body) {
+    const int ranges = static_cast<int>(bounds.size()) - 1;
+    if (ranges <= 0) {
+        return;
+    }
+    #pragma omp parallel num_threads(ranges)
+    {
+        const int thread = omp_get_thread_num();
+        const int threads = omp_get_num_threads();
+        for (int r = thread; r < ranges; r += threads) {
+            for (int i = bounds[r]; i < bounds[r + 1]; i++) {
+                body(i);
+            }
+        }
+    }
+}
+
+#endif // WEIGHTED_SCHEDULE_H
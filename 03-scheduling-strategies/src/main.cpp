@@ -2,37 +2,19 @@
 #include <iomanip>
 #include <vector>
 #include <string>
-#include <chrono>
+#include <map>
 #include <omp.h>
 #include <numeric>
 #include <algorithm>
 #include <cmath>
+#include "weighted_schedule.h"
+#include "segmented_sieve.h"
+#include "schedule_autotuner.h"
+#include "perf_markers.h"
+#include "bench_core.h"
 
-// Timer utility class for measuring execution time
-class Timer {
-private:
-    std::chrono::high_resolution_clock::time_point start_time;
-    std::chrono::high_resolution_clock::time_point end_time;
-    bool running;
-
-public:
-    Timer() : running(false) {}
-
-    void start() {
-        start_time = std::chrono::high_resolution_clock::now();
-        running = true;
-    }
-
-    void stop() {
-        end_time = std::chrono::high_resolution_clock::now();
-        running = false;
-    }
-
-    double elapsedMilliseconds() {
-        auto end = running ? std::chrono::high_resolution_clock::now() : end_time;
-        return std::chrono::duration<double, std::milli>(end - start_time).count();
-    }
-};
+// Timer utility for measuring execution time, on the shared calibrated clock
+using Timer = bench::Timer;
 
 // Function to check if a number is prime
 bool isPrime(int n) {
@@ -75,7 +57,7 @@ struct SchedulingResult {
 };
 
 // Function to visualize thread workload distribution
-void visualizeThreadWorkload(const std::vector<int>& work_counts) {
+void visualizeThreadWorkload(const std::vector<int>& work_counts, const std::string& unit = "iterations") {
     int max_work = *std::max_element(work_counts.begin(), work_counts.end());
     int min_work = *std::min_element(work_counts.begin(), work_counts.end());
     int work_range = max_work - min_work;
@@ -100,11 +82,51 @@ void visualizeThreadWorkload(const std::vector<int>& work_counts) {
             std::cout << "#";
         }
         
-        std::cout << "] " << work_counts[i] << " iterations\n";
+        std::cout << "] " << work_counts[i] << " " << unit << "\n";
     }
     std::cout << "\n";
 }
 
+// Print results in table format
+void printSchedulingTable(const std::vector<SchedulingResult>& results) {
+    std::cout << std::setw(20) << "Scheduling Type" << " | " 
+              << std::setw(12) << "Time (ms)" << " | " 
+              << std::setw(10) << "Speedup" << " | " 
+              << std::setw(15) << "Load Balance" << "\n";
+    std::cout << std::string(65, '-') << "\n";
+    
+    for (const auto& result : results) {
+        // Calculate load balance metrics
+        int max_work = *std::max_element(result.thread_work_counts.begin(), result.thread_work_counts.end());
+        int min_work = *std::min_element(result.thread_work_counts.begin(), result.thread_work_counts.end());
+        
+        double imbalance = 0.0;
+        if (max_work > 0) {
+            imbalance = static_cast<double>(max_work - min_work) / max_work * 100.0;
+        }
+        
+        std::cout << std::setw(20) << result.name << " | " 
+                  << std::setw(12) << std::fixed << std::setprecision(2) << result.time << " | " 
+                  << std::setw(10) << std::fixed << std::setprecision(2) << result.speedup << " | "
+                  << std::setw(13) << std::fixed << std::setprecision(2) << imbalance << "%" << "\n";
+    }
+}
+
+// Append the sequential baseline and every schedule to the shared results file (BENCH_RESULTS)
+void recordSchedulingResults(const std::string& benchmark, long long size, int threads,
+                             double sequential_time, const std::vector<SchedulingResult>& results) {
+    bench::record(benchmark, "sequential", size, 1, {sequential_time});
+    for (const auto& result : results) {
+        std::map<std::string, double> counters = {{"speedup", result.speedup}};
+        if (!result.thread_work_counts.empty()) {
+            int max_work = *std::max_element(result.thread_work_counts.begin(), result.thread_work_counts.end());
+            int min_work = *std::min_element(result.thread_work_counts.begin(), result.thread_work_counts.end());
+            counters["imbalance_pct"] = max_work > 0 ? static_cast<double>(max_work - min_work) / max_work * 100.0 : 0.0;
+        }
+        bench::record(benchmark, result.name, size, threads, {result.time}, counters);
+    }
+}
+
 // Function to visualize iteration assignment patterns
 void visualizeIterationPattern(const std::string& schedule_type, int num_threads, int iterations, int chunk_size = 0) {
     std::cout << "  Iteration pattern with " << schedule_type;
@@ -191,6 +213,118 @@ void visualizeIterationPattern(const std::string& schedule_type, int num_threads
     std::cout << "\n";
 }
 
+// Segmented sieve engine: the same schedule choices on a memory-bound kernel
+void runSieveEngine(int max_threads, int trial_division_limit) {
+    std::cout << "=========================================\n";
+    std::cout << "Segmented Sieve Engine\n";
+    std::cout << "=========================================\n\n";
+    
+    // Agreement with trial division on small limits first
+    bool valid = true;
+    for (int limit : {0, 1, 2, 3, 10, 1000, 524290, trial_division_limit}) {
+        valid = valid && countPrimesSieve(limit, SieveSchedule::Dynamic, 1) == countPrimes(limit);
+    }
+    std::cout << "Validation against isPrime: " << (valid ? "passed" : "FAILED") << "\n";
+    
+    const long long SIEVE_LIMIT = 200000000;
+    const long long KNOWN_COUNT = 11078937;  // pi(2 * 10^8)
+    Timer timer;
+    
+    timer.start();
+    long long sequential_count = countPrimesSieve(SIEVE_LIMIT, SieveSchedule::Static, 0, 1);
+    timer.stop();
+    double sequential_time = timer.elapsedMilliseconds();
+    std::cout << "Primes up to " << SIEVE_LIMIT << ": " << sequential_count
+              << (sequential_count == KNOWN_COUNT ? " (correct)" : " (WRONG)") << "\n";
+    std::cout << "Single thread: " << std::fixed << std::setprecision(2) << sequential_time << " ms, "
+              << SIEVE_SEGMENT_BYTES / 1024 << " KB segments of " << 2 * SIEVE_SEGMENT_BITS << " numbers\n\n";
+    
+    struct SieveRun {
+        const char* name;
+        SieveSchedule schedule;
+        int chunk;
+    };
+    const SieveRun runs[] = {
+        {"Static (default)", SieveSchedule::Static, 0},
+        {"Static (chunk=1)", SieveSchedule::Static, 1},
+        {"Dynamic (chunk=1)", SieveSchedule::Dynamic, 1},
+        {"Dynamic (chunk=10)", SieveSchedule::Dynamic, 10},
+        {"Guided (chunk=1)", SieveSchedule::Guided, 1},
+    };
+    
+    std::vector<SchedulingResult> results;
+    for (const auto& run : runs) {
+        SchedulingResult result(run.name);
+        timer.start();
+        long long count = countPrimesSieve(SIEVE_LIMIT, run.schedule, run.chunk, max_threads, &result.thread_work_counts);
+        timer.stop();
+        result.time = timer.elapsedMilliseconds();
+        result.speedup = sequential_time / result.time;
+        if (count != sequential_count) {
+            result.name += " (WRONG)";
+        }
+        results.push_back(result);
+    }
+    
+    std::sort(results.begin(), results.end(), [](const SchedulingResult& a, const SchedulingResult& b) {
+        return a.time < b.time;
+    });
+    printSchedulingTable(results);
+    recordSchedulingResults("segmented_sieve", SIEVE_LIMIT, max_threads, sequential_time, results);
+    
+    std::cout << "\nSegments per thread, " << results[0].name << ":\n";
+    visualizeThreadWorkload(results[0].thread_work_counts, "segments");
+}
+
+// schedule(runtime) autotuning of the countPrimes loop; returns the locked choice
+ScheduleChoice runScheduleAutotuner(const std::vector<int>& workload) {
+    PERF_SCOPE("Schedule autotuner");
+    std::cout << "=========================================\n";
+    std::cout << "Schedule Autotuner (schedule(runtime))\n";
+    std::cout << "=========================================\n\n";
+    
+    const std::string LOOP_ID = "countPrimes_workload";
+    const int items = static_cast<int>(workload.size());
+    ScheduleAutotuner tuner("schedule_profile.txt");
+    std::vector<int> results_parallel(items);
+    
+    if (tuner.isLocked(LOOP_ID, items)) {
+        std::cout << "Loaded tuned schedule from schedule_profile.txt\n";
+    } else {
+        std::cout << "Exploring " << tuner.candidates().size() << " schedules, one invocation each\n";
+    }
+    
+    // Exploration runs until the choice locks, then two runs on the locked schedule
+    int locked_runs = 0;
+    for (int invocation = 1; locked_runs < 2; invocation++) {
+        bool exploring = !tuner.isLocked(LOOP_ID, items);
+        double ms = tuner.run(LOOP_ID, items, [&]() {
+            #pragma omp parallel for schedule(runtime)
+            for (int i = 0; i < items; i++) {
+                results_parallel[i] = countPrimes(workload[i]);
+            }
+        });
+        if (!exploring) {
+            locked_runs++;
+        }
+        
+        int chunk = 0;
+        std::string kind = "static";
+#if defined(_OPENMP) && _OPENMP >= 200805
+        omp_sched_t runtime_kind;
+        omp_get_schedule(&runtime_kind, &chunk);
+        kind = runtime_kind == omp_sched_dynamic ? "dynamic" : runtime_kind == omp_sched_guided ? "guided" : "static";
+#endif
+        std::cout << "  Invocation " << invocation << ": " << std::setw(7) << kind << ", chunk " << std::setw(2) << chunk
+                  << " -> " << std::fixed << std::setprecision(2) << ms << " ms" << (exploring ? " (exploring)" : "") << "\n";
+    }
+    
+    ScheduleChoice choice = tuner.bestChoice(LOOP_ID, items);
+    std::cout << "Locked in: " << scheduleKindName(choice.kind) << ", chunk " << choice.chunk
+              << " (key: " << LOOP_ID << ", " << omp_get_max_threads() << " threads, " << items << " iterations)\n\n";
+    return choice;
+}
+
 int main() {
     std::cout << "=========================================\n";
     std::cout << "   OpenMP Scheduling Strategies Demo\n";
@@ -247,6 +381,8 @@ int main() {
     results.push_back(SchedulingResult("Guided (default)"));
     results.push_back(SchedulingResult("Guided (chunk=1)"));
     results.push_back(SchedulingResult("Runtime"));
+    results.push_back(SchedulingResult("Weighted (profiled)"));
+    results.push_back(SchedulingResult("Weighted (cost fn)"));
     
     // Initialize thread work counters for each scheduling strategy
     for (auto& result : results) {
@@ -260,6 +396,7 @@ int main() {
     // Static scheduling (default)
     {
         std::vector<int> results_parallel(NUM_WORKLOAD_ITEMS);
+        PERF_SCOPE("schedule(static)");
         timer.start();
         #pragma omp parallel for schedule(static)
         for (int i = 0; i < NUM_WORKLOAD_ITEMS; i++) {
@@ -274,6 +411,7 @@ int main() {
     // Static scheduling (chunk=1)
     {
         std::vector<int> results_parallel(NUM_WORKLOAD_ITEMS);
+        PERF_SCOPE("schedule(static, 1)");
         timer.start();
         #pragma omp parallel for schedule(static, 1)
         for (int i = 0; i < NUM_WORKLOAD_ITEMS; i++) {
@@ -288,6 +426,7 @@ int main() {
     // Static scheduling (chunk=10)
     {
         std::vector<int> results_parallel(NUM_WORKLOAD_ITEMS);
+        PERF_SCOPE("schedule(static, 10)");
         timer.start();
         #pragma omp parallel for schedule(static, 10)
         for (int i = 0; i < NUM_WORKLOAD_ITEMS; i++) {
@@ -302,6 +441,7 @@ int main() {
     // Dynamic scheduling (default)
     {
         std::vector<int> results_parallel(NUM_WORKLOAD_ITEMS);
+        PERF_SCOPE("schedule(dynamic)");
         timer.start();
         #pragma omp parallel for schedule(dynamic)
         for (int i = 0; i < NUM_WORKLOAD_ITEMS; i++) {
@@ -316,6 +456,7 @@ int main() {
     // Dynamic scheduling (chunk=1)
     {
         std::vector<int> results_parallel(NUM_WORKLOAD_ITEMS);
+        PERF_SCOPE("schedule(dynamic, 1)");
         timer.start();
         #pragma omp parallel for schedule(dynamic, 1)
         for (int i = 0; i < NUM_WORKLOAD_ITEMS; i++) {
@@ -330,6 +471,7 @@ int main() {
     // Dynamic scheduling (chunk=10)
     {
         std::vector<int> results_parallel(NUM_WORKLOAD_ITEMS);
+        PERF_SCOPE("schedule(dynamic, 10)");
         timer.start();
         #pragma omp parallel for schedule(dynamic, 10)
         for (int i = 0; i < NUM_WORKLOAD_ITEMS; i++) {
@@ -344,6 +486,7 @@ int main() {
     // Guided scheduling (default)
     {
         std::vector<int> results_parallel(NUM_WORKLOAD_ITEMS);
+        PERF_SCOPE("schedule(guided)");
         timer.start();
         #pragma omp parallel for schedule(guided)
         for (int i = 0; i < NUM_WORKLOAD_ITEMS; i++) {
@@ -358,6 +501,7 @@ int main() {
     // Guided scheduling (chunk=1)
     {
         std::vector<int> results_parallel(NUM_WORKLOAD_ITEMS);
+        PERF_SCOPE("schedule(guided, 1)");
         timer.start();
         #pragma omp parallel for schedule(guided, 1)
         for (int i = 0; i < NUM_WORKLOAD_ITEMS; i++) {
@@ -383,6 +527,46 @@ int main() {
         results[8].speedup = sequential_time / results[8].time;
     }
     
+    // Weighted static scheduling: contiguous ranges balanced by a cost model fitted
+    // from a short profiling run of countPrimes at a few smaller limits
+    double profile_ms = 0.0;
+    int max_limit = *std::max_element(workload.begin(), workload.end());
+    PowerLawCostModel profiled_model = profileCostModel(
+        [](int limit) {
+            volatile int sink = countPrimes(limit);
+            (void)sink;
+        },
+        1000, std::max(1000, max_limit / 4), 6, &profile_ms);
+    std::vector<int> profiled_bounds;
+    {
+        std::vector<int> results_parallel(NUM_WORKLOAD_ITEMS);
+        timer.start();
+        profiled_bounds = buildWeightedPartition(estimateCosts(workload, profiled_model), max_threads);
+        weightedStaticFor(profiled_bounds, [&](int i) {
+            results_parallel[i] = countPrimes(workload[i]);
+            results[9].thread_work_counts[omp_get_thread_num()]++;
+        });
+        timer.stop();
+        results[9].time = timer.elapsedMilliseconds();
+        results[9].speedup = sequential_time / results[9].time;
+    }
+    
+    // Weighted static scheduling with a user-supplied cost function: trial division
+    // up to sqrt(n) for each of n numbers
+    {
+        std::vector<int> results_parallel(NUM_WORKLOAD_ITEMS);
+        timer.start();
+        std::vector<int> bounds = buildWeightedPartition(
+            estimateCosts(workload, [](int limit) { return std::pow(static_cast<double>(limit), 1.5); }), max_threads);
+        weightedStaticFor(bounds, [&](int i) {
+            results_parallel[i] = countPrimes(workload[i]);
+            results[10].thread_work_counts[omp_get_thread_num()]++;
+        });
+        timer.stop();
+        results[10].time = timer.elapsedMilliseconds();
+        results[10].speedup = sequential_time / results[10].time;
+    }
+    
     // Display summary of results
     std::cout << "=========================================\n";
     std::cout << "Performance Summary (sorted by execution time)\n";
@@ -393,28 +577,8 @@ int main() {
         return a.time < b.time;
     });
     
-    // Print results in table format
-    std::cout << std::setw(20) << "Scheduling Type" << " | " 
-              << std::setw(12) << "Time (ms)" << " | " 
-              << std::setw(10) << "Speedup" << " | " 
-              << std::setw(15) << "Load Balance" << "\n";
-    std::cout << std::string(65, '-') << "\n";
-    
-    for (const auto& result : results) {
-        // Calculate load balance metrics
-        int max_work = *std::max_element(result.thread_work_counts.begin(), result.thread_work_counts.end());
-        int min_work = *std::min_element(result.thread_work_counts.begin(), result.thread_work_counts.end());
-        
-        double imbalance = 0.0;
-        if (max_work > 0) {
-            imbalance = static_cast<double>(max_work - min_work) / max_work * 100.0;
-        }
-        
-        std::cout << std::setw(20) << result.name << " | " 
-                  << std::setw(12) << std::fixed << std::setprecision(2) << result.time << " | " 
-                  << std::setw(10) << std::fixed << std::setprecision(2) << result.speedup << " | "
-                  << std::setw(13) << std::fixed << std::setprecision(2) << imbalance << "%" << "\n";
-    }
+    printSchedulingTable(results);
+    recordSchedulingResults("prime_count", NUM_WORKLOAD_ITEMS, max_threads, sequential_time, results);
     
     // Show detailed visualization for the fastest scheduling strategy
     std::cout << "\n=========================================\n";
@@ -426,6 +590,36 @@ int main() {
     
     visualizeThreadWorkload(results[0].thread_work_counts);
     
+    // Weighted static: uneven iteration counts, even predicted cost
+    std::cout << "=========================================\n";
+    std::cout << "Weighted Static Scheduling (profiled cost model)\n";
+    std::cout << "=========================================\n\n";
+    
+    std::cout << "Cost model: time(limit) = " << std::scientific << std::setprecision(3) << profiled_model.scale
+              << " * limit^" << std::fixed << std::setprecision(3) << profiled_model.exponent
+              << " ms (profiling took " << std::setprecision(2) << profile_ms << " ms)\n";
+    for (const auto& result : results) {
+        if (result.name == "Weighted (profiled)") {
+            std::cout << "Execution time: " << result.time << " ms\n\n";
+            visualizeThreadWorkload(result.thread_work_counts);
+        }
+    }
+    
+    std::vector<double> profiled_costs = estimateCosts(workload, profiled_model);
+    double total_cost = std::accumulate(profiled_costs.begin(), profiled_costs.end(), 0.0);
+    std::vector<int> predicted_share(max_threads, 0);
+    for (int t = 0; t < max_threads; t++) {
+        double range_cost = std::accumulate(profiled_costs.begin() + profiled_bounds[t],
+                                            profiled_costs.begin() + profiled_bounds[t + 1], 0.0);
+        predicted_share[t] = static_cast<int>(std::lround(range_cost / total_cost * 1000.0));
+    }
+    std::cout << "  Predicted cost per thread (per mille of total):\n";
+    visualizeThreadWorkload(predicted_share, "per mille");
+    
+    runSieveEngine(max_threads, MAX_NUMBER);
+    
+    ScheduleChoice tuned = runScheduleAutotuner(workload);
+    
     // Show iteration pattern visualizations for different scheduling types
     std::cout << "=========================================\n";
     std::cout << "Iteration Assignment Patterns (Simplified)\n";
@@ -436,6 +630,10 @@ int main() {
     visualizeIterationPattern("dynamic", max_threads, NUM_WORKLOAD_ITEMS, 1);
     visualizeIterationPattern("guided", max_threads, NUM_WORKLOAD_ITEMS, 1);
     
+    std::cout << "  Autotuned choice for the countPrimes loop:\n";
+    int tuned_chunk = tuned.kind == ScheduleKind::Static ? tuned.chunk : std::max(tuned.chunk, 1);
+    visualizeIterationPattern(scheduleKindName(tuned.kind), max_threads, NUM_WORKLOAD_ITEMS, tuned_chunk);
+    
     std::cout << "=========================================\n";
     std::cout << "Scheduling Recommendations\n";
     std::cout << "=========================================\n\n";
@@ -0,0 +1,174 @@
+#include "schedule_autotuner.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <omp.h>
+
+namespace {
+
+// omp_set_schedule is OpenMP 3.0; older runtimes (MSVC's OpenMP 2.0) keep the
+// OMP_SCHEDULE / default schedule and the tuner only records timings
+void applySchedule(const ScheduleChoice& choice) {
+#if defined(_OPENMP) && _OPENMP >= 200805
+    omp_sched_t kind = omp_sched_static;
+    if (choice.kind == ScheduleKind::Dynamic) kind = omp_sched_dynamic;
+    if (choice.kind == ScheduleKind::Guided) kind = omp_sched_guided;
+    omp_set_schedule(kind, choice.chunk);
+#else
+    (void)choice;
+#endif
+}
+
+int tripCountBucket(long long trip_count) {
+    int bucket = 0;
+    while (trip_count > 1) {
+        trip_count >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+bool parseKind(const std::string& name, ScheduleKind& kind) {
+    if (name == "static") kind = ScheduleKind::Static;
+    else if (name == "dynamic") kind = ScheduleKind::Dynamic;
+    else if (name == "guided") kind = ScheduleKind::Guided;
+    else return false;
+    return true;
+}
+
+} // namespace
+
+const char* scheduleKindName(ScheduleKind kind) {
+    switch (kind) {
+        case ScheduleKind::Dynamic: return "dynamic";
+        case ScheduleKind::Guided: return "guided";
+        default: return "static";
+    }
+}
+
+ScheduleAutotuner::ScheduleAutotuner(const std::string& profile_path, int trials_per_candidate)
+    : profile_path_(profile_path),
+      trials_per_candidate_(std::max(trials_per_candidate, 1)),
+      candidates_{
+          {ScheduleKind::Static, 0},
+          {ScheduleKind::Static, 1},
+          {ScheduleKind::Dynamic, 1},
+          {ScheduleKind::Dynamic, 4},
+          {ScheduleKind::Guided, 1},
+          {ScheduleKind::Guided, 4},
+      } {
+    load();
+}
+
+std::string ScheduleAutotuner::key(const std::string& loop_id, long long trip_count) const {
+    return loop_id + " " + std::to_string(omp_get_max_threads()) + " " + std::to_string(tripCountBucket(trip_count));
+}
+
+ScheduleAutotuner::LoopProfile& ScheduleAutotuner::profileFor(const std::string& loop_id, long long trip_count) {
+    LoopProfile& profile = profiles_[key(loop_id, trip_count)];
+    if (profile.best_ms.empty()) {
+        profile.best_ms.assign(candidates_.size(), -1.0);
+    }
+    return profile;
+}
+
+const ScheduleAutotuner::LoopProfile* ScheduleAutotuner::findProfile(const std::string& loop_id,
+                                                                     long long trip_count) const {
+    const auto it = profiles_.find(key(loop_id, trip_count));
+    return it == profiles_.end() ? nullptr : &it->second;
+}
+
+ScheduleChoice ScheduleAutotuner::prepare(const std::string& loop_id, long long trip_count) {
+    LoopProfile& profile = profileFor(loop_id, trip_count);
+    const ScheduleChoice choice = profile.locked
+        ? profile.choice
+        : candidates_[static_cast<size_t>(profile.invocations) % candidates_.size()];
+    applySchedule(choice);
+    return choice;
+}
+
+void ScheduleAutotuner::record(const std::string& loop_id, long long trip_count, double ms) {
+    LoopProfile& profile = profileFor(loop_id, trip_count);
+    if (profile.locked) {
+        return;
+    }
+    const size_t candidate = static_cast<size_t>(profile.invocations) % candidates_.size();
+    double& best = profile.best_ms[candidate];
+    best = best < 0.0 ? ms : std::min(best, ms);
+    profile.invocations++;
+
+    if (profile.invocations >= static_cast<int>(candidates_.size()) * trials_per_candidate_) {
+        const auto fastest = std::min_element(profile.best_ms.begin(), profile.best_ms.end());
+        profile.choice = candidates_[static_cast<size_t>(fastest - profile.best_ms.begin())];
+        profile.choice_ms = *fastest;
+        profile.locked = true;
+        save();
+    }
+}
+
+bool ScheduleAutotuner::isLocked(const std::string& loop_id, long long trip_count) const {
+    const LoopProfile* profile = findProfile(loop_id, trip_count);
+    return profile != nullptr && profile->locked;
+}
+
+ScheduleChoice ScheduleAutotuner::bestChoice(const std::string& loop_id, long long trip_count) const {
+    const LoopProfile* profile = findProfile(loop_id, trip_count);
+    if (profile == nullptr) {
+        return candidates_.front();
+    }
+    if (profile->locked) {
+        return profile->choice;
+    }
+    ScheduleChoice best = candidates_.front();
+    double best_ms = -1.0;
+    for (size_t c = 0; c < profile->best_ms.size(); c++) {
+        if (profile->best_ms[c] >= 0.0 && (best_ms < 0.0 || profile->best_ms[c] < best_ms)) {
+            best_ms = profile->best_ms[c];
+            best = candidates_[c];
+        }
+    }
+    return best;
+}
+
+int ScheduleAutotuner::explorationRuns(const std::string& loop_id, long long trip_count) const {
+    const LoopProfile* profile = findProfile(loop_id, trip_count);
+    return profile == nullptr ? 0 : profile->invocations;
+}
+
+// Profile format, one locked decision per line:
+//   <loop id> <threads> <trip-count bucket> <kind> <chunk> <best ms>
+bool ScheduleAutotuner::save() const {
+    std::ofstream file(profile_path_);
+    if (!file.is_open()) {
+        return false;
+    }
+    file << "# loop_id threads trip_bucket kind chunk best_ms\n";
+    for (const auto& entry : profiles_) {
+        if (entry.second.locked) {
+            file << entry.first << " " << scheduleKindName(entry.second.choice.kind) << " "
+                 << entry.second.choice.chunk << " " << entry.second.choice_ms << "\n";
+        }
+    }
+    return static_cast<bool>(file);
+}
+
+void ScheduleAutotuner::load() {
+    std::ifstream file(profile_path_);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string loop_id, threads, bucket, kind_name;
+        LoopProfile profile;
+        if (!(fields >> loop_id >> threads >> bucket >> kind_name >> profile.choice.chunk >> profile.choice_ms)
+            || !parseKind(kind_name, profile.choice.kind)) {
+            continue;  // Skip malformed lines rather than fail the run
+        }
+        profile.locked = true;
+        profile.best_ms.assign(candidates_.size(), -1.0);
+        profiles_[loop_id + " " + threads + " " + bucket] = profile;
+    }
+}
@@ -0,0 +1,124 @@
+#include "segmented_sieve.h"
+#include "perf_markers.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <omp.h>
+
+namespace {
+
+constexpr long long WORD_BITS = 64;
+constexpr long long SEGMENT_WORDS = SIEVE_SEGMENT_BITS / WORD_BITS;
+
+// Odd primes up to limit with a plain sieve; these cross off the segments
+std::vector<int> oddBasePrimes(int limit) {
+    std::vector<int> primes;
+    if (limit < 3) {
+        return primes;
+    }
+    std::vector<bool> composite(limit + 1, false);
+    for (int p = 3; p <= limit; p += 2) {
+        if (composite[p]) continue;
+        primes.push_back(p);
+        for (long long m = static_cast<long long>(p) * p; m <= limit; m += 2LL * p) {
+            composite[m] = true;
+        }
+    }
+    return primes;
+}
+
+// Sieve one segment. Bit j stands for the odd number 2 * (first + j) + 1;
+// returns the number of primes among the first bits entries.
+long long sieveSegment(long long first, long long bits, const std::vector<int>& primes,
+                       std::vector<uint64_t>& words) {
+    std::fill(words.begin(), words.end(), ~0ULL);
+    const long long low = 2 * first + 1;
+    const long long high = 2 * (first + bits) - 1;
+
+    for (int p : primes) {
+        const long long square = static_cast<long long>(p) * p;
+        if (square > high) break;
+        // First odd multiple of p in the segment, but no smaller than p * p
+        long long start = std::max(square, (low + p - 1) / p * p);
+        if ((start & 1) == 0) start += p;
+        for (long long j = (start - 1) / 2 - first; j < bits; j += p) {
+            words[j / WORD_BITS] &= ~(1ULL << (j % WORD_BITS));
+        }
+    }
+    if (first == 0) {
+        words[0] &= ~1ULL;  // 1 is not prime
+    }
+
+    long long count = 0;
+    const long long full_words = bits / WORD_BITS;
+    for (long long w = 0; w < full_words; w++) {
+        count += static_cast<long long>(std::bitset<64>(words[w]).count());
+    }
+    if (bits % WORD_BITS != 0) {
+        const uint64_t mask = (1ULL << (bits % WORD_BITS)) - 1;
+        count += static_cast<long long>(std::bitset<64>(words[full_words] & mask).count());
+    }
+    return count;
+}
+
+} // namespace
+
+long long countPrimesSieve(long long limit, SieveSchedule schedule, int chunk, int num_threads,
+                           std::vector<int>* segments_per_thread) {
+    PERF_SCOPE("Segmented sieve");
+    if (limit < 2) {
+        return 0;
+    }
+    const std::vector<int> primes = oddBasePrimes(static_cast<int>(std::sqrt(static_cast<double>(limit))) + 1);
+    const long long odd_count = (limit - 1) / 2 + 1;  // Odd numbers 1, 3, ..., <= limit
+    const long long segments = (odd_count + SIEVE_SEGMENT_BITS - 1) / SIEVE_SEGMENT_BITS;
+    const int threads = num_threads > 0 ? num_threads : omp_get_max_threads();
+    const int chunk_size = std::max(chunk, 1);
+
+    std::vector<int> per_thread(threads, 0);
+    long long count = 1;  // The prime 2
+
+    #pragma omp parallel num_threads(threads) reduction(+:count)
+    {
+        std::vector<uint64_t> words(SEGMENT_WORDS);
+        int sieved = 0;
+
+        // Same kinds and chunk sizes as the countPrimes tests
+        if (schedule == SieveSchedule::Static && chunk <= 0) {
+            #pragma omp for schedule(static)
+            for (long long s = 0; s < segments; s++) {
+                const long long first = s * SIEVE_SEGMENT_BITS;
+                count += sieveSegment(first, std::min(SIEVE_SEGMENT_BITS, odd_count - first), primes, words);
+                sieved++;
+            }
+        } else if (schedule == SieveSchedule::Static) {
+            #pragma omp for schedule(static, chunk_size)
+            for (long long s = 0; s < segments; s++) {
+                const long long first = s * SIEVE_SEGMENT_BITS;
+                count += sieveSegment(first, std::min(SIEVE_SEGMENT_BITS, odd_count - first), primes, words);
+                sieved++;
+            }
+        } else if (schedule == SieveSchedule::Dynamic) {
+            #pragma omp for schedule(dynamic, chunk_size)
+            for (long long s = 0; s < segments; s++) {
+                const long long first = s * SIEVE_SEGMENT_BITS;
+                count += sieveSegment(first, std::min(SIEVE_SEGMENT_BITS, odd_count - first), primes, words);
+                sieved++;
+            }
+        } else {
+            #pragma omp for schedule(guided, chunk_size)
+            for (long long s = 0; s < segments; s++) {
+                const long long first = s * SIEVE_SEGMENT_BITS;
+                count += sieveSegment(first, std::min(SIEVE_SEGMENT_BITS, odd_count - first), primes, words);
+                sieved++;
+            }
+        }
+        per_thread[omp_get_thread_num()] = sieved;
+    }
+
+    if (segments_per_thread != nullptr) {
+        *segments_per_thread = per_thread;
+    }
+    return count;
+}
@@ -0,0 +1,96 @@
+#include "weighted_schedule.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+double PowerLawCostModel::operator()(int size) const {
+    return scale * std::pow(static_cast<double>(std::max(size, 1)), exponent);
+}
+
+PowerLawCostModel profileCostModel(const std::function<void(int)>& kernel, int min_size, int max_size,
+                                   int probes, double* profile_ms) {
+    const auto profile_start = std::chrono::high_resolution_clock::now();
+    min_size = std::max(min_size, 1);
+    max_size = std::max(max_size, min_size);
+    probes = std::max(probes, 2);
+
+    // Least-squares fit of log(time) = log(scale) + exponent * log(size)
+    double sum_x = 0.0, sum_y = 0.0, sum_xx = 0.0, sum_xy = 0.0;
+    int samples = 0;
+    const double ratio = std::pow(static_cast<double>(max_size) / min_size, 1.0 / (probes - 1));
+    double size = min_size;
+    for (int p = 0; p < probes; p++, size *= ratio) {
+        const int n = static_cast<int>(std::lround(size));
+        // Best of two runs filters out a cold first call
+        double best = 0.0;
+        for (int rep = 0; rep < 2; rep++) {
+            const auto start = std::chrono::high_resolution_clock::now();
+            kernel(n);
+            const double elapsed = std::chrono::duration<double, std::milli>(
+                std::chrono::high_resolution_clock::now() - start).count();
+            best = rep == 0 ? elapsed : std::min(best, elapsed);
+        }
+        if (best <= 0.0) {
+            continue;  // Below timer resolution
+        }
+        const double x = std::log(static_cast<double>(n));
+        const double y = std::log(best);
+        sum_x += x;
+        sum_y += y;
+        sum_xx += x * x;
+        sum_xy += x * y;
+        samples++;
+    }
+
+    PowerLawCostModel model;
+    const double denominator = samples * sum_xx - sum_x * sum_x;
+    if (samples >= 2 && denominator > 0.0) {
+        model.exponent = (samples * sum_xy - sum_x * sum_y) / denominator;
+        model.scale = std::exp((sum_y - model.exponent * sum_x) / samples);
+    }
+
+    if (profile_ms != nullptr) {
+        *profile_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - profile_start).count();
+    }
+    return model;
+}
+
+std::vector<double> estimateCosts(const std::vector<int>& sizes, const CostFunction& cost) {
+    std::vector<double> costs(sizes.size());
+    for (size_t i = 0; i < sizes.size(); i++) {
+        costs[i] = std::max(0.0, cost(sizes[i]));
+    }
+    return costs;
+}
+
+std::vector<int> buildWeightedPartition(const std::vector<double>& costs, int num_threads) {
+    num_threads = std::max(num_threads, 1);
+    const int n = static_cast<int>(costs.size());
+
+    std::vector<double> prefix(n + 1, 0.0);
+    for (int i = 0; i < n; i++) {
+        prefix[i + 1] = prefix[i] + costs[i];
+    }
+    if (prefix[n] <= 0.0) {
+        // No usable estimates: fall back to equal iteration counts
+        for (int i = 0; i <= n; i++) {
+            prefix[i] = i;
+        }
+    }
+    const double total = prefix[n];
+
+    std::vector<int> bounds(num_threads + 1, n);
+    bounds[0] = 0;
+    for (int t = 1; t < num_threads; t++) {
+        // First cut at or past the ideal share, or the one just before it if closer
+        const double target = total * t / num_threads;
+        int cut = static_cast<int>(std::lower_bound(prefix.begin() + bounds[t - 1], prefix.end(), target) - prefix.begin());
+        if (cut > bounds[t - 1] && target - prefix[cut - 1] < prefix[std::min(cut, n)] - target) {
+            cut--;
+        }
+        bounds[t] = std::min(cut, n);
+    }
+    return bounds;
+}
@@ -0,0 +1,43 @@
+#ifndef MATRIX_KERNELS_H
+#define MATRIX_KERNELS_H
+
+#include <vector>
+
+// Square row-major matrix multiplication kernels, C = A x B, parallelized over rows
+// of C. They differ only in loop order and in which buffers are shared or private,
+// which is what decides how well each thread's working set stays in cache:
+//
+//   Naive         i-j-k; the inner loop reads B down a column, one cache line per
+//                 element (stride = size doubles)
+//   Transposed    B is transposed once into a buffer shared by all threads; the
+//                 inner loop then reads two rows with unit stride
+//   RowAccum      i-k-j; each thread accumulates a row of C in a private buffer
+//                 while streaming rows of B, then writes the row out once
+//   TiledShared   tile x tile blocks, accumulating straight into the shared C
+//   TiledPrivate  tile x tile blocks with a private C tile and a private packed
+//                 copy of the B tile, so the hot loop touches only thread-local data
+
+enum class MatrixKernel {
+    Naive,
+    Transposed,
+    RowAccum,
+    TiledShared,
+    TiledPrivate
+};
+
+const char* matrixKernelName(MatrixKernel kernel);
+
+// How the kernel shares its buffers, for the demo's table
+const char* matrixKernelSharing(MatrixKernel kernel);
+
+// Bytes one thread keeps re-reading in its innermost loops: the data that has to stay
+// in cache for the kernel to run at cache speed. A strided column of B costs a whole
+// cache line per element, which is why Naive needs so much more than Transposed.
+double matrixKernelWorkingSetBytes(MatrixKernel kernel, int size, int tile = 64);
+
+// Multiply the size x size matrices A and B into C (resized as needed). tile is the
+// block edge for the tiled kernels and ignored by the others.
+void multiplyMatrices(MatrixKernel kernel, const std::vector<double>& A, const std::vector<double>& B,
+                      std::vector<double>& C, int size, int tile = 64);
+
+#endif // MATRIX_KERNELS_H
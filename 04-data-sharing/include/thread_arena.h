@@ -0,0 +1,126 @@
+#ifndef THREAD_ARENA_H
+#define THREAD_ARENA_H
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <vector>
+
+// Per-thread scratch arena. Temporaries inside a parallel region (a std::vector per
+// graph level, a buffer per task) normally go through the global heap, whose locks
+// the threads then fight over. Each thread instead bump-allocates from its own arena,
+// reached through a threadprivate pointer, and releases everything at once at the end
+// of the region. Memory blocks are kept across regions, so after warm-up a region
+// allocates nothing from the heap at all.
+
+class ScratchArena {
+public:
+    // Position in the arena, for rewinding to an earlier state
+    struct Marker {
+        size_t block = 0;
+        size_t offset = 0;
+    };
+
+    explicit ScratchArena(size_t block_bytes = 64 * 1024);
+    ~ScratchArena();
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    // Bump-allocate; alignment must be a power of two. Requests larger than the block
+    // size get a block of their own. Throws std::bad_alloc when the heap is exhausted.
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    Marker mark() const { return {current_, offset_}; }
+
+    // Free everything allocated after m; the blocks stay for reuse
+    void rewind(const Marker& m);
+
+    // Free everything; the blocks stay for reuse
+    void reset() { rewind(Marker{}); }
+
+    // Bytes handed out since the last reset, and bytes held in blocks
+    size_t bytesUsed() const;
+    size_t bytesReserved() const;
+
+    // Blocks taken from the heap over the arena's lifetime
+    size_t heapAllocations() const { return heap_allocations_; }
+
+private:
+    struct Block {
+        char* data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks_;
+    size_t current_ = 0;  // Index of the block being filled
+    size_t offset_ = 0;   // Bytes used in blocks_[current_]
+    size_t block_bytes_;
+    size_t heap_allocations_ = 0;
+};
+
+// The calling thread's arena, created on first use. The pointer behind it is
+// threadprivate, so each OpenMP thread gets its own; the arenas live until exit.
+ScratchArena& threadArena();
+
+// Rewinds the calling thread's arena when it goes out of scope. Declare one at the
+// top of a parallel region (or a task) so its temporaries are released together.
+class ThreadArenaScope {
+public:
+    ThreadArenaScope() : arena_(threadArena()), marker_(arena_.mark()) {}
+    ~ThreadArenaScope() { arena_.rewind(marker_); }
+
+    ThreadArenaScope(const ThreadArenaScope&) = delete;
+    ThreadArenaScope& operator=(const ThreadArenaScope&) = delete;
+
+    ScratchArena& arena() { return arena_; }
+
+private:
+    ScratchArena& arena_;
+    ScratchArena::Marker marker_;
+};
+
+// STL allocator drawing from a ScratchArena (the calling thread's by default).
+// deallocate is a no-op: memory comes back when the arena is rewound, so containers
+// using it must not outlive the enclosing ThreadArenaScope.
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator() : arena_(&threadArena()) {}
+    explicit ArenaAllocator(ScratchArena& arena) : arena_(&arena) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.arena()) {}
+
+    T* allocate(size_t count) {
+        if (count > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(arena_->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) noexcept {}
+
+    ScratchArena* arena() const { return arena_; }
+
+private:
+    ScratchArena* arena_;
+};
+
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept {
+    return a.arena() == b.arena();
+}
+
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept {
+    return a.arena() != b.arena();
+}
+
+// std::vector whose storage lives in the calling thread's arena
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif // THREAD_ARENA_H
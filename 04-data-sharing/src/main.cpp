@@ -2,39 +2,20 @@
 #include <iomanip>
 #include <vector>
 #include <string>
-#include <chrono>
 #include <omp.h>
 #include <cmath>
+#include <algorithm>
+#include <cstdlib>
+#include "matrix_kernels.h"
+#include "thread_arena.h"
+#include "bench_core.h"
 
 // ------------------------------
 // Utility Classes and Functions
 // ------------------------------
 
-// Timer class for performance measurements
-class Timer {
-private:
-    std::chrono::high_resolution_clock::time_point start_time;
-    std::chrono::high_resolution_clock::time_point end_time;
-    bool running;
-
-public:
-    Timer() : running(false) {}
-
-    void start() {
-        start_time = std::chrono::high_resolution_clock::now();
-        running = true;
-    }
-
-    void stop() {
-        end_time = std::chrono::high_resolution_clock::now();
-        running = false;
-    }
-
-    double elapsedMilliseconds() {
-        auto end = running ? std::chrono::high_resolution_clock::now() : end_time;
-        return std::chrono::duration<double, std::milli>(end - start_time).count();
-    }
-};
+// Timer for performance measurements, on the shared calibrated clock
+using Timer = bench::Timer;
 
 // Memory state visualizer
 void visualizeMemory(const std::string& title, const std::vector<int>& values, int thread_count) {
@@ -300,83 +281,247 @@ void threadprivateDemo() {
 }
 
 // Example 7: Complex Example - Matrix Multiplication with Data Sharing
-void matrixMultiplicationDemo() {
+// The kernels differ in loop order and in which buffers are shared or private;
+// size and tile come from --matrix-size and --tile
+void matrixMultiplicationDemo(int size, int tile) {
     std::cout << "\n================================================\n";
     std::cout << "DEMO 7: MATRIX MULTIPLICATION WITH DATA SHARING\n";
     std::cout << "================================================\n";
 
-    const int size = 600; // Matrix size
-    
-    // Allocate matrices
-    std::vector<double> A(size * size, 1.0);
-    std::vector<double> B(size * size, 2.0);
-    std::vector<double> C(size * size, 0.0);
+    // Allocate matrices; small repeating values so every kernel's result can be checked
+    std::vector<double> A(static_cast<size_t>(size) * size);
+    std::vector<double> B(static_cast<size_t>(size) * size);
+    std::vector<double> C;
+    for (size_t i = 0; i < A.size(); i++) {
+        A[i] = static_cast<double>(i % 7) - 3.0;
+        B[i] = static_cast<double>(i % 5) * 0.5;
+    }
     
-    std::cout << "Matrix size: " << size << "x" << size << "\n";
+    std::cout << "Matrix size: " << size << "x" << size << ", tile " << tile << "x" << tile << "\n";
     std::cout << "Performing matrix multiplication C = A × B\n";
     
     Timer timer;
     timer.start();
     
     // Sequential version for comparison
-    std::vector<double> C_sequential(size * size, 0.0);
+    std::vector<double> C_sequential(static_cast<size_t>(size) * size, 0.0);
     for (int i = 0; i < size; i++) {
         for (int j = 0; j < size; j++) {
             double sum = 0.0;
             for (int k = 0; k < size; k++) {
-                sum += A[i * size + k] * B[k * size + j];
+                sum += A[static_cast<size_t>(i) * size + k] * B[static_cast<size_t>(k) * size + j];
             }
-            C_sequential[i * size + j] = sum;
+            C_sequential[static_cast<size_t>(i) * size + j] = sum;
         }
     }
     
     double sequential_time = timer.elapsedMilliseconds();
-    std::cout << "Sequential execution time: " << sequential_time << " ms\n";
+    std::cout << "Sequential execution time: " << sequential_time << " ms\n\n";
+    
+    const double flops = 2.0 * size * static_cast<double>(size) * size;
+    bench::record("matrix_multiply", "sequential", size, 1, {sequential_time},
+                  {{"GFLOP_per_s", flops / (sequential_time * 1e6)}});
+    const MatrixKernel kernels[] = {MatrixKernel::Naive, MatrixKernel::Transposed, MatrixKernel::RowAccum,
+                                    MatrixKernel::TiledShared, MatrixKernel::TiledPrivate};
+    
+    std::cout << std::left << std::setw(18) << "Kernel" << std::right
+              << std::setw(12) << "Time (ms)" << std::setw(10) << "GFLOP/s" << std::setw(10) << "Speedup"
+              << std::setw(14) << "Hot set (KB)" << std::setw(8) << "Check" << "  Sharing\n";
+    std::cout << std::string(100, '-') << "\n";
+    
+    for (MatrixKernel kernel : kernels) {
+        timer.start();
+        multiplyMatrices(kernel, A, B, C, size, tile);
+        double parallel_time = timer.elapsedMilliseconds();
+        
+        // Verify results (summation order differs between kernels)
+        bool correct = true;
+        for (size_t i = 0; i < C.size() && correct; i++) {
+            if (std::abs(C[i] - C_sequential[i]) > 1e-9 * (1.0 + std::abs(C_sequential[i]))) {
+                correct = false;
+            }
+        }
+        
+        std::cout << std::left << std::setw(18) << matrixKernelName(kernel) << std::right << std::fixed
+                  << std::setprecision(2) << std::setw(12) << parallel_time
+                  << std::setw(10) << flops / (parallel_time * 1e6)
+                  << std::setw(9) << sequential_time / parallel_time << "x"
+                  << std::setw(14) << std::setprecision(1) << matrixKernelWorkingSetBytes(kernel, size, tile) / 1024.0
+                  << std::setw(8) << (correct ? "PASSED" : "FAILED")
+                  << "  " << matrixKernelSharing(kernel) << "\n";
+        std::cout.unsetf(std::ios::fixed);
+        std::cout << std::setprecision(6);
+        
+        bench::record("matrix_multiply", matrixKernelName(kernel), size, omp_get_max_threads(), {parallel_time},
+                      {{"GFLOP_per_s", flops / (parallel_time * 1e6)}, {"speedup", sequential_time / parallel_time},
+                       {"tile", static_cast<double>(tile)}});
+    }
+    
+    std::cout << "\nData sharing in this example:\n";
+    std::cout << "- Matrices A, B, C: shared (all threads access same memory)\n";
+    std::cout << "- Loop counters i, j, k: private to each thread\n";
+    std::cout << "- Accumulator 'sum': private to each thread\n";
+    std::cout << "- Transposed B: shared, written once behind the loop's implicit barrier\n";
+    std::cout << "- Row and tile buffers: private, declared inside the parallel region\n";
+    std::cout << "\nCache behavior:\n";
+    std::cout << "- 'Hot set' is the data a thread re-reads in its inner loops. The naive kernel\n";
+    std::cout << "  reads B down a column, so each element costs a full 64-byte cache line.\n";
+    std::cout << "- Transposing B or using i-k-j order makes every inner loop unit-stride.\n";
+    std::cout << "- Tiling bounds the hot set by the tile size instead of the matrix size.\n";
+    std::cout << "  Private tiles are contiguous and never shared, so their cache lines stay\n";
+    std::cout << "  in the owning core's cache and the B tile loads without conflict misses.\n\n";
+}
+
+// Example 8: Threadprivate Scratch Arenas
+// Each iteration builds a short-lived vector, as hot loops do with per-level or per-task
+// temporaries. The heap versions take the allocator's locks on every iteration; the
+// arena version bump-allocates from the thread's own threadprivate arena.
+void threadArenaDemo() {
+    std::cout << "\n================================================\n";
+    std::cout << "DEMO 8: THREADPRIVATE SCRATCH ARENAS\n";
+    std::cout << "================================================\n";
+
+    const int iterations = 200000;
+    const int num_threads = omp_get_max_threads();
+    // Element counts cycle through 16..1024 so the heap sees mixed size classes
+    auto elementsFor = [](int i) { return 16 + (i * 37) % 1009; };
+    
+    long long expected = 0;
+    for (int i = 0; i < iterations; i++) {
+        long long n = elementsFor(i);
+        expected += n * (n - 1) / 2;
+    }
     
-    // Reset timer
+    Timer timer;
+    std::cout << "Iterations: " << iterations << ", threads: " << num_threads << "\n\n";
+    std::cout << std::left << std::setw(24) << "Allocator" << std::right << std::setw(12) << "Time (ms)"
+              << std::setw(16) << "Iter/s (M)" << std::setw(8) << "Check" << "\n";
+    std::cout << std::string(60, '-') << "\n";
+    
+    auto report = [&](const char* name, double ms, long long total) {
+        std::cout << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << ms << std::setw(16) << iterations / (ms * 1e3)
+                  << std::setw(8) << (total == expected ? "PASSED" : "FAILED") << "\n";
+        std::cout.unsetf(std::ios::fixed);
+        std::cout << std::setprecision(6);
+        bench::record("scratch_allocation", name, iterations, num_threads, {ms},
+                      {{"Miter_per_s", iterations / (ms * 1e3)}});
+    };
+    
+    // 1. std::vector with the default allocator (operator new)
+    long long total = 0;
     timer.start();
+    #pragma omp parallel for reduction(+:total) schedule(static)
+    for (int i = 0; i < iterations; i++) {
+        std::vector<int> values;
+        for (int v = 0; v < elementsFor(i); v++) {
+            values.push_back(v);
+        }
+        for (int v : values) {
+            total += v;
+        }
+    }
+    report("std::vector (new)", timer.elapsedMilliseconds(), total);
     
-    // Parallel version with appropriate data sharing
-    #pragma omp parallel
-    {
-        // A, B, C are shared by default (all threads access the same arrays)
-        #pragma omp for
-        for (int i = 0; i < size; i++) {
-            for (int j = 0; j < size; j++) {
-                // sum is private to each thread (automatic variable in the loop)
-                double sum = 0.0;
-                for (int k = 0; k < size; k++) {
-                    sum += A[i * size + k] * B[k * size + j];
+    // 2. malloc/free of an exactly sized buffer
+    total = 0;
+    timer.start();
+    #pragma omp parallel for reduction(+:total) schedule(static)
+    for (int i = 0; i < iterations; i++) {
+        const int n = elementsFor(i);
+        int* values = static_cast<int*>(std::malloc(n * sizeof(int)));
+        for (int v = 0; v < n; v++) {
+            values[v] = v;
+        }
+        for (int v = 0; v < n; v++) {
+            total += values[v];
+        }
+        std::free(values);
+    }
+    report("malloc/free", timer.elapsedMilliseconds(), total);
+    
+    // 3. The same exactly sized buffer bump-allocated from the thread's arena
+    total = 0;
+    timer.start();
+    #pragma omp parallel for reduction(+:total) schedule(static)
+    for (int i = 0; i < iterations; i++) {
+        ThreadArenaScope scope;
+        const int n = elementsFor(i);
+        int* values = static_cast<int*>(scope.arena().allocate(n * sizeof(int), alignof(int)));
+        for (int v = 0; v < n; v++) {
+            values[v] = v;
+        }
+        for (int v = 0; v < n; v++) {
+            total += values[v];
+        }
+    }
+    report("thread arena buffer", timer.elapsedMilliseconds(), total);
+    
+    // 4. ArenaVector in the thread's arena, rewound after every iteration. The first
+    //    region warms the arenas up; the second should take nothing from the heap.
+    std::vector<size_t> heap_blocks(num_threads, 0);
+    std::vector<size_t> reserved(num_threads, 0);
+    for (int round = 0; round < 2; round++) {
+        total = 0;
+        timer.start();
+        #pragma omp parallel num_threads(num_threads) reduction(+:total)
+        {
+            #pragma omp for schedule(static)
+            for (int i = 0; i < iterations; i++) {
+                ThreadArenaScope scope;
+                ArenaVector<int> values;
+                for (int v = 0; v < elementsFor(i); v++) {
+                    values.push_back(v);
+                }
+                for (int v : values) {
+                    total += v;
                 }
-                C[i * size + j] = sum;
             }
+            const int thread_id = omp_get_thread_num();
+            const size_t blocks = threadArena().heapAllocations();
+            heap_blocks[thread_id] = blocks - heap_blocks[thread_id];
+            reserved[thread_id] = threadArena().bytesReserved();
         }
+        report(round == 0 ? "ArenaVector (cold)" : "ArenaVector (warm)", timer.elapsedMilliseconds(), total);
     }
     
-    double parallel_time = timer.elapsedMilliseconds();
-    
-    // Verify results
-    bool correct = true;
-    for (int i = 0; i < size * size && correct; i++) {
-        if (std::abs(C[i] - C_sequential[i]) > 1e-10) {
-            correct = false;
-        }
+    std::cout << "\nArena state per thread after the warm run:\n";
+    for (int t = 0; t < std::min(num_threads, 8); t++) {
+        std::cout << "  Thread " << t << ": " << reserved[t] / 1024 << " KB reserved, "
+                  << heap_blocks[t] << " heap blocks taken during the warm run\n";
+    }
+    if (num_threads > 8) {
+        std::cout << "  ... and " << (num_threads - 8) << " more threads\n";
     }
     
-    std::cout << "Parallel execution time: " << parallel_time << " ms\n";
-    std::cout << "Speedup: " << sequential_time / parallel_time << "x\n";
-    std::cout << "Result verification: " << (correct ? "PASSED" : "FAILED") << "\n";
     std::cout << "\nData sharing in this example:\n";
-    std::cout << "- Matrices A, B, C: shared (all threads access same memory)\n";
-    std::cout << "- Loop counters i, j, k: private to each thread\n";
-    std::cout << "- Accumulator 'sum': private to each thread\n\n";
+    std::cout << "- The arena pointer is threadprivate: one arena per thread, kept between regions\n";
+    std::cout << "- ThreadArenaScope rewinds the arena when the iteration ends; blocks are reused\n";
+    std::cout << "- Vector growth in the arena never frees, so a scope should stay short\n\n";
 }
 
 // ------------------------------
 // Main Function
 // ------------------------------
 
-int main() {
+int main(int argc, char* argv[]) {
+    int matrix_size = 600;
+    int tile = 64;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--matrix-size" && i + 1 < argc) {
+            matrix_size = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--tile" && i + 1 < argc) {
+            tile = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--help" || arg == "-h") {
+            std::cout << "Usage: " << argv[0] << " [--matrix-size N] [--tile N]\n";
+            std::cout << "  --matrix-size N  Edge of the square matrices in demo 7 (default 600)\n";
+            std::cout << "  --tile N         Block edge for the tiled kernels (default 64)\n";
+            return 0;
+        }
+    }
+
+
     std::cout << "=========================================\n";
     std::cout << "   OpenMP Data Sharing Clauses Demo\n";
     std::cout << "=========================================\n\n";
@@ -394,7 +539,8 @@ int main() {
     firstprivateDemo();
     lastprivateDemo();
     threadprivateDemo();
-    matrixMultiplicationDemo();
+    matrixMultiplicationDemo(matrix_size, tile);
+    threadArenaDemo();
     
     std::cout << "=========================================\n";
     std::cout << "              Demo Complete\n";
@@ -0,0 +1,193 @@
+#include "matrix_kernels.h"
+#include "perf_markers.h"
+
+#include <algorithm>
+#include <omp.h>
+
+namespace {
+
+void multiplyNaive(const double* A, const double* B, double* C, int size) {
+    PERF_SCOPE("Matrix multiply (naive)");
+    #pragma omp parallel for
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            double sum = 0.0;
+            for (int k = 0; k < size; k++) {
+                sum += A[i * size + k] * B[k * size + j];
+            }
+            C[i * size + j] = sum;
+        }
+    }
+}
+
+void multiplyTransposed(const double* A, const double* B, double* C, int size) {
+    PERF_SCOPE("Matrix multiply (transposed B)");
+    // Shared: written once by all threads, then only read
+    std::vector<double> Bt(static_cast<size_t>(size) * size);
+
+    #pragma omp parallel
+    {
+        #pragma omp for
+        for (int k = 0; k < size; k++) {
+            for (int j = 0; j < size; j++) {
+                Bt[static_cast<size_t>(j) * size + k] = B[static_cast<size_t>(k) * size + j];
+            }
+        }
+        // Implicit barrier: Bt is complete before any thread reads it
+
+        #pragma omp for
+        for (int i = 0; i < size; i++) {
+            const double* a_row = A + static_cast<size_t>(i) * size;
+            for (int j = 0; j < size; j++) {
+                const double* bt_row = Bt.data() + static_cast<size_t>(j) * size;
+                double sum = 0.0;
+                for (int k = 0; k < size; k++) {
+                    sum += a_row[k] * bt_row[k];
+                }
+                C[static_cast<size_t>(i) * size + j] = sum;
+            }
+        }
+    }
+}
+
+void multiplyRowAccum(const double* A, const double* B, double* C, int size) {
+    PERF_SCOPE("Matrix multiply (row accumulator)");
+    #pragma omp parallel
+    {
+        // Private: one row of C, reused for every row this thread owns
+        std::vector<double> row(size);
+
+        #pragma omp for
+        for (int i = 0; i < size; i++) {
+            std::fill(row.begin(), row.end(), 0.0);
+            for (int k = 0; k < size; k++) {
+                const double a = A[static_cast<size_t>(i) * size + k];
+                const double* b_row = B + static_cast<size_t>(k) * size;
+                for (int j = 0; j < size; j++) {
+                    row[j] += a * b_row[j];
+                }
+            }
+            std::copy(row.begin(), row.end(), C + static_cast<size_t>(i) * size);
+        }
+    }
+}
+
+void multiplyTiledShared(const double* A, const double* B, double* C, int size, int tile) {
+    PERF_SCOPE("Matrix multiply (tiled, shared)");
+    #pragma omp parallel for
+    for (int ii = 0; ii < size; ii += tile) {
+        const int i_end = std::min(ii + tile, size);
+        for (int i = ii; i < i_end; i++) {
+            std::fill(C + static_cast<size_t>(i) * size, C + static_cast<size_t>(i + 1) * size, 0.0);
+        }
+        for (int kk = 0; kk < size; kk += tile) {
+            const int k_end = std::min(kk + tile, size);
+            for (int jj = 0; jj < size; jj += tile) {
+                const int j_end = std::min(jj + tile, size);
+                for (int i = ii; i < i_end; i++) {
+                    double* c_row = C + static_cast<size_t>(i) * size;
+                    for (int k = kk; k < k_end; k++) {
+                        const double a = A[static_cast<size_t>(i) * size + k];
+                        const double* b_row = B + static_cast<size_t>(k) * size;
+                        for (int j = jj; j < j_end; j++) {
+                            c_row[j] += a * b_row[j];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void multiplyTiledPrivate(const double* A, const double* B, double* C, int size, int tile) {
+    PERF_SCOPE("Matrix multiply (tiled, private)");
+    #pragma omp parallel
+    {
+        // Private: a C tile and a packed B tile, both contiguous and tile x tile
+        std::vector<double> c_tile(static_cast<size_t>(tile) * tile);
+        std::vector<double> b_tile(static_cast<size_t>(tile) * tile);
+
+        #pragma omp for collapse(2)
+        for (int ii = 0; ii < size; ii += tile) {
+            for (int jj = 0; jj < size; jj += tile) {
+                const int rows = std::min(tile, size - ii);
+                const int cols = std::min(tile, size - jj);
+                std::fill(c_tile.begin(), c_tile.end(), 0.0);
+
+                for (int kk = 0; kk < size; kk += tile) {
+                    const int depth = std::min(tile, size - kk);
+                    for (int k = 0; k < depth; k++) {
+                        std::copy(B + static_cast<size_t>(kk + k) * size + jj,
+                                  B + static_cast<size_t>(kk + k) * size + jj + cols,
+                                  b_tile.begin() + static_cast<size_t>(k) * tile);
+                    }
+                    for (int i = 0; i < rows; i++) {
+                        const double* a_row = A + static_cast<size_t>(ii + i) * size + kk;
+                        double* c_row = c_tile.data() + static_cast<size_t>(i) * tile;
+                        for (int k = 0; k < depth; k++) {
+                            const double a = a_row[k];
+                            const double* b_row = b_tile.data() + static_cast<size_t>(k) * tile;
+                            for (int j = 0; j < cols; j++) {
+                                c_row[j] += a * b_row[j];
+                            }
+                        }
+                    }
+                }
+
+                for (int i = 0; i < rows; i++) {
+                    std::copy(c_tile.begin() + static_cast<size_t>(i) * tile,
+                              c_tile.begin() + static_cast<size_t>(i) * tile + cols,
+                              C + static_cast<size_t>(ii + i) * size + jj);
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+const char* matrixKernelName(MatrixKernel kernel) {
+    switch (kernel) {
+        case MatrixKernel::Transposed: return "transposed B";
+        case MatrixKernel::RowAccum: return "i-k-j row accum";
+        case MatrixKernel::TiledShared: return "tiled, shared C";
+        case MatrixKernel::TiledPrivate: return "tiled, private";
+        default: return "naive i-j-k";
+    }
+}
+
+const char* matrixKernelSharing(MatrixKernel kernel) {
+    switch (kernel) {
+        case MatrixKernel::Transposed: return "A, C, B^T shared";
+        case MatrixKernel::RowAccum: return "A, B, C shared; C row private";
+        case MatrixKernel::TiledShared: return "A, B, C shared";
+        case MatrixKernel::TiledPrivate: return "A, B, C shared; C and B tiles private";
+        default: return "A, B, C shared";
+    }
+}
+
+double matrixKernelWorkingSetBytes(MatrixKernel kernel, int size, int tile) {
+    const double CACHE_LINE = 64.0;
+    const double n = size;
+    const double t = std::max(std::min(tile, size), 1);
+    switch (kernel) {
+        case MatrixKernel::Transposed: return 2.0 * n * sizeof(double);         // A row + B^T row
+        case MatrixKernel::RowAccum: return 2.0 * n * sizeof(double);           // C row + B row
+        case MatrixKernel::TiledShared:
+        case MatrixKernel::TiledPrivate: return 3.0 * t * t * sizeof(double);   // A, B and C tiles
+        default: return n * sizeof(double) + n * CACHE_LINE;                    // A row + B column lines
+    }
+}
+
+void multiplyMatrices(MatrixKernel kernel, const std::vector<double>& A, const std::vector<double>& B,
+                      std::vector<double>& C, int size, int tile) {
+    C.resize(static_cast<size_t>(size) * size);
+    tile = std::max(tile, 1);
+    switch (kernel) {
+        case MatrixKernel::Transposed: multiplyTransposed(A.data(), B.data(), C.data(), size); break;
+        case MatrixKernel::RowAccum: multiplyRowAccum(A.data(), B.data(), C.data(), size); break;
+        case MatrixKernel::TiledShared: multiplyTiledShared(A.data(), B.data(), C.data(), size, tile); break;
+        case MatrixKernel::TiledPrivate: multiplyTiledPrivate(A.data(), B.data(), C.data(), size, tile); break;
+        default: multiplyNaive(A.data(), B.data(), C.data(), size); break;
+    }
+}
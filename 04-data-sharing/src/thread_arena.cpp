@@ -0,0 +1,105 @@
+#include "thread_arena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <omp.h>
+
+namespace {
+
+// threadprivate needs a variable with static storage; a plain pointer keeps it
+// portable to runtimes that reject class types with constructors (MSVC's OpenMP 2.0)
+ScratchArena* thread_arena = nullptr;
+#pragma omp threadprivate(thread_arena)
+
+// Owns every arena so they are freed at exit; touched once per thread
+std::mutex registry_mutex;
+std::vector<std::unique_ptr<ScratchArena>>& registry() {
+    static std::vector<std::unique_ptr<ScratchArena>> arenas;
+    return arenas;
+}
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+ScratchArena::ScratchArena(size_t block_bytes) : block_bytes_(block_bytes > 0 ? block_bytes : 1) {}
+
+ScratchArena::~ScratchArena() {
+    for (const Block& block : blocks_) {
+        std::free(block.data);
+    }
+}
+
+void* ScratchArena::allocate(size_t bytes, size_t alignment) {
+    if (bytes == 0) {
+        bytes = 1;
+    }
+    // Walk forward through the blocks kept from earlier regions before growing
+    while (current_ < blocks_.size()) {
+        const Block& block = blocks_[current_];
+        const uintptr_t base = reinterpret_cast<uintptr_t>(block.data);
+        const size_t start = alignUp(base + offset_, alignment) - base;
+        if (start + bytes <= block.size) {
+            offset_ = start + bytes;
+            return block.data + start;
+        }
+        if (current_ + 1 == blocks_.size()) {
+            break;
+        }
+        current_++;
+        offset_ = 0;
+    }
+
+    // malloc aligns to max_align_t; over-allocate for anything stricter
+    const size_t size = std::max(block_bytes_, bytes + alignment);
+    char* data = static_cast<char*>(std::malloc(size));
+    if (data == nullptr) {
+        throw std::bad_alloc();
+    }
+    heap_allocations_++;
+    blocks_.push_back({data, size});
+    current_ = blocks_.size() - 1;
+    const uintptr_t base = reinterpret_cast<uintptr_t>(data);
+    const size_t start = alignUp(base, alignment) - base;
+    offset_ = start + bytes;
+    return data + start;
+}
+
+void ScratchArena::rewind(const Marker& m) {
+    current_ = m.block;
+    offset_ = m.offset;
+}
+
+size_t ScratchArena::bytesUsed() const {
+    if (blocks_.empty()) {
+        return 0;
+    }
+    size_t used = offset_;
+    for (size_t b = 0; b < current_; b++) {
+        used += blocks_[b].size;
+    }
+    return used;
+}
+
+size_t ScratchArena::bytesReserved() const {
+    size_t reserved = 0;
+    for (const Block& block : blocks_) {
+        reserved += block.size;
+    }
+    return reserved;
+}
+
+ScratchArena& threadArena() {
+    if (thread_arena == nullptr) {
+        auto arena = std::make_unique<ScratchArena>();
+        thread_arena = arena.get();
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        registry().push_back(std::move(arena));
+    }
+    return *thread_arena;
+}
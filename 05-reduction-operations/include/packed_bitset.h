@@ -0,0 +1,56 @@
+#ifndef PACKED_BITSET_H
+#define PACKED_BITSET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Bits packed 64 to a word. Unlike std::vector<bool>, the words are plain uint64_t:
+// reductions process 64 bits per operation and vectorize, and threads that own
+// different words never write to the same memory location.
+//
+// Bits past size() in the last word are always zero.
+class PackedBitset {
+public:
+    static constexpr size_t BITS_PER_WORD = 64;
+
+    PackedBitset() = default;
+    explicit PackedBitset(size_t size, bool value = false);
+
+    // Pack a std::vector<bool>, one word per iteration in parallel
+    static PackedBitset from_bools(const std::vector<bool>& bits);
+
+    size_t size() const { return size_; }
+    size_t word_count() const { return words_.size(); }
+
+    bool test(size_t index) const {
+        return (words_[index / BITS_PER_WORD] >> (index % BITS_PER_WORD)) & 1u;
+    }
+    void set(size_t index, bool value);
+
+    const uint64_t* words() const { return words_.data(); }
+    uint64_t* words() { return words_.data(); }
+
+    // Valid bits of the last word
+    uint64_t last_word_mask() const;
+
+private:
+    std::vector<uint64_t> words_;
+    size_t size_ = 0;
+};
+
+// Logical AND / OR of every bit, read word by word with no early exit
+// (reduction(&) / reduction(|) over the words)
+bool bitset_reduce_and(const PackedBitset& bits);
+bool bitset_reduce_or(const PackedBitset& bits);
+
+// Same answers, but threads stop as soon as any of them finds a clear bit (all)
+// or a set bit (any); the data is scanned in chunks of BITSET_SCAN_CHUNK words
+constexpr size_t BITSET_SCAN_CHUNK = 1024;
+bool bitset_all(const PackedBitset& bits);
+bool bitset_any(const PackedBitset& bits);
+
+// Number of set bits
+size_t bitset_count(const PackedBitset& bits);
+
+#endif // PACKED_BITSET_H
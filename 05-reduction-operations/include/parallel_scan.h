@@ -0,0 +1,134 @@
+#ifndef PARALLEL_SCAN_H
+#define PARALLEL_SCAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <vector>
+#include <omp.h>
+
+// Prefix sums (scans) over any associative operator.
+//
+// inclusive: out[i] = in[0] op in[1] op ... op in[i]
+// exclusive: out[i] = identity op in[0] op ... op in[i - 1]
+//
+// The parallel versions use two passes over one contiguous block per thread:
+// pass 1 reduces each block, the block totals are scanned (one per thread), and
+// pass 2 scans each block starting from its offset. in and out may be the same array.
+
+// The OpenMP 5.0 scan directive (reduction(inscan, ...)): GCC 10+ and Clang 11+
+// implement it while still reporting an older _OPENMP version
+#if (defined(_OPENMP) && _OPENMP >= 201811) || \
+    (defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 10) || \
+    (defined(__clang__) && __clang_major__ >= 11)
+#define PARALLEL_SCAN_HAS_OMP_SCAN 1
+#endif
+
+// In-register SIMD scans of int32_t addition (SSE2, or AVX2 when compiled for it),
+// starting from carry; return the last inclusive value
+int32_t inclusive_scan_add_simd(const int32_t* in, int32_t* out, size_t size, int32_t carry);
+int32_t exclusive_scan_add_simd(const int32_t* in, int32_t* out, size_t size, int32_t carry);
+
+// Sequential scan of one block starting from carry; returns the running value
+// after the block. int32_t addition takes the SIMD kernels.
+template <typename T, typename Op>
+T scan_block(const T* in, T* out, size_t size, T carry, Op op, bool inclusive) {
+    constexpr bool simd_add = std::is_same<T, int32_t>::value &&
+        (std::is_same<Op, std::plus<T>>::value || std::is_same<Op, std::plus<>>::value);
+    if constexpr (simd_add) {
+        return inclusive ? inclusive_scan_add_simd(in, out, size, carry)
+                         : exclusive_scan_add_simd(in, out, size, carry);
+    } else {
+        T running = carry;
+        if (inclusive) {
+            for (size_t i = 0; i < size; ++i) {
+                running = op(running, in[i]);
+                out[i] = running;
+            }
+        } else {
+            for (size_t i = 0; i < size; ++i) {
+                const T value = in[i];
+                out[i] = running;
+                running = op(running, value);
+            }
+        }
+        return running;
+    }
+}
+
+// Below this size (or with one thread) the extra pass costs more than it saves
+constexpr size_t SCAN_PARALLEL_THRESHOLD = 1 << 15;
+
+template <typename T, typename Op>
+void parallel_scan(const T* in, T* out, size_t size, T identity, Op op, bool inclusive) {
+    if (size < SCAN_PARALLEL_THRESHOLD || omp_get_max_threads() == 1) {
+        scan_block(in, out, size, identity, op, inclusive);
+        return;
+    }
+    std::vector<T> offsets(static_cast<size_t>(omp_get_max_threads()) + 1, identity);
+
+    #pragma omp parallel
+    {
+        const size_t threads = static_cast<size_t>(omp_get_num_threads());
+        const size_t thread = static_cast<size_t>(omp_get_thread_num());
+        const size_t begin = size * thread / threads;
+        const size_t end = size * (thread + 1) / threads;
+
+        // Pass 1: block total only, so the block is written once (in pass 2)
+        T total = identity;
+        for (size_t i = begin; i < end; ++i) {
+            total = op(total, in[i]);
+        }
+        offsets[thread + 1] = total;
+
+        #pragma omp barrier
+        #pragma omp single
+        {
+            for (size_t t = 1; t <= threads; ++t) {
+                offsets[t] = op(offsets[t - 1], offsets[t]);
+            }
+        }
+
+        // Pass 2: scan the block from the total of everything before it
+        scan_block(in + begin, out + begin, end - begin, offsets[thread], op, inclusive);
+    }
+}
+
+template <typename T, typename Op>
+void inclusive_scan_parallel(const T* in, T* out, size_t size, T identity, Op op) {
+    parallel_scan(in, out, size, identity, op, true);
+}
+
+template <typename T, typename Op>
+void exclusive_scan_parallel(const T* in, T* out, size_t size, T identity, Op op) {
+    parallel_scan(in, out, size, identity, op, false);
+}
+
+#ifdef PARALLEL_SCAN_HAS_OMP_SCAN
+// Addition scans written with the OpenMP 5.0 scan directive; the compiler
+// generates the two passes itself
+template <typename T>
+void inclusive_scan_omp_directive(const T* in, T* out, size_t size) {
+    T sum = T();
+    #pragma omp parallel for reduction(inscan, +:sum)
+    for (long long i = 0; i < static_cast<long long>(size); ++i) {
+        sum += in[i];
+        #pragma omp scan inclusive(sum)
+        out[i] = sum;
+    }
+}
+
+template <typename T>
+void exclusive_scan_omp_directive(const T* in, T* out, size_t size) {
+    T sum = T();
+    #pragma omp parallel for reduction(inscan, +:sum)
+    for (long long i = 0; i < static_cast<long long>(size); ++i) {
+        out[i] = sum;
+        #pragma omp scan exclusive(sum)
+        sum += in[i];
+    }
+}
+#endif
+
+#endif // PARALLEL_SCAN_H
@@ -0,0 +1,29 @@
+#ifndef REPRODUCIBLE_SUM_H
+#define REPRODUCIBLE_SUM_H
+
+#include <cstddef>
+#include <vector>
+
+// A plain reduction(+:sum) adds the elements in an order that depends on the
+// team size and schedule, so its bits change with the thread count. The
+// reproducible sum fixes the order instead: the data is cut into blocks of
+// REPRODUCIBLE_BLOCK_SIZE elements regardless of the threads, each block is added
+// in REPRODUCIBLE_LANES interleaved partial sums, and the block results are
+// combined in a fixed pairwise tree. Threads only decide who computes which block.
+//
+// The order is fixed in the source, so value-changing optimizations such as
+// -ffast-math or /fp:fast must stay off for this file.
+
+constexpr size_t REPRODUCIBLE_BLOCK_SIZE = 4096;
+constexpr int REPRODUCIBLE_LANES = 8;
+
+enum class ReproducibleMode {
+    Plain,        // Fixed-order sum
+    Compensated   // Fixed-order Kahan sum per lane, error terms carried through the tree
+};
+
+// Sum of data, bitwise identical for every num_threads (0 = omp_get_max_threads())
+double reproducible_sum(const std::vector<double>& data, ReproducibleMode mode = ReproducibleMode::Plain,
+                        int num_threads = 0);
+
+#endif // REPRODUCIBLE_SUM_H
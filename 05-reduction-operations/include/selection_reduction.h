@@ -0,0 +1,38 @@
+#ifndef SELECTION_REDUCTION_H
+#define SELECTION_REDUCTION_H
+
+#include <cstddef>
+#include <vector>
+
+// A value with its position, reduced as one unit so the index travels with the value
+struct ValueIndex {
+    double value;
+    long long index;  // -1 when empty
+};
+
+// value first, then the lower index on ties: the order every routine here ranks by,
+// which makes the results independent of thread count and merge order
+inline bool ranks_higher(const ValueIndex& a, const ValueIndex& b) {
+    return a.value > b.value || (a.value == b.value && a.index < b.index);
+}
+
+// Elements per block in arg-min/arg-max: a vectorized min/max over the block, and
+// the index is looked up only when the block improves on the best so far
+constexpr size_t ARG_EXTREME_BLOCK_SIZE = 4096;
+
+// Up to this k each thread keeps a bounded heap; above it, each thread selects its
+// k best with nth_element instead
+constexpr size_t TOPK_HEAP_LIMIT = 1024;
+
+// First occurrence of the smallest / largest value ({NaN, -1} for empty data;
+// NaN values are not supported)
+ValueIndex argmin_parallel(const std::vector<double>& data);
+ValueIndex argmax_parallel(const std::vector<double>& data);
+ValueIndex argmin_sequential(const std::vector<double>& data);
+ValueIndex argmax_sequential(const std::vector<double>& data);
+
+// The min(k, size) largest elements in ranks_higher order
+std::vector<ValueIndex> top_k_parallel(const std::vector<double>& data, size_t k);
+std::vector<ValueIndex> top_k_sequential(const std::vector<double>& data, size_t k);
+
+#endif // SELECTION_REDUCTION_H
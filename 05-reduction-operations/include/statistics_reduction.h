@@ -0,0 +1,88 @@
+#ifndef STATISTICS_REDUCTION_H
+#define STATISTICS_REDUCTION_H
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+// Count, mean and central moments, merged with Chan et al.'s pairwise formulas so
+// that partial results from any split of the data combine exactly like one pass
+struct RunningStats {
+    long long count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;  // Sum of squared deviations from the mean
+    double m3 = 0.0;  // Sum of cubed deviations from the mean
+
+    // Welford update with one value
+    void add(double value);
+
+    // Add a contiguous block: its own mean and moments first (vectorizable), then one merge
+    void add_block(const double* values, size_t size);
+
+    void merge(const RunningStats& other);
+
+    double variance() const;         // Sample variance (n - 1)
+    double standard_deviation() const;
+    double skewness() const;         // Population skewness g1
+};
+
+// Smallest and largest value with the index of their first occurrence
+struct ExtremeValues {
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    long long min_index = -1;
+    long long max_index = -1;
+
+    // Scan values[0..size), which sit at offset in the full array
+    void add_block(const double* values, size_t size, long long offset);
+
+    // Ties keep the lower index, so the result does not depend on the merge order
+    void merge(const ExtremeValues& other);
+};
+
+// Fixed-width bins over [lower, upper]; values outside land in underflow/overflow
+struct Histogram {
+    double lower = 0.0;
+    double upper = 1.0;
+    std::vector<long long> counts;
+    long long underflow = 0;
+    long long overflow = 0;
+
+    Histogram() = default;
+    Histogram(double lower, double upper, int bins);
+
+    // Same bins, all counts zero (the identity for merge)
+    Histogram empty_copy() const;
+
+    void add_block(const double* values, size_t size);
+    void merge(const Histogram& other);
+};
+
+struct StatisticsSummary {
+    RunningStats moments;
+    ExtremeValues extremes;
+    Histogram histogram;
+
+    void merge(const StatisticsSummary& other);
+};
+
+// Elements per block in the single-pass kernels; small enough to stay in L1 while
+// the block is scanned for moments, extremes and bins
+constexpr size_t STATISTICS_BLOCK_SIZE = 2048;
+
+// Moments, extremes with index and a histogram in one parallel pass over data,
+// combined with user-defined reductions (declare reduction, OpenMP 4.0) or, on
+// OpenMP 2.0 compilers, per-thread partials merged in a critical section
+StatisticsSummary statistics_parallel_single_pass(const std::vector<double>& data,
+                                                  double hist_lower, double hist_upper, int bins);
+
+// Same over values[0..size); extreme indices are reported as first_index + i, so
+// a chunk of a larger array keeps its global positions
+StatisticsSummary statistics_parallel_single_pass(const double* values, size_t size, long long first_index,
+                                                  double hist_lower, double hist_upper, int bins);
+
+// The same summary sequentially, block by block, as the validation reference
+StatisticsSummary statistics_sequential(const std::vector<double>& data,
+                                        double hist_lower, double hist_upper, int bins);
+
+#endif // STATISTICS_REDUCTION_H
@@ -0,0 +1,61 @@
+#ifndef STREAMING_REDUCTION_H
+#define STREAMING_REDUCTION_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+// Reductions over binary files larger than memory. The file is a raw array of one
+// element type; it is consumed in chunks, each chunk is reduced by an ordinary
+// parallel reduction, and the partial results are merged in file order.
+
+enum class StreamMethod {
+    MemoryMap,      // mmap / MapViewOfFile the file; the next chunk is prefetched with madvise
+    BufferedRead    // fread into two buffers; the next chunk is read while this one is reduced
+};
+
+struct StreamOptions {
+    size_t chunk_bytes = 64 * 1024 * 1024;  // Rounded to a multiple of the page size
+    StreamMethod method = StreamMethod::MemoryMap;
+};
+
+struct StreamStats {
+    size_t bytes = 0;          // Bytes reduced (whole elements only)
+    size_t chunks = 0;
+    double seconds = 0.0;
+
+    double gigabytes_per_second() const {
+        return seconds > 0.0 ? static_cast<double>(bytes) / seconds / 1e9 : 0.0;
+    }
+};
+
+// Called once per chunk, in file order: data holds count elements, the first of
+// which is element first_index of the file
+using ChunkConsumer = std::function<void(const void* data, size_t count, size_t first_index)>;
+
+// Stream path through consume in chunks of whole elements. Returns false if the
+// file cannot be opened, mapped or read.
+bool stream_file_chunks(const std::string& path, size_t element_size, const StreamOptions& options,
+                        const ChunkConsumer& consume, StreamStats* stats = nullptr);
+
+// Reduce a file of T: reduce_chunk(values, count, first_index) returns the chunk's
+// partial result (and is expected to be parallel inside), merge(total, partial)
+// folds it into the running total.
+template <typename T, typename Result, typename ReduceChunk, typename Merge>
+bool stream_reduce(const std::string& path, Result& total, ReduceChunk reduce_chunk, Merge merge,
+                   const StreamOptions& options = StreamOptions(), StreamStats* stats = nullptr) {
+    return stream_file_chunks(path, sizeof(T), options,
+        [&](const void* data, size_t count, size_t first_index) {
+            merge(total, reduce_chunk(static_cast<const T*>(data), count, first_index));
+        }, stats);
+}
+
+// Write count pseudo-random doubles in [0, 100) to path, for demos and tests.
+// Returns false on I/O failure.
+bool write_random_doubles_file(const std::string& path, size_t count);
+
+// Best effort: drop the file's pages from the OS page cache, so the next read
+// measures the storage device rather than memory (no-op where unsupported)
+void evict_file_from_page_cache(const std::string& path);
+
+#endif // STREAMING_REDUCTION_H
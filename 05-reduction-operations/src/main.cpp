@@ -2,21 +2,39 @@
 #include <iomanip>
 #include <vector>
 #include <random>
-#include <chrono>
 #include <cmath>
 #include <string>
 #include <omp.h>
 #include <fstream>
+#include "statistics_reduction.h"
+#include "reproducible_sum.h"
+#include "packed_bitset.h"
+#include "streaming_reduction.h"
+#include "parallel_scan.h"
+#include "selection_reduction.h"
+#include "perf_markers.h"
+#include "bench_core.h"
+#include <cstdio>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <set>
 
-// Helper functions for timing
-auto get_time() {
-    return std::chrono::high_resolution_clock::now();
+// Helper functions for timing, on the shared calibrated clock (bench_core.h)
+bench::Clock::Ticks get_time() {
+    return bench::Clock::now();
 }
 
-template <typename TimePoint>
-double get_elapsed_time(const TimePoint& start, const TimePoint& end) {
-    // Explicit casting to double to avoid precision loss warning
-    return static_cast<double>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
+// Whole milliseconds
+double get_elapsed_time(bench::Clock::Ticks start, bench::Clock::Ticks end) {
+    return std::floor(bench::Clock::toMilliseconds(end - start));
+}
+
+// Fractional milliseconds, for kernels that finish well under 1 ms
+double get_elapsed_time_precise(bench::Clock::Ticks start, bench::Clock::Ticks end) {
+    return bench::Clock::toMilliseconds(end - start);
 }
 
 // Helper to generate random values
@@ -65,6 +83,7 @@ double sum_sequential(const std::vector<double>& data) {
 
 // 2. Parallel sum with critical section (inefficient)
 double sum_parallel_critical(const std::vector<double>& data) {
+    PERF_SCOPE("Sum (critical)");
     double sum = 0.0;
     auto start = get_time();
     
@@ -84,6 +103,7 @@ double sum_parallel_critical(const std::vector<double>& data) {
 
 // 3. Parallel sum with atomic (better than critical, but still has overhead)
 double sum_parallel_atomic(const std::vector<double>& data) {
+    PERF_SCOPE("Sum (atomic)");
     double sum = 0.0;
     auto start = get_time();
     
@@ -101,6 +121,7 @@ double sum_parallel_atomic(const std::vector<double>& data) {
 
 // 4. Manual reduction (local sums then combine)
 double sum_parallel_manual(const std::vector<double>& data) {
+    PERF_SCOPE("Sum (manual partials)");
     double sum = 0.0;
     auto start = get_time();
     
@@ -127,6 +148,7 @@ double sum_parallel_manual(const std::vector<double>& data) {
 
 // 5. OpenMP reduction (most efficient)
 double sum_parallel_reduction(const std::vector<double>& data) {
+    PERF_SCOPE("Sum (reduction clause)");
     double sum = 0.0;
     auto start = get_time();
     
@@ -141,6 +163,99 @@ double sum_parallel_reduction(const std::vector<double>& data) {
     return sum;
 }
 
+// 6. Reproducible reduction (identical bits at any thread count)
+double sum_parallel_reproducible(const std::vector<double>& data, ReproducibleMode mode = ReproducibleMode::Plain) {
+    PERF_SCOPE("Sum (reproducible)");
+    auto start = get_time();
+    double sum = reproducible_sum(data, mode);
+    auto end = get_time();
+    std::cout << "  Parallel Sum (reproducible" << (mode == ReproducibleMode::Compensated ? ", Kahan" : "") << "): "
+              << std::fixed << std::setprecision(2)
+              << sum << " (Time: " << get_elapsed_time(start, end) << " ms)" << std::endl;
+    return sum;
+}
+
+// Bit pattern of a double, for exact comparison
+uint64_t double_bits(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// Sum with every thread count from the list: the plain reduction may change in the
+// last bits, the reproducible sums must not. Also reports their cost.
+void reproducibility_check(const std::vector<double>& data) {
+    std::vector<int> thread_counts = {1, 2, 3, 4, 8, omp_get_max_threads()};
+    std::set<uint64_t> plain_results, repro_results, kahan_results;
+    const long long n = static_cast<long long>(data.size());
+    
+    for (int threads : thread_counts) {
+        double sum = 0.0;
+        #pragma omp parallel for reduction(+:sum) num_threads(threads)
+        for (long long i = 0; i < n; ++i) {
+            sum += data[i];
+        }
+        plain_results.insert(double_bits(sum));
+        repro_results.insert(double_bits(reproducible_sum(data, ReproducibleMode::Plain, threads)));
+        kahan_results.insert(double_bits(reproducible_sum(data, ReproducibleMode::Compensated, threads)));
+    }
+    
+    // Overhead: average over repeated runs (the timer has millisecond resolution)
+    const int runs = 10;
+    double plain_sum = 0.0, repro_sum = 0.0, kahan_sum = 0.0;
+    auto start = get_time();
+    for (int r = 0; r < runs; ++r) {
+        double sum = 0.0;
+        #pragma omp parallel for reduction(+:sum)
+        for (long long i = 0; i < n; ++i) {
+            sum += data[i];
+        }
+        plain_sum = sum;
+    }
+    auto end = get_time();
+    double plain_time = std::max(0.1, get_elapsed_time(start, end) / runs);
+    
+    start = get_time();
+    for (int r = 0; r < runs; ++r) {
+        repro_sum = reproducible_sum(data, ReproducibleMode::Plain);
+    }
+    end = get_time();
+    double repro_time = std::max(0.1, get_elapsed_time(start, end) / runs);
+    
+    start = get_time();
+    for (int r = 0; r < runs; ++r) {
+        kahan_sum = reproducible_sum(data, ReproducibleMode::Compensated);
+    }
+    end = get_time();
+    double kahan_time = std::max(0.1, get_elapsed_time(start, end) / runs);
+    
+    // Compensated extended-precision sequential sum as the accuracy reference
+    long double reference = 0.0L;
+    long double compensation = 0.0L;
+    for (const auto& val : data) {
+        const long double y = static_cast<long double>(val) - compensation;
+        const long double t = reference + y;
+        compensation = (t - reference) - y;
+        reference = t;
+    }
+    
+    std::cout << "Reproducibility across " << thread_counts.size() << " thread counts:\n";
+    std::cout << "  reduction(+:sum):      " << plain_results.size() << " distinct result(s)\n";
+    std::cout << "  Reproducible:          " << repro_results.size() << " distinct result(s)\n";
+    std::cout << "  Reproducible (Kahan):  " << kahan_results.size() << " distinct result(s)\n";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  Time per sum: reduction " << plain_time << " ms, reproducible " << repro_time
+              << " ms (" << repro_time / plain_time << "x), Kahan " << kahan_time
+              << " ms (" << kahan_time / plain_time << "x)\n";
+    std::cout << std::scientific << std::setprecision(3);
+    std::cout << "  Error vs long double: reduction " << std::abs(static_cast<long double>(plain_sum) - reference)
+              << ", reproducible " << std::abs(static_cast<long double>(repro_sum) - reference)
+              << ", Kahan " << std::abs(static_cast<long double>(kahan_sum) - reference) << "\n";
+    std::cout << std::fixed;
+    std::cout << "  Validation: Reproducible=" << std::boolalpha << (repro_results.size() == 1)
+              << ", Kahan=" << (kahan_results.size() == 1) << std::endl;
+}
+
 // Product reduction examples
 
 // Sequential product
@@ -160,6 +275,7 @@ double product_sequential(const std::vector<double>& data) {
 
 // Parallel product with OpenMP reduction
 double product_parallel_reduction(const std::vector<double>& data) {
+    PERF_SCOPE("Product (reduction clause)");
     double product = 1.0;
     auto start = get_time();
     
@@ -195,6 +311,7 @@ void minmax_sequential(const std::vector<double>& data, double& min_val, double&
 
 // Parallel min/max with OpenMP manual reduction
 void minmax_parallel_reduction(const std::vector<double>& data, double& min_val, double& max_val) {
+    PERF_SCOPE("Min/max (reduction clause)");
     min_val = data[0];
     max_val = data[0];
     auto start = get_time();
@@ -224,6 +341,57 @@ void minmax_parallel_reduction(const std::vector<double>& data, double& min_val,
               << get_elapsed_time(start, end) << " ms)" << std::endl;
 }
 
+// Arg-min/arg-max and top-k, checked against the sequential min/max and a full partial_sort
+void selection_example(const std::vector<double>& data, double seq_min, double seq_max) {
+    auto start = get_time();
+    ValueIndex min_seq = argmin_sequential(data);
+    ValueIndex max_seq = argmax_sequential(data);
+    auto end = get_time();
+    double seq_time = get_elapsed_time_precise(start, end);
+    
+    start = get_time();
+    ValueIndex min_par = argmin_parallel(data);
+    ValueIndex max_par = argmax_parallel(data);
+    end = get_time();
+    double par_time = get_elapsed_time_precise(start, end);
+    
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  ArgMin/ArgMax: min " << min_par.value << " at [" << min_par.index << "], max "
+              << max_par.value << " at [" << max_par.index << "]" << std::endl;
+    std::cout << std::setprecision(3);
+    std::cout << "    Time: " << par_time << " ms (parallel) vs " << seq_time << " ms (min_element/max_element)" << std::endl;
+    
+    bool arg_valid = min_par.value == seq_min && max_par.value == seq_max
+        && min_par.index == min_seq.index && max_par.index == max_seq.index;
+    
+    // Small k takes the per-thread heaps, large k the per-thread selection
+    bool topk_valid = true;
+    const size_t ks[] = {10, std::max<size_t>(TOPK_HEAP_LIMIT + 1, data.size() / 100)};
+    for (size_t k : ks) {
+        start = get_time();
+        std::vector<ValueIndex> reference = top_k_sequential(data, k);
+        end = get_time();
+        double ref_time = get_elapsed_time_precise(start, end);
+        
+        start = get_time();
+        std::vector<ValueIndex> top = top_k_parallel(data, k);
+        end = get_time();
+        double top_time = get_elapsed_time_precise(start, end);
+        
+        bool same = top.size() == reference.size();
+        for (size_t i = 0; same && i < top.size(); ++i) {
+            same = top[i].value == reference[i].value && top[i].index == reference[i].index;
+        }
+        topk_valid = topk_valid && same;
+        std::cout << "    Top-" << k << (k <= TOPK_HEAP_LIMIT ? " (heaps): " : " (selection): ")
+                  << top_time << " ms vs " << ref_time << " ms (partial_sort)" << std::endl;
+    }
+    std::cout << std::setprecision(2);
+    
+    std::cout << "  Validation: ArgMinMax=" << std::boolalpha << arg_valid
+              << ", TopK=" << topk_valid << std::endl;
+}
+
 // Logical operations reduction
 
 // Sequential logical AND/OR
@@ -245,6 +413,7 @@ void logical_sequential(const std::vector<bool>& data, bool& result_and, bool& r
 
 // Parallel logical AND/OR with OpenMP reduction
 void logical_parallel_reduction(const std::vector<bool>& data, bool& result_and_ref, bool& result_or_ref) {
+    PERF_SCOPE("Logical and/or (reduction clause)");
     // Create non-reference copies to use in reduction
     bool result_and = true;
     bool result_or = false;
@@ -266,6 +435,80 @@ void logical_parallel_reduction(const std::vector<bool>& data, bool& result_and_
               << get_elapsed_time(start, end) << " ms)" << std::endl;
 }
 
+// Logical reductions on a packed bitset vs std::vector<bool>
+void packed_logical_comparison(const std::vector<bool>& data) {
+    const int runs = 20;
+    const long long n = static_cast<long long>(data.size());
+    PackedBitset bits = PackedBitset::from_bools(data);
+    
+    // std::vector<bool> path: the same loop as logical_parallel_reduction plus a count
+    bool vec_and = true, vec_or = false;
+    long long vec_count = 0;
+    auto start = get_time();
+    for (int r = 0; r < runs; ++r) {
+        bool result_and = true;
+        bool result_or = false;
+        long long count = 0;
+        #pragma omp parallel for reduction(&&:result_and) reduction(||:result_or) reduction(+:count)
+        for (long long i = 0; i < n; ++i) {
+            result_and = result_and && data[i];
+            result_or = result_or || data[i];
+            count += data[i] ? 1 : 0;
+        }
+        vec_and = result_and;
+        vec_or = result_or;
+        vec_count = count;
+    }
+    auto end = get_time();
+    double vec_time = get_elapsed_time_precise(start, end) / runs;
+    
+    // Packed path, full word-at-a-time reductions
+    bool packed_and = true, packed_or = false;
+    size_t packed_count = 0;
+    start = get_time();
+    for (int r = 0; r < runs; ++r) {
+        packed_and = bitset_reduce_and(bits);
+        packed_or = bitset_reduce_or(bits);
+        packed_count = bitset_count(bits);
+    }
+    end = get_time();
+    double packed_time = get_elapsed_time_precise(start, end) / runs;
+    
+    // Early-terminating all/any, on this data and on the worst case for all()
+    // (every bit set, so no chunk can stop the scan)
+    PackedBitset all_set(data.size(), true);
+    bool early_all = true, early_any = false, full_all = false;
+    start = get_time();
+    for (int r = 0; r < runs; ++r) {
+        early_all = bitset_all(bits);
+        early_any = bitset_any(bits);
+    }
+    end = get_time();
+    double early_time = get_elapsed_time_precise(start, end) / runs;
+    
+    start = get_time();
+    for (int r = 0; r < runs; ++r) {
+        full_all = bitset_all(all_set);
+    }
+    end = get_time();
+    double full_all_time = get_elapsed_time_precise(start, end) / runs;
+    
+    std::cout << "Packed Bitset Logical Reductions (" << bits.word_count() << " words):\n";
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "  std::vector<bool>: AND=" << std::boolalpha << vec_and << ", OR=" << vec_or
+              << ", Count=" << vec_count << " (Time: " << vec_time << " ms)\n";
+    std::cout << "  PackedBitset:      AND=" << packed_and << ", OR=" << packed_or
+              << ", Count=" << packed_count << " (Time: " << packed_time << " ms, Speedup: "
+              << std::setprecision(1) << vec_time / packed_time << "x)\n" << std::setprecision(3);
+    std::cout << "  Early exit:        all=" << early_all << ", any=" << early_any
+              << " (Time: " << early_time << " ms); all() on all-set bits: " << full_all
+              << " (Time: " << full_all_time << " ms)\n";
+    std::cout << "  Validation: AND=" << (vec_and == packed_and && vec_and == early_all)
+              << ", OR=" << (vec_or == packed_or && vec_or == early_any)
+              << ", Count=" << (static_cast<size_t>(vec_count) == packed_count)
+              << ", AllSet=" << (full_all && bitset_count(all_set) == data.size()) << std::endl;
+}
+
 // Bitwise operations reduction
 
 // Sequential bitwise operations
@@ -290,6 +533,7 @@ void bitwise_sequential(const std::vector<int>& data, int& result_and, int& resu
 
 // Parallel bitwise operations with OpenMP reduction
 void bitwise_parallel_reduction(const std::vector<int>& data, int& result_and_ref, int& result_or_ref, int& result_xor_ref) {
+    PERF_SCOPE("Bitwise and/or/xor (reduction clause)");
     // Create non-reference copies to use in reduction
     int result_and = ~0; // All bits set to 1
     int result_or = 0;   // All bits set to 0
@@ -352,6 +596,7 @@ void multiple_reductions_example(const std::vector<double>& data) {
 
 // Using the custom reduction for sum of squares
 double sum_of_squares_reduction(const std::vector<double>& data) {
+    PERF_SCOPE("Sum of squares (reduction clause)");
     double sum = 0.0;
     auto start = get_time();
     
@@ -382,6 +627,201 @@ bool validate_results(const T& sequential, const T& parallel, double tolerance =
     }
 }
 
+// Statistics summary the usual way: one sweep over data per quantity
+StatisticsSummary statistics_multi_pass(const std::vector<double>& data, double hist_lower, double hist_upper, int bins) {
+    StatisticsSummary summary;
+    const long long n = static_cast<long long>(data.size());
+    
+    // Pass 1: mean
+    double sum = 0.0;
+    #pragma omp parallel for reduction(+:sum)
+    for (long long i = 0; i < n; ++i) {
+        sum += data[i];
+    }
+    const double mean = sum / static_cast<double>(n);
+    
+    // Pass 2: centered second and third moments
+    double m2 = 0.0;
+    double m3 = 0.0;
+    #pragma omp parallel for reduction(+:m2, m3)
+    for (long long i = 0; i < n; ++i) {
+        const double d = data[i] - mean;
+        m2 += d * d;
+        m3 += d * d * d;
+    }
+    summary.moments.count = n;
+    summary.moments.mean = mean;
+    summary.moments.m2 = m2;
+    summary.moments.m3 = m3;
+    
+    // Pass 3: extremes with index (the value alone is a built-in reduction, its index is not)
+    #pragma omp parallel
+    {
+        ExtremeValues local;
+        #pragma omp for
+        for (long long i = 0; i < n; ++i) {
+            ExtremeValues single;
+            single.min = single.max = data[i];
+            single.min_index = single.max_index = i;
+            local.merge(single);
+        }
+        #pragma omp critical
+        summary.extremes.merge(local);
+    }
+    
+    // Pass 4: histogram
+    summary.histogram = Histogram(hist_lower, hist_upper, bins);
+    summary.histogram.add_block(data.data(), data.size());
+    return summary;
+}
+
+// Full statistics summary in one streaming pass with user-defined reductions
+void statistics_summary_example(const std::vector<double>& data) {
+    const int bins = 10;
+    
+    auto start = get_time();
+    StatisticsSummary single = statistics_parallel_single_pass(data, 0.0, 100.0, bins);
+    auto end = get_time();
+    double single_time = get_elapsed_time(start, end);
+    
+    start = get_time();
+    StatisticsSummary multi = statistics_multi_pass(data, 0.0, 100.0, bins);
+    end = get_time();
+    double multi_time = get_elapsed_time(start, end);
+    
+    StatisticsSummary reference = statistics_sequential(data, 0.0, 100.0, bins);
+    
+    std::cout << "  Statistics Summary (single pass, declare reduction):" << std::endl;
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "    Count=" << single.moments.count
+              << ", Mean=" << single.moments.mean
+              << ", StdDev=" << single.moments.standard_deviation()
+              << ", Skewness=" << single.moments.skewness() << std::endl;
+    std::cout << std::setprecision(2);
+    std::cout << "    Min=" << single.extremes.min << " at [" << single.extremes.min_index << "]"
+              << ", Max=" << single.extremes.max << " at [" << single.extremes.max_index << "]" << std::endl;
+    std::cout << "    Histogram [0, 100] in " << bins << " bins:";
+    for (long long count : single.histogram.counts) {
+        std::cout << " " << count;
+    }
+    std::cout << std::endl;
+    std::cout << "    Time: " << single_time << " ms (1 pass) vs " << multi_time << " ms (4 passes)" << std::endl;
+    
+    // Moments agree to rounding; extremes and bins must match exactly
+    bool moments_valid = validate_results(reference.moments.mean, single.moments.mean)
+        && validate_results(reference.moments.variance(), single.moments.variance())
+        && validate_results(multi.moments.variance(), single.moments.variance())
+        && std::abs(reference.moments.skewness() - single.moments.skewness()) < 1e-9
+        && std::abs(multi.moments.skewness() - single.moments.skewness()) < 1e-9;
+    bool extremes_valid = single.extremes.min_index == multi.extremes.min_index
+        && single.extremes.max_index == multi.extremes.max_index
+        && single.extremes.min == data[single.extremes.min_index]
+        && single.extremes.max == data[single.extremes.max_index];
+    bool histogram_valid = single.histogram.counts == multi.histogram.counts
+        && single.histogram.counts == reference.histogram.counts;
+    
+    std::cout << "  Validation: Moments=" << std::boolalpha << moments_valid
+              << ", Extremes=" << extremes_valid
+              << ", Histogram=" << histogram_valid << std::endl;
+}
+
+// Prefix sums against std::inclusive_scan / std::exclusive_scan: integer sums take
+// the SIMD block kernels, doubles and the running maximum the generic operator path
+void prefix_scan_example(const std::vector<double>& data, std::ofstream* report = nullptr) {
+    const size_t size = data.size();
+    std::vector<int32_t> ints(size);
+    for (size_t i = 0; i < size; ++i) {
+        ints[i] = static_cast<int32_t>(data[i]) % 100;
+    }
+    std::vector<int32_t> int_reference(size), int_result(size);
+    std::vector<double> reference(size), result(size);
+    
+    auto start = get_time();
+    std::inclusive_scan(ints.begin(), ints.end(), int_reference.begin());
+    auto end = get_time();
+    double std_time = get_elapsed_time_precise(start, end);
+    
+    start = get_time();
+    inclusive_scan_parallel(ints.data(), int_result.data(), size, int32_t(0), std::plus<int32_t>());
+    end = get_time();
+    double blocked_time = get_elapsed_time_precise(start, end);
+    bool inclusive_valid = int_result == int_reference;
+    
+    double directive_time = 0.0;
+    bool directive_valid = true;
+#ifdef PARALLEL_SCAN_HAS_OMP_SCAN
+    start = get_time();
+    inclusive_scan_omp_directive(ints.data(), int_result.data(), size);
+    end = get_time();
+    directive_time = get_elapsed_time_precise(start, end);
+    directive_valid = int_result == int_reference;
+#endif
+    
+    start = get_time();
+    std::exclusive_scan(ints.begin(), ints.end(), int_reference.begin(), int32_t(0));
+    end = get_time();
+    double std_exclusive_time = get_elapsed_time_precise(start, end);
+    
+    start = get_time();
+    exclusive_scan_parallel(ints.data(), int_result.data(), size, int32_t(0), std::plus<int32_t>());
+    end = get_time();
+    double exclusive_time = get_elapsed_time_precise(start, end);
+    bool exclusive_valid = int_result == int_reference;
+    
+    // Doubles: the blocked order rounds differently, so compare with a relative tolerance
+    start = get_time();
+    std::inclusive_scan(data.begin(), data.end(), reference.begin());
+    end = get_time();
+    double std_double_time = get_elapsed_time_precise(start, end);
+    
+    start = get_time();
+    inclusive_scan_parallel(data.data(), result.data(), size, 0.0, std::plus<double>());
+    end = get_time();
+    double double_time = get_elapsed_time_precise(start, end);
+    double max_relative_error = 0.0;
+    for (size_t i = 0; i < size; ++i) {
+        max_relative_error = std::max(max_relative_error, std::abs(result[i] - reference[i]) / std::max(1.0, std::abs(reference[i])));
+    }
+    
+    // Any associative operator: running maximum
+    auto max_op = [](double a, double b) { return a > b ? a : b; };
+    std::inclusive_scan(data.begin(), data.end(), reference.begin(), max_op);
+    inclusive_scan_parallel(data.data(), result.data(), size, -std::numeric_limits<double>::infinity(), max_op);
+    bool max_valid = result == reference;
+    
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "  Prefix Scan (" << size << " elements):" << std::endl;
+    std::cout << "    int32 inclusive: std::inclusive_scan " << std_time << " ms, blocked+SIMD " << blocked_time
+              << " ms (" << std_time / std::max(blocked_time, 1e-6) << "x)";
+#ifdef PARALLEL_SCAN_HAS_OMP_SCAN
+    std::cout << ", omp scan " << directive_time << " ms (" << std_time / std::max(directive_time, 1e-6) << "x)";
+#endif
+    std::cout << std::endl;
+    std::cout << "    int32 exclusive: std::exclusive_scan " << std_exclusive_time << " ms, blocked+SIMD " << exclusive_time
+              << " ms (" << std_exclusive_time / std::max(exclusive_time, 1e-6) << "x)" << std::endl;
+    std::cout << "    double inclusive: std::inclusive_scan " << std_double_time << " ms, blocked " << double_time
+              << " ms (" << std_double_time / std::max(double_time, 1e-6) << "x)" << std::endl;
+    std::cout << "  Validation: Inclusive=" << std::boolalpha << inclusive_valid
+              << ", OmpScan=" << directive_valid
+              << ", Exclusive=" << exclusive_valid
+              << ", Double=" << (max_relative_error < 1e-10)
+              << ", RunningMax=" << max_valid << std::endl;
+    std::cout << std::setprecision(2);
+    
+    if (report != nullptr && report->is_open()) {
+        *report << std::fixed << std::setprecision(3);
+        *report << "Prefix Scan:\n";
+        *report << "  int32 inclusive: std " << std_time << " ms, blocked " << blocked_time << " ms";
+#ifdef PARALLEL_SCAN_HAS_OMP_SCAN
+        *report << ", omp scan " << directive_time << " ms";
+#endif
+        *report << "\n";
+        *report << "  int32 exclusive: std " << std_exclusive_time << " ms, blocked " << exclusive_time << " ms\n";
+        *report << "  double inclusive: std " << std_double_time << " ms, blocked " << double_time << " ms\n\n";
+        *report << std::setprecision(2);
+    }
+}
+
 // Run all reduction tests with given data size
 void run_all_tests(size_t data_size) {
     std::cout << "\n--- Running tests with " << data_size << " elements ---" << std::endl;
@@ -438,6 +878,11 @@ void run_all_tests(size_t data_size) {
               << "Sum=" << std::boolalpha << validate_results(seq_sum, par_sum_reduction)
               << std::endl;
     
+    // Test reproducible sums
+    sum_parallel_reproducible(data);
+    sum_parallel_reproducible(data, ReproducibleMode::Compensated);
+    reproducibility_check(data);
+    
     // Test product operations (using specialized data)
     start = get_time();
     double seq_product = product_sequential(product_data);
@@ -467,6 +912,7 @@ void run_all_tests(size_t data_size) {
               << "Min=" << std::boolalpha << validate_results(seq_min, par_min)
               << ", Max=" << validate_results(seq_max, par_max)
               << std::endl;
+    selection_example(data, seq_min, seq_max);
     
     // Test logical operations
     bool seq_and, seq_or, par_and, par_or;
@@ -480,6 +926,7 @@ void run_all_tests(size_t data_size) {
               << "AND=" << std::boolalpha << validate_results(seq_and, par_and)
               << ", OR=" << validate_results(seq_or, par_or)
               << std::endl;
+    packed_logical_comparison(bool_data);
     
     // Test bitwise operations
     int seq_and_int, seq_or_int, seq_xor_int;
@@ -513,6 +960,150 @@ void run_all_tests(size_t data_size) {
     std::cout << "  Validation: "
               << std::boolalpha << validate_results(seq_sum_of_squares, par_sum_of_squares)
               << std::endl;
+    
+    // Test single-pass statistics summary
+    statistics_summary_example(data);
+    
+    // Test prefix scans
+    prefix_scan_example(data);
+}
+
+// Streaming reductions over a file of doubles, with both read methods
+bool stream_double_file(const std::string& path, const StreamOptions& base_options, bool evict_between_runs) {
+    const int bins = 10;
+    const StreamMethod methods[] = {StreamMethod::MemoryMap, StreamMethod::BufferedRead};
+    
+    for (StreamMethod method : methods) {
+        StreamOptions options = base_options;
+        options.method = method;
+        const char* method_name = method == StreamMethod::MemoryMap ? "mmap" : "double-buffered read";
+        
+        // Sum alone: as close to the raw read rate as a reduction gets
+        if (evict_between_runs) evict_file_from_page_cache(path);
+        double sum = 0.0;
+        StreamStats sum_stats;
+        bool ok = stream_reduce<double>(path, sum,
+            [](const double* values, size_t count, size_t) {
+                double chunk_sum = 0.0;
+                #pragma omp parallel for reduction(+:chunk_sum)
+                for (long long i = 0; i < static_cast<long long>(count); ++i) {
+                    chunk_sum += values[i];
+                }
+                return chunk_sum;
+            },
+            [](double& total, double partial) { total += partial; },
+            options, &sum_stats);
+        
+        // Full statistics summary, merged chunk by chunk
+        if (evict_between_runs) evict_file_from_page_cache(path);
+        StatisticsSummary summary;
+        StreamStats stats_stats;
+        ok = ok && stream_reduce<double>(path, summary,
+            [bins](const double* values, size_t count, size_t first_index) {
+                return statistics_parallel_single_pass(values, count, static_cast<long long>(first_index), 0.0, 100.0, bins);
+            },
+            [](StatisticsSummary& total, const StatisticsSummary& partial) { total.merge(partial); },
+            options, &stats_stats);
+        
+        if (!ok) {
+            std::cerr << "  Could not stream " << path << " (" << method_name << ")" << std::endl;
+            return false;
+        }
+        
+        std::cout << "  Streaming (" << method_name << ", " << sum_stats.chunks << " chunks of "
+                  << options.chunk_bytes / (1024 * 1024) << " MB):" << std::endl;
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "    Sum=" << sum << " (" << sum_stats.seconds * 1000.0 << " ms, "
+                  << sum_stats.gigabytes_per_second() << " GB/s)" << std::endl;
+        std::cout << std::setprecision(4);
+        std::cout << "    Statistics: Count=" << summary.moments.count << ", Mean=" << summary.moments.mean
+                  << ", StdDev=" << summary.moments.standard_deviation()
+                  << ", Min=" << summary.extremes.min << " at [" << summary.extremes.min_index << "]"
+                  << ", Max=" << summary.extremes.max << " at [" << summary.extremes.max_index << "]" << std::endl;
+        std::cout << std::setprecision(2);
+        std::cout << "    (" << stats_stats.seconds * 1000.0 << " ms, " << stats_stats.gigabytes_per_second() << " GB/s)" << std::endl;
+    }
+    return true;
+}
+
+// Streaming reductions over a file of 32-bit integers
+bool stream_int_file(const std::string& path, const StreamOptions& options) {
+    struct IntTotals {
+        long long sum = 0;
+        int bit_and = ~0;
+        int bit_or = 0;
+        int bit_xor = 0;
+    };
+    IntTotals totals;
+    StreamStats stats;
+    bool ok = stream_reduce<int>(path, totals,
+        [](const int* values, size_t count, size_t) {
+            long long sum = 0;
+            int bit_and = ~0, bit_or = 0, bit_xor = 0;
+            #pragma omp parallel for reduction(+:sum) reduction(&:bit_and) reduction(|:bit_or) reduction(^:bit_xor)
+            for (long long i = 0; i < static_cast<long long>(count); ++i) {
+                sum += values[i];
+                bit_and &= values[i];
+                bit_or |= values[i];
+                bit_xor ^= values[i];
+            }
+            return IntTotals{sum, bit_and, bit_or, bit_xor};
+        },
+        [](IntTotals& total, const IntTotals& partial) {
+            total.sum += partial.sum;
+            total.bit_and &= partial.bit_and;
+            total.bit_or |= partial.bit_or;
+            total.bit_xor ^= partial.bit_xor;
+        },
+        options, &stats);
+    if (!ok) {
+        std::cerr << "  Could not stream " << path << std::endl;
+        return false;
+    }
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  Streaming int32: Sum=" << totals.sum << ", AND=" << totals.bit_and
+              << ", OR=" << totals.bit_or << ", XOR=" << totals.bit_xor
+              << " (" << stats.seconds * 1000.0 << " ms, " << stats.gigabytes_per_second() << " GB/s)" << std::endl;
+    return true;
+}
+
+// --stream without a file: write a demo file, check streamed results against the
+// in-memory reductions, and measure with the page cache dropped
+void streaming_demo(const StreamOptions& options) {
+    const std::string path = "streaming_demo.bin";
+    const size_t count = 32 * 1024 * 1024; // 256 MB of doubles
+    
+    std::cout << "Writing " << count * sizeof(double) / (1024 * 1024) << " MB demo file " << path << "..." << std::endl;
+    if (!write_random_doubles_file(path, count)) {
+        std::cerr << "Could not write " << path << std::endl;
+        return;
+    }
+    
+    // In-memory reference from the same file
+    std::vector<double> data(count);
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    bool loaded = file != nullptr && std::fread(data.data(), sizeof(double), count, file) == count;
+    if (file != nullptr) std::fclose(file);
+    
+    stream_double_file(path, options, true);
+    
+    if (loaded) {
+        StatisticsSummary reference = statistics_parallel_single_pass(data, 0.0, 100.0, 10);
+        StatisticsSummary streamed;
+        stream_reduce<double>(path, streamed,
+            [](const double* values, size_t n, size_t first_index) {
+                return statistics_parallel_single_pass(values, n, static_cast<long long>(first_index), 0.0, 100.0, 10);
+            },
+            [](StatisticsSummary& total, const StatisticsSummary& partial) { total.merge(partial); },
+            options);
+        std::cout << "  Validation vs in-memory: Mean=" << std::boolalpha
+                  << validate_results(reference.moments.mean, streamed.moments.mean)
+                  << ", Variance=" << validate_results(reference.moments.variance(), streamed.moments.variance())
+                  << ", Extremes=" << (reference.extremes.min_index == streamed.extremes.min_index
+                                       && reference.extremes.max_index == streamed.extremes.max_index)
+                  << ", Histogram=" << (reference.histogram.counts == streamed.histogram.counts) << std::endl;
+    }
+    std::remove(path.c_str());
 }
 
 int main(int argc, char* argv[]) {
@@ -527,6 +1118,10 @@ int main(int argc, char* argv[]) {
     // Check for command line arguments
     bool benchmark_mode = false;
     bool validation_mode = false;
+    bool stream_mode = false;
+    std::string stream_path;
+    std::string stream_type = "double";
+    StreamOptions stream_options;
     
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
@@ -534,10 +1129,30 @@ int main(int argc, char* argv[]) {
             benchmark_mode = true;
         } else if (arg == "--validate") {
             validation_mode = true;
+        } else if (arg == "--stream") {
+            stream_mode = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                stream_path = argv[++i];
+            }
+        } else if (arg == "--type" && i + 1 < argc) {
+            stream_type = argv[++i];
+        } else if (arg == "--chunk-mb" && i + 1 < argc) {
+            stream_options.chunk_bytes = static_cast<size_t>(std::max(1, std::atoi(argv[++i]))) * 1024 * 1024;
         }
     }
     
-    if (validation_mode) {
+    if (stream_mode) {
+        std::cout << "\n[STREAMING MODE]" << std::endl;
+        if (stream_path.empty()) {
+            streaming_demo(stream_options);
+        } else if (stream_type == "int32") {
+            std::cout << "Reducing " << stream_path << " as int32" << std::endl;
+            stream_int_file(stream_path, stream_options);
+        } else {
+            std::cout << "Reducing " << stream_path << " as double" << std::endl;
+            stream_double_file(stream_path, stream_options, false);
+        }
+    } else if (validation_mode) {
         std::cout << "\n[VALIDATION MODE]" << std::endl;
         std::cout << "Running extensive validation tests..." << std::endl;
         
@@ -645,7 +1260,7 @@ int main(int argc, char* argv[]) {
             benchmark_file << "Threads available: " << max_threads << "\n\n";
         }
         
-        // Run more detailed benchmarks
+        // Run more detailed benchmarks; fractional milliseconds, since the small sizes finish well under 1 ms
         std::vector<size_t> sizes = {10'000, 100'000, 1'000'000, 10'000'000};
         
         for (auto size : sizes) {
@@ -662,7 +1277,7 @@ int main(int argc, char* argv[]) {
             auto start = get_time();
             double seq_sum = sum_sequential(data);
             auto end = get_time();
-            double seq_time = get_elapsed_time(start, end);
+            double seq_time = get_elapsed_time_precise(start, end);
             if (seq_time < 0.1) seq_time = 0.1; // Prevent division by zero
             
             std::cout << "  Sequential Sum: " << std::fixed << std::setprecision(2) 
@@ -671,7 +1286,7 @@ int main(int argc, char* argv[]) {
             start = get_time();
             double critical_sum = sum_parallel_critical(data);
             end = get_time();
-            double critical_time = get_elapsed_time(start, end);
+            double critical_time = get_elapsed_time_precise(start, end);
             if (critical_time < 0.1) critical_time = 0.1; // Prevent division by zero
             
             std::cout << "  Parallel Sum (critical): " << std::fixed << std::setprecision(2) 
@@ -680,7 +1295,7 @@ int main(int argc, char* argv[]) {
             start = get_time();
             double atomic_sum = sum_parallel_atomic(data);
             end = get_time();
-            double atomic_time = get_elapsed_time(start, end);
+            double atomic_time = get_elapsed_time_precise(start, end);
             if (atomic_time < 0.1) atomic_time = 0.1; // Prevent division by zero
             
             std::cout << "  Parallel Sum (atomic): " << std::fixed << std::setprecision(2) 
@@ -689,7 +1304,7 @@ int main(int argc, char* argv[]) {
             start = get_time();
             double manual_sum = sum_parallel_manual(data);
             end = get_time();
-            double manual_time = get_elapsed_time(start, end);
+            double manual_time = get_elapsed_time_precise(start, end);
             if (manual_time < 0.1) manual_time = 0.1; // Prevent division by zero
             
             std::cout << "  Parallel Sum (manual): " << std::fixed << std::setprecision(2) 
@@ -698,12 +1313,27 @@ int main(int argc, char* argv[]) {
             start = get_time();
             double reduction_sum = sum_parallel_reduction(data);
             end = get_time();
-            double reduction_time = get_elapsed_time(start, end);
+            double reduction_time = get_elapsed_time_precise(start, end);
             if (reduction_time < 0.1) reduction_time = 0.1; // Prevent division by zero
             
             std::cout << "  Parallel Sum (reduction): " << std::fixed << std::setprecision(2) 
                       << reduction_sum << " (Time: " << reduction_time << " ms)" << std::endl;
             
+            start = get_time();
+            double reproducible_sum_val = sum_parallel_reproducible(data);
+            end = get_time();
+            double reproducible_time = get_elapsed_time_precise(start, end);
+            if (reproducible_time < 0.1) reproducible_time = 0.1; // Prevent division by zero
+            
+            start = get_time();
+            double kahan_sum_val = sum_parallel_reproducible(data, ReproducibleMode::Compensated);
+            end = get_time();
+            double kahan_time = get_elapsed_time_precise(start, end);
+            if (kahan_time < 0.1) kahan_time = 0.1; // Prevent division by zero
+            
+            std::cout << "  Parallel Sum (reproducible): " << std::fixed << std::setprecision(2) 
+                      << reproducible_sum_val << " / " << kahan_sum_val << " (Kahan)" << std::endl;
+            
             // Add product benchmark with specialized data
             if (size <= 1'000'000) { // Limit to reasonable sizes to avoid long execution times
                 auto product_data = generate_product_data(size);
@@ -711,13 +1341,13 @@ int main(int argc, char* argv[]) {
                 start = get_time();
                 double seq_product_val = product_sequential(product_data);
                 end = get_time();
-                double seq_product_time = get_elapsed_time(start, end);
+                double seq_product_time = get_elapsed_time_precise(start, end);
                 if (seq_product_time < 0.1) seq_product_time = 0.1;
                 
                 start = get_time();
                 double reduction_product_val = product_parallel_reduction(product_data);
                 end = get_time();
-                double reduction_product_time = get_elapsed_time(start, end);
+                double reduction_product_time = get_elapsed_time_precise(start, end);
                 if (reduction_product_time < 0.1) reduction_product_time = 0.1;
                 
                 std::cout << "\nProduct Operation (size=" << size << ", specialized data):\n";
@@ -725,6 +1355,10 @@ int main(int argc, char* argv[]) {
                 std::cout << "  Reduction:  " << reduction_product_val << " (Time: " << reduction_product_time << " ms (Speedup: " 
                           << std::max(0.0, seq_product_time/reduction_product_time) << "x)\n";
                 
+                bench::record("product", "sequential", static_cast<long long>(size), 1, {seq_product_time});
+                bench::record("product", "reduction", static_cast<long long>(size), max_threads, {reduction_product_time},
+                              {{"speedup", seq_product_time / reduction_product_time}});
+                
                 if (benchmark_file.is_open()) {
                     benchmark_file << "Product Operation (specialized data):\n";
                     benchmark_file << "  Sequential:  " << seq_product_time << " ms\n";
@@ -741,6 +1375,19 @@ int main(int argc, char* argv[]) {
             std::cout << "  Atomic:      " << atomic_time << " ms (Speedup: " << std::max(0.0, seq_time/atomic_time) << "x)\n";
             std::cout << "  Manual:      " << manual_time << " ms (Speedup: " << std::max(0.0, seq_time/manual_time) << "x)\n";
             std::cout << "  Reduction:   " << reduction_time << " ms (Speedup: " << std::max(0.0, seq_time/reduction_time) << "x)\n";
+            std::cout << "  Reproducible: " << reproducible_time << " ms (Speedup: " << std::max(0.0, seq_time/reproducible_time)
+                      << "x, " << reproducible_time / reduction_time << "x the reduction)\n";
+            std::cout << "  Kahan:       " << kahan_time << " ms (Speedup: " << std::max(0.0, seq_time/kahan_time)
+                      << "x, " << kahan_time / reduction_time << "x the reduction)\n";
+            
+            const long long record_size = static_cast<long long>(size);
+            bench::record("sum", "sequential", record_size, 1, {seq_time});
+            const std::pair<const char*, double> parallel_sums[] = {
+                {"critical", critical_time}, {"atomic", atomic_time}, {"manual", manual_time},
+                {"reduction", reduction_time}, {"reproducible", reproducible_time}, {"kahan", kahan_time}};
+            for (const auto& [variant, time] : parallel_sums) {
+                bench::record("sum", variant, record_size, max_threads, {time}, {{"speedup", seq_time / time}});
+            }
             
             if (benchmark_file.is_open()) {
                 benchmark_file << std::fixed << std::setprecision(2);
@@ -749,8 +1396,12 @@ int main(int argc, char* argv[]) {
                 benchmark_file << "  Critical:    " << critical_time << " ms (Speedup: " << std::max(0.0, seq_time/critical_time) << "x)\n";
                 benchmark_file << "  Atomic:      " << atomic_time << " ms (Speedup: " << std::max(0.0, seq_time/atomic_time) << "x)\n";
                 benchmark_file << "  Manual:      " << manual_time << " ms (Speedup: " << std::max(0.0, seq_time/manual_time) << "x)\n";
-                benchmark_file << "  Reduction:   " << reduction_time << " ms (Speedup: " << std::max(0.0, seq_time/reduction_time) << "x)\n\n";
+                benchmark_file << "  Reduction:   " << reduction_time << " ms (Speedup: " << std::max(0.0, seq_time/reduction_time) << "x)\n";
+                benchmark_file << "  Reproducible: " << reproducible_time << " ms (Speedup: " << std::max(0.0, seq_time/reproducible_time) << "x)\n";
+                benchmark_file << "  Kahan:       " << kahan_time << " ms (Speedup: " << std::max(0.0, seq_time/kahan_time) << "x)\n\n";
             }
+            
+            prefix_scan_example(data, &benchmark_file);
         }
         
         if (benchmark_file.is_open()) {
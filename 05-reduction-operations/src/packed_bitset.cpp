@@ -0,0 +1,157 @@
+#include "packed_bitset.h"
+
+#include <algorithm>
+#include <atomic>
+#include <omp.h>
+
+namespace {
+
+// Bit-parallel popcount. The x86-64 baseline has no popcnt instruction, so the
+// builtin would become a library call; this form vectorizes instead.
+inline uint64_t popcount64(uint64_t x) {
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (x * 0x0101010101010101ULL) >> 56;
+}
+
+} // namespace
+
+PackedBitset::PackedBitset(size_t size, bool value)
+    : words_((size + BITS_PER_WORD - 1) / BITS_PER_WORD, value ? ~0ULL : 0ULL), size_(size) {
+    if (value && !words_.empty()) {
+        words_.back() &= last_word_mask();
+    }
+}
+
+PackedBitset PackedBitset::from_bools(const std::vector<bool>& bits) {
+    PackedBitset result(bits.size());
+    const long long words = static_cast<long long>(result.word_count());
+    const size_t size = bits.size();
+    uint64_t* out = result.words();
+
+    #pragma omp parallel for schedule(static)
+    for (long long w = 0; w < words; ++w) {
+        const size_t begin = static_cast<size_t>(w) * BITS_PER_WORD;
+        const size_t end = std::min(begin + BITS_PER_WORD, size);
+        uint64_t word = 0;
+        for (size_t i = begin; i < end; ++i) {
+            word |= static_cast<uint64_t>(bits[i]) << (i - begin);
+        }
+        out[w] = word;
+    }
+    return result;
+}
+
+void PackedBitset::set(size_t index, bool value) {
+    const uint64_t bit = 1ULL << (index % BITS_PER_WORD);
+    if (value) {
+        words_[index / BITS_PER_WORD] |= bit;
+    } else {
+        words_[index / BITS_PER_WORD] &= ~bit;
+    }
+}
+
+uint64_t PackedBitset::last_word_mask() const {
+    const size_t tail = size_ % BITS_PER_WORD;
+    return tail == 0 ? ~0ULL : (1ULL << tail) - 1;
+}
+
+bool bitset_reduce_and(const PackedBitset& bits) {
+    if (bits.size() == 0) {
+        return true;
+    }
+    const uint64_t* words = bits.words();
+    const long long full_words = static_cast<long long>(bits.word_count()) - 1;
+    uint64_t result = ~0ULL;
+
+    #pragma omp parallel for reduction(&:result)
+    for (long long w = 0; w < full_words; ++w) {
+        result &= words[w];
+    }
+    // The last word only has to be full where it holds bits
+    const uint64_t mask = bits.last_word_mask();
+    return result == ~0ULL && (words[full_words] & mask) == mask;
+}
+
+bool bitset_reduce_or(const PackedBitset& bits) {
+    const uint64_t* words = bits.words();
+    const long long word_count = static_cast<long long>(bits.word_count());
+    uint64_t result = 0;
+
+    #pragma omp parallel for reduction(|:result)
+    for (long long w = 0; w < word_count; ++w) {
+        result |= words[w];
+    }
+    return result != 0;
+}
+
+// Scan chunks until some thread finds a word that decides the answer; found
+// tells the others to skip their remaining chunks
+template <typename Decides>
+static bool bitset_scan_until(const PackedBitset& bits, Decides decides) {
+    const uint64_t* words = bits.words();
+    const long long word_count = static_cast<long long>(bits.word_count());
+    const long long chunks = (word_count + static_cast<long long>(BITSET_SCAN_CHUNK) - 1)
+                           / static_cast<long long>(BITSET_SCAN_CHUNK);
+    std::atomic<bool> found(false);
+
+    #pragma omp parallel for schedule(dynamic, 4)
+    for (long long c = 0; c < chunks; ++c) {
+        if (found.load(std::memory_order_relaxed)) {
+            continue;
+        }
+        const long long begin = c * static_cast<long long>(BITSET_SCAN_CHUNK);
+        const long long end = std::min(begin + static_cast<long long>(BITSET_SCAN_CHUNK), word_count);
+        if (decides(words, begin, end)) {
+            found.store(true, std::memory_order_relaxed);
+        }
+    }
+    return found.load();
+}
+
+bool bitset_all(const PackedBitset& bits) {
+    if (bits.size() == 0) {
+        return true;
+    }
+    const long long last = static_cast<long long>(bits.word_count()) - 1;
+    const uint64_t mask = bits.last_word_mask();
+
+    // A chunk decides "not all" if any of its words has a clear valid bit
+    const bool has_clear_bit = bitset_scan_until(bits, [last, mask](const uint64_t* words, long long begin, long long end) {
+        uint64_t chunk_and = ~0ULL;
+        const long long full_end = std::min(end, last);
+        #pragma omp simd reduction(&:chunk_and)
+        for (long long w = begin; w < full_end; ++w) {
+            chunk_and &= words[w];
+        }
+        if (end > last && (words[last] & mask) != mask) {
+            return true;
+        }
+        return chunk_and != ~0ULL;
+    });
+    return !has_clear_bit;
+}
+
+bool bitset_any(const PackedBitset& bits) {
+    return bitset_scan_until(bits, [](const uint64_t* words, long long begin, long long end) {
+        uint64_t chunk_or = 0;
+        #pragma omp simd reduction(|:chunk_or)
+        for (long long w = begin; w < end; ++w) {
+            chunk_or |= words[w];
+        }
+        return chunk_or != 0;
+    });
+}
+
+size_t bitset_count(const PackedBitset& bits) {
+    const uint64_t* words = bits.words();
+    const long long word_count = static_cast<long long>(bits.word_count());
+    uint64_t count = 0;
+
+    #pragma omp parallel for reduction(+:count)
+    for (long long w = 0; w < word_count; ++w) {
+        count += popcount64(words[w]);
+    }
+    return static_cast<size_t>(count);
+}
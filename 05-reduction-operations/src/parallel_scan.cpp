@@ -0,0 +1,84 @@
+#include "parallel_scan.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PARALLEL_SCAN_SSE2 1
+#endif
+
+// In-register scan: log2(lanes) shift-and-add steps turn a vector into its own
+// prefix sums, then the carry from the previous vector is added to every lane and
+// the last lane becomes the next carry. Integer addition is associative, so the
+// result is exactly the sequential one.
+
+int32_t inclusive_scan_add_simd(const int32_t* in, int32_t* out, size_t size, int32_t carry) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    __m256i running = _mm256_set1_epi32(carry);
+    for (; i + 8 <= size; i += 8) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        // Scan within each 128-bit half
+        x = _mm256_add_epi32(x, _mm256_slli_si256(x, 4));
+        x = _mm256_add_epi32(x, _mm256_slli_si256(x, 8));
+        // Add the low half's last lane to the whole high half
+        const __m256i low_total = _mm256_shuffle_epi32(_mm256_permute2x128_si256(x, x, 0x08), 0xFF);
+        x = _mm256_add_epi32(x, low_total);
+        x = _mm256_add_epi32(x, running);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), x);
+        running = _mm256_permutevar8x32_epi32(x, _mm256_set1_epi32(7));
+    }
+    carry = _mm256_cvtsi256_si32(running);
+#elif defined(PARALLEL_SCAN_SSE2)
+    __m128i running = _mm_set1_epi32(carry);
+    for (; i + 4 <= size; i += 4) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+        x = _mm_add_epi32(x, running);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), x);
+        running = _mm_shuffle_epi32(x, 0xFF);
+    }
+    carry = _mm_cvtsi128_si32(running);
+#endif
+    for (; i < size; ++i) {
+        carry += in[i];
+        out[i] = carry;
+    }
+    return carry;
+}
+
+int32_t exclusive_scan_add_simd(const int32_t* in, int32_t* out, size_t size, int32_t carry) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    __m256i running = _mm256_set1_epi32(carry);
+    for (; i + 8 <= size; i += 8) {
+        const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        __m256i x = _mm256_add_epi32(value, _mm256_slli_si256(value, 4));
+        x = _mm256_add_epi32(x, _mm256_slli_si256(x, 8));
+        const __m256i low_total = _mm256_shuffle_epi32(_mm256_permute2x128_si256(x, x, 0x08), 0xFF);
+        x = _mm256_add_epi32(_mm256_add_epi32(x, low_total), running);
+        // Exclusive = inclusive minus the element itself
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_sub_epi32(x, value));
+        running = _mm256_permutevar8x32_epi32(x, _mm256_set1_epi32(7));
+    }
+    carry = _mm256_cvtsi256_si32(running);
+#elif defined(PARALLEL_SCAN_SSE2)
+    __m128i running = _mm_set1_epi32(carry);
+    for (; i + 4 <= size; i += 4) {
+        const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m128i x = _mm_add_epi32(value, _mm_slli_si128(value, 4));
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+        x = _mm_add_epi32(x, running);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_sub_epi32(x, value));
+        running = _mm_shuffle_epi32(x, 0xFF);
+    }
+    carry = _mm_cvtsi128_si32(running);
+#endif
+    for (; i < size; ++i) {
+        const int32_t value = in[i];
+        out[i] = carry;
+        carry += value;
+    }
+    return carry;
+}
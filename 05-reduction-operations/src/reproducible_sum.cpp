@@ -0,0 +1,130 @@
+#include "reproducible_sum.h"
+
+#include <algorithm>
+#include <omp.h>
+
+namespace {
+
+// Value plus the rounding error it has lost so far
+struct CompensatedValue {
+    double sum;
+    double error;
+};
+
+// Knuth's TwoSum: a + b = s + e exactly
+inline CompensatedValue two_sum(double a, double b) {
+    const double s = a + b;
+    const double b_virtual = s - a;
+    const double e = (a - (s - b_virtual)) + (b - b_virtual);
+    return {s, e};
+}
+
+inline CompensatedValue combine(const CompensatedValue& a, const CompensatedValue& b) {
+    const CompensatedValue s = two_sum(a.sum, b.sum);
+    return {s.sum, s.error + a.error + b.error};
+}
+
+// Lane k adds elements k, k + LANES, k + 2 * LANES, ...; the loop over k is
+// element-wise across lanes, so it vectorizes without reassociating anything
+double block_sum_plain(const double* values, size_t size) {
+    double lanes[REPRODUCIBLE_LANES] = {};
+    size_t i = 0;
+    for (; i + REPRODUCIBLE_LANES <= size; i += REPRODUCIBLE_LANES) {
+        for (int k = 0; k < REPRODUCIBLE_LANES; ++k) {
+            lanes[k] += values[i + k];
+        }
+    }
+    for (int k = 0; i < size; ++i, ++k) {
+        lanes[k] += values[i];
+    }
+    // Fixed pairwise combination of the lanes
+    for (int width = REPRODUCIBLE_LANES / 2; width > 0; width /= 2) {
+        for (int k = 0; k < width; ++k) {
+            lanes[k] += lanes[k + width];
+        }
+    }
+    return lanes[0];
+}
+
+CompensatedValue block_sum_compensated(const double* values, size_t size) {
+    double lanes[REPRODUCIBLE_LANES] = {};
+    double errors[REPRODUCIBLE_LANES] = {};
+    size_t i = 0;
+    for (; i + REPRODUCIBLE_LANES <= size; i += REPRODUCIBLE_LANES) {
+        for (int k = 0; k < REPRODUCIBLE_LANES; ++k) {
+            const double y = values[i + k] - errors[k];
+            const double t = lanes[k] + y;
+            errors[k] = (t - lanes[k]) - y;
+            lanes[k] = t;
+        }
+    }
+    for (int k = 0; i < size; ++i, ++k) {
+        const double y = values[i] - errors[k];
+        const double t = lanes[k] + y;
+        errors[k] = (t - lanes[k]) - y;
+        lanes[k] = t;
+    }
+    // Kahan keeps the negated error
+    CompensatedValue partial[REPRODUCIBLE_LANES];
+    for (int k = 0; k < REPRODUCIBLE_LANES; ++k) {
+        partial[k] = {lanes[k], -errors[k]};
+    }
+    for (int width = REPRODUCIBLE_LANES / 2; width > 0; width /= 2) {
+        for (int k = 0; k < width; ++k) {
+            partial[k] = combine(partial[k], partial[k + width]);
+        }
+    }
+    return partial[0];
+}
+
+// Fixed pairwise tree over the block results: level by level, neighbors (2i, 2i + 1)
+// are combined and an odd last element moves up unchanged
+template <typename T, typename Combine>
+T tree_reduce(std::vector<T>& values, Combine combine_pair) {
+    size_t count = values.size();
+    while (count > 1) {
+        const size_t half = count / 2;
+        for (size_t i = 0; i < half; ++i) {
+            values[i] = combine_pair(values[2 * i], values[2 * i + 1]);
+        }
+        if (count % 2 != 0) {
+            values[half] = values[count - 1];
+        }
+        count = half + count % 2;
+    }
+    return values[0];
+}
+
+} // namespace
+
+double reproducible_sum(const std::vector<double>& data, ReproducibleMode mode, int num_threads) {
+    if (data.empty()) {
+        return 0.0;
+    }
+    if (num_threads <= 0) {
+        num_threads = omp_get_max_threads();
+    }
+
+    const double* values = data.data();
+    const size_t size = data.size();
+    const long long blocks = static_cast<long long>((size + REPRODUCIBLE_BLOCK_SIZE - 1) / REPRODUCIBLE_BLOCK_SIZE);
+
+    if (mode == ReproducibleMode::Plain) {
+        std::vector<double> block_sums(static_cast<size_t>(blocks));
+        #pragma omp parallel for schedule(static) num_threads(num_threads)
+        for (long long b = 0; b < blocks; ++b) {
+            const size_t begin = static_cast<size_t>(b) * REPRODUCIBLE_BLOCK_SIZE;
+            block_sums[b] = block_sum_plain(values + begin, std::min(REPRODUCIBLE_BLOCK_SIZE, size - begin));
+        }
+        return tree_reduce(block_sums, [](double a, double b) { return a + b; });
+    }
+
+    std::vector<CompensatedValue> block_sums(static_cast<size_t>(blocks));
+    #pragma omp parallel for schedule(static) num_threads(num_threads)
+    for (long long b = 0; b < blocks; ++b) {
+        const size_t begin = static_cast<size_t>(b) * REPRODUCIBLE_BLOCK_SIZE;
+        block_sums[b] = block_sum_compensated(values + begin, std::min(REPRODUCIBLE_BLOCK_SIZE, size - begin));
+    }
+    const CompensatedValue total = tree_reduce(block_sums, combine);
+    return total.sum + total.error;
+}
@@ -0,0 +1,218 @@
+#include "selection_reduction.h"
+#include "perf_markers.h"
+
+#include <algorithm>
+#include <limits>
+#include <omp.h>
+
+namespace {
+
+const ValueIndex EMPTY_VALUE_INDEX = {std::numeric_limits<double>::quiet_NaN(), -1};
+
+ValueIndex smaller_of(const ValueIndex& a, const ValueIndex& b) {
+    if (a.index < 0) return b;
+    if (b.index < 0) return a;
+    return (b.value < a.value || (b.value == a.value && b.index < a.index)) ? b : a;
+}
+
+ValueIndex larger_of(const ValueIndex& a, const ValueIndex& b) {
+    if (a.index < 0) return b;
+    if (b.index < 0) return a;
+    return ranks_higher(b, a) ? b : a;
+}
+
+// Blocks are visited in increasing order within a thread, so a strict comparison
+// keeps the first occurrence
+void min_block(const double* values, size_t size, long long offset, ValueIndex& best) {
+    const long long n = static_cast<long long>(size);
+    double block_min = values[0];
+    #pragma omp simd reduction(min:block_min)
+    for (long long i = 1; i < n; ++i) {
+        block_min = values[i] < block_min ? values[i] : block_min;
+    }
+    if (best.index < 0 || block_min < best.value) {
+        const long long at = std::find(values, values + n, block_min) - values;
+        best = ValueIndex{block_min, offset + at};
+    }
+}
+
+void max_block(const double* values, size_t size, long long offset, ValueIndex& best) {
+    const long long n = static_cast<long long>(size);
+    double block_max = values[0];
+    #pragma omp simd reduction(max:block_max)
+    for (long long i = 1; i < n; ++i) {
+        block_max = values[i] > block_max ? values[i] : block_max;
+    }
+    if (best.index < 0 || block_max > best.value) {
+        const long long at = std::find(values, values + n, block_max) - values;
+        best = ValueIndex{block_max, offset + at};
+    }
+}
+
+} // namespace
+
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp declare reduction(merge_argmin : ValueIndex : omp_out = smaller_of(omp_out, omp_in)) \
+    initializer(omp_priv = EMPTY_VALUE_INDEX)
+#pragma omp declare reduction(merge_argmax : ValueIndex : omp_out = larger_of(omp_out, omp_in)) \
+    initializer(omp_priv = EMPTY_VALUE_INDEX)
+#endif
+
+ValueIndex argmin_parallel(const std::vector<double>& data) {
+    PERF_SCOPE("Arg-min");
+    const size_t size = data.size();
+    const long long blocks = static_cast<long long>((size + ARG_EXTREME_BLOCK_SIZE - 1) / ARG_EXTREME_BLOCK_SIZE);
+    ValueIndex best = EMPTY_VALUE_INDEX;
+
+#if defined(_OPENMP) && _OPENMP >= 201307
+    #pragma omp parallel for schedule(static) reduction(merge_argmin:best)
+    for (long long block = 0; block < blocks; ++block) {
+        const size_t begin = static_cast<size_t>(block) * ARG_EXTREME_BLOCK_SIZE;
+        min_block(data.data() + begin, std::min(ARG_EXTREME_BLOCK_SIZE, size - begin),
+                  static_cast<long long>(begin), best);
+    }
+#else
+    #pragma omp parallel
+    {
+        ValueIndex local = EMPTY_VALUE_INDEX;
+
+        #pragma omp for schedule(static)
+        for (long long block = 0; block < blocks; ++block) {
+            const size_t begin = static_cast<size_t>(block) * ARG_EXTREME_BLOCK_SIZE;
+            min_block(data.data() + begin, std::min(ARG_EXTREME_BLOCK_SIZE, size - begin),
+                      static_cast<long long>(begin), local);
+        }
+
+        #pragma omp critical
+        best = smaller_of(best, local);
+    }
+#endif
+
+    return best;
+}
+
+ValueIndex argmax_parallel(const std::vector<double>& data) {
+    PERF_SCOPE("Arg-max");
+    const size_t size = data.size();
+    const long long blocks = static_cast<long long>((size + ARG_EXTREME_BLOCK_SIZE - 1) / ARG_EXTREME_BLOCK_SIZE);
+    ValueIndex best = EMPTY_VALUE_INDEX;
+
+#if defined(_OPENMP) && _OPENMP >= 201307
+    #pragma omp parallel for schedule(static) reduction(merge_argmax:best)
+    for (long long block = 0; block < blocks; ++block) {
+        const size_t begin = static_cast<size_t>(block) * ARG_EXTREME_BLOCK_SIZE;
+        max_block(data.data() + begin, std::min(ARG_EXTREME_BLOCK_SIZE, size - begin),
+                  static_cast<long long>(begin), best);
+    }
+#else
+    #pragma omp parallel
+    {
+        ValueIndex local = EMPTY_VALUE_INDEX;
+
+        #pragma omp for schedule(static)
+        for (long long block = 0; block < blocks; ++block) {
+            const size_t begin = static_cast<size_t>(block) * ARG_EXTREME_BLOCK_SIZE;
+            max_block(data.data() + begin, std::min(ARG_EXTREME_BLOCK_SIZE, size - begin),
+                      static_cast<long long>(begin), local);
+        }
+
+        #pragma omp critical
+        best = larger_of(best, local);
+    }
+#endif
+
+    return best;
+}
+
+ValueIndex argmin_sequential(const std::vector<double>& data) {
+    if (data.empty()) {
+        return EMPTY_VALUE_INDEX;
+    }
+    const auto it = std::min_element(data.begin(), data.end());
+    return ValueIndex{*it, static_cast<long long>(it - data.begin())};
+}
+
+ValueIndex argmax_sequential(const std::vector<double>& data) {
+    if (data.empty()) {
+        return EMPTY_VALUE_INDEX;
+    }
+    // max_element returns the first of equal maxima, as ranks_higher does
+    const auto it = std::max_element(data.begin(), data.end());
+    return ValueIndex{*it, static_cast<long long>(it - data.begin())};
+}
+
+std::vector<ValueIndex> top_k_parallel(const std::vector<double>& data, size_t k) {
+    k = std::min(k, data.size());
+    if (k == 0) {
+        return {};
+    }
+    const long long n = static_cast<long long>(data.size());
+    std::vector<std::vector<ValueIndex>> partials(static_cast<size_t>(omp_get_max_threads()));
+
+    #pragma omp parallel
+    {
+        std::vector<ValueIndex>& best = partials[static_cast<size_t>(omp_get_thread_num())];
+
+        if (k <= TOPK_HEAP_LIMIT) {
+            // Bounded heap with the weakest kept element on top: most candidates are
+            // rejected by one comparison once the heap is full
+            best.reserve(k);
+            #pragma omp for schedule(static)
+            for (long long i = 0; i < n; ++i) {
+                const ValueIndex candidate{data[i], i};
+                if (best.size() < k) {
+                    best.push_back(candidate);
+                    std::push_heap(best.begin(), best.end(), ranks_higher);
+                } else if (ranks_higher(candidate, best.front())) {
+                    std::pop_heap(best.begin(), best.end(), ranks_higher);
+                    best.back() = candidate;
+                    std::push_heap(best.begin(), best.end(), ranks_higher);
+                }
+            }
+        } else {
+            // Large k: collect into a 2k buffer and cut it back to the k best with
+            // nth_element whenever it fills; linear time, O(k) memory per thread
+            best.reserve(2 * k);
+            bool has_threshold = false;
+            ValueIndex threshold = EMPTY_VALUE_INDEX;
+            #pragma omp for schedule(static)
+            for (long long i = 0; i < n; ++i) {
+                const ValueIndex candidate{data[i], i};
+                if (has_threshold && !ranks_higher(candidate, threshold)) {
+                    continue;
+                }
+                best.push_back(candidate);
+                if (best.size() == 2 * k) {
+                    std::nth_element(best.begin(), best.begin() + static_cast<long long>(k - 1), best.end(), ranks_higher);
+                    best.resize(k);
+                    threshold = best[k - 1];
+                    has_threshold = true;
+                }
+            }
+            if (best.size() > k) {
+                std::nth_element(best.begin(), best.begin() + static_cast<long long>(k - 1), best.end(), ranks_higher);
+                best.resize(k);
+            }
+        }
+    }
+
+    // Merge: at most threads * k candidates
+    std::vector<ValueIndex> result;
+    for (const auto& partial : partials) {
+        result.insert(result.end(), partial.begin(), partial.end());
+    }
+    std::partial_sort(result.begin(), result.begin() + static_cast<long long>(k), result.end(), ranks_higher);
+    result.resize(k);
+    return result;
+}
+
+std::vector<ValueIndex> top_k_sequential(const std::vector<double>& data, size_t k) {
+    k = std::min(k, data.size());
+    std::vector<ValueIndex> all(data.size());
+    for (size_t i = 0; i < data.size(); ++i) {
+        all[i] = ValueIndex{data[i], static_cast<long long>(i)};
+    }
+    std::partial_sort(all.begin(), all.begin() + static_cast<long long>(k), all.end(), ranks_higher);
+    all.resize(k);
+    return all;
+}
@@ -0,0 +1,251 @@
+#include "statistics_reduction.h"
+#include "perf_markers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <omp.h>
+
+// RunningStats
+
+void RunningStats::add(double value) {
+    const long long n = count + 1;
+    const double delta = value - mean;
+    const double delta_n = delta / static_cast<double>(n);
+    const double term = delta * delta_n * static_cast<double>(count);
+    mean += delta_n;
+    m3 += term * delta_n * static_cast<double>(n - 2) - 3.0 * delta_n * m2;
+    m2 += term;
+    count = n;
+}
+
+void RunningStats::add_block(const double* values, size_t size) {
+    if (size == 0) {
+        return;
+    }
+    const long long n = static_cast<long long>(size);
+
+    double sum = 0.0;
+    #pragma omp simd reduction(+:sum)
+    for (long long i = 0; i < n; ++i) {
+        sum += values[i];
+    }
+
+    // Second sweep over the block while it is still in L1: deviations from the
+    // block mean keep m2/m3 accurate where raw power sums would cancel
+    RunningStats block;
+    block.count = n;
+    block.mean = sum / static_cast<double>(n);
+    double m2_sum = 0.0;
+    double m3_sum = 0.0;
+    const double block_mean = block.mean;
+    #pragma omp simd reduction(+:m2_sum, m3_sum)
+    for (long long i = 0; i < n; ++i) {
+        const double d = values[i] - block_mean;
+        m2_sum += d * d;
+        m3_sum += d * d * d;
+    }
+    block.m2 = m2_sum;
+    block.m3 = m3_sum;
+    merge(block);
+}
+
+void RunningStats::merge(const RunningStats& other) {
+    if (other.count == 0) {
+        return;
+    }
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+    const double na = static_cast<double>(count);
+    const double nb = static_cast<double>(other.count);
+    const double n = na + nb;
+    const double delta = other.mean - mean;
+    const double delta_n = delta / n;
+
+    m3 += other.m3 + delta * delta_n * delta_n * na * nb * (na - nb)
+        + 3.0 * delta_n * (na * other.m2 - nb * m2);
+    m2 += other.m2 + delta * delta_n * na * nb;
+    mean += delta_n * nb;
+    count += other.count;
+}
+
+double RunningStats::variance() const {
+    return count > 1 ? m2 / static_cast<double>(count - 1) : 0.0;
+}
+
+double RunningStats::standard_deviation() const {
+    return std::sqrt(variance());
+}
+
+double RunningStats::skewness() const {
+    if (count < 2 || m2 == 0.0) {
+        return 0.0;
+    }
+    const double n = static_cast<double>(count);
+    return std::sqrt(n) * m3 / std::pow(m2, 1.5);
+}
+
+// ExtremeValues
+
+void ExtremeValues::add_block(const double* values, size_t size, long long offset) {
+    if (size == 0) {
+        return;
+    }
+    const long long n = static_cast<long long>(size);
+
+    // Values first (vectorized), then the first position of each in the cached block
+    double lo = values[0];
+    double hi = values[0];
+    #pragma omp simd reduction(min:lo) reduction(max:hi)
+    for (long long i = 0; i < n; ++i) {
+        lo = std::min(lo, values[i]);
+        hi = std::max(hi, values[i]);
+    }
+
+    ExtremeValues block;
+    block.min = lo;
+    block.max = hi;
+    for (long long i = 0; i < n && (block.min_index < 0 || block.max_index < 0); ++i) {
+        if (block.min_index < 0 && values[i] == lo) block.min_index = offset + i;
+        if (block.max_index < 0 && values[i] == hi) block.max_index = offset + i;
+    }
+    merge(block);
+}
+
+void ExtremeValues::merge(const ExtremeValues& other) {
+    if (other.min_index >= 0 &&
+        (min_index < 0 || other.min < min || (other.min == min && other.min_index < min_index))) {
+        min = other.min;
+        min_index = other.min_index;
+    }
+    if (other.max_index >= 0 &&
+        (max_index < 0 || other.max > max || (other.max == max && other.max_index < max_index))) {
+        max = other.max;
+        max_index = other.max_index;
+    }
+}
+
+// Histogram
+
+Histogram::Histogram(double lower, double upper, int bins)
+    : lower(lower), upper(upper), counts(static_cast<size_t>(std::max(bins, 1)), 0) {}
+
+Histogram Histogram::empty_copy() const {
+    return Histogram(lower, upper, static_cast<int>(counts.size()));
+}
+
+void Histogram::add_block(const double* values, size_t size) {
+    const long long bins = static_cast<long long>(counts.size());
+    const double scale = static_cast<double>(bins) / (upper - lower);
+    long long* bin_counts = counts.data();
+
+    for (size_t i = 0; i < size; ++i) {
+        const double value = values[i];
+        if (value < lower) {
+            ++underflow;
+        } else if (value > upper) {
+            ++overflow;
+        } else {
+            // upper itself belongs to the last bin
+            const long long bin = std::min(static_cast<long long>((value - lower) * scale), bins - 1);
+            ++bin_counts[bin];
+        }
+    }
+}
+
+void Histogram::merge(const Histogram& other) {
+    if (counts.empty()) {
+        *this = other;
+        return;
+    }
+    for (size_t b = 0; b < counts.size() && b < other.counts.size(); ++b) {
+        counts[b] += other.counts[b];
+    }
+    underflow += other.underflow;
+    overflow += other.overflow;
+}
+
+// Single-pass drivers
+
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp declare reduction(merge_moments : RunningStats : omp_out.merge(omp_in)) \
+    initializer(omp_priv = RunningStats())
+#pragma omp declare reduction(merge_extremes : ExtremeValues : omp_out.merge(omp_in)) \
+    initializer(omp_priv = ExtremeValues())
+#pragma omp declare reduction(merge_histogram : Histogram : omp_out.merge(omp_in)) \
+    initializer(omp_priv = omp_orig.empty_copy())
+#endif
+
+void StatisticsSummary::merge(const StatisticsSummary& other) {
+    moments.merge(other.moments);
+    extremes.merge(other.extremes);
+    histogram.merge(other.histogram);
+}
+
+StatisticsSummary statistics_parallel_single_pass(const std::vector<double>& data,
+                                                  double hist_lower, double hist_upper, int bins) {
+    return statistics_parallel_single_pass(data.data(), data.size(), 0, hist_lower, hist_upper, bins);
+}
+
+StatisticsSummary statistics_parallel_single_pass(const double* values, size_t size, long long first_index,
+                                                  double hist_lower, double hist_upper, int bins) {
+    PERF_SCOPE("Statistics (single pass)");
+    const long long blocks = static_cast<long long>((size + STATISTICS_BLOCK_SIZE - 1) / STATISTICS_BLOCK_SIZE);
+
+    RunningStats moments;
+    ExtremeValues extremes;
+    Histogram histogram(hist_lower, hist_upper, bins);
+
+#if defined(_OPENMP) && _OPENMP >= 201307
+    #pragma omp parallel for schedule(static) reduction(merge_moments:moments) \
+        reduction(merge_extremes:extremes) reduction(merge_histogram:histogram)
+    for (long long block = 0; block < blocks; ++block) {
+        const size_t begin = static_cast<size_t>(block) * STATISTICS_BLOCK_SIZE;
+        const size_t count = std::min(STATISTICS_BLOCK_SIZE, size - begin);
+        moments.add_block(values + begin, count);
+        extremes.add_block(values + begin, count, first_index + static_cast<long long>(begin));
+        histogram.add_block(values + begin, count);
+    }
+#else
+    // No user-defined reductions before OpenMP 4.0: the same combiners, applied by hand
+    #pragma omp parallel
+    {
+        RunningStats local_moments;
+        ExtremeValues local_extremes;
+        Histogram local_histogram = histogram.empty_copy();
+
+        #pragma omp for schedule(static)
+        for (long long block = 0; block < blocks; ++block) {
+            const size_t begin = static_cast<size_t>(block) * STATISTICS_BLOCK_SIZE;
+            const size_t count = std::min(STATISTICS_BLOCK_SIZE, size - begin);
+            local_moments.add_block(values + begin, count);
+            local_extremes.add_block(values + begin, count, first_index + static_cast<long long>(begin));
+            local_histogram.add_block(values + begin, count);
+        }
+
+        #pragma omp critical
+        {
+            moments.merge(local_moments);
+            extremes.merge(local_extremes);
+            histogram.merge(local_histogram);
+        }
+    }
+#endif
+
+    return StatisticsSummary{moments, extremes, histogram};
+}
+
+StatisticsSummary statistics_sequential(const std::vector<double>& data,
+                                        double hist_lower, double hist_upper, int bins) {
+    StatisticsSummary summary;
+    summary.histogram = Histogram(hist_lower, hist_upper, bins);
+
+    for (size_t begin = 0; begin < data.size(); begin += STATISTICS_BLOCK_SIZE) {
+        const size_t count = std::min(STATISTICS_BLOCK_SIZE, data.size() - begin);
+        summary.moments.add_block(data.data() + begin, count);
+        summary.extremes.add_block(data.data() + begin, count, static_cast<long long>(begin));
+        summary.histogram.add_block(data.data() + begin, count);
+    }
+    return summary;
+}
@@ -0,0 +1,230 @@
+#include "streaming_reduction.h"
+#include "perf_markers.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <future>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr size_t PAGE_SIZE_BYTES = 4096;
+
+// Chunk size: a whole number of pages and of elements, at least one of each
+size_t chunk_size_for(size_t requested, size_t element_size) {
+    element_size = std::max<size_t>(1, element_size);
+    const size_t unit = PAGE_SIZE_BYTES * element_size / std::gcd(PAGE_SIZE_BYTES, element_size);
+    return std::max(unit, requested / unit * unit);
+}
+
+// Walk a mapped region chunk by chunk
+void consume_mapped(const char* base, size_t bytes, size_t element_size, size_t chunk,
+                    const ChunkConsumer& consume, StreamStats& stats) {
+    for (size_t offset = 0; offset < bytes; offset += chunk) {
+        const size_t length = std::min(chunk, bytes - offset);
+#if !defined(_WIN32) && defined(MADV_WILLNEED)
+        // Ask the kernel to start reading the next chunk while this one is reduced
+        if (offset + length < bytes) {
+            madvise(const_cast<char*>(base) + offset + length, std::min(chunk, bytes - offset - length), MADV_WILLNEED);
+        }
+#endif
+        consume(base + offset, length / element_size, offset / element_size);
+        ++stats.chunks;
+#if !defined(_WIN32) && defined(MADV_DONTNEED)
+        // Done with these pages; dropping them keeps the resident set at about two chunks
+        madvise(const_cast<char*>(base) + offset, length / PAGE_SIZE_BYTES * PAGE_SIZE_BYTES, MADV_DONTNEED);
+#endif
+    }
+}
+
+bool stream_memory_map(const std::string& path, size_t element_size, size_t chunk,
+                       const ChunkConsumer& consume, StreamStats& stats) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        return false;
+    }
+    const size_t bytes = static_cast<size_t>(file_size.QuadPart) / element_size * element_size;
+    if (bytes == 0) {
+        CloseHandle(file);
+        return true;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        CloseHandle(file);
+        return false;
+    }
+    const char* base = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (base == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    consume_mapped(base, bytes, element_size, chunk, consume, stats);
+    stats.bytes = bytes;
+    UnmapViewOfFile(base);
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return true;
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return false;
+    }
+    const size_t file_bytes = static_cast<size_t>(info.st_size);
+    const size_t bytes = file_bytes / element_size * element_size;
+    if (bytes == 0) {
+        close(fd);
+        return true;
+    }
+    void* mapped = mmap(nullptr, file_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+#ifdef MADV_SEQUENTIAL
+    madvise(mapped, file_bytes, MADV_SEQUENTIAL);
+#endif
+    consume_mapped(static_cast<const char*>(mapped), bytes, element_size, chunk, consume, stats);
+    stats.bytes = bytes;
+    munmap(mapped, file_bytes);
+    close(fd);
+    return true;
+#endif
+}
+
+bool stream_buffered_read(const std::string& path, size_t element_size, size_t chunk,
+                          const ChunkConsumer& consume, StreamStats& stats) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    // The chunk buffers are the buffering; stdio's own would only add a copy
+    std::setvbuf(file, nullptr, _IONBF, 0);
+
+    // No point allocating buffers larger than a small file
+    std::error_code error;
+    const auto file_bytes = std::filesystem::file_size(path, error);
+    if (!error && file_bytes < chunk) {
+        chunk = chunk_size_for(static_cast<size_t>(file_bytes), element_size);
+    }
+
+    std::vector<char> buffers[2] = {std::vector<char>(chunk), std::vector<char>(chunk)};
+    auto read_into = [file, chunk, &buffers](int index) {
+        return std::fread(buffers[index].data(), 1, chunk, file);
+    };
+
+    // One read is always in flight: while chunk k is reduced, chunk k + 1 is read
+    int current = 0;
+    std::future<size_t> pending = std::async(std::launch::async, read_into, current);
+    size_t first_index = 0;
+    bool ok = true;
+    while (true) {
+        const size_t got = pending.get();
+        if (got < chunk && std::ferror(file)) {
+            ok = false;
+            break;
+        }
+        const size_t count = got / element_size;
+        if (count == 0) {
+            break;
+        }
+        const int ready = current;
+        current ^= 1;
+        if (got == chunk) {
+            pending = std::async(std::launch::async, read_into, current);
+        }
+        consume(buffers[ready].data(), count, first_index);
+        first_index += count;
+        stats.bytes += count * element_size;
+        ++stats.chunks;
+        if (got < chunk) {
+            break;
+        }
+    }
+    std::fclose(file);
+    return ok;
+}
+
+} // namespace
+
+bool stream_file_chunks(const std::string& path, size_t element_size, const StreamOptions& options,
+                        const ChunkConsumer& consume, StreamStats* stats) {
+    PERF_SCOPE("Streaming reduction");
+    StreamStats local;
+    const size_t chunk = chunk_size_for(options.chunk_bytes, element_size);
+    const auto start = std::chrono::steady_clock::now();
+
+    const bool ok = options.method == StreamMethod::MemoryMap
+        ? stream_memory_map(path, element_size, chunk, consume, local)
+        : stream_buffered_read(path, element_size, chunk, consume, local);
+
+    local.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (stats != nullptr) {
+        *stats = local;
+    }
+    return ok;
+}
+
+bool write_random_doubles_file(const std::string& path, size_t count) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    std::mt19937_64 gen(12345);
+    std::uniform_real_distribution<double> dist(0.0, 100.0);
+    std::vector<double> buffer(1 << 20);
+
+    bool ok = true;
+    for (size_t written = 0; written < count && ok; ) {
+        const size_t n = std::min(buffer.size(), count - written);
+        for (size_t i = 0; i < n; ++i) {
+            buffer[i] = dist(gen);
+        }
+        ok = std::fwrite(buffer.data(), sizeof(double), n, file) == n;
+        written += n;
+    }
+    return std::fclose(file) == 0 && ok;
+}
+
+void evict_file_from_page_cache(const std::string& path) {
+#if !defined(_WIN32) && defined(POSIX_FADV_DONTNEED)
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    // Only clean pages can be dropped
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+#else
+    (void)path;
+#endif
+}
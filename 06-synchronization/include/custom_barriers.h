@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// User-level barriers for threads of one OpenMP team. Each is built for a fixed
+// number of threads and is called as barrier.wait(omp_get_thread_num()) by every
+// thread of the team, as a drop-in for #pragma omp barrier:
+//
+//   CentralBarrier       one shared counter and a sense flag that flips each episode
+//   TreeBarrier          combining tree: threads meet in groups of `fan_in`, and only
+//                        the last arrival of each group climbs to the parent
+//   DisseminationBarrier log2(n) rounds; in round r thread i signals thread i + 2^r.
+//                        No thread ever waits on a shared counter
+//   HierarchicalBarrier  threads first meet within their group (socket), then one
+//                        thread per group meets the other groups
+//
+// Spinning threads pause and periodically yield, so the barriers stay usable when
+// there are more threads than cores.
+
+class CentralBarrier {
+public:
+    explicit CentralBarrier(int num_threads);
+    void wait(int thread_id);
+
+private:
+    struct alignas(64) LocalSense {
+        bool sense = false;
+    };
+
+    int num_threads_;
+    alignas(64) std::atomic<int> count_{0};
+    alignas(64) std::atomic<bool> sense_{false};
+    std::unique_ptr<LocalSense[]> local_;
+};
+
+class TreeBarrier {
+public:
+    TreeBarrier(int num_threads, int fan_in = 4);
+    void wait(int thread_id);
+
+private:
+    struct alignas(64) Node {
+        std::atomic<int> count{0};
+        int expected = 0;  // Arrivals that complete this node
+        int parent = -1;
+    };
+    struct alignas(64) LocalSense {
+        bool sense = false;
+    };
+
+    std::vector<Node> nodes_;
+    std::vector<int> leaf_of_thread_;
+    alignas(64) std::atomic<bool> sense_{false};
+    std::unique_ptr<LocalSense[]> local_;
+};
+
+class DisseminationBarrier {
+public:
+    explicit DisseminationBarrier(int num_threads);
+    void wait(int thread_id);
+
+private:
+    // Signals received per round; counts only grow, so episodes need no reset
+    struct alignas(64) Flag {
+        std::atomic<unsigned> count{0};
+    };
+    struct alignas(64) Episode {
+        unsigned value = 0;
+    };
+
+    int num_threads_;
+    int rounds_;
+    std::unique_ptr<Flag[]> flags_;  // [thread * rounds_ + round]
+    std::unique_ptr<Episode[]> episode_;
+};
+
+class HierarchicalBarrier {
+public:
+    // group_of_thread[t] is the group (socket) of thread t; groups are numbered 0..g-1
+    HierarchicalBarrier(int num_threads, const std::vector<int>& group_of_thread);
+    void wait(int thread_id);
+
+    int group_count() const { return static_cast<int>(groups_.size()); }
+
+private:
+    struct alignas(64) Group {
+        std::atomic<int> count{0};
+        std::atomic<bool> sense{false};
+        int size = 0;
+    };
+    struct alignas(64) LocalSense {
+        bool sense = false;
+    };
+
+    std::vector<Group> groups_;
+    std::vector<int> group_of_thread_;
+    int active_groups_ = 0;  // Groups with at least one thread
+    alignas(64) std::atomic<int> global_count_{0};
+    alignas(64) std::atomic<bool> global_sense_{false};
+    std::unique_ptr<LocalSense[]> local_;
+};
+
+// Group (socket) of each thread of a num_threads team, for HierarchicalBarrier.
+// Uses the package of the CPU each thread runs on (Linux), otherwise the OpenMP place
+// when threads are bound (OMP_PLACES=sockets). On a single socket, or if neither is
+// available, threads are split into groups of about sqrt(num_threads).
+std::vector<int> detect_thread_groups(int num_threads);
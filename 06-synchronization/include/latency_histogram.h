@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <omp.h>
+#include "utils.h"
+
+// Log-bucketed latency histogram in the style of HdrHistogram. Values below 32 ns
+// get a bucket each; above that every power of two is split into 16 linear
+// sub-buckets, so any recorded value is reported within about 6%. Recording is
+// an index computation and an increment; no allocation, no sorting.
+class LatencyHistogram {
+public:
+    void record(uint64_t ns);
+    void merge(const LatencyHistogram& other);
+
+    uint64_t count() const { return count_; }
+    uint64_t max() const { return max_; }
+    double mean() const { return count_ > 0 ? static_cast<double>(sum_) / count_ : 0.0; }
+
+    // Value at percentile p (0-100), as the midpoint of its bucket
+    double percentile(double p) const;
+
+    utils::LatencySummary summary(const std::string& label) const;
+
+private:
+    static constexpr int SUB_BUCKET_BITS = 4;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int LINEAR_LIMIT = 2 * SUB_BUCKETS;  // Values below get one bucket each
+    static constexpr int BUCKETS = LINEAR_LIMIT + (64 - SUB_BUCKET_BITS - 1) * SUB_BUCKETS;
+
+    static int bucket_index(uint64_t ns);
+    static double bucket_midpoint(int index);
+
+    std::array<uint64_t, BUCKETS> buckets_{};
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t max_ = 0;
+};
+
+// One histogram per OpenMP thread, each on its own cache lines, merged only when
+// the results are read
+class PerThreadLatency {
+public:
+    explicit PerThreadLatency(int num_threads) : slots_(num_threads > 0 ? num_threads : 1) {}
+
+    // The calling thread's histogram
+    LatencyHistogram& local() { return slots_[omp_get_thread_num() % slots_.size()].histogram; }
+
+    LatencyHistogram merged() const;
+
+    // Mean latency of each thread, labelled "T0", "T1", ... for a fairness chart
+    std::vector<std::pair<std::string, double>> per_thread_mean_ns() const;
+
+private:
+    struct alignas(64) Slot {
+        LatencyHistogram histogram;
+    };
+    std::vector<Slot> slots_;
+};
+
+// Times `op` `iterations` times on every thread of a team of `num_threads` and
+// records each call in the thread's own histogram. `op` runs inside the parallel
+// region, so it may contain critical, atomic or barrier constructs.
+template <typename Op>
+void record_latencies(PerThreadLatency& latency, int num_threads, int iterations, Op op) {
+    #pragma omp parallel num_threads(num_threads)
+    {
+        LatencyHistogram& local = latency.local();
+        for (int i = 0; i < iterations; i++) {
+            auto start = std::chrono::steady_clock::now();
+            op();
+            auto end = std::chrono::steady_clock::now();
+            local.record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+        }
+    }
+}
+
+// Percentile table over the merged histograms, then a per-thread fairness chart
+// (mean latency of each thread) for every run
+void print_latency_report(const std::vector<std::pair<std::string, const PerThreadLatency*>>& runs);
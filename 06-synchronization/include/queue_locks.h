@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <omp.h>
+
+// Queue-based spin locks. A test-and-set lock (and most runtime locks under heavy
+// contention) has every waiter hammer the same cache line, and the line bounces
+// between cores on every release. These locks hand the lock over in FIFO order:
+//
+//   TicketLock  two counters; waiters spin on "now serving". Fair, but all waiters
+//               still read one line, so each release invalidates every waiter.
+//   MCSLock     waiters form a linked list and each spins on a flag in its own
+//               node; a release writes only the successor's node.
+//   CLHLock     an implicit list: each waiter spins on its predecessor's node.
+//               One atomic on acquire, none but a store on release.
+//
+// MCS and CLH keep one queue node per thread, indexed by omp_get_thread_num(), so a
+// lock serves the threads of one team of at most `max_threads` threads. A thread
+// number beyond that aborts with an error rather than indexing past the nodes.
+
+enum class QueueLockKind {
+    Omp,     // omp_lock_t, for comparison
+    Ticket,
+    MCS,
+    CLH
+};
+
+const char* queue_lock_name(QueueLockKind kind);
+
+class TicketLock {
+public:
+    void lock();
+    void unlock();
+
+private:
+    alignas(64) std::atomic<unsigned> next_ticket_{0};
+    alignas(64) std::atomic<unsigned> now_serving_{0};
+};
+
+class MCSLock {
+public:
+    // max_threads = 0 sizes the queue for omp_get_max_threads()
+    explicit MCSLock(int max_threads = 0);
+    void lock();
+    void unlock();
+
+private:
+    struct alignas(64) Node {
+        std::atomic<Node*> next{nullptr};
+        std::atomic<bool> locked{false};
+    };
+
+    int capacity_;
+    std::unique_ptr<Node[]> nodes_;
+    alignas(64) std::atomic<Node*> tail_{nullptr};
+};
+
+class CLHLock {
+public:
+    // max_threads = 0 sizes the queue for omp_get_max_threads()
+    explicit CLHLock(int max_threads = 0);
+    void lock();
+    void unlock();
+
+private:
+    struct alignas(64) Node {
+        std::atomic<bool> locked{false};
+    };
+
+    // The node a thread enqueues next and the predecessor it waits on. Nodes change
+    // hands: after a release the thread recycles its predecessor's node.
+    struct alignas(64) ThreadState {
+        Node* node = nullptr;
+        Node* pred = nullptr;
+    };
+
+    int capacity_;
+    std::unique_ptr<Node[]> nodes_;  // One per thread plus the initial tail
+    std::unique_ptr<ThreadState[]> threads_;
+    alignas(64) std::atomic<Node*> tail_{nullptr};
+};
+
+// Drop-in counterpart of omp_lock_t: the same init/set/unset/destroy calls, with the
+// lock algorithm chosen at init time
+typedef struct {
+    QueueLockKind kind;
+    omp_lock_t omp_lock;
+    void* impl;
+} queue_lock_t;
+
+// max_threads: largest team that will use the lock (0 = omp_get_max_threads())
+void queue_lock_init(queue_lock_t* lock, QueueLockKind kind, int max_threads = 0);
+void queue_lock_destroy(queue_lock_t* lock);
+void queue_lock_set(queue_lock_t* lock);
+void queue_lock_unset(queue_lock_t* lock);
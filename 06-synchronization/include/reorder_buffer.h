@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <thread>
+
+// Reorder buffer: restores input order after a parallel loop without #pragma omp
+// ordered. Workers post each finished item under its iteration index and carry on;
+// items are emitted strictly in index order by one thread at a time, whichever
+// poster finds the drain flag free. Only the emit step is serialized, and no worker
+// waits for its predecessor as it does in an ordered region.
+//
+// The window bounds memory: an item more than `window` positions ahead of the next
+// one to emit waits (backpressure), helping to drain while it does. The item that is
+// next in line always fits, so waiting cannot deadlock.
+//
+// Indices must run 0, 1, 2, ... with each posted exactly once.
+template <typename T>
+class ReorderBuffer {
+public:
+    using EmitFn = std::function<void(size_t index, T& value)>;
+
+    ReorderBuffer(size_t window, EmitFn emit)
+        : window_(window > 0 ? window : 1), slots_(new Slot[window_]), emit_(std::move(emit)) {}
+
+    ReorderBuffer(const ReorderBuffer&) = delete;
+    ReorderBuffer& operator=(const ReorderBuffer&) = delete;
+
+    // Called by workers, from any thread
+    void post(size_t index, T value) {
+        if (index >= next_.load(std::memory_order_acquire) + window_) {
+            backpressure_waits_.fetch_add(1, std::memory_order_relaxed);
+        }
+        int spins = 0;
+        while (index >= next_.load(std::memory_order_acquire) + window_) {
+            if (!try_drain() && ++spins % 64 == 0) {
+                std::this_thread::yield();
+            }
+        }
+        Slot& slot = slots_[index % window_];
+        slot.value = std::move(value);
+        // seq_cst here and on the drain flag: a poster and a retiring drainer must
+        // not both miss each other's write (store-load ordering)
+        slot.ready.store(index + 1);
+        try_drain();
+    }
+
+    // Emit everything that is ready; call once all items are posted to finish
+    void flush() {
+        while (try_drain()) {
+        }
+    }
+
+    size_t emitted() const { return next_.load(std::memory_order_acquire); }
+
+    // Posts that had to wait for window space
+    long long backpressure_waits() const { return backpressure_waits_.load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<size_t> ready{0};  // index + 1 once the item is posted
+        T value{};
+    };
+
+    // Become the drainer if nobody is; returns true if anything was emitted
+    bool try_drain() {
+        bool emitted_any = false;
+        for (;;) {
+            if (draining_.exchange(true)) {
+                return emitted_any;  // The current drainer will pick our item up
+            }
+            size_t next = next_.load(std::memory_order_relaxed);
+            for (;;) {
+                Slot& slot = slots_[next % window_];
+                if (slot.ready.load(std::memory_order_acquire) != next + 1) {
+                    break;
+                }
+                emit_(next, slot.value);
+                next++;
+                next_.store(next, std::memory_order_release);
+                emitted_any = true;
+            }
+            draining_.store(false);
+            // An item posted after our last check may have seen the flag held;
+            // go round again if the next one is waiting
+            if (slots_[next % window_].ready.load() != next + 1) {
+                return emitted_any;
+            }
+        }
+    }
+
+    size_t window_;
+    std::unique_ptr<Slot[]> slots_;
+    EmitFn emit_;
+    alignas(64) std::atomic<size_t> next_{0};  // Next index to emit
+    alignas(64) std::atomic<bool> draining_{false};
+    alignas(64) std::atomic<long long> backpressure_waits_{0};
+};
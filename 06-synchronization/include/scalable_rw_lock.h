@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <omp.h>
+
+// Reader-scalable reader-writer lock in the "big reader" style (as in BRAVO).
+// Every thread announces itself in its own cache-line-padded reader slot instead of
+// a shared counter, so concurrent readers never write the same cache line. A writer
+// raises a flag, which stops new readers, and then waits for every slot to drain.
+// Readers back off while the flag is up, which gives writers preference: a steady
+// stream of readers cannot starve them.
+class ScalableRWLock {
+public:
+    // slots = 0 uses one slot per available thread (omp_get_max_threads)
+    explicit ScalableRWLock(int slots = 0);
+    ~ScalableRWLock();
+
+    ScalableRWLock(const ScalableRWLock&) = delete;
+    ScalableRWLock& operator=(const ScalableRWLock&) = delete;
+
+    void read_lock();
+    void read_unlock();
+    void write_lock();
+    void write_unlock();
+
+private:
+    // One per cache line; padded so neighbouring readers do not share a line
+    struct alignas(64) ReaderSlot {
+        std::atomic<int> active{0};
+    };
+
+    ReaderSlot& my_slot();
+
+    std::unique_ptr<ReaderSlot[]> slots_;
+    int slot_count_;
+    alignas(64) std::atomic<bool> writer_pending_{false};
+    omp_lock_t writer_lock_;  // Serializes writers
+};
+
+// Sequence lock for tiny read-mostly data. Readers take no lock and write nothing:
+// they read the sequence number, copy the data, and retry if a writer was active or
+// finished in between. Writers still serialize on a lock and make the sequence odd
+// while they write.
+//
+// Readers copy the data while a writer may be changing it, so the protected fields
+// must be std::atomic accessed with memory_order_relaxed; the copy is only used once
+// the sequence check passes.
+class SeqLock {
+public:
+    SeqLock();
+    ~SeqLock();
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    // Run read_fn until it observes a consistent snapshot; returns the retry count
+    template <typename ReadFn>
+    int read(ReadFn read_fn) const {
+        int retries = 0;
+        for (;;) {
+            const unsigned before = sequence_.load(std::memory_order_acquire);
+            if ((before & 1u) == 0) {
+                read_fn();
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence_.load(std::memory_order_relaxed) == before) {
+                    return retries;
+                }
+            }
+            retries++;
+        }
+    }
+
+    void write_lock();
+    void write_unlock();
+
+private:
+    alignas(64) std::atomic<unsigned> sequence_{0};
+    omp_lock_t writer_lock_;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <omp.h>
+
+// Statistics counter split into one cache-line-padded slot per thread. A shared
+// atomic counter makes every increment pull the same line into the incrementing
+// core; here each thread only ever touches its own line, so increments from
+// different threads never contend.
+//
+// read() sums the slots. It is exact once the writers are quiescent (for example
+// after the parallel region or a barrier) and otherwise a value the counter passed
+// through recently, which is all a statistics counter needs.
+class ShardedCounter {
+public:
+    // shards = 0 uses one slot per available thread (omp_get_max_threads)
+    explicit ShardedCounter(int shards = 0)
+        : shard_count_(shards > 0 ? shards : std::max(omp_get_max_threads(), 1)),
+          shards_(new Shard[shard_count_]) {}
+
+    // Add to the calling thread's slot. Relaxed: the count orders nothing else.
+    // Threads beyond the slot count share slots, which stays correct.
+    void add(long long delta = 1) {
+        shards_[omp_get_thread_num() % shard_count_].value.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    long long read() const {
+        long long total = 0;
+        for (int s = 0; s < shard_count_; s++) {
+            total += shards_[s].value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    // Only meaningful while no thread is adding
+    void reset() {
+        for (int s = 0; s < shard_count_; s++) {
+            shards_[s].value.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    int shard_count() const { return shard_count_; }
+
+    // Thread-local batch in front of the counter: increments stay in a register and
+    // reach the shared slot every flush_every adds, and when the batch is destroyed.
+    // read() then lags by at most flush_every - 1 per live batch.
+    class Batch {
+    public:
+        explicit Batch(ShardedCounter& counter, int flush_every = 1024)
+            : counter_(counter), flush_every_(flush_every > 0 ? flush_every : 1) {}
+        ~Batch() { flush(); }
+
+        Batch(const Batch&) = delete;
+        Batch& operator=(const Batch&) = delete;
+
+        void add(long long delta = 1) {
+            pending_ += delta;
+            if (++adds_ >= flush_every_) {
+                flush();
+            }
+        }
+
+        void flush() {
+            if (pending_ != 0) {
+                counter_.add(pending_);
+                pending_ = 0;
+            }
+            adds_ = 0;
+        }
+
+    private:
+        ShardedCounter& counter_;
+        int flush_every_;
+        int adds_ = 0;
+        long long pending_ = 0;
+    };
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<long long> value{0};
+    };
+
+    int shard_count_;
+    std::unique_ptr<Shard[]> shards_;
+};
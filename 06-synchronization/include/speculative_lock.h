@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+// Speculative lock elision with Intel RTM (TSX). lock() first tries to run the
+// critical section as a hardware transaction without taking the lock; threads that
+// touch different data then commit in parallel. A transaction that aborts is retried
+// up to a budget, after which the thread takes the real (fallback) lock. Reading the
+// fallback lock inside every transaction means a thread holding it aborts all
+// speculative ones, so the two paths never overlap.
+//
+// Without RTM (no TSX in the CPU, disabled by microcode, or not x86) every lock()
+// goes straight to the fallback lock; rtm_supported() tells the caller which case
+// applies. Statistics are kept per thread, indexed by omp_get_thread_num() modulo
+// max_threads, in relaxed atomics so threads that share a slot (a larger or nested
+// team) still count correctly.
+
+// True if the CPU reports RTM (CPUID.(EAX=7,ECX=0):EBX bit 11)
+bool rtm_supported();
+
+// Why transactions ended, summed over all threads
+struct SpeculationStats {
+    long long commits = 0;         // Critical sections that ran as transactions
+    long long fallbacks = 0;       // Critical sections that took the real lock
+    long long aborts = 0;          // All aborts, including the ones counted below
+    long long abort_conflict = 0;  // Another thread touched the same cache line
+    long long abort_capacity = 0;  // Read or write set too large for the cache
+    long long abort_lock_busy = 0; // Fallback lock was held (explicit abort)
+    long long abort_other = 0;     // Interrupts, page faults, unsupported instructions
+};
+
+class ElidedLock {
+public:
+    // retry_budget: transactions tried before falling back. max_threads = 0 sizes
+    // the statistics for omp_get_max_threads().
+    explicit ElidedLock(int retry_budget = 4, int max_threads = 0);
+
+    void lock();
+    void unlock();
+
+    // True if lock() tries transactions at all
+    bool speculating() const { return use_rtm_; }
+
+    SpeculationStats stats() const;
+    void reset_stats();
+
+private:
+    // Same fields as SpeculationStats; one cache line per slot
+    struct alignas(64) ThreadStats {
+        std::atomic<long long> commits{0};
+        std::atomic<long long> fallbacks{0};
+        std::atomic<long long> aborts{0};
+        std::atomic<long long> abort_conflict{0};
+        std::atomic<long long> abort_capacity{0};
+        std::atomic<long long> abort_lock_busy{0};
+        std::atomic<long long> abort_other{0};
+    };
+
+    void lock_fallback();
+    ThreadStats& my_stats();
+
+    alignas(64) std::atomic<int> fallback_{0};
+    int retry_budget_;
+    int capacity_;
+    bool use_rtm_;
+    std::unique_ptr<ThreadStats[]> stats_;
+};
@@ -15,6 +15,7 @@ void demo_critical_sections(int num_threads, int workload);
 void demo_named_critical_sections(int num_threads, int workload);
 void demo_nested_critical_sections(int num_threads, int workload);
 void benchmark_critical_sections(int num_threads, int workload);
+void demo_queue_exchange(int num_threads, int workload);
 
 // Atomic operations demos
 void demo_atomic_operations(int num_threads, int workload);
@@ -30,6 +31,7 @@ void demo_simple_locks(int num_threads, int workload);
 void demo_nested_locks(int num_threads, int workload);
 void demo_lock_hints(int num_threads, int workload);
 void demo_reader_writer_locks(int num_threads, int workload);
+void demo_queue_locks(int num_threads, int workload);
 
 // Barriers demos
 void demo_barriers(int num_threads, int workload);
@@ -5,14 +5,13 @@
 #include <chrono>
 #include <functional>
 #include <iostream>
+#include "bench_core.h"
 
 namespace utils {
-    // Timer class for performance measurements
+    // Timer class for performance measurements, on the shared calibrated clock
     class Timer {
     private:
-        std::chrono::high_resolution_clock::time_point start_time;
-        std::chrono::high_resolution_clock::time_point end_time;
-        bool running;
+        bench::Timer timer;
 
     public:
         Timer();
@@ -24,7 +23,8 @@ namespace utils {
         bool is_running() const;
     };
 
-    // Benchmark a function with given parameters
+    // Benchmark a function with given parameters: the shared warmup policy, then
+    // num_runs timed runs; returns the mean without the fastest and slowest run
     double benchmark_function(std::function<void()> func, int num_runs = 5);
 
     // Progress bar visualization
@@ -60,14 +60,31 @@ namespace utils {
                          const std::string& label2, double value2, 
                          const std::string& unit = "ms");
 
+    // Latency distribution of one benchmark row, in nanoseconds
+    struct LatencySummary {
+        std::string label;
+        long long count = 0;
+        double mean_ns = 0.0;
+        double p50_ns = 0.0;
+        double p99_ns = 0.0;
+        double p999_ns = 0.0;
+        double max_ns = 0.0;
+    };
+
+    // Table of count, mean, p50, p99, p99.9 and max per row
+    void print_percentile_table(const std::vector<LatencySummary>& rows);
+
     // File I/O utilities
     void write_results_to_file(const std::string& filename, 
                               const std::vector<std::pair<std::string, double>>& results);
+    void write_results_to_file(const std::string& filename, 
+                              const std::vector<LatencySummary>& rows);
     
     // Race condition detection (simplified)
     bool detect_race_condition(std::function<void(int)> test_func, int iterations = 1000);
     
-    // ASCII chart for visualizing performance results
+    // ASCII chart for visualizing performance results: one horizontal bar per entry,
+    // the longest `width` characters wide; `height` caps the number of rows shown
     void draw_bar_chart(const std::vector<std::pair<std::string, double>>& data, 
                        int width = 60, int height = 10);
 
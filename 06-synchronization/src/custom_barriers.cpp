@@ -0,0 +1,239 @@
+#include "../include/custom_barriers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+#include <omp.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CUSTOM_BARRIERS_X86 1
+#endif
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace {
+
+inline void spin_wait(int& spins) {
+#ifdef CUSTOM_BARRIERS_X86
+    _mm_pause();
+#endif
+    if (++spins % 64 == 0) {
+        std::this_thread::yield();
+    }
+}
+
+} // namespace
+
+// ---------------- CentralBarrier ----------------
+
+CentralBarrier::CentralBarrier(int num_threads)
+    : num_threads_(std::max(num_threads, 1)), local_(new LocalSense[num_threads_]) {}
+
+void CentralBarrier::wait(int thread_id) {
+    const bool sense = !local_[thread_id].sense;
+    local_[thread_id].sense = sense;
+    if (count_.fetch_add(1, std::memory_order_acq_rel) == num_threads_ - 1) {
+        // Last arrival: reset for the next episode, then release everyone
+        count_.store(0, std::memory_order_relaxed);
+        sense_.store(sense, std::memory_order_release);
+    } else {
+        int spins = 0;
+        while (sense_.load(std::memory_order_acquire) != sense) {
+            spin_wait(spins);
+        }
+    }
+}
+
+// ---------------- TreeBarrier ----------------
+
+TreeBarrier::TreeBarrier(int num_threads, int fan_in) {
+    num_threads = std::max(num_threads, 1);
+    fan_in = std::max(fan_in, 2);
+    local_.reset(new LocalSense[num_threads]);
+    leaf_of_thread_.resize(num_threads);
+
+    // Build the tree bottom-up: level 0 groups threads, each higher level groups
+    // the nodes below it, until one node (the root) is left
+    std::vector<int> level_sizes;
+    int width = num_threads;
+    do {
+        width = (width + fan_in - 1) / fan_in;
+        level_sizes.push_back(width);
+    } while (width > 1);
+
+    int total = 0;
+    for (int size : level_sizes) {
+        total += size;
+    }
+    nodes_ = std::vector<Node>(total);
+
+    int level_start = 0;
+    int members = num_threads;
+    for (size_t level = 0; level < level_sizes.size(); level++) {
+        const int next_start = level_start + level_sizes[level];
+        for (int n = 0; n < level_sizes[level]; n++) {
+            Node& node = nodes_[level_start + n];
+            node.expected = std::min(fan_in, members - n * fan_in);
+            node.parent = level + 1 < level_sizes.size() ? next_start + n / fan_in : -1;
+        }
+        members = level_sizes[level];
+        level_start = next_start;
+    }
+    for (int t = 0; t < num_threads; t++) {
+        leaf_of_thread_[t] = t / fan_in;
+    }
+}
+
+void TreeBarrier::wait(int thread_id) {
+    const bool sense = !local_[thread_id].sense;
+    local_[thread_id].sense = sense;
+
+    // Climb while this thread is the last arrival at its node
+    int node_index = leaf_of_thread_[thread_id];
+    while (node_index >= 0) {
+        Node& node = nodes_[node_index];
+        if (node.count.fetch_add(1, std::memory_order_acq_rel) != node.expected - 1) {
+            int spins = 0;
+            while (sense_.load(std::memory_order_acquire) != sense) {
+                spin_wait(spins);
+            }
+            return;
+        }
+        node.count.store(0, std::memory_order_relaxed);
+        node_index = node.parent;
+    }
+    // Completed the root: everyone has arrived
+    sense_.store(sense, std::memory_order_release);
+}
+
+// ---------------- DisseminationBarrier ----------------
+
+DisseminationBarrier::DisseminationBarrier(int num_threads)
+    : num_threads_(std::max(num_threads, 1)), rounds_(0) {
+    while ((1 << rounds_) < num_threads_) {
+        rounds_++;
+    }
+    flags_.reset(new Flag[static_cast<size_t>(num_threads_) * std::max(rounds_, 1)]);
+    episode_.reset(new Episode[num_threads_]);
+}
+
+void DisseminationBarrier::wait(int thread_id) {
+    const unsigned episode = ++episode_[thread_id].value;
+    for (int round = 0; round < rounds_; round++) {
+        const int partner = (thread_id + (1 << round)) % num_threads_;
+        flags_[partner * rounds_ + round].count.fetch_add(1, std::memory_order_release);
+        // One signal arrives per round per episode; a partner that is already an
+        // episode ahead only makes the count larger
+        Flag& mine = flags_[thread_id * rounds_ + round];
+        int spins = 0;
+        while (static_cast<int>(mine.count.load(std::memory_order_acquire) - episode) < 0) {
+            spin_wait(spins);
+        }
+    }
+}
+
+// ---------------- HierarchicalBarrier ----------------
+
+HierarchicalBarrier::HierarchicalBarrier(int num_threads, const std::vector<int>& group_of_thread)
+    : group_of_thread_(group_of_thread) {
+    num_threads = std::max(num_threads, 1);
+    group_of_thread_.resize(num_threads, 0);
+    int group_total = 1;
+    for (int group : group_of_thread_) {
+        group_total = std::max(group_total, group + 1);
+    }
+    groups_ = std::vector<Group>(group_total);
+    for (int group : group_of_thread_) {
+        groups_[group].size++;
+    }
+    for (const Group& group : groups_) {
+        active_groups_ += group.size > 0 ? 1 : 0;
+    }
+    local_.reset(new LocalSense[num_threads]);
+}
+
+void HierarchicalBarrier::wait(int thread_id) {
+    const bool sense = !local_[thread_id].sense;
+    local_[thread_id].sense = sense;
+    Group& group = groups_[group_of_thread_[thread_id]];
+
+    if (group.count.fetch_add(1, std::memory_order_acq_rel) == group.size - 1) {
+        // Last in the group: represent it at the global level
+        group.count.store(0, std::memory_order_relaxed);
+        if (global_count_.fetch_add(1, std::memory_order_acq_rel) == active_groups_ - 1) {
+            global_count_.store(0, std::memory_order_relaxed);
+            global_sense_.store(sense, std::memory_order_release);
+        } else {
+            int spins = 0;
+            while (global_sense_.load(std::memory_order_acquire) != sense) {
+                spin_wait(spins);
+            }
+        }
+        // Release the group; its threads spin on their own socket's line
+        group.sense.store(sense, std::memory_order_release);
+    } else {
+        int spins = 0;
+        while (group.sense.load(std::memory_order_acquire) != sense) {
+            spin_wait(spins);
+        }
+    }
+}
+
+// ---------------- Topology ----------------
+
+std::vector<int> detect_thread_groups(int num_threads) {
+    num_threads = std::max(num_threads, 1);
+    std::vector<int> raw(num_threads, -1);
+
+#ifdef __linux__
+    {
+        #pragma omp parallel num_threads(num_threads)
+        {
+            const int cpu = sched_getcpu();
+            std::ifstream file("/sys/devices/system/cpu/cpu" + std::to_string(cpu) +
+                               "/topology/physical_package_id");
+            int package = -1;
+            if (cpu >= 0 && (file >> package)) {
+                raw[omp_get_thread_num()] = package;
+            }
+        }
+    }
+#endif
+#if defined(_OPENMP) && _OPENMP >= 201511
+    // Elsewhere, threads bound to places: with OMP_PLACES=sockets each place is one socket
+    if (std::find(raw.begin(), raw.end(), -1) != raw.end() &&
+        omp_get_proc_bind() != omp_proc_bind_false && omp_get_num_places() > 1) {
+        #pragma omp parallel num_threads(num_threads)
+        raw[omp_get_thread_num()] = omp_get_place_num();
+    }
+#endif
+
+    // Renumber densely in order of first appearance
+    std::map<int, int> dense;
+    std::vector<int> groups(num_threads);
+    bool complete = true;
+    for (int t = 0; t < num_threads; t++) {
+        if (raw[t] < 0) {
+            complete = false;
+            break;
+        }
+        auto it = dense.emplace(raw[t], static_cast<int>(dense.size())).first;
+        groups[t] = it->second;
+    }
+    if (complete && dense.size() > 1) {
+        return groups;
+    }
+
+    // One socket or unknown topology: groups of about sqrt(n) keep both levels busy
+    const int group_size = std::max(1, static_cast<int>(std::lround(std::sqrt(static_cast<double>(num_threads)))));
+    for (int t = 0; t < num_threads; t++) {
+        groups[t] = t / group_size;
+    }
+    return groups;
+}
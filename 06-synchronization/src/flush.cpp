@@ -1,11 +1,14 @@
 #include <iostream>
 #include <vector>
 #include <iomanip>
+#include <algorithm>
 #include <thread>
 #include <chrono>
+#include <memory>
 #include <omp.h>
 #include "../include/synchronization_demos.h"
 #include "../include/utils.h"
+#include "../include/lockfree_queue.h"
 
 // Simple flag-based signaling between threads using flush
 void demo_flush_signaling(int /*num_threads*/, int /*workload*/) {
@@ -230,6 +233,163 @@ void demo_implicit_flushes(int /*num_threads*/, int /*workload*/) {
     std::cout << "especially when implementing your own synchronization mechanisms.\n";
 }
 
+// The flush signaling pattern above, turned into a ring buffer: every push and
+// pop is bracketed by full #pragma omp flush fences (a seq_cst fence each) and
+// rereads the other side's index every time. Kept as the baseline for the
+// acquire/release channel below.
+class FlushChannel {
+public:
+    explicit FlushChannel(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask_ = size - 1;
+        slots_.reset(new int[size]);
+    }
+
+    // Producer thread only
+    bool try_push(int value) {
+        #pragma omp flush
+        const size_t tail = tail_;
+        if (tail - head_ > mask_) {
+            return false;
+        }
+        slots_[tail & mask_] = value;
+        #pragma omp flush
+        tail_ = tail + 1;
+        #pragma omp flush
+        return true;
+    }
+
+    // Consumer thread only
+    bool try_pop(int& value) {
+        #pragma omp flush
+        const size_t head = head_;
+        if (head == tail_) {
+            return false;
+        }
+        #pragma omp flush
+        value = slots_[head & mask_];
+        #pragma omp flush
+        head_ = head + 1;
+        #pragma omp flush
+        return true;
+    }
+
+private:
+    std::unique_ptr<int[]> slots_;
+    size_t mask_ = 0;
+    alignas(64) volatile size_t tail_ = 0;
+    alignas(64) volatile size_t head_ = 0;
+};
+
+template <typename Channel>
+void channel_send(Channel& channel, int value) {
+    int spins = 0;
+    while (!channel.try_push(value)) {
+        if (++spins % 64 == 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+template <typename Channel>
+int channel_receive(Channel& channel) {
+    int value = 0;
+    int spins = 0;
+    while (!channel.try_pop(value)) {
+        if (++spins % 64 == 0) {
+            std::this_thread::yield();
+        }
+    }
+    return value;
+}
+
+// Streams `messages` integers from thread 0 to thread 1; returns messages per
+// second, or 0 if the consumer saw them out of order
+template <typename Channel>
+double channel_throughput(int messages) {
+    Channel channel(1024);
+    bool in_order = true;
+    utils::Timer timer;
+    timer.start();
+    #pragma omp parallel num_threads(2)
+    {
+        if (omp_get_thread_num() == 0) {
+            for (int i = 0; i < messages; i++) {
+                channel_send(channel, i);
+            }
+        } else {
+            for (int i = 0; i < messages; i++) {
+                if (channel_receive(channel) != i) {
+                    in_order = false;
+                }
+            }
+        }
+    }
+    timer.stop();
+    double seconds = timer.elapsed_seconds();
+    return in_order && seconds > 0.0 ? messages / seconds : 0.0;
+}
+
+// Ping-pong over a pair of channels; returns the mean round trip in ns
+template <typename Channel>
+double channel_round_trip_ns(int round_trips) {
+    Channel ping(16);
+    Channel pong(16);
+    utils::Timer timer;
+    timer.start();
+    #pragma omp parallel num_threads(2)
+    {
+        if (omp_get_thread_num() == 0) {
+            for (int i = 0; i < round_trips; i++) {
+                channel_send(ping, i);
+                channel_receive(pong);
+            }
+        } else {
+            for (int i = 0; i < round_trips; i++) {
+                channel_send(pong, channel_receive(ping));
+            }
+        }
+    }
+    timer.stop();
+    return timer.elapsed_ms() * 1e6 / round_trips;
+}
+
+// Flush-fenced ring versus the acquire/release SPSCQueue from lockfree_queue.h
+void demo_channel_benchmark(int /*num_threads*/, int workload) {
+    utils::print_subsection("SPSC Channel: flush vs acquire/release");
+    std::cout << "One producer and one consumer exchange integers through a ring buffer:\n";
+    std::cout << "  flush fences     - full #pragma omp flush around every index update\n";
+    std::cout << "  acquire/release  - SPSCQueue: one release store per message, and the\n";
+    std::cout << "                     other side's index is only reloaded when the cached\n";
+    std::cout << "                     copy says the ring looks full or empty\n\n";
+    
+    const int messages = std::max(workload, 100000);
+    const int round_trips = std::max(workload / 10, 10000);
+    
+    double flush_rate = channel_throughput<FlushChannel>(messages);
+    double acqrel_rate = channel_throughput<SPSCQueue<int>>(messages);
+    double flush_rtt = channel_round_trip_ns<FlushChannel>(round_trips);
+    double acqrel_rtt = channel_round_trip_ns<SPSCQueue<int>>(round_trips);
+    
+    std::cout << std::left << std::setw(18) << "Channel" << std::right << std::setw(16) << "Msgs/sec"
+              << std::setw(18) << "Round trip ns" << "\n";
+    std::cout << std::string(52, '-') << "\n";
+    std::cout << std::fixed << std::setprecision(0);
+    std::cout << std::left << std::setw(18) << "flush fences" << std::right << std::setw(16) << flush_rate
+              << std::setw(18) << flush_rtt << "\n";
+    std::cout << std::left << std::setw(18) << "acquire/release" << std::right << std::setw(16) << acqrel_rate
+              << std::setw(18) << acqrel_rtt << "\n";
+    std::cout.unsetf(std::ios::fixed);
+    
+    std::cout << "\n(" << messages << " messages streamed, " << round_trips << " round trips; a rate of 0\n";
+    std::cout << "means the consumer saw messages out of order)\n";
+    std::cout << "Round trips need both threads running at once; with fewer cores than\n";
+    std::cout << "threads they measure the scheduler's time slice, not the channel.\n";
+}
+
 // Main flush demo function
 void demo_flush(int num_threads, int workload) {
     utils::print_section("OpenMP Flush Directive");
@@ -248,4 +408,8 @@ void demo_flush(int num_threads, int workload) {
     
     // Demonstrate memory consistency issues
     demo_memory_consistency(num_threads, workload > 0 ? workload : 1000);
+    utils::pause_console();
+    
+    // Compare a flush-based channel with an acquire/release one
+    demo_channel_benchmark(num_threads, workload > 0 ? workload : 1000);
 } 
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "../include/latency_histogram.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+int floor_log2(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(value);
+#else
+    int exponent = 0;
+    while (value >>= 1) {
+        exponent++;
+    }
+    return exponent;
+#endif
+}
+
+} // namespace
+
+int LatencyHistogram::bucket_index(uint64_t ns) {
+    if (ns < static_cast<uint64_t>(LINEAR_LIMIT)) {
+        return static_cast<int>(ns);
+    }
+    // The top SUB_BUCKET_BITS + 1 bits select the bucket; the leading one is implied
+    const int exponent = floor_log2(ns);
+    const int shift = exponent - SUB_BUCKET_BITS;
+    const int sub = static_cast<int>(ns >> shift) - SUB_BUCKETS;
+    return LINEAR_LIMIT + (exponent - SUB_BUCKET_BITS - 1) * SUB_BUCKETS + sub;
+}
+
+double LatencyHistogram::bucket_midpoint(int index) {
+    if (index < LINEAR_LIMIT) {
+        return index;
+    }
+    const int exponent = (index - LINEAR_LIMIT) / SUB_BUCKETS + SUB_BUCKET_BITS + 1;
+    const int sub = (index - LINEAR_LIMIT) % SUB_BUCKETS;
+    const double width = static_cast<double>(1ULL << (exponent - SUB_BUCKET_BITS));
+    return (SUB_BUCKETS + sub) * width + width / 2.0;
+}
+
+void LatencyHistogram::record(uint64_t ns) {
+    buckets_[bucket_index(ns)]++;
+    count_++;
+    sum_ += ns;
+    max_ = std::max(max_, ns);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (int i = 0; i < BUCKETS; i++) {
+        buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    max_ = std::max(max_, other.max_);
+}
+
+double LatencyHistogram::percentile(double p) const {
+    if (count_ == 0) {
+        return 0.0;
+    }
+    // Rank of the requested sample, 1-based
+    uint64_t rank = static_cast<uint64_t>(p / 100.0 * count_ + 0.5);
+    rank = std::min(std::max<uint64_t>(rank, 1), count_);
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+        seen += buckets_[i];
+        if (seen >= rank) {
+            return std::min(bucket_midpoint(i), static_cast<double>(max_));
+        }
+    }
+    return static_cast<double>(max_);
+}
+
+utils::LatencySummary LatencyHistogram::summary(const std::string& label) const {
+    utils::LatencySummary row;
+    row.label = label;
+    row.count = static_cast<long long>(count_);
+    row.mean_ns = mean();
+    row.p50_ns = percentile(50.0);
+    row.p99_ns = percentile(99.0);
+    row.p999_ns = percentile(99.9);
+    row.max_ns = static_cast<double>(max_);
+    return row;
+}
+
+LatencyHistogram PerThreadLatency::merged() const {
+    LatencyHistogram total;
+    for (const auto& slot : slots_) {
+        total.merge(slot.histogram);
+    }
+    return total;
+}
+
+std::vector<std::pair<std::string, double>> PerThreadLatency::per_thread_mean_ns() const {
+    std::vector<std::pair<std::string, double>> means;
+    for (size_t t = 0; t < slots_.size(); t++) {
+        if (slots_[t].histogram.count() > 0) {
+            means.push_back({"T" + std::to_string(t), slots_[t].histogram.mean()});
+        }
+    }
+    return means;
+}
+
+void print_latency_report(const std::vector<std::pair<std::string, const PerThreadLatency*>>& runs) {
+    std::vector<utils::LatencySummary> rows;
+    for (const auto& run : runs) {
+        rows.push_back(run.second->merged().summary(run.first));
+    }
+    utils::print_percentile_table(rows);
+
+    for (const auto& run : runs) {
+        auto means = run.second->per_thread_mean_ns();
+        if (means.size() < 2) {
+            continue;
+        }
+        auto bounds = std::minmax_element(means.begin(), means.end(),
+            [](const std::pair<std::string, double>& a, const std::pair<std::string, double>& b) {
+                return a.second < b.second;
+            });
+        std::cout << "\n" << run.first << " - mean ns per thread (slowest/fastest "
+                  << std::fixed << std::setprecision(2)
+                  << (bounds.first->second > 0.0 ? bounds.second->second / bounds.first->second : 0.0)
+                  << "x)\n";
+        utils::draw_bar_chart(means, 40, static_cast<int>(means.size()));
+    }
+}
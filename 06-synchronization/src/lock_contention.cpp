@@ -1,23 +1,128 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <iomanip>
+#include <memory>
+#include <chrono>
 #include <omp.h>
 #include "../include/synchronization_demos.h"
 #include "../include/utils.h"
+#include "../include/lock_profiler.h"
 
-// Note: The actual implementation of the lock contention visualization
-// is in thread_timeline.cpp for code organization purposes.
-// This file serves as a wrapper to maintain the API consistency.
+// Busy work inside or outside a lock, kept from being optimized away
+static void spin_work(int rounds) {
+    for (volatile int j = 0; j < rounds; j++) { }
+}
 
-// This is just a stub since the actual implementation is in thread_timeline.cpp
-// to avoid duplication. The header expects this function to exist.
+// Average cost of one set/unset pair on an uncontended lock, in ns
+template <typename SetFn, typename UnsetFn>
+static double uncontended_pair_ns(int pairs, SetFn set, UnsetFn unset) {
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < pairs; i++) {
+        set();
+        unset();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - begin).count() / pairs;
+}
+
+// Profile the locks of a small order-processing loop and rank them by the time
+// threads spent waiting for each
 void visualize_lock_contention(int num_threads, int workload) {
-    utils::print_section("Lock Contention Visualization");
-    std::cout << "For lock contention visualization, please use the Thread Timeline visualization\n";
-    std::cout << "which includes lock contention analysis as part of its demonstration.\n\n";
-    
-    std::cout << "Running the Thread Timeline visualization instead...\n";
-    
-    // Call the thread timeline visualization which includes lock contention
-    visualize_thread_timeline(num_threads, workload);
-} 
\ No newline at end of file
+    utils::print_section("Lock Contention Profile");
+
+    if (num_threads <= 0) {
+        num_threads = omp_get_max_threads();
+    }
+    const int items = std::max(workload, 20000);
+    const int stripes = 16;
+
+    std::cout << "Each of " << items << " orders takes these locks:\n";
+    std::cout << "  inventory        - one global omp_lock_t, every order, short hold\n";
+    std::cout << "  account_stripe   - one of " << stripes << " striped locks, every order (reported together)\n";
+    std::cout << "  critical(stats)  - a named critical section, every 8th order\n";
+    std::cout << "  audit_log        - one omp_lock_t, every 32nd order, long hold\n\n";
+
+    utils::print_result("Number of threads", num_threads);
+
+    reset_lock_profiles();
+    long long inventory = 0;
+    long long stats = 0;
+    long long audit_entries = 0;
+    std::vector<long long> balances(stripes, 0);
+    {
+        ProfiledLock inventory_lock("inventory");
+        ProfiledLock audit_lock("audit_log");
+        std::vector<std::unique_ptr<ProfiledLock>> account_locks;
+        for (int s = 0; s < stripes; s++) {
+            account_locks.emplace_back(new ProfiledLock("account_stripe"));
+        }
+        LockSite stats_site("critical(stats)");
+
+        utils::Timer timer;
+        timer.start();
+        #pragma omp parallel for num_threads(num_threads) schedule(dynamic, 64)
+        for (int i = 0; i < items; i++) {
+            spin_work(200);  // Work outside any lock
+
+            inventory_lock.set();
+            inventory++;
+            spin_work(20);
+            inventory_lock.unset();
+
+            ProfiledLock& account = *account_locks[(i * 7) % stripes];
+            account.set();
+            balances[(i * 7) % stripes] += i;
+            spin_work(50);
+            account.unset();
+
+            if (i % 8 == 0) {
+                uint64_t arrival = LockSite::now_ns();
+                #pragma omp critical(stats)
+                {
+                    CriticalHold hold(stats_site, arrival);
+                    stats++;
+                    spin_work(100);
+                }
+            }
+
+            if (i % 32 == 0) {
+                audit_lock.set();
+                audit_entries++;
+                spin_work(2000);
+                audit_lock.unset();
+            }
+        }
+        timer.stop();
+        utils::print_result("Run time", timer.elapsed_ms(), "ms");
+
+        const bool counts_correct = inventory == items && stats == (items + 7) / 8 &&
+                                    audit_entries == (items + 31) / 32;
+        utils::print_result("All counters exact", counts_correct ? 1 : 0);
+    }
+
+    utils::print_subsection("Locks Ranked by Total Wait");
+    print_lock_profiles();
+
+    std::cout << "\nHandoff%: acquisitions by a different thread than the previous holder; each\n";
+    std::cout << "one moves the lock and the data it protects to another core.\n";
+    std::cout << "Wait%: share of the time threads spent at this lock that was waiting rather\n";
+    std::cout << "than holding. A lock near the top with a high Wait% is the one to split,\n";
+    std::cout << "shorten or replace; striping spreads account_stripe over " << stripes << " locks.\n";
+
+    // What the profiling itself costs, without contention
+    omp_lock_t raw_lock;
+    omp_init_lock(&raw_lock);
+    ProfiledLock probe_lock("overhead_probe");
+    const int pairs = 200000;
+    double raw_ns = uncontended_pair_ns(pairs, [&]() { omp_set_lock(&raw_lock); },
+                                        [&]() { omp_unset_lock(&raw_lock); });
+    double profiled_ns = uncontended_pair_ns(pairs, [&]() { probe_lock.set(); }, [&]() { probe_lock.unset(); });
+    omp_destroy_lock(&raw_lock);
+
+    std::cout << "\nProfiling overhead (uncontended set/unset pair):\n";
+    utils::print_result("omp_lock_t", raw_ns, "ns");
+    utils::print_result("ProfiledLock", profiled_ns, "ns");
+
+    std::cout << "\nFor how lock waits line up over time per thread, see the Thread Timeline demo.\n";
+}
@@ -0,0 +1,117 @@
+#include "../include/lock_profiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+
+namespace {
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<LockSite*> live;
+    std::map<std::string, LockProfile> retired;  // Totals of destroyed sites
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+void accumulate(LockProfile& total, const LockProfile& part) {
+    total.acquisitions += part.acquisitions;
+    total.handoffs += part.handoffs;
+    total.wait_ns += part.wait_ns;
+    total.hold_ns += part.hold_ns;
+    total.max_wait_ns = std::max(total.max_wait_ns, part.max_wait_ns);
+}
+
+} // namespace
+
+LockSite::LockSite(const std::string& name) {
+    profile_.name = name;
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.mutex);
+    reg.live.push_back(this);
+}
+
+LockSite::~LockSite() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.mutex);
+    reg.live.erase(std::remove(reg.live.begin(), reg.live.end(), this), reg.live.end());
+    LockProfile& total = reg.retired[profile_.name];
+    total.name = profile_.name;
+    accumulate(total, profile_);
+}
+
+std::vector<LockProfile> lock_profiles() {
+    Registry& reg = registry();
+    std::map<std::string, LockProfile> by_name;
+    {
+        std::lock_guard<std::mutex> guard(reg.mutex);
+        by_name = reg.retired;
+        for (const LockSite* site : reg.live) {
+            LockProfile& total = by_name[site->profile().name];
+            total.name = site->profile().name;
+            accumulate(total, site->profile());
+        }
+    }
+    
+    std::vector<LockProfile> profiles;
+    for (const auto& entry : by_name) {
+        if (entry.second.acquisitions > 0) {
+            profiles.push_back(entry.second);
+        }
+    }
+    std::sort(profiles.begin(), profiles.end(), [](const LockProfile& a, const LockProfile& b) {
+        return a.wait_ns > b.wait_ns;
+    });
+    return profiles;
+}
+
+void reset_lock_profiles() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.mutex);
+    reg.retired.clear();
+    for (LockSite* site : reg.live) {
+        site->reset();
+    }
+}
+
+void print_lock_profiles(size_t max_rows) {
+    std::vector<LockProfile> profiles = lock_profiles();
+    if (profiles.empty()) {
+        std::cout << "No profiled lock has been acquired.\n";
+        return;
+    }
+    
+    size_t name_width = 6;
+    for (const auto& profile : profiles) {
+        name_width = std::max(name_width, profile.name.size() + 2);
+    }
+    
+    std::cout << std::left << std::setw(static_cast<int>(name_width)) << "Lock" << std::right
+              << std::setw(11) << "Acquires" << std::setw(10) << "Handoff%" << std::setw(11) << "Wait ms"
+              << std::setw(12) << "Avg wait ns" << std::setw(12) << "Max wait us" << std::setw(10) << "Hold ms"
+              << std::setw(9) << "Wait%" << "\n";
+    std::cout << std::string(name_width + 75, '-') << "\n";
+    std::cout << std::fixed;
+    for (size_t i = 0; i < profiles.size() && i < max_rows; i++) {
+        const LockProfile& p = profiles[i];
+        const double acquisitions = static_cast<double>(p.acquisitions);
+        const double busy = static_cast<double>(p.wait_ns + p.hold_ns);
+        std::cout << std::left << std::setw(static_cast<int>(name_width)) << p.name << std::right
+                  << std::setw(11) << p.acquisitions
+                  << std::setprecision(1) << std::setw(10) << 100.0 * p.handoffs / acquisitions
+                  << std::setprecision(2) << std::setw(11) << p.wait_ns / 1e6
+                  << std::setprecision(0) << std::setw(12) << p.wait_ns / acquisitions
+                  << std::setprecision(1) << std::setw(12) << p.max_wait_ns / 1e3
+                  << std::setprecision(2) << std::setw(10) << p.hold_ns / 1e6
+                  << std::setprecision(1) << std::setw(9) << (busy > 0.0 ? 100.0 * p.wait_ns / busy : 0.0)
+                  << "\n";
+    }
+    if (profiles.size() > max_rows) {
+        std::cout << "(" << profiles.size() - max_rows << " more locks not shown)\n";
+    }
+}
@@ -116,6 +116,11 @@ std::vector<std::pair<std::string, std::vector<DemoMenuItem>>> get_all_demos() {
                 "Critical Sections Performance",
                 "Benchmark the performance overhead of critical sections",
                 benchmark_critical_sections
+            },
+            {
+                "Producer/Consumer Queues",
+                "Critical, lock and lock-free queues between producer and consumer threads",
+                demo_queue_exchange
             }
         }
     });
@@ -185,6 +190,11 @@ std::vector<std::pair<std::string, std::vector<DemoMenuItem>>> get_all_demos() {
                 "Reader-Writer Locks",
                 "Implementing reader-writer locks for parallel access patterns",
                 demo_reader_writer_locks
+            },
+            {
+                "Queue Locks",
+                "Ticket, MCS and CLH locks versus omp_lock_t under contention",
+                demo_queue_locks
             }
         }
     });
@@ -321,12 +331,8 @@ int main(int argc, char* argv[]) {
     
     // Run in benchmark mode if requested
     if (options.benchmark_mode) {
-        utils::print_header("OpenMP Synchronization Benchmarks");
-        // Kilitlenmeyi önlemek için workload ve thread sayısını sınırlayalım
-        int safe_threads = options.num_threads > 0 ? std::min(options.num_threads, 4) : 4;
-        int safe_workload = std::min(options.workload, 1000);
-        std::cout << "\nRunning all benchmarks with " << safe_threads << " threads and workload size " << safe_workload << "\n";
-        run_benchmarks(safe_threads, safe_workload);
+        // The matrix sweeps thread counts itself; --threads sets the largest
+        run_benchmarks(options.num_threads, options.workload);
         return 0;
     }
     
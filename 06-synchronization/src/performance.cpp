@@ -1,31 +1,371 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <iomanip>
+#include <fstream>
+#include <algorithm>
+#include <functional>
 #include <omp.h>
 #include "../include/synchronization_demos.h"
 #include "../include/utils.h"
+#include "../include/scalable_rw_lock.h"
+#include "perf_markers.h"
+
+namespace {
+
+// Busy work standing in for the body of a critical section
+inline void spin_work(int rounds) {
+    for (volatile int j = 0; j < rounds; j++) { }
+}
+
+// One cell of the matrix
+struct MatrixRow {
+    std::string primitive;
+    int threads = 0;
+    int cs_length = 0;
+    long long ops = 0;
+    double seconds = 0.0;
+    double ops_per_sec = 0.0;
+    double efficiency = 0.0;  // (ops/sec at T / ops/sec at 1 thread) / T
+    bool correct = true;
+};
+
+// A primitive under test: runs `ops_per_thread` synchronized operations on each of
+// `threads` threads, each holding the primitive for `cs_length` spin rounds, and
+// returns false if the protected state came out wrong
+struct Primitive {
+    std::string name;
+    bool takes_cs_length;  // Atomics have no body to lengthen
+    std::function<bool(int threads, int ops_per_thread, int cs_length)> run;
+};
+
+std::vector<Primitive> matrix_primitives() {
+    std::vector<Primitive> primitives;
+
+    primitives.push_back({"critical", true, [](int threads, int ops, int cs) {
+        long long counter = 0;
+        #pragma omp parallel num_threads(threads)
+        for (int i = 0; i < ops; i++) {
+            #pragma omp critical
+            {
+                counter++;
+                spin_work(cs);
+            }
+        }
+        return counter == static_cast<long long>(threads) * ops;
+    }});
+
+    primitives.push_back({"critical(name)", true, [](int threads, int ops, int cs) {
+        long long counter = 0;
+        #pragma omp parallel num_threads(threads)
+        for (int i = 0; i < ops; i++) {
+            #pragma omp critical(matrix_counter)
+            {
+                counter++;
+                spin_work(cs);
+            }
+        }
+        return counter == static_cast<long long>(threads) * ops;
+    }});
+
+    primitives.push_back({"atomic update", false, [](int threads, int ops, int) {
+        long long counter = 0;
+        #pragma omp parallel num_threads(threads)
+        for (int i = 0; i < ops; i++) {
+            #pragma omp atomic
+            counter++;
+        }
+        return counter == static_cast<long long>(threads) * ops;
+    }});
+
+    primitives.push_back({"atomic capture", false, [](int threads, int ops, int) {
+        long long counter = 0;
+        long long last_seen = 0;
+        #pragma omp parallel num_threads(threads) reduction(max:last_seen)
+        for (int i = 0; i < ops; i++) {
+            long long previous;
+            #pragma omp atomic capture
+            previous = counter++;
+            last_seen = std::max(last_seen, previous);
+        }
+        return counter == static_cast<long long>(threads) * ops && last_seen == counter - 1;
+    }});
+
+    primitives.push_back({"omp_lock", true, [](int threads, int ops, int cs) {
+        long long counter = 0;
+        omp_lock_t lock;
+        omp_init_lock(&lock);
+        #pragma omp parallel num_threads(threads)
+        for (int i = 0; i < ops; i++) {
+            omp_set_lock(&lock);
+            counter++;
+            spin_work(cs);
+            omp_unset_lock(&lock);
+        }
+        omp_destroy_lock(&lock);
+        return counter == static_cast<long long>(threads) * ops;
+    }});
+
+    primitives.push_back({"omp_nest_lock", true, [](int threads, int ops, int cs) {
+        long long counter = 0;
+        omp_nest_lock_t lock;
+        omp_init_nest_lock(&lock);
+        #pragma omp parallel num_threads(threads)
+        for (int i = 0; i < ops; i++) {
+            // Taken twice, as a recursive caller would
+            omp_set_nest_lock(&lock);
+            omp_set_nest_lock(&lock);
+            counter++;
+            spin_work(cs);
+            omp_unset_nest_lock(&lock);
+            omp_unset_nest_lock(&lock);
+        }
+        omp_destroy_nest_lock(&lock);
+        return counter == static_cast<long long>(threads) * ops;
+    }});
+
+    primitives.push_back({"rw lock 90% read", true, [](int threads, int ops, int cs) {
+        long long value = 0;
+        long long writes = 0;
+        long long bad_reads = 0;
+        ScalableRWLock lock(threads);
+        #pragma omp parallel num_threads(threads) reduction(+:writes, bad_reads)
+        for (int i = 0; i < ops; i++) {
+            if (i % 10 == 0) {
+                lock.write_lock();
+                value++;
+                spin_work(cs);
+                value++;
+                lock.write_unlock();
+                writes++;
+            } else {
+                lock.read_lock();
+                // A writer is never halfway through while we hold the read lock
+                bad_reads += (value % 2 != 0) ? 1 : 0;
+                spin_work(cs);
+                lock.read_unlock();
+            }
+        }
+        return bad_reads == 0 && value == 2 * writes;
+    }});
+
+    primitives.push_back({"barrier", true, [](int threads, int ops, int cs) {
+        long long arrivals = 0;
+        long long early = 0;
+        #pragma omp parallel num_threads(threads) reduction(+:early)
+        for (int i = 0; i < ops; i++) {
+            spin_work(cs);
+            #pragma omp atomic
+            arrivals++;
+            #pragma omp barrier
+            long long seen;
+            #pragma omp atomic read
+            seen = arrivals;
+            early += seen < static_cast<long long>(threads) * (i + 1) ? 1 : 0;
+            // Keep the next round's arrivals from racing this round's check
+            #pragma omp barrier
+        }
+        return early == 0;
+    }});
+
+    primitives.push_back({"ordered", true, [](int threads, int ops, int cs) {
+        const long long total = static_cast<long long>(threads) * ops;
+        long long next = 0;
+        bool in_order = true;
+        #pragma omp parallel for num_threads(threads) schedule(static, 1) ordered
+        for (long long i = 0; i < total; i++) {
+            #pragma omp ordered
+            {
+                in_order = in_order && next == i;
+                next++;
+                spin_work(cs);
+            }
+        }
+        return in_order && next == total;
+    }});
+
+    return primitives;
+}
+
+// Thread counts 1, 2, 4, ... up to and including max_threads
+std::vector<int> thread_sweep(int max_threads) {
+    std::vector<int> counts;
+    for (int t = 1; t < max_threads; t *= 2) {
+        counts.push_back(t);
+    }
+    counts.push_back(max_threads);
+    return counts;
+}
+
+// Every primitive at every thread count and critical-section length. The total
+// operation count of a primitive/length pair is the same at every thread count
+// (strong scaling), so throughput at T threads against 1 thread gives the scaling
+// efficiency directly.
+std::vector<MatrixRow> run_benchmark_matrix(const std::vector<int>& thread_counts,
+                                            const std::vector<int>& cs_lengths, long long total_ops) {
+    std::vector<MatrixRow> rows;
+    for (const Primitive& primitive : matrix_primitives()) {
+        for (int cs_length : cs_lengths) {
+            if (cs_length > 0 && !primitive.takes_cs_length) {
+                continue;
+            }
+            // Longer critical sections get proportionally fewer operations
+            const long long cell_ops = total_ops * 100 / (100 + cs_length);
+            double single_thread_rate = 0.0;
+            for (int threads : thread_counts) {
+                const int ops_per_thread = static_cast<int>(std::max<long long>(cell_ops / threads, 1));
+                // Barriers and ordered make every thread wait for all; keep them short
+                const bool lockstep = primitive.name == "barrier" || primitive.name == "ordered";
+                const int ops = lockstep ? std::max(ops_per_thread / 10, 1) : ops_per_thread;
+
+                MatrixRow row;
+                row.primitive = primitive.name;
+                row.threads = threads;
+                row.cs_length = cs_length;
+                row.ops = static_cast<long long>(ops) * threads;
+                PERF_FRAME_BEGIN("Benchmark matrix cell");
+                const double start = omp_get_wtime();
+                row.correct = primitive.run(threads, ops, cs_length);
+                row.seconds = omp_get_wtime() - start;
+                PERF_FRAME_END("Benchmark matrix cell");
+                row.ops_per_sec = row.seconds > 0.0 ? row.ops / row.seconds : 0.0;
+                PERF_COUNTER("Synchronization ops/s", row.ops_per_sec);
+                if (threads == thread_counts.front()) {
+                    single_thread_rate = row.ops_per_sec / threads;
+                }
+                row.efficiency = single_thread_rate > 0.0 ? row.ops_per_sec / (single_thread_rate * threads) : 0.0;
+                rows.push_back(row);
+            }
+        }
+    }
+    return rows;
+}
+
+void print_matrix(const std::vector<MatrixRow>& rows) {
+    std::cout << std::left << std::setw(18) << "Primitive" << std::right << std::setw(8) << "CS len"
+              << std::setw(9) << "Threads" << std::setw(14) << "Ops/sec" << std::setw(12) << "Efficiency"
+              << std::setw(9) << "Check" << "\n";
+    std::cout << std::string(70, '-') << "\n";
+    std::string last_group;
+    for (const MatrixRow& row : rows) {
+        const std::string group = row.primitive + "/" + std::to_string(row.cs_length);
+        if (!last_group.empty() && group != last_group && row.threads == rows.front().threads) {
+            std::cout << "\n";
+        }
+        last_group = group;
+        std::cout << std::left << std::setw(18) << row.primitive << std::right << std::setw(8) << row.cs_length
+                  << std::setw(9) << row.threads << std::fixed << std::setprecision(0) << std::setw(14)
+                  << row.ops_per_sec << std::setprecision(2) << std::setw(12) << row.efficiency
+                  << std::setw(9) << (row.correct ? "PASSED" : "FAILED") << "\n";
+    }
+}
+
+void write_matrix_csv(const std::string& filename, const std::vector<MatrixRow>& rows) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << " for writing.\n";
+        return;
+    }
+    file << "primitive,threads,cs_length,ops,seconds,ops_per_sec,efficiency,correct\n";
+    for (const MatrixRow& row : rows) {
+        file << row.primitive << "," << row.threads << "," << row.cs_length << "," << row.ops << ","
+             << std::setprecision(6) << std::fixed << row.seconds << "," << std::setprecision(1)
+             << row.ops_per_sec << "," << std::setprecision(4) << row.efficiency << ","
+             << (row.correct ? "true" : "false") << "\n";
+    }
+}
+
+void write_matrix_json(const std::string& filename, const std::vector<MatrixRow>& rows, int max_threads) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << " for writing.\n";
+        return;
+    }
+    file << "{\n";
+    file << "  \"openmp\": " << _OPENMP << ",\n";
+    file << "  \"max_threads\": " << max_threads << ",\n";
+    file << "  \"num_procs\": " << omp_get_num_procs() << ",\n";
+    file << "  \"results\": [\n";
+    for (size_t i = 0; i < rows.size(); i++) {
+        const MatrixRow& row = rows[i];
+        file << "    {\"primitive\": \"" << row.primitive << "\", \"threads\": " << row.threads
+             << ", \"cs_length\": " << row.cs_length << ", \"ops\": " << row.ops
+             << std::fixed << ", \"seconds\": " << std::setprecision(6) << row.seconds
+             << ", \"ops_per_sec\": " << std::setprecision(1) << row.ops_per_sec
+             << ", \"efficiency\": " << std::setprecision(4) << row.efficiency
+             << ", \"correct\": " << (row.correct ? "true" : "false") << "}"
+             << (i + 1 < rows.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n}\n";
+}
+
+// One result per cell in the shared results file (BENCH_RESULTS): the
+// primitive is the benchmark, the critical-section length the variant
+void record_matrix(const std::vector<MatrixRow>& rows) {
+    for (const MatrixRow& row : rows) {
+        bench::record(row.primitive, "cs=" + std::to_string(row.cs_length), row.ops, row.threads,
+                      {row.seconds * 1000.0},
+                      {{"ops_per_sec", row.ops_per_sec}, {"efficiency", row.efficiency},
+                       {"correct", row.correct ? 1.0 : 0.0}});
+    }
+}
+
+} // namespace
 
 // Implementation of the performance analysis function
 void run_performance_analysis(int num_threads, int workload) {
     utils::print_header("OpenMP Synchronization Performance Analysis");
     std::cout << "Running performance analysis with " << num_threads << " threads and workload size " << workload << "\n\n";
-    
+
     // Run various performance tests that are available in the codebase
     benchmark_critical_sections(num_threads, workload);
     demo_locks(num_threads, workload);
-    
+
+    // Every primitive side by side, alone and at the requested thread count
+    if (num_threads <= 0) {
+        num_threads = omp_get_max_threads();
+    }
+    std::vector<int> thread_counts = {1};
+    if (num_threads > 1) {
+        thread_counts.push_back(num_threads);
+    }
+    utils::print_section("Primitive Overhead: 1 vs " + std::to_string(num_threads) + " Threads");
+    print_matrix(run_benchmark_matrix(thread_counts, {0, 100}, std::max(workload, 20000)));
+
     std::cout << "\nPerformance analysis complete.\n";
 }
 
-// Implementation of the benchmarks function
+// Implementation of the benchmarks function: the full primitive matrix, written to
+// sync_benchmark_matrix.csv and .json for comparing machines
 void run_benchmarks(int num_threads, int workload) {
     utils::print_header("OpenMP Synchronization Benchmarks");
-    std::cout << "Running all benchmarks with " << num_threads << " threads and workload size " << workload << "\n\n";
-    
-    // Run all benchmarks that are available in the codebase
-    benchmark_critical_sections(num_threads, workload);
-    demo_simple_locks(num_threads, workload);
-    demo_nested_locks(num_threads, workload);
-    
+    if (num_threads <= 0) {
+        num_threads = omp_get_max_threads();
+    }
+    const long long total_ops = std::max(workload, 20000);
+    const std::vector<int> thread_counts = thread_sweep(num_threads);
+    const std::vector<int> cs_lengths = {0, 100, 1000};
+
+    std::cout << "Benchmark matrix: every primitive x threads {";
+    for (size_t i = 0; i < thread_counts.size(); i++) {
+        std::cout << (i > 0 ? ", " : "") << thread_counts[i];
+    }
+    std::cout << "} x critical-section length {0, 100, 1000} spin rounds\n";
+    std::cout << total_ops << " operations per cell at CS length 0, shared among the threads; scaled by\n";
+    std::cout << "100 / (100 + CS length) for longer sections, and by 1/10 for barrier and ordered\n";
+    std::cout << "Efficiency: ops/sec relative to 1 thread, divided by the thread count\n\n";
+
+    std::vector<MatrixRow> rows = run_benchmark_matrix(thread_counts, cs_lengths, total_ops);
+    print_matrix(rows);
+
+    write_matrix_csv("sync_benchmark_matrix.csv", rows);
+    write_matrix_json("sync_benchmark_matrix.json", rows, num_threads);
+    record_matrix(rows);
+
+    const bool all_correct = std::all_of(rows.begin(), rows.end(), [](const MatrixRow& row) { return row.correct; });
+    std::cout << "\n";
+    utils::print_result("All primitives correct", all_correct ? 1 : 0);
+    std::cout << "Results written to sync_benchmark_matrix.csv and sync_benchmark_matrix.json\n";
+
     std::cout << "\nAll benchmarks complete.\n";
-} 
\ No newline at end of file
+}
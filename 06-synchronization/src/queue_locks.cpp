@@ -0,0 +1,162 @@
+#include "../include/queue_locks.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Spin politely: pause on x86, and give the core away now and then so a waiter
+// does not burn the time slice of the thread it is waiting for
+inline void spin_wait(int& spins) {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#endif
+    if (++spins % 64 == 0) {
+        std::this_thread::yield();
+    }
+}
+
+int queue_capacity(int max_threads) {
+    return max_threads > 0 ? max_threads : omp_get_max_threads();
+}
+
+// Queue node index of the calling thread. A team larger than the lock was sized
+// for would write past the node array, so stop instead of corrupting memory.
+int thread_slot(int capacity) {
+    const int tid = omp_get_thread_num();
+    if (tid >= capacity) {
+        std::cerr << "Queue lock sized for " << capacity << " threads used by thread " << tid << std::endl;
+        std::abort();
+    }
+    return tid;
+}
+
+} // namespace
+
+const char* queue_lock_name(QueueLockKind kind) {
+    switch (kind) {
+        case QueueLockKind::Ticket: return "ticket";
+        case QueueLockKind::MCS: return "MCS";
+        case QueueLockKind::CLH: return "CLH";
+        default: return "omp_lock_t";
+    }
+}
+
+void TicketLock::lock() {
+    const unsigned ticket = next_ticket_.fetch_add(1, std::memory_order_relaxed);
+    int spins = 0;
+    while (now_serving_.load(std::memory_order_acquire) != ticket) {
+        spin_wait(spins);
+    }
+}
+
+void TicketLock::unlock() {
+    // Only the holder writes now_serving_, so a plain increment is enough
+    now_serving_.store(now_serving_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+MCSLock::MCSLock(int max_threads)
+    : capacity_(queue_capacity(max_threads)), nodes_(new Node[capacity_]) {}
+
+void MCSLock::lock() {
+    Node& me = nodes_[thread_slot(capacity_)];
+    me.next.store(nullptr, std::memory_order_relaxed);
+    me.locked.store(true, std::memory_order_relaxed);
+
+    Node* pred = tail_.exchange(&me, std::memory_order_acq_rel);
+    if (pred != nullptr) {
+        pred->next.store(&me, std::memory_order_release);
+        int spins = 0;
+        while (me.locked.load(std::memory_order_acquire)) {
+            spin_wait(spins);
+        }
+    }
+}
+
+void MCSLock::unlock() {
+    Node& me = nodes_[thread_slot(capacity_)];
+    Node* succ = me.next.load(std::memory_order_acquire);
+    if (succ == nullptr) {
+        Node* expected = &me;
+        if (tail_.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel,
+                                          std::memory_order_relaxed)) {
+            return;  // No one waiting
+        }
+        // A thread swapped itself in but has not linked to us yet
+        int spins = 0;
+        while ((succ = me.next.load(std::memory_order_acquire)) == nullptr) {
+            spin_wait(spins);
+        }
+    }
+    succ->locked.store(false, std::memory_order_release);
+}
+
+CLHLock::CLHLock(int max_threads) : capacity_(queue_capacity(max_threads)) {
+    nodes_.reset(new Node[capacity_ + 1]);
+    threads_.reset(new ThreadState[capacity_]);
+    for (int t = 0; t < capacity_; t++) {
+        threads_[t].node = &nodes_[t];
+    }
+    tail_.store(&nodes_[capacity_], std::memory_order_relaxed);  // Unlocked sentinel
+}
+
+void CLHLock::lock() {
+    ThreadState& state = threads_[thread_slot(capacity_)];
+    state.node->locked.store(true, std::memory_order_relaxed);
+    state.pred = tail_.exchange(state.node, std::memory_order_acq_rel);
+    int spins = 0;
+    while (state.pred->locked.load(std::memory_order_acquire)) {
+        spin_wait(spins);
+    }
+}
+
+void CLHLock::unlock() {
+    ThreadState& state = threads_[thread_slot(capacity_)];
+    state.node->locked.store(false, std::memory_order_release);
+    // The successor now spins on our node; the predecessor's node is free to reuse
+    state.node = state.pred;
+}
+
+void queue_lock_init(queue_lock_t* lock, QueueLockKind kind, int max_threads) {
+    lock->kind = kind;
+    lock->impl = nullptr;
+    switch (kind) {
+        case QueueLockKind::Ticket: lock->impl = new TicketLock(); break;
+        case QueueLockKind::MCS: lock->impl = new MCSLock(max_threads); break;
+        case QueueLockKind::CLH: lock->impl = new CLHLock(max_threads); break;
+        default: omp_init_lock(&lock->omp_lock); break;
+    }
+}
+
+void queue_lock_destroy(queue_lock_t* lock) {
+    switch (lock->kind) {
+        case QueueLockKind::Ticket: delete static_cast<TicketLock*>(lock->impl); break;
+        case QueueLockKind::MCS: delete static_cast<MCSLock*>(lock->impl); break;
+        case QueueLockKind::CLH: delete static_cast<CLHLock*>(lock->impl); break;
+        default: omp_destroy_lock(&lock->omp_lock); break;
+    }
+    lock->impl = nullptr;
+}
+
+void queue_lock_set(queue_lock_t* lock) {
+    switch (lock->kind) {
+        case QueueLockKind::Ticket: static_cast<TicketLock*>(lock->impl)->lock(); break;
+        case QueueLockKind::MCS: static_cast<MCSLock*>(lock->impl)->lock(); break;
+        case QueueLockKind::CLH: static_cast<CLHLock*>(lock->impl)->lock(); break;
+        default: omp_set_lock(&lock->omp_lock); break;
+    }
+}
+
+void queue_lock_unset(queue_lock_t* lock) {
+    switch (lock->kind) {
+        case QueueLockKind::Ticket: static_cast<TicketLock*>(lock->impl)->unlock(); break;
+        case QueueLockKind::MCS: static_cast<MCSLock*>(lock->impl)->unlock(); break;
+        case QueueLockKind::CLH: static_cast<CLHLock*>(lock->impl)->unlock(); break;
+        default: omp_unset_lock(&lock->omp_lock); break;
+    }
+}
@@ -0,0 +1,77 @@
+#include "../include/scalable_rw_lock.h"
+
+#include <thread>
+
+ScalableRWLock::ScalableRWLock(int slots)
+    : slot_count_(slots > 0 ? slots : omp_get_max_threads()) {
+    if (slot_count_ < 1) {
+        slot_count_ = 1;
+    }
+    slots_.reset(new ReaderSlot[slot_count_]);
+    omp_init_lock(&writer_lock_);
+}
+
+ScalableRWLock::~ScalableRWLock() {
+    omp_destroy_lock(&writer_lock_);
+}
+
+ScalableRWLock::ReaderSlot& ScalableRWLock::my_slot() {
+    // Slots count readers, so threads that share one (more threads than slots, or
+    // nested teams reusing thread numbers) are still correct, only less scalable
+    return slots_[omp_get_thread_num() % slot_count_];
+}
+
+void ScalableRWLock::read_lock() {
+    ReaderSlot& slot = my_slot();
+    for (;;) {
+        while (writer_pending_.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        // Announce, then re-check: seq_cst on both sides means either the writer
+        // sees this slot or this reader sees the writer's flag
+        slot.active.fetch_add(1, std::memory_order_seq_cst);
+        if (!writer_pending_.load(std::memory_order_seq_cst)) {
+            return;
+        }
+        // A writer arrived; step aside so it is not held up by new readers
+        slot.active.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void ScalableRWLock::read_unlock() {
+    my_slot().active.fetch_sub(1, std::memory_order_release);
+}
+
+void ScalableRWLock::write_lock() {
+    omp_set_lock(&writer_lock_);
+    writer_pending_.store(true, std::memory_order_seq_cst);
+    for (int s = 0; s < slot_count_; s++) {
+        while (slots_[s].active.load(std::memory_order_acquire) != 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void ScalableRWLock::write_unlock() {
+    writer_pending_.store(false, std::memory_order_release);
+    omp_unset_lock(&writer_lock_);
+}
+
+SeqLock::SeqLock() {
+    omp_init_lock(&writer_lock_);
+}
+
+SeqLock::~SeqLock() {
+    omp_destroy_lock(&writer_lock_);
+}
+
+void SeqLock::write_lock() {
+    omp_set_lock(&writer_lock_);
+    sequence_.fetch_add(1, std::memory_order_relaxed);  // Odd: write in progress
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void SeqLock::write_unlock() {
+    sequence_.fetch_add(1, std::memory_order_release);  // Even again
+    omp_unset_lock(&writer_lock_);
+}
@@ -0,0 +1,165 @@
+#include "../include/speculative_lock.h"
+
+#include <thread>
+#include <omp.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SPECULATIVE_LOCK_X86 1
+#include <immintrin.h>
+#ifdef _WIN32
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// GCC and Clang only expose the RTM intrinsics in functions compiled for RTM; the
+// rest of the program stays buildable for CPUs without it
+#if defined(SPECULATIVE_LOCK_X86) && (defined(__GNUC__) || defined(__clang__))
+#define RTM_TARGET __attribute__((target("rtm")))
+#else
+#define RTM_TARGET
+#endif
+
+namespace {
+
+// Explicit abort code used when the fallback lock is seen held inside a transaction
+constexpr unsigned LOCK_BUSY_CODE = 0xff;
+
+// Counters are only read once the threads are done, so no ordering is needed
+inline void count(std::atomic<long long>& counter) {
+    counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+void spin_until_free(const std::atomic<int>& flag) {
+    int spins = 0;
+    while (flag.load(std::memory_order_relaxed) != 0) {
+#ifdef SPECULATIVE_LOCK_X86
+        _mm_pause();
+#endif
+        if (++spins % 64 == 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+} // namespace
+
+bool rtm_supported() {
+#ifdef SPECULATIVE_LOCK_X86
+#ifdef _WIN32
+    int info[4] = {0};
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 11)) != 0;
+#else
+    unsigned int a = 0, b = 0, c = 0, d = 0;
+    if (__get_cpuid_max(0, nullptr) < 7) {
+        return false;
+    }
+    __cpuid_count(7, 0, a, b, c, d);
+    return (b & (1u << 11)) != 0;
+#endif
+#else
+    return false;
+#endif
+}
+
+ElidedLock::ElidedLock(int retry_budget, int max_threads)
+    : retry_budget_(retry_budget > 0 ? retry_budget : 1),
+      capacity_(max_threads > 0 ? max_threads : omp_get_max_threads()),
+      use_rtm_(rtm_supported()),
+      stats_(new ThreadStats[capacity_]) {}
+
+ElidedLock::ThreadStats& ElidedLock::my_stats() {
+    return stats_[omp_get_thread_num() % capacity_];
+}
+
+void ElidedLock::lock_fallback() {
+    for (;;) {
+        spin_until_free(fallback_);
+        int expected = 0;
+        if (fallback_.compare_exchange_weak(expected, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    count(my_stats().fallbacks);
+}
+
+RTM_TARGET void ElidedLock::lock() {
+#ifdef SPECULATIVE_LOCK_X86
+    if (use_rtm_) {
+        ThreadStats& counts = my_stats();
+        for (int attempt = 0; attempt < retry_budget_; attempt++) {
+            const unsigned status = _xbegin();
+            if (status == _XBEGIN_STARTED) {
+                // Reading the lock puts it in the read set: if anyone takes it, we abort
+                if (fallback_.load(std::memory_order_relaxed) == 0) {
+                    return;
+                }
+                _xabort(LOCK_BUSY_CODE);
+            }
+
+            count(counts.aborts);
+            if ((status & _XABORT_EXPLICIT) && _XABORT_CODE(status) == LOCK_BUSY_CODE) {
+                count(counts.abort_lock_busy);
+                spin_until_free(fallback_);  // Retrying while it is held would abort again
+                continue;
+            }
+            if (status & _XABORT_CONFLICT) {
+                count(counts.abort_conflict);
+            } else if (status & _XABORT_CAPACITY) {
+                count(counts.abort_capacity);
+            } else {
+                count(counts.abort_other);
+            }
+            if (!(status & _XABORT_RETRY)) {
+                break;  // The hardware says a retry cannot succeed
+            }
+        }
+    }
+#endif
+    lock_fallback();
+}
+
+RTM_TARGET void ElidedLock::unlock() {
+#ifdef SPECULATIVE_LOCK_X86
+    if (use_rtm_ && _xtest()) {
+        _xend();
+        count(my_stats().commits);
+        return;
+    }
+#endif
+    fallback_.store(0, std::memory_order_release);
+}
+
+SpeculationStats ElidedLock::stats() const {
+    SpeculationStats total;
+    for (int t = 0; t < capacity_; t++) {
+        const ThreadStats& counts = stats_[t];
+        total.commits += counts.commits.load(std::memory_order_relaxed);
+        total.fallbacks += counts.fallbacks.load(std::memory_order_relaxed);
+        total.aborts += counts.aborts.load(std::memory_order_relaxed);
+        total.abort_conflict += counts.abort_conflict.load(std::memory_order_relaxed);
+        total.abort_capacity += counts.abort_capacity.load(std::memory_order_relaxed);
+        total.abort_lock_busy += counts.abort_lock_busy.load(std::memory_order_relaxed);
+        total.abort_other += counts.abort_other.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void ElidedLock::reset_stats() {
+    for (int t = 0; t < capacity_; t++) {
+        ThreadStats& counts = stats_[t];
+        counts.commits.store(0, std::memory_order_relaxed);
+        counts.fallbacks.store(0, std::memory_order_relaxed);
+        counts.aborts.store(0, std::memory_order_relaxed);
+        counts.abort_conflict.store(0, std::memory_order_relaxed);
+        counts.abort_capacity.store(0, std::memory_order_relaxed);
+        counts.abort_lock_busy.store(0, std::memory_order_relaxed);
+        counts.abort_other.store(0, std::memory_order_relaxed);
+    }
+}
@@ -6,73 +6,219 @@
 #include <omp.h>
 #include <chrono>
 #include <thread>
+#include <cstdint>
 #include "../include/synchronization_demos.h"
 #include "../include/utils.h"
 
-// Structure to track thread activity
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TIMELINE_X86 1
+#ifdef _WIN32
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#include <cpuid.h>
+#endif
+#endif
+
+namespace {
+
+// Timestamp source for the timeline: the TSC when it is invariant (constant rate,
+// not stopped in sleep states), otherwise steady_clock in nanoseconds. Reading it
+// costs a few nanoseconds, against the hundreds omp_get_wtime plus a critical
+// section cost in the old recorder.
+class TickClock {
+public:
+    TickClock() : use_tsc_(invariant_tsc()) {
+        // Calibrate ticks per second against steady_clock
+        auto wall_start = std::chrono::steady_clock::now();
+        uint64_t tick_start = now();
+        while (std::chrono::steady_clock::now() - wall_start < std::chrono::milliseconds(20)) {
+        }
+        auto wall_end = std::chrono::steady_clock::now();
+        uint64_t tick_end = now();
+        double seconds = std::chrono::duration<double>(wall_end - wall_start).count();
+        ticks_per_second_ = static_cast<double>(tick_end - tick_start) / seconds;
+    }
+
+    uint64_t now() const {
+#ifdef TIMELINE_X86
+        if (use_tsc_) {
+            return __rdtsc();
+        }
+#endif
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    double to_seconds(uint64_t ticks) const { return static_cast<double>(ticks) / ticks_per_second_; }
+    const char* name() const { return use_tsc_ ? "invariant TSC" : "steady_clock"; }
+
+private:
+    static bool invariant_tsc() {
+#ifdef TIMELINE_X86
+#ifdef _WIN32
+        int info[4] = {0};
+        __cpuid(info, 0x80000000);
+        if (static_cast<unsigned>(info[0]) < 0x80000007u) {
+            return false;
+        }
+        __cpuid(info, 0x80000007);
+        return (info[3] & (1 << 8)) != 0;
+#else
+        unsigned int a = 0, b = 0, c = 0, d = 0;
+        if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007u) {
+            return false;
+        }
+        __cpuid(0x80000007, a, b, c, d);
+        return (d & (1u << 8)) != 0;
+#endif
+#else
+        return false;
+#endif
+    }
+
+    bool use_tsc_;
+    double ticks_per_second_ = 1e9;
+};
+
+enum class EventType : uint8_t { Work, Barrier, Critical, Wait, Idle };
+
+const char* event_type_name(EventType type) {
+    switch (type) {
+        case EventType::Work: return "work";
+        case EventType::Barrier: return "barrier";
+        case EventType::Critical: return "critical";
+        case EventType::Wait: return "wait";
+        case EventType::Idle: return "idle";
+    }
+    return "?";
+}
+
+char event_symbol(EventType type) {
+    switch (type) {
+        case EventType::Work: return '#';
+        case EventType::Barrier: return '|';
+        case EventType::Critical: return 'C';
+        case EventType::Wait: return '-';
+        case EventType::Idle: return '.';
+    }
+    return '?';
+}
+
+// One recorded interval. The description is a string literal plus an optional
+// number (e.g. "Processing item" 3), so recording never allocates.
 struct ThreadEvent {
-    double start_time;
-    double end_time;
-    std::string event_type;
+    uint64_t start_ticks;
+    uint64_t end_ticks;  // 0 while the event is open
+    const char* description;
+    int arg;             // Appended to the description when >= 0
+    EventType type;
     int thread_id;
-    std::string description;
 };
 
-// Visualization class for thread timelines
+} // namespace
+
+// Visualization class for thread timelines. Each thread records into its own
+// preallocated ring, so add_event/end_event take no lock and share no cache line;
+// the rings are only merged in display(). When a ring fills up, the oldest events
+// are overwritten and counted as dropped.
 class ThreadTimelineVisualizer {
 private:
-    std::vector<ThreadEvent> events;
-    double start_time;
+    struct alignas(64) ThreadLog {
+        std::vector<ThreadEvent> ring;
+        size_t count = 0;  // Events ever recorded; ring index is count % capacity
+    };
+    
+    TickClock clock;
+    uint64_t start_ticks;
     int num_threads;
+    size_t capacity;
+    std::vector<ThreadLog> logs;
     
 public:
-    ThreadTimelineVisualizer(int num_threads) : num_threads(num_threads) {
+    ThreadTimelineVisualizer(int num_threads, size_t events_per_thread = 1024)
+        : num_threads(num_threads), capacity(std::max<size_t>(events_per_thread, 1)), logs(num_threads) {
+        for (auto& log : logs) {
+            log.ring.resize(capacity);
+        }
         // Record start time
-        start_time = omp_get_wtime();
+        start_ticks = clock.now();
     }
     
-    // Add a thread event
-    void add_event(int thread_id, const std::string& event_type, const std::string& description = "") {
-        ThreadEvent event;
-        event.start_time = omp_get_wtime() - start_time;
-        event.end_time = 0; // Will be set when event ends
-        event.thread_id = thread_id;
-        event.event_type = event_type;
-        event.description = description;
-        
-        #pragma omp critical(timeline_update)
-        {
-            events.push_back(event);
+    // Add a thread event; only the owning thread may record for thread_id
+    void add_event(int thread_id, EventType type, const char* description = "", int arg = -1) {
+        if (thread_id < 0 || thread_id >= num_threads) {
+            return;
         }
+        ThreadLog& log = logs[thread_id];
+        ThreadEvent& event = log.ring[log.count % capacity];
+        event.start_ticks = clock.now();
+        event.end_ticks = 0; // Will be set when event ends
+        event.description = description;
+        event.arg = arg;
+        event.type = type;
+        event.thread_id = thread_id;
+        log.count++;
     }
     
-    // End the last event for a thread
+    // End the last open event for a thread
     void end_event(int thread_id) {
-        double end_time = omp_get_wtime() - start_time;
-        
-        #pragma omp critical(timeline_update)
-        {
-            // Find the last event for this thread
-            for (int i = static_cast<int>(events.size()) - 1; i >= 0; i--) {
-                if (events[i].thread_id == thread_id && events[i].end_time == 0) {
-                    events[i].end_time = end_time;
-                    break;
-                }
+        uint64_t end_ticks = clock.now();
+        if (thread_id < 0 || thread_id >= num_threads) {
+            return;
+        }
+        ThreadLog& log = logs[thread_id];
+        size_t oldest = log.count > capacity ? log.count - capacity : 0;
+        for (size_t i = log.count; i > oldest; i--) {
+            ThreadEvent& event = log.ring[(i - 1) % capacity];
+            if (event.end_ticks == 0) {
+                event.end_ticks = end_ticks;
+                break;
             }
         }
     }
     
+    // Average cost of one add_event/end_event pair on the calling thread, in ns
+    static double measure_overhead_ns(int pairs = 100000) {
+        ThreadTimelineVisualizer probe(1, 256);
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < pairs; i++) {
+            probe.add_event(0, EventType::Work, "probe", i);
+            probe.end_event(0);
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - begin).count() / pairs;
+    }
+    
+    const char* clock_name() const { return clock.name(); }
+    
     // Display the timeline in the console
     void display() {
-        // Sort events by start time
+        // Merge the per-thread rings and sort events by start time
+        std::vector<ThreadEvent> events;
+        size_t dropped = 0;
+        for (const auto& log : logs) {
+            size_t kept = std::min(log.count, capacity);
+            dropped += log.count - kept;
+            for (size_t i = log.count - kept; i < log.count; i++) {
+                events.push_back(log.ring[i % capacity]);
+            }
+        }
         std::sort(events.begin(), events.end(), [](const ThreadEvent& a, const ThreadEvent& b) {
-            return a.start_time < b.start_time;
+            return a.start_ticks < b.start_ticks;
         });
         
+        auto seconds_since_start = [this](uint64_t ticks) {
+            return ticks > start_ticks ? clock.to_seconds(ticks - start_ticks) : 0.0;
+        };
+        
         // Find the total time span
         double max_time = 0;
         for (const auto& event : events) {
-            max_time = std::max(max_time, event.end_time);
+            max_time = std::max(max_time, seconds_since_start(event.end_ticks));
+        }
+        if (max_time <= 0) {
+            max_time = 1e-9;
         }
         
         // Set the width of the timeline display
@@ -91,9 +237,9 @@ public:
             // Add events for this thread to the timeline
             for (const auto& event : events) {
                 if (event.thread_id == t) {
-                    int start_pos = static_cast<int>((event.start_time / max_time) * 
+                    int start_pos = static_cast<int>((seconds_since_start(event.start_ticks) / max_time) * 
                                                    (timeline_width - label_width));
-                    int end_pos = static_cast<int>((event.end_time / max_time) * 
+                    int end_pos = static_cast<int>((seconds_since_start(event.end_ticks) / max_time) * 
                                                  (timeline_width - label_width));
                     
                     // Ensure valid positions
@@ -103,13 +249,7 @@ public:
                                       static_cast<int>(timeline.size()));
                     
                     // Fill the timeline with a symbol based on event type
-                    char symbol = '?';
-                    if (event.event_type == "work") symbol = '#';
-                    else if (event.event_type == "barrier") symbol = '|';
-                    else if (event.event_type == "critical") symbol = 'C';
-                    else if (event.event_type == "wait") symbol = '-';
-                    else if (event.event_type == "idle") symbol = '.';
-                    
+                    char symbol = event_symbol(event.type);
                     for (int i = start_pos; i < end_pos; i++) {
                         timeline[i] = symbol;
                     }
@@ -135,19 +275,31 @@ public:
                   << "  " << "Type" << " - Description\n";
         
         for (const auto& event : events) {
-            double duration = event.end_time - event.start_time;
+            double start = seconds_since_start(event.start_ticks);
+            double end = seconds_since_start(event.end_ticks);
             std::cout << std::setw(5) << event.thread_id 
-                      << std::setw(10) << std::fixed << std::setprecision(4) << event.start_time 
-                      << std::setw(10) << std::fixed << std::setprecision(4) << event.end_time 
-                      << std::setw(10) << std::fixed << std::setprecision(4) << duration 
-                      << "  " << event.event_type;
+                      << std::setw(10) << std::fixed << std::setprecision(4) << start 
+                      << std::setw(10) << std::fixed << std::setprecision(4) << end 
+                      << std::setw(10) << std::fixed << std::setprecision(4) << (end - start) 
+                      << "  " << event_type_name(event.type);
             
-            if (!event.description.empty()) {
+            if (event.description[0] != '\0') {
                 std::cout << " - " << event.description;
+                if (event.arg >= 0) {
+                    std::cout << " " << event.arg;
+                }
             }
             
             std::cout << std::endl;
         }
+        
+        std::cout << "\nRecorder: " << clock.name() << ", per-thread rings of " << capacity << " events";
+        if (dropped > 0) {
+            std::cout << " (" << dropped << " oldest events dropped)";
+        }
+        std::cout << "\n";
+        std::cout << "Instrumentation overhead: " << std::setprecision(1) << measure_overhead_ns()
+                  << " ns per add_event/end_event pair\n";
     }
 };
 
@@ -185,7 +337,7 @@ void visualize_thread_timeline(int num_threads, int workload) {
         // Each thread processes items
         for (int i = 0; i < reduced_workload; i++) {
             // Start work event
-            visualizer.add_event(tid, "work", "Processing item " + std::to_string(i));
+            visualizer.add_event(tid, EventType::Work, "Processing item", i);
             
             // Simulate some processing
             std::this_thread::sleep_for(std::chrono::milliseconds(20 + tid * 5));
@@ -194,7 +346,7 @@ void visualize_thread_timeline(int num_threads, int workload) {
             visualizer.end_event(tid);
             
             // Enter critical section
-            visualizer.add_event(tid, "critical", "Updating counter");
+            visualizer.add_event(tid, EventType::Critical, "Updating counter");
             
             #pragma omp critical
             {
@@ -219,7 +371,7 @@ void visualize_thread_timeline(int num_threads, int workload) {
         // Each thread processes items
         for (int i = 0; i < reduced_workload; i++) {
             // Start work event
-            visualizer.add_event(tid, "work", "Processing item " + std::to_string(i));
+            visualizer.add_event(tid, EventType::Work, "Processing item", i);
             
             // Simulate some processing (same as before)
             std::this_thread::sleep_for(std::chrono::milliseconds(20 + tid * 5));
@@ -228,7 +380,7 @@ void visualize_thread_timeline(int num_threads, int workload) {
             visualizer.end_event(tid);
             
             // Atomic operation is much faster
-            visualizer.add_event(tid, "critical", "Atomic update");
+            visualizer.add_event(tid, EventType::Critical, "Atomic update");
             
             #pragma omp atomic
             counter_atomic++;
@@ -252,7 +404,7 @@ void visualize_thread_timeline(int num_threads, int workload) {
         int tid = omp_get_thread_num();
         
         // First phase
-        visualizer.add_event(tid, "work", "Phase 1 work");
+        visualizer.add_event(tid, EventType::Work, "Phase 1 work");
         
         // Threads take varying time to complete phase 1
         std::this_thread::sleep_for(std::chrono::milliseconds(100 + tid * 50));
@@ -260,14 +412,14 @@ void visualize_thread_timeline(int num_threads, int workload) {
         visualizer.end_event(tid);
         
         // Barrier wait
-        visualizer.add_event(tid, "barrier", "Waiting at barrier 1");
+        visualizer.add_event(tid, EventType::Barrier, "Waiting at barrier 1");
         
         #pragma omp barrier
         
         visualizer.end_event(tid);
         
         // Second phase
-        visualizer.add_event(tid, "work", "Phase 2 work");
+        visualizer.add_event(tid, EventType::Work, "Phase 2 work");
         
         // Reverse the timing pattern for phase 2
         std::this_thread::sleep_for(std::chrono::milliseconds(100 + (num_threads - tid) * 50));
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <chrono>
@@ -13,25 +14,20 @@
 
 namespace utils {
     // Timer implementation
-    Timer::Timer() : running(false) {}
+    Timer::Timer() {}
     
     void Timer::start() {
-        start_time = std::chrono::high_resolution_clock::now();
-        running = true;
+        timer.start();
     }
     
     void Timer::stop() {
-        if (running) {
-            end_time = std::chrono::high_resolution_clock::now();
-            running = false;
+        if (timer.isRunning()) {
+            timer.stop();
         }
     }
     
     double Timer::elapsed_ms() const {
-        auto duration = (running ? 
-            std::chrono::high_resolution_clock::now() - start_time : 
-            end_time - start_time);
-        return std::chrono::duration_cast<std::chrono::microseconds>(duration).count() / 1000.0;
+        return timer.elapsedMilliseconds();
     }
     
     double Timer::elapsed_seconds() const {
@@ -39,11 +35,11 @@ namespace utils {
     }
     
     void Timer::reset() {
-        running = false;
+        timer.reset();
     }
     
     bool Timer::is_running() const {
-        return running;
+        return timer.isRunning();
     }
     
     // Benchmark function
@@ -53,15 +49,7 @@ namespace utils {
         }
         
         std::vector<double> times;
-        Timer timer;
-        
-        for (int i = 0; i < num_runs; ++i) {
-            timer.reset();
-            timer.start();
-            func();
-            timer.stop();
-            times.push_back(timer.elapsed_ms());
-        }
+        bench::measure(func, bench::RunPolicy::repetitions(num_runs), &times);
         
         // Calculate average (excluding outliers if enough samples)
         if (times.size() <= 2) {
@@ -273,6 +261,46 @@ namespace utils {
         file.close();
     }
     
+    void write_results_to_file(const std::string& filename, 
+                              const std::vector<LatencySummary>& rows) {
+        std::ofstream file(filename);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open file " << filename << " for writing.\n";
+            return;
+        }
+        
+        file << "# OpenMP Synchronization Latency Percentiles\n";
+        file << "# Format: Benchmark_Name,Count,Mean_ns,P50_ns,P99_ns,P99_9_ns,Max_ns\n\n";
+        
+        file << std::fixed << std::setprecision(1);
+        for (const auto& row : rows) {
+            file << row.label << "," << row.count << "," << row.mean_ns << "," << row.p50_ns << ","
+                 << row.p99_ns << "," << row.p999_ns << "," << row.max_ns << "\n";
+        }
+        
+        file.close();
+    }
+    
+    // Percentile table
+    void print_percentile_table(const std::vector<LatencySummary>& rows) {
+        size_t label_width = 10;
+        for (const auto& row : rows) {
+            label_width = std::max(label_width, row.label.size() + 2);
+        }
+        
+        std::cout << std::left << std::setw(static_cast<int>(label_width)) << "Latency (ns)" << std::right
+                  << std::setw(10) << "Count" << std::setw(10) << "Mean" << std::setw(10) << "p50"
+                  << std::setw(10) << "p99" << std::setw(10) << "p99.9" << std::setw(12) << "Max" << "\n";
+        std::cout << std::string(label_width + 62, '-') << "\n";
+        std::cout << std::fixed << std::setprecision(0);
+        for (const auto& row : rows) {
+            std::cout << std::left << std::setw(static_cast<int>(label_width)) << row.label << std::right
+                      << std::setw(10) << row.count << std::setw(10) << row.mean_ns
+                      << std::setw(10) << row.p50_ns << std::setw(10) << row.p99_ns
+                      << std::setw(10) << row.p999_ns << std::setw(12) << row.max_ns << "\n";
+        }
+    }
+    
     // Race condition detection
     bool detect_race_condition(std::function<void(int)> test_func, int iterations) {
         const int test_runs = 5;
@@ -301,24 +329,26 @@ namespace utils {
                        int width, int height) {
         // Find max value for scaling
         double max_value = 0.0;
+        size_t label_width = 0;
         for (const auto& pair : data) {
             max_value = std::max(max_value, pair.second);
+            label_width = std::max(label_width, pair.first.size());
+        }
+        if (max_value <= 0.0) {
+            return;
         }
         
-        // Use width parameter for bar width calculation
-        int bar_width = width / std::max(1, static_cast<int>(data.size()));
-        
-        // Use height parameter for vertical scaling
-        int max_bar_height = height;
-        
-        // Display the chart
+        // Display the chart, one row per entry up to `height` rows
+        int rows = 0;
         for (const auto& pair : data) {
-            // Calculate bar length proportional to value and height
-            int bar_length = static_cast<int>((pair.second / max_value) * bar_width);
-            int bar_height = static_cast<int>((pair.second / max_value) * max_bar_height);
-            
-            // Use both parameters to avoid unused warnings
-            (void)bar_height;
+            if (height > 0 && rows++ >= height) {
+                std::cout << "  ... " << (data.size() - height) << " more\n";
+                break;
+            }
+            int bar_length = static_cast<int>((std::max(pair.second, 0.0) / max_value) * width + 0.5);
+            std::cout << "  " << std::left << std::setw(static_cast<int>(label_width)) << pair.first
+                      << std::right << " |" << std::string(bar_length, '#')
+                      << " " << std::fixed << std::setprecision(3) << pair.second << "\n";
         }
     }
     
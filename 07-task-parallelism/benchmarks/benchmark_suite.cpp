@@ -13,6 +13,109 @@
 #include <numeric>
 #include <omp.h>
 #include "../include/task_utils.h"
+#include "../include/parallel_sort.h"
+#include "../include/blocked_gemm.h"
+
+//==============================================================================
+// Timing statistics
+//==============================================================================
+
+// Two-sided 95% critical value of Student's t distribution
+inline double t_critical_95(int degrees_of_freedom) {
+    static const double table[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    if (degrees_of_freedom < 1) return 0.0;
+    if (degrees_of_freedom <= 30) return table[degrees_of_freedom - 1];
+    if (degrees_of_freedom <= 40) return 2.021;
+    if (degrees_of_freedom <= 60) return 2.000;
+    if (degrees_of_freedom <= 120) return 1.980;
+    return 1.960;
+}
+
+// Summary of repeated timings of one configuration
+struct TimingStats {
+    int samples = 0;
+    double mean = 0.0;
+    double median = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    double stddev = 0.0;     // sample standard deviation
+    double ci95_low = 0.0;   // 95% confidence interval of the mean
+    double ci95_high = 0.0;
+    std::vector<double> times;   // the samples, in run order
+    
+    static TimingStats from_samples(std::vector<double> times) {
+        TimingStats stats;
+        stats.times = times;
+        stats.samples = static_cast<int>(times.size());
+        if (times.empty()) return stats;
+        
+        std::sort(times.begin(), times.end());
+        size_t n = times.size();
+        stats.min = times.front();
+        stats.max = times.back();
+        stats.median = (n % 2 == 1) ? times[n / 2] : 0.5 * (times[n / 2 - 1] + times[n / 2]);
+        stats.mean = std::accumulate(times.begin(), times.end(), 0.0) / n;
+        
+        if (n > 1) {
+            double sum_sq = 0.0;
+            for (double t : times) {
+                sum_sq += (t - stats.mean) * (t - stats.mean);
+            }
+            stats.stddev = std::sqrt(sum_sq / (n - 1));
+        }
+        
+        double half_width = t_critical_95(static_cast<int>(n) - 1) * stats.stddev / std::sqrt(static_cast<double>(n));
+        stats.ci95_low = stats.mean - half_width;
+        stats.ci95_high = stats.mean + half_width;
+        return stats;
+    }
+};
+
+// Outcome of comparing a result against the baseline run
+enum class BaselineVerdict {
+    NoBaseline,      // configuration not present in the baseline
+    Inconclusive,    // fewer than two samples on one side
+    NotSignificant,
+    Faster,
+    Slower
+};
+
+// Welch's t-test on the two means (unequal variances); significant at 95%
+inline BaselineVerdict compare_to_baseline(const TimingStats& current, const TimingStats& baseline) {
+    if (current.samples < 2 || baseline.samples < 2) return BaselineVerdict::Inconclusive;
+    
+    double var_current = current.stddev * current.stddev / current.samples;
+    double var_baseline = baseline.stddev * baseline.stddev / baseline.samples;
+    double standard_error = std::sqrt(var_current + var_baseline);
+    
+    if (standard_error == 0.0) {
+        if (current.mean == baseline.mean) return BaselineVerdict::NotSignificant;
+        return current.mean < baseline.mean ? BaselineVerdict::Faster : BaselineVerdict::Slower;
+    }
+    
+    // Welch-Satterthwaite degrees of freedom
+    double df = (var_current + var_baseline) * (var_current + var_baseline) /
+                (var_current * var_current / (current.samples - 1) +
+                 var_baseline * var_baseline / (baseline.samples - 1));
+    double t = (current.mean - baseline.mean) / standard_error;
+    
+    if (std::fabs(t) < t_critical_95(static_cast<int>(df))) return BaselineVerdict::NotSignificant;
+    return t < 0.0 ? BaselineVerdict::Faster : BaselineVerdict::Slower;
+}
+
+inline const char* verdict_name(BaselineVerdict verdict) {
+    switch (verdict) {
+        case BaselineVerdict::NoBaseline: return "no baseline";
+        case BaselineVerdict::Inconclusive: return "inconclusive";
+        case BaselineVerdict::NotSignificant: return "no change";
+        case BaselineVerdict::Faster: return "FASTER";
+        case BaselineVerdict::Slower: return "SLOWER";
+    }
+    return "unknown";
+}
 
 // Structure to store benchmark results
 struct BenchmarkResult {
@@ -21,15 +124,30 @@ struct BenchmarkResult {
     int problem_size;
     int num_threads;
     int task_granularity;
-    double execution_time;
+    double execution_time;   // median when repeated
     double speedup;
     double efficiency;
+    TimingStats stats;
+    double gflops = 0.0;     // floating-point throughput, 0 where not meaningful
     
     // Constructor with all parameters
     BenchmarkResult(const std::string& alg, const std::string& impl, int size, int threads, 
                    int grain, double time, double up, double eff)
         : algorithm(alg), implementation(impl), problem_size(size), num_threads(threads),
-          task_granularity(grain), execution_time(time), speedup(up), efficiency(eff) {}
+          task_granularity(grain), execution_time(time), speedup(up), efficiency(eff),
+          stats(TimingStats::from_samples({time})) {}
+    
+    BenchmarkResult(const std::string& alg, const std::string& impl, int size, int threads, 
+                   int grain, const TimingStats& timing, double up, double eff, double throughput = 0.0)
+        : algorithm(alg), implementation(impl), problem_size(size), num_threads(threads),
+          task_granularity(grain), execution_time(timing.median), speedup(up), efficiency(eff),
+          stats(timing), gflops(throughput) {}
+    
+    // Identity used to match against a baseline
+    std::string key() const {
+        return algorithm + "|" + implementation + "|" + std::to_string(problem_size) + "|" +
+               std::to_string(num_threads) + "|" + std::to_string(task_granularity);
+    }
 };
 
 // Class to manage benchmark results
@@ -37,6 +155,28 @@ class BenchmarkManager {
 private:
     std::vector<BenchmarkResult> results;
     std::string results_dir;
+    int warmup_runs = 0;
+    int repetitions = 1;
+    std::map<std::string, TimingStats> baseline;
+    
+    // Value of "field": in a single-line JSON object written by save_to_json
+    static bool json_field(const std::string& line, const std::string& field, std::string& value) {
+        std::string pattern = "\"" + field + "\":";
+        size_t pos = line.find(pattern);
+        if (pos == std::string::npos) return false;
+        pos += pattern.size();
+        while (pos < line.size() && line[pos] == ' ') pos++;
+        
+        if (pos < line.size() && line[pos] == '"') {
+            size_t end = line.find('"', pos + 1);
+            if (end == std::string::npos) return false;
+            value = line.substr(pos + 1, end - pos - 1);
+        } else {
+            size_t end = line.find_first_of(",}", pos);
+            value = line.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+        }
+        return true;
+    }
     
 public:
     BenchmarkManager(const std::string& dir = "benchmark_results") : results_dir(dir) {
@@ -44,15 +184,65 @@ public:
         std::filesystem::create_directory(results_dir);
     }
     
+    // Untimed warmup runs and timed repetitions for every configuration
+    void set_repetitions(int warmups, int reps) {
+        warmup_runs = std::max(0, warmups);
+        repetitions = std::max(1, reps);
+    }
+    
+    int get_repetitions() const {
+        return repetitions;
+    }
+    
+    // Time body() warmup_runs + repetitions times; setup() runs untimed before
+    // each run (e.g. to restore the unsorted input of an in-place sort)
+    TimingStats measure(const std::function<void()>& body,
+                        const std::function<void()>& setup = nullptr) const {
+        for (int i = 0; i < warmup_runs; ++i) {
+            if (setup) setup();
+            body();
+        }
+        
+        std::vector<double> times;
+        times.reserve(repetitions);
+        for (int i = 0; i < repetitions; ++i) {
+            if (setup) setup();
+            times.push_back(task_utils::measure_time(body));
+        }
+        return TimingStats::from_samples(times);
+    }
+    
+    // Also appended to the shared results file when BENCH_RESULTS is set
     void add_result(const BenchmarkResult& result) {
         results.push_back(result);
+        
+        std::vector<double> samples_ms;
+        for (double t : result.stats.times) {
+            samples_ms.push_back(t * 1000.0);
+        }
+        std::string variant = result.implementation;
+        if (result.task_granularity > 0) {
+            variant += " (grain " + std::to_string(result.task_granularity) + ")";
+        }
+        std::map<std::string, double> counters = {{"speedup", result.speedup}, {"efficiency_pct", result.efficiency}};
+        if (result.gflops > 0.0) {
+            counters["GFLOP_per_s"] = result.gflops;
+        }
+        bench::record(result.algorithm, variant, result.problem_size, result.num_threads, samples_ms, counters);
     }
     
     void add_result(const std::string& algorithm, const std::string& implementation, 
                    int problem_size, int num_threads, int task_granularity,
                    double execution_time, double speedup, double efficiency) {
-        results.emplace_back(algorithm, implementation, problem_size, num_threads,
-                            task_granularity, execution_time, speedup, efficiency);
+        add_result(BenchmarkResult(algorithm, implementation, problem_size, num_threads,
+                                   task_granularity, execution_time, speedup, efficiency));
+    }
+    
+    void add_result(const std::string& algorithm, const std::string& implementation, 
+                   int problem_size, int num_threads, int task_granularity,
+                   const TimingStats& timing, double speedup, double efficiency, double gflops = 0.0) {
+        add_result(BenchmarkResult(algorithm, implementation, problem_size, num_threads,
+                                   task_granularity, timing, speedup, efficiency, gflops));
     }
     
     void print_results() const {
@@ -73,6 +263,53 @@ public:
         }
         
         std::cout << "------------------------------------------------------------------------------------" << std::endl;
+        
+        if (repetitions > 1) {
+            print_statistics();
+        }
+        print_throughput();
+    }
+    
+    // GFLOP/s of the results that report it (matrix multiply)
+    void print_throughput() const {
+        bool any = std::any_of(results.begin(), results.end(),
+                               [](const BenchmarkResult& r) { return r.gflops > 0.0; });
+        if (!any) return;
+        
+        std::cout << "\nFloating-Point Throughput:" << std::endl;
+        std::cout << "------------------------------------------------------------------------" << std::endl;
+        std::cout << "Algorithm       | Implementation | Size    | Threads | Time (s) | GFLOP/s" << std::endl;
+        std::cout << "------------------------------------------------------------------------" << std::endl;
+        
+        for (const auto& result : results) {
+            if (result.gflops <= 0.0) continue;
+            std::cout << std::setw(15) << std::left << result.algorithm << " | "
+                      << std::setw(14) << std::left << result.implementation << " | "
+                      << std::setw(8) << std::right << result.problem_size << " | "
+                      << std::setw(7) << std::right << result.num_threads << " | "
+                      << std::fixed << std::setprecision(4) << std::setw(8) << result.execution_time << " | "
+                      << std::fixed << std::setprecision(2) << std::setw(7) << result.gflops << std::endl;
+        }
+    }
+    
+    // Spread of the repeated timings behind each median
+    void print_statistics() const {
+        std::cout << "\nTiming Statistics (" << warmup_runs << " warmup, " << repetitions << " timed runs):" << std::endl;
+        std::cout << "-----------------------------------------------------------------------------------------------------------" << std::endl;
+        std::cout << "Algorithm       | Implementation | Size    | Threads | Granularity | Median   | Min      | Stddev   | 95% CI" << std::endl;
+        std::cout << "-----------------------------------------------------------------------------------------------------------" << std::endl;
+        
+        for (const auto& result : results) {
+            std::cout << std::setw(15) << std::left << result.algorithm << " | "
+                      << std::setw(14) << std::left << result.implementation << " | "
+                      << std::setw(8) << std::right << result.problem_size << " | "
+                      << std::setw(7) << std::right << result.num_threads << " | "
+                      << std::setw(11) << std::right << result.task_granularity << " | "
+                      << std::fixed << std::setprecision(4) << std::setw(8) << result.stats.median << " | "
+                      << std::setw(8) << result.stats.min << " | "
+                      << std::setw(8) << result.stats.stddev << " | ["
+                      << result.stats.ci95_low << ", " << result.stats.ci95_high << "]" << std::endl;
+        }
     }
     
     void save_to_csv(const std::string& filename) const {
@@ -85,7 +322,8 @@ public:
         }
         
         // Write header
-        file << "Algorithm,Implementation,ProblemSize,NumThreads,TaskGranularity,Time,Speedup,Efficiency\n";
+        file << "Algorithm,Implementation,ProblemSize,NumThreads,TaskGranularity,Time,Speedup,Efficiency,"
+             << "Samples,Mean,Min,Max,Stddev,CI95Low,CI95High,GFLOPS\n";
         
         // Write data
         for (const auto& result : results) {
@@ -96,13 +334,145 @@ public:
                  << result.task_granularity << ","
                  << std::fixed << std::setprecision(6) << result.execution_time << ","
                  << std::fixed << std::setprecision(4) << result.speedup << ","
-                 << std::fixed << std::setprecision(4) << result.efficiency << "\n";
+                 << std::fixed << std::setprecision(4) << result.efficiency << ","
+                 << result.stats.samples << ","
+                 << std::fixed << std::setprecision(6) << result.stats.mean << ","
+                 << result.stats.min << ","
+                 << result.stats.max << ","
+                 << result.stats.stddev << ","
+                 << result.stats.ci95_low << ","
+                 << result.stats.ci95_high << ","
+                 << std::fixed << std::setprecision(3) << result.gflops << "\n";
+        }
+        
+        file.close();
+        std::cout << "Results saved to " << filepath << std::endl;
+    }
+    
+    // One result object per line, so load_baseline can read the file back
+    // without a JSON library
+    void save_to_json(const std::string& filename) const {
+        std::string filepath = results_dir + "/" + filename;
+        std::ofstream file(filepath);
+        
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open file " << filepath << " for writing." << std::endl;
+            return;
+        }
+        
+        file << "{\n  \"warmup_runs\": " << warmup_runs << ",\n  \"repetitions\": " << repetitions
+             << ",\n  \"results\": [\n";
+        
+        for (size_t i = 0; i < results.size(); ++i) {
+            const auto& result = results[i];
+            file << "    {\"algorithm\": \"" << result.algorithm << "\""
+                 << ", \"implementation\": \"" << result.implementation << "\""
+                 << ", \"problem_size\": " << result.problem_size
+                 << ", \"num_threads\": " << result.num_threads
+                 << ", \"task_granularity\": " << result.task_granularity
+                 << std::fixed << std::setprecision(9)
+                 << ", \"median\": " << result.stats.median
+                 << ", \"mean\": " << result.stats.mean
+                 << ", \"min\": " << result.stats.min
+                 << ", \"max\": " << result.stats.max
+                 << ", \"stddev\": " << result.stats.stddev
+                 << ", \"ci95_low\": " << result.stats.ci95_low
+                 << ", \"ci95_high\": " << result.stats.ci95_high
+                 << ", \"samples\": " << result.stats.samples
+                 << std::setprecision(4)
+                 << ", \"speedup\": " << result.speedup
+                 << ", \"efficiency\": " << result.efficiency
+                 << ", \"gflops\": " << result.gflops << "}"
+                 << (i + 1 < results.size() ? "," : "") << "\n";
         }
         
+        file << "  ]\n}\n";
         file.close();
         std::cout << "Results saved to " << filepath << std::endl;
     }
     
+    // Load a file written by save_to_json as the comparison baseline
+    bool load_baseline(const std::string& filepath) {
+        std::ifstream file(filepath);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open baseline file " << filepath << std::endl;
+            return false;
+        }
+        
+        baseline.clear();
+        std::string line;
+        while (std::getline(file, line)) {
+            std::string algorithm, implementation, size, threads, grain, mean, stddev, samples, median;
+            if (!json_field(line, "algorithm", algorithm) ||
+                !json_field(line, "implementation", implementation) ||
+                !json_field(line, "problem_size", size) ||
+                !json_field(line, "num_threads", threads) ||
+                !json_field(line, "task_granularity", grain) ||
+                !json_field(line, "mean", mean) ||
+                !json_field(line, "stddev", stddev) ||
+                !json_field(line, "samples", samples)) {
+                continue;  // Not a result line
+            }
+            
+            try {
+                BenchmarkResult entry(algorithm, implementation, std::stoi(size), std::stoi(threads),
+                                      std::stoi(grain), std::stod(mean), 0.0, 0.0);
+                entry.stats.mean = std::stod(mean);
+                entry.stats.stddev = std::stod(stddev);
+                entry.stats.samples = std::stoi(samples);
+                if (json_field(line, "median", median)) {
+                    entry.stats.median = std::stod(median);
+                }
+                baseline[entry.key()] = entry.stats;
+            } catch (const std::exception&) {
+                std::cerr << "Error: Malformed baseline entry: " << line << std::endl;
+            }
+        }
+        
+        std::cout << "Loaded " << baseline.size() << " baseline results from " << filepath << std::endl;
+        return !baseline.empty();
+    }
+    
+    // Flag statistically significant changes against the loaded baseline
+    void print_baseline_comparison() const {
+        if (baseline.empty()) return;
+        
+        std::cout << "\nComparison Against Baseline (Welch's t-test, 95%):" << std::endl;
+        std::cout << "-------------------------------------------------------------------------------------------------------" << std::endl;
+        std::cout << "Algorithm       | Implementation | Size    | Threads | Granularity | Baseline | Current  | Change  | Verdict" << std::endl;
+        std::cout << "-------------------------------------------------------------------------------------------------------" << std::endl;
+        
+        int faster = 0, slower = 0;
+        for (const auto& result : results) {
+            auto it = baseline.find(result.key());
+            BaselineVerdict verdict = (it == baseline.end()) ? BaselineVerdict::NoBaseline
+                                                             : compare_to_baseline(result.stats, it->second);
+            if (verdict == BaselineVerdict::Faster) faster++;
+            if (verdict == BaselineVerdict::Slower) slower++;
+            
+            std::cout << std::setw(15) << std::left << result.algorithm << " | "
+                      << std::setw(14) << std::left << result.implementation << " | "
+                      << std::setw(8) << std::right << result.problem_size << " | "
+                      << std::setw(7) << std::right << result.num_threads << " | "
+                      << std::setw(11) << std::right << result.task_granularity << " | ";
+            
+            if (it == baseline.end()) {
+                std::cout << std::setw(8) << "-" << " | "
+                          << std::fixed << std::setprecision(4) << std::setw(8) << result.stats.mean << " | "
+                          << std::setw(7) << "-" << " | ";
+            } else {
+                double change = (it->second.mean > 0.0) ? (result.stats.mean / it->second.mean - 1.0) * 100.0 : 0.0;
+                std::cout << std::fixed << std::setprecision(4) << std::setw(8) << it->second.mean << " | "
+                          << std::setw(8) << result.stats.mean << " | "
+                          << std::showpos << std::setprecision(1) << std::setw(6) << change << "%"
+                          << std::noshowpos << " | ";
+            }
+            std::cout << verdict_name(verdict) << std::endl;
+        }
+        
+        std::cout << "Significant: " << faster << " faster, " << slower << " slower" << std::endl;
+    }
+    
     void visualize_speedup_by_algorithm() const {
         std::cout << "\nSpeedup by Algorithm:" << std::endl;
         std::cout << "-----------------------------------" << std::endl;
@@ -407,23 +777,25 @@ void benchmark_fibonacci(BenchmarkManager& manager) {
         std::cout << "  Problem size n = " << n << std::endl;
         
         // Measure sequential performance (baseline)
-        double seq_time = task_utils::measure_time([n]() {
+        TimingStats seq_stats = manager.measure([n]() {
             fibonacci_sequential(n);
         });
+        double seq_time = seq_stats.median;
         
         std::cout << "    Sequential time: " << std::fixed << std::setprecision(4) 
                   << seq_time << " seconds" << std::endl;
         
         // Add sequential result
-        manager.add_result("Fibonacci", "Sequential", n, 1, 0, seq_time, 1.0, 100.0);
+        manager.add_result("Fibonacci", "Sequential", n, 1, 0, seq_stats, 1.0, 100.0);
         
         // Measure simple parallel performance
         for (int threads : thread_counts) {
             omp_set_num_threads(threads);
             
-            double simple_time = task_utils::measure_time([n]() {
+            TimingStats simple_stats = manager.measure([n]() {
                 fibonacci_parallel_simple(n);
             });
+            double simple_time = simple_stats.median;
             
             double speedup = seq_time / simple_time;
             double efficiency = (speedup / threads) * 100.0;
@@ -433,7 +805,7 @@ void benchmark_fibonacci(BenchmarkManager& manager) {
                       << "speedup=" << std::fixed << std::setprecision(2) << speedup << "x" << std::endl;
             
             manager.add_result("Fibonacci", "SimpleParallel", n, threads, 0, 
-                              simple_time, speedup, efficiency);
+                              simple_stats, speedup, efficiency);
         }
         
         // Measure task-based parallel performance
@@ -441,9 +813,10 @@ void benchmark_fibonacci(BenchmarkManager& manager) {
             for (int cutoff : cutoff_values) {
                 omp_set_num_threads(threads);
                 
-                double task_time = task_utils::measure_time([n, cutoff]() {
+                TimingStats task_stats = manager.measure([n, cutoff]() {
                     fibonacci_parallel_task(n, cutoff);
                 });
+                double task_time = task_stats.median;
                 
                 double speedup = seq_time / task_time;
                 double efficiency = (speedup / threads) * 100.0;
@@ -454,7 +827,7 @@ void benchmark_fibonacci(BenchmarkManager& manager) {
                           << "speedup=" << std::fixed << std::setprecision(2) << speedup << "x" << std::endl;
                 
                 manager.add_result("Fibonacci", "TaskParallel", n, threads, cutoff, 
-                                  task_time, speedup, efficiency);
+                                  task_stats, speedup, efficiency);
             }
         }
     }
@@ -551,7 +924,48 @@ void quicksort_parallel_task(std::vector<int>& arr, int cutoff) {
     }
 }
 
-void benchmark_quicksort(BenchmarkManager& manager) {
+// Run one task-parallel sort engine; cutoff is the sequential threshold for the
+// quicksort and merge sort variants and the minimum bucket size for sample sort.
+// Radix sort has no cutoff.
+void run_parallel_sort(parallel_sort::SortAlgorithm algorithm, std::vector<int>& arr, int cutoff) {
+    switch (algorithm) {
+        case parallel_sort::SortAlgorithm::LOMUTO_TASK:
+            quicksort_parallel_task(arr, cutoff);
+            break;
+        case parallel_sort::SortAlgorithm::THREE_WAY_TASK:
+            parallel_sort::quicksort_3way_parallel(arr, cutoff);
+            break;
+        case parallel_sort::SortAlgorithm::SAMPLE_SORT:
+            parallel_sort::sample_sort(arr, cutoff);
+            break;
+        case parallel_sort::SortAlgorithm::RADIX_SORT:
+            parallel_sort::radix_sort(arr);
+            break;
+        case parallel_sort::SortAlgorithm::MERGE_SORT:
+            parallel_sort::merge_sort_parallel(arr, cutoff);
+            break;
+    }
+}
+
+// Implementation label used in the results table and CSV
+const char* sort_implementation_label(parallel_sort::SortAlgorithm algorithm) {
+    switch (algorithm) {
+        case parallel_sort::SortAlgorithm::LOMUTO_TASK: return "TaskParallel";
+        case parallel_sort::SortAlgorithm::THREE_WAY_TASK: return "ThreeWayTask";
+        case parallel_sort::SortAlgorithm::SAMPLE_SORT: return "SampleSort";
+        case parallel_sort::SortAlgorithm::RADIX_SORT: return "RadixSort";
+        case parallel_sort::SortAlgorithm::MERGE_SORT: return "MergeSort";
+    }
+    return "Unknown";
+}
+
+void benchmark_quicksort(BenchmarkManager& manager,
+                         const std::vector<parallel_sort::SortAlgorithm>& algorithms = {
+                             parallel_sort::SortAlgorithm::LOMUTO_TASK,
+                             parallel_sort::SortAlgorithm::THREE_WAY_TASK,
+                             parallel_sort::SortAlgorithm::SAMPLE_SORT,
+                             parallel_sort::SortAlgorithm::RADIX_SORT,
+                             parallel_sort::SortAlgorithm::MERGE_SORT}) {
     std::cout << "\nRunning Quicksort Benchmark..." << std::endl;
     
     // Parameters
@@ -581,25 +995,27 @@ void benchmark_quicksort(BenchmarkManager& manager) {
         }
         
         // Measure sequential performance (baseline)
-        auto seq_data = original_data;
-        double seq_time = task_utils::measure_time([&seq_data]() {
+        std::vector<int> seq_data;
+        TimingStats seq_stats = manager.measure([&seq_data]() {
             quicksort_sequential(seq_data, 0, static_cast<int>(seq_data.size() - 1));
-        });
+        }, [&]() { seq_data = original_data; });
+        double seq_time = seq_stats.median;
         
         std::cout << "    Sequential time: " << std::fixed << std::setprecision(4) 
                   << seq_time << " seconds" << std::endl;
         
         // Add sequential result
-        manager.add_result("Quicksort", "Sequential", size, 1, 0, seq_time, 1.0, 100.0);
+        manager.add_result("Quicksort", "Sequential", size, 1, 0, seq_stats, 1.0, 100.0);
         
         // Measure simple parallel performance
         for (int threads : thread_counts) {
             omp_set_num_threads(threads);
             
-            auto simple_data = original_data;
-            double simple_time = task_utils::measure_time([&simple_data]() {
+            std::vector<int> simple_data;
+            TimingStats simple_stats = manager.measure([&simple_data]() {
                 quicksort_parallel_simple(simple_data, 0, static_cast<int>(simple_data.size() - 1));
-            });
+            }, [&]() { simple_data = original_data; });
+            double simple_time = simple_stats.median;
             
             double speedup = seq_time / simple_time;
             double efficiency = (speedup / threads) * 100.0;
@@ -615,35 +1031,43 @@ void benchmark_quicksort(BenchmarkManager& manager) {
             }
             
             manager.add_result("Quicksort", "SimpleParallel", size, threads, 0, 
-                              simple_time, speedup, efficiency);
+                              simple_stats, speedup, efficiency);
         }
         
-        // Measure task-based parallel performance
-        for (int threads : thread_counts) {
-            for (int cutoff : cutoff_values) {
-                omp_set_num_threads(threads);
-                
-                auto task_data = original_data;
-                double task_time = task_utils::measure_time([&task_data, cutoff]() {
-                    quicksort_parallel_task(task_data, cutoff);
-                });
-                
-                double speedup = seq_time / task_time;
-                double efficiency = (speedup / threads) * 100.0;
-                
-                std::cout << "    Task Parallel (threads=" << threads 
-                          << ", cutoff=" << cutoff << "): " 
-                          << std::fixed << std::setprecision(4) << task_time << " s, "
-                          << "speedup=" << std::fixed << std::setprecision(2) << speedup << "x" << std::endl;
-                
-                // Verify result
-                bool is_correct = std::is_sorted(task_data.begin(), task_data.end());
-                if (!is_correct) {
-                    std::cerr << "      Error: Task parallel quicksort result is incorrect!" << std::endl;
+        // Measure task-based parallel performance of each selected engine
+        for (parallel_sort::SortAlgorithm algorithm : algorithms) {
+            for (int threads : thread_counts) {
+                for (int cutoff : cutoff_values) {
+                    // Radix sort ignores the cutoff; measure it once per thread count
+                    if (algorithm == parallel_sort::SortAlgorithm::RADIX_SORT && cutoff != cutoff_values.front()) {
+                        continue;
+                    }
+                    omp_set_num_threads(threads);
+                    
+                    std::vector<int> task_data;
+                    TimingStats task_stats = manager.measure([&task_data, cutoff, algorithm]() {
+                        run_parallel_sort(algorithm, task_data, cutoff);
+                    }, [&]() { task_data = original_data; });
+                    double task_time = task_stats.median;
+                    
+                    double speedup = seq_time / task_time;
+                    double efficiency = (speedup / threads) * 100.0;
+                    
+                    std::cout << "    " << parallel_sort::algorithm_name(algorithm) << " (threads=" << threads 
+                              << ", cutoff=" << cutoff << "): " 
+                              << std::fixed << std::setprecision(4) << task_time << " s, "
+                              << "speedup=" << std::fixed << std::setprecision(2) << speedup << "x" << std::endl;
+                    
+                    // Verify result
+                    bool is_correct = std::is_sorted(task_data.begin(), task_data.end());
+                    if (!is_correct) {
+                        std::cerr << "      Error: " << parallel_sort::algorithm_name(algorithm)
+                                  << " result is incorrect!" << std::endl;
+                    }
+                    
+                    manager.add_result("Quicksort", sort_implementation_label(algorithm), size, threads, cutoff, 
+                                      task_stats, speedup, efficiency);
                 }
-                
-                manager.add_result("Quicksort", "TaskParallel", size, threads, cutoff, 
-                                  task_time, speedup, efficiency);
             }
         }
     }
@@ -760,24 +1184,30 @@ void benchmark_matrix_multiply(BenchmarkManager& manager) {
         std::vector<double> C_seq(size * size, 0.0);
         
         // Measure sequential performance (baseline)
-        double seq_time = task_utils::measure_time([&]() {
+        TimingStats seq_stats = manager.measure([&]() {
             matrix_multiply_sequential(A, B, C_seq, size);
         });
+        double seq_time = seq_stats.median;
+        
+        const double flops = blocked_gemm::gemm_flops(size);
         
         std::cout << "    Sequential time: " << std::fixed << std::setprecision(4) 
-                  << seq_time << " seconds" << std::endl;
+                  << seq_time << " seconds, " << std::setprecision(2) << flops / seq_time * 1e-9
+                  << " GFLOP/s" << std::endl;
         
         // Add sequential result
-        manager.add_result("MatrixMultiply", "Sequential", size, 1, 0, seq_time, 1.0, 100.0);
+        manager.add_result("MatrixMultiply", "Sequential", size, 1, 0, seq_stats, 1.0, 100.0,
+                           flops / seq_time * 1e-9);
         
         // Measure simple parallel performance
         for (int threads : thread_counts) {
             omp_set_num_threads(threads);
             
             std::vector<double> C_simple(size * size, 0.0);
-            double simple_time = task_utils::measure_time([&]() {
+            TimingStats simple_stats = manager.measure([&]() {
                 matrix_multiply_parallel_simple(A, B, C_simple, size);
             });
+            double simple_time = simple_stats.median;
             
             double speedup = seq_time / simple_time;
             double efficiency = (speedup / threads) * 100.0;
@@ -787,11 +1217,12 @@ void benchmark_matrix_multiply(BenchmarkManager& manager) {
             
             std::cout << "    Simple Parallel (threads=" << threads << "): " 
                       << std::fixed << std::setprecision(4) << simple_time << " s, "
-                      << "speedup=" << std::fixed << std::setprecision(2) << speedup << "x"
+                      << "speedup=" << std::fixed << std::setprecision(2) << speedup << "x, "
+                      << flops / simple_time * 1e-9 << " GFLOP/s"
                       << (is_correct ? "" : " (INCORRECT)") << std::endl;
             
             manager.add_result("MatrixMultiply", "SimpleParallel", size, threads, 0, 
-                              simple_time, speedup, efficiency);
+                              simple_stats, speedup, efficiency, flops / simple_time * 1e-9);
         }
         
         // Measure task-based parallel performance
@@ -800,9 +1231,10 @@ void benchmark_matrix_multiply(BenchmarkManager& manager) {
                 omp_set_num_threads(threads);
                 
                 std::vector<double> C_task(size * size, 0.0);
-                double task_time = task_utils::measure_time([&]() {
+                TimingStats task_stats = manager.measure([&]() {
                     matrix_multiply_task(A, B, C_task, size, block_size);
                 });
+                double task_time = task_stats.median;
                 
                 double speedup = seq_time / task_time;
                 double efficiency = (speedup / threads) * 100.0;
@@ -813,13 +1245,43 @@ void benchmark_matrix_multiply(BenchmarkManager& manager) {
                 std::cout << "    Task Parallel (threads=" << threads 
                           << ", block_size=" << block_size << "): " 
                           << std::fixed << std::setprecision(4) << task_time << " s, "
-                          << "speedup=" << std::fixed << std::setprecision(2) << speedup << "x"
+                          << "speedup=" << std::fixed << std::setprecision(2) << speedup << "x, "
+                          << flops / task_time * 1e-9 << " GFLOP/s"
                           << (is_correct ? "" : " (INCORRECT)") << std::endl;
                 
                 manager.add_result("MatrixMultiply", "TaskParallel", size, threads, block_size, 
-                                  task_time, speedup, efficiency);
+                                  task_stats, speedup, efficiency, flops / task_time * 1e-9);
             }
         }
+        
+        // Measure the packed, cache-blocked task GEMM; its different summation
+        // order needs a tolerance that scales with the inner dimension
+        const double packed_tolerance = 4.0 * size * size * std::numeric_limits<double>::epsilon();
+        for (int threads : thread_counts) {
+            omp_set_num_threads(threads);
+            
+            std::vector<double> C_packed(size * size, 0.0);
+            TimingStats packed_stats = manager.measure([&]() {
+                blocked_gemm::gemm_task(A, B, C_packed, size);
+            });
+            double packed_time = packed_stats.median;
+            
+            double speedup = seq_time / packed_time;
+            double efficiency = (speedup / threads) * 100.0;
+            
+            // Verify result
+            bool is_correct = verify_matrix_result(C_seq, C_packed, size, packed_tolerance);
+            
+            std::cout << "    Packed Task GEMM (threads=" << threads 
+                      << ", kernel=" << blocked_gemm::kernel_name() << "): " 
+                      << std::fixed << std::setprecision(4) << packed_time << " s, "
+                      << "speedup=" << std::fixed << std::setprecision(2) << speedup << "x, "
+                      << flops / packed_time * 1e-9 << " GFLOP/s"
+                      << (is_correct ? "" : " (INCORRECT)") << std::endl;
+            
+            manager.add_result("MatrixMultiply", "PackedTask", size, threads, blocked_gemm::MC, 
+                              packed_stats, speedup, efficiency, flops / packed_time * 1e-9);
+        }
     }
 }
 
@@ -831,15 +1293,59 @@ int main(int argc, char* argv[]) {
     bool run_fibonacci = true;
     bool run_quicksort = true;
     bool run_matrix = true;
+    std::vector<parallel_sort::SortAlgorithm> sort_algorithms = {
+        parallel_sort::SortAlgorithm::LOMUTO_TASK,
+        parallel_sort::SortAlgorithm::THREE_WAY_TASK,
+        parallel_sort::SortAlgorithm::SAMPLE_SORT,
+        parallel_sort::SortAlgorithm::RADIX_SORT,
+        parallel_sort::SortAlgorithm::MERGE_SORT};
+    
+    int warmup_runs = 0;
+    int repetitions = 1;
+    std::string json_file;
+    std::string baseline_file;
     
-    if (argc > 1) {
-        std::string arg = argv[1];
+    // Options: --warmup N, --repetitions N, --json FILE, --baseline FILE;
+    // everything else is positional
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--warmup" && has_value) {
+            warmup_runs = std::atoi(argv[++i]);
+        } else if (arg == "--repetitions" && has_value) {
+            repetitions = std::atoi(argv[++i]);
+        } else if (arg == "--json" && has_value) {
+            json_file = argv[++i];
+        } else if (arg == "--baseline" && has_value) {
+            baseline_file = argv[++i];
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Error: unknown or incomplete option '" << arg << "'" << std::endl;
+            return 1;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    
+    if (!positional.empty()) {
+        const std::string& arg = positional[0];
         if (arg == "fibonacci") {
             run_quicksort = false;
             run_matrix = false;
         } else if (arg == "quicksort") {
             run_fibonacci = false;
             run_matrix = false;
+            
+            // Optional engine filter: quicksort [lomuto|3way|sample|radix|merge]
+            parallel_sort::SortAlgorithm algorithm;
+            if (positional.size() > 1) {
+                if (!parallel_sort::parse_algorithm(positional[1], algorithm)) {
+                    std::cerr << "Error: unknown sort algorithm '" << positional[1]
+                              << "' (expected lomuto, 3way, sample, radix or merge)" << std::endl;
+                    return 1;
+                }
+                sort_algorithms = {algorithm};
+            }
         } else if (arg == "matrix") {
             run_fibonacci = false;
             run_quicksort = false;
@@ -851,6 +1357,15 @@ int main(int argc, char* argv[]) {
     
     // Initialize benchmark manager
     BenchmarkManager manager;
+    manager.set_repetitions(warmup_runs, repetitions);
+    if (manager.get_repetitions() > 1 || warmup_runs > 0) {
+        std::cout << "Statistical mode: " << warmup_runs << " warmup run(s), "
+                  << manager.get_repetitions() << " timed repetition(s) per configuration" << std::endl;
+    }
+    
+    if (!baseline_file.empty() && !manager.load_baseline(baseline_file)) {
+        return 1;
+    }
     
     // Run benchmarks
     if (run_fibonacci) {
@@ -858,7 +1373,7 @@ int main(int argc, char* argv[]) {
     }
     
     if (run_quicksort) {
-        benchmark_quicksort(manager);
+        benchmark_quicksort(manager, sort_algorithms);
     }
     
     if (run_matrix) {
@@ -868,6 +1383,10 @@ int main(int argc, char* argv[]) {
     // Print and save results
     manager.print_results();
     manager.save_to_csv("benchmark_results.csv");
+    if (!json_file.empty()) {
+        manager.save_to_json(json_file);
+    }
+    manager.print_baseline_comparison();
     
     // Visualize results
     manager.visualize_speedup_by_algorithm();
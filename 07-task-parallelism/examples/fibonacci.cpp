@@ -4,6 +4,7 @@
 #include <vector>
 #include <omp.h>
 #include <string>       // This provides std::string
+#include "../include/task_utils.h"
 
 // Sequential Fibonacci
 long long fib_sequential(int n) {
@@ -52,6 +53,62 @@ long long fib_parallel(int n, int cutoff) {
     return result;
 }
 
+// Fibonacci without a hand-picked cutoff: the granularity controller decides
+// at every level whether fib(n-1) becomes a task or runs inline
+long long fib_adaptive(int n, int depth, task_utils::GranularityController& controller) {
+    if (n < 2) return n;
+    
+    // Below the learned spawn depth, skip the per-call checks entirely
+    if (controller.past_spawn_limit(depth)) {
+        return fib_sequential(n);
+    }
+    
+    long long x, y;
+    bool spawned = controller.spawn_or_run(depth, [&x, &controller, n, depth]() {
+        x = fib_adaptive(n - 1, depth + 1, controller);
+    });
+    
+    y = fib_adaptive(n - 2, depth + 1, controller);
+    
+    if (spawned) {
+        #pragma omp taskwait
+    }
+    
+    return x + y;
+}
+
+// Wrapper for adaptive Fibonacci
+long long fib_adaptive_parallel(int n) {
+    task_utils::GranularityController controller;
+    long long result;
+    
+    #pragma omp parallel
+    {
+        #pragma omp single
+        {
+            result = fib_adaptive(n, 0, controller);
+        }
+    }
+    
+    return result;
+}
+
+// Work-stealing Fibonacci: same recursion and cutoff, forked through the
+// custom Chase-Lev pool instead of the OpenMP task runtime
+long long fib_work_stealing(task_utils::WorkStealingPool& pool, int n, int cutoff) {
+    if (n < 2) return n;
+    
+    if (n < cutoff) {
+        return fib_sequential(n);
+    }
+    
+    long long x, y;
+    pool.join([&]() { x = fib_work_stealing(pool, n - 1, cutoff); },
+              [&]() { y = fib_work_stealing(pool, n - 2, cutoff); });
+    
+    return x + y;
+}
+
 // Measure execution time
 template<typename Func, typename... Args>
 std::pair<long long, double> measure_time(Func func, Args... args) {
@@ -63,28 +120,45 @@ std::pair<long long, double> measure_time(Func func, Args... args) {
 }
 
 // Display cutoff impact on performance
-void analyze_cutoff_impact(int n, [[maybe_unused]] int num_threads) {
+void analyze_cutoff_impact(int n, int num_threads) {
     std::cout << "\nAnalyzing cutoff impact on Fibonacci(" << n << "):" << std::endl;
     std::cout << "--------------------------------------------------" << std::endl;
-    std::cout << "Cutoff | Result | Time (s) | Speedup" << std::endl;
+    std::cout << "Cutoff | Result | Time (s) | Speedup | WS Time (s) | WS Speedup" << std::endl;
     std::cout << "--------------------------------------------------" << std::endl;
     
     // First measure sequential time as baseline
     auto [seq_result, seq_time] = measure_time(fib_sequential, n);
     
+    task_utils::WorkStealingPool pool(num_threads);
+    
     // Try different cutoff values
     for (int cutoff = 10; cutoff <= std::min(n, 30); cutoff += 5) {
         auto [result, time] = measure_time(fib_parallel, n, cutoff);
         
+        auto [ws_result, ws_time] = measure_time([&]() {
+            return pool.run([&]() { return fib_work_stealing(pool, n, cutoff); });
+        });
+        
         // Calculate speedup
         double speedup = seq_time / time;
+        double ws_speedup = seq_time / ws_time;
         
         std::cout << std::setw(6) << cutoff << " | "
                   << std::setw(8) << result << " | "
                   << std::fixed << std::setprecision(4) << std::setw(8) << time << " | "
-                  << std::fixed << std::setprecision(2) << std::setw(6) << speedup << "x"
+                  << std::fixed << std::setprecision(2) << std::setw(6) << speedup << "x | "
+                  << std::fixed << std::setprecision(4) << std::setw(11) << ws_time << " | "
+                  << std::fixed << std::setprecision(2) << std::setw(9) << ws_speedup << "x"
+                  << (ws_result == result ? "" : "  (mismatch!)")
                   << std::endl;
     }
+    
+    // The adaptive controller needs no cutoff at all
+    auto [adaptive_result, adaptive_time] = measure_time(fib_adaptive_parallel, n);
+    std::cout << "Adaptive |" << std::setw(8) << adaptive_result << " | "
+              << std::fixed << std::setprecision(4) << std::setw(8) << adaptive_time << " | "
+              << std::fixed << std::setprecision(2) << std::setw(6) << seq_time / adaptive_time << "x"
+              << (adaptive_result == seq_result ? "" : "  (mismatch!)") << std::endl;
 }
 
 int main(int argc, char* argv[]) {
@@ -121,12 +195,29 @@ int main(int argc, char* argv[]) {
     std::cout << "\nSpeedup: " << std::fixed << std::setprecision(2) << speedup << "x" << std::endl;
     std::cout << "Efficiency: " << std::fixed << std::setprecision(2) << efficiency << "%" << std::endl;
     
+    // Same computation on the work-stealing pool
+    task_utils::WorkStealingPool pool(num_threads);
+    auto [ws_result, ws_time] = measure_time([&]() {
+        return pool.run([&]() { return fib_work_stealing(pool, n, cutoff); });
+    });
+    std::cout << "\nWork-Stealing Result: " << ws_result << std::endl;
+    std::cout << "Work-Stealing Time: " << std::fixed << std::setprecision(4) << ws_time << " seconds"
+              << " (" << std::setprecision(2) << par_time / ws_time << "x vs omp task)" << std::endl;
+    pool.print_stats();
+    
+    // Same computation with the adaptive granularity controller (no cutoff)
+    auto [adaptive_result, adaptive_time] = measure_time(fib_adaptive_parallel, n);
+    std::cout << "\nAdaptive Result: " << adaptive_result << std::endl;
+    std::cout << "Adaptive Time: " << std::fixed << std::setprecision(4) << adaptive_time << " seconds"
+              << " (" << std::setprecision(2) << par_time / adaptive_time << "x vs cutoff " << cutoff << ")" << std::endl;
+    
     // Verify results match
-    if (seq_result == par_result) {
+    if (seq_result == par_result && seq_result == ws_result && seq_result == adaptive_result) {
         std::cout << "\nResults match! ✓" << std::endl;
     } else {
         std::cout << "\nResults do not match! ✗" << std::endl;
-        std::cout << "Sequential: " << seq_result << ", Parallel: " << par_result << std::endl;
+        std::cout << "Sequential: " << seq_result << ", Parallel: " << par_result
+                  << ", Work-Stealing: " << ws_result << std::endl;
     }
     
     // Analyze impact of different cutoff values
@@ -10,8 +10,63 @@
 #include <memory>
 #include <mutex>
 #include <atomic>
+#include <cstdint>
+#include <utility>
+#include <fstream>
+#include <cstring>
+#include <limits>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <sstream>
+#include <type_traits>
+#include <bitset>
 #include <omp.h>
+
+// SIMD kernels of the sorted-set intersection used by triangle counting. GCC
+// and Clang compile the AVX2 and AVX-512 kernels with target attributes and
+// triangle counting picks one at run time, so the default build needs no
+// -mavx2; MSVC only has the kernels its /arch flag enables.
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define GRAPH_INTERSECT_AVX2 1
+#define GRAPH_INTERSECT_AVX512 1
+#define GRAPH_INTERSECT_RUNTIME_DISPATCH 1
+#define GRAPH_AVX2_TARGET __attribute__((target("avx2")))
+#define GRAPH_AVX512_TARGET __attribute__((target("avx512f")))
+#else
+#if defined(__AVX2__)
+#define GRAPH_INTERSECT_AVX2 1
+#else
+#define GRAPH_INTERSECT_AVX2 0
+#endif
+#if defined(__AVX512F__)
+#define GRAPH_INTERSECT_AVX512 1
+#else
+#define GRAPH_INTERSECT_AVX512 0
+#endif
+#define GRAPH_INTERSECT_RUNTIME_DISPATCH 0
+#define GRAPH_AVX2_TARGET
+#define GRAPH_AVX512_TARGET
+#endif
+#if GRAPH_INTERSECT_AVX2 || GRAPH_INTERSECT_AVX512
+#include <immintrin.h>
+#endif
+
+// Platform-specific includes for memory-mapped graph files
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "../include/task_utils.h"
+#include "perf_markers.h"
 
 //==============================================================================
 // Graph Data Structures
@@ -79,6 +134,355 @@ public:
     }
 };
 
+// Read-only view over one vertex's slice of the CSR neighbors array
+struct NeighborRange {
+    const int* first;
+    const int* last;
+    
+    const int* begin() const { return first; }
+    const int* end() const { return last; }
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+    int operator[](size_t i) const { return first[i]; }
+};
+
+// Frozen, immutable graph in compressed sparse row (CSR) form.
+// Vertex v's neighbors are neighbors[offsets[v] .. offsets[v + 1]), so every
+// neighbor list is contiguous and the whole graph lives in two arrays.
+// Use Graph as the mutable builder and freeze it (or an edge list) into this.
+// The arrays are either owned on the heap or borrowed from a file mapping;
+// copies share the same immutable storage. An optional weights array runs
+// parallel to neighbors; without it every edge has weight 1.
+class CSRGraph {
+private:
+    // Heap storage for graphs built in memory
+    struct OwnedArrays {
+        std::vector<int64_t> offsets;
+        std::vector<int> neighbors;
+    };
+    
+    int num_vertices;
+    const int64_t* offsets;              // num_vertices + 1 entries
+    const int* neighbors;                // offsets[num_vertices] entries
+    std::shared_ptr<const void> storage; // keeps offsets/neighbors alive
+    const float* weights = nullptr;      // offsets[num_vertices] entries, or null if unweighted
+    std::shared_ptr<const void> weight_storage;
+    
+    // Exclusive prefix sum of per-vertex degrees (two-pass blocked scan)
+    static std::vector<int64_t> build_offsets(const std::vector<int64_t>& degrees) {
+        const int n = static_cast<int>(degrees.size());
+        std::vector<int64_t> result(n + 1, 0);
+        int num_blocks = 1;
+        std::vector<int64_t> block_sums;
+        
+        #pragma omp parallel
+        {
+            #pragma omp single
+            {
+                num_blocks = omp_get_num_threads();
+                block_sums.assign(num_blocks + 1, 0);
+            }
+            
+            int block = omp_get_thread_num();
+            int64_t chunk = (static_cast<int64_t>(n) + num_blocks - 1) / num_blocks;
+            int begin = static_cast<int>(std::min<int64_t>(block * chunk, n));
+            int end = static_cast<int>(std::min<int64_t>(begin + chunk, n));
+            
+            int64_t local_sum = 0;
+            for (int v = begin; v < end; v++) {
+                local_sum += degrees[v];
+            }
+            block_sums[block + 1] = local_sum;
+            
+            #pragma omp barrier
+            #pragma omp single
+            {
+                for (int b = 0; b < num_blocks; b++) {
+                    block_sums[b + 1] += block_sums[b];
+                }
+            }
+            
+            int64_t running = block_sums[block];
+            for (int v = begin; v < end; v++) {
+                result[v] = running;
+                running += degrees[v];
+            }
+        }
+        
+        result[n] = block_sums[num_blocks];
+        return result;
+    }
+    
+    void adopt(int n, std::shared_ptr<OwnedArrays> arrays) {
+        num_vertices = n;
+        offsets = arrays->offsets.data();
+        neighbors = arrays->neighbors.data();
+        storage = std::move(arrays);
+    }
+    
+public:
+    CSRGraph() {
+        auto arrays = std::make_shared<OwnedArrays>();
+        arrays->offsets.assign(1, 0);
+        adopt(0, std::move(arrays));
+    }
+    
+    // Freeze an adjacency-list builder, preserving its neighbor order
+    explicit CSRGraph(const Graph& graph) {
+        const int n = graph.get_num_vertices();
+        std::vector<int64_t> degrees(n);
+        
+        #pragma omp parallel for schedule(static)
+        for (int v = 0; v < n; v++) {
+            degrees[v] = static_cast<int64_t>(graph.get_neighbors(v).size());
+        }
+        
+        auto arrays = std::make_shared<OwnedArrays>();
+        arrays->offsets = build_offsets(degrees);
+        arrays->neighbors.resize(arrays->offsets[n]);
+        
+        #pragma omp parallel for schedule(dynamic, 256)
+        for (int v = 0; v < n; v++) {
+            const auto& adj = graph.get_neighbors(v);
+            std::copy(adj.begin(), adj.end(), arrays->neighbors.begin() + arrays->offsets[v]);
+        }
+        
+        adopt(n, std::move(arrays));
+    }
+    
+    // Build directly from an undirected edge list; each edge is stored in both
+    // directions and neighbor lists are sorted so the layout is deterministic.
+    // With simple_graph, self-loops and duplicate edges are dropped.
+    static CSRGraph from_edge_list(int n, const std::vector<std::pair<int, int>>& edges,
+                                   bool simple_graph = false) {
+        const int64_t num_input_edges = static_cast<int64_t>(edges.size());
+        std::vector<int64_t> degrees(n, 0);
+        
+        // Count degrees (out-of-range endpoints are dropped, like Graph::add_edge)
+        #pragma omp parallel for schedule(static)
+        for (int64_t e = 0; e < num_input_edges; e++) {
+            int u = edges[e].first;
+            int v = edges[e].second;
+            if (u >= 0 && u < n && v >= 0 && v < n) {
+                #pragma omp atomic
+                degrees[u]++;
+                #pragma omp atomic
+                degrees[v]++;
+            }
+        }
+        
+        auto arrays = std::make_shared<OwnedArrays>();
+        arrays->offsets = build_offsets(degrees);
+        arrays->neighbors.resize(arrays->offsets[n]);
+        std::vector<int64_t> cursor(arrays->offsets.begin(), arrays->offsets.end() - 1);
+        int* out = arrays->neighbors.data();
+        
+        // Scatter both directions of every edge into its owner's slice
+        #pragma omp parallel for schedule(static)
+        for (int64_t e = 0; e < num_input_edges; e++) {
+            int u = edges[e].first;
+            int v = edges[e].second;
+            if (u >= 0 && u < n && v >= 0 && v < n) {
+                int64_t pos_u, pos_v;
+                #pragma omp atomic capture
+                pos_u = cursor[u]++;
+                #pragma omp atomic capture
+                pos_v = cursor[v]++;
+                out[pos_u] = v;
+                out[pos_v] = u;
+            }
+        }
+        
+        // Scatter order depends on thread interleaving, so sort each slice
+        #pragma omp parallel for schedule(dynamic, 256)
+        for (int v = 0; v < n; v++) {
+            std::sort(out + arrays->offsets[v], out + arrays->offsets[v + 1]);
+        }
+        
+        if (simple_graph) {
+            // Sorted slices make duplicates adjacent; compact into fresh arrays
+            #pragma omp parallel for schedule(dynamic, 256)
+            for (int v = 0; v < n; v++) {
+                int64_t kept = 0;
+                for (int64_t i = arrays->offsets[v]; i < arrays->offsets[v + 1]; i++) {
+                    if (out[i] != v && (i == arrays->offsets[v] || out[i] != out[i - 1])) kept++;
+                }
+                degrees[v] = kept;
+            }
+            
+            auto compact = std::make_shared<OwnedArrays>();
+            compact->offsets = build_offsets(degrees);
+            compact->neighbors.resize(compact->offsets[n]);
+            
+            #pragma omp parallel for schedule(dynamic, 256)
+            for (int v = 0; v < n; v++) {
+                int64_t pos = compact->offsets[v];
+                for (int64_t i = arrays->offsets[v]; i < arrays->offsets[v + 1]; i++) {
+                    if (out[i] != v && (i == arrays->offsets[v] || out[i] != out[i - 1])) {
+                        compact->neighbors[pos++] = out[i];
+                    }
+                }
+            }
+            
+            arrays = std::move(compact);
+        }
+        
+        CSRGraph csr;
+        csr.adopt(n, std::move(arrays));
+        return csr;
+    }
+    
+    // Zero-copy view over externally owned arrays (e.g. a memory-mapped file).
+    // owner must keep both arrays alive; it is shared by every copy of the view.
+    static CSRGraph from_arrays(int n, const int64_t* offsets, const int* neighbors,
+                                std::shared_ptr<const void> owner) {
+        CSRGraph csr;
+        csr.num_vertices = n;
+        csr.offsets = offsets;
+        csr.neighbors = neighbors;
+        csr.storage = std::move(owner);
+        return csr;
+    }
+    
+    // Copy of this graph with vertex v renamed to new_ids[v] (a permutation);
+    // neighbor lists are sorted in the new labels
+    CSRGraph relabeled(const std::vector<int>& new_ids) const {
+        const int n = num_vertices;
+        std::vector<int> old_ids(n);
+        std::vector<int64_t> degrees(n);
+        
+        #pragma omp parallel for schedule(static)
+        for (int v = 0; v < n; v++) {
+            old_ids[new_ids[v]] = v;
+        }
+        
+        #pragma omp parallel for schedule(static)
+        for (int v = 0; v < n; v++) {
+            degrees[v] = get_degree(old_ids[v]);
+        }
+        
+        auto arrays = std::make_shared<OwnedArrays>();
+        arrays->offsets = build_offsets(degrees);
+        arrays->neighbors.resize(arrays->offsets[n]);
+        int* out = arrays->neighbors.data();
+        std::vector<float> new_weights(weights ? arrays->offsets[n] : 0);
+        
+        #pragma omp parallel for schedule(dynamic, 256)
+        for (int v = 0; v < n; v++) {
+            int* slice = out + arrays->offsets[v];
+            int64_t count = 0;
+            if (weights == nullptr) {
+                for (int u : get_neighbors(old_ids[v])) {
+                    slice[count++] = new_ids[u];
+                }
+                std::sort(slice, slice + count);
+            } else {
+                // Weights travel with their neighbors through the sort
+                std::vector<std::pair<int, float>> entries;
+                entries.reserve(degrees[v]);
+                for (int64_t i = offsets[old_ids[v]]; i < offsets[old_ids[v] + 1]; i++) {
+                    entries.emplace_back(new_ids[neighbors[i]], weights[i]);
+                }
+                std::sort(entries.begin(), entries.end());
+                for (const auto& [u, w] : entries) {
+                    new_weights[arrays->offsets[v] + count] = w;
+                    slice[count++] = u;
+                }
+            }
+        }
+        
+        CSRGraph csr;
+        csr.adopt(n, std::move(arrays));
+        return weights ? csr.with_weights(std::move(new_weights)) : csr;
+    }
+    
+    // Copy sharing this graph's structure, with entry_weights[i] the weight of
+    // neighbor entry i (get_num_entries() of them, aligned with get_neighbor_array()).
+    // Both directions of an undirected edge should carry the same weight.
+    // Weights are not part of the binary CSR file.
+    CSRGraph with_weights(std::vector<float> entry_weights) const {
+        CSRGraph csr = *this;
+        auto owned = std::make_shared<const std::vector<float>>(std::move(entry_weights));
+        csr.weights = owned->data();
+        csr.weight_storage = std::move(owned);
+        return csr;
+    }
+    
+    bool has_weights() const {
+        return weights != nullptr;
+    }
+    
+    // Weight of neighbor entry i; 1 on unweighted graphs
+    float get_weight(int64_t entry) const {
+        return weights ? weights[entry] : 1.0f;
+    }
+    
+    // Null on unweighted graphs
+    const float* get_weight_array() const {
+        return weights;
+    }
+    
+    NeighborRange get_neighbors(int vertex) const {
+        return {neighbors + offsets[vertex], neighbors + offsets[vertex + 1]};
+    }
+    
+    int get_degree(int vertex) const {
+        return static_cast<int>(offsets[vertex + 1] - offsets[vertex]);
+    }
+    
+    int get_num_vertices() const {
+        return num_vertices;
+    }
+    
+    // O(1): the neighbors array holds every undirected edge twice
+    int64_t get_num_edges() const {
+        return offsets[num_vertices] / 2;
+    }
+    
+    // O(1): total degree is the length of the neighbors array
+    double get_average_degree() const {
+        return num_vertices > 0 ? static_cast<double>(offsets[num_vertices]) / num_vertices : 0.0;
+    }
+    
+    // Raw arrays, e.g. for serialization
+    const int64_t* get_offsets() const {
+        return offsets;
+    }
+    
+    const int* get_neighbor_array() const {
+        return neighbors;
+    }
+    
+    int64_t get_num_entries() const {
+        return offsets[num_vertices];
+    }
+    
+    void print_stats() const {
+        std::cout << "Graph Statistics (CSR):" << std::endl;
+        std::cout << "- Vertices: " << num_vertices << std::endl;
+        std::cout << "- Edges: " << get_num_edges() << std::endl;
+        std::cout << "- Average degree: " << std::fixed << std::setprecision(2) 
+                  << get_average_degree() << std::endl;
+        std::cout << "- Memory: " << std::fixed << std::setprecision(2)
+                  << ((num_vertices + 1) * sizeof(int64_t) +
+                      get_num_entries() * (sizeof(int) + (weights ? sizeof(float) : 0))) / (1024.0 * 1024.0)
+                  << " MB" << (weights ? " (weighted)" : "") << std::endl;
+        
+        // Degree distribution
+        std::map<int, int> degree_counts;
+        for (int v = 0; v < num_vertices; v++) {
+            degree_counts[get_degree(v)]++;
+        }
+        
+        std::cout << "- Degree distribution:" << std::endl;
+        for (const auto& [degree, count] : degree_counts) {
+            std::cout << "  " << degree << ": " << count << " vertices (" 
+                      << std::fixed << std::setprecision(1)
+                      << (100.0 * count / num_vertices) << "%)" << std::endl;
+        }
+    }
+};
+
 // Generate a random graph
 Graph generate_random_graph(int num_vertices, int num_edges, int seed = 42) {
     std::mt19937 gen(seed);
@@ -194,12 +598,434 @@ Graph generate_grid_graph(int width, int height) {
     return graph;
 }
 
+//==============================================================================
+// Parallel Deterministic Graph Generators
+//==============================================================================
+// Every random draw is a pure function of (seed, counter), so each edge can be
+// generated independently by whichever thread owns it and the resulting CSR
+// graph is bit-identical for a given seed at any thread count.
+
+// Counter-based random stream (SplitMix64 finalizer over a seeded counter)
+inline uint64_t counter_rng(uint64_t seed, uint64_t counter) {
+    uint64_t z = (seed ^ 0x2545F4914F6CDD1DULL) + (counter + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Uniform double in [0, 1) from the counter-based stream
+inline double counter_uniform(uint64_t seed, uint64_t counter) {
+    return static_cast<double>(counter_rng(seed, counter) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Parallel counterpart of generate_random_graph: num_edges uniform endpoint
+// pairs, self-loops redrawn, duplicates removed during the CSR build (so the
+// edge count can be slightly below num_edges on dense graphs)
+CSRGraph generate_random_graph_parallel(int num_vertices, int64_t num_edges, uint64_t seed = 42) {
+    // No vertices to draw endpoints from (or nothing to draw): empty graph
+    if (num_vertices <= 0 || num_edges <= 0) {
+        return CSRGraph::from_edge_list(std::max(0, num_vertices), {}, true);
+    }
+    
+    std::vector<std::pair<int, int>> edges(num_edges);
+    
+    #pragma omp parallel for schedule(static)
+    for (int64_t e = 0; e < num_edges; e++) {
+        uint64_t counter = static_cast<uint64_t>(e) << 8;
+        int u, v;
+        do {
+            u = static_cast<int>(counter_rng(seed, counter++) % num_vertices);
+            v = static_cast<int>(counter_rng(seed, counter++) % num_vertices);
+        } while (u == v && num_vertices > 1);
+        edges[e] = {u, v};
+    }
+    
+    return CSRGraph::from_edge_list(num_vertices, edges, true);
+}
+
+// Parallel preferential attachment (Batagelj-Brandes edge list, resolved in
+// parallel as in Sanders & Schulz). Edge e has source e / d; its target copies a
+// uniformly chosen earlier slot of the implicit endpoint array. Source slots are
+// known in closed form, target slots are resolved by following the chain of
+// earlier edges, which only depends on the counter-based draws.
+CSRGraph generate_scale_free_graph_parallel(int num_vertices, int min_edges_per_vertex, uint64_t seed = 42) {
+    if (num_vertices <= 0) {
+        return CSRGraph::from_edge_list(0, {}, true);
+    }
+    const int64_t d = std::max(1, min_edges_per_vertex);
+    const int64_t num_edges = static_cast<int64_t>(num_vertices) * d;
+    std::vector<std::pair<int, int>> edges(num_edges);
+    
+    #pragma omp parallel for schedule(static)
+    for (int64_t e = 0; e < num_edges; e++) {
+        int64_t current = e;
+        int target;
+        
+        while (true) {
+            uint64_t slot = counter_rng(seed, static_cast<uint64_t>(current)) % static_cast<uint64_t>(2 * current + 1);
+            if (slot % 2 == 0) {
+                target = static_cast<int>((slot / 2) / d);
+                break;
+            }
+            current = static_cast<int64_t>(slot / 2);
+        }
+        
+        edges[e] = {static_cast<int>(e / d), target};
+    }
+    
+    return CSRGraph::from_edge_list(num_vertices, edges, true);
+}
+
+// R-MAT / Kronecker generator with Graph500 parameters (a=0.57, b=c=0.19).
+// Produces 2^scale vertices and edge_factor * 2^scale edges straight into CSR.
+// Vertex IDs are scrambled with a bijection so high-degree vertices are not
+// clustered at low IDs.
+CSRGraph generate_rmat_graph(int scale, int edge_factor, uint64_t seed = 42,
+                             double a = 0.57, double b = 0.19, double c = 0.19) {
+    const int num_vertices = 1 << scale;
+    const int64_t num_edges = static_cast<int64_t>(edge_factor) * num_vertices;
+    const uint64_t mask = static_cast<uint64_t>(num_vertices) - 1;
+    const double ab = a + b;
+    const double abc = a + b + c;
+    std::vector<std::pair<int, int>> edges(num_edges);
+    
+    // Invertible on [0, 2^scale): odd multiply and xor-shift, both modulo 2^scale
+    auto scramble = [&](uint64_t x) {
+        x = (x * 0x9E3779B97F4A7C15ULL) & mask;
+        x ^= x >> ((scale + 1) / 2);
+        return static_cast<int>((x * 0xBF58476D1CE4E5B9ULL) & mask);
+    };
+    
+    #pragma omp parallel for schedule(static)
+    for (int64_t e = 0; e < num_edges; e++) {
+        uint64_t u = 0;
+        uint64_t v = 0;
+        
+        // Recursively pick one of the four adjacency-matrix quadrants per bit
+        for (int bit = 0; bit < scale; bit++) {
+            double r = counter_uniform(seed, static_cast<uint64_t>(e) * scale + bit);
+            int u_bit = r >= ab ? 1 : 0;
+            int v_bit = (r >= a && r < ab) || r >= abc ? 1 : 0;
+            u = (u << 1) | u_bit;
+            v = (v << 1) | v_bit;
+        }
+        
+        edges[e] = {scramble(u), scramble(v)};
+    }
+    
+    return CSRGraph::from_edge_list(num_vertices, edges, true);
+}
+
+// Element-wise comparison of two CSR graphs
+bool are_graphs_identical(const CSRGraph& g1, const CSRGraph& g2) {
+    if (g1.get_num_vertices() != g2.get_num_vertices() || g1.get_num_entries() != g2.get_num_entries()) {
+        return false;
+    }
+    
+    return std::equal(g1.get_offsets(), g1.get_offsets() + g1.get_num_vertices() + 1, g2.get_offsets()) &&
+           std::equal(g1.get_neighbor_array(), g1.get_neighbor_array() + g1.get_num_entries(),
+                      g2.get_neighbor_array());
+}
+
+// Symmetric random weights in [min_weight, max_weight). The weight of edge
+// {u, v} is a pure function of (seed, min(u, v), max(u, v)), so both stored
+// directions agree and the result does not depend on the thread count.
+CSRGraph assign_random_weights(const CSRGraph& graph, float min_weight = 1.0f, float max_weight = 100.0f,
+                               uint64_t seed = 42) {
+    const int n = graph.get_num_vertices();
+    const int64_t* offsets = graph.get_offsets();
+    const int* neighbors = graph.get_neighbor_array();
+    std::vector<float> weights(graph.get_num_entries());
+    
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (int u = 0; u < n; u++) {
+        for (int64_t i = offsets[u]; i < offsets[u + 1]; i++) {
+            uint64_t lo = static_cast<uint64_t>(std::min(u, neighbors[i]));
+            uint64_t hi = static_cast<uint64_t>(std::max(u, neighbors[i]));
+            double r = counter_uniform(seed, lo * static_cast<uint64_t>(n) + hi);
+            weights[i] = static_cast<float>(min_weight + (max_weight - min_weight) * r);
+        }
+    }
+    
+    return graph.with_weights(std::move(weights));
+}
+
+//==============================================================================
+// Graph I/O
+//==============================================================================
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+private:
+    const char* data_ptr = nullptr;
+    size_t data_size = 0;
+#ifdef _WIN32
+    HANDLE file_handle = INVALID_HANDLE_VALUE;
+    HANDLE mapping_handle = nullptr;
+#endif
+    
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    ~MappedFile() {
+#ifdef _WIN32
+        if (data_ptr) UnmapViewOfFile(data_ptr);
+        if (mapping_handle) CloseHandle(mapping_handle);
+        if (file_handle != INVALID_HANDLE_VALUE) CloseHandle(file_handle);
+#else
+        if (data_ptr) munmap(const_cast<char*>(data_ptr), data_size);
+#endif
+    }
+    
+    bool open(const std::string& path) {
+#ifdef _WIN32
+        file_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file_handle == INVALID_HANDLE_VALUE) return false;
+        
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart == 0) return false;
+        data_size = static_cast<size_t>(file_size.QuadPart);
+        
+        mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping_handle) return false;
+        
+        data_ptr = static_cast<const char*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+        return data_ptr != nullptr;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            close(fd);
+            return false;
+        }
+        data_size = static_cast<size_t>(st.st_size);
+        
+        void* mapped = mmap(nullptr, data_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd); // The mapping stays valid after the descriptor is closed
+        if (mapped == MAP_FAILED) return false;
+        
+        data_ptr = static_cast<const char*>(mapped);
+        return true;
+#endif
+    }
+    
+    const char* data() const { return data_ptr; }
+    size_t size() const { return data_size; }
+};
+
+// On-disk binary CSR layout (native byte order):
+//   CSRFileHeader | int64 offsets[num_vertices + 1] | int32 neighbors[num_entries]
+// The header is 32 bytes, so both arrays are naturally aligned inside the mapping
+// and load_csr_binary can use them in place.
+struct CSRFileHeader {
+    char magic[8];
+    int64_t num_vertices;
+    int64_t num_entries;
+    int64_t reserved;
+};
+
+constexpr char CSR_FILE_MAGIC[8] = {'O', 'M', 'P', 'C', 'S', 'R', '0', '1'};
+
+// Write a frozen graph in the binary CSR format
+bool save_csr_binary(const CSRGraph& graph, const std::string& path) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << path << " for writing." << std::endl;
+        return false;
+    }
+    
+    CSRFileHeader header{};
+    std::memcpy(header.magic, CSR_FILE_MAGIC, sizeof(header.magic));
+    header.num_vertices = graph.get_num_vertices();
+    header.num_entries = graph.get_num_entries();
+    
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(graph.get_offsets()),
+               static_cast<std::streamsize>((header.num_vertices + 1) * sizeof(int64_t)));
+    file.write(reinterpret_cast<const char*>(graph.get_neighbor_array()),
+               static_cast<std::streamsize>(header.num_entries * sizeof(int)));
+    
+    return file.good();
+}
+
+// Map a binary CSR file and expose it as a CSRGraph without copying
+bool load_csr_binary(const std::string& path, CSRGraph& graph) {
+    auto mapping = std::make_shared<MappedFile>();
+    if (!mapping->open(path)) {
+        std::cerr << "Error: Could not map file " << path << std::endl;
+        return false;
+    }
+    
+    CSRFileHeader header;
+    if (mapping->size() < sizeof(header)) {
+        std::cerr << "Error: " << path << " is too small to be a CSR file." << std::endl;
+        return false;
+    }
+    std::memcpy(&header, mapping->data(), sizeof(header));
+    
+    if (std::memcmp(header.magic, CSR_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.num_vertices <= 0 || header.num_vertices > std::numeric_limits<int>::max() ||
+        header.num_entries < 0) {
+        std::cerr << "Error: " << path << " is not a valid CSR file." << std::endl;
+        return false;
+    }
+    
+    // Compare against the bytes present by division, so a crafted num_entries
+    // cannot wrap the size computation (num_vertices <= INT_MAX keeps
+    // offsets_bytes exact)
+    const size_t offsets_bytes = static_cast<size_t>(header.num_vertices + 1) * sizeof(int64_t);
+    const size_t payload_bytes = mapping->size() - sizeof(header);
+    if (payload_bytes < offsets_bytes ||
+        static_cast<uint64_t>(header.num_entries) > (payload_bytes - offsets_bytes) / sizeof(int)) {
+        std::cerr << "Error: " << path << " is truncated (" << mapping->size() << " bytes for "
+                  << header.num_vertices << " vertices and " << header.num_entries << " entries)." << std::endl;
+        return false;
+    }
+    
+    const char* base = mapping->data() + sizeof(header);
+    const int64_t* offsets = reinterpret_cast<const int64_t*>(base);
+    const int* neighbors = reinterpret_cast<const int*>(base + offsets_bytes);
+    
+    if (offsets[0] != 0 || offsets[header.num_vertices] != header.num_entries) {
+        std::cerr << "Error: " << path << " has inconsistent offsets." << std::endl;
+        return false;
+    }
+    
+    // The kernels index with these arrays unchecked, so a corrupt or foreign
+    // file is rejected here: offsets must not decrease and every neighbor ID
+    // must be a vertex. One parallel pass over the mapped arrays.
+    const int64_t num_vertices = header.num_vertices;
+    const int64_t num_entries = header.num_entries;
+    bool bad_offsets = false;
+    bool bad_neighbors = false;
+    #pragma omp parallel reduction(||:bad_offsets, bad_neighbors)
+    {
+        #pragma omp for schedule(static) nowait
+        for (int64_t v = 0; v < num_vertices; v++) {
+            if (offsets[v] > offsets[v + 1]) bad_offsets = true;
+        }
+        #pragma omp for schedule(static) nowait
+        for (int64_t e = 0; e < num_entries; e++) {
+            if (neighbors[e] < 0 || neighbors[e] >= num_vertices) bad_neighbors = true;
+        }
+    }
+    if (bad_offsets) {
+        std::cerr << "Error: " << path << " has decreasing offsets." << std::endl;
+        return false;
+    }
+    if (bad_neighbors) {
+        std::cerr << "Error: " << path << " has neighbor IDs outside [0, " << num_vertices << ")." << std::endl;
+        return false;
+    }
+    
+    graph = CSRGraph::from_arrays(static_cast<int>(header.num_vertices), offsets, neighbors, mapping);
+    return true;
+}
+
+// Parse a SNAP-style text edge list ("u v" per line, '#' or '%' comments).
+// The mapped text is cut into one chunk per thread at line boundaries and each
+// chunk is parsed independently. Edges are treated as undirected and the vertex
+// count is the largest ID plus one.
+bool load_snap_edge_list(const std::string& path, CSRGraph& graph) {
+    MappedFile mapping;
+    if (!mapping.open(path)) {
+        std::cerr << "Error: Could not map file " << path << std::endl;
+        return false;
+    }
+    
+    const char* text = mapping.data();
+    const size_t text_size = mapping.size();
+    std::vector<std::vector<std::pair<int, int>>> thread_edges;
+    int max_vertex = -1;
+    bool malformed = false;
+    
+    #pragma omp parallel reduction(max:max_vertex) reduction(||:malformed)
+    {
+        #pragma omp single
+        thread_edges.resize(omp_get_num_threads());
+        
+        const int tid = omp_get_thread_num();
+        const int nthreads = omp_get_num_threads();
+        
+        // A chunk owns every line that starts inside its nominal byte range
+        auto next_line_start = [&](size_t pos) {
+            while (pos > 0 && pos < text_size && text[pos - 1] != '\n') pos++;
+            return pos;
+        };
+        size_t begin = next_line_start(text_size * tid / nthreads);
+        size_t end = next_line_start(text_size * (tid + 1) / nthreads);
+        
+        auto& edges = thread_edges[tid];
+        size_t pos = begin;
+        
+        while (pos < end) {
+            size_t line_end = pos;
+            while (line_end < end && text[line_end] != '\n') line_end++;
+            
+            // Skip leading whitespace, blank lines and comments
+            while (pos < line_end && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\r')) pos++;
+            if (pos < line_end && text[pos] != '#' && text[pos] != '%') {
+                long long ids[2] = {-1, -1};
+                for (int k = 0; k < 2; k++) {
+                    while (pos < line_end && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == ',')) pos++;
+                    if (pos < line_end && text[pos] >= '0' && text[pos] <= '9') {
+                        ids[k] = 0;
+                        while (pos < line_end && text[pos] >= '0' && text[pos] <= '9') {
+                            ids[k] = ids[k] * 10 + (text[pos] - '0');
+                            pos++;
+                        }
+                    }
+                }
+                
+                if (ids[0] < 0 || ids[1] < 0 ||
+                    ids[0] >= std::numeric_limits<int>::max() || ids[1] >= std::numeric_limits<int>::max()) {
+                    malformed = true;
+                } else {
+                    int u = static_cast<int>(ids[0]);
+                    int v = static_cast<int>(ids[1]);
+                    edges.emplace_back(u, v);
+                    max_vertex = std::max(max_vertex, std::max(u, v));
+                }
+            }
+            
+            pos = line_end + 1;
+        }
+    }
+    
+    if (malformed) {
+        std::cerr << "Warning: skipped malformed lines in " << path << std::endl;
+    }
+    
+    // Concatenate the per-thread edge lists in parallel
+    std::vector<size_t> starts(thread_edges.size() + 1, 0);
+    for (size_t t = 0; t < thread_edges.size(); t++) {
+        starts[t + 1] = starts[t] + thread_edges[t].size();
+    }
+    
+    std::vector<std::pair<int, int>> edges(starts.back());
+    #pragma omp parallel for schedule(static, 1)
+    for (int t = 0; t < static_cast<int>(thread_edges.size()); t++) {
+        std::copy(thread_edges[t].begin(), thread_edges[t].end(), edges.begin() + starts[t]);
+    }
+    
+    graph = CSRGraph::from_edge_list(max_vertex + 1, edges);
+    return true;
+}
+
 //==============================================================================
 // Graph Algorithms - Sequential Implementations
 //==============================================================================
+// All algorithms are templated on the graph type so they run unchanged on the
+// mutable Graph builder and on the frozen CSRGraph.
 
 // Sequential Breadth-First Search (BFS)
-std::vector<int> bfs_sequential(const Graph& graph, int start_vertex) {
+template<typename GraphT>
+std::vector<int> bfs_sequential(const GraphT& graph, int start_vertex) {
     int num_vertices = graph.get_num_vertices();
     std::vector<int> distances(num_vertices, -1); // -1 indicates unvisited
     std::queue<int> q;
@@ -223,7 +1049,8 @@ std::vector<int> bfs_sequential(const Graph& graph, int start_vertex) {
 }
 
 // Sequential Depth-First Search (DFS)
-void dfs_sequential_recursive(const Graph& graph, int vertex, std::vector<bool>& visited) {
+template<typename GraphT>
+void dfs_sequential_recursive(const GraphT& graph, int vertex, std::vector<bool>& visited) {
     visited[vertex] = true;
     
     // Simulate work
@@ -236,7 +1063,8 @@ void dfs_sequential_recursive(const Graph& graph, int vertex, std::vector<bool>&
     }
 }
 
-std::vector<bool> dfs_sequential(const Graph& graph, int start_vertex) {
+template<typename GraphT>
+std::vector<bool> dfs_sequential(const GraphT& graph, int start_vertex) {
     int num_vertices = graph.get_num_vertices();
     std::vector<bool> visited(num_vertices, false);
     
@@ -246,7 +1074,8 @@ std::vector<bool> dfs_sequential(const Graph& graph, int start_vertex) {
 }
 
 // Sequential Connected Components
-std::vector<int> connected_components_sequential(const Graph& graph) {
+template<typename GraphT>
+std::vector<int> connected_components_sequential(const GraphT& graph) {
     int num_vertices = graph.get_num_vertices();
     std::vector<int> component_ids(num_vertices, -1);
     int current_component = 0;
@@ -278,7 +1107,8 @@ std::vector<int> connected_components_sequential(const Graph& graph) {
 }
 
 // Sequential PageRank
-std::vector<double> pagerank_sequential(const Graph& graph, int iterations, double damping_factor = 0.85) {
+template<typename GraphT>
+std::vector<double> pagerank_sequential(const GraphT& graph, int iterations, double damping_factor = 0.85) {
     int num_vertices = graph.get_num_vertices();
     std::vector<double> ranks(num_vertices, 1.0 / num_vertices);
     std::vector<double> new_ranks(num_vertices, 0.0);
@@ -310,7 +1140,9 @@ std::vector<double> pagerank_sequential(const Graph& graph, int iterations, doub
 //==============================================================================
 
 // Task-based Breadth-First Search (level by level)
-std::vector<int> bfs_parallel_task(const Graph& graph, int start_vertex) {
+template<typename GraphT>
+std::vector<int> bfs_parallel_task(const GraphT& graph, int start_vertex) {
+    PERF_SCOPE("BFS (tasks)");
     int num_vertices = graph.get_num_vertices();
     std::vector<int> distances(num_vertices, -1);
     
@@ -368,7 +1200,8 @@ std::vector<int> bfs_parallel_task(const Graph& graph, int start_vertex) {
 }
 
 // Task-based Depth-First Search
-void dfs_parallel_task_recursive(const Graph& graph, int vertex, std::vector<bool>& visited, 
+template<typename GraphT>
+void dfs_parallel_task_recursive(const GraphT& graph, int vertex, std::vector<bool>& visited, 
                               int& processed_count, std::mutex& visited_mutex, int cutoff_depth = 3) {
     // Mark vertex as visited
     {
@@ -404,7 +1237,7 @@ void dfs_parallel_task_recursive(const Graph& graph, int vertex, std::vector<boo
     if (cutoff_depth > 0) {
         // Still within task creation depth, create tasks
         for (int neighbor : unvisited_neighbors) {
-            #pragma omp task
+            #pragma omp task shared(graph, visited, processed_count, visited_mutex)
             {
                 dfs_parallel_task_recursive(graph, neighbor, visited, processed_count, visited_mutex, cutoff_depth - 1);
             }
@@ -417,10 +1250,72 @@ void dfs_parallel_task_recursive(const Graph& graph, int vertex, std::vector<boo
     }
 }
 
-std::vector<bool> dfs_parallel_task(const Graph& graph, int start_vertex, int cutoff_depth = 3) {
-    int num_vertices = graph.get_num_vertices();
-    std::vector<bool> visited(num_vertices, false);
-    int processed_count = 0;
+// Task-based DFS without a cutoff depth: the granularity controller decides
+// per neighbor whether to spawn a task or recurse inline
+template<typename GraphT>
+void dfs_adaptive_recursive(const GraphT& graph, int vertex, int depth, std::vector<bool>& visited,
+                            int& processed_count, std::mutex& visited_mutex,
+                            task_utils::GranularityController& controller) {
+    {
+        std::lock_guard<std::mutex> lock(visited_mutex);
+        if (visited[vertex]) {
+            return; // Already visited by another task
+        }
+        visited[vertex] = true;
+    }
+    
+    task_utils::do_compute_work(100); // Same per-vertex work as dfs_parallel_task
+    
+    #pragma omp atomic
+    processed_count++;
+    
+    for (int neighbor : graph.get_neighbors(vertex)) {
+        bool already_visited;
+        {
+            std::lock_guard<std::mutex> lock(visited_mutex);
+            already_visited = visited[neighbor];
+        }
+        
+        if (!already_visited) {
+            GraphT const* graph_ptr = &graph;
+            std::vector<bool>* visited_ptr = &visited;
+            int* count_ptr = &processed_count;
+            std::mutex* mutex_ptr = &visited_mutex;
+            task_utils::GranularityController* controller_ptr = &controller;
+            controller.spawn_or_run(depth, [=]() {
+                dfs_adaptive_recursive(*graph_ptr, neighbor, depth + 1, *visited_ptr, *count_ptr,
+                                       *mutex_ptr, *controller_ptr);
+            });
+        }
+    }
+}
+
+template<typename GraphT>
+std::vector<bool> dfs_parallel_adaptive(const GraphT& graph, int start_vertex) {
+    PERF_SCOPE("DFS (adaptive tasks)");
+    int num_vertices = graph.get_num_vertices();
+    std::vector<bool> visited(num_vertices, false);
+    int processed_count = 0;
+    std::mutex visited_mutex;
+    task_utils::GranularityController controller;
+    
+    #pragma omp parallel
+    {
+        #pragma omp single
+        {
+            dfs_adaptive_recursive(graph, start_vertex, 0, visited, processed_count, visited_mutex, controller);
+        }
+    }
+    
+    return visited;
+}
+
+template<typename GraphT>
+std::vector<bool> dfs_parallel_task(const GraphT& graph, int start_vertex, int cutoff_depth = 3) {
+    PERF_SCOPE("DFS (tasks)");
+    int num_vertices = graph.get_num_vertices();
+    std::vector<bool> visited(num_vertices, false);
+    int processed_count = 0;
     std::mutex visited_mutex;
     
     #pragma omp parallel
@@ -435,7 +1330,9 @@ std::vector<bool> dfs_parallel_task(const Graph& graph, int start_vertex, int cu
 }
 
 // Task-based Connected Components
-std::vector<int> connected_components_parallel_task(const Graph& graph, int batch_size = 64) {
+template<typename GraphT>
+std::vector<int> connected_components_parallel_task(const GraphT& graph, int batch_size = 64) {
+    PERF_SCOPE("Connected components (tasks)");
     int num_vertices = graph.get_num_vertices();
     std::vector<int> component_ids(num_vertices, -1);
     std::atomic<int> current_component(0);
@@ -489,7 +1386,9 @@ std::vector<int> connected_components_parallel_task(const Graph& graph, int batc
 }
 
 // Task-based PageRank
-std::vector<double> pagerank_parallel_task(const Graph& graph, int iterations, double damping_factor = 0.85, int batch_size = 64) {
+template<typename GraphT>
+std::vector<double> pagerank_parallel_task(const GraphT& graph, int iterations, double damping_factor = 0.85, int batch_size = 64) {
+    PERF_SCOPE("PageRank (tasks)");
     int num_vertices = graph.get_num_vertices();
     std::vector<double> ranks(num_vertices, 1.0 / num_vertices);
     std::vector<double> new_ranks(num_vertices, 0.0);
@@ -539,7 +1438,9 @@ std::vector<double> pagerank_parallel_task(const Graph& graph, int iterations, d
 //==============================================================================
 
 // Parallel (non-task) BFS
-std::vector<int> bfs_parallel_for(const Graph& graph, int start_vertex) {
+template<typename GraphT>
+std::vector<int> bfs_parallel_for(const GraphT& graph, int start_vertex) {
+    PERF_SCOPE("BFS (parallel for)");
     int num_vertices = graph.get_num_vertices();
     std::vector<int> distances(num_vertices, -1);
     
@@ -588,7 +1489,9 @@ std::vector<int> bfs_parallel_for(const Graph& graph, int start_vertex) {
 }
 
 // Parallel Connected Components (using parallel for)
-std::vector<int> connected_components_parallel_for(const Graph& graph) {
+template<typename GraphT>
+std::vector<int> connected_components_parallel_for(const GraphT& graph) {
+    PERF_SCOPE("Connected components (parallel for)");
     int num_vertices = graph.get_num_vertices();
     std::vector<int> component_ids(num_vertices, -1);
     std::atomic<int> current_component(0);
@@ -629,7 +1532,9 @@ std::vector<int> connected_components_parallel_for(const Graph& graph) {
 }
 
 // Parallel PageRank (using parallel for)
-std::vector<double> pagerank_parallel_for(const Graph& graph, int iterations, double damping_factor = 0.85) {
+template<typename GraphT>
+std::vector<double> pagerank_parallel_for(const GraphT& graph, int iterations, double damping_factor = 0.85) {
+    PERF_SCOPE("PageRank (parallel for)");
     int num_vertices = graph.get_num_vertices();
     std::vector<double> ranks(num_vertices, 1.0 / num_vertices);
     std::vector<double> new_ranks(num_vertices, 0.0);
@@ -658,6 +1563,1040 @@ std::vector<double> pagerank_parallel_for(const Graph& graph, int iterations, do
     return ranks;
 }
 
+//==============================================================================
+// Graph Algorithms - Convergence-Aware PageRank
+//==============================================================================
+
+// Pull-based PageRank. Each vertex gathers contributions from its in-neighbors
+// (the neighbors, for an undirected graph) into its own slot, so the sweep
+// needs no atomics. Stops as soon as the L1 change between sweeps drops below
+// tolerance, or after max_iterations.
+template<typename GraphT>
+std::vector<double> pagerank_pull(const GraphT& graph, int max_iterations, double tolerance = 1e-4,
+                                  double damping_factor = 0.85, int* iterations_run = nullptr) {
+    PERF_SCOPE("PageRank (pull)");
+    const int num_vertices = graph.get_num_vertices();
+    const double base_rank = (1.0 - damping_factor) / num_vertices;
+    std::vector<double> ranks(num_vertices, 1.0 / num_vertices);
+    std::vector<double> contributions(num_vertices);
+    int iter = 0;
+    
+    while (iter < max_iterations) {
+        PERF_FRAME_BEGIN("PageRank sweep");
+        // Outgoing share of every vertex, computed once per sweep
+        #pragma omp parallel for schedule(static)
+        for (int u = 0; u < num_vertices; u++) {
+            size_t degree = graph.get_neighbors(u).size();
+            contributions[u] = degree > 0 ? damping_factor * ranks[u] / static_cast<double>(degree) : 0.0;
+        }
+        
+        double l1_change = 0.0;
+        
+        #pragma omp parallel for schedule(dynamic, 64) reduction(+:l1_change)
+        for (int v = 0; v < num_vertices; v++) {
+            double sum = base_rank;
+            for (int u : graph.get_neighbors(v)) {
+                sum += contributions[u];
+            }
+            l1_change += std::abs(sum - ranks[v]);
+            ranks[v] = sum;
+        }
+        PERF_FRAME_END("PageRank sweep");
+        PERF_COUNTER("PageRank L1 change", l1_change);
+        
+        iter++;
+        if (l1_change < tolerance) break;
+    }
+    
+    if (iterations_run) *iterations_run = iter;
+    return ranks;
+}
+
+// Delta PageRank. Starting from the uniform guess, every vertex carries a
+// signed residual (how far one more sweep would move it). Only vertices whose
+// |residual| exceeds tolerance / num_vertices fold it into their rank and push
+// it on, so converged regions of the graph stop costing work. The total mass
+// left unpropagated at exit is bounded by tolerance.
+template<typename GraphT>
+std::vector<double> pagerank_delta(const GraphT& graph, int max_iterations, double tolerance = 1e-4,
+                                   double damping_factor = 0.85, int* iterations_run = nullptr) {
+    PERF_SCOPE("PageRank (delta)");
+    const int num_vertices = graph.get_num_vertices();
+    const double epsilon = tolerance / num_vertices;
+    const double initial_rank = 1.0 / num_vertices;
+    std::vector<double> ranks(num_vertices, initial_rank);
+    std::vector<double> residuals(num_vertices);
+    std::vector<double> incoming(num_vertices, 0.0);
+    int active = 0;
+    
+    // Initial residual = one pull sweep from the uniform guess minus the guess
+    #pragma omp parallel for schedule(dynamic, 64) reduction(+:active)
+    for (int v = 0; v < num_vertices; v++) {
+        double sum = (1.0 - damping_factor) / num_vertices;
+        for (int u : graph.get_neighbors(v)) {
+            sum += damping_factor * initial_rank / static_cast<double>(graph.get_neighbors(u).size());
+        }
+        residuals[v] = sum - initial_rank;
+        if (std::abs(residuals[v]) > epsilon) active++;
+    }
+    
+    int iter = 1;
+    
+    while (active > 0 && iter < max_iterations) {
+        PERF_FRAME_BEGIN("PageRank sweep");
+        // Push phase: active vertices publish their residual to neighbors
+        #pragma omp parallel for schedule(dynamic, 64)
+        for (int v = 0; v < num_vertices; v++) {
+            double residual = residuals[v];
+            if (std::abs(residual) <= epsilon) continue;
+            
+            ranks[v] += residual;
+            residuals[v] = 0.0;
+            
+            const auto& neighbors = graph.get_neighbors(v);
+            if (!neighbors.empty()) {
+                double share = damping_factor * residual / static_cast<double>(neighbors.size());
+                for (int neighbor : neighbors) {
+                    #pragma omp atomic
+                    incoming[neighbor] += share;
+                }
+            }
+        }
+        
+        // Apply phase: fold this sweep's pushes into the residuals
+        active = 0;
+        #pragma omp parallel for schedule(static) reduction(+:active)
+        for (int v = 0; v < num_vertices; v++) {
+            residuals[v] += incoming[v];
+            incoming[v] = 0.0;
+            if (std::abs(residuals[v]) > epsilon) active++;
+        }
+        PERF_FRAME_END("PageRank sweep");
+        PERF_COUNTER("PageRank active vertices", active);
+        
+        iter++;
+    }
+    
+    // Keep the sub-threshold residuals instead of dropping them
+    #pragma omp parallel for schedule(static)
+    for (int v = 0; v < num_vertices; v++) {
+        ranks[v] += residuals[v];
+    }
+    
+    if (iterations_run) *iterations_run = iter;
+    return ranks;
+}
+
+//==============================================================================
+// Graph Algorithms - Union-Find Connected Components
+//==============================================================================
+
+// Lock-free union-find over a parent array. Parents only ever point to a
+// smaller vertex ID, so concurrent links cannot form cycles.
+namespace union_find {
+
+// Hook the larger root under the smaller one with CAS, retrying on races
+inline void link(std::atomic<int>* parent, int u, int v) {
+    int p1 = parent[u].load(std::memory_order_relaxed);
+    int p2 = parent[v].load(std::memory_order_relaxed);
+    
+    while (p1 != p2) {
+        int high = std::max(p1, p2);
+        int low = std::min(p1, p2);
+        int p_high = parent[high].load(std::memory_order_relaxed);
+        
+        // Already hooked to the same tree
+        if (p_high == low) break;
+        
+        if (p_high == high &&
+            parent[high].compare_exchange_strong(p_high, low, std::memory_order_relaxed)) {
+            break;
+        }
+        
+        // Lost the race or high was not a root: climb one level and retry
+        p1 = parent[parent[high].load(std::memory_order_relaxed)].load(std::memory_order_relaxed);
+        p2 = parent[low].load(std::memory_order_relaxed);
+    }
+}
+
+// Full path compression so every vertex points directly at its root
+inline void compress(std::atomic<int>* parent, int num_vertices) {
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (int v = 0; v < num_vertices; v++) {
+        int p = parent[v].load(std::memory_order_relaxed);
+        int gp = parent[p].load(std::memory_order_relaxed);
+        while (p != gp) {
+            parent[v].store(gp, std::memory_order_relaxed);
+            p = gp;
+            gp = parent[p].load(std::memory_order_relaxed);
+        }
+    }
+}
+
+// Most frequent root among a fixed-seed random sample of vertices
+inline int sample_frequent_root(const std::atomic<int>* parent, int num_vertices, int num_samples = 1024) {
+    std::mt19937 gen(27491095);
+    std::uniform_int_distribution<int> dist(0, num_vertices - 1);
+    std::unordered_map<int, int> counts;
+    
+    for (int i = 0; i < num_samples; i++) {
+        counts[parent[dist(gen)].load(std::memory_order_relaxed)]++;
+    }
+    
+    auto best = std::max_element(counts.begin(), counts.end(),
+        [](const std::pair<const int, int>& a, const std::pair<const int, int>& b) { return a.second < b.second; });
+    return best->first;
+}
+
+inline std::vector<int> to_labels(const std::atomic<int>* parent, int num_vertices) {
+    std::vector<int> component_ids(num_vertices);
+    #pragma omp parallel for schedule(static)
+    for (int v = 0; v < num_vertices; v++) {
+        component_ids[v] = parent[v].load(std::memory_order_relaxed);
+    }
+    return component_ids;
+}
+
+} // namespace union_find
+
+// Shiloach-Vishkin style: link every edge once, then compress.
+// One edge sweep plus one compression pass, independent of graph diameter.
+template<typename GraphT>
+std::vector<int> connected_components_union_find(const GraphT& graph) {
+    PERF_SCOPE("Connected components (union-find)");
+    const int num_vertices = graph.get_num_vertices();
+    std::unique_ptr<std::atomic<int>[]> parent(new std::atomic<int>[num_vertices]);
+    
+    #pragma omp parallel for schedule(static)
+    for (int v = 0; v < num_vertices; v++) {
+        parent[v].store(v, std::memory_order_relaxed);
+    }
+    
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (int v = 0; v < num_vertices; v++) {
+        for (int u : graph.get_neighbors(v)) {
+            // Each undirected edge appears twice; link it from one side only
+            if (u < v) {
+                union_find::link(parent.get(), v, u);
+            }
+        }
+    }
+    
+    union_find::compress(parent.get(), num_vertices);
+    return union_find::to_labels(parent.get(), num_vertices);
+}
+
+// Afforest (Sutton et al.): link only the first neighbor_rounds edges of every
+// vertex, sample the now-dominant component, and skip all vertices already in
+// it while linking the remaining edges. On graphs with a giant component most
+// edges are never touched.
+template<typename GraphT>
+std::vector<int> connected_components_afforest(const GraphT& graph, int neighbor_rounds = 2) {
+    PERF_SCOPE("Connected components (Afforest)");
+    const int num_vertices = graph.get_num_vertices();
+    if (num_vertices == 0) return {};
+    
+    std::unique_ptr<std::atomic<int>[]> parent(new std::atomic<int>[num_vertices]);
+    
+    #pragma omp parallel for schedule(static)
+    for (int v = 0; v < num_vertices; v++) {
+        parent[v].store(v, std::memory_order_relaxed);
+    }
+    
+    // Sparse sampling: one neighbor per round, compress after each round
+    for (int r = 0; r < neighbor_rounds; r++) {
+        #pragma omp parallel for schedule(dynamic, 1024)
+        for (int v = 0; v < num_vertices; v++) {
+            const auto& neighbors = graph.get_neighbors(v);
+            if (r < static_cast<int>(neighbors.size())) {
+                union_find::link(parent.get(), v, neighbors[r]);
+            }
+        }
+        union_find::compress(parent.get(), num_vertices);
+    }
+    
+    int frequent_root = union_find::sample_frequent_root(parent.get(), num_vertices);
+    
+    // Finish the remaining edges, skipping the giant component. Edges from
+    // skipped vertices are still covered from their other endpoint.
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (int v = 0; v < num_vertices; v++) {
+        if (parent[v].load(std::memory_order_relaxed) == frequent_root) continue;
+        
+        const auto& neighbors = graph.get_neighbors(v);
+        for (size_t i = neighbor_rounds; i < neighbors.size(); i++) {
+            union_find::link(parent.get(), v, neighbors[i]);
+        }
+    }
+    
+    union_find::compress(parent.get(), num_vertices);
+    return union_find::to_labels(parent.get(), num_vertices);
+}
+
+//==============================================================================
+// Graph Algorithms - Direction-Optimizing BFS
+//==============================================================================
+
+// Per-run statistics of the direction-optimizing BFS
+struct DirectionOptimizingStats {
+    int top_down_steps = 0;
+    int bottom_up_steps = 0;
+};
+
+// Direction-optimizing BFS (Beamer et al.).
+// Top-down steps push from a sparse frontier queue and claim neighbors with CAS.
+// Once the frontier's edges exceed the unexplored edges / alpha, it switches to
+// bottom-up steps where every unvisited vertex pulls from a frontier bitmap and
+// stops at the first parent found. It switches back to top-down once the
+// frontier shrinks below num_vertices / beta.
+template<typename GraphT>
+std::vector<int> bfs_direction_optimizing(const GraphT& graph, int start_vertex, int alpha = 15, int beta = 18,
+                                          DirectionOptimizingStats* stats = nullptr) {
+    PERF_SCOPE("BFS (direction-optimizing)");
+    const int num_vertices = graph.get_num_vertices();
+    const int num_words = (num_vertices + 63) / 64;
+    
+    std::unique_ptr<std::atomic<int>[]> distances(new std::atomic<int>[num_vertices]);
+    int64_t unexplored_edges = 0;
+    
+    #pragma omp parallel for schedule(static) reduction(+:unexplored_edges)
+    for (int v = 0; v < num_vertices; v++) {
+        distances[v].store(-1, std::memory_order_relaxed);
+        unexplored_edges += static_cast<int64_t>(graph.get_neighbors(v).size());
+    }
+    
+    std::vector<int> frontier(1, start_vertex);
+    std::vector<uint64_t> frontier_bits(num_words, 0);
+    std::vector<uint64_t> next_bits(num_words, 0);
+    distances[start_vertex].store(0, std::memory_order_relaxed);
+    
+    int64_t frontier_edges = static_cast<int64_t>(graph.get_neighbors(start_vertex).size());
+    int64_t frontier_size = 1;
+    bool bottom_up = false;
+    int level = 0;
+    
+    while (frontier_size > 0) {
+        // Pick the direction for this level
+        if (!bottom_up && frontier_edges > unexplored_edges / alpha) {
+            // Convert queue -> bitmap
+            std::fill(frontier_bits.begin(), frontier_bits.end(), 0);
+            for (int v : frontier) {
+                frontier_bits[v >> 6] |= (uint64_t(1) << (v & 63));
+            }
+            bottom_up = true;
+        } else if (bottom_up && frontier_size < num_vertices / beta) {
+            // Convert bitmap -> queue
+            frontier.clear();
+            for (int w = 0; w < num_words; w++) {
+                uint64_t word = frontier_bits[w];
+                while (word != 0) {
+                    int bit = 0;
+                    while (((word >> bit) & 1) == 0) bit++;
+                    frontier.push_back(w * 64 + bit);
+                    word &= word - 1;
+                }
+            }
+            bottom_up = false;
+        }
+        
+        unexplored_edges -= frontier_edges;
+        int64_t next_size = 0;
+        int64_t next_edges = 0;
+        
+        if (bottom_up) {
+            if (stats) stats->bottom_up_steps++;
+            
+            // Each thread owns whole 64-vertex words of next_bits, so no atomics are needed
+            #pragma omp parallel for schedule(dynamic, 64) reduction(+:next_size, next_edges)
+            for (int w = 0; w < num_words; w++) {
+                uint64_t word = 0;
+                int v_end = std::min(num_vertices, (w + 1) * 64);
+                
+                for (int v = w * 64; v < v_end; v++) {
+                    if (distances[v].load(std::memory_order_relaxed) != -1) continue;
+                    
+                    const auto& neighbors = graph.get_neighbors(v);
+                    for (int u : neighbors) {
+                        if (frontier_bits[u >> 6] & (uint64_t(1) << (u & 63))) {
+                            distances[v].store(level + 1, std::memory_order_relaxed);
+                            word |= uint64_t(1) << (v & 63);
+                            next_size++;
+                            next_edges += static_cast<int64_t>(neighbors.size());
+                            break;
+                        }
+                    }
+                }
+                
+                next_bits[w] = word;
+            }
+            
+            frontier_bits.swap(next_bits);
+        } else {
+            if (stats) stats->top_down_steps++;
+            std::vector<int> next_frontier;
+            
+            #pragma omp parallel reduction(+:next_edges)
+            {
+                std::vector<int> local_next;
+                
+                #pragma omp for schedule(dynamic, 64) nowait
+                for (int i = 0; i < static_cast<int>(frontier.size()); i++) {
+                    for (int neighbor : graph.get_neighbors(frontier[i])) {
+                        int expected = -1;
+                        if (distances[neighbor].load(std::memory_order_relaxed) == -1 &&
+                            distances[neighbor].compare_exchange_strong(expected, level + 1,
+                                                                        std::memory_order_relaxed)) {
+                            local_next.push_back(neighbor);
+                            next_edges += static_cast<int64_t>(graph.get_neighbors(neighbor).size());
+                        }
+                    }
+                }
+                
+                // One merge per thread per level
+                #pragma omp critical
+                next_frontier.insert(next_frontier.end(), local_next.begin(), local_next.end());
+            }
+            
+            frontier.swap(next_frontier);
+            next_size = static_cast<int64_t>(frontier.size());
+        }
+        
+        frontier_size = next_size;
+        frontier_edges = next_edges;
+        level++;
+    }
+    
+    std::vector<int> result(num_vertices);
+    #pragma omp parallel for schedule(static)
+    for (int v = 0; v < num_vertices; v++) {
+        result[v] = distances[v].load(std::memory_order_relaxed);
+    }
+    
+    return result;
+}
+
+//==============================================================================
+// Graph Algorithms - Weighted Single-Source Shortest Paths
+//==============================================================================
+// Distances are sums of edge weights (get_weight, 1 on unweighted graphs);
+// unreachable vertices stay at infinity.
+
+// Sequential Dijkstra with a binary heap and lazy deletion (the reference)
+std::vector<double> sssp_dijkstra(const CSRGraph& graph, int source) {
+    PERF_SCOPE("SSSP (Dijkstra)");
+    const int64_t* offsets = graph.get_offsets();
+    const int* neighbors = graph.get_neighbor_array();
+    std::vector<double> distances(graph.get_num_vertices(), std::numeric_limits<double>::infinity());
+    
+    using Entry = std::pair<double, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+    distances[source] = 0.0;
+    heap.push({0.0, source});
+    
+    while (!heap.empty()) {
+        auto [d, u] = heap.top();
+        heap.pop();
+        if (d > distances[u]) continue; // Superseded by a shorter path
+        
+        for (int64_t i = offsets[u]; i < offsets[u + 1]; i++) {
+            double candidate = d + graph.get_weight(i);
+            int v = neighbors[i];
+            if (candidate < distances[v]) {
+                distances[v] = candidate;
+                heap.push({candidate, v});
+            }
+        }
+    }
+    
+    return distances;
+}
+
+// Per-run statistics of delta-stepping
+struct DeltaSteppingStats {
+    int buckets = 0;            // Buckets settled
+    int light_phases = 0;       // Light-edge rounds over a bucket's frontier
+    int64_t relaxations = 0;    // Successful distance updates
+};
+
+// Each vertex's edges reordered so the light ones (weight <= delta) come
+// first; built once per run so the light phases never scan heavy edges
+struct LightHeavyEdges {
+    std::vector<int64_t> light_end;     // Vertex v's light edges are [offsets[v], light_end[v])
+    std::vector<int> targets;
+    std::vector<float> weights;
+};
+
+inline LightHeavyEdges split_light_heavy(const CSRGraph& graph, double delta) {
+    const int n = graph.get_num_vertices();
+    const int64_t* offsets = graph.get_offsets();
+    const int* neighbors = graph.get_neighbor_array();
+    
+    LightHeavyEdges edges;
+    edges.light_end.resize(n);
+    edges.targets.resize(graph.get_num_entries());
+    edges.weights.resize(graph.get_num_entries());
+    
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (int v = 0; v < n; v++) {
+        int64_t light = offsets[v];
+        int64_t heavy = offsets[v + 1];
+        for (int64_t i = offsets[v]; i < offsets[v + 1]; i++) {
+            float w = graph.get_weight(i);
+            int64_t slot = (w <= delta) ? light++ : --heavy;
+            edges.targets[slot] = neighbors[i];
+            edges.weights[slot] = w;
+        }
+        edges.light_end[v] = light;
+    }
+    
+    return edges;
+}
+
+// Lower an atomic distance to candidate; true if candidate was smaller
+inline bool relax_distance(std::atomic<double>& distance, double candidate) {
+    double current = distance.load(std::memory_order_relaxed);
+    while (candidate < current) {
+        if (distance.compare_exchange_weak(current, candidate, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Parallel delta-stepping (Meyer & Sanders). Vertices are kept in buckets of
+// width delta by tentative distance and buckets are settled in order. Within a
+// bucket, light edges are relaxed in rounds, since they can put vertices back
+// into the same bucket; the heavy edges of every vertex removed from it are
+// relaxed once afterwards, as they can only reach later buckets. Small delta
+// approaches Dijkstra (little wasted work, many rounds); large delta approaches
+// Bellman-Ford (few rounds, many re-relaxations).
+// Every thread collects the vertices it relaxes in its own bins, so insertion
+// needs no locks. A relaxation from bucket b lands at most max_weight / delta
+// buckets ahead, so the bins are a cyclic array of that many slots rather than
+// one per bucket up to the largest distance. The bins for the next bucket are
+// concatenated into a shared frontier with a prefix sum over the bin sizes.
+// A delta that is not a positive finite number has no buckets (distance / delta
+// would be NaN or infinite), so it falls back to Dijkstra; a delta so small that
+// it would need more than MAX_DELTA_BUCKETS slots is raised to the smallest
+// delta that fits.
+constexpr int64_t MAX_DELTA_BUCKETS = 1 << 16;
+
+std::vector<double> sssp_delta_stepping(const CSRGraph& graph, int source, double delta,
+                                        DeltaSteppingStats* stats = nullptr) {
+    if (!std::isfinite(delta) || delta <= 0.0) {
+        if (stats) *stats = DeltaSteppingStats();
+        return sssp_dijkstra(graph, source);
+    }
+    
+    PERF_SCOPE("SSSP (delta-stepping)");
+    const int num_vertices = graph.get_num_vertices();
+    const int64_t* offsets = graph.get_offsets();
+    const int64_t no_bucket = std::numeric_limits<int64_t>::max();
+    
+    float max_weight = 0.0f;
+    #pragma omp parallel for schedule(static) reduction(max:max_weight)
+    for (int64_t i = 0; i < graph.get_num_entries(); i++) {
+        max_weight = std::max(max_weight, graph.get_weight(i));
+    }
+    delta = std::max(delta, static_cast<double>(max_weight) / MAX_DELTA_BUCKETS);
+    // Offsets 0 .. ceil(max_weight / delta) + 1 from the current bucket, plus one
+    // slot of headroom for rounding in distance / delta
+    const int64_t num_slots = static_cast<int64_t>(std::ceil(max_weight / delta)) + 3;
+    
+    const LightHeavyEdges edges = split_light_heavy(graph, delta);
+    std::unique_ptr<std::atomic<double>[]> distances(new std::atomic<double>[num_vertices]);
+    // Light edges can put a vertex back into the bucket it was taken out of;
+    // this keeps its heavy edges to one pass per settled bucket
+    std::unique_ptr<std::atomic<bool>[]> heavy_queued(new std::atomic<bool>[num_vertices]);
+    
+    #pragma omp parallel for schedule(static)
+    for (int v = 0; v < num_vertices; v++) {
+        distances[v].store(std::numeric_limits<double>::infinity(), std::memory_order_relaxed);
+        heavy_queued[v].store(false, std::memory_order_relaxed);
+    }
+    distances[source].store(0.0, std::memory_order_relaxed);
+    
+    std::vector<int> frontier(1, source);   // Current bucket; may hold repeated or stale entries
+    std::vector<int64_t> bin_offsets;       // Per-thread positions in the next frontier
+    std::vector<int64_t> next_buckets;      // Per-thread smallest non-empty bin
+    int64_t bucket = 0;
+    int buckets = 0;
+    int light_phases = 0;
+    int64_t relaxations = 0;
+    
+    #pragma omp parallel reduction(+:relaxations)
+    {
+        const int tid = omp_get_thread_num();
+        const int num_threads = omp_get_num_threads();
+        
+        #pragma omp single
+        {
+            bin_offsets.assign(num_threads + 1, 0);
+            next_buckets.assign(num_threads, no_bucket);
+        }
+        
+        // This thread's bins; bucket b lives in slot b % num_slots
+        std::vector<std::vector<int>> local_bins(static_cast<size_t>(num_slots));
+        std::vector<int> removed;                   // Vertices this thread took out of the current bucket
+        
+        auto relax = [&](int v, double candidate) {
+            if (relax_distance(distances[v], candidate)) {
+                int64_t b = static_cast<int64_t>(candidate / delta);
+                local_bins[static_cast<size_t>(b % num_slots)].push_back(v);
+                relaxations++;
+            }
+        };
+        
+        // Replace the frontier with every thread's bin for bucket b
+        auto gather = [&](int64_t b) {
+            std::vector<int>* bin = &local_bins[static_cast<size_t>(b % num_slots)];
+            bin_offsets[tid + 1] = static_cast<int64_t>(bin->size());
+            #pragma omp barrier
+            #pragma omp single
+            {
+                for (int t = 0; t < num_threads; t++) {
+                    bin_offsets[t + 1] += bin_offsets[t];
+                }
+                frontier.resize(bin_offsets[num_threads]);
+            }
+            if (!bin->empty()) {
+                std::copy(bin->begin(), bin->end(), frontier.begin() + bin_offsets[tid]);
+                bin->clear();
+            }
+            #pragma omp barrier
+        };
+        
+        while (bucket != no_bucket) {
+            // Light phases until no thread put anything back into this bucket
+            while (!frontier.empty()) {
+                #pragma omp for schedule(dynamic, 64)
+                for (int i = 0; i < static_cast<int>(frontier.size()); i++) {
+                    int u = frontier[i];
+                    double du = distances[u].load(std::memory_order_relaxed);
+                    if (static_cast<int64_t>(du / delta) < bucket) continue; // Settled in an earlier bucket
+                    
+                    if (!heavy_queued[u].exchange(true, std::memory_order_relaxed)) {
+                        removed.push_back(u);
+                    }
+                    for (int64_t e = offsets[u]; e < edges.light_end[u]; e++) {
+                        relax(edges.targets[e], du + edges.weights[e]);
+                    }
+                }
+                
+                #pragma omp single nowait
+                light_phases++;
+                
+                gather(bucket);
+            }
+            
+            // The bucket is settled, so these distances are final
+            for (int u : removed) {
+                double du = distances[u].load(std::memory_order_relaxed);
+                for (int64_t e = edges.light_end[u]; e < offsets[u + 1]; e++) {
+                    relax(edges.targets[e], du + edges.weights[e]);
+                }
+                // Only a rounding-displaced heavy edge can reopen this bucket and improve u again
+                heavy_queued[u].store(false, std::memory_order_relaxed);
+            }
+            removed.clear();
+            
+            // Every pending entry is within num_slots buckets of this one. Search
+            // from this bucket, not the next, in case rounding put a heavy edge here
+            int64_t local_next = no_bucket;
+            for (int64_t b = bucket; b < bucket + num_slots; b++) {
+                if (!local_bins[static_cast<size_t>(b % num_slots)].empty()) {
+                    local_next = b;
+                    break;
+                }
+            }
+            next_buckets[tid] = local_next;
+            #pragma omp barrier
+            
+            #pragma omp single
+            {
+                buckets++;
+                bucket = *std::min_element(next_buckets.begin(), next_buckets.end());
+            }
+            
+            if (bucket != no_bucket) {
+                gather(bucket);
+            }
+        }
+    }
+    
+    if (stats) {
+        stats->buckets = buckets;
+        stats->light_phases = light_phases;
+        stats->relaxations = relaxations;
+    }
+    
+    std::vector<double> result(num_vertices);
+    #pragma omp parallel for schedule(static)
+    for (int v = 0; v < num_vertices; v++) {
+        result[v] = distances[v].load(std::memory_order_relaxed);
+    }
+    
+    return result;
+}
+
+//==============================================================================
+// Graph Algorithms - Triangle Counting
+//==============================================================================
+// Every triangle is counted once on the degree-ordered orientation: each edge
+// points from the endpoint of lower (degree, id) rank to the higher one, and a
+// triangle u -> v -> w, u -> w is found by intersecting the sorted out-lists
+// of u and v. High-degree vertices keep few out-edges, so no list is much
+// longer than sqrt(edges).
+
+// Number of common elements of two sorted, duplicate-free lists (scalar merge)
+inline int64_t intersect_count_scalar(const int* a, int64_t na, const int* b, int64_t nb) {
+    int64_t count = 0;
+    int64_t i = 0;
+    int64_t j = 0;
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            i++;
+        } else if (a[i] > b[j]) {
+            j++;
+        } else {
+            count++;
+            i++;
+            j++;
+        }
+    }
+    return count;
+}
+
+// Same count with compare-based SIMD merging: a block of each list is loaded,
+// every element of one block is compared against every rotation of the other,
+// and the block with the smaller last element is advanced (both on a tie).
+// The tails shorter than a block finish in the scalar merge.
+#if GRAPH_INTERSECT_AVX512
+GRAPH_AVX512_TARGET
+inline int64_t intersect_count_avx512(const int* a, int64_t na, const int* b, int64_t nb) {
+    int64_t count = 0;
+    int64_t i = 0;
+    int64_t j = 0;
+    while (i + 16 <= na && j + 16 <= nb) {
+        __m512i va = _mm512_loadu_si512(a + i);
+        __m512i vb = _mm512_loadu_si512(b + j);
+        __mmask16 match = _mm512_cmpeq_epi32_mask(va, vb);
+        for (int r = 1; r < 16; r++) {
+            vb = _mm512_alignr_epi32(vb, vb, 1);
+            match |= _mm512_cmpeq_epi32_mask(va, vb);
+        }
+        count += static_cast<int64_t>(std::bitset<16>(match).count());
+        
+        int a_last = a[i + 15];
+        int b_last = b[j + 15];
+        i += (a_last <= b_last) ? 16 : 0;
+        j += (b_last <= a_last) ? 16 : 0;
+    }
+    return count + intersect_count_scalar(a + i, na - i, b + j, nb - j);
+}
+#endif
+
+#if GRAPH_INTERSECT_AVX2
+GRAPH_AVX2_TARGET
+inline int64_t intersect_count_avx2(const int* a, int64_t na, const int* b, int64_t nb) {
+    int64_t count = 0;
+    int64_t i = 0;
+    int64_t j = 0;
+    const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    while (i + 8 <= na && j + 8 <= nb) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+        __m256i match = _mm256_cmpeq_epi32(va, vb);
+        for (int r = 1; r < 8; r++) {
+            vb = _mm256_permutevar8x32_epi32(vb, rotate);
+            match = _mm256_or_si256(match, _mm256_cmpeq_epi32(va, vb));
+        }
+        count += static_cast<int64_t>(std::bitset<8>(_mm256_movemask_ps(_mm256_castsi256_ps(match))).count());
+        
+        int a_last = a[i + 7];
+        int b_last = b[j + 7];
+        i += (a_last <= b_last) ? 8 : 0;
+        j += (b_last <= a_last) ? 8 : 0;
+    }
+    return count + intersect_count_scalar(a + i, na - i, b + j, nb - j);
+}
+#endif
+
+using IntersectCountFn = int64_t (*)(const int*, int64_t, const int*, int64_t);
+
+struct IntersectKernel {
+    IntersectCountFn count;
+    const char* name;
+};
+
+// Widest kernel this CPU runs, chosen once
+inline const IntersectKernel& intersect_kernel() {
+    static const IntersectKernel kernel = []() -> IntersectKernel {
+#if GRAPH_INTERSECT_RUNTIME_DISPATCH
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return {intersect_count_avx512, "AVX-512"};
+        if (__builtin_cpu_supports("avx2")) return {intersect_count_avx2, "AVX2"};
+#elif GRAPH_INTERSECT_AVX512
+        return {intersect_count_avx512, "AVX-512"};
+#elif GRAPH_INTERSECT_AVX2
+        return {intersect_count_avx2, "AVX2"};
+#endif
+        return {intersect_count_scalar, "scalar fallback (CPU without AVX2)"};
+    }();
+    return kernel;
+}
+
+inline const char* intersect_simd_name() {
+    return intersect_kernel().name;
+}
+
+// Degree-ordered orientation of an undirected graph, with self-loops and
+// duplicate edges removed and every out-list sorted by vertex ID
+struct OrientedGraph {
+    std::vector<int64_t> offsets;
+    std::vector<int> neighbors;
+    std::vector<int> order;         // Vertices by descending out-degree, for scheduling
+    int64_t wedges = 0;             // Paths of length two in the simple graph
+    int max_out_degree = 0;
+};
+
+OrientedGraph orient_by_degree(const CSRGraph& graph) {
+    const int n = graph.get_num_vertices();
+    auto ranks_above = [&](int u, int v) {
+        int du = graph.get_degree(u);
+        int dv = graph.get_degree(v);
+        return dv > du || (dv == du && v > u);
+    };
+    
+    // Sorted, duplicate-free neighbors of u that outrank it
+    auto out_neighbors = [&](int u, std::vector<int>& scratch, int64_t& simple_degree) {
+        scratch.clear();
+        for (int v : graph.get_neighbors(u)) {
+            if (v != u) scratch.push_back(v);
+        }
+        std::sort(scratch.begin(), scratch.end());
+        scratch.erase(std::unique(scratch.begin(), scratch.end()), scratch.end());
+        simple_degree = static_cast<int64_t>(scratch.size());
+        scratch.erase(std::remove_if(scratch.begin(), scratch.end(), [&](int v) { return !ranks_above(u, v); }),
+                      scratch.end());
+    };
+    
+    OrientedGraph dag;
+    dag.offsets.assign(n + 1, 0);
+    int64_t wedges = 0;
+    
+    #pragma omp parallel reduction(+:wedges)
+    {
+        std::vector<int> scratch;
+        #pragma omp for schedule(dynamic, 256)
+        for (int u = 0; u < n; u++) {
+            int64_t simple_degree = 0;
+            out_neighbors(u, scratch, simple_degree);
+            dag.offsets[u + 1] = static_cast<int64_t>(scratch.size());
+            wedges += simple_degree * (simple_degree - 1) / 2;
+        }
+    }
+    
+    for (int u = 0; u < n; u++) {
+        dag.max_out_degree = std::max(dag.max_out_degree, static_cast<int>(dag.offsets[u + 1]));
+        dag.offsets[u + 1] += dag.offsets[u];
+    }
+    dag.neighbors.resize(dag.offsets[n]);
+    dag.wedges = wedges;
+    
+    #pragma omp parallel
+    {
+        std::vector<int> scratch;
+        #pragma omp for schedule(dynamic, 256)
+        for (int u = 0; u < n; u++) {
+            int64_t simple_degree = 0;
+            out_neighbors(u, scratch, simple_degree);
+            std::copy(scratch.begin(), scratch.end(), dag.neighbors.begin() + dag.offsets[u]);
+        }
+    }
+    
+    // Longest lists first, so the dynamic schedule does not end on a large vertex
+    dag.order.resize(n);
+    std::iota(dag.order.begin(), dag.order.end(), 0);
+    std::stable_sort(dag.order.begin(), dag.order.end(), [&](int u, int v) {
+        return dag.offsets[u + 1] - dag.offsets[u] > dag.offsets[v + 1] - dag.offsets[v];
+    });
+    
+    return dag;
+}
+
+// Total triangle count over a degree-ordered orientation
+int64_t count_triangles(const OrientedGraph& dag, bool use_simd) {
+    PERF_SCOPE("Triangle counting");
+    const int n = static_cast<int>(dag.order.size());
+    const int64_t* offsets = dag.offsets.data();
+    const int* neighbors = dag.neighbors.data();
+    const IntersectCountFn intersect = use_simd ? intersect_kernel().count : intersect_count_scalar;
+    int64_t triangles = 0;
+    
+    #pragma omp parallel for schedule(dynamic, 16) reduction(+:triangles)
+    for (int i = 0; i < n; i++) {
+        int u = dag.order[i];
+        const int* u_list = neighbors + offsets[u];
+        int64_t u_size = offsets[u + 1] - offsets[u];
+        
+        for (int64_t k = 0; k < u_size; k++) {
+            int v = u_list[k];
+            const int* v_list = neighbors + offsets[v];
+            int64_t v_size = offsets[v + 1] - offsets[v];
+            triangles += intersect(u_list, u_size, v_list, v_size);
+        }
+    }
+    
+    return triangles;
+}
+
+//==============================================================================
+// Vertex Reordering
+//==============================================================================
+// A reordering is a permutation new_ids[old_vertex] = new_vertex. The graph is
+// relabeled once, kernels run on the relabeled copy, and per-vertex results are
+// mapped back to the original labels with map_to_original_labels.
+
+enum class ReorderStrategy {
+    DEGREE_SORT,     // Descending degree, so hubs share cache lines
+    HUB_CLUSTERING,  // Above-average-degree vertices first, original order kept otherwise
+    RCM              // Reverse Cuthill-McKee, reduces bandwidth of the adjacency matrix
+};
+
+inline std::string reorder_strategy_name(ReorderStrategy strategy) {
+    switch (strategy) {
+        case ReorderStrategy::DEGREE_SORT: return "Degree sort";
+        case ReorderStrategy::HUB_CLUSTERING: return "Hub clustering";
+        case ReorderStrategy::RCM: return "Reverse Cuthill-McKee";
+        default: return "Unknown";
+    }
+}
+
+// Descending-degree order (ties keep the original order)
+std::vector<int> degree_sort_order(const CSRGraph& graph) {
+    const int n = graph.get_num_vertices();
+    std::vector<int> by_degree(n);
+    std::iota(by_degree.begin(), by_degree.end(), 0);
+    std::stable_sort(by_degree.begin(), by_degree.end(),
+                     [&](int a, int b) { return graph.get_degree(a) > graph.get_degree(b); });
+    
+    std::vector<int> new_ids(n);
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; i++) {
+        new_ids[by_degree[i]] = i;
+    }
+    return new_ids;
+}
+
+// Hub clustering: a stable partition into hubs and non-hubs, computed with a
+// per-thread count and prefix sum so the relative order inside each group is kept
+std::vector<int> hub_clustering_order(const CSRGraph& graph) {
+    const int n = graph.get_num_vertices();
+    const double threshold = graph.get_average_degree();
+    std::vector<int> new_ids(n);
+    std::vector<int> hub_counts;
+    int total_hubs = 0;
+    
+    #pragma omp parallel
+    {
+        const int tid = omp_get_thread_num();
+        const int nthreads = omp_get_num_threads();
+        const int begin = static_cast<int>(static_cast<int64_t>(n) * tid / nthreads);
+        const int end = static_cast<int>(static_cast<int64_t>(n) * (tid + 1) / nthreads);
+        
+        #pragma omp single
+        hub_counts.assign(nthreads + 1, 0);
+        
+        int local_hubs = 0;
+        for (int v = begin; v < end; v++) {
+            if (graph.get_degree(v) > threshold) local_hubs++;
+        }
+        hub_counts[tid + 1] = local_hubs;
+        
+        #pragma omp barrier
+        #pragma omp single
+        {
+            for (int t = 0; t < nthreads; t++) {
+                hub_counts[t + 1] += hub_counts[t];
+            }
+            total_hubs = hub_counts[nthreads];
+        }
+        
+        int next_hub = hub_counts[tid];
+        int next_other = total_hubs + (begin - hub_counts[tid]);
+        for (int v = begin; v < end; v++) {
+            new_ids[v] = graph.get_degree(v) > threshold ? next_hub++ : next_other++;
+        }
+    }
+    
+    return new_ids;
+}
+
+// Reverse Cuthill-McKee: BFS from a low-degree vertex of each component,
+// enqueuing neighbors by increasing degree, then reverse the visit order
+std::vector<int> rcm_order(const CSRGraph& graph) {
+    const int n = graph.get_num_vertices();
+    std::vector<int> visit_order;
+    visit_order.reserve(n);
+    std::vector<bool> visited(n, false);
+    
+    // Component start candidates in increasing degree order
+    std::vector<int> by_degree(n);
+    std::iota(by_degree.begin(), by_degree.end(), 0);
+    std::stable_sort(by_degree.begin(), by_degree.end(),
+                     [&](int a, int b) { return graph.get_degree(a) < graph.get_degree(b); });
+    
+    std::vector<int> scratch;
+    for (int root : by_degree) {
+        if (visited[root]) continue;
+        
+        size_t head = visit_order.size();
+        visit_order.push_back(root);
+        visited[root] = true;
+        
+        while (head < visit_order.size()) {
+            int current = visit_order[head++];
+            scratch.clear();
+            for (int neighbor : graph.get_neighbors(current)) {
+                if (!visited[neighbor]) {
+                    visited[neighbor] = true;
+                    scratch.push_back(neighbor);
+                }
+            }
+            std::sort(scratch.begin(), scratch.end(),
+                      [&](int a, int b) { return graph.get_degree(a) < graph.get_degree(b); });
+            visit_order.insert(visit_order.end(), scratch.begin(), scratch.end());
+        }
+    }
+    
+    std::vector<int> new_ids(n);
+    for (int i = 0; i < n; i++) {
+        new_ids[visit_order[i]] = n - 1 - i;
+    }
+    return new_ids;
+}
+
+std::vector<int> compute_reordering(const CSRGraph& graph, ReorderStrategy strategy) {
+    switch (strategy) {
+        case ReorderStrategy::DEGREE_SORT: return degree_sort_order(graph);
+        case ReorderStrategy::HUB_CLUSTERING: return hub_clustering_order(graph);
+        case ReorderStrategy::RCM: return rcm_order(graph);
+        default: return {};
+    }
+}
+
+// result[old] = relabeled_result[new_ids[old]]
+template<typename T>
+std::vector<T> map_to_original_labels(const std::vector<T>& relabeled_result, const std::vector<int>& new_ids) {
+    std::vector<T> result(relabeled_result.size());
+    #pragma omp parallel for schedule(static)
+    for (int v = 0; v < static_cast<int>(new_ids.size()); v++) {
+        result[v] = relabeled_result[new_ids[v]];
+    }
+    return result;
+}
+
 //==============================================================================
 // Benchmarking Functions
 //==============================================================================
@@ -741,8 +2680,27 @@ bool are_pageranks_equivalent(const std::vector<double>& pr1, const std::vector<
     return true;
 }
 
+// Check if two weighted distance arrays agree (both unreachable, or within a relative tolerance)
+bool are_weighted_distances_equivalent(const std::vector<double>& dist1, const std::vector<double>& dist2,
+                                       double tolerance = 1e-9) {
+    if (dist1.size() != dist2.size()) {
+        return false;
+    }
+    
+    for (size_t i = 0; i < dist1.size(); i++) {
+        if (std::isinf(dist1[i]) || std::isinf(dist2[i])) {
+            if (dist1[i] != dist2[i]) return false;
+        } else if (std::abs(dist1[i] - dist2[i]) > tolerance * std::max(1.0, std::abs(dist1[i]))) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
 // Benchmark BFS algorithm
-void benchmark_bfs(const Graph& graph, int start_vertex, int num_threads) {
+template<typename GraphT>
+void benchmark_bfs(const GraphT& graph, int start_vertex, int num_threads) {
     std::cout << "\nBenchmarking Breadth-First Search from vertex " << start_vertex << ":" << std::endl;
     std::cout << "--------------------------------------------------" << std::endl;
     
@@ -782,10 +2740,26 @@ void benchmark_bfs(const Graph& graph, int start_vertex, int num_threads) {
     std::cout << "Task-based BFS: " << std::fixed << std::setprecision(4) << task_time << " seconds" 
               << " (speedup: " << std::fixed << std::setprecision(2) << task_speedup << "x)" 
               << (task_correct ? "" : " - INCORRECT") << std::endl;
+    
+    // Direction-optimizing (top-down / bottom-up) BFS
+    DirectionOptimizingStats do_stats;
+    start_time = std::chrono::high_resolution_clock::now();
+    auto do_distances = bfs_direction_optimizing(graph, start_vertex, 15, 18, &do_stats);
+    end_time = std::chrono::high_resolution_clock::now();
+    double do_time = std::chrono::duration<double>(end_time - start_time).count();
+    
+    bool do_correct = are_distances_equivalent(seq_distances, do_distances);
+    double do_speedup = seq_time / do_time;
+    
+    std::cout << "Direction-optimizing BFS: " << std::fixed << std::setprecision(4) << do_time << " seconds" 
+              << " (speedup: " << std::fixed << std::setprecision(2) << do_speedup << "x, "
+              << do_stats.top_down_steps << " top-down / " << do_stats.bottom_up_steps << " bottom-up steps)" 
+              << (do_correct ? "" : " - INCORRECT") << std::endl;
 }
 
 // Benchmark DFS algorithm
-void benchmark_dfs(const Graph& graph, int start_vertex, int num_threads) {
+template<typename GraphT>
+void benchmark_dfs(const GraphT& graph, int start_vertex, int num_threads) {
     std::cout << "\nBenchmarking Depth-First Search from vertex " << start_vertex << ":" << std::endl;
     std::cout << "--------------------------------------------------" << std::endl;
     
@@ -818,10 +2792,23 @@ void benchmark_dfs(const Graph& graph, int start_vertex, int num_threads) {
                   << " (speedup: " << std::fixed << std::setprecision(2) << task_speedup << "x)" 
                   << (task_correct ? "" : " - INCORRECT") << std::endl;
     }
+    
+    // Adaptive granularity: no cutoff to pick
+    start_time = std::chrono::high_resolution_clock::now();
+    auto adaptive_visited = dfs_parallel_adaptive(graph, start_vertex);
+    end_time = std::chrono::high_resolution_clock::now();
+    double adaptive_time = std::chrono::duration<double>(end_time - start_time).count();
+    
+    int adaptive_count = static_cast<int>(std::count(adaptive_visited.begin(), adaptive_visited.end(), true));
+    std::cout << "Adaptive task-based DFS: " 
+              << std::fixed << std::setprecision(4) << adaptive_time << " seconds" 
+              << " (speedup: " << std::fixed << std::setprecision(2) << seq_time / adaptive_time << "x)" 
+              << (adaptive_count == visited_count ? "" : " - INCORRECT") << std::endl;
 }
 
 // Benchmark Connected Components algorithm
-void benchmark_connected_components(const Graph& graph, int num_threads) {
+template<typename GraphT>
+void benchmark_connected_components(const GraphT& graph, int num_threads) {
     std::cout << "\nBenchmarking Connected Components:" << std::endl;
     std::cout << "--------------------------------------------------" << std::endl;
     
@@ -868,10 +2855,38 @@ void benchmark_connected_components(const Graph& graph, int num_threads) {
                   << " (speedup: " << std::fixed << std::setprecision(2) << task_speedup << "x)" 
                   << (task_correct ? "" : " - INCORRECT") << std::endl;
     }
+    
+    // Union-find variants (diameter-independent number of passes)
+    start_time = std::chrono::high_resolution_clock::now();
+    auto uf_components = connected_components_union_find(graph);
+    end_time = std::chrono::high_resolution_clock::now();
+    double uf_time = std::chrono::duration<double>(end_time - start_time).count();
+    
+    bool uf_correct = are_components_equivalent(seq_components, uf_components) &&
+                      count_components(uf_components) == num_components;
+    
+    std::cout << "Union-Find Connected Components: " << std::fixed << std::setprecision(4) 
+              << uf_time << " seconds" 
+              << " (speedup: " << std::fixed << std::setprecision(2) << seq_time / uf_time << "x)" 
+              << (uf_correct ? "" : " - INCORRECT") << std::endl;
+    
+    start_time = std::chrono::high_resolution_clock::now();
+    auto afforest_components = connected_components_afforest(graph);
+    end_time = std::chrono::high_resolution_clock::now();
+    double afforest_time = std::chrono::duration<double>(end_time - start_time).count();
+    
+    bool afforest_correct = are_components_equivalent(seq_components, afforest_components) &&
+                            count_components(afforest_components) == num_components;
+    
+    std::cout << "Afforest Connected Components: " << std::fixed << std::setprecision(4) 
+              << afforest_time << " seconds" 
+              << " (speedup: " << std::fixed << std::setprecision(2) << seq_time / afforest_time << "x)" 
+              << (afforest_correct ? "" : " - INCORRECT") << std::endl;
 }
 
 // Benchmark PageRank algorithm
-void benchmark_pagerank(const Graph& graph, int num_threads, int iterations = 20) {
+template<typename GraphT>
+void benchmark_pagerank(const GraphT& graph, int num_threads, int iterations = 20, double tolerance = 1e-4) {
     std::cout << "\nBenchmarking PageRank (" << iterations << " iterations):" << std::endl;
     std::cout << "--------------------------------------------------" << std::endl;
     
@@ -916,10 +2931,258 @@ void benchmark_pagerank(const Graph& graph, int num_threads, int iterations = 20
                   << " (speedup: " << std::fixed << std::setprecision(2) << task_speedup << "x)" 
                   << (task_correct ? "" : " - INCORRECT") << std::endl;
     }
+    
+    // Convergence-aware variants: stop at the L1 tolerance instead of a fixed count
+    int pull_iterations = 0;
+    start_time = std::chrono::high_resolution_clock::now();
+    auto pull_pagerank = pagerank_pull(graph, iterations, tolerance, 0.85, &pull_iterations);
+    end_time = std::chrono::high_resolution_clock::now();
+    double pull_time = std::chrono::duration<double>(end_time - start_time).count();
+    
+    // Same update rule as the push kernels, so it must match them sweep for sweep
+    bool pull_correct = are_pageranks_equivalent(pagerank_sequential(graph, pull_iterations), pull_pagerank);
+    
+    std::cout << "Pull PageRank (tol=" << std::scientific << std::setprecision(0) << tolerance << "): " 
+              << std::fixed << std::setprecision(4) << pull_time << " seconds, "
+              << pull_iterations << " iterations"
+              << " (speedup: " << std::fixed << std::setprecision(2) << seq_time / pull_time << "x)" 
+              << (pull_correct ? "" : " - INCORRECT") << std::endl;
+    
+    int delta_iterations = 0;
+    start_time = std::chrono::high_resolution_clock::now();
+    auto delta_pagerank = pagerank_delta(graph, iterations * 4, tolerance, 0.85, &delta_iterations);
+    end_time = std::chrono::high_resolution_clock::now();
+    double delta_time = std::chrono::duration<double>(end_time - start_time).count();
+    
+    // Compare against a tightly converged pull solution
+    auto reference_pagerank = pagerank_pull(graph, iterations * 10, tolerance * 1e-3);
+    bool delta_correct = are_pageranks_equivalent(reference_pagerank, delta_pagerank);
+    
+    std::cout << "Delta PageRank (tol=" << std::scientific << std::setprecision(0) << tolerance << "): " 
+              << std::fixed << std::setprecision(4) << delta_time << " seconds, "
+              << delta_iterations << " iterations"
+              << " (speedup: " << std::fixed << std::setprecision(2) << seq_time / delta_time << "x)" 
+              << (delta_correct ? "" : " - INCORRECT") << std::endl;
+}
+
+// Benchmark delta-stepping SSSP against sequential Dijkstra over a range of
+// delta values and thread counts
+void benchmark_sssp(const CSRGraph& graph, int source, int num_threads) {
+    std::cout << "\nBenchmarking Weighted SSSP from vertex " << source << ":" << std::endl;
+    std::cout << "--------------------------------------------------" << std::endl;
+    
+    std::vector<double> reference;
+    double dijkstra_time = task_utils::measure_time([&]() { reference = sssp_dijkstra(graph, source); });
+    int reached = static_cast<int>(std::count_if(reference.begin(), reference.end(),
+                                                 [](double d) { return !std::isinf(d); }));
+    
+    std::cout << "Sequential Dijkstra: " << std::fixed << std::setprecision(4) << dijkstra_time << " seconds" << std::endl;
+    std::cout << "Reached " << reached << " vertices out of " << graph.get_num_vertices() << std::endl;
+    
+    // Meyer & Sanders suggest delta ~ max weight / max degree; the average degree
+    // is the practical version, and the sweep brackets it on both sides
+    float max_weight = 0.0f;
+    #pragma omp parallel for schedule(static) reduction(max:max_weight)
+    for (int64_t i = 0; i < graph.get_num_entries(); i++) {
+        max_weight = std::max(max_weight, graph.get_weight(i));
+    }
+    // An edgeless or zero-weight graph gives no usable estimate; any positive delta works there
+    double base_delta = max_weight / std::max(1.0, graph.get_average_degree());
+    if (!std::isfinite(base_delta) || base_delta <= 0.0) {
+        base_delta = 1.0;
+    }
+    
+    std::vector<int> thread_counts;
+    for (int t = 1; t < num_threads; t *= 2) {
+        thread_counts.push_back(t);
+    }
+    thread_counts.push_back(num_threads);
+    
+    std::cout << std::right << std::setw(10) << "Delta" << std::setw(9) << "Threads" << std::setw(12) << "Time(s)"
+              << std::setw(10) << "Speedup" << std::setw(9) << "Buckets" << std::setw(8) << "Light"
+              << std::setw(14) << "Relaxations" << std::endl;
+    
+    for (double factor : {0.25, 1.0, 4.0, 16.0}) {
+        const double delta = base_delta * factor;
+        
+        for (int threads : thread_counts) {
+            omp_set_num_threads(threads);
+            DeltaSteppingStats stats;
+            std::vector<double> distances;
+            double time = task_utils::measure_time([&]() {
+                distances = sssp_delta_stepping(graph, source, delta, &stats);
+            });
+            
+            bool correct = are_weighted_distances_equivalent(reference, distances);
+            
+            std::cout << std::setw(10) << std::fixed << std::setprecision(2) << delta
+                      << std::setw(9) << threads << std::setw(12) << std::setprecision(4) << time
+                      << std::setw(9) << std::setprecision(2) << dijkstra_time / time << "x"
+                      << std::setw(9) << stats.buckets << std::setw(8) << stats.light_phases
+                      << std::setw(14) << stats.relaxations << (correct ? "" : " - INCORRECT") << std::endl;
+        }
+    }
+    
+    omp_set_num_threads(num_threads);
+}
+
+// Benchmark triangle counting with the scalar and the SIMD intersection
+void benchmark_triangle_counting(const CSRGraph& graph, int num_threads) {
+    std::cout << "\nBenchmarking Triangle Counting (SIMD intersection: " << intersect_simd_name() << "):" << std::endl;
+    std::cout << "--------------------------------------------------" << std::endl;
+    
+    omp_set_num_threads(num_threads);
+    OrientedGraph dag;
+    double orient_time = task_utils::measure_time([&]() { dag = orient_by_degree(graph); });
+    
+    std::cout << "Degree ordering: " << std::fixed << std::setprecision(4) << orient_time << " seconds"
+              << " (max out-degree " << dag.max_out_degree << ")" << std::endl;
+    
+    int64_t reference = 0;
+    double reference_time = 0.0;
+    
+    std::cout << std::left << std::setw(10) << "Kernel" << std::right << std::setw(9) << "Threads"
+              << std::setw(12) << "Time(s)" << std::setw(10) << "Speedup" << std::setw(14) << "Triangles" << std::endl;
+    
+    for (int threads : {1, num_threads}) {
+        for (bool use_simd : {false, true}) {
+            omp_set_num_threads(threads);
+            int64_t triangles = 0;
+            double time = task_utils::measure_time([&]() { triangles = count_triangles(dag, use_simd); });
+            
+            // The first run (scalar, one thread) is the baseline for speedup and correctness
+            if (reference_time == 0.0) {
+                reference = triangles;
+                reference_time = time;
+            }
+            
+            std::cout << std::left << std::setw(10) << (use_simd ? "SIMD" : "Scalar") << std::right
+                      << std::setw(9) << threads << std::setw(12) << std::fixed << std::setprecision(4) << time
+                      << std::setw(9) << std::setprecision(2) << reference_time / time << "x"
+                      << std::setw(14) << triangles << (triangles == reference ? "" : " - INCORRECT") << std::endl;
+        }
+        
+        if (num_threads == 1) break;
+    }
+    
+    // Global clustering coefficient (transitivity): closed wedges over all wedges
+    double transitivity = dag.wedges > 0 ? 3.0 * static_cast<double>(reference) / dag.wedges : 0.0;
+    std::cout << "Global clustering coefficient: " << std::fixed << std::setprecision(6) << transitivity << std::endl;
+    
+    omp_set_num_threads(num_threads);
+}
+
+// Compare adjacency-list and CSR storage on the same traversal kernels
+void benchmark_storage_layouts(const Graph& graph, const CSRGraph& csr, int start_vertex, int num_threads,
+                               int pagerank_iterations = 20) {
+    std::cout << "\nBenchmarking Storage Layouts (adjacency list vs CSR):" << std::endl;
+    std::cout << "--------------------------------------------------" << std::endl;
+    
+    omp_set_num_threads(num_threads);
+    
+    double adj_bfs_time = task_utils::measure_time([&]() { bfs_parallel_for(graph, start_vertex); });
+    double csr_bfs_time = task_utils::measure_time([&]() { bfs_parallel_for(csr, start_vertex); });
+    bool bfs_correct = are_distances_equivalent(bfs_sequential(graph, start_vertex),
+                                                bfs_parallel_for(csr, start_vertex));
+    
+    std::cout << "Parallel For BFS: adjacency " << std::fixed << std::setprecision(4) << adj_bfs_time
+              << "s, CSR " << csr_bfs_time << "s (speedup: " << std::fixed << std::setprecision(2)
+              << adj_bfs_time / csr_bfs_time << "x)" << (bfs_correct ? "" : " - INCORRECT") << std::endl;
+    
+    double adj_pr_time = task_utils::measure_time([&]() { pagerank_parallel_for(graph, pagerank_iterations); });
+    double csr_pr_time = task_utils::measure_time([&]() { pagerank_parallel_for(csr, pagerank_iterations); });
+    bool pr_correct = are_pageranks_equivalent(pagerank_sequential(graph, pagerank_iterations),
+                                               pagerank_parallel_for(csr, pagerank_iterations));
+    
+    std::cout << "Parallel For PageRank: adjacency " << std::fixed << std::setprecision(4) << adj_pr_time
+              << "s, CSR " << csr_pr_time << "s (speedup: " << std::fixed << std::setprecision(2)
+              << adj_pr_time / csr_pr_time << "x)" << (pr_correct ? "" : " - INCORRECT") << std::endl;
+}
+
+// Measure what each reordering costs and what it buys the main kernels
+void benchmark_reordering(const CSRGraph& graph, int start_vertex, int num_threads, int pagerank_iterations = 20) {
+    std::cout << "\nBenchmarking Vertex Reordering:" << std::endl;
+    std::cout << "--------------------------------------------------" << std::endl;
+    
+    omp_set_num_threads(num_threads);
+    
+    // Baseline kernels on the original labels (tolerance 0 forces a fixed sweep count)
+    std::vector<double> base_pagerank;
+    std::vector<int> base_distances;
+    std::vector<int> base_components;
+    double base_pr_time = task_utils::measure_time([&]() {
+        base_pagerank = pagerank_pull(graph, pagerank_iterations, 0.0);
+    });
+    double base_bfs_time = task_utils::measure_time([&]() {
+        base_distances = bfs_direction_optimizing(graph, start_vertex);
+    });
+    double base_cc_time = task_utils::measure_time([&]() {
+        base_components = connected_components_afforest(graph);
+    });
+    double base_total = base_pr_time + base_bfs_time + base_cc_time;
+    
+    std::cout << std::left << std::setw(24) << "Ordering" << std::right
+              << std::setw(12) << "Reorder(s)" << std::setw(12) << "PageRank(s)"
+              << std::setw(10) << "BFS(s)" << std::setw(10) << "CC(s)"
+              << std::setw(10) << "Speedup" << std::setw(14) << "Break-even" << std::endl;
+    std::cout << std::left << std::setw(24) << "Original" << std::right << std::fixed << std::setprecision(4)
+              << std::setw(12) << 0.0 << std::setw(12) << base_pr_time
+              << std::setw(10) << base_bfs_time << std::setw(10) << base_cc_time
+              << std::setw(10) << "1.00x" << std::setw(14) << "-" << std::endl;
+    
+    const ReorderStrategy strategies[] = {ReorderStrategy::DEGREE_SORT, ReorderStrategy::HUB_CLUSTERING,
+                                          ReorderStrategy::RCM};
+    
+    for (ReorderStrategy strategy : strategies) {
+        std::vector<int> new_ids;
+        CSRGraph reordered;
+        double reorder_time = task_utils::measure_time([&]() {
+            new_ids = compute_reordering(graph, strategy);
+            reordered = graph.relabeled(new_ids);
+        });
+        
+        std::vector<double> pagerank;
+        std::vector<int> distances;
+        std::vector<int> components;
+        double pr_time = task_utils::measure_time([&]() {
+            pagerank = pagerank_pull(reordered, pagerank_iterations, 0.0);
+        });
+        double bfs_time = task_utils::measure_time([&]() {
+            distances = bfs_direction_optimizing(reordered, new_ids[start_vertex]);
+        });
+        double cc_time = task_utils::measure_time([&]() {
+            components = connected_components_afforest(reordered);
+        });
+        
+        // Results mapped back to the original labels must match the baseline
+        bool correct = are_pageranks_equivalent(base_pagerank, map_to_original_labels(pagerank, new_ids)) &&
+                       map_to_original_labels(distances, new_ids) == base_distances &&
+                       are_components_equivalent(base_components, map_to_original_labels(components, new_ids));
+        
+        double total = pr_time + bfs_time + cc_time;
+        double saved_per_run = base_total - total;
+        std::ostringstream break_even;
+        if (saved_per_run > 0) {
+            break_even << std::fixed << std::setprecision(1) << reorder_time / saved_per_run << " runs";
+        } else {
+            break_even << "never";
+        }
+        
+        std::ostringstream speedup;
+        speedup << std::fixed << std::setprecision(2) << base_total / total << "x";
+        
+        std::cout << std::left << std::setw(24) << reorder_strategy_name(strategy) << std::right
+                  << std::fixed << std::setprecision(4)
+                  << std::setw(12) << reorder_time << std::setw(12) << pr_time
+                  << std::setw(10) << bfs_time << std::setw(10) << cc_time
+                  << std::setw(10) << speedup.str() << std::setw(14) << break_even.str()
+                  << (correct ? "" : " - INCORRECT") << std::endl;
+    }
 }
 
 // Run all benchmarks
-void run_benchmarks(const Graph& graph, int num_threads) {
+template<typename GraphT>
+void run_benchmarks(const GraphT& graph, int num_threads) {
     // Choose a start vertex for traversal algorithms (use vertex 0)
     int start_vertex = 0;
     
@@ -929,6 +3192,17 @@ void run_benchmarks(const Graph& graph, int num_threads) {
     benchmark_connected_components(graph, num_threads);
     benchmark_pagerank(graph, num_threads);
     
+    if constexpr (std::is_same<GraphT, CSRGraph>::value) {
+        benchmark_reordering(graph, start_vertex, num_threads);
+        benchmark_sssp(graph.has_weights() ? graph : assign_random_weights(graph), start_vertex, num_threads);
+        benchmark_triangle_counting(graph, num_threads);
+    } else {
+        CSRGraph csr(graph);
+        benchmark_reordering(csr, start_vertex, num_threads);
+        benchmark_sssp(assign_random_weights(csr), start_vertex, num_threads);
+        benchmark_triangle_counting(csr, num_threads);
+    }
+    
     // Display overall performance summary
     std::cout << "\nOverall Performance Summary:" << std::endl;
     std::cout << "--------------------------------------------------" << std::endl;
@@ -954,17 +3228,106 @@ int main(int argc, char* argv[]) {
     int num_vertices = 1000;
     int num_edges = 5000;
     int num_threads = omp_get_max_threads();
-    int graph_type = 0;  // 0=random, 1=scale-free, 2=grid
+    // 0=random, 1=scale-free, 2=grid, 3=binary CSR file, 4=SNAP edge list,
+    // 5=parallel random, 6=parallel scale-free, 7=R-MAT (parallel generators build CSR directly)
+    int graph_type = 0;
     int seed = 42;
+    std::string graph_file;  // input for types 3/4, optional output for generated graphs
+    bool run_all = false;    // false = BFS only, true = every benchmark in run_benchmarks
     
     if (argc > 1) num_vertices = std::stoi(argv[1]);
     if (argc > 2) num_edges = std::stoi(argv[2]);
     if (argc > 3) num_threads = std::stoi(argv[3]);
     if (argc > 4) graph_type = std::stoi(argv[4]);
+    if (argc > 5) graph_file = argv[5];
+    if (argc > 6) run_all = std::stoi(argv[6]) != 0;
     
     std::cout << "=== OpenMP Graph Processing with Task Parallelism ===" << std::endl;
-    std::cout << "Number of vertices: " << num_vertices << std::endl;
     std::cout << "Number of threads: " << num_threads << std::endl;
+    omp_set_num_threads(num_threads);
+    
+    // Load a stored graph straight into CSR form
+    if (graph_type == 3 || graph_type == 4) {
+        if (graph_file.empty()) {
+            std::cerr << "Graph type " << graph_type << " requires a file path argument" << std::endl;
+            return 1;
+        }
+        
+        CSRGraph csr;
+        bool loaded = false;
+        double load_time = task_utils::measure_time([&]() {
+            loaded = (graph_type == 3) ? load_csr_binary(graph_file, csr) : load_snap_edge_list(graph_file, csr);
+        });
+        if (!loaded) {
+            return 1;
+        }
+        
+        std::cout << "Graph type: " << (graph_type == 3 ? "Binary CSR file" : "SNAP edge list") 
+                  << " (" << graph_file << ")" << std::endl;
+        std::cout << "Load time: " << std::fixed << std::setprecision(4) << load_time << " seconds" << std::endl;
+        
+        if (csr.get_num_vertices() == 0) {
+            std::cerr << "Error: " << graph_file << " has no vertices." << std::endl;
+            return 1;
+        }
+        
+        csr.print_stats();
+        if (run_all) {
+            run_benchmarks(csr, num_threads);
+        } else {
+            benchmark_bfs(csr, 0, num_threads);
+        }
+        return 0;
+    }
+    
+    // Parallel generators: same graph for a given seed at any thread count
+    if (graph_type >= 5 && graph_type <= 7) {
+        std::function<CSRGraph()> generate;
+        
+        if (graph_type == 5) {
+            std::cout << "Graph type: Random (parallel generator)" << std::endl;
+            generate = [&]() { return generate_random_graph_parallel(num_vertices, num_edges, seed); };
+        } else if (graph_type == 6) {
+            std::cout << "Graph type: Scale-free (parallel generator)" << std::endl;
+            generate = [&]() { return generate_scale_free_graph_parallel(num_vertices, 2, seed); };
+        } else {
+            int scale = 1;
+            while ((1 << scale) < num_vertices) scale++;
+            int edge_factor = std::max(1, num_edges / (1 << scale));
+            std::cout << "Graph type: R-MAT (scale " << scale << ", edge factor " << edge_factor << ")" << std::endl;
+            generate = [&, scale, edge_factor]() { return generate_rmat_graph(scale, edge_factor, seed); };
+        }
+        
+        CSRGraph csr;
+        double generation_time = task_utils::measure_time([&]() { csr = generate(); });
+        std::cout << "Generation time: " << std::fixed << std::setprecision(4) << generation_time 
+                  << " seconds" << std::endl;
+        
+        // Regenerate single-threaded to confirm the output does not depend on the team size
+        omp_set_num_threads(1);
+        bool deterministic = are_graphs_identical(csr, generate());
+        omp_set_num_threads(num_threads);
+        std::cout << "Identical to single-threaded generation: " << (deterministic ? "yes" : "NO") << std::endl;
+        
+        if (!graph_file.empty() && save_csr_binary(csr, graph_file)) {
+            std::cout << "Saved binary CSR graph to " << graph_file << std::endl;
+        }
+        
+        if (csr.get_num_vertices() == 0) {
+            std::cerr << "Error: the generated graph has no vertices." << std::endl;
+            return 1;
+        }
+        
+        csr.print_stats();
+        if (run_all) {
+            run_benchmarks(csr, num_threads);
+        } else {
+            benchmark_bfs(csr, 0, num_threads);
+        }
+        return 0;
+    }
+    
+    std::cout << "Number of vertices: " << num_vertices << std::endl;
     
     // Generate the appropriate graph
     Graph graph(num_vertices);
@@ -998,12 +3361,29 @@ int main(int argc, char* argv[]) {
             return 1;
     }
     
+    // Freeze the builder into CSR form; all kernels below run on the frozen graph
+    CSRGraph csr;
+    double freeze_time = task_utils::measure_time([&]() { csr = CSRGraph(graph); });
+    std::cout << "CSR freeze time: " << std::fixed << std::setprecision(4) << freeze_time << " seconds" << std::endl;
+    
+    // Store the frozen graph so later runs can map it instead of regenerating
+    if (!graph_file.empty()) {
+        if (save_csr_binary(csr, graph_file)) {
+            std::cout << "Saved binary CSR graph to " << graph_file << std::endl;
+        }
+    }
+    
     // Print graph statistics
-    graph.print_stats();
+    csr.print_stats();
     
-    // Run only BFS benchmark
     int start_vertex = 0;
-    benchmark_bfs(graph, start_vertex, num_threads);
+    if (run_all) {
+        run_benchmarks(csr, num_threads);
+    } else {
+        // Run only BFS benchmark
+        benchmark_bfs(csr, start_vertex, num_threads);
+    }
+    benchmark_storage_layouts(graph, csr, start_vertex, num_threads);
     
     return 0;
-}
\ No newline at end of file
+}
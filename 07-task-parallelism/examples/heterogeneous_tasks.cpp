@@ -10,9 +10,34 @@
 #include <thread>
 #include <mutex>
 #include <atomic>
+#include <map>
+#include <cstdlib>
+#include <set>
 #include <omp.h>
 #include "../include/task_utils.h"
 
+// Coroutine scheduler (execute_coroutines) when built as C++20
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#include <condition_variable>
+#include <deque>
+#include <queue>
+#define HETEROGENEOUS_HAVE_COROUTINES 1
+#else
+#define HETEROGENEOUS_HAVE_COROUTINES 0
+#endif
+
+// Processor topology for sizing the memory worker set
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fstream>
+#include <filesystem>
+#endif
+
 //==============================================================================
 // Task Type Definitions
 //==============================================================================
@@ -63,6 +88,7 @@ struct TaskExecution {
 class TaskExecutionRecorder {
 private:
     std::vector<TaskExecution> executions;
+    std::map<int, std::string> worker_classes; // Worker id -> resource class (resource-class scheduler only)
     std::mutex recorder_mutex;
     double program_start_time;
     
@@ -74,10 +100,18 @@ public:
     void reset() {
         std::lock_guard<std::mutex> lock(recorder_mutex);
         executions.clear();
+        worker_classes.clear();
         program_start_time = omp_get_wtime();
         std::cout << "Task recorder reset. Ready to record new executions." << std::endl;
     }
     
+    // Tag a worker with the resource class it serves; enables the per-class
+    // section of print_thread_utilization
+    void set_worker_class(int thread_id, const std::string& class_name) {
+        std::lock_guard<std::mutex> lock(recorder_mutex);
+        worker_classes[thread_id] = class_name;
+    }
+    
     void record_start(const HeterogeneousTask& task, int thread_id) {
         double current_time = omp_get_wtime() - program_start_time;
         
@@ -279,7 +313,13 @@ public:
         
         // Print timeline for each thread
         for (const auto& [thread_id, thread_executions] : executions_by_thread) {
-            std::cout << std::setw(6) << thread_id << " |";
+            auto class_it = worker_classes.find(thread_id);
+            if (class_it != worker_classes.end()) {
+                // Prefix the resource class initial so worker sets are visible
+                std::cout << class_it->second[0] << std::setw(5) << thread_id << " |";
+            } else {
+                std::cout << std::setw(6) << thread_id << " |";
+            }
             
             std::vector<char> timeline(timeline_width, ' ');
             
@@ -308,6 +348,44 @@ public:
         
         // Print legend
         std::cout << "Legend: C = Compute, M = Memory, I = IO, X = Mixed\n";
+        
+        if (!worker_classes.empty()) {
+            print_class_utilization(executions_by_thread, max_time);
+        }
+    }
+    
+    // Busy fraction of each resource class: sum of task time on the class's
+    // workers divided by (workers x makespan)
+    void print_class_utilization(const std::map<int, std::vector<TaskExecution>>& executions_by_thread,
+                                 double max_time) const {
+        std::map<std::string, int> class_workers;
+        std::map<std::string, int> class_tasks;
+        std::map<std::string, double> class_busy;
+        
+        for (const auto& [thread_id, class_name] : worker_classes) {
+            class_workers[class_name]++;
+            auto it = executions_by_thread.find(thread_id);
+            if (it == executions_by_thread.end()) continue;
+            for (const auto& exec : it->second) {
+                class_tasks[class_name]++;
+                class_busy[class_name] += exec.end_time - exec.start_time;
+            }
+        }
+        
+        std::cout << "\nUtilization By Resource Class:" << std::endl;
+        std::cout << "----------------------------------------------" << std::endl;
+        std::cout << "Class    | Workers | Tasks | Busy (s) | Util %" << std::endl;
+        std::cout << "----------------------------------------------" << std::endl;
+        
+        for (const auto& [class_name, workers] : class_workers) {
+            double busy = class_busy[class_name];
+            double util = (max_time > 0.0) ? busy / (workers * max_time) * 100.0 : 0.0;
+            std::cout << std::setw(8) << class_name << " | "
+                      << std::setw(7) << workers << " | "
+                      << std::setw(5) << class_tasks[class_name] << " | "
+                      << std::fixed << std::setprecision(3) << std::setw(8) << busy << " | "
+                      << std::fixed << std::setprecision(1) << std::setw(5) << util << "%" << std::endl;
+        }
     }
     
 private:
@@ -341,13 +419,22 @@ TaskExecutionRecorder recorder;
 // Task Execution Functions
 //==============================================================================
 
+// Workers that are not OpenMP threads (the resource-class scheduler's I/O
+// workers) set this so their records do not collide with OpenMP thread ids
+thread_local int external_worker_id = -1;
+
+// Id used when recording a task: the external worker id if set, else the OpenMP thread number
+int current_worker_id() {
+    return external_worker_id >= 0 ? external_worker_id : omp_get_thread_num();
+}
+
 // Memory for memory-bound tasks
 const int MEMORY_SIZE = 100 * 1024 * 1024; // 100 MB
 std::vector<int> global_memory(MEMORY_SIZE);
 
 // Execute a compute-bound task
 void execute_compute_task(const HeterogeneousTask& task) {
-    int thread_id = omp_get_thread_num();
+    int thread_id = current_worker_id();
     
     // Record start
     recorder.record_start(task, thread_id);
@@ -361,7 +448,7 @@ void execute_compute_task(const HeterogeneousTask& task) {
 
 // Execute a memory-bound task
 void execute_memory_task(const HeterogeneousTask& task) {
-    int thread_id = omp_get_thread_num();
+    int thread_id = current_worker_id();
     
     // Record start
     recorder.record_start(task, thread_id);
@@ -396,7 +483,7 @@ void execute_memory_task(const HeterogeneousTask& task) {
 
 // Execute an I/O-bound task (simulated with sleep)
 void execute_io_task(const HeterogeneousTask& task) {
-    int thread_id = omp_get_thread_num();
+    int thread_id = current_worker_id();
     
     // Record start
     recorder.record_start(task, thread_id);
@@ -408,17 +495,11 @@ void execute_io_task(const HeterogeneousTask& task) {
     recorder.record_end(task.id, thread_id);
 }
 
-// Execute a mixed task (compute + memory + I/O)
-void execute_mixed_task(const HeterogeneousTask& task) {
-    int thread_id = omp_get_thread_num();
-    
-    // Record start
-    recorder.record_start(task, thread_id);
-    
-    // Distribute work amount across different resource types
+// Compute and memory parts of a mixed task: half its work is compute, a
+// quarter memory and the last quarter I/O (mixed_io_milliseconds)
+void do_mixed_cpu_work(const HeterogeneousTask& task) {
     int compute_work = task.work_amount / 2;
     int memory_work = task.work_amount / 4;
-    int io_work = task.work_amount / 4;
     
     // Compute part
     task_utils::do_compute_work(compute_work);
@@ -430,21 +511,49 @@ void execute_mixed_task(const HeterogeneousTask& task) {
             local_data[j] += i;
         }
     }
+}
+
+int mixed_io_milliseconds(const HeterogeneousTask& task) {
+    return task.work_amount / 4;
+}
+
+// Execute a mixed task (compute + memory + I/O)
+void execute_mixed_task(const HeterogeneousTask& task) {
+    int thread_id = current_worker_id();
+    
+    // Record start
+    recorder.record_start(task, thread_id);
+    
+    do_mixed_cpu_work(task);
     
     // I/O part (simulated)
-    std::this_thread::sleep_for(std::chrono::milliseconds(io_work));
+    std::this_thread::sleep_for(std::chrono::milliseconds(mixed_io_milliseconds(task)));
     
     // Record end
     recorder.record_end(task.id, thread_id);
 }
 
+// Progress line printed as a task starts
+void announce_task(const HeterogeneousTask& task) {
+    #pragma omp critical(cout)
+    {
+        std::cout << "Executing task " << task.id << " of type " << task.get_type_string() << std::endl;
+    }
+}
+
+// Error line for a task that threw
+void report_task_error(const HeterogeneousTask& task, const std::exception& e) {
+    #pragma omp critical(cerr)
+    {
+        std::cerr << "Error executing task " << task.id << " (" << task.get_type_string() 
+                  << "): " << e.what() << std::endl;
+    }
+}
+
 // Execute a task based on its type
 void execute_task(const HeterogeneousTask& task) {
     try {
-        #pragma omp critical(cout)
-        {
-            std::cout << "Executing task " << task.id << " of type " << task.get_type_string() << std::endl;
-        }
+        announce_task(task);
         
         switch (task.type) {
             case TaskType::ComputeBound:
@@ -467,11 +576,7 @@ void execute_task(const HeterogeneousTask& task) {
                 break;
         }
     } catch (const std::exception& e) {
-        #pragma omp critical(cerr)
-        {
-            std::cerr << "Error executing task " << task.id << " (" << task.get_type_string() 
-                      << "): " << e.what() << std::endl;
-        }
+        report_task_error(task, e);
     }
 }
 
@@ -1041,6 +1146,364 @@ void execute_adaptive(const std::vector<HeterogeneousTask>& tasks, int num_threa
     }
 }
 
+// Memory workers per socket (command-line argument 6); 0 derives the count
+// from the cores per socket
+int memory_workers_per_socket = 0;
+
+// I/O tasks mostly wait, so they get more workers than cores
+const int IO_OVERSUBSCRIPTION = 4;
+
+struct SocketTopology {
+    int sockets;
+    int cores_per_socket;
+};
+
+// Sockets and physical cores per socket, read from sysfs on Linux and from
+// GetLogicalProcessorInformation on Windows. Elsewhere, or if that fails, the
+// OpenMP places are used when OMP_PLACES=sockets, else one socket holding
+// every processor.
+SocketTopology detect_socket_topology() {
+    int sockets = 0;
+    int cores = 0;
+#ifdef _WIN32
+    DWORD length = 0;
+    GetLogicalProcessorInformation(nullptr, &length);
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    if (!info.empty() && GetLogicalProcessorInformation(info.data(), &length)) {
+        for (const auto& entry : info) {
+            if (entry.Relationship == RelationProcessorPackage) sockets++;
+            if (entry.Relationship == RelationProcessorCore) cores++;
+        }
+    }
+#else
+    // One (package, core) pair per physical core; offline CPUs have no topology entry
+    std::set<int> packages;
+    std::set<std::pair<int, int>> package_cores;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator("/sys/devices/system/cpu", error)) {
+        const std::string name = entry.path().filename().string();
+        if (name.size() < 4 || name.compare(0, 3, "cpu") != 0 ||
+            name.find_first_not_of("0123456789", 3) != std::string::npos) {
+            continue;
+        }
+        int package = -1, core = -1;
+        std::ifstream package_file(entry.path() / "topology" / "physical_package_id");
+        std::ifstream core_file(entry.path() / "topology" / "core_id");
+        if (package_file >> package && core_file >> core) {
+            packages.insert(package);
+            package_cores.insert({package, core});
+        }
+    }
+    sockets = static_cast<int>(packages.size());
+    cores = static_cast<int>(package_cores.size());
+#endif
+    
+    if (sockets <= 0 || cores <= 0) {
+        sockets = 1;
+        const char* places_env = std::getenv("OMP_PLACES");
+        if (omp_get_num_places() > 0 && omp_get_proc_bind() != omp_proc_bind_false &&
+            places_env != nullptr && std::string(places_env) == "sockets") {
+            sockets = omp_get_num_places();
+        }
+        cores = omp_get_num_procs();
+    }
+    return {sockets, std::max(1, cores / sockets)};
+}
+
+// Execute tasks on separate worker sets per resource class:
+//   - memory-bound tasks on a capped number of threads per socket, so they
+//     cannot flood the memory system and stall the compute tasks. A socket's
+//     bandwidth is usually saturated by about half its cores, so the default
+//     cap is cores_per_socket / 2 (memory_workers_per_socket overrides it);
+//   - compute-bound and mixed tasks on the remaining OpenMP threads;
+//   - I/O tasks on oversubscribed std::thread workers outside the OpenMP team,
+//     so a sleeping I/O task never holds a core.
+// Memory workers join the compute queue once the memory queue is empty; compute
+// workers never take memory tasks, which keeps the bandwidth cap intact.
+void execute_resource_classes(const std::vector<HeterogeneousTask>& tasks, int num_threads) {
+    std::cout << "\nExecuting tasks with resource-class worker sets..." << std::endl;
+    
+    std::vector<const HeterogeneousTask*> compute_queue, memory_queue, io_queue;
+    for (const auto& task : tasks) {
+        switch (task.type) {
+            case TaskType::MemoryBound: memory_queue.push_back(&task); break;
+            case TaskType::IOBound: io_queue.push_back(&task); break;
+            default: compute_queue.push_back(&task); break; // Mixed tasks are mostly compute
+        }
+    }
+    
+    // Size the worker sets
+    const SocketTopology topology = detect_socket_topology();
+    const int per_socket = memory_workers_per_socket > 0 ? memory_workers_per_socket
+                                                         : std::max(1, topology.cores_per_socket / 2);
+    int memory_workers = 0;
+    if (!memory_queue.empty()) {
+        memory_workers = std::min(per_socket * topology.sockets, std::max(1, num_threads / 2));
+        memory_workers = std::min(memory_workers, static_cast<int>(memory_queue.size()));
+    }
+    int compute_workers = std::max(1, num_threads - memory_workers);
+    int io_workers = std::min(IO_OVERSUBSCRIPTION * num_threads, static_cast<int>(io_queue.size()));
+    
+    std::cout << "Worker sets: " 
+              << compute_workers << " compute, "
+              << memory_workers << " memory (" << topology.sockets << " socket(s), up to "
+              << per_socket << " per socket), "
+              << io_workers << " I/O (oversubscribed)" << std::endl;
+    
+    std::atomic<size_t> next_compute(0), next_memory(0), next_io(0);
+    std::atomic<int> completed_tasks(0);
+    
+    // Claim and run tasks from a queue until it is empty
+    auto drain = [&completed_tasks](const std::vector<const HeterogeneousTask*>& queue,
+                                    std::atomic<size_t>& next) {
+        for (size_t i = next.fetch_add(1); i < queue.size(); i = next.fetch_add(1)) {
+            execute_task(*queue[i]);
+            completed_tasks++;
+        }
+    };
+    
+    // I/O workers: plain threads with ids after the OpenMP team's
+    std::vector<std::thread> io_threads;
+    for (int w = 0; w < io_workers; w++) {
+        int worker_id = compute_workers + memory_workers + w;
+        recorder.set_worker_class(worker_id, "IO");
+        io_threads.emplace_back([&, worker_id]() {
+            external_worker_id = worker_id;
+            drain(io_queue, next_io);
+        });
+    }
+    
+    // OpenMP team: threads [0, memory_workers) serve the memory class, the rest compute
+    for (int t = 0; t < memory_workers + compute_workers; t++) {
+        recorder.set_worker_class(t, t < memory_workers ? "Memory" : "Compute");
+    }
+    
+    #pragma omp parallel num_threads(memory_workers + compute_workers)
+    {
+        int tid = omp_get_thread_num();
+        if (tid < memory_workers) {
+            drain(memory_queue, next_memory);
+        }
+        drain(compute_queue, next_compute);
+    }
+    
+    for (auto& worker : io_threads) {
+        worker.join();
+    }
+    
+    std::cout << "Completed " << completed_tasks << " tasks" << std::endl;
+}
+
+#if HETEROGENEOUS_HAVE_COROUTINES
+
+//==============================================================================
+// Coroutine-Based Asynchronous Execution
+//==============================================================================
+
+// Coroutine for one task. It starts suspended, runs on whichever team thread
+// resumes it and frees its own frame when it returns.
+struct AsyncTask {
+    struct promise_type {
+        AsyncTask get_return_object() {
+            return AsyncTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+    
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Runs coroutine tasks on an OpenMP team. A task that awaits I/O suspends,
+// and its thread goes on to the next ready task instead of sleeping; the
+// completion puts the task back in the ready queue. Completions come from a
+// timer thread that stands in for the I/O latency; an epoll, io_uring or IOCP
+// backend would push the same handles when a real operation finishes.
+class AsyncExecutor {
+private:
+    struct Timer {
+        std::chrono::steady_clock::time_point deadline;
+        std::coroutine_handle<> handle;
+        
+        bool operator>(const Timer& other) const { return deadline > other.deadline; }
+    };
+    
+    int num_threads;
+    
+    std::mutex ready_mutex;
+    std::condition_variable ready_cv;
+    std::deque<std::coroutine_handle<>> ready;
+    int pending = 0;    // Spawned tasks that have not finished
+    
+    std::mutex timer_mutex;
+    std::condition_variable timer_cv;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+    bool stopping = false;
+    std::thread timer_thread;   // Last, so it starts after the members it uses
+    
+    void make_ready(std::coroutine_handle<> handle) {
+        {
+            std::lock_guard<std::mutex> lock(ready_mutex);
+            ready.push_back(handle);
+        }
+        ready_cv.notify_one();
+    }
+    
+    void add_timer(std::chrono::steady_clock::time_point deadline, std::coroutine_handle<> handle) {
+        {
+            std::lock_guard<std::mutex> lock(timer_mutex);
+            timers.push({deadline, handle});
+        }
+        timer_cv.notify_one();
+    }
+    
+    // Hand every expired timer's coroutine to the team
+    void timer_loop() {
+        std::unique_lock<std::mutex> lock(timer_mutex);
+        while (!stopping) {
+            if (timers.empty()) {
+                timer_cv.wait(lock);
+            } else if (std::chrono::steady_clock::now() < timers.top().deadline) {
+                // Copy: wait_until rereads it after relocking, and a push while
+                // unlocked can reallocate the queue's storage
+                const auto deadline = timers.top().deadline;
+                timer_cv.wait_until(lock, deadline);
+            } else {
+                std::coroutine_handle<> handle = timers.top().handle;
+                timers.pop();
+                lock.unlock();
+                make_ready(handle);
+                lock.lock();
+            }
+        }
+    }
+    
+public:
+    explicit AsyncExecutor(int threads) : num_threads(threads), timer_thread([this]() { timer_loop(); }) {}
+    
+    ~AsyncExecutor() {
+        {
+            std::lock_guard<std::mutex> lock(timer_mutex);
+            stopping = true;
+        }
+        timer_cv.notify_one();
+        timer_thread.join();
+    }
+    
+    AsyncExecutor(const AsyncExecutor&) = delete;
+    AsyncExecutor& operator=(const AsyncExecutor&) = delete;
+    
+    // Awaitable that resumes the coroutine after duration without holding a thread
+    auto sleep_for(std::chrono::milliseconds duration) {
+        struct Awaiter {
+            AsyncExecutor& executor;
+            std::chrono::steady_clock::time_point deadline;
+            
+            bool await_ready() const noexcept { return false; }
+            // The timer thread may resume the coroutine before this returns,
+            // so nothing here touches the frame after add_timer
+            void await_suspend(std::coroutine_handle<> handle) { executor.add_timer(deadline, handle); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{*this, std::chrono::steady_clock::now() + duration};
+    }
+    
+    void spawn(AsyncTask task) {
+        {
+            std::lock_guard<std::mutex> lock(ready_mutex);
+            pending++;
+            ready.push_back(task.handle);
+        }
+        ready_cv.notify_one();
+    }
+    
+    // Called by each task as its last statement
+    void finish() {
+        std::lock_guard<std::mutex> lock(ready_mutex);
+        if (--pending == 0) {
+            ready_cv.notify_all();
+        }
+    }
+    
+    // Resume ready tasks on the team until every spawned task has finished
+    void run() {
+        #pragma omp parallel num_threads(num_threads)
+        {
+            while (true) {
+                std::coroutine_handle<> next;
+                {
+                    std::unique_lock<std::mutex> lock(ready_mutex);
+                    ready_cv.wait(lock, [this]() { return !ready.empty() || pending == 0; });
+                    if (ready.empty()) break;
+                    next = ready.front();
+                    ready.pop_front();
+                }
+                next.resume();
+            }
+        }
+    }
+};
+
+// One task as a coroutine. Compute and memory tasks run straight through;
+// I/O waits, including the I/O part of mixed tasks, are awaited. Tasks that
+// suspend are recorded against suspended_worker_id, as they hold no thread
+// while they wait and may finish on a different one.
+AsyncTask run_task_async(AsyncExecutor& executor, const HeterogeneousTask& task, int suspended_worker_id) {
+    try {
+        announce_task(task);
+        
+        switch (task.type) {
+            case TaskType::ComputeBound:
+                execute_compute_task(task);
+                break;
+            case TaskType::MemoryBound:
+                execute_memory_task(task);
+                break;
+            case TaskType::IOBound:
+                recorder.record_start(task, suspended_worker_id);
+                co_await executor.sleep_for(std::chrono::milliseconds(task.work_amount));
+                recorder.record_end(task.id, suspended_worker_id);
+                break;
+            case TaskType::Mixed:
+                recorder.record_start(task, suspended_worker_id);
+                do_mixed_cpu_work(task);
+                co_await executor.sleep_for(std::chrono::milliseconds(mixed_io_milliseconds(task)));
+                recorder.record_end(task.id, suspended_worker_id);
+                break;
+        }
+    } catch (const std::exception& e) {
+        report_task_error(task, e);
+    }
+    
+    executor.finish();
+}
+
+// Execute tasks as coroutines on one OpenMP team; I/O suspends instead of
+// blocking a worker, so compute and memory tasks keep the team busy meanwhile
+void execute_coroutines(const std::vector<HeterogeneousTask>& tasks, int num_threads) {
+    std::cout << "\nExecuting tasks as coroutines (I/O suspends instead of sleeping)..." << std::endl;
+    
+    // Waits overlap, so this pseudo-worker's utilization is the average number
+    // of tasks suspended at once and can exceed 100%
+    const int suspended_worker_id = num_threads;
+    for (int t = 0; t < num_threads; t++) {
+        recorder.set_worker_class(t, "Team");
+    }
+    recorder.set_worker_class(suspended_worker_id, "Suspended");
+    
+    AsyncExecutor executor(num_threads);
+    for (const auto& task : tasks) {
+        executor.spawn(run_task_async(executor, task, suspended_worker_id));
+    }
+    executor.run();
+    
+    std::cout << "Completed " << tasks.size() << " tasks" << std::endl;
+}
+
+#endif // HETEROGENEOUS_HAVE_COROUTINES
+
 //==============================================================================
 // Performance Comparison Functions
 //==============================================================================
@@ -1079,6 +1542,10 @@ void compare_scheduling_approaches(const std::vector<HeterogeneousTask>& tasks,
     [[maybe_unused]] double priority_time = test_approach("Priority", execute_priority);
     [[maybe_unused]] double binding_time = test_approach("Thread Binding", execute_thread_binding);
     [[maybe_unused]] double adaptive_time = test_approach("Adaptive", execute_adaptive);
+    [[maybe_unused]] double class_time = test_approach("Resource Class", execute_resource_classes);
+#if HETEROGENEOUS_HAVE_COROUTINES
+    double coroutine_time = test_approach("Coroutine", execute_coroutines);
+#endif
     
     // Print summary
     std::cout << "\nPerformance Summary:" << std::endl;
@@ -1093,6 +1560,13 @@ void compare_scheduling_approaches(const std::vector<HeterogeneousTask>& tasks,
                   << std::fixed << std::setprecision(2) << std::setw(17) << speedup << "x" << std::endl;
     }
     
+#if HETEROGENEOUS_HAVE_COROUTINES
+    std::cout << "\nCoroutine makespan vs. adaptive: " << std::fixed << std::setprecision(2)
+              << adaptive_time / coroutine_time << "x faster" << std::endl;
+#else
+    std::cout << "\n(Build as C++20 to add the coroutine scheduler to this comparison)" << std::endl;
+#endif
+    
     // Visualize the results
     std::vector<double> execution_times;
     std::vector<std::string> approach_names;
@@ -1112,6 +1586,8 @@ void compare_scheduling_approaches(const std::vector<HeterogeneousTask>& tasks,
     std::cout << "3. Limit the number of concurrent memory-bound or I/O-bound tasks" << std::endl;
     std::cout << "4. Consider adaptive approaches that balance different task types" << std::endl;
     std::cout << "5. Use thread binding for NUMA systems or when tasks have specific resource requirements" << std::endl;
+    std::cout << "6. Give each resource class its own workers: cap memory-bound threads, oversubscribe I/O" << std::endl;
+    std::cout << "7. Let I/O suspend (coroutines, async completions) instead of blocking a worker" << std::endl;
 }
 
 //==============================================================================
@@ -1124,13 +1600,15 @@ int main(int argc, char* argv[]) {
     int min_work = 50;
     int max_work = 200; // Reduced from 500 to be more reasonable
     int num_threads = omp_get_max_threads();
-    int scheduling_type = 0;  // 0=compare all, 1=naive, 2=grouped, 3=priority, 4=binding, 5=adaptive
+    int scheduling_type = 0;  // 0=compare all, 1=naive, 2=grouped, 3=priority, 4=binding, 5=adaptive,
+                              // 6=resource class, 7=coroutines (C++20 builds)
     
     if (argc > 1) num_tasks = std::min(atoi(argv[1]), 100); // Limit max tasks
     if (argc > 2) num_threads = std::min(atoi(argv[2]), 32); // Limit max threads
-    if (argc > 3) scheduling_type = std::min(atoi(argv[3]), 5); // Ensure valid scheduling type
+    if (argc > 3) scheduling_type = std::min(atoi(argv[3]), 7); // Ensure valid scheduling type
     if (argc > 4) min_work = std::min(std::max(10, atoi(argv[4])), 1000); // Keep work amount reasonable
     if (argc > 5) max_work = std::min(std::max(min_work, atoi(argv[5])), 1000); // Keep max work reasonable
+    if (argc > 6) memory_workers_per_socket = std::max(0, atoi(argv[6])); // 0 = half the cores per socket
     
     // Set the number of OpenMP threads
     omp_set_num_threads(num_threads);
@@ -1191,6 +1669,21 @@ int main(int argc, char* argv[]) {
                 execute_adaptive(tasks, num_threads);
                 recorder.print_statistics();
                 break;
+            case 6:  // Resource-class worker sets
+                recorder.reset();
+                execute_resource_classes(tasks, num_threads);
+                recorder.print_statistics();
+                break;
+            case 7:  // Coroutines
+#if HETEROGENEOUS_HAVE_COROUTINES
+                recorder.reset();
+                execute_coroutines(tasks, num_threads);
+                recorder.print_statistics();
+#else
+                std::cerr << "The coroutine scheduler needs a C++20 build" << std::endl;
+                return 1;
+#endif
+                break;
             default:  // Compare all approaches
                 compare_scheduling_approaches(tasks, num_threads);
                 break;
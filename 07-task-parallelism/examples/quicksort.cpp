@@ -8,6 +8,8 @@
 #include <stdexcept>
 #include <string>
 #include <utility>
+#include "../include/task_utils.h"
+#include "../include/parallel_sort.h"
 
 // Partition function for quicksort
 int partition(std::vector<int>& arr, int low, int high) {
@@ -40,7 +42,7 @@ void quicksort_sequential(std::vector<int>& arr, int low, int high) {
     if (low < high) {
         int pi = partition(arr, low, high);
         // Extra check to ensure partition returned a valid value
-        if (pi > low && pi < high) {
+        if (pi >= low && pi <= high) {
             quicksort_sequential(arr, low, pi - 1);
             quicksort_sequential(arr, pi + 1, high);
         }
@@ -106,6 +108,100 @@ void quicksort_parallel(std::vector<int>& arr, int cutoff) {
     }
 }
 
+// Work-stealing quicksort: same partitioning and cutoffs as quicksort_task,
+// with the two halves forked through the custom Chase-Lev pool
+void quicksort_work_stealing(task_utils::WorkStealingPool& pool, std::vector<int>& arr, int low, int high, int cutoff) {
+    // Boundary check
+    if (low < 0 || high < 0 || low >= static_cast<int>(arr.size()) || high >= static_cast<int>(arr.size())) {
+        return;
+    }
+    
+    if (low < high) {
+        if (high - low < cutoff) {
+            quicksort_sequential(arr, low, high);
+            return;
+        }
+        
+        int pi = partition(arr, low, high);
+        if (pi <= low || pi >= high) {
+            quicksort_sequential(arr, low, high);
+            return;
+        }
+        
+        pool.join([&]() { quicksort_work_stealing(pool, arr, low, pi - 1, cutoff); },
+                  [&]() { quicksort_work_stealing(pool, arr, pi + 1, high, cutoff); });
+    }
+}
+
+// Wrapper for work-stealing quicksort
+void quicksort_work_stealing_parallel(task_utils::WorkStealingPool& pool, std::vector<int>& arr, int cutoff) {
+    pool.run([&]() {
+        quicksort_work_stealing(pool, arr, 0, static_cast<int>(arr.size()) - 1, cutoff);
+    });
+}
+
+// Quicksort without a hand-picked cutoff: the granularity controller decides
+// at every level whether the left half becomes a task or is sorted inline
+void quicksort_adaptive(std::vector<int>& arr, int low, int high, int depth, task_utils::GranularityController& controller) {
+    if (high - low < parallel_sort::INSERTION_SORT_CUTOFF) {
+        if (low < high) parallel_sort::insertion_sort(arr, low, high);
+        return;
+    }
+    
+    // Below the learned spawn depth, finish the range sequentially
+    if (controller.past_spawn_limit(depth)) {
+        quicksort_sequential(arr, low, high);
+        return;
+    }
+    
+    int pi = partition(arr, low, high);
+    
+    bool spawned = controller.spawn_or_run(depth, [&arr, &controller, low, pi, depth]() {
+        quicksort_adaptive(arr, low, pi - 1, depth + 1, controller);
+    });
+    
+    quicksort_adaptive(arr, pi + 1, high, depth + 1, controller);
+    
+    if (spawned) {
+        #pragma omp taskwait
+    }
+}
+
+// Wrapper for adaptive quicksort
+void quicksort_adaptive_parallel(std::vector<int>& arr) {
+    task_utils::GranularityController controller;
+    
+    #pragma omp parallel
+    {
+        #pragma omp single
+        {
+            quicksort_adaptive(arr, 0, static_cast<int>(arr.size()) - 1, 0, controller);
+        }
+    }
+}
+
+// Run the selected parallel sort engine; cutoff is the sequential threshold for
+// the task variants and the minimum bucket size for sample sort (radix sort has none)
+void parallel_sort_dispatch(parallel_sort::SortAlgorithm algorithm, std::vector<int>& arr, int cutoff) {
+    switch (algorithm) {
+        case parallel_sort::SortAlgorithm::LOMUTO_TASK:
+            quicksort_parallel(arr, cutoff);
+            break;
+        case parallel_sort::SortAlgorithm::THREE_WAY_TASK:
+            parallel_sort::quicksort_3way_parallel(arr, cutoff);
+            break;
+        case parallel_sort::SortAlgorithm::SAMPLE_SORT:
+            parallel_sort::sample_sort(arr, cutoff);
+            break;
+        case parallel_sort::SortAlgorithm::RADIX_SORT:
+            parallel_sort::radix_sort(arr);
+            break;
+        case parallel_sort::SortAlgorithm::MERGE_SORT:
+            parallel_sort::merge_sort_parallel(arr, cutoff);
+            break;
+    }
+}
+
 // Function to check if a vector is sorted
 bool is_sorted(const std::vector<int>& arr) {
     return std::is_sorted(arr.begin(), arr.end());
@@ -135,10 +231,12 @@ double measure_time(Func func, Args... args) {
 }
 
 // Function to analyze cutoff impact
-void analyze_cutoff_impact(int size, [[maybe_unused]] int num_threads) {
-    std::cout << "\nAnalyzing cutoff impact on array size " << size << ":" << std::endl;
+void analyze_cutoff_impact(int size, int num_threads,
+                           parallel_sort::SortAlgorithm algorithm = parallel_sort::SortAlgorithm::LOMUTO_TASK) {
+    std::cout << "\nAnalyzing cutoff impact on array size " << size
+              << " (" << parallel_sort::algorithm_name(algorithm) << "):" << std::endl;
     std::cout << "--------------------------------------------------" << std::endl;
-    std::cout << "Cutoff | Time (s) | Speedup" << std::endl;
+    std::cout << "Cutoff | Time (s) | Speedup | WS Time (s) | WS Speedup" << std::endl;
     std::cout << "--------------------------------------------------" << std::endl;
     
     // Generate a large random array
@@ -150,23 +248,43 @@ void analyze_cutoff_impact(int size, [[maybe_unused]] int num_threads) {
         quicksort_sequential(sequential, 0, static_cast<int>(sequential.size()) - 1);
     });
     
+    task_utils::WorkStealingPool pool(num_threads);
+    
     // Try different cutoff values
     std::vector<int> cutoffs = {10, 50, 100, 500, 1000, 5000, 10000};
     
     for (int cutoff : cutoffs) {
         auto parallel = original;
-        double par_time = measure_time([&parallel, cutoff]() {
-            quicksort_parallel(parallel, cutoff);
+        double par_time = measure_time([&parallel, cutoff, algorithm]() {
+            parallel_sort_dispatch(algorithm, parallel, cutoff);
+        });
+        
+        auto stealing = original;
+        double ws_time = measure_time([&pool, &stealing, cutoff]() {
+            quicksort_work_stealing_parallel(pool, stealing, cutoff);
         });
         
         // Calculate speedup
         double speedup = seq_time / par_time;
+        double ws_speedup = seq_time / ws_time;
         
         std::cout << std::setw(6) << cutoff << " | "
                   << std::fixed << std::setprecision(4) << std::setw(8) << par_time << " | "
-                  << std::fixed << std::setprecision(2) << std::setw(6) << speedup << "x"
+                  << std::fixed << std::setprecision(2) << std::setw(6) << speedup << "x | "
+                  << std::fixed << std::setprecision(4) << std::setw(11) << ws_time << " | "
+                  << std::fixed << std::setprecision(2) << std::setw(9) << ws_speedup << "x"
                   << std::endl;
     }
+    
+    // The adaptive controller needs no cutoff at all
+    auto adaptive = original;
+    double adaptive_time = measure_time([&adaptive]() {
+        quicksort_adaptive_parallel(adaptive);
+    });
+    std::cout << "Adaptive | "
+              << std::fixed << std::setprecision(4) << std::setw(8) << adaptive_time << " | "
+              << std::fixed << std::setprecision(2) << std::setw(6) << seq_time / adaptive_time << "x"
+              << (std::is_sorted(adaptive.begin(), adaptive.end()) ? "" : "  (not sorted!)") << std::endl;
 }
 
 int main(int argc, char* argv[]) {
@@ -180,6 +298,13 @@ int main(int argc, char* argv[]) {
         if (argc > 2) cutoff = std::stoi(argv[2]);
         if (argc > 3) num_threads = std::stoi(argv[3]);
         
+        parallel_sort::SortAlgorithm algorithm = parallel_sort::SortAlgorithm::LOMUTO_TASK;
+        if (argc > 4 && !parallel_sort::parse_algorithm(argv[4], algorithm)) {
+            std::cerr << "Error: unknown algorithm '" << argv[4] << "' (expected lomuto, 3way, sample, radix or merge)" << std::endl;
+            return 1;
+        }
+        bool run_cutoff_analysis = (argc > 5 && std::stoi(argv[5]) != 0);
+        
         // Sanitize inputs - daha güvenli limitler
         const int MAX_SIZE = 100000; // Reduced max size to avoid memory issues
         if (size > MAX_SIZE) {
@@ -198,6 +323,7 @@ int main(int argc, char* argv[]) {
         std::cout << "Array size: " << size << std::endl;
         std::cout << "Number of threads: " << num_threads << std::endl;
         std::cout << "Cutoff for sequential execution: " << cutoff << std::endl;
+        std::cout << "Parallel algorithm: " << parallel_sort::algorithm_name(algorithm) << std::endl;
         
         // Generate random data
         std::cout << "\nGenerating random data..." << std::endl;
@@ -206,6 +332,8 @@ int main(int argc, char* argv[]) {
         // Create copies for sequential and parallel sorting
         auto sequential_data = original_data;
         auto parallel_data = original_data;
+        auto stealing_data = original_data;
+        auto adaptive_data = original_data;
         
         // Measure sequential time
         std::cout << "Running sequential quicksort..." << std::endl;
@@ -218,20 +346,40 @@ int main(int argc, char* argv[]) {
         double parallel_time;
         
         try {
-            parallel_time = measure_time([&parallel_data, cutoff]() {
-                quicksort_parallel(parallel_data, cutoff);
+            parallel_time = measure_time([&parallel_data, cutoff, algorithm]() {
+                parallel_sort_dispatch(algorithm, parallel_data, cutoff);
+            });
+            
+            // Same sort on the work-stealing pool
+            std::cout << "Running work-stealing quicksort..." << std::endl;
+            task_utils::WorkStealingPool pool(num_threads);
+            double stealing_time = measure_time([&pool, &stealing_data, cutoff]() {
+                quicksort_work_stealing_parallel(pool, stealing_data, cutoff);
+            });
+            
+            // Same sort with the adaptive granularity controller (no cutoff)
+            std::cout << "Running adaptive quicksort..." << std::endl;
+            double adaptive_time = measure_time([&adaptive_data]() {
+                quicksort_adaptive_parallel(adaptive_data);
             });
             
             // Verify results
             bool sequential_sorted = is_sorted(sequential_data);
             bool parallel_sorted = is_sorted(parallel_data);
-            bool results_match = std::equal(sequential_data.begin(), sequential_data.end(), parallel_data.begin());
+            bool results_match = std::equal(sequential_data.begin(), sequential_data.end(), parallel_data.begin()) &&
+                                 std::equal(sequential_data.begin(), sequential_data.end(), stealing_data.begin()) &&
+                                 std::equal(sequential_data.begin(), sequential_data.end(), adaptive_data.begin());
             
             // Display results
             std::cout << "\nPerformance Results:" << std::endl;
             std::cout << "---------------------------------" << std::endl;
             std::cout << "Sequential time: " << std::fixed << std::setprecision(4) << sequential_time << " seconds" << std::endl;
             std::cout << "Parallel time: " << std::fixed << std::setprecision(4) << parallel_time << " seconds" << std::endl;
+            std::cout << "Work-stealing time: " << std::fixed << std::setprecision(4) << stealing_time << " seconds"
+                      << " (" << std::setprecision(2) << parallel_time / stealing_time << "x vs omp task)" << std::endl;
+            pool.print_stats();
+            std::cout << "Adaptive time: " << std::fixed << std::setprecision(4) << adaptive_time << " seconds"
+                      << " (" << std::setprecision(2) << parallel_time / adaptive_time << "x vs cutoff " << cutoff << ")" << std::endl;
             std::cout << "---------------------------------" << std::endl;
             
             double speedup = sequential_time / parallel_time;
@@ -245,8 +393,12 @@ int main(int argc, char* argv[]) {
             std::cout << "Parallel result sorted: " << (parallel_sorted ? "Yes" : "No") << std::endl;
             std::cout << "Results match: " << (results_match ? "Yes" : "No") << std::endl;
             
-            // Skip cutoff analysis to improve stability
-            std::cout << "\nSkipping cutoff analysis for stability" << std::endl;
+            // Cutoff analysis is opt-in to keep the default run short
+            if (run_cutoff_analysis) {
+                analyze_cutoff_impact(size, num_threads, algorithm);
+            } else {
+                std::cout << "\nSkipping cutoff analysis for stability" << std::endl;
+            }
         } catch (const std::exception& e) {
             std::cerr << "\nError during parallel quicksort: " << e.what() << std::endl;
             return 1;
@@ -469,6 +469,77 @@ void run_with_adaptive_throttling(const std::vector<int>& task_durations) {
     stats.visualize_throughput();
 }
 
+//==============================================================================
+// 6. Blocking Throttler (spin, then park)
+//==============================================================================
+void run_with_blocking_throttler(const std::vector<int>& task_durations, int max_tasks) {
+    TaskStatistics stats;
+    task_utils::BlockingTaskThrottler throttler(max_tasks);
+    
+    task_utils::print_section_header("Running WITH BlockingTaskThrottler (max " + 
+                                   std::to_string(max_tasks) + " active tasks)");
+    
+    #pragma omp parallel
+    {
+        #pragma omp single
+        {
+            for (size_t i = 0; i < task_durations.size(); ++i) {
+                // Spins briefly, then sleeps until a task releases a slot
+                throttler.before_task();
+                
+                #pragma omp task
+                {
+                    do_work(static_cast<int>(i), task_durations[i], stats);
+                    throttler.after_task();
+                }
+            }
+        }
+    }
+    
+    stats.print_summary();
+    std::cout << "Producer parked " << throttler.get_park_count() << " times" << std::endl;
+    stats.visualize_throughput();
+}
+
+//==============================================================================
+// 7. AIMD Adaptive Throttling
+//==============================================================================
+void run_with_aimd_throttling(const std::vector<int>& task_durations) {
+    TaskStatistics stats;
+    
+    // Same starting point and floor as run_with_adaptive_throttling
+    int num_threads = omp_get_max_threads();
+    task_utils::AdaptiveTaskThrottler throttler(num_threads * 2, num_threads, num_threads * 8,
+                                                std::max(1, num_threads / 2));
+    
+    task_utils::print_section_header("Running WITH AIMD Adaptive Throttling");
+    
+    #pragma omp parallel
+    {
+        #pragma omp single
+        {
+            for (size_t i = 0; i < task_durations.size(); ++i) {
+                throttler.before_task();
+                
+                #pragma omp task
+                {
+                    do_work(static_cast<int>(i), task_durations[i], stats);
+                    
+                    // Completing a task may close a sampling window and retune the limit
+                    throttler.after_task();
+                }
+            }
+        }
+    }
+    
+    stats.print_summary();
+    std::cout << "Final max active tasks: " << throttler.get_max_tasks()
+              << " (" << throttler.get_increase_count() << " increases, "
+              << throttler.get_decrease_count() << " decreases, "
+              << throttler.get_park_count() << " parks)" << std::endl;
+    stats.visualize_throughput();
+}
+
 //==============================================================================
 // Comparison of all throttling methods
 //==============================================================================
@@ -522,6 +593,20 @@ void compare_throttling_methods(const std::vector<int>& task_durations, int num_
         0.0
     });
     
+    methods.push_back({
+        "Blocking Throttler",
+        "max=" + std::to_string(max_tasks),
+        [&task_durations, max_tasks]() { run_with_blocking_throttler(task_durations, max_tasks); },
+        0.0
+    });
+    
+    methods.push_back({
+        "AIMD Adaptive",
+        "aimd",
+        [&task_durations]() { run_with_aimd_throttling(task_durations); },
+        0.0
+    });
+    
     // Run methods and measure execution time
     task_utils::print_section_header("Comparing Task Throttling Methods");
     
@@ -571,7 +656,7 @@ int main(int argc, char* argv[]) {
     int min_duration = 50;
     int max_duration = 200;
     int num_threads = omp_get_max_threads();
-    int example_mode = 0;  // 0=all, 1=no throttling, 2=atomic, 3=taskgroup, 4=throttler, 5=adaptive
+    int example_mode = 0;  // 0=all, 1=no throttling, 2=atomic, 3=taskgroup, 4=throttler, 5=adaptive, 6=blocking, 7=aimd
     
     if (argc > 1) num_tasks = atoi(argv[1]);
     if (argc > 2) num_threads = atoi(argv[2]);
@@ -608,6 +693,12 @@ int main(int argc, char* argv[]) {
         case 5:  // Adaptive throttling
             run_with_adaptive_throttling(task_durations);
             break;
+        case 6:  // Blocking throttler
+            run_with_blocking_throttler(task_durations, num_threads * 2);
+            break;
+        case 7:  // AIMD adaptive throttling
+            run_with_aimd_throttling(task_durations);
+            break;
         default:  // Comparison of all methods
             compare_throttling_methods(task_durations, num_threads);
             break;
@@ -10,6 +10,7 @@
 #include <stdexcept>
 #include <string>
 #include <utility>
+#include "../include/task_utils.h"
 
 // Function to perform work (to measure real computation)
 void do_work(int iterations) {
@@ -226,6 +227,55 @@ void test_num_tasks_impact(int data_size) {
     }
 }
 
+// Run the same loop site repeatedly under the online grainsize tuner.
+// The learned grainsize is saved to profile_path, so a second run of the
+// program starts from the tuned value (shown as "loaded" in the first row).
+void test_grainsize_autotuner(int data_size, int invocations, const std::string& profile_path) {
+    std::cout << "\nOnline grainsize tuning (profile: " << profile_path << "):" << std::endl;
+    std::cout << "----------------------------------------------------------------------" << std::endl;
+    std::cout << "Call | Grain Size | Time (s) | Cost/iter (us) | Overhead/task (us) | State" << std::endl;
+    std::cout << "----------------------------------------------------------------------" << std::endl;
+    
+    const std::string site = "process_irregular";
+    task_utils::GrainsizeTuner tuner(profile_path);
+    bool loaded = tuner.get_grainsize(site) > 0;
+    
+    auto original_data = generate_data(data_size);
+    auto sequential_data = original_data;
+    process_sequential(sequential_data);
+    
+    bool all_correct = true;
+    for (int call = 1; call <= invocations; ++call) {
+        auto test_data = original_data;
+        int grainsize = tuner.get_grainsize(site);
+        
+        double start = omp_get_wtime();
+        tuner.run(site, 0, data_size, [&test_data](int begin, int end) {
+            process_range_sequential(test_data, begin, end);
+        });
+        double time = omp_get_wtime() - start;
+        
+        all_correct = all_correct && verify_results(sequential_data, test_data);
+        
+        auto profile = tuner.get_profile(site);
+        if (grainsize == 0) grainsize = profile.grainsize;  // First call picked the initial value
+        
+        std::cout << std::setw(4) << call << " | "
+                  << std::setw(10) << grainsize << " | "
+                  << std::fixed << std::setprecision(4) << std::setw(8) << time << " | "
+                  << std::fixed << std::setprecision(2) << std::setw(14) << profile.last_cost_per_iteration * 1e6 << " | "
+                  << std::fixed << std::setprecision(2) << std::setw(18) << profile.last_overhead_per_task * 1e6 << " | "
+                  << (call == 1 && loaded ? "loaded" : (profile.converged ? "converged" : "tuning")) << std::endl;
+    }
+    
+    std::cout << "Final grain size: " << tuner.get_grainsize(site)
+              << (all_correct ? "" : " (INCORRECT RESULTS)") << std::endl;
+    
+    if (tuner.save()) {
+        std::cout << "Profile saved to " << profile_path << std::endl;
+    }
+}
+
 // Compare different implementation approaches
 void compare_implementations(int data_size, int grainsize, int num_tasks) {
     std::cout << "\nComparing different implementation approaches:" << std::endl;
@@ -305,11 +355,15 @@ int main(int argc, char* argv[]) {
     int grainsize = 100;
     int num_tasks = 16;
     int num_threads = omp_get_max_threads();
+    int tuner_invocations = 10;
+    std::string profile_path = "taskloop_grainsize.profile";
     
     if (argc > 1) data_size = atoi(argv[1]);
     if (argc > 2) grainsize = atoi(argv[2]);
     if (argc > 3) num_tasks = atoi(argv[3]);
     if (argc > 4) num_threads = atoi(argv[4]);
+    if (argc > 5) tuner_invocations = std::max(1, atoi(argv[5]));
+    if (argc > 6) profile_path = argv[6];
     
     omp_set_num_threads(num_threads);
     
@@ -329,5 +383,8 @@ int main(int argc, char* argv[]) {
     // Test impact of num_tasks on performance
     test_num_tasks_impact(data_size);
     
+    // Tune the grainsize online and persist it for the next run
+    test_grainsize_autotuner(data_size, tuner_invocations, profile_path);
+    
     return 0;
 }
\ No newline at end of file
@@ -13,6 +13,7 @@
 #include <sstream>      // For string stream processing
 #include <cstdlib>      // For atoi as an alternative to std::stoi
 #include <algorithm>    // For std::sort
+#include "../include/task_utils.h"
 
 // Binary tree node structure
 struct TreeNode {
@@ -77,7 +78,7 @@ void traverse_parallel(std::shared_ptr<TreeNode> node, std::vector<int>& result,
     
     // Process left subtree - only create task if depth is significant
     if (cutoff_depth > 1 && node->left) {
-        #pragma omp task
+        #pragma omp task shared(result, node_mutexes)
         {
             traverse_parallel(node->left, result, node_mutexes, cutoff_depth - 1);
         }
@@ -103,7 +104,7 @@ void traverse_parallel(std::shared_ptr<TreeNode> node, std::vector<int>& result,
     
     // Process right subtree - only create task if depth is significant
     if (cutoff_depth > 1 && node->right) {
-        #pragma omp task
+        #pragma omp task shared(result, node_mutexes)
         {
             traverse_parallel(node->right, result, node_mutexes, cutoff_depth - 1);
         }
@@ -140,6 +141,219 @@ void parallel_tree_traversal(std::shared_ptr<TreeNode> root, std::vector<int>& r
     result = std::move(local_result);
 }
 
+// Work-stealing in-order traversal: both subtrees are forked through the
+// custom Chase-Lev pool into private buffers and concatenated afterwards,
+// so the result keeps in-order ordering without any locking
+void traverse_work_stealing(task_utils::WorkStealingPool& pool, std::shared_ptr<TreeNode> node, std::vector<int>& result, int cutoff_depth) {
+    if (!node) return;
+    
+    if (cutoff_depth <= 0) {
+        traverse_sequential(node, result);
+        return;
+    }
+    
+    std::vector<int> left_result;
+    std::vector<int> right_result;
+    pool.join([&]() { traverse_work_stealing(pool, node->left, left_result, cutoff_depth - 1); },
+              [&]() { traverse_work_stealing(pool, node->right, right_result, cutoff_depth - 1); });
+    
+    result.insert(result.end(), left_result.begin(), left_result.end());
+    result.push_back(node->value);
+    result.insert(result.end(), right_result.begin(), right_result.end());
+}
+
+// Wrapper for work-stealing traversal
+void work_stealing_tree_traversal(task_utils::WorkStealingPool& pool, std::shared_ptr<TreeNode> root, std::vector<int>& result, int cutoff_depth) {
+    result.clear();
+    pool.run([&]() { traverse_work_stealing(pool, root, result, cutoff_depth); });
+}
+
+//==============================================================================
+// Arena-allocated flat tree
+//==============================================================================
+
+// Index-linked binary tree stored in one arena (parallel arrays) in BFS order:
+// no per-node allocation, no reference counts, and the upper levels that
+// every traversal touches share a few cache lines. -1 marks a missing child.
+struct FlatTree {
+    std::vector<int> value;
+    std::vector<int> left;
+    std::vector<int> right;
+    std::vector<int> subtree_size;  // nodes in the subtree rooted here
+    int root = -1;
+    
+    int size() const { return static_cast<int>(value.size()); }
+    
+    // Subtree sizes bottom-up; in BFS order every child has a larger index than its parent
+    void compute_subtree_sizes() {
+        subtree_size.assign(value.size(), 1);
+        for (int i = size() - 1; i >= 0; --i) {
+            if (left[i] >= 0) subtree_size[i] += subtree_size[left[i]];
+            if (right[i] >= 0) subtree_size[i] += subtree_size[right[i]];
+        }
+    }
+    
+    int size_of(int node) const { return node < 0 ? 0 : subtree_size[node]; }
+};
+
+// Flatten a pointer tree into BFS order, keeping its values and shape
+FlatTree flatten_tree(std::shared_ptr<TreeNode> root) {
+    FlatTree tree;
+    if (!root) return tree;
+    
+    std::vector<TreeNode*> order = {root.get()};
+    for (size_t head = 0; head < order.size(); ++head) {
+        if (order[head]->left) order.push_back(order[head]->left.get());
+        if (order[head]->right) order.push_back(order[head]->right.get());
+    }
+    
+    tree.value.resize(order.size());
+    tree.left.assign(order.size(), -1);
+    tree.right.assign(order.size(), -1);
+    
+    // Children were appended in the same order, so they can be numbered on the fly
+    int next_child = 1;
+    for (size_t i = 0; i < order.size(); ++i) {
+        tree.value[i] = order[i]->value;
+        if (order[i]->left) tree.left[i] = next_child++;
+        if (order[i]->right) tree.right[i] = next_child++;
+    }
+    
+    tree.root = 0;
+    tree.compute_subtree_sizes();
+    return tree;
+}
+
+// Build the same balanced tree as generate_tree (values numbered in preorder)
+// directly in the arena, without creating pointer nodes
+FlatTree generate_flat_tree(int depth) {
+    FlatTree tree;
+    if (depth <= 0) return tree;
+    
+    const int n = (1 << depth) - 1;
+    tree.value.resize(n);
+    tree.left.resize(n);
+    tree.right.resize(n);
+    for (int i = 0; i < n; ++i) {
+        tree.left[i] = (2 * i + 1 < n) ? 2 * i + 1 : -1;
+        tree.right[i] = (2 * i + 2 < n) ? 2 * i + 2 : -1;
+    }
+    
+    // Preorder numbering with an explicit stack
+    std::vector<int> stack = {0};
+    int counter = 0;
+    while (!stack.empty()) {
+        int node = stack.back();
+        stack.pop_back();
+        tree.value[node] = ++counter;
+        if (tree.right[node] >= 0) stack.push_back(tree.right[node]);
+        if (tree.left[node] >= 0) stack.push_back(tree.left[node]);
+    }
+    
+    tree.root = 0;
+    tree.compute_subtree_sizes();
+    return tree;
+}
+
+// Sequential in-order traversal writing into out[offset..]
+void traverse_flat_sequential(const FlatTree& tree, int node, int* out, int offset) {
+    while (node >= 0) {
+        int left = tree.left[node];
+        int position = offset + tree.size_of(left);
+        traverse_flat_sequential(tree, left, out, offset);
+        out[position] = tree.value[node];
+        
+        // Continue with the right subtree iteratively
+        offset = position + 1;
+        node = tree.right[node];
+    }
+}
+
+// Task-parallel in-order traversal: a node's in-order position is its offset
+// plus the size of its left subtree, so every task writes a disjoint,
+// precomputed range of the result. No locks and no ordering fix-up needed.
+void traverse_flat_task(const FlatTree& tree, int node, int* out, int offset, int cutoff_depth) {
+    if (node < 0) return;
+    
+    if (cutoff_depth <= 0) {
+        traverse_flat_sequential(tree, node, out, offset);
+        return;
+    }
+    
+    int left = tree.left[node];
+    int position = offset + tree.size_of(left);
+    
+    #pragma omp task firstprivate(left, offset, cutoff_depth) shared(tree)
+    {
+        traverse_flat_task(tree, left, out, offset, cutoff_depth - 1);
+    }
+    
+    out[position] = tree.value[node];
+    traverse_flat_task(tree, tree.right[node], out, position + 1, cutoff_depth - 1);
+    
+    #pragma omp taskwait
+}
+
+// Flat traversal without a cutoff depth: the granularity controller decides
+// at every level whether the left subtree becomes a task
+void traverse_flat_adaptive(const FlatTree& tree, int node, int* out, int offset, int depth,
+                            task_utils::GranularityController& controller) {
+    if (node < 0) return;
+    
+    if (controller.past_spawn_limit(depth)) {
+        traverse_flat_sequential(tree, node, out, offset);
+        return;
+    }
+    
+    int left = tree.left[node];
+    int position = offset + tree.size_of(left);
+    
+    const FlatTree* tree_ptr = &tree;
+    task_utils::GranularityController* controller_ptr = &controller;
+    bool spawned = controller.spawn_or_run(depth, [=]() {
+        traverse_flat_adaptive(*tree_ptr, left, out, offset, depth + 1, *controller_ptr);
+    });
+    
+    out[position] = tree.value[node];
+    traverse_flat_adaptive(tree, tree.right[node], out, position + 1, depth + 1, controller);
+    
+    if (spawned) {
+        #pragma omp taskwait
+    }
+}
+
+void parallel_flat_traversal_adaptive(const FlatTree& tree, std::vector<int>& result) {
+    result.assign(tree.size(), 0);
+    if (tree.root < 0) return;
+    
+    int* out = result.data();
+    task_utils::GranularityController controller;
+    
+    #pragma omp parallel
+    {
+        #pragma omp single
+        {
+            traverse_flat_adaptive(tree, tree.root, out, 0, 0, controller);
+        }
+    }
+}
+
+// Wrapper for the flat parallel traversal
+void parallel_flat_traversal(const FlatTree& tree, std::vector<int>& result, int cutoff_depth) {
+    result.assign(tree.size(), 0);
+    if (tree.root < 0) return;
+    
+    int* out = result.data();
+    
+    #pragma omp parallel
+    {
+        #pragma omp single
+        {
+            traverse_flat_task(tree, tree.root, out, 0, cutoff_depth);
+        }
+    }
+}
+
 // Measure execution time
 template<typename Func, typename... Args>
 double measure_time(Func func, Args... args) {
@@ -223,9 +437,11 @@ void analyze_cutoff_impact(std::shared_ptr<TreeNode> root, int max_depth) {
     
     std::cout << "\nAnalyzing cutoff depth impact:" << std::endl;
     std::cout << "---------------------------------------------------" << std::endl;
-    std::cout << "Cutoff | Parallel Time (s) | Speedup | Correct" << std::endl;
+    std::cout << "Cutoff | Parallel Time (s) | Speedup | Correct | WS Time (s) | WS Speedup | WS Correct" << std::endl;
     std::cout << "---------------------------------------------------" << std::endl;
     
+    task_utils::WorkStealingPool pool(omp_get_max_threads());
+    
     for (int cutoff = 0; cutoff <= max_depth; cutoff += 2) {
         std::vector<int> par_result;
         
@@ -234,13 +450,23 @@ void analyze_cutoff_impact(std::shared_ptr<TreeNode> root, int max_depth) {
             parallel_tree_traversal(root, par_result, cutoff);
         });
         
+        std::vector<int> ws_result;
+        double ws_time = measure_time([&]() {
+            work_stealing_tree_traversal(pool, root, ws_result, cutoff);
+        });
+        
         bool correct = verify_results(seq_result, par_result);
+        bool ws_correct = (ws_result == seq_result);
         double speedup = seq_time / par_time;
+        double ws_speedup = seq_time / ws_time;
         
         std::cout << std::setw(6) << cutoff << " | "
                   << std::fixed << std::setprecision(6) << std::setw(17) << par_time << " | "
                   << std::fixed << std::setprecision(2) << std::setw(7) << speedup << " | "
-                  << (correct ? "Yes" : "No") << std::endl;
+                  << std::setw(7) << (correct ? "Yes" : "No") << " | "
+                  << std::fixed << std::setprecision(6) << std::setw(11) << ws_time << " | "
+                  << std::fixed << std::setprecision(2) << std::setw(10) << ws_speedup << " | "
+                  << (ws_correct ? "Yes" : "No") << std::endl;
     }
 }
 
@@ -255,6 +481,9 @@ int main(int argc, char* argv[]) {
         if (argc > 2) num_threads = std::stoi(argv[2]);  
         if (argc > 3) cutoff_depth = std::stoi(argv[3]);
         
+        // The arena tree has no allocation or locking limits, so it keeps the requested depth
+        int flat_depth = std::max(1, std::min(depth, 24));
+        
         // Sanity checks - daha güvenli limitler
         if (depth < 1) depth = 1;
         if (depth > 8) {
@@ -320,12 +549,65 @@ int main(int argc, char* argv[]) {
             // Verify results correctness
             bool results_match = verify_results(seq_result, par_result);
             std::cout << "\nResults correctness: " << (results_match ? "PASS" : "FAIL") << std::endl;
+            
+            // Same traversal on the work-stealing pool (in-order, no locks)
+            task_utils::WorkStealingPool pool(num_threads);
+            std::vector<int> ws_result;
+            double ws_time = measure_time([&]() {
+                work_stealing_tree_traversal(pool, root, ws_result, cutoff_depth);
+            });
+            
+            std::cout << "\nWork-stealing traversal time: " << std::fixed << std::setprecision(6) << ws_time << " seconds"
+                      << " (" << std::setprecision(2) << par_time / ws_time << "x vs omp task)" << std::endl;
+            pool.print_stats();
+            std::cout << "Work-stealing correctness (exact in-order): " << (ws_result == seq_result ? "PASS" : "FAIL") << std::endl;
+            
+            // Same tree in the arena layout: tasks write precomputed result ranges
+            FlatTree flat = flatten_tree(root);
+            std::vector<int> flat_result;
+            double flat_time = measure_time([&]() {
+                parallel_flat_traversal(flat, flat_result, cutoff_depth);
+            });
+            
+            std::cout << "\nFlat arena traversal time: " << std::fixed << std::setprecision(6) << flat_time << " seconds"
+                      << " (" << std::setprecision(2) << par_time / flat_time << "x vs pointer tree)" << std::endl;
+            std::cout << "Flat arena correctness (exact in-order): " << (flat_result == seq_result ? "PASS" : "FAIL") << std::endl;
         }
         catch (const std::exception& e) {
             std::cerr << "Error during parallel traversal: " << e.what() << std::endl;
             return 1;
         }
         
+        // Large arena tree at the full requested depth
+        if (flat_depth > depth) {
+            FlatTree big = generate_flat_tree(flat_depth);
+            std::cout << "\nArena tree at depth " << flat_depth << ": " << big.size() << " nodes" << std::endl;
+            
+            std::vector<int> big_seq(big.size());
+            double big_seq_time = measure_time([&]() {
+                traverse_flat_sequential(big, big.root, big_seq.data(), 0);
+            });
+            
+            std::vector<int> big_par;
+            int big_cutoff = std::min(flat_depth, std::max(cutoff_depth, 8));
+            double big_par_time = measure_time([&]() {
+                parallel_flat_traversal(big, big_par, big_cutoff);
+            });
+            
+            std::cout << "Sequential arena traversal: " << std::fixed << std::setprecision(6) << big_seq_time << " seconds" << std::endl;
+            std::cout << "Parallel arena traversal (cutoff " << big_cutoff << "): " << big_par_time << " seconds ("
+                      << std::setprecision(2) << big_seq_time / big_par_time << "x)" << std::endl;
+            std::cout << "Arena traversal correctness: " << (big_par == big_seq ? "PASS" : "FAIL") << std::endl;
+            
+            std::vector<int> big_adaptive;
+            double big_adaptive_time = measure_time([&]() {
+                parallel_flat_traversal_adaptive(big, big_adaptive);
+            });
+            std::cout << "Adaptive arena traversal (no cutoff): " << std::fixed << std::setprecision(6) << big_adaptive_time
+                      << " seconds (" << std::setprecision(2) << big_seq_time / big_adaptive_time << "x), "
+                      << (big_adaptive == big_seq ? "PASS" : "FAIL") << std::endl;
+        }
+        
         // Skip cutoff analysis completely
         std::cout << "\nSkipping cutoff analysis for performance reasons" << std::endl;
         
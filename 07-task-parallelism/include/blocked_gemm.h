@@ -0,0 +1,304 @@
+#ifndef BLOCKED_GEMM_H
+#define BLOCKED_GEMM_H
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <omp.h>
+#include "perf_markers.h"
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// MSVC /arch:AVX2 implies FMA but does not define __FMA__
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define BLOCKED_GEMM_USE_AVX2 1
+#include <immintrin.h>
+#else
+#define BLOCKED_GEMM_USE_AVX2 0
+#endif
+
+namespace blocked_gemm {
+
+//==============================================================================
+// Blocking parameters
+//==============================================================================
+
+// Register tile computed by one micro-kernel call (MR rows x NR columns of C)
+constexpr int MR = 4;
+constexpr int NR = 8;
+
+// Cache blocks (BLIS naming): a KC x NR sliver of B stays in L1, an MC x KC
+// block of A in L2, a KC x NC panel of B in L3
+constexpr int MC = 96;
+constexpr int KC = 256;
+constexpr int NC = 2048;
+
+// Columns of C per task inside one MC x NC macro tile; splits wide panels so
+// small matrices still yield enough tasks
+constexpr int NC_TASK = 256;
+
+static_assert(MC % MR == 0 && NC % NR == 0 && NC_TASK % NR == 0, "Blocks must be multiples of the register tile");
+
+inline const char* kernel_name() {
+    return BLOCKED_GEMM_USE_AVX2 ? "AVX2/FMA 4x8" : "portable 4x8";
+}
+
+//==============================================================================
+// Aligned scratch buffer
+//==============================================================================
+
+// 64-byte aligned array of doubles used for the packed panels
+class AlignedBuffer {
+private:
+    double* data_ = nullptr;
+    size_t size_ = 0;
+
+    static double* allocate(size_t count) {
+        size_t bytes = ((count * sizeof(double) + 63) / 64) * 64;
+#ifdef _WIN32
+        void* ptr = _aligned_malloc(bytes, 64);
+#else
+        void* ptr = std::aligned_alloc(64, bytes);
+#endif
+        if (ptr == nullptr) throw std::bad_alloc();
+        return static_cast<double*>(ptr);
+    }
+
+    static void release(double* ptr) {
+#ifdef _WIN32
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+
+public:
+    AlignedBuffer() = default;
+    explicit AlignedBuffer(size_t count) : data_(count ? allocate(count) : nullptr), size_(count) {}
+    ~AlignedBuffer() { if (data_) release(data_); }
+
+    AlignedBuffer(const AlignedBuffer&) = delete;
+    AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+    double* data() { return data_; }
+    const double* data() const { return data_; }
+    size_t size() const { return size_; }
+};
+
+//==============================================================================
+// Packing
+//==============================================================================
+
+// Pack rows [row, row+mc) x columns [col, col+kc) of row-major A (leading
+// dimension lda) into MR-row slivers: sliver s holds A[row+s*MR+i][col+p] at
+// packed[s*MR*kc + p*MR + i]. Missing rows at the edge are zero-filled.
+inline void pack_a(const double* A, int lda, int row, int col, int mc, int kc, double* packed) {
+    for (int s = 0; s < mc; s += MR) {
+        int rows = std::min(MR, mc - s);
+        for (int p = 0; p < kc; ++p) {
+            for (int i = 0; i < MR; ++i) {
+                *packed++ = (i < rows) ? A[static_cast<size_t>(row + s + i) * lda + col + p] : 0.0;
+            }
+        }
+    }
+}
+
+// Pack rows [row, row+kc) x columns [col, col+nc) of row-major B into NR-column
+// slivers: sliver s holds B[row+p][col+s*NR+j] at packed[s*NR*kc + p*NR + j]
+inline void pack_b(const double* B, int ldb, int row, int col, int kc, int nc, double* packed) {
+    for (int s = 0; s < nc; s += NR) {
+        int cols = std::min(NR, nc - s);
+        for (int p = 0; p < kc; ++p) {
+            const double* src = B + static_cast<size_t>(row + p) * ldb + col + s;
+            for (int j = 0; j < NR; ++j) {
+                *packed++ = (j < cols) ? src[j] : 0.0;
+            }
+        }
+    }
+}
+
+//==============================================================================
+// Micro-kernel
+//==============================================================================
+
+// tile[MR][NR] = sum over p of a_sliver[p][:] x b_sliver[p][:]
+inline void micro_kernel(int kc, const double* a, const double* b, double* tile) {
+#if BLOCKED_GEMM_USE_AVX2
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+    __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+    __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+    __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+
+    for (int p = 0; p < kc; ++p) {
+        __m256d b0 = _mm256_load_pd(b);
+        __m256d b1 = _mm256_load_pd(b + 4);
+
+        __m256d a0 = _mm256_broadcast_sd(a);
+        c00 = _mm256_fmadd_pd(a0, b0, c00);
+        c01 = _mm256_fmadd_pd(a0, b1, c01);
+        __m256d a1 = _mm256_broadcast_sd(a + 1);
+        c10 = _mm256_fmadd_pd(a1, b0, c10);
+        c11 = _mm256_fmadd_pd(a1, b1, c11);
+        __m256d a2 = _mm256_broadcast_sd(a + 2);
+        c20 = _mm256_fmadd_pd(a2, b0, c20);
+        c21 = _mm256_fmadd_pd(a2, b1, c21);
+        __m256d a3 = _mm256_broadcast_sd(a + 3);
+        c30 = _mm256_fmadd_pd(a3, b0, c30);
+        c31 = _mm256_fmadd_pd(a3, b1, c31);
+
+        a += MR;
+        b += NR;
+    }
+
+    _mm256_storeu_pd(tile + 0 * NR, c00);
+    _mm256_storeu_pd(tile + 0 * NR + 4, c01);
+    _mm256_storeu_pd(tile + 1 * NR, c10);
+    _mm256_storeu_pd(tile + 1 * NR + 4, c11);
+    _mm256_storeu_pd(tile + 2 * NR, c20);
+    _mm256_storeu_pd(tile + 2 * NR + 4, c21);
+    _mm256_storeu_pd(tile + 3 * NR, c30);
+    _mm256_storeu_pd(tile + 3 * NR + 4, c31);
+#else
+    // Accumulators stay in registers; the fixed-size inner loops vectorize
+    double acc[MR][NR] = {};
+
+    for (int p = 0; p < kc; ++p) {
+        for (int i = 0; i < MR; ++i) {
+            double a_value = a[i];
+            for (int j = 0; j < NR; ++j) {
+                acc[i][j] += a_value * b[j];
+            }
+        }
+        a += MR;
+        b += NR;
+    }
+
+    for (int i = 0; i < MR; ++i) {
+        for (int j = 0; j < NR; ++j) {
+            tile[i * NR + j] = acc[i][j];
+        }
+    }
+#endif
+}
+
+// Multiply packed blocks for C[row..row+mc) x [col..col+nc) and add (or store,
+// when overwrite is set) into C. packed_a starts at the block's first sliver,
+// packed_b at sliver col_offset / NR of the packed panel.
+inline void macro_kernel(int mc, int nc, int kc, const double* packed_a, const double* packed_b,
+                         double* C, int ldc, int row, int col, bool overwrite) {
+    alignas(64) double tile[MR * NR];
+
+    for (int jr = 0; jr < nc; jr += NR) {
+        int cols = std::min(NR, nc - jr);
+        const double* b_sliver = packed_b + static_cast<size_t>(jr) * kc;
+
+        for (int ir = 0; ir < mc; ir += MR) {
+            int rows = std::min(MR, mc - ir);
+            micro_kernel(kc, packed_a + static_cast<size_t>(ir) * kc, b_sliver, tile);
+
+            for (int i = 0; i < rows; ++i) {
+                double* c_row = C + static_cast<size_t>(row + ir + i) * ldc + col + jr;
+                const double* t_row = tile + i * NR;
+                if (overwrite) {
+                    for (int j = 0; j < cols; ++j) c_row[j] = t_row[j];
+                } else {
+                    for (int j = 0; j < cols; ++j) c_row[j] += t_row[j];
+                }
+            }
+        }
+    }
+}
+
+//==============================================================================
+// Task-parallel GEMM
+//==============================================================================
+
+// C = A x B for square row-major size x size matrices.
+// Loop order follows BLIS: for each NC panel of columns and each KC slice of
+// the inner dimension, B is packed once (shared by all tasks) and A is packed
+// into MC-row blocks; then every (MC block, NC_TASK column group) macro tile
+// is an independent task. Packing and compute of one KC slice are separated
+// by taskwait, so each slice's buffers are reused by the next.
+inline void gemm_task(const std::vector<double>& A, const std::vector<double>& B,
+                      std::vector<double>& C, int size) {
+    PERF_SCOPE("Blocked GEMM (tasks)");
+    const int n = size;
+    if (n <= 0) return;
+
+    const int kc_max = std::min(KC, n);
+    const int nc_max = std::min(NC, ((n + NR - 1) / NR) * NR);
+    const int m_padded = ((n + MR - 1) / MR) * MR;
+
+    AlignedBuffer packed_b(static_cast<size_t>(kc_max) * ((nc_max + NR - 1) / NR) * NR);
+    AlignedBuffer packed_a(static_cast<size_t>(kc_max) * m_padded);
+
+    const double* a_data = A.data();
+    const double* b_data = B.data();
+    double* c_data = C.data();
+    double* pa = packed_a.data();
+    double* pb = packed_b.data();
+
+    #pragma omp parallel
+    {
+        #pragma omp single
+        {
+            for (int jc = 0; jc < n; jc += NC) {
+                int nc = std::min(NC, n - jc);
+
+                for (int pc = 0; pc < n; pc += KC) {
+                    int kc = std::min(KC, n - pc);
+                    bool first_slice = (pc == 0);
+
+                    // Pack B: one task per NC_TASK column group
+                    for (int jt = 0; jt < nc; jt += NC_TASK) {
+                        #pragma omp task firstprivate(jt, jc, nc, pc, kc)
+                        {
+                            int width = std::min(NC_TASK, nc - jt);
+                            pack_b(b_data, n, pc, jc + jt, kc, width, pb + static_cast<size_t>(jt) * kc);
+                        }
+                    }
+
+                    // Pack A: one task per MC block
+                    for (int ic = 0; ic < n; ic += MC) {
+                        #pragma omp task firstprivate(ic, pc, kc)
+                        {
+                            int mc = std::min(MC, n - ic);
+                            pack_a(a_data, n, ic, pc, mc, kc, pa + static_cast<size_t>(ic) * kc);
+                        }
+                    }
+
+                    #pragma omp taskwait
+
+                    // Compute: one task per macro tile
+                    for (int ic = 0; ic < n; ic += MC) {
+                        for (int jt = 0; jt < nc; jt += NC_TASK) {
+                            #pragma omp task firstprivate(ic, jt, jc, nc, kc, first_slice)
+                            {
+                                int mc = std::min(MC, n - ic);
+                                int width = std::min(NC_TASK, nc - jt);
+                                macro_kernel(mc, width, kc, pa + static_cast<size_t>(ic) * kc,
+                                             pb + static_cast<size_t>(jt) * kc,
+                                             c_data, n, ic, jc + jt, first_slice);
+                            }
+                        }
+                    }
+
+                    #pragma omp taskwait
+                }
+            }
+        }
+    }
+}
+
+// Floating-point operations of a size x size x size multiply
+inline double gemm_flops(int size) {
+    return 2.0 * static_cast<double>(size) * size * size;
+}
+
+} // namespace blocked_gemm
+
+#endif // BLOCKED_GEMM_H
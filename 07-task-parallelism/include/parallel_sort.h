@@ -0,0 +1,478 @@
+#ifndef PARALLEL_SORT_H
+#define PARALLEL_SORT_H
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <omp.h>
+#include "perf_markers.h"
+
+namespace parallel_sort {
+
+//==============================================================================
+// Algorithm selection
+//==============================================================================
+
+enum class SortAlgorithm {
+    LOMUTO_TASK,     // Single-pivot Lomuto partition with omp tasks (the original examples)
+    THREE_WAY_TASK,  // Median-of-three 3-way partition, insertion-sort leaves, omp tasks
+    SAMPLE_SORT,     // Parallel splitter selection, bucket scatter, per-bucket sort
+    RADIX_SORT,      // LSD radix sort, per-thread histograms and stable scatter per 8-bit digit
+    MERGE_SORT       // Task merge sort with a co-ranked parallel merge
+};
+
+inline const char* algorithm_name(SortAlgorithm algorithm) {
+    switch (algorithm) {
+        case SortAlgorithm::LOMUTO_TASK: return "Lomuto task";
+        case SortAlgorithm::THREE_WAY_TASK: return "3-way task";
+        case SortAlgorithm::SAMPLE_SORT: return "Sample sort";
+        case SortAlgorithm::RADIX_SORT: return "Radix sort";
+        case SortAlgorithm::MERGE_SORT: return "Merge sort";
+    }
+    return "Unknown";
+}
+
+// Parse "lomuto", "3way", "sample", "radix" or "merge"; returns false for anything else
+inline bool parse_algorithm(const std::string& name, SortAlgorithm& algorithm) {
+    if (name == "lomuto") {
+        algorithm = SortAlgorithm::LOMUTO_TASK;
+    } else if (name == "3way") {
+        algorithm = SortAlgorithm::THREE_WAY_TASK;
+    } else if (name == "sample") {
+        algorithm = SortAlgorithm::SAMPLE_SORT;
+    } else if (name == "radix") {
+        algorithm = SortAlgorithm::RADIX_SORT;
+    } else if (name == "merge") {
+        algorithm = SortAlgorithm::MERGE_SORT;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+//==============================================================================
+// 3-way partition quicksort
+//==============================================================================
+
+// Ranges below this size are finished with insertion sort
+constexpr int INSERTION_SORT_CUTOFF = 16;
+
+// Insertion sort of arr[low..high] (inclusive)
+inline void insertion_sort(std::vector<int>& arr, int low, int high) {
+    for (int i = low + 1; i <= high; i++) {
+        int value = arr[i];
+        int j = i - 1;
+        while (j >= low && arr[j] > value) {
+            arr[j + 1] = arr[j];
+            j--;
+        }
+        arr[j + 1] = value;
+    }
+}
+
+// Median of arr[low], arr[mid], arr[high]; guards against sorted and reversed inputs
+inline int median_of_three(const std::vector<int>& arr, int low, int high) {
+    int mid = low + (high - low) / 2;
+    int a = arr[low], b = arr[mid], c = arr[high];
+    if (a < b) {
+        if (b < c) return b;
+        return (a < c) ? c : a;
+    }
+    if (a < c) return a;
+    return (b < c) ? c : b;
+}
+
+// Dijkstra 3-way partition of arr[low..high]. On return arr[low..lt-1] < pivot,
+// arr[lt..gt] == pivot and arr[gt+1..high] > pivot, so runs of duplicates are
+// excluded from both recursive calls.
+inline void partition_3way(std::vector<int>& arr, int low, int high, int& lt, int& gt) {
+    int pivot = median_of_three(arr, low, high);
+    lt = low;
+    gt = high;
+    int i = low;
+
+    while (i <= gt) {
+        if (arr[i] < pivot) {
+            std::swap(arr[lt++], arr[i++]);
+        } else if (arr[i] > pivot) {
+            std::swap(arr[i], arr[gt--]);
+        } else {
+            i++;
+        }
+    }
+}
+
+// Sequential 3-way quicksort; recurses on the smaller side to bound stack depth
+inline void quicksort_3way_sequential(std::vector<int>& arr, int low, int high) {
+    while (high - low >= INSERTION_SORT_CUTOFF) {
+        int lt, gt;
+        partition_3way(arr, low, high, lt, gt);
+
+        if (lt - low < high - gt) {
+            quicksort_3way_sequential(arr, low, lt - 1);
+            low = gt + 1;
+        } else {
+            quicksort_3way_sequential(arr, gt + 1, high);
+            high = lt - 1;
+        }
+    }
+    insertion_sort(arr, low, high);
+}
+
+// Task-based 3-way quicksort; ranges smaller than cutoff run sequentially
+inline void quicksort_3way_task(std::vector<int>& arr, int low, int high, int cutoff) {
+    if (high - low < cutoff) {
+        quicksort_3way_sequential(arr, low, high);
+        return;
+    }
+
+    int lt, gt;
+    partition_3way(arr, low, high, lt, gt);
+
+    #pragma omp task shared(arr) firstprivate(low, lt, cutoff)
+    {
+        quicksort_3way_task(arr, low, lt - 1, cutoff);
+    }
+
+    quicksort_3way_task(arr, gt + 1, high, cutoff);
+
+    #pragma omp taskwait
+}
+
+// Wrapper for parallel 3-way quicksort
+inline void quicksort_3way_parallel(std::vector<int>& arr, int cutoff) {
+    PERF_SCOPE("3-way quicksort (tasks)");
+    if (arr.size() < 2) return;
+
+    #pragma omp parallel
+    {
+        #pragma omp single
+        {
+            quicksort_3way_task(arr, 0, static_cast<int>(arr.size()) - 1, cutoff);
+        }
+    }
+}
+
+//==============================================================================
+// Bucket offsets (shared by sample sort and radix sort)
+//==============================================================================
+
+// counts holds one row of num_buckets histogram counts per thread. Replace
+// every count by an exclusive prefix sum in (bucket, thread) order: all of
+// bucket 0 (thread 0 first), then all of bucket 1, ... Each thread can then
+// scatter its block to private, disjoint ranges without atomics, and a thread
+// that scans its block in order keeps equal keys in input order (stable).
+// If bucket_start is not null it receives the num_buckets + 1 bucket bounds.
+// The work is team x num_buckets, independent of n, so one thread does it.
+inline void bucket_offsets(std::vector<int64_t>& counts, int team, int num_buckets,
+                           int64_t* bucket_start = nullptr) {
+    int64_t running = 0;
+    for (int b = 0; b < num_buckets; b++) {
+        if (bucket_start) bucket_start[b] = running;
+        for (int t = 0; t < team; t++) {
+            int64_t c = counts[static_cast<size_t>(t) * num_buckets + b];
+            counts[static_cast<size_t>(t) * num_buckets + b] = running;
+            running += c;
+        }
+    }
+    if (bucket_start) bucket_start[num_buckets] = running;
+}
+
+//==============================================================================
+// Parallel sample sort
+//==============================================================================
+
+// Sort arr with a parallel sample sort:
+//   1. every thread draws evenly spaced samples from its block of the input,
+//      the (small) sample is sorted and num_buckets - 1 splitters are picked;
+//   2. every thread counts how many of its elements fall into each bucket;
+//   3. a prefix sum over (bucket, thread) gives each thread private write
+//      offsets, so the scatter into the scratch buffer needs no atomics;
+//   4. buckets are sorted independently with dynamic scheduling.
+// No step is serial in n: the top-level O(n) partition that caps quicksort
+// speedup is replaced by two parallel passes over the data.
+//
+// min_bucket_size controls granularity: the target bucket count is
+// n / min_bucket_size, clamped to [number of threads, 64 x threads].
+inline void sample_sort(std::vector<int>& arr, int min_bucket_size = 10000, int oversampling = 32) {
+    PERF_SCOPE("Sample sort");
+    const int64_t n = static_cast<int64_t>(arr.size());
+    const int num_threads = omp_get_max_threads();
+
+    if (n < 2) return;
+    if (num_threads == 1 || n < 2 * static_cast<int64_t>(std::max(min_bucket_size, INSERTION_SORT_CUTOFF))) {
+        quicksort_3way_sequential(arr, 0, static_cast<int>(n) - 1);
+        return;
+    }
+
+    int64_t target_buckets = n / std::max(1, min_bucket_size);
+    const int num_buckets = static_cast<int>(std::max<int64_t>(num_threads,
+                                   std::min<int64_t>(target_buckets, 64LL * num_threads)));
+    oversampling = std::max(1, oversampling);
+
+    // Step 1: parallel sampling, then splitter selection from the sorted sample
+    const int64_t total_samples = static_cast<int64_t>(num_buckets) * oversampling;
+    std::vector<int> samples(static_cast<size_t>(total_samples));
+
+    #pragma omp parallel for schedule(static)
+    for (int64_t s = 0; s < total_samples; s++) {
+        // Stride through the input; the +stride/2 offset avoids always hitting block starts
+        int64_t index = (s * n + n / (2 * total_samples)) / total_samples;
+        samples[s] = arr[std::min(index, n - 1)];
+    }
+    std::sort(samples.begin(), samples.end());
+
+    std::vector<int> splitters(num_buckets - 1);
+    for (int b = 1; b < num_buckets; b++) {
+        splitters[b - 1] = samples[static_cast<size_t>(b) * oversampling];
+    }
+
+    // Elements equal to a splitter go right (upper_bound), so bucket b holds
+    // splitters[b-1] <= x < splitters[b]
+    auto bucket_of = [&splitters](int value) {
+        return static_cast<int>(std::upper_bound(splitters.begin(), splitters.end(), value) - splitters.begin());
+    };
+
+    // Step 2: per-thread bucket histograms over contiguous blocks
+    std::vector<int64_t> counts(static_cast<size_t>(num_threads) * num_buckets, 0);
+    std::vector<int> scratch(arr.size());
+    std::vector<int64_t> bucket_start(num_buckets + 1, 0);
+
+    #pragma omp parallel num_threads(num_threads)
+    {
+        const int tid = omp_get_thread_num();
+        const int team = omp_get_num_threads();
+        const int64_t begin = n * tid / team;
+        const int64_t end = n * (tid + 1) / team;
+        int64_t* my_counts = &counts[static_cast<size_t>(tid) * num_buckets];
+
+        for (int64_t i = begin; i < end; i++) {
+            my_counts[bucket_of(arr[i])]++;
+        }
+
+        #pragma omp barrier
+
+        // Step 3: exclusive scan in (bucket, thread) order turns counts into offsets
+        #pragma omp single
+        {
+            bucket_offsets(counts, team, num_buckets, bucket_start.data());
+        }
+
+        // Scatter into private, disjoint ranges of the scratch buffer
+        for (int64_t i = begin; i < end; i++) {
+            int value = arr[i];
+            scratch[my_counts[bucket_of(value)]++] = value;
+        }
+
+        #pragma omp barrier
+
+        // Step 4: sort each bucket; bucket sizes vary, so schedule dynamically
+        #pragma omp for schedule(dynamic, 1)
+        for (int b = 0; b < num_buckets; b++) {
+            int low = static_cast<int>(bucket_start[b]);
+            int high = static_cast<int>(bucket_start[b + 1]) - 1;
+
+            // Heavily duplicated keys pile into one bucket; the 3-way partition
+            // retires each run of equal keys in a single pass
+            if (low < high) {
+                quicksort_3way_sequential(scratch, low, high);
+            }
+        }
+    }
+
+    arr.swap(scratch);
+}
+
+//==============================================================================
+// Parallel LSD radix sort
+//==============================================================================
+
+constexpr int RADIX_BITS = 8;
+constexpr int RADIX_BUCKETS = 1 << RADIX_BITS;
+constexpr int RADIX_PASSES = 32 / RADIX_BITS;
+
+// Digit of a key for the pass at shift. Flipping the sign bit maps signed
+// order onto unsigned order, so negative keys sort before positive ones.
+inline int radix_digit(int value, int shift) {
+    return static_cast<int>(((static_cast<uint32_t>(value) ^ 0x80000000u) >> shift) & (RADIX_BUCKETS - 1));
+}
+
+// Sort arr with a parallel least-significant-digit radix sort, 8 bits per pass:
+//   1. every thread builds a 256-bin histogram of the digit over its block;
+//   2. bucket_offsets scans the histograms in (digit, thread) order;
+//   3. every thread scatters its block in order into the other buffer.
+// Blocks are the same in every pass, so each pass is stable and four passes
+// sort 32-bit keys in O(n) work with no comparisons. A pass in which every key
+// has the same digit would only copy, so it is skipped: keys in [0, 2^24) take
+// three passes.
+inline void radix_sort(std::vector<int>& arr) {
+    PERF_SCOPE("Radix sort (LSD)");
+    const int64_t n = static_cast<int64_t>(arr.size());
+    if (n < 2) return;
+    if (n <= INSERTION_SORT_CUTOFF) {
+        insertion_sort(arr, 0, static_cast<int>(n) - 1);
+        return;
+    }
+
+    const int num_threads = omp_get_max_threads();
+    std::vector<int64_t> counts(static_cast<size_t>(num_threads) * RADIX_BUCKETS);
+    std::vector<int> scratch(arr.size());
+    int* src = arr.data();
+    int* dst = scratch.data();
+    bool skip_pass = false;
+
+    #pragma omp parallel num_threads(num_threads)
+    {
+        const int tid = omp_get_thread_num();
+        const int team = omp_get_num_threads();
+        const int64_t begin = n * tid / team;
+        const int64_t end = n * (tid + 1) / team;
+        int64_t* my_counts = &counts[static_cast<size_t>(tid) * RADIX_BUCKETS];
+
+        for (int pass = 0; pass < RADIX_PASSES; pass++) {
+            const int shift = pass * RADIX_BITS;
+
+            std::fill(my_counts, my_counts + RADIX_BUCKETS, 0);
+            for (int64_t i = begin; i < end; i++) {
+                my_counts[radix_digit(src[i], shift)]++;
+            }
+
+            #pragma omp barrier
+
+            #pragma omp single
+            {
+                // All keys share this digit when one bucket holds all n of them
+                int64_t first_bucket = 0;
+                for (int t = 0; t < team; t++) {
+                    first_bucket += counts[static_cast<size_t>(t) * RADIX_BUCKETS + radix_digit(src[0], shift)];
+                }
+                skip_pass = first_bucket == n;
+                if (!skip_pass) {
+                    bucket_offsets(counts, team, RADIX_BUCKETS);
+                }
+            }
+
+            if (!skip_pass) {
+                for (int64_t i = begin; i < end; i++) {
+                    int value = src[i];
+                    dst[my_counts[radix_digit(value, shift)]++] = value;
+                }
+
+                #pragma omp barrier
+
+                #pragma omp single
+                {
+                    std::swap(src, dst);
+                }
+            }
+        }
+    }
+
+    // An odd number of scatter passes leaves the result in the scratch buffer
+    if (src != arr.data()) {
+        arr.swap(scratch);
+    }
+}
+
+//==============================================================================
+// Task-parallel merge sort with parallel merge
+//==============================================================================
+
+// Output blocks of a parallel merge are never smaller than this
+constexpr int64_t MIN_MERGE_BLOCK = 4096;
+
+// Co-rank: the split i + j = k such that merging a[0..i) with b[0..j) gives
+// the first k elements of merge(a, b). Ties take a first, like std::merge,
+// so the merge stays stable. Binary search over i, O(log min(na, nb)).
+inline void co_rank(int64_t k, const int* a, int64_t na, const int* b, int64_t nb, int64_t& i, int64_t& j) {
+    int64_t low = std::max<int64_t>(0, k - nb);
+    int64_t high = std::min(k, na);
+    while (true) {
+        i = low + (high - low) / 2;
+        j = k - i;
+        if (i > 0 && j < nb && a[i - 1] > b[j]) {
+            high = i - 1;       // Took an a element that belongs after b[j]
+        } else if (j > 0 && i < na && b[j - 1] >= a[i]) {
+            low = i + 1;        // Took a b element that belongs after a[i]
+        } else {
+            return;
+        }
+    }
+}
+
+// Merge sorted a and b into out. The output is cut into blocks of at least
+// grain elements; each block finds its input ranges with co_rank at both ends
+// and merges them sequentially, so blocks are independent tasks. This removes
+// the O(n) sequential merge at the top of the recursion.
+inline void parallel_merge(const int* a, int64_t na, const int* b, int64_t nb, int* out, int64_t grain) {
+    const int64_t total = na + nb;
+    grain = std::max(grain, MIN_MERGE_BLOCK);
+    if (total <= grain) {
+        std::merge(a, a + na, b, b + nb, out);
+        return;
+    }
+
+    const int64_t blocks = (total + grain - 1) / grain;
+    for (int64_t block = 0; block < blocks; block++) {
+        #pragma omp task firstprivate(block)
+        {
+            const int64_t k_begin = total * block / blocks;
+            const int64_t k_end = total * (block + 1) / blocks;
+            int64_t i_begin, j_begin, i_end, j_end;
+            co_rank(k_begin, a, na, b, nb, i_begin, j_begin);
+            co_rank(k_end, a, na, b, nb, i_end, j_end);
+            std::merge(a + i_begin, a + i_end, b + j_begin, b + j_end, out + k_begin);
+        }
+    }
+    #pragma omp taskwait
+}
+
+// Task-based merge sort of data[0..n). The halves are sorted into the other
+// buffer and merged back, alternating level by level, so there is no copy
+// step: the result ends in scratch if into_scratch, otherwise in data.
+// Ranges smaller than cutoff are sorted sequentially.
+inline void merge_sort_task(int* data, int* scratch, int64_t n, int64_t cutoff, bool into_scratch) {
+    if (n <= cutoff) {
+        std::sort(data, data + n);
+        if (into_scratch) {
+            std::copy(data, data + n, scratch);
+        }
+        return;
+    }
+
+    const int64_t half = n / 2;
+
+    #pragma omp task
+    merge_sort_task(data, scratch, half, cutoff, !into_scratch);
+
+    merge_sort_task(data + half, scratch + half, n - half, cutoff, !into_scratch);
+
+    #pragma omp taskwait
+
+    const int* src = into_scratch ? data : scratch;
+    int* dst = into_scratch ? scratch : data;
+    parallel_merge(src, half, src + half, n - half, dst, cutoff);
+}
+
+// Wrapper for parallel merge sort
+inline void merge_sort_parallel(std::vector<int>& arr, int cutoff) {
+    PERF_SCOPE("Merge sort (tasks)");
+    if (arr.size() < 2) return;
+
+    std::vector<int> scratch(arr.size());
+    const int64_t leaf = std::max(cutoff, INSERTION_SORT_CUTOFF);
+
+    #pragma omp parallel
+    {
+        #pragma omp single
+        {
+            merge_sort_task(arr.data(), scratch.data(), static_cast<int64_t>(arr.size()), leaf, false);
+        }
+    }
+}
+
+} // namespace parallel_sort
+
+#endif // PARALLEL_SORT_H
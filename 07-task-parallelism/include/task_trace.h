@@ -0,0 +1,386 @@
+#ifndef TASK_TRACE_H
+#define TASK_TRACE_H
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <omp.h>
+
+namespace task_trace {
+
+//==============================================================================
+// Binary trace format
+//==============================================================================
+//
+// A trace file is the 8-byte magic "OMPTRC01" followed by chunks, each
+// starting with a one-byte tag:
+//   'N' name:   uint32 name_id, uint32 length, length bytes of UTF-8
+//   'E' events: uint32 count, count x EventRecord
+// Names are written when interned, so they always precede the events that
+// use them and a reader can process the file in a single pass. All integers
+// are little-endian (the byte order of every supported target).
+
+constexpr char TRACE_MAGIC[8] = {'O', 'M', 'P', 'T', 'R', 'C', '0', '1'};
+constexpr char CHUNK_NAME = 'N';
+constexpr char CHUNK_EVENTS = 'E';
+
+// One completed task: 32 bytes, no strings
+struct EventRecord {
+    uint64_t start_ns;   // since the writer was opened
+    uint64_t end_ns;
+    uint64_t task_id;
+    uint32_t name_id;
+    uint32_t thread_id;
+};
+
+static_assert(sizeof(EventRecord) == 32, "EventRecord must stay 32 bytes");
+
+// Reader limits: ids beyond these mean a corrupt file, not a real trace
+constexpr uint32_t MAX_TRACE_NAMES = 1u << 20;
+constexpr uint32_t MAX_TRACE_THREADS = 1u << 16;
+
+//==============================================================================
+// Thread ids
+//==============================================================================
+
+// Small dense id of the calling OS thread, assigned on first use and stable for
+// the thread's lifetime. omp_get_thread_num() does not identify a thread:
+// nested teams and non-OpenMP threads reuse the same numbers, which would merge
+// their events into one track.
+inline int current_thread_id() {
+    static std::atomic<int> next_id{0};
+    thread_local const int id = next_id.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+//==============================================================================
+// Streaming writer
+//==============================================================================
+
+// Writes events while the run is in progress. Each thread fills its own
+// cache-line-aligned buffer of RECORDS_PER_FLUSH records and appends it to the
+// file as one 'E' chunk when full, so memory stays bounded for any number of
+// tasks and the hot path is a timestamp read plus a 32-byte store.
+//
+// Intern every name before the parallel region (intern takes a lock); record
+// with the returned id. thread_id must be current_thread_id() of the calling
+// thread; ids beyond the buffers sized at construction share a mutex-protected
+// buffer.
+// close() (or the destructor) flushes the remaining buffers and must run
+// outside the parallel region.
+class TraceWriter {
+public:
+    static constexpr size_t RECORDS_PER_FLUSH = 4096;
+
+private:
+    struct alignas(64) ThreadBuffer {
+        std::vector<EventRecord> records;
+    };
+
+    std::ofstream file;
+    std::vector<ThreadBuffer> buffers;
+    ThreadBuffer overflow;
+    std::mutex overflow_mutex;
+    std::mutex file_mutex;
+    std::map<std::string, uint32_t> name_ids;
+    std::chrono::steady_clock::time_point epoch;
+    uint64_t events_written = 0;
+
+    // Caller holds file_mutex
+    void write_chunk(const std::vector<EventRecord>& records) {
+        if (records.empty()) return;
+        uint32_t count = static_cast<uint32_t>(records.size());
+        file.put(CHUNK_EVENTS);
+        file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        file.write(reinterpret_cast<const char*>(records.data()),
+                   static_cast<std::streamsize>(records.size() * sizeof(EventRecord)));
+        events_written += count;
+    }
+
+    void flush_buffer(std::vector<EventRecord>& records) {
+        std::lock_guard<std::mutex> lock(file_mutex);
+        write_chunk(records);
+        records.clear();
+    }
+
+public:
+    explicit TraceWriter(const std::string& path, int max_threads = std::max(omp_get_max_threads(), 64))
+        : file(path, std::ios::binary | std::ios::trunc),
+          buffers(static_cast<size_t>(std::max(1, max_threads))),
+          epoch(std::chrono::steady_clock::now()) {
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open trace file " << path << " for writing." << std::endl;
+            return;
+        }
+        file.write(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+        for (auto& buffer : buffers) {
+            buffer.records.reserve(RECORDS_PER_FLUSH);
+        }
+    }
+
+    ~TraceWriter() {
+        close();
+    }
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    bool is_open() const {
+        return file.is_open();
+    }
+
+    // Id for a name, writing it to the file the first time it is seen
+    uint32_t intern(const std::string& name) {
+        std::lock_guard<std::mutex> lock(file_mutex);
+        auto it = name_ids.find(name);
+        if (it != name_ids.end()) return it->second;
+
+        uint32_t id = static_cast<uint32_t>(name_ids.size());
+        name_ids.emplace(name, id);
+        if (file.is_open()) {
+            uint32_t length = static_cast<uint32_t>(name.size());
+            file.put(CHUNK_NAME);
+            file.write(reinterpret_cast<const char*>(&id), sizeof(id));
+            file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+            file.write(name.data(), length);
+        }
+        return id;
+    }
+
+    // Nanoseconds since the writer was opened
+    uint64_t now() const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - epoch).count());
+    }
+
+    void record(uint32_t name_id, uint64_t task_id, int thread_id, uint64_t start_ns, uint64_t end_ns) {
+        EventRecord event{start_ns, end_ns, task_id, name_id, static_cast<uint32_t>(thread_id)};
+
+        if (thread_id >= 0 && thread_id < static_cast<int>(buffers.size())) {
+            auto& records = buffers[thread_id].records;
+            records.push_back(event);
+            if (records.size() >= RECORDS_PER_FLUSH) {
+                flush_buffer(records);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(overflow_mutex);
+        overflow.records.push_back(event);
+        if (overflow.records.size() >= RECORDS_PER_FLUSH) {
+            flush_buffer(overflow.records);
+        }
+    }
+
+    // Flush all buffers and close the file; safe to call more than once
+    void close() {
+        if (!file.is_open()) return;
+        {
+            std::lock_guard<std::mutex> lock(file_mutex);
+            for (auto& buffer : buffers) {
+                write_chunk(buffer.records);
+                buffer.records.clear();
+            }
+            write_chunk(overflow.records);
+            overflow.records.clear();
+        }
+        file.close();
+    }
+
+    uint64_t get_events_written() const {
+        return events_written;
+    }
+};
+
+// Records one event covering its own lifetime
+//   { task_trace::TraceScope scope(writer, name_id, task_id); ...work... }
+class TraceScope {
+private:
+    TraceWriter& writer;
+    uint32_t name_id;
+    uint64_t task_id;
+    int thread_id;
+    uint64_t start_ns;
+
+public:
+    TraceScope(TraceWriter& w, uint32_t name, uint64_t task, int thread = current_thread_id())
+        : writer(w), name_id(name), task_id(task), thread_id(thread), start_ns(w.now()) {}
+
+    ~TraceScope() {
+        writer.record(name_id, task_id, thread_id, start_ns, writer.now());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+
+//==============================================================================
+// Chrome trace-event / Perfetto export
+//==============================================================================
+
+// Escape a name for a JSON string literal
+inline std::string json_escape(const std::string& text) {
+    std::string result;
+    result.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+            case '"': result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+                    result += escaped;
+                } else {
+                    result += c;
+                }
+        }
+    }
+    return result;
+}
+
+// Convert a binary trace into Chrome trace-event JSON ("X" complete events,
+// microsecond timestamps) that chrome://tracing and ui.perfetto.dev open
+// directly. Streams chunk by chunk, so memory use does not grow with the
+// number of events. Events with an out-of-range thread id are skipped with a
+// warning rather than failing the export. Returns the number of events
+// exported, or -1 on error.
+inline long long export_chrome_json(const std::string& trace_path, const std::string& json_path,
+                                    const std::string& process_name = "OpenMP tasks") {
+    std::ifstream in(trace_path, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "Error: Could not open trace file " << trace_path << std::endl;
+        return -1;
+    }
+
+    in.seekg(0, std::ios::end);
+    const uint64_t file_size = static_cast<uint64_t>(in.tellg());
+    in.seekg(0, std::ios::beg);
+
+    char magic[sizeof(TRACE_MAGIC)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0) {
+        std::cerr << "Error: " << trace_path << " is not a task trace file." << std::endl;
+        return -1;
+    }
+
+    // Sizes read from the file are checked against the bytes left before
+    // anything is allocated, so a corrupt count cannot trigger a huge resize
+    auto remaining = [&]() -> uint64_t {
+        const std::streamoff position = in.tellg();
+        return position < 0 ? 0 : file_size - static_cast<uint64_t>(position);
+    };
+
+    std::ofstream out(json_path);
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not open file " << json_path << " for writing." << std::endl;
+        return -1;
+    }
+
+    std::vector<std::string> names;
+    std::vector<EventRecord> records;
+    std::vector<bool> thread_seen;
+    long long exported = 0;
+    long long skipped = 0;
+    bool first = true;
+
+    auto separator = [&]() -> const char* {
+        if (first) { first = false; return "\n"; }
+        return ",\n";
+    };
+
+    out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+    out << separator() << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": 0, "
+        << "\"args\": {\"name\": \"" << json_escape(process_name) << "\"}}";
+
+    char tag;
+    while (in.get(tag)) {
+        if (tag == CHUNK_NAME) {
+            uint32_t id = 0, length = 0;
+            in.read(reinterpret_cast<char*>(&id), sizeof(id));
+            in.read(reinterpret_cast<char*>(&length), sizeof(length));
+            if (!in || length > remaining()) {
+                std::cerr << "Warning: Trace file " << trace_path << " is truncated." << std::endl;
+                break;
+            }
+            if (id >= MAX_TRACE_NAMES) {
+                std::cerr << "Error: Corrupt name id " << id << " in trace file " << trace_path << std::endl;
+                return -1;
+            }
+            std::string name(length, '\0');
+            in.read(&name[0], length);
+            if (!in) {
+                std::cerr << "Warning: Trace file " << trace_path << " is truncated." << std::endl;
+                break;
+            }
+            if (names.size() <= id) names.resize(id + 1);
+            names[id] = json_escape(name);
+        } else if (tag == CHUNK_EVENTS) {
+            uint32_t count = 0;
+            in.read(reinterpret_cast<char*>(&count), sizeof(count));
+            if (!in || static_cast<uint64_t>(count) * sizeof(EventRecord) > remaining()) {
+                std::cerr << "Warning: Trace file " << trace_path << " is truncated." << std::endl;
+                break;
+            }
+            records.resize(count);
+            in.read(reinterpret_cast<char*>(records.data()), static_cast<std::streamsize>(count * sizeof(EventRecord)));
+            if (!in) {
+                std::cerr << "Warning: Trace file " << trace_path << " is truncated." << std::endl;
+                break;
+            }
+
+            for (const auto& event : records) {
+                if (event.thread_id >= MAX_TRACE_THREADS) {
+                    skipped++;
+                    continue;
+                }
+                if (thread_seen.size() <= event.thread_id) thread_seen.resize(event.thread_id + 1, false);
+                if (!thread_seen[event.thread_id]) {
+                    thread_seen[event.thread_id] = true;
+                    out << separator() << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": "
+                        << event.thread_id << ", \"args\": {\"name\": \"Thread " << event.thread_id << "\"}}";
+                }
+
+                const std::string& name = event.name_id < names.size() ? names[event.name_id] : std::string("task");
+                uint64_t duration = event.end_ns >= event.start_ns ? event.end_ns - event.start_ns : 0;
+                // Timestamps are microseconds; keep nanosecond resolution as decimals
+                out << separator() << "{\"name\": \"" << name << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": "
+                    << event.thread_id
+                    << ", \"ts\": " << event.start_ns / 1000 << "." << std::setw(3) << std::setfill('0') << event.start_ns % 1000
+                    << ", \"dur\": " << duration / 1000 << "." << std::setw(3) << duration % 1000 << std::setfill(' ')
+                    << ", \"args\": {\"task_id\": " << event.task_id << "}}";
+                exported++;
+            }
+        } else {
+            std::cerr << "Error: Corrupt chunk in trace file " << trace_path << std::endl;
+            return -1;
+        }
+    }
+
+    if (skipped > 0) {
+        std::cerr << "Warning: Skipped " << skipped << " events with out-of-range thread ids in "
+                  << trace_path << std::endl;
+    }
+
+    out << "\n]}\n";
+    if (!out) {
+        std::cerr << "Error: Failed writing " << json_path << std::endl;
+        return -1;
+    }
+    return exported;
+}
+
+} // namespace task_trace
+
+#endif // TASK_TRACE_H
@@ -14,7 +14,18 @@
 #include <mutex>
 #include <atomic>
 #include <thread>
+#include <condition_variable>
+#include <memory>
+#include <cstdint>
+#include <type_traits>
+#include <limits>
+#include <fstream>
+#include <sstream>
+#include <cctype>
+#include <deque>
 #include <omp.h>
+#include "bench_core.h"
+#include "task_trace.h"
 
 namespace task_utils {
 
@@ -22,78 +33,51 @@ namespace task_utils {
 // Timing utilities
 //==============================================================================
 
-// Measure execution time of a function
+// Measure execution time of a function in seconds, on the shared calibrated clock
 template<typename Func, typename... Args>
 double measure_time(Func func, Args&&... args) {
-    auto start = std::chrono::high_resolution_clock::now();
+    const bench::Clock::Ticks start = bench::Clock::now();
     func(std::forward<Args>(args)...);
-    auto end = std::chrono::high_resolution_clock::now();
-    return std::chrono::duration<double>(end - start).count();
+    return bench::Clock::toNanoseconds(bench::Clock::now() - start) * 1e-9;
 }
 
-// Measure execution time with multiple runs and return statistics
+// Measure execution time with multiple runs and return {mean, standard deviation}
+// in seconds; the shared warmup policy (BENCH_WARMUP) runs first
 template<typename Func, typename... Args>
 std::pair<double, double> measure_time_stats(Func func, Args&&... args, int num_runs = 5) {
-    std::vector<double> times;
-    times.reserve(num_runs);
-    
-    for (int i = 0; i < num_runs; ++i) {
-        double time = measure_time(func, std::forward<Args>(args)...);
-        times.push_back(time);
-    }
-    
-    // Calculate mean
-    double sum = 0.0;
-    for (double t : times) {
-        sum += t;
-    }
-    double mean = sum / num_runs;
-    
-    // Calculate standard deviation
-    double sq_sum = 0.0;
-    for (double t : times) {
-        sq_sum += (t - mean) * (t - mean);
-    }
-    double std_dev = std::sqrt(sq_sum / num_runs);
-    
-    return {mean, std_dev};
+    const bench::Stats stats = bench::measure([&]() { func(std::forward<Args>(args)...); },
+                                              bench::RunPolicy::repetitions(num_runs));
+    return {stats.meanMs * 1e-3, stats.stddevMs * 1e-3};
 }
 
 // Class for timing task executions
 class TaskTimer {
 private:
-    std::chrono::time_point<std::chrono::high_resolution_clock> start_time;
-    bool running;
+    bench::Timer timer;
     double elapsed_seconds;
     
 public:
-    TaskTimer() : running(false), elapsed_seconds(0.0) {}
+    TaskTimer() : elapsed_seconds(0.0) {}
     
     void start() {
-        start_time = std::chrono::high_resolution_clock::now();
-        running = true;
+        timer.start();
     }
     
     double stop() {
-        if (!running) return elapsed_seconds;
+        if (!timer.isRunning()) return elapsed_seconds;
         
-        auto end_time = std::chrono::high_resolution_clock::now();
-        elapsed_seconds = std::chrono::duration<double>(end_time - start_time).count();
-        running = false;
+        timer.stop();
+        elapsed_seconds = timer.elapsedSeconds();
         return elapsed_seconds;
     }
     
     void reset() {
         elapsed_seconds = 0.0;
-        running = false;
+        timer.reset();
     }
     
     double elapsed() const {
-        if (running) {
-            auto current_time = std::chrono::high_resolution_clock::now();
-            return std::chrono::duration<double>(current_time - start_time).count();
-        }
-        return elapsed_seconds;
+        return timer.isRunning() ? timer.elapsedSeconds() : elapsed_seconds;
     }
 };
 
@@ -398,75 +382,189 @@ struct TaskEvent {
         : task_id(id), thread_id(thread), start_time(start), end_time(0), task_name(name) {}
 };
 
+// Compile-time switch for TaskTracker. Define TASK_UTILS_ENABLE_TRACKING=0
+// before including this header to turn every record call into a no-op, so
+// instrumented code can be timed without any tracking overhead.
+#ifndef TASK_UTILS_ENABLE_TRACKING
+#define TASK_UTILS_ENABLE_TRACKING 1
+#endif
+
+constexpr bool TASK_TRACKING_ENABLED = (TASK_UTILS_ENABLE_TRACKING != 0);
+
 // Global task tracker
+//
+// Every thread appends to its own cache-line-aligned buffer, so recording
+// needs no lock and no search: record_start returns the slot of the new event
+// and record_end(task_id, thread_id, slot) closes it in O(1). Buffers are only
+// merged when the events are read back (get_events / visualize_execution),
+// which must happen outside the parallel region that records them.
+//
+// The buffer is chosen by task_trace::current_thread_id(), which stays unique
+// under nested parallelism; thread_id is only the label stored with the event
+// (pass current_thread_id() too for one timeline row per OS thread). Threads
+// beyond the buffers sized at construction fall back to a shared,
+// mutex-protected overflow buffer. record_end must run on the thread that
+// called record_start.
 class TaskTracker {
 private:
-    std::vector<TaskEvent> events;
-    std::mutex tracker_mutex;
+    struct alignas(64) ThreadBuffer {
+        std::vector<TaskEvent> events;
+    };
+    
+    std::vector<ThreadBuffer> buffers;
+    ThreadBuffer overflow;
+    std::mutex overflow_mutex;
     double program_start_time;
     
+    template<typename Func>
+    void for_each_event(Func func) const {
+        for (const auto& buffer : buffers) {
+            for (const auto& event : buffer.events) {
+                func(event);
+            }
+        }
+        for (const auto& event : overflow.events) {
+            func(event);
+        }
+    }
+    
+    bool has_events() const {
+        if (!overflow.events.empty()) return true;
+        for (const auto& buffer : buffers) {
+            if (!buffer.events.empty()) return true;
+        }
+        return false;
+    }
+    
 public:
-    TaskTracker() : program_start_time(omp_get_wtime()) {}
+    explicit TaskTracker(int max_threads = std::max(omp_get_max_threads(), 64))
+        : buffers(static_cast<size_t>(std::max(1, max_threads))), program_start_time(omp_get_wtime()) {}
     
     // Delete copy constructor and assignment operator
     TaskTracker(const TaskTracker&) = delete;
     TaskTracker& operator=(const TaskTracker&) = delete;
     
-    // Move constructor and assignment operator
-    TaskTracker(TaskTracker&& other) noexcept {
-        // Lock the source object's mutex
-        std::lock_guard<std::mutex> lock(other.tracker_mutex);
-        events = std::move(other.events);
-        program_start_time = other.program_start_time;
-    }
+    // Move operations must not race with recording on either tracker
+    TaskTracker(TaskTracker&& other) noexcept
+        : buffers(std::move(other.buffers)), overflow(std::move(other.overflow)),
+          program_start_time(other.program_start_time) {}
     
     TaskTracker& operator=(TaskTracker&& other) noexcept {
         if (this != &other) {
-            // Lock both mutexes to prevent deadlock
-            std::lock(tracker_mutex, other.tracker_mutex);
-            std::lock_guard<std::mutex> lock1(tracker_mutex, std::adopt_lock);
-            std::lock_guard<std::mutex> lock2(other.tracker_mutex, std::adopt_lock);
-            
-            events = std::move(other.events);
+            buffers = std::move(other.buffers);
+            overflow = std::move(other.overflow);
             program_start_time = other.program_start_time;
         }
         return *this;
     }
     
+    // Reserve per-thread capacity up front so recording never reallocates
+    void reserve(size_t events_per_thread) {
+        for (auto& buffer : buffers) {
+            buffer.events.reserve(events_per_thread);
+        }
+    }
+    
     void reset() {
-        std::lock_guard<std::mutex> lock(tracker_mutex);
-        events.clear();
+        for (auto& buffer : buffers) {
+            buffer.events.clear();
+        }
+        overflow.events.clear();
         program_start_time = omp_get_wtime();
     }
     
-    void record_start(int task_id, int thread_id, const std::string& task_name = "") {
-        std::lock_guard<std::mutex> lock(tracker_mutex);
-        events.emplace_back(task_id, thread_id, omp_get_wtime() - program_start_time, task_name);
+    // Returns the slot to pass to record_end
+    size_t record_start(int task_id, int thread_id, const std::string& task_name = "") {
+        if constexpr (!TASK_TRACKING_ENABLED) {
+            (void)task_id; (void)thread_id; (void)task_name;
+            return 0;
+        } else {
+            double now = omp_get_wtime() - program_start_time;
+            const int buffer_id = task_trace::current_thread_id();
+            if (buffer_id < static_cast<int>(buffers.size())) {
+                auto& events = buffers[buffer_id].events;
+                events.emplace_back(task_id, thread_id, now, task_name);
+                return events.size() - 1;
+            }
+            
+            std::lock_guard<std::mutex> lock(overflow_mutex);
+            overflow.events.emplace_back(task_id, thread_id, now, task_name);
+            return overflow.events.size() - 1;
+        }
+    }
+    
+    // O(1) completion of the event returned by record_start
+    void record_end(int task_id, int thread_id, size_t slot) {
+        if constexpr (!TASK_TRACKING_ENABLED) {
+            (void)task_id; (void)thread_id; (void)slot;
+        } else {
+            double now = omp_get_wtime() - program_start_time;
+            const int buffer_id = task_trace::current_thread_id();
+            if (buffer_id < static_cast<int>(buffers.size())) {
+                auto& events = buffers[buffer_id].events;
+                if (slot < events.size() && events[slot].task_id == task_id) {
+                    events[slot].end_time = now;
+                }
+                return;
+            }
+            
+            std::lock_guard<std::mutex> lock(overflow_mutex);
+            if (slot < overflow.events.size() && overflow.events[slot].task_id == task_id) {
+                overflow.events[slot].end_time = now;
+            }
+        }
     }
     
+    // Completion without a slot: searches the calling thread's own buffer
+    // backwards for the newest open event with this id
     void record_end(int task_id, int thread_id) {
-        std::lock_guard<std::mutex> lock(tracker_mutex);
-        
-        // Find the task event and update its end time
-        for (auto it = events.rbegin(); it != events.rend(); ++it) {
-            if (it->task_id == task_id && it->thread_id == thread_id && it->end_time == 0) {
-                it->end_time = omp_get_wtime() - program_start_time;
-                break;
+        if constexpr (!TASK_TRACKING_ENABLED) {
+            (void)task_id; (void)thread_id;
+        } else {
+            double now = omp_get_wtime() - program_start_time;
+            auto close_latest = [&](std::vector<TaskEvent>& events) {
+                for (auto it = events.rbegin(); it != events.rend(); ++it) {
+                    if (it->task_id == task_id && it->thread_id == thread_id && it->end_time == 0) {
+                        it->end_time = now;
+                        break;
+                    }
+                }
+            };
+            
+            const int buffer_id = task_trace::current_thread_id();
+            if (buffer_id < static_cast<int>(buffers.size())) {
+                close_latest(buffers[buffer_id].events);
+                return;
             }
+            
+            std::lock_guard<std::mutex> lock(overflow_mutex);
+            close_latest(overflow.events);
         }
     }
     
-    const std::vector<TaskEvent>& get_events() const {
-        return events;
+    // Merge all per-thread buffers, ordered by start time
+    std::vector<TaskEvent> get_events() const {
+        std::vector<TaskEvent> merged;
+        size_t total = overflow.events.size();
+        for (const auto& buffer : buffers) {
+            total += buffer.events.size();
+        }
+        merged.reserve(total);
+        
+        for_each_event([&merged](const TaskEvent& event) { merged.push_back(event); });
+        std::stable_sort(merged.begin(), merged.end(), [](const TaskEvent& a, const TaskEvent& b) {
+            return a.start_time < b.start_time;
+        });
+        return merged;
     }
     
     // Get events grouped by thread
     std::map<int, std::vector<std::pair<double, double>>> get_events_by_thread() const {
         std::map<int, std::vector<std::pair<double, double>>> result;
         
-        for (const auto& event : events) {
+        for_each_event([&result](const TaskEvent& event) {
             result[event.thread_id].emplace_back(event.start_time, event.end_time);
-        }
+        });
         
         return result;
     }
@@ -474,16 +572,13 @@ public:
     // Calculate thread utilization
     std::map<int, double> calculate_thread_utilization() const {
         // Find the maximum end time
-        double max_time = 0;
-        for (const auto& event : events) {
-            max_time = std::max(max_time, event.end_time);
-        }
+        double max_time = get_max_time();
         
         // Calculate busy time for each thread
         std::map<int, double> thread_busy_time;
-        for (const auto& event : events) {
+        for_each_event([&thread_busy_time](const TaskEvent& event) {
             thread_busy_time[event.thread_id] += (event.end_time - event.start_time);
-        }
+        });
         
         // Calculate utilization percentage
         std::map<int, double> utilization;
@@ -497,15 +592,15 @@ public:
     // Get the maximum execution time
     double get_max_time() const {
         double max_time = 0;
-        for (const auto& event : events) {
+        for_each_event([&max_time](const TaskEvent& event) {
             max_time = std::max(max_time, event.end_time);
-        }
+        });
         return max_time;
     }
     
     // Visualize task execution
     void visualize_execution() const {
-        if (events.empty()) {
+        if (!has_events()) {
             std::cout << "No task events recorded." << std::endl;
             return;
         }
@@ -549,12 +644,12 @@ public:
         
         // Calculate busy times
         std::map<int, double> thread_busy_time;
-        for (const auto& event : events) {
+        for_each_event([&thread_busy_time](const TaskEvent& event) {
             // Sadece tamamlanmış işleri hesapla
             if (event.end_time > 0) {
                 thread_busy_time[event.thread_id] += (event.end_time - event.start_time);
             }
-        }
+        });
         
         double total_busy_time = 0;
         for (const auto& [thread_id, util] : utilization) {
@@ -596,6 +691,327 @@ inline bool should_parallelize(int size, int cutoff) {
     return size >= cutoff;
 }
 
+// Runtime spawn-or-inline decision for recursive task code, replacing
+// hand-tuned cutoffs. Two signals are combined:
+//   - queue depth: a task is only created while fewer than
+//     tasks_per_thread x threads spawned tasks are still waiting to start;
+//   - measured cost: every spawned task records its duration by recursion
+//     depth. Once tasks at some depth average less than min_task_seconds,
+//     too little to amortize creating them, spawning stops at that depth
+//     and below.
+// Because every level keeps asking, deep subtrees start spawning again as
+// soon as threads drain the queue (down to the learned depth), so the
+// effective cutoff adapts to thread count, input size and imbalance.
+// The depth limit only ever tightens, so a caller past it can switch to its
+// plain sequential code for the whole subtree.
+//
+//   if (controller.past_spawn_limit(depth)) return fib_sequential(n);
+//   bool spawned = controller.spawn_or_run(depth, [&]() { x = fib(n - 1, depth + 1, controller); });
+//   y = fib(n - 2, depth + 1, controller);
+//   if (spawned) {
+//       #pragma omp taskwait
+//   }
+class GranularityController {
+private:
+    static constexpr int MAX_TRACKED_DEPTH = 64;
+    static constexpr int MIN_SAMPLES = 8;
+    
+    struct alignas(64) DepthStats {
+        std::atomic<long long> total_ns{0};
+        std::atomic<int> count{0};
+    };
+    
+    alignas(64) std::atomic<int> pending;      // spawned, not yet started
+    alignas(64) std::atomic<long long> spawned;
+    std::atomic<int> depth_limit;              // deepest level still allowed to spawn
+    DepthStats depth_stats[MAX_TRACKED_DEPTH];
+    int max_pending;
+    long long min_task_ns;
+    
+    void record(int depth, long long duration_ns) {
+        DepthStats& stats = depth_stats[std::min(depth, MAX_TRACKED_DEPTH - 1)];
+        long long total = stats.total_ns.fetch_add(duration_ns, std::memory_order_relaxed) + duration_ns;
+        int count = stats.count.fetch_add(1, std::memory_order_relaxed) + 1;
+        
+        if (count >= MIN_SAMPLES && total / count < min_task_ns) {
+            // Only ever tighten the limit
+            int limit = depth_limit.load(std::memory_order_relaxed);
+            while (limit >= depth &&
+                   !depth_limit.compare_exchange_weak(limit, depth - 1, std::memory_order_relaxed)) {
+            }
+        }
+    }
+    
+public:
+    explicit GranularityController(int tasks_per_thread = 2, int num_threads = omp_get_max_threads(),
+                                   double min_task_seconds = 20e-6)
+        // A single thread gains nothing from tasks: inline everything from the start
+        : pending(0), spawned(0), depth_limit(num_threads > 1 ? std::numeric_limits<int>::max() : -1),
+          max_pending(std::max(1, tasks_per_thread * std::max(1, num_threads))),
+          min_task_ns(static_cast<long long>(min_task_seconds * 1e9)) {}
+    
+    GranularityController(const GranularityController&) = delete;
+    GranularityController& operator=(const GranularityController&) = delete;
+    
+    // Two relaxed loads; cheap enough to ask at every recursion level
+    bool should_spawn(int depth) const {
+        return depth <= depth_limit.load(std::memory_order_relaxed) &&
+               pending.load(std::memory_order_relaxed) < max_pending;
+    }
+    
+    // True once nothing at this depth or deeper will ever be spawned again
+    bool past_spawn_limit(int depth) const {
+        return depth > depth_limit.load(std::memory_order_relaxed);
+    }
+    
+    // Create func as an OpenMP task if worthwhile, otherwise run it now.
+    // depth is the recursion depth of the caller. Returns true if a task
+    // was created (the caller must taskwait before using its results).
+    template<typename Func>
+    bool spawn_or_run(int depth, Func func) {
+        if (!should_spawn(depth)) {
+            func();
+            return false;
+        }
+        
+        GranularityController* self = this;
+        pending.fetch_add(1, std::memory_order_relaxed);
+        spawned.fetch_add(1, std::memory_order_relaxed);
+        
+        #pragma omp task firstprivate(func, self, depth)
+        {
+            self->pending.fetch_sub(1, std::memory_order_relaxed);
+            auto start = std::chrono::steady_clock::now();
+            func();
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            self->record(depth, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        }
+        return true;
+    }
+    
+    long long get_spawned_tasks() const {
+        return spawned.load();
+    }
+    
+    // Deepest level still allowed to spawn (INT_MAX until a limit is learned)
+    int get_depth_limit() const {
+        return depth_limit.load();
+    }
+    
+    int get_max_pending() const {
+        return max_pending;
+    }
+};
+
+// Online grainsize tuning for a chunked task loop (the OpenMP 2.0 stand-in for
+// taskloop grainsize). Every call site is identified by a name; each call of
+// run() measures
+//   - cost per iteration c = summed task body time / iterations,
+//   - overhead per task  o = (threads x wall time - body time) / tasks,
+// and moves the site's grainsize towards the minimum of the simple model
+//   T(g) = (n*c + (n/g)*o) / P + g*c     ->     g* = sqrt(n*o / (P*c))
+// (task overhead shrinks with g, the last-chunk tail grows with it), capped so
+// every thread still gets MIN_TASKS_PER_THREAD chunks. The step is damped
+// (geometric mean of old and model value); after STABLE_RUNS_TO_CONVERGE
+// steps below CONVERGENCE_TOLERANCE the site is frozen.
+//
+// Learned values are keyed by (site, thread count) and can be saved to and
+// loaded from a small text profile, so the next process starts tuned:
+//   GrainsizeTuner tuner("grainsize.profile");
+//   tuner.run("scale_loop", 0, n, [&](int b, int e) { for (int i = b; i < e; ++i) ... });
+//   tuner.save();
+class GrainsizeTuner {
+public:
+    static constexpr int MIN_TASKS_PER_THREAD = 4;
+    static constexpr int STABLE_RUNS_TO_CONVERGE = 3;
+    static constexpr double CONVERGENCE_TOLERANCE = 0.1;
+    
+    struct SiteProfile {
+        int grainsize = 0;       // 0 = not chosen yet
+        int stable_runs = 0;
+        bool converged = false;
+        long long invocations = 0;
+        double last_cost_per_iteration = 0.0;  // seconds
+        double last_overhead_per_task = 0.0;   // seconds
+    };
+    
+private:
+    using Key = std::pair<std::string, int>;  // (site, threads)
+    
+    std::map<Key, SiteProfile> profiles;
+    std::string profile_path;
+    mutable std::mutex profiles_mutex;
+    
+    // Site names are stored as single whitespace-free tokens
+    static std::string sanitize(const std::string& site) {
+        std::string result = site.empty() ? "site" : site;
+        for (char& c : result) {
+            if (std::isspace(static_cast<unsigned char>(c))) c = '_';
+        }
+        return result;
+    }
+    
+    static int max_grainsize(int n, int threads) {
+        return std::max(1, n / (MIN_TASKS_PER_THREAD * std::max(1, threads)));
+    }
+    
+    void update(SiteProfile& profile, int n, int threads, int num_tasks, double wall, double busy) {
+        profile.invocations++;
+        if (profile.converged || n <= 0 || busy <= 0.0) return;
+        
+        double cost = busy / n;
+        double overhead = std::max(0.0, threads * wall - busy) / std::max(1, num_tasks);
+        profile.last_cost_per_iteration = cost;
+        profile.last_overhead_per_task = overhead;
+        
+        double model = std::sqrt(n * overhead / (threads * cost));
+        model = std::min(std::max(model, 1.0), static_cast<double>(max_grainsize(n, threads)));
+        
+        double current = static_cast<double>(profile.grainsize);
+        int next = std::max(1, static_cast<int>(std::lround(std::sqrt(current * model))));
+        
+        if (std::fabs(next - current) <= CONVERGENCE_TOLERANCE * current) {
+            if (++profile.stable_runs >= STABLE_RUNS_TO_CONVERGE) {
+                profile.converged = true;
+            }
+        } else {
+            profile.stable_runs = 0;
+        }
+        profile.grainsize = next;
+    }
+    
+public:
+    // An empty path disables persistence; otherwise the profile is loaded now
+    // (a missing file is not an error) and written by save()
+    explicit GrainsizeTuner(const std::string& path = "") : profile_path(path) {
+        if (!profile_path.empty()) {
+            load(profile_path);
+        }
+    }
+    
+    // Run body(chunk_begin, chunk_end) over [begin, end) as tasks of the
+    // site's current grainsize, then refine the grainsize from the timings.
+    // Opens its own parallel region; call it from serial code.
+    template<typename Body>
+    void run(const std::string& site, int begin, int end, Body body) {
+        const int n = end - begin;
+        if (n <= 0) return;
+        
+        const int threads = omp_get_max_threads();
+        const Key key(sanitize(site), threads);
+        
+        int grainsize;
+        {
+            std::lock_guard<std::mutex> lock(profiles_mutex);
+            SiteProfile& profile = profiles[key];
+            if (profile.grainsize <= 0) {
+                profile.grainsize = max_grainsize(n, threads);
+            }
+            grainsize = profile.grainsize;
+        }
+        
+        std::atomic<long long> busy_ns(0);
+        const int num_tasks = (n + grainsize - 1) / grainsize;
+        double start = omp_get_wtime();
+        
+        #pragma omp parallel
+        {
+            #pragma omp single
+            {
+                for (int i = begin; i < end; i += grainsize) {
+                    int chunk_end = std::min(i + grainsize, end);
+                    
+                    #pragma omp task firstprivate(i, chunk_end) shared(body, busy_ns)
+                    {
+                        auto t0 = std::chrono::steady_clock::now();
+                        body(i, chunk_end);
+                        auto elapsed = std::chrono::steady_clock::now() - t0;
+                        busy_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+                                          std::memory_order_relaxed);
+                    }
+                }
+            }
+        }
+        
+        double wall = omp_get_wtime() - start;
+        
+        std::lock_guard<std::mutex> lock(profiles_mutex);
+        update(profiles[key], n, threads, num_tasks, wall, busy_ns.load() * 1e-9);
+    }
+    
+    // Current grainsize for a site at the current thread count (0 if unknown)
+    int get_grainsize(const std::string& site) const {
+        std::lock_guard<std::mutex> lock(profiles_mutex);
+        auto it = profiles.find(Key(sanitize(site), omp_get_max_threads()));
+        return it != profiles.end() ? it->second.grainsize : 0;
+    }
+    
+    SiteProfile get_profile(const std::string& site) const {
+        std::lock_guard<std::mutex> lock(profiles_mutex);
+        auto it = profiles.find(Key(sanitize(site), omp_get_max_threads()));
+        return it != profiles.end() ? it->second : SiteProfile();
+    }
+    
+    bool is_converged(const std::string& site) const {
+        return get_profile(site).converged;
+    }
+    
+    // Forget a site's learned value so tuning restarts
+    void reset_site(const std::string& site) {
+        std::lock_guard<std::mutex> lock(profiles_mutex);
+        profiles.erase(Key(sanitize(site), omp_get_max_threads()));
+    }
+    
+    // Profile format, one entry per line: <site> <threads> <grainsize> <converged 0|1>
+    bool load(const std::string& path) {
+        std::ifstream in(path);
+        if (!in) return false;  // No profile yet
+        
+        std::lock_guard<std::mutex> lock(profiles_mutex);
+        std::string line;
+        int line_number = 0;
+        while (std::getline(in, line)) {
+            line_number++;
+            if (line.empty() || line[0] == '#') continue;
+            
+            std::istringstream fields(line);
+            std::string site;
+            int threads = 0, grainsize = 0, converged = 0;
+            if (!(fields >> site >> threads >> grainsize >> converged) || threads <= 0 || grainsize <= 0) {
+                std::cerr << "Error: Malformed grainsize profile entry at " << path << ":" << line_number << std::endl;
+                continue;
+            }
+            
+            SiteProfile& profile = profiles[Key(site, threads)];
+            profile.grainsize = grainsize;
+            profile.converged = converged != 0;
+            profile.stable_runs = profile.converged ? STABLE_RUNS_TO_CONVERGE : 0;
+        }
+        return true;
+    }
+    
+    bool save() const {
+        return profile_path.empty() ? false : save(profile_path);
+    }
+    
+    bool save(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out) {
+            std::cerr << "Error: Could not write grainsize profile " << path << std::endl;
+            return false;
+        }
+        
+        std::lock_guard<std::mutex> lock(profiles_mutex);
+        out << "# site threads grainsize converged\n";
+        for (const auto& [key, profile] : profiles) {
+            if (profile.grainsize <= 0) continue;
+            out << key.first << " " << key.second << " " << profile.grainsize << " "
+                << (profile.converged ? 1 : 0) << "\n";
+        }
+        return static_cast<bool>(out);
+    }
+};
+
 // Structure to define a dependency graph
 struct DependencyGraph {
     struct Node {
@@ -645,6 +1061,48 @@ struct DependencyGraph {
             std::cout << std::endl;
         }
     }
+    
+    // Upward rank of every node (same order as nodes): its cost plus the most
+    // expensive path to an exit node. Dependencies refer to node ids.
+    // Nodes on a cycle keep rank 0.
+    std::vector<int> compute_upward_ranks() const {
+        std::map<int, size_t> index_of;
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            index_of[nodes[i].id] = i;
+        }
+        
+        std::vector<std::vector<size_t>> successors(nodes.size());
+        std::vector<int> remaining(nodes.size(), 0);
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            for (int dep : nodes[i].dependencies) {
+                auto it = index_of.find(dep);
+                if (it == index_of.end()) continue;
+                successors[it->second].push_back(i);
+                remaining[i]++;
+            }
+        }
+        
+        // Kahn order, then ranks from the exits backwards
+        std::vector<size_t> order;
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            if (remaining[i] == 0) order.push_back(i);
+        }
+        for (size_t head = 0; head < order.size(); ++head) {
+            for (size_t succ : successors[order[head]]) {
+                if (--remaining[succ] == 0) order.push_back(succ);
+            }
+        }
+        
+        std::vector<int> rank(nodes.size(), 0);
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            int longest_tail = 0;
+            for (size_t succ : successors[*it]) {
+                longest_tail = std::max(longest_tail, rank[succ]);
+            }
+            rank[*it] = nodes[*it].cost + longest_tail;
+        }
+        return rank;
+    }
 };
 
 // Task throttling mechanism
@@ -682,6 +1140,778 @@ public:
     }
 };
 
+// Concurrency limiter that parks waiters instead of spinning. before_task
+// spins briefly (cheap when a slot frees up quickly), then sleeps on a
+// condition variable until after_task releases a slot, so oversubscribed
+// threads give their core back to the tasks that are running.
+class BlockingTaskThrottler {
+private:
+    std::atomic<int> active_tasks;
+    std::atomic<int> max_tasks;
+    std::atomic<int> waiters;
+    std::atomic<long long> park_count;
+    int spin_limit;
+    std::mutex wait_mutex;
+    std::condition_variable wait_cv;
+    
+    bool try_acquire() {
+        int current = active_tasks.load();
+        while (current < max_tasks.load()) {
+            if (active_tasks.compare_exchange_weak(current, current + 1)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+public:
+    explicit BlockingTaskThrottler(int max, int spin = 128)
+        : active_tasks(0), max_tasks(std::max(1, max)), waiters(0), park_count(0), spin_limit(spin) {}
+    
+    void before_task() {
+        for (int i = 0; i < spin_limit; ++i) {
+            if (try_acquire()) return;
+        }
+        
+        std::unique_lock<std::mutex> lock(wait_mutex);
+        waiters++;
+        park_count++;
+        wait_cv.wait(lock, [this]() { return try_acquire(); });
+        waiters--;
+    }
+    
+    void after_task() {
+        active_tasks--;
+        // Taking the lock orders the notify after a waiter's predicate check
+        if (waiters.load() > 0) {
+            std::lock_guard<std::mutex> lock(wait_mutex);
+            wait_cv.notify_one();
+        }
+    }
+    
+    // Change the limit at runtime; raising it wakes parked waiters
+    void set_max_tasks(int max) {
+        int previous = max_tasks.exchange(std::max(1, max));
+        if (max > previous && waiters.load() > 0) {
+            std::lock_guard<std::mutex> lock(wait_mutex);
+            wait_cv.notify_all();
+        }
+    }
+    
+    int get_active_tasks() const {
+        return active_tasks.load();
+    }
+    
+    int get_max_tasks() const {
+        return max_tasks.load();
+    }
+    
+    // Number of times before_task had to park instead of spinning
+    long long get_park_count() const {
+        return park_count.load();
+    }
+};
+
+// Blocking throttler whose limit is tuned by AIMD (additive increase,
+// multiplicative decrease) from observed completion throughput. Every
+// sample_interval seconds the thread that completes a task measures the
+// throughput of the window: if it held up, the limit grows by
+// additive_step; if it dropped by more than tolerance, the limit is scaled
+// by decrease_factor. No monitor thread is needed.
+class AdaptiveTaskThrottler {
+private:
+    BlockingTaskThrottler throttler;
+    int min_tasks;
+    int max_limit;
+    int additive_step;
+    double decrease_factor;
+    double tolerance;
+    double sample_interval;
+    
+    std::atomic<long long> completed{0};
+    std::mutex controller_mutex;
+    std::atomic<double> window_start;   // Read without the lock by the fast-path check
+    long long window_completed = 0;
+    double last_throughput = 0.0;
+    int increases = 0;
+    int decreases = 0;
+    
+    void maybe_adjust() {
+        double now = omp_get_wtime();
+        if (now - window_start.load(std::memory_order_relaxed) < sample_interval) return;
+        
+        std::unique_lock<std::mutex> lock(controller_mutex, std::try_to_lock);
+        const double start = window_start.load(std::memory_order_relaxed);
+        if (!lock.owns_lock() || now - start < sample_interval) return;
+        
+        long long done = completed.load();
+        double throughput = static_cast<double>(done - window_completed) / (now - start);
+        int limit = throttler.get_max_tasks();
+        
+        if (throughput >= last_throughput * (1.0 - tolerance)) {
+            limit = std::min(max_limit, limit + additive_step);
+            increases++;
+        } else {
+            limit = std::max(min_tasks, static_cast<int>(limit * decrease_factor));
+            decreases++;
+        }
+        throttler.set_max_tasks(limit);
+        
+        last_throughput = throughput;
+        window_start.store(now, std::memory_order_relaxed);
+        window_completed = done;
+    }
+    
+public:
+    AdaptiveTaskThrottler(int initial, int min_limit, int max_limit_, int step = 1,
+                          double decrease = 0.5, double tol = 0.05, double interval = 0.25)
+        : throttler(initial), min_tasks(std::max(1, min_limit)), max_limit(std::max(min_tasks, max_limit_)),
+          additive_step(std::max(1, step)), decrease_factor(decrease), tolerance(tol),
+          sample_interval(interval), window_start(omp_get_wtime()) {}
+    
+    void before_task() {
+        throttler.before_task();
+    }
+    
+    void after_task() {
+        completed++;
+        throttler.after_task();
+        maybe_adjust();
+    }
+    
+    int get_active_tasks() const {
+        return throttler.get_active_tasks();
+    }
+    
+    int get_max_tasks() const {
+        return throttler.get_max_tasks();
+    }
+    
+    long long get_park_count() const {
+        return throttler.get_park_count();
+    }
+    
+    int get_increase_count() const {
+        return increases;
+    }
+    
+    int get_decrease_count() const {
+        return decreases;
+    }
+};
+
+//==============================================================================
+// Priority dispatching
+//==============================================================================
+
+// Priority-queue dispatcher executed by an OpenMP team. Unlike the OpenMP
+// priority clause, which is only a hint (and ignored unless
+// OMP_MAX_TASK_PRIORITY is set), jobs are always started in order of
+// effective priority:
+//   effective = priority + min(max_aging_boost, aging_per_second x waited seconds)
+// The bounded aging term lets a starved low-priority job overtake newer
+// higher-priority ones, but never by more than max_aging_boost levels.
+// Jobs of equal priority are FIFO, so the oldest job of each level is that
+// level's best candidate and a dispatch only compares one job per level.
+// Jobs may submit further jobs (e.g. DAG successors); run() returns when
+// nothing is queued or running.
+class PriorityDispatcher {
+public:
+    struct CompletedJob {
+        int priority;
+        double wait_seconds;     // submit -> start
+        double latency_seconds;  // submit -> completion
+    };
+    
+private:
+    struct Job {
+        std::function<void()> work;
+        int priority;
+        double submit_time;
+    };
+    
+    std::map<int, std::deque<Job>> levels;  // priority -> FIFO
+    std::vector<CompletedJob> completed;
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    size_t queued = 0;
+    size_t running = 0;
+    long long aged_dispatches = 0;          // dispatches decided by aging
+    double aging_per_second;
+    int max_aging_boost;
+    double epoch;
+    
+    double now() const {
+        return omp_get_wtime() - epoch;
+    }
+    
+    double effective_priority(const Job& job, double time) const {
+        double boost = std::min(static_cast<double>(max_aging_boost), aging_per_second * (time - job.submit_time));
+        return job.priority + boost;
+    }
+    
+    // Caller holds queue_mutex and queued > 0
+    Job pop_best(double time) {
+        auto best = levels.end();
+        double best_priority = -std::numeric_limits<double>::infinity();
+        
+        for (auto it = levels.begin(); it != levels.end(); ++it) {
+            if (it->second.empty()) continue;
+            double priority = effective_priority(it->second.front(), time);
+            // Ties go to the higher base priority (levels are in ascending order)
+            if (priority >= best_priority) {
+                best_priority = priority;
+                best = it;
+            }
+        }
+        
+        // Aging decided this dispatch if a higher base level had work waiting
+        for (auto it = std::next(best); it != levels.end(); ++it) {
+            if (!it->second.empty()) {
+                aged_dispatches++;
+                break;
+            }
+        }
+        
+        Job job = std::move(best->second.front());
+        best->second.pop_front();
+        if (best->second.empty()) levels.erase(best);
+        queued--;
+        return job;
+    }
+    
+public:
+    explicit PriorityDispatcher(double aging_rate = 100.0, int max_boost = 50)
+        : aging_per_second(std::max(0.0, aging_rate)), max_aging_boost(std::max(0, max_boost)),
+          epoch(omp_get_wtime()) {}
+    
+    PriorityDispatcher(const PriorityDispatcher&) = delete;
+    PriorityDispatcher& operator=(const PriorityDispatcher&) = delete;
+    
+    // Queue a job; safe to call from inside a running job
+    void submit(int priority, std::function<void()> work) {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            levels[priority].push_back(Job{std::move(work), priority, now()});
+            queued++;
+        }
+        queue_cv.notify_one();
+    }
+    
+    // Execute queued jobs on num_threads OpenMP threads until none are queued or running
+    void run(int num_threads = omp_get_max_threads()) {
+        #pragma omp parallel num_threads(std::max(1, num_threads))
+        {
+            while (true) {
+                Job job{};
+                double start;
+                {
+                    std::unique_lock<std::mutex> lock(queue_mutex);
+                    queue_cv.wait(lock, [this]() { return queued > 0 || running == 0; });
+                    if (queued == 0) break;  // Nothing queued or running: done
+                    
+                    start = now();
+                    job = pop_best(start);
+                    running++;
+                }
+                
+                job.work();
+                double end = now();
+                
+                {
+                    std::lock_guard<std::mutex> lock(queue_mutex);
+                    completed.push_back({job.priority, start - job.submit_time, end - job.submit_time});
+                    running--;
+                }
+                queue_cv.notify_all();
+            }
+        }
+    }
+    
+    const std::vector<CompletedJob>& get_completed() const {
+        return completed;
+    }
+    
+    long long get_aged_dispatches() const {
+        return aged_dispatches;
+    }
+    
+    // Clear statistics and restart the clock; call between runs only
+    void reset_stats() {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        completed.clear();
+        aged_dispatches = 0;
+        epoch = omp_get_wtime();
+    }
+    
+    // p50/p95/p99/max latency per priority class, highest priority first
+    static void print_latency_report(const std::vector<CompletedJob>& jobs, const std::string& title) {
+        std::map<int, std::vector<double>> by_priority;
+        for (const auto& job : jobs) {
+            by_priority[job.priority].push_back(job.latency_seconds * 1000.0);
+        }
+        
+        auto percentile = [](const std::vector<double>& sorted, double p) {
+            size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+            return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+        };
+        
+        std::cout << "\n" << title << " - completion latency by priority (ms):" << std::endl;
+        std::cout << "--------------------------------------------------------" << std::endl;
+        std::cout << "Priority | Count |    p50 |    p95 |    p99 |    max" << std::endl;
+        std::cout << "--------------------------------------------------------" << std::endl;
+        
+        for (auto it = by_priority.rbegin(); it != by_priority.rend(); ++it) {
+            auto& latencies = it->second;
+            std::sort(latencies.begin(), latencies.end());
+            std::cout << std::setw(8) << it->first << " | "
+                      << std::setw(5) << latencies.size() << " | "
+                      << std::fixed << std::setprecision(1)
+                      << std::setw(6) << percentile(latencies, 0.50) << " | "
+                      << std::setw(6) << percentile(latencies, 0.95) << " | "
+                      << std::setw(6) << percentile(latencies, 0.99) << " | "
+                      << std::setw(6) << latencies.back() << std::endl;
+        }
+    }
+};
+
+//==============================================================================
+// Work-stealing scheduler
+//==============================================================================
+
+// Chase-Lev work-stealing deque (Le et al., "Correct and Efficient Work-Stealing
+// for Weak Memory Models"). The owning thread pushes and pops at the bottom,
+// thieves steal from the top. The circular buffer grows on demand; retired
+// buffers are kept until the deque is destroyed so a slow thief never reads
+// freed memory.
+template<typename T>
+class ChaseLevDeque {
+private:
+    struct Buffer {
+        int64_t capacity;
+        std::unique_ptr<std::atomic<T>[]> slots;
+        
+        explicit Buffer(int64_t cap) : capacity(cap), slots(new std::atomic<T>[cap]) {}
+        
+        T get(int64_t i) const { return slots[i & (capacity - 1)].load(std::memory_order_relaxed); }
+        void put(int64_t i, T value) { slots[i & (capacity - 1)].store(value, std::memory_order_relaxed); }
+    };
+    
+    alignas(64) std::atomic<int64_t> top;
+    alignas(64) std::atomic<int64_t> bottom;
+    std::atomic<Buffer*> buffer;
+    std::vector<std::unique_ptr<Buffer>> buffers;  // owner-only; includes retired ones
+    
+public:
+    explicit ChaseLevDeque(int64_t initial_capacity = 256) : top(0), bottom(0) {
+        buffers.emplace_back(new Buffer(initial_capacity));
+        buffer.store(buffers.back().get(), std::memory_order_relaxed);
+    }
+    
+    ChaseLevDeque(const ChaseLevDeque&) = delete;
+    ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+    
+    // Owner only
+    void push(T value) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        Buffer* buf = buffer.load(std::memory_order_relaxed);
+        
+        if (b - t > buf->capacity - 1) {
+            Buffer* grown = new Buffer(buf->capacity * 2);
+            for (int64_t i = t; i < b; i++) {
+                grown->put(i, buf->get(i));
+            }
+            buffers.emplace_back(grown);
+            buffer.store(grown, std::memory_order_release);
+            buf = grown;
+        }
+        
+        buf->put(b, value);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    
+    // Owner only; returns false if the deque is empty
+    bool pop(T& value) {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Buffer* buf = buffer.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        
+        value = buf->get(b);
+        if (t == b) {
+            // Last element: race against thieves for it
+            bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                   std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+    
+    // Any thread; returns false if empty or if another thread won the race
+    bool steal(T& value) {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        
+        if (t >= b) return false;
+        
+        Buffer* buf = buffer.load(std::memory_order_acquire);
+        value = buf->get(t);
+        return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+    
+    int64_t size_estimate() const {
+        return std::max<int64_t>(0, bottom.load(std::memory_order_relaxed) - top.load(std::memory_order_relaxed));
+    }
+};
+
+// Fork-join pool with one Chase-Lev deque per worker and randomized victim
+// selection. Independent of the OpenMP runtime, so its spawn cost is fully
+// under our control: join() keeps the forked job on the caller's stack and
+// never allocates.
+//
+//   task_utils::WorkStealingPool pool(8);
+//   long long r = pool.run([&]() { return fib(pool, 40); });
+//   // inside: pool.join([&] { x = fib(pool, n - 1); }, [&] { y = fib(pool, n - 2); });
+class WorkStealingPool {
+public:
+    struct Stats {
+        uint64_t executed = 0;  // jobs run by workers (including inlined joins)
+        uint64_t stolen = 0;    // jobs taken from another worker's deque
+        uint64_t spawned = 0;   // jobs pushed onto a deque
+    };
+    
+private:
+    // Type-erased unit of work; the execute function knows the concrete type
+    struct Job {
+        void (*execute_fn)(Job*);
+        void execute() { execute_fn(this); }
+    };
+    
+    // Job living on the stack frame of the join() that forked it
+    template<typename F>
+    struct StackJob : Job {
+        F* func;
+        std::atomic<bool> done;
+        
+        explicit StackJob(F& f) : func(&f), done(false) {
+            this->execute_fn = [](Job* job) {
+                StackJob* self = static_cast<StackJob*>(job);
+                (*self->func)();
+                self->done.store(true, std::memory_order_release);
+            };
+        }
+    };
+    
+    struct alignas(64) Worker {
+        WorkStealingPool* pool = nullptr;
+        int index = 0;
+        ChaseLevDeque<Job*> deque;
+        uint64_t rng_state = 0;
+        Stats stats;
+    };
+    
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    
+    // Root jobs submitted from outside the pool
+    std::mutex inject_mutex;
+    std::condition_variable wake_cv;
+    std::vector<Job*> injected;
+    std::atomic<int> active_runs{0};
+    std::atomic<int> sleeping{0};
+    std::atomic<bool> stopping{false};
+    
+    static Worker*& current_worker() {
+        static thread_local Worker* worker = nullptr;
+        return worker;
+    }
+    
+    Worker* local_worker() const {
+        Worker* w = current_worker();
+        return (w && w->pool == this) ? w : nullptr;
+    }
+    
+    // xorshift64 for victim selection
+    static uint64_t next_random(uint64_t& state) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+    
+    void push_local(Worker* w, Job* job) {
+        w->deque.push(job);
+        w->stats.spawned++;
+        if (sleeping.load(std::memory_order_relaxed) > 0) {
+            wake_cv.notify_one();
+        }
+    }
+    
+    // Steal from up to one full round of randomly chosen victims
+    Job* try_steal(Worker* w) {
+        const int n = static_cast<int>(workers.size());
+        if (n <= 1) return nullptr;
+        
+        int start = static_cast<int>(next_random(w->rng_state) % static_cast<uint64_t>(n));
+        for (int k = 0; k < n; k++) {
+            int victim = (start + k) % n;
+            if (victim == w->index) continue;
+            Job* job = nullptr;
+            if (workers[victim]->deque.steal(job)) {
+                w->stats.stolen++;
+                return job;
+            }
+        }
+        return nullptr;
+    }
+    
+    Job* try_injected() {
+        std::lock_guard<std::mutex> lock(inject_mutex);
+        if (injected.empty()) return nullptr;
+        Job* job = injected.back();
+        injected.pop_back();
+        return job;
+    }
+    
+    // Find and run one job; returns false if nothing was runnable
+    bool run_one(Worker* w) {
+        Job* job = nullptr;
+        if (!w->deque.pop(job)) {
+            job = try_steal(w);
+        }
+        if (!job) {
+            job = try_injected();
+        }
+        if (!job) return false;
+        
+        job->execute();
+        w->stats.executed++;
+        return true;
+    }
+    
+    void worker_loop(int index) {
+        Worker* w = workers[index].get();
+        current_worker() = w;
+        int idle_rounds = 0;
+        
+        while (!stopping.load(std::memory_order_acquire)) {
+            if (run_one(w)) {
+                idle_rounds = 0;
+                continue;
+            }
+            
+            // Spin briefly while a run is in flight, then park
+            if (active_runs.load(std::memory_order_acquire) > 0 && ++idle_rounds < 256) {
+                std::this_thread::yield();
+                continue;
+            }
+            
+            std::unique_lock<std::mutex> lock(inject_mutex);
+            sleeping.fetch_add(1, std::memory_order_relaxed);
+            wake_cv.wait_for(lock, std::chrono::milliseconds(1), [this]() {
+                return stopping.load(std::memory_order_relaxed) || !injected.empty();
+            });
+            sleeping.fetch_sub(1, std::memory_order_relaxed);
+            idle_rounds = 0;
+        }
+        
+        current_worker() = nullptr;
+    }
+    
+public:
+    explicit WorkStealingPool(int num_workers = omp_get_max_threads()) {
+        num_workers = std::max(1, num_workers);
+        for (int i = 0; i < num_workers; i++) {
+            workers.emplace_back(new Worker());
+            workers.back()->pool = this;
+            workers.back()->index = i;
+            workers.back()->rng_state = 0x9E3779B97F4A7C15ULL * static_cast<uint64_t>(i + 1);
+        }
+        for (int i = 0; i < num_workers; i++) {
+            threads.emplace_back(&WorkStealingPool::worker_loop, this, i);
+        }
+    }
+    
+    ~WorkStealingPool() {
+        stopping.store(true, std::memory_order_release);
+        wake_cv.notify_all();
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+    
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+    
+    int num_workers() const {
+        return static_cast<int>(workers.size());
+    }
+    
+    // Execute f on a pool worker and block until it (and everything it forked) is done
+    template<typename F>
+    auto run(F&& f) -> decltype(f()) {
+        using Result = decltype(f());
+        
+        if (local_worker()) {
+            return f();
+        }
+        
+        if constexpr (std::is_void<Result>::value) {
+            run([&]() { f(); return 0; });
+        } else {
+            Result result{};
+            auto root = [&]() { result = f(); };
+            StackJob<decltype(root)> job(root);
+            
+            active_runs.fetch_add(1, std::memory_order_acq_rel);
+            {
+                std::lock_guard<std::mutex> lock(inject_mutex);
+                injected.push_back(&job);
+            }
+            wake_cv.notify_all();
+            
+            // job.done is the worker's last access to job, so once it is set the
+            // stack frame may go away. The caller is not a worker and cannot
+            // help, so it spins briefly and then backs off to short sleeps.
+            for (int spins = 0; !job.done.load(std::memory_order_acquire); spins++) {
+                if (spins < 1000) {
+                    std::this_thread::yield();
+                } else {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+            }
+            active_runs.fetch_sub(1, std::memory_order_acq_rel);
+            return result;
+        }
+    }
+    
+    // Run left and right, potentially in parallel. The left job is published for
+    // thieves while the caller runs right; if nobody stole it, it is popped back
+    // and run inline. Called outside the pool, both run sequentially.
+    template<typename F1, typename F2>
+    void join(F1&& left, F2&& right) {
+        Worker* w = local_worker();
+        if (!w) {
+            left();
+            right();
+            return;
+        }
+        
+        StackJob<typename std::remove_reference<F1>::type> job(left);
+        push_local(w, &job);
+        
+        right();
+        
+        // Nested joins have completed, so our job is on top of the deque unless stolen
+        Job* top_job = nullptr;
+        if (w->deque.pop(top_job)) {
+            if (top_job == &job) {
+                left();
+                w->stats.executed++;
+                return;
+            }
+            // Should not happen with strictly nested joins; run it anyway
+            top_job->execute();
+            w->stats.executed++;
+        }
+        
+        // Stolen: keep this worker busy with other jobs until the thief finishes
+        while (!job.done.load(std::memory_order_acquire)) {
+            if (!run_one(w)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    
+    // N-ary spawn/sync on top of the pool. Spawned closures are heap-allocated;
+    // prefer join() for binary recursion.
+    class TaskGroup {
+    private:
+        template<typename F>
+        struct HeapJob : Job {
+            F func;
+            std::atomic<int>* pending;
+            
+            HeapJob(F&& f, std::atomic<int>* counter) : func(std::move(f)), pending(counter) {
+                this->execute_fn = [](Job* job) {
+                    HeapJob* self = static_cast<HeapJob*>(job);
+                    self->func();
+                    std::atomic<int>* counter = self->pending;
+                    delete self;
+                    counter->fetch_sub(1, std::memory_order_acq_rel);
+                };
+            }
+        };
+        
+        WorkStealingPool& pool;
+        std::atomic<int> pending{0};
+        
+    public:
+        explicit TaskGroup(WorkStealingPool& p) : pool(p) {}
+        ~TaskGroup() { wait(); }
+        
+        template<typename F>
+        void spawn(F f) {
+            Worker* w = pool.local_worker();
+            if (!w) {
+                f();
+                return;
+            }
+            pending.fetch_add(1, std::memory_order_relaxed);
+            pool.push_local(w, new HeapJob<F>(std::move(f), &pending));
+        }
+        
+        // Help execute jobs until every job spawned by this group has finished
+        void wait() {
+            Worker* w = pool.local_worker();
+            while (pending.load(std::memory_order_acquire) > 0) {
+                if (!w || !pool.run_one(w)) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    };
+    
+    // Aggregate counters over all workers (read when the pool is quiescent)
+    Stats get_stats() const {
+        Stats total;
+        for (const auto& w : workers) {
+            total.executed += w->stats.executed;
+            total.stolen += w->stats.stolen;
+            total.spawned += w->stats.spawned;
+        }
+        return total;
+    }
+    
+    void reset_stats() {
+        for (auto& w : workers) {
+            w->stats = Stats();
+        }
+    }
+    
+    void print_stats() const {
+        Stats total = get_stats();
+        std::cout << "Work-stealing pool (" << workers.size() << " workers): "
+                  << total.spawned << " spawned, " << total.executed << " executed, "
+                  << total.stolen << " stolen";
+        if (total.spawned > 0) {
+            std::cout << " (" << std::fixed << std::setprecision(1)
+                      << (100.0 * static_cast<double>(total.stolen) / static_cast<double>(total.spawned)) << "%)";
+        }
+        std::cout << std::endl;
+    }
+};
+
 } // namespace task_utils
 
 #endif // TASK_UTILS_H
\ No newline at end of file
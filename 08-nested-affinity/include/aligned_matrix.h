@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+#include <algorithm>
+#include <omp.h>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+/**
+ * @struct MatrixView
+ * @brief Non-owning view of a row-major block: element (i, j) is data[i * stride + j]
+ */
+template<typename T>
+struct MatrixView {
+    T* data;
+    int rows;
+    int cols;
+    size_t stride;
+
+    T& operator()(int i, int j) const { return data[static_cast<size_t>(i) * stride + j]; }
+    T* row(int i) const { return data + static_cast<size_t>(i) * stride; }
+
+    /**
+     * @brief View of a sub-block of this view
+     * @param row0 First row of the block
+     * @param col0 First column of the block
+     * @param numRows Number of rows
+     * @param numCols Number of columns
+     * @return View sharing this view's storage
+     */
+    MatrixView block(int row0, int col0, int numRows, int numCols) const {
+        return MatrixView{row(row0) + col0, numRows, numCols, stride};
+    }
+};
+
+/**
+ * @class Matrix
+ * @brief Contiguous row-major matrix of doubles with 64-byte aligned rows
+ *
+ * The row stride is padded to a multiple of 8 doubles, so every row starts on a
+ * cache line and SIMD loads of a row never straddle two lines at the start.
+ * Construction zero-fills in parallel with a static row schedule, which also
+ * first-touches each row's pages from the thread that later works on it.
+ * Inside a parallel region (e.g. in a task) the fill runs on the calling
+ * thread instead of opening a nested team.
+ */
+class Matrix {
+public:
+    static constexpr size_t ALIGNMENT = 64;
+    static constexpr size_t STRIDE_MULTIPLE = ALIGNMENT / sizeof(double);
+
+    Matrix() = default;
+
+    /**
+     * @brief Create a zero-initialized matrix
+     * @param rows Number of rows
+     * @param cols Number of columns
+     */
+    Matrix(int rows, int cols)
+        : m_rows(rows), m_cols(cols),
+          m_stride(((static_cast<size_t>(std::max(cols, 0)) + STRIDE_MULTIPLE - 1) / STRIDE_MULTIPLE) * STRIDE_MULTIPLE) {
+        m_data = allocate(static_cast<size_t>(std::max(rows, 0)) * m_stride);
+
+        double* data = m_data;
+        const size_t stride = m_stride;
+        #pragma omp parallel for schedule(static) if(!omp_in_parallel())
+        for (int i = 0; i < rows; i++) {
+            std::memset(data + static_cast<size_t>(i) * stride, 0, stride * sizeof(double));
+        }
+    }
+
+    Matrix(const Matrix& other) : m_rows(other.m_rows), m_cols(other.m_cols), m_stride(other.m_stride) {
+        m_data = allocate(static_cast<size_t>(m_rows) * m_stride);
+        if (m_data != nullptr) {
+            std::memcpy(m_data, other.m_data, static_cast<size_t>(m_rows) * m_stride * sizeof(double));
+        }
+    }
+
+    Matrix(Matrix&& other) noexcept {
+        swap(other);
+    }
+
+    Matrix& operator=(Matrix other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~Matrix() {
+        release(m_data);
+    }
+
+    int rows() const { return m_rows; }
+    int cols() const { return m_cols; }
+    size_t stride() const { return m_stride; }
+    bool empty() const { return m_rows == 0 || m_cols == 0; }
+
+    double* data() { return m_data; }
+    const double* data() const { return m_data; }
+
+    double& operator()(int i, int j) { return m_data[static_cast<size_t>(i) * m_stride + j]; }
+    double operator()(int i, int j) const { return m_data[static_cast<size_t>(i) * m_stride + j]; }
+
+    double* row(int i) { return m_data + static_cast<size_t>(i) * m_stride; }
+    const double* row(int i) const { return m_data + static_cast<size_t>(i) * m_stride; }
+
+    /**
+     * @brief View of the whole matrix or of a sub-block
+     * @param row0 First row of the block
+     * @param col0 First column of the block
+     * @param numRows Number of rows (-1 for the rest)
+     * @param numCols Number of columns (-1 for the rest)
+     */
+    MatrixView<double> view(int row0 = 0, int col0 = 0, int numRows = -1, int numCols = -1) {
+        return MatrixView<double>{row(row0) + col0,
+                                  numRows < 0 ? m_rows - row0 : numRows,
+                                  numCols < 0 ? m_cols - col0 : numCols, m_stride};
+    }
+
+    MatrixView<const double> view(int row0 = 0, int col0 = 0, int numRows = -1, int numCols = -1) const {
+        return MatrixView<const double>{row(row0) + col0,
+                                        numRows < 0 ? m_rows - row0 : numRows,
+                                        numCols < 0 ? m_cols - col0 : numCols, m_stride};
+    }
+
+private:
+    int m_rows = 0;
+    int m_cols = 0;
+    size_t m_stride = 0;
+    double* m_data = nullptr;
+
+    void swap(Matrix& other) noexcept {
+        std::swap(m_rows, other.m_rows);
+        std::swap(m_cols, other.m_cols);
+        std::swap(m_stride, other.m_stride);
+        std::swap(m_data, other.m_data);
+    }
+
+    static double* allocate(size_t count) {
+        if (count == 0) {
+            return nullptr;
+        }
+        size_t bytes = ((count * sizeof(double) + ALIGNMENT - 1) / ALIGNMENT) * ALIGNMENT;
+#ifdef _WIN32
+        void* ptr = _aligned_malloc(bytes, ALIGNMENT);
+#else
+        void* ptr = std::aligned_alloc(ALIGNMENT, bytes);
+#endif
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<double*>(ptr);
+    }
+
+    static void release(double* ptr) {
+        if (ptr == nullptr) {
+            return;
+        }
+#ifdef _WIN32
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+
+class SystemTopology;
+
+/**
+ * @class HierarchicalReduction
+ * @brief Two-level (NUMA node, then global) sum for the threads of one team
+ *
+ * Each thread writes its partial into its own cache line. One representative per
+ * NUMA node sums the lines of the threads on its node, so those lines never leave
+ * the node, and thread 0 then combines one line per node. A flat critical or
+ * atomic reduction instead has every thread pull the same line across sockets.
+ *
+ * The thread-to-node map is taken once in the constructor by running a team of
+ * the same size; OpenMP reuses its pool threads, so keep the team size unchanged
+ * and bind threads (OMP_PROC_BIND) for the map to stay accurate. An unbound
+ * thread that migrates still produces the right sum, only with remote traffic.
+ *
+ * Usage:
+ *   HierarchicalReduction reducer(topology, numThreads);
+ *   #pragma omp parallel num_threads(numThreads)
+ *   {
+ *       double total = reducer.reduce(localPartial);
+ *   }
+ */
+class HierarchicalReduction {
+public:
+    /**
+     * @brief Map the threads of a team of the given size to NUMA nodes
+     * @param topology Topology after detectTopology() has been called
+     * @param numThreads Team size the reduction will be used with
+     */
+    HierarchicalReduction(const SystemTopology& topology, int numThreads);
+
+    /**
+     * @brief Sum one value per thread; must be called by every thread of the team
+     * @param partial Calling thread's contribution
+     * @return Sum over the team, returned to every thread
+     */
+    double reduce(double partial);
+
+    /**
+     * @brief Get the team size the reduction was built for
+     * @return Number of threads
+     */
+    int getThreadCount() const;
+
+    /**
+     * @brief Get the number of NUMA nodes the team's threads were found on
+     * @return Node group count
+     */
+    int getGroupCount() const;
+
+    /**
+     * @brief Print which threads reduce together on each node
+     */
+    void displayGroups() const;
+
+private:
+    struct alignas(64) PaddedValue {
+        double value;
+    };
+
+    struct NodeGroup {
+        int node;
+        int representative;       ///< Lowest thread number on the node
+        std::vector<int> members; ///< Thread numbers on the node
+    };
+
+    int m_numThreads;
+    std::vector<PaddedValue> m_partials;   ///< One line per thread
+    std::vector<PaddedValue> m_nodeSums;   ///< One line per node group
+    std::vector<NodeGroup> m_groups;
+    std::vector<int> m_groupOfThread;      ///< Index into m_groups, -1 if not a representative
+    PaddedValue m_result;
+};
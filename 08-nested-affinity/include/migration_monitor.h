@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class SystemTopology;
+
+/**
+ * @struct ThreadMigrationStats
+ * @brief What the sampler observed for one registered thread
+ */
+struct ThreadMigrationStats {
+    int ompThreadNum;          ///< omp_get_thread_num() at registration
+    int homeProcessor;         ///< Processor at registration
+    bool pinned;               ///< Affinity mask narrower than the process mask
+    std::vector<int> place;    ///< Processors the thread is allowed on (its assigned place)
+    long long samples;         ///< Samples with a known processor
+    long long migrations;      ///< Processor changes between consecutive samples
+    double offPlaceSeconds;    ///< Time observed outside place (pinned) or away from home (unpinned)
+    double smtSharedSeconds;   ///< Time another registered thread ran on an SMT sibling
+    std::vector<int> processorsSeen;
+};
+
+/**
+ * @class MigrationMonitor
+ * @brief Background sampler of the processor each registered thread is running on
+ *
+ * Threads call registerCurrentThread() once (typically at the start of a parallel
+ * region). A sampler thread then wakes every interval and records each thread's
+ * processor: on Linux it reads /proc/self/task/<tid>/stat, so workers do nothing
+ * further; elsewhere workers publish their processor with checkpoint(), a
+ * GetThreadCoreID() call plus one relaxed store, from their inner loops.
+ *
+ * Usage:
+ *   MigrationMonitor monitor(topology);
+ *   #pragma omp parallel
+ *   { monitor.registerCurrentThread(); }
+ *   monitor.start();
+ *   ... benchmark ...
+ *   monitor.stop();
+ *   monitor.displayReport();
+ *
+ * OpenMP keeps its pool threads between regions, so threads registered in one
+ * region are the ones that run later regions of the same size.
+ */
+class MigrationMonitor {
+public:
+    static constexpr int MAX_THREADS = 512;
+
+    /**
+     * @brief Construct a monitor
+     * @param topology Detected topology, used to find SMT siblings
+     * @param intervalMicros Sampling interval in microseconds
+     */
+    explicit MigrationMonitor(const SystemTopology& topology, int intervalMicros = 1000);
+
+    ~MigrationMonitor();
+
+    MigrationMonitor(const MigrationMonitor&) = delete;
+    MigrationMonitor& operator=(const MigrationMonitor&) = delete;
+
+    /**
+     * @brief Register the calling thread; its current affinity mask becomes its place
+     * @return Slot index of the thread, or -1 if the monitor is full
+     */
+    int registerCurrentThread();
+
+    /**
+     * @brief Publish the calling thread's current processor (needed only off Linux)
+     */
+    void checkpoint();
+
+    /**
+     * @brief Start the background sampler
+     */
+    void start();
+
+    /**
+     * @brief Stop the sampler and wait for it to exit
+     */
+    void stop();
+
+    /**
+     * @brief Check whether samples come from the OS rather than from checkpoint()
+     * @return true on Linux
+     */
+    static bool samplesFromOs();
+
+    /**
+     * @brief Get per-thread statistics (valid after stop())
+     * @return One entry per registered thread
+     */
+    std::vector<ThreadMigrationStats> getStats() const;
+
+    /**
+     * @brief Get the time sampled between start() and stop()
+     * @return Seconds
+     */
+    double getSampledSeconds() const;
+
+    /**
+     * @brief Get the number of samples at which two registered threads shared a physical core
+     * @return Sample count
+     */
+    long long getSmtCoScheduledSamples() const;
+
+    /**
+     * @brief Print per-thread migrations, off-place time and SMT co-scheduling
+     * @param label Heading for the report
+     */
+    void displayReport(const std::string& label = "Thread Migration Report") const;
+
+private:
+    struct ThreadSlot {
+        std::atomic<int> publishedProcessor{-1};
+        long long osThreadId = 0;
+        ThreadMigrationStats stats;
+        int lastProcessor = -1;
+    };
+
+    const SystemTopology& m_topology;
+    unsigned long long m_instanceId;   ///< Distinguishes monitors reusing an address
+    std::chrono::microseconds m_interval;
+    std::vector<ThreadSlot> m_slots;
+    std::atomic<int> m_registered{0};
+    std::mutex m_registerMutex;
+    std::atomic<bool> m_running{false};
+    std::thread m_sampler;
+    double m_sampledSeconds = 0.0;
+    long long m_samplesTaken = 0;
+    long long m_smtSamples = 0;
+    std::vector<int> m_processMask;
+
+    void samplerLoop();
+    int readProcessor(ThreadSlot& slot, bool& running) const;
+};
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+class SystemTopology;
+
+/**
+ * @enum PlacementPolicy
+ * @brief Strategy for laying out a two-level (outer x inner) thread hierarchy
+ */
+enum class PlacementPolicy {
+    SocketSpread, ///< One outer thread per package; inner teams on that package's physical cores
+    CoreSpread,   ///< Physical cores split into one contiguous partition per outer thread
+    Compact       ///< Teams packed onto consecutive logical processors, SMT siblings first
+};
+
+/**
+ * @brief Get a printable name for a placement policy
+ * @param policy Policy to name
+ * @return "socket", "spread" or "compact"
+ */
+const char* PlacementPolicyName(PlacementPolicy policy);
+
+/**
+ * @brief Parse a placement policy name as printed by PlacementPolicyName
+ * @param name Policy name
+ * @param policy Receives the parsed policy
+ * @return true if the name was recognized
+ */
+bool ParsePlacementPolicy(const std::string& name, PlacementPolicy& policy);
+
+/**
+ * @struct PlacementPlan
+ * @brief Processor assignment for every (outer, inner) thread plus the equivalent OpenMP settings
+ */
+struct PlacementPlan {
+    PlacementPolicy policy;
+    int outerThreads;
+    int innerThreads;
+    std::vector<std::vector<int>> processors; ///< processors[outer][inner] = logical processor
+    std::string ompPlaces;                    ///< OMP_PLACES value, one place per thread in plan order
+    std::string ompProcBind;                  ///< OMP_PROC_BIND value for both levels
+    std::string ompNumThreads;                ///< OMP_NUM_THREADS value for both levels
+    std::vector<std::string> warnings;        ///< Oversubscription or SMT sharing notes
+};
+
+/**
+ * @struct PlacementValidation
+ * @brief Result of running a plan and checking where each thread actually executed
+ */
+struct PlacementValidation {
+    int threadsChecked;
+    int threadsPinned;      ///< Threads whose affinity call succeeded
+    int threadsOnTarget;    ///< Threads observed on their planned processor
+    std::vector<std::vector<int>> observed; ///< observed[outer][inner] = processor from GetThreadCoreID
+};
+
+/**
+ * @class PlacementPlanner
+ * @brief Derives nested-team placements from the detected system topology
+ *
+ * A plan can be used two ways: exported as OMP_PLACES / OMP_PROC_BIND /
+ * OMP_NUM_THREADS for the next launch (the runtime reads them at startup), or
+ * applied in the running process by calling pinCurrentThread() at the start of
+ * each inner parallel region.
+ */
+class PlacementPlanner {
+public:
+    /**
+     * @brief Construct a planner for the detected topology
+     * @param topology Topology after detectTopology() has been called
+     */
+    explicit PlacementPlanner(const SystemTopology& topology);
+
+    /**
+     * @brief Plan the placement of outer x inner threads
+     * @param outerThreads Number of outer threads
+     * @param innerThreads Number of threads in each inner team
+     * @param policy Placement strategy
+     * @return Plan with one processor per thread and the matching environment settings
+     */
+    PlacementPlan plan(int outerThreads, int innerThreads, PlacementPolicy policy) const;
+
+    /**
+     * @brief Pin the calling thread to its planned processor
+     * @param plan Plan returned by plan()
+     * @param outerId Thread number in the outer team
+     * @param innerId Thread number in the inner team
+     * @return true if the affinity call succeeded
+     */
+    static bool pinCurrentThread(const PlacementPlan& plan, int outerId, int innerId);
+
+    /**
+     * @brief Run a nested region with the plan pinned and record where each thread runs
+     * @param plan Plan returned by plan()
+     * @return Pinning and placement statistics
+     */
+    static PlacementValidation validate(const PlacementPlan& plan);
+
+    /**
+     * @brief Print the processor assignment table of a plan
+     * @param plan Plan to display
+     */
+    void displayPlan(const PlacementPlan& plan) const;
+
+    /**
+     * @brief Print the environment settings that reproduce a plan
+     * @param plan Plan to display
+     */
+    static void displayEnvironment(const PlacementPlan& plan);
+
+private:
+    const SystemTopology& m_topology;
+
+    /**
+     * @brief Physical cores of a package, each as its list of SMT siblings
+     */
+    std::vector<std::vector<int>> coresOfPackage(int packageId) const;
+
+    /**
+     * @brief Logical processors ordered core by core: all SMT siblings of a core are adjacent
+     */
+    std::vector<int> compactOrder() const;
+};
@@ -5,6 +5,18 @@
 #include <map>
 #include <set>
 
+/**
+ * @struct CacheInfo
+ * @brief One cache instance and the logical processors that share it
+ */
+struct CacheInfo {
+    int level;                       ///< 1, 2, 3, ...
+    std::string type;                ///< "Data", "Instruction" or "Unified"
+    long long sizeBytes;             ///< Capacity of this instance in bytes
+    int lineSize;                    ///< Coherency line size in bytes (0 if unknown)
+    std::vector<int> sharedProcessors; ///< Logical processors sharing this instance
+};
+
 /**
  * @class SystemTopology
  * @brief Detects and stores system hardware topology information
@@ -15,6 +27,11 @@
  * - Number of logical processors (hardware threads)
  * - NUMA node information
  * - Core to NUMA node mapping
+ * - Cache hierarchy (which logical processors share each L1/L2/L3 instance)
+ * - SMT siblings (logical processors on the same physical core)
+ *
+ * Windows uses GetLogicalProcessorInformation; Linux reads
+ * /sys/devices/system/cpu and /sys/devices/system/node.
  */
 class SystemTopology {
 public:
@@ -22,7 +39,7 @@ public:
     ~SystemTopology();
 
     /**
-     * @brief Detect system topology using Windows API
+     * @brief Detect system topology (Windows API or Linux sysfs)
      * @return true if detection was successful
      */
     bool detectTopology();
@@ -89,6 +106,58 @@ public:
      */
     std::vector<int> getProcessorsForNumaNode(int numaNode) const;
 
+    /**
+     * @brief Get the list of logical processors in a physical package
+     * @param packageId Physical package ID
+     * @return Vector of logical processor IDs
+     */
+    std::vector<int> getProcessorsForPackage(int packageId) const;
+
+    /**
+     * @brief Get the total number of physical cores
+     * @return Number of distinct physical cores
+     */
+    int getPhysicalCoreCount() const;
+
+    /**
+     * @brief Get the SMT siblings of a logical processor (including itself)
+     * @param logicalProcessor Logical processor ID
+     * @return Logical processors on the same physical core, ascending
+     */
+    std::vector<int> getSmtSiblings(int logicalProcessor) const;
+
+    /**
+     * @brief Get the logical processors sharing a data/unified cache level
+     * @param logicalProcessor Logical processor ID
+     * @param level Cache level (1, 2 or 3)
+     * @return Logical processors sharing that cache instance (empty if unknown)
+     */
+    std::vector<int> getProcessorsSharingCache(int logicalProcessor, int level) const;
+
+    /**
+     * @brief Get the size of one data/unified cache instance at a level
+     * @param level Cache level (1, 2 or 3)
+     * @return Size in bytes, or 0 if unknown
+     */
+    long long getCacheSize(int level) const;
+
+    /**
+     * @brief Get the cache line size
+     * @return Line size in bytes (64 if unknown)
+     */
+    int getCacheLineSize() const;
+
+    /**
+     * @brief Get all detected cache instances
+     * @return Cache instances, ordered by level
+     */
+    const std::vector<CacheInfo>& getCaches() const;
+
+    /**
+     * @brief Display the cache hierarchy and sharing groups
+     */
+    void displayCacheInfo() const;
+
 private:
     // Topology data
     int m_logicalProcessorCount;
@@ -101,8 +170,13 @@ private:
     std::vector<int> m_logicalToPhysicalCore; // Maps logical CPU ID -> physical core ID
     std::vector<int> m_logicalToNumaNode;     // Maps logical CPU ID -> NUMA node
     std::map<int, std::vector<int>> m_numaToLogical; // Maps NUMA node -> logical CPU IDs
+    std::vector<CacheInfo> m_caches;                 // All cache instances
 
     // Helper methods for Windows-specific detection
     bool detectWindowsTopology();
     void detectNumaTopology();
+
+    // Helper methods for Linux-specific detection
+    bool detectLinuxTopology();
+    void detectLinuxNumaTopology();
 };
\ No newline at end of file
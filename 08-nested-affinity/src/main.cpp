@@ -9,6 +9,9 @@
 #include "../include/system_topology.h"
 #include "../include/thread_utils.h"
 #include "../include/cli_parser.h"
+#include "../include/placement_planner.h"
+#include "../include/migration_monitor.h"
+#include "../include/hierarchical_reduction.h"
 
 // Demo selection menu
 void displayMenu() {
@@ -18,6 +21,8 @@ void displayMenu() {
     std::cout << "3. Thread Affinity Demo" << std::endl;
     std::cout << "4. Custom Thread Placement Demo" << std::endl;
     std::cout << "5. Matrix Multiplication Performance" << std::endl;
+    std::cout << "6. Automatic Placement Planner" << std::endl;
+    std::cout << "7. Hierarchical NUMA Reduction" << std::endl;
     std::cout << "0. Exit" << std::endl;
     std::cout << "\nEnter your choice: ";
 }
@@ -33,6 +38,9 @@ void systemTopologyDemo(const SystemTopology& topology) {
     // Display detailed processor mapping
     topology.displayProcessorMap();
     
+    // Display cache hierarchy (sizes and which processors share each level)
+    topology.displayCacheInfo();
+    
     // Display NUMA node info if available
     if (topology.getNumaNodeCount() > 1) {
         topology.displayNumaInfo();
@@ -161,10 +169,166 @@ void customThreadPlacementDemo(const SystemTopology& topology) {
 }
 
 // Matrix multiplication demo
-void matrixMultiplicationDemo() {
+void matrixMultiplicationDemo(const SystemTopology& topology, int matrixSize) {
     std::cout << "\n=== Matrix Multiplication Performance Demo ===" << std::endl;
-    std::cout << "Please run the 'matrix_multiplication' executable for this demo." << std::endl;
-    std::cout << "Example: build\\Release\\matrix_multiplication.exe --matrix_size=1000" << std::endl;
+    std::cout << "Please run the 'matrix_multiplication' executable for the full comparison." << std::endl;
+    std::cout << "Example: build\\Release\\matrix_multiplication.exe --matrix_size=1000 --monitor" << std::endl;
+    
+    // Short multiply under the migration monitor to show whether threads stay put
+    const int n = matrixSize;
+    std::vector<double> A(static_cast<size_t>(n) * n, 1.0);
+    std::vector<double> B(static_cast<size_t>(n) * n, 2.0);
+    std::vector<double> C(static_cast<size_t>(n) * n, 0.0);
+    
+    MigrationMonitor monitor(topology);
+    #pragma omp parallel
+    {
+        monitor.registerCurrentThread();
+    }
+    
+    std::cout << "\nMultiplying " << n << "x" << n << " matrices with the migration monitor running..." << std::endl;
+    monitor.start();
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; i++) {
+        monitor.checkpoint();
+        for (int k = 0; k < n; k++) {
+            double a = A[static_cast<size_t>(i) * n + k];
+            for (int j = 0; j < n; j++) {
+                C[static_cast<size_t>(i) * n + j] += a * B[static_cast<size_t>(k) * n + j];
+            }
+        }
+    }
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    monitor.stop();
+    
+    std::cout << "Completed in " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+              << " ms (C[0] = " << C[0] << ")" << std::endl;
+    monitor.displayReport("Thread Migration During Multiply");
+}
+
+// Placement planner demo: plan, print the OpenMP settings, then pin and verify
+void placementPlannerDemo(const SystemTopology& topology, int outerThreads, int innerThreads,
+                          const std::string& policyName) {
+    std::cout << "\n=== Automatic Placement Planner ===" << std::endl;
+    
+    PlacementPolicy policy;
+    if (!ParsePlacementPolicy(policyName, policy)) {
+        std::cerr << "Unknown placement policy: " << policyName
+                  << " (use socket, spread or compact)" << std::endl;
+        return;
+    }
+    
+    PlacementPlanner planner(topology);
+    PlacementPlan plan = planner.plan(outerThreads, innerThreads, policy);
+    planner.displayPlan(plan);
+    if (plan.processors.empty() || plan.processors[0].empty()) {
+        return;
+    }
+    PlacementPlanner::displayEnvironment(plan);
+    
+    std::cout << "\nPinning threads with SetThreadAffinity and checking with GetThreadCoreID..." << std::endl;
+    PlacementValidation validation = PlacementPlanner::validate(plan);
+    
+    for (int o = 0; o < plan.outerThreads; o++) {
+        for (int i = 0; i < plan.innerThreads; i++) {
+            int observed = validation.observed[o][i];
+            std::cout << "  Outer " << o << ", inner " << i << ": planned " << plan.processors[o][i]
+                      << ", observed " << observed
+                      << (observed == plan.processors[o][i] ? "" : "  <-- mismatch") << std::endl;
+        }
+    }
+    std::cout << "Threads checked: " << validation.threadsChecked
+              << ", pinned: " << validation.threadsPinned
+              << ", on planned processor: " << validation.threadsOnTarget << std::endl;
+}
+
+// Hierarchical reduction demo: per-node then global sum versus flat reductions
+void hierarchicalReductionDemo(const SystemTopology& topology, int numThreads, int iterations) {
+    std::cout << "\n=== Hierarchical NUMA Reduction ===" << std::endl;
+    std::cout << "Threads: " << numThreads << ", reductions per variant: " << iterations << std::endl;
+    
+    HierarchicalReduction reducer(topology, numThreads);
+    reducer.displayGroups();
+    if (reducer.getGroupCount() < 2) {
+        std::cout << "All threads are on one NUMA node; the hierarchical variant only adds a stage here." << std::endl;
+    }
+    
+    // Every thread contributes (tid + iteration) each round, so the expected total is known
+    const double expectedTotal = static_cast<double>(iterations) * numThreads * (numThreads - 1) / 2.0 +
+                                 static_cast<double>(numThreads) * iterations * (iterations - 1) / 2.0;
+    
+    auto timeVariant = [&](const std::string& name, int variant) {
+        double total = 0.0;
+        double flatSum = 0.0;
+        auto start = std::chrono::high_resolution_clock::now();
+        
+        #pragma omp parallel num_threads(numThreads) shared(reducer, total, flatSum, variant, iterations)
+        {
+            const int tid = omp_get_thread_num();
+            double checksum = 0.0;
+            
+            for (int iter = 0; iter < iterations; iter++) {
+                double partial = static_cast<double>(tid + iter);
+                
+                if (variant == 0) {
+                    // Flat: every thread updates the same line under one lock
+                    #pragma omp single
+                    flatSum = 0.0;
+                    #pragma omp critical
+                    flatSum += partial;
+                    #pragma omp barrier
+                    checksum += flatSum;
+                    #pragma omp barrier
+                } else if (variant == 1) {
+                    // Flat: every thread updates the same line atomically
+                    #pragma omp single
+                    flatSum = 0.0;
+                    #pragma omp atomic
+                    flatSum += partial;
+                    #pragma omp barrier
+                    checksum += flatSum;
+                    #pragma omp barrier
+                } else if (variant == 2) {
+                    // Runtime reduction clause over one iteration per thread
+                    #pragma omp single
+                    flatSum = 0.0;
+                    #pragma omp for reduction(+:flatSum) schedule(static, 1)
+                    for (int t = 0; t < numThreads; t++) {
+                        flatSum += static_cast<double>(t + iter);
+                    }
+                    checksum += flatSum;
+                    #pragma omp barrier
+                } else {
+                    checksum += reducer.reduce(partial);
+                }
+            }
+            
+            if (tid == 0) {
+                total = checksum;
+            }
+        }
+        
+        auto end = std::chrono::high_resolution_clock::now();
+        double micros = std::chrono::duration<double, std::micro>(end - start).count();
+        std::cout << std::setw(22) << name << std::setw(14) << std::fixed << std::setprecision(3)
+                  << micros / iterations << std::setw(10)
+                  << (total == expectedTotal ? "ok" : "FAIL") << std::endl;
+        return micros / iterations;
+    };
+    
+    std::cout << "\n" << std::setw(22) << "Variant" << std::setw(14) << "us/reduction" << std::setw(10) << "Check" << std::endl;
+    std::cout << std::string(46, '-') << std::endl;
+    double criticalTime = timeVariant("Flat critical", 0);
+    double atomicTime = timeVariant("Flat atomic", 1);
+    double clauseTime = timeVariant("reduction clause", 2);
+    double hierarchicalTime = timeVariant("Hierarchical (NUMA)", 3);
+    
+    double bestFlat = std::min(criticalTime, std::min(atomicTime, clauseTime));
+    std::cout << "\nHierarchical vs best flat: " << std::setprecision(2) << bestFlat / hierarchicalTime
+              << "x" << std::endl;
 }
 
 // Entry point
@@ -235,7 +399,18 @@ int main(int argc, char* argv[]) {
                 break;
                 
             case 5:
-                matrixMultiplicationDemo();
+                matrixMultiplicationDemo(topology, parser.getIntOption("matrix_size", 512));
+                break;
+                
+            case 6:
+                placementPlannerDemo(topology, outer_threads, inner_threads,
+                                     parser.getStringOption("policy", "socket"));
+                break;
+                
+            case 7:
+                hierarchicalReductionDemo(topology,
+                                          parser.getIntOption("threads", topology.getLogicalProcessorCount()),
+                                          parser.getIntOption("iterations", 20000));
                 break;
                 
             default:
@@ -0,0 +1,329 @@
+#include <iostream>
+#include <vector>
+#include <iomanip>
+#include <omp.h>
+#include <string>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <cmath>
+#include "../include/system_topology.h"
+#include "../include/thread_utils.h"
+#include "../include/cli_parser.h"
+#include "bench_core.h"
+
+/**
+ * @brief Split a comma-separated option value
+ */
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+/**
+ * @brief Read an environment variable
+ * @return Its value, or "(unset)"
+ */
+std::string environmentValue(const char* name) {
+    const char* value = std::getenv(name);
+    return value != nullptr ? std::string(value) : std::string("(unset)");
+}
+
+/**
+ * @brief The runtime settings under test, as a result variant, e.g. "levels=2 wait=active hot=1"
+ */
+std::string environmentVariant() {
+    std::ostringstream variant;
+    const std::pair<const char*, const char*> settings[] = {
+        {"levels", "OMP_MAX_ACTIVE_LEVELS"}, {"wait", "OMP_WAIT_POLICY"}, {"hot", "KMP_HOT_TEAMS_MODE"}};
+    for (const auto& setting : settings) {
+        const char* value = std::getenv(setting.second);
+        if (value != nullptr) {
+            variant << (variant.tellp() > 0 ? " " : "") << setting.first << "=" << value;
+        }
+    }
+    return variant.tellp() > 0 ? variant.str() : "default";
+}
+
+/**
+ * @brief Enable nesting unless OMP_MAX_ACTIVE_LEVELS already decides it
+ *
+ * omp_set_nested(1) raises the active-level limit on newer runtimes, which would
+ * hide an OMP_MAX_ACTIVE_LEVELS=1 setting under test, so it is only called when
+ * the variable is unset.
+ */
+void configureNesting(int depth) {
+    if (std::getenv("OMP_MAX_ACTIVE_LEVELS") != nullptr) {
+        return;
+    }
+    SetNestedParallelism(true);
+#if _OPENMP >= 200805
+    omp_set_max_active_levels(depth);
+#endif
+}
+
+/**
+ * @brief Open one parallel region per remaining level; the innermost body is empty
+ */
+void enterNested(int depth, int width) {
+    if (depth == 0) {
+        return;
+    }
+    #pragma omp parallel num_threads(width)
+    {
+        enterNested(depth - 1, width);
+    }
+}
+
+/**
+ * @brief Cost of entering and leaving a nest of the given depth from serial code
+ * @return Microseconds per outermost region
+ */
+double measureNestingDepth(int depth, int width, int repetitions) {
+    enterNested(depth, width);  // Warm-up creates the pool threads
+
+    const bench::Clock::Ticks start = bench::Clock::now();
+    for (int r = 0; r < repetitions; r++) {
+        enterNested(depth, width);
+    }
+    const bench::Clock::Ticks end = bench::Clock::now();
+    return bench::Clock::toNanoseconds(end - start) * 1e-3 / repetitions;
+}
+
+/**
+ * @brief Small, fixed amount of work per inner thread
+ */
+inline double innerWork(int begin, int end) {
+    double sum = 0.0;
+    for (int i = begin; i < end; i++) {
+        sum += i * 0.5;
+    }
+    return sum;
+}
+
+/**
+ * @brief Fork a fresh inner team for every outer iteration
+ * @return Microseconds per outer iteration
+ */
+double measureFreshInnerTeams(int outerThreads, int innerThreads, int iterations, int workItems, double& checksum) {
+    double total = 0.0;
+    const bench::Clock::Ticks start = bench::Clock::now();
+
+    #pragma omp parallel num_threads(outerThreads) reduction(+:total)
+    {
+        for (int iter = 0; iter < iterations; iter++) {
+            double innerSum = 0.0;
+            #pragma omp parallel num_threads(innerThreads) reduction(+:innerSum)
+            {
+                #pragma omp for schedule(static)
+                for (int i = 0; i < workItems; i++) {
+                    innerSum += innerWork(i, i + 1);
+                }
+            }
+            total += innerSum;
+        }
+    }
+
+    const bench::Clock::Ticks end = bench::Clock::now();
+    checksum = total;
+    return bench::Clock::toNanoseconds(end - start) * 1e-3 / iterations;
+}
+
+/**
+ * @brief Keep each inner team alive for all outer iterations
+ *
+ * The inner team is forked once per outer thread; each iteration is a worksharing
+ * loop whose implicit barrier replaces the join and re-fork.
+ * @return Microseconds per outer iteration
+ */
+double measurePersistentInnerTeams(int outerThreads, int innerThreads, int iterations, int workItems, double& checksum) {
+    double total = 0.0;
+    const bench::Clock::Ticks start = bench::Clock::now();
+
+    #pragma omp parallel num_threads(outerThreads) reduction(+:total)
+    {
+        double outerSum = 0.0;
+        #pragma omp parallel num_threads(innerThreads) reduction(+:outerSum)
+        {
+            for (int iter = 0; iter < iterations; iter++) {
+                #pragma omp for schedule(static)
+                for (int i = 0; i < workItems; i++) {
+                    outerSum += innerWork(i, i + 1);
+                }
+            }
+        }
+        total += outerSum;
+    }
+
+    const bench::Clock::Ticks end = bench::Clock::now();
+    checksum = total;
+    return bench::Clock::toNanoseconds(end - start) * 1e-3 / iterations;
+}
+
+/**
+ * @brief Run all measurements under the current environment
+ *
+ * Prints "TEAM_RESULT,<name>,<microseconds>" lines, which the sweep parent collects.
+ */
+void runMeasurements(int maxDepth, int width, int outerThreads, int innerThreads,
+                     int repetitions, int iterations, int workItems, bool quiet) {
+    configureNesting(std::max(maxDepth, 2));
+
+    if (!quiet) {
+        std::cout << "\nEnvironment in effect:" << std::endl;
+        for (const char* name : {"OMP_MAX_ACTIVE_LEVELS", "OMP_WAIT_POLICY", "KMP_HOT_TEAMS_MODE",
+                                 "KMP_HOT_TEAMS_MAX_LEVEL", "OMP_PROC_BIND", "OMP_PLACES"}) {
+            std::cout << "  " << std::setw(24) << std::left << name << std::right << environmentValue(name) << std::endl;
+        }
+#if _OPENMP >= 200805
+        std::cout << "  omp_get_max_active_levels() = " << omp_get_max_active_levels() << std::endl;
+#endif
+        std::cout << "\nNested region entry/exit, " << width << " threads per level:" << std::endl;
+        std::cout << std::setw(8) << "Depth" << std::setw(18) << "us/region" << std::endl;
+        std::cout << std::string(26, '-') << std::endl;
+    }
+
+    for (int depth = 1; depth <= maxDepth; depth++) {
+        double micros = measureNestingDepth(depth, width, std::max(1, repetitions / depth));
+        bench::record("nested_region", environmentVariant(), depth,
+                      static_cast<int>(std::pow(width, depth)), {micros * 1e-3});
+        if (quiet) {
+            std::cout << "TEAM_RESULT,depth" << depth << "," << std::fixed << std::setprecision(3) << micros << std::endl;
+        } else {
+            std::cout << std::setw(8) << depth << std::setw(18) << std::fixed << std::setprecision(3) << micros << std::endl;
+        }
+    }
+
+    double freshChecksum = 0.0;
+    double persistentChecksum = 0.0;
+    double fresh = measureFreshInnerTeams(outerThreads, innerThreads, iterations, workItems, freshChecksum);
+    double persistent = measurePersistentInnerTeams(outerThreads, innerThreads, iterations, workItems, persistentChecksum);
+    bench::record("inner_team", "fresh, " + environmentVariant(), workItems, outerThreads * innerThreads, {fresh * 1e-3});
+    bench::record("inner_team", "persistent, " + environmentVariant(), workItems, outerThreads * innerThreads,
+                  {persistent * 1e-3}, {{"speedup", fresh / persistent}});
+
+    if (quiet) {
+        std::cout << "TEAM_RESULT,fresh_inner," << std::fixed << std::setprecision(3) << fresh << std::endl;
+        std::cout << "TEAM_RESULT,persistent_inner," << persistent << std::endl;
+        return;
+    }
+
+    std::cout << "\nShort inner regions: " << outerThreads << " outer x " << innerThreads << " inner, "
+              << iterations << " iterations of " << workItems << " items" << std::endl;
+    std::cout << std::setw(26) << "Mode" << std::setw(18) << "us/iteration" << std::endl;
+    std::cout << std::string(44, '-') << std::endl;
+    std::cout << std::setw(26) << "Fresh inner team" << std::setw(18) << std::setprecision(3) << fresh << std::endl;
+    std::cout << std::setw(26) << "Persistent inner team" << std::setw(18) << persistent << std::endl;
+    std::cout << "Persistent speedup: " << std::setprecision(2) << fresh / persistent << "x"
+              << (freshChecksum == persistentChecksum ? "" : "  (checksum mismatch!)") << std::endl;
+}
+
+/**
+ * @brief Re-launch this executable under each runtime setting and tabulate the results
+ *
+ * OMP_MAX_ACTIVE_LEVELS, OMP_WAIT_POLICY and the KMP_HOT_TEAMS_* variables are read
+ * when the runtime starts, so each combination needs its own process.
+ */
+int runEnvironmentSweep(const std::string& executable, const std::string& childArgs, const CliParser& parser) {
+    std::vector<std::string> levels = splitList(parser.getStringOption("sweep_levels", "1,2,3"));
+    std::vector<std::string> waits = splitList(parser.getStringOption("sweep_wait", "active,passive"));
+    std::vector<std::string> hotTeams = splitList(parser.getStringOption("sweep_hot_teams", "0,1"));
+
+    std::cout << "\n=== Team Creation Environment Sweep ===" << std::endl;
+    std::cout << "KMP_HOT_TEAMS_* are honoured by the LLVM/Intel runtime only; other runtimes ignore them." << std::endl;
+    std::cout << std::setw(8) << "Levels" << std::setw(10) << "Wait" << std::setw(6) << "Hot"
+              << std::setw(22) << "Measurement" << std::setw(14) << "us" << std::endl;
+    std::cout << std::string(60, '-') << std::endl;
+
+    for (const std::string& level : levels) {
+        for (const std::string& wait : waits) {
+            for (const std::string& hot : hotTeams) {
+                std::ostringstream command;
+#ifdef _WIN32
+                command << "set OMP_MAX_ACTIVE_LEVELS=" << level << "&& set OMP_WAIT_POLICY=" << wait
+                        << "&& set KMP_HOT_TEAMS_MODE=" << hot << "&& set KMP_HOT_TEAMS_MAX_LEVEL=" << level
+                        << "&& \"" << executable << "\"" << childArgs;
+                FILE* pipe = _popen(command.str().c_str(), "r");
+#else
+                command << "OMP_MAX_ACTIVE_LEVELS=" << level << " OMP_WAIT_POLICY=" << wait
+                        << " KMP_HOT_TEAMS_MODE=" << hot << " KMP_HOT_TEAMS_MAX_LEVEL=" << level
+                        << " \"" << executable << "\"" << childArgs;
+                FILE* pipe = popen(command.str().c_str(), "r");
+#endif
+                if (pipe == nullptr) {
+                    std::cerr << "Error: Could not launch sweep child: " << command.str() << std::endl;
+                    return 1;
+                }
+
+                char buffer[256];
+                while (std::fgets(buffer, sizeof(buffer), pipe) != nullptr) {
+                    std::string line(buffer);
+                    if (line.compare(0, 12, "TEAM_RESULT,") != 0) {
+                        continue;
+                    }
+                    std::vector<std::string> fields = splitList(line.substr(12));
+                    if (fields.size() < 2) {
+                        continue;
+                    }
+                    std::cout << std::setw(8) << level << std::setw(10) << wait << std::setw(6) << hot
+                              << std::setw(22) << fields[0] << std::setw(14) << std::fixed << std::setprecision(3) << std::stod(fields[1]) << std::endl;
+                }
+#ifdef _WIN32
+                _pclose(pipe);
+#else
+                pclose(pipe);
+#endif
+            }
+        }
+    }
+    return 0;
+}
+
+// Entry point
+int main(int argc, char* argv[]) {
+    CliParser parser(argc, argv);
+
+    int maxDepth = parser.getIntOption("max_depth", 3);
+    int width = parser.getIntOption("width", 2);
+    int outerThreads = parser.getIntOption("outer_threads", std::min(4, omp_get_num_procs()));
+    int innerThreads = parser.getIntOption("inner_threads", 2);
+    int repetitions = parser.getIntOption("repetitions", 2000);
+    int iterations = parser.getIntOption("iterations", 10000);
+    int workItems = parser.getIntOption("work_items", 256);
+
+    if (parser.hasOption("team_child")) {
+        runMeasurements(maxDepth, width, outerThreads, innerThreads, repetitions, iterations, workItems, true);
+        return 0;
+    }
+
+    #ifdef _OPENMP
+        std::cout << "OpenMP is supported! Version: " << _OPENMP << std::endl;
+    #else
+        std::cerr << "OpenMP is not supported!" << std::endl;
+        return 1;
+    #endif
+
+    SystemTopology topology;
+    topology.detectTopology();
+    std::cout << "Detected " << topology.getLogicalProcessorCount() << " logical processors" << std::endl;
+
+    if (parser.getBoolOption("sweep", false)) {
+        std::ostringstream childArgs;
+        childArgs << " --team_child --max_depth=" << maxDepth << " --width=" << width
+                  << " --outer_threads=" << outerThreads << " --inner_threads=" << innerThreads
+                  << " --repetitions=" << repetitions << " --iterations=" << iterations
+                  << " --work_items=" << workItems;
+        return runEnvironmentSweep(argv[0], childArgs.str(), parser);
+    }
+
+    runMeasurements(maxDepth, width, outerThreads, innerThreads, repetitions, iterations, workItems, false);
+    return 0;
+}
@@ -0,0 +1,313 @@
+#include "../include/placement_planner.h"
+#include "../include/system_topology.h"
+#include "../include/thread_utils.h"
+#include <omp.h>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <sstream>
+#include <map>
+#include <set>
+
+namespace {
+
+/**
+ * @brief Place an inner team on a partition of physical cores
+ *
+ * Threads take one core each, using the core's first SMT sibling; extra threads
+ * wrap onto the second siblings, then the third, and so on.
+ */
+std::vector<int> placeOnCores(const std::vector<std::vector<int>>& cores, int innerThreads, bool& smtShared) {
+    std::vector<int> processors;
+    if (cores.empty()) {
+        return processors;
+    }
+
+    const int coreCount = static_cast<int>(cores.size());
+    for (int i = 0; i < innerThreads; i++) {
+        const std::vector<int>& siblings = cores[i % coreCount];
+        int round = i / coreCount;
+        if (round > 0 && siblings.size() > 1) {
+            smtShared = true;
+        }
+        processors.push_back(siblings[round % siblings.size()]);
+    }
+    return processors;
+}
+
+/**
+ * @brief Contiguous slice number part of count equal slices of items
+ */
+std::vector<std::vector<int>> slice(const std::vector<std::vector<int>>& items, int part, int count) {
+    const size_t n = items.size();
+    size_t begin = n * part / count;
+    size_t end = n * (part + 1) / count;
+    if (begin == end) {
+        // More partitions than cores: share the core this partition falls on
+        begin = std::min(begin, n - 1);
+        end = begin + 1;
+    }
+    return std::vector<std::vector<int>>(items.begin() + begin, items.begin() + end);
+}
+
+} // namespace
+
+const char* PlacementPolicyName(PlacementPolicy policy) {
+    switch (policy) {
+        case PlacementPolicy::SocketSpread: return "socket";
+        case PlacementPolicy::CoreSpread: return "spread";
+        case PlacementPolicy::Compact: return "compact";
+    }
+    return "unknown";
+}
+
+bool ParsePlacementPolicy(const std::string& name, PlacementPolicy& policy) {
+    for (PlacementPolicy candidate : {PlacementPolicy::SocketSpread, PlacementPolicy::CoreSpread,
+                                      PlacementPolicy::Compact}) {
+        if (name == PlacementPolicyName(candidate)) {
+            policy = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+PlacementPlanner::PlacementPlanner(const SystemTopology& topology)
+    : m_topology(topology) {
+}
+
+std::vector<std::vector<int>> PlacementPlanner::coresOfPackage(int packageId) const {
+    std::vector<std::vector<int>> cores;
+    std::map<int, size_t> coreIndex;
+
+    for (int processor : m_topology.getProcessorsForPackage(packageId)) {
+        int core = m_topology.getPhysicalCoreId(processor);
+        auto it = coreIndex.find(core);
+        if (it == coreIndex.end()) {
+            coreIndex[core] = cores.size();
+            cores.push_back(std::vector<int>{processor});
+        } else {
+            cores[it->second].push_back(processor);
+        }
+    }
+    return cores;
+}
+
+std::vector<int> PlacementPlanner::compactOrder() const {
+    std::vector<int> order;
+    std::set<int> packages;
+    for (int i = 0; i < m_topology.getLogicalProcessorCount(); i++) {
+        if (m_topology.getPackageId(i) >= 0) {
+            packages.insert(m_topology.getPackageId(i));
+        }
+    }
+    for (int package : packages) {
+        for (const auto& core : coresOfPackage(package)) {
+            order.insert(order.end(), core.begin(), core.end());
+        }
+    }
+    return order;
+}
+
+PlacementPlan PlacementPlanner::plan(int outerThreads, int innerThreads, PlacementPolicy policy) const {
+    PlacementPlan result;
+    result.policy = policy;
+    result.outerThreads = std::max(1, outerThreads);
+    result.innerThreads = std::max(1, innerThreads);
+    result.processors.assign(result.outerThreads, std::vector<int>());
+
+    // Packages in ID order, each as a list of physical cores
+    std::vector<std::vector<std::vector<int>>> packages;
+    std::set<int> packageIds;
+    for (int i = 0; i < m_topology.getLogicalProcessorCount(); i++) {
+        if (m_topology.getPackageId(i) >= 0) {
+            packageIds.insert(m_topology.getPackageId(i));
+        }
+    }
+    for (int package : packageIds) {
+        packages.push_back(coresOfPackage(package));
+    }
+    if (packages.empty()) {
+        result.warnings.push_back("No topology information; plan is empty.");
+        return result;
+    }
+
+    bool smtShared = false;
+
+    switch (policy) {
+        case PlacementPolicy::SocketSpread: {
+            // Outer thread o goes to package o % P; outer threads sharing a package split its cores
+            const int packageCount = static_cast<int>(packages.size());
+            if (result.outerThreads < packageCount) {
+                result.warnings.push_back("Fewer outer threads than packages; some packages stay idle.");
+            }
+            for (int o = 0; o < result.outerThreads; o++) {
+                int package = o % packageCount;
+                int sharers = result.outerThreads / packageCount + (package < result.outerThreads % packageCount ? 1 : 0);
+                int part = o / packageCount;
+                result.processors[o] = placeOnCores(slice(packages[package], part, sharers),
+                                                    result.innerThreads, smtShared);
+            }
+            break;
+        }
+
+        case PlacementPolicy::CoreSpread: {
+            std::vector<std::vector<int>> allCores;
+            for (const auto& package : packages) {
+                allCores.insert(allCores.end(), package.begin(), package.end());
+            }
+            for (int o = 0; o < result.outerThreads; o++) {
+                result.processors[o] = placeOnCores(slice(allCores, o, result.outerThreads),
+                                                    result.innerThreads, smtShared);
+            }
+            break;
+        }
+
+        case PlacementPolicy::Compact: {
+            std::vector<int> order = compactOrder();
+            for (int o = 0; o < result.outerThreads; o++) {
+                for (int i = 0; i < result.innerThreads; i++) {
+                    size_t t = static_cast<size_t>(o) * result.innerThreads + i;
+                    result.processors[o].push_back(order[t % order.size()]);
+                }
+            }
+            break;
+        }
+    }
+
+    // Sanity checks over the whole plan
+    std::map<int, int> usage;
+    std::map<int, std::set<int>> coreUsage;
+    for (const auto& team : result.processors) {
+        for (int processor : team) {
+            usage[processor]++;
+            coreUsage[m_topology.getPhysicalCoreId(processor)].insert(processor);
+        }
+    }
+    int totalThreads = result.outerThreads * result.innerThreads;
+    if (totalThreads > m_topology.getLogicalProcessorCount()) {
+        result.warnings.push_back("Oversubscribed: " + std::to_string(totalThreads) + " threads on " +
+                                  std::to_string(m_topology.getLogicalProcessorCount()) + " logical processors.");
+    } else if (std::any_of(usage.begin(), usage.end(), [](const std::pair<const int, int>& p) { return p.second > 1; })) {
+        result.warnings.push_back("Some threads share a logical processor.");
+    }
+    if (smtShared || (policy != PlacementPolicy::Compact &&
+                      std::any_of(coreUsage.begin(), coreUsage.end(),
+                                  [](const std::pair<const int, std::set<int>>& p) { return p.second.size() > 1; }))) {
+        result.warnings.push_back("Some threads share a physical core through SMT.");
+    }
+
+    // One place per thread in outer-major order: with OMP_PROC_BIND=spread,close the
+    // runtime gives outer thread o the o-th block of innerThreads places and its inner
+    // team one place each inside that block
+    std::ostringstream places;
+    for (size_t o = 0; o < result.processors.size(); o++) {
+        for (size_t i = 0; i < result.processors[o].size(); i++) {
+            places << ((o == 0 && i == 0) ? "" : ",") << "{" << result.processors[o][i] << "}";
+        }
+    }
+    result.ompPlaces = places.str();
+    result.ompProcBind = "spread,close";
+    result.ompNumThreads = std::to_string(result.outerThreads) + "," + std::to_string(result.innerThreads);
+
+    return result;
+}
+
+bool PlacementPlanner::pinCurrentThread(const PlacementPlan& plan, int outerId, int innerId) {
+    if (outerId < 0 || outerId >= static_cast<int>(plan.processors.size())) {
+        return false;
+    }
+    const std::vector<int>& team = plan.processors[outerId];
+    if (innerId < 0 || innerId >= static_cast<int>(team.size())) {
+        return false;
+    }
+    return SetThreadAffinity(team[innerId]);
+}
+
+PlacementValidation PlacementPlanner::validate(const PlacementPlan& plan) {
+    PlacementValidation validation;
+    validation.threadsChecked = 0;
+    validation.threadsPinned = 0;
+    validation.threadsOnTarget = 0;
+    validation.observed.assign(plan.outerThreads, std::vector<int>(plan.innerThreads, -1));
+
+    bool previousNested = SetNestedParallelism(true);
+
+    #pragma omp parallel num_threads(plan.outerThreads) shared(plan, validation)
+    {
+        int outerId = omp_get_thread_num();
+
+        #pragma omp parallel num_threads(plan.innerThreads) shared(plan, validation, outerId)
+        {
+            int innerId = omp_get_thread_num();
+            std::vector<int> savedMask = GetThreadAffinityMask();
+            bool pinned = pinCurrentThread(plan, outerId, innerId);
+
+            // Keep the thread busy briefly so the scheduler has moved it
+            volatile double sink = 0.0;
+            for (int i = 0; i < 200000; i++) {
+                sink = sink + i * 0.5;
+            }
+            int core = GetThreadCoreID();
+
+            #pragma omp critical
+            {
+                validation.threadsChecked++;
+                if (pinned) {
+                    validation.threadsPinned++;
+                }
+                if (outerId < plan.outerThreads && innerId < plan.innerThreads) {
+                    validation.observed[outerId][innerId] = core;
+                    if (core >= 0 && innerId < static_cast<int>(plan.processors[outerId].size()) &&
+                        core == plan.processors[outerId][innerId]) {
+                        validation.threadsOnTarget++;
+                    }
+                }
+            }
+
+            // Everyone has sampled; give the pooled thread its original mask back
+            #pragma omp barrier
+            if (!savedMask.empty()) {
+                SetThreadAffinityMask(savedMask);
+            }
+        }
+    }
+
+    SetNestedParallelism(previousNested);
+    return validation;
+}
+
+void PlacementPlanner::displayPlan(const PlacementPlan& plan) const {
+    std::cout << "\nPlacement plan (" << PlacementPolicyName(plan.policy) << "): "
+              << plan.outerThreads << " outer x " << plan.innerThreads << " inner" << std::endl;
+    std::cout << std::setw(8) << "Outer" << std::setw(8) << "Inner" << std::setw(12) << "Processor"
+              << std::setw(10) << "Package" << std::setw(8) << "Core" << std::setw(8) << "NUMA" << std::endl;
+    std::cout << std::string(54, '-') << std::endl;
+
+    for (int o = 0; o < static_cast<int>(plan.processors.size()); o++) {
+        for (int i = 0; i < static_cast<int>(plan.processors[o].size()); i++) {
+            int processor = plan.processors[o][i];
+            std::cout << std::setw(8) << o << std::setw(8) << i << std::setw(12) << processor
+                      << std::setw(10) << m_topology.getPackageId(processor)
+                      << std::setw(8) << m_topology.getPhysicalCoreId(processor)
+                      << std::setw(8) << m_topology.getNumaNodeForProcessor(processor) << std::endl;
+        }
+    }
+
+    for (const auto& warning : plan.warnings) {
+        std::cout << "Warning: " << warning << std::endl;
+    }
+}
+
+void PlacementPlanner::displayEnvironment(const PlacementPlan& plan) {
+    std::cout << "\nEquivalent OpenMP environment:" << std::endl;
+#ifdef _WIN32
+    const char* prefix = "set ";
+#else
+    const char* prefix = "export ";
+#endif
+    std::cout << "  " << prefix << "OMP_NUM_THREADS=" << plan.ompNumThreads << std::endl;
+    std::cout << "  " << prefix << "OMP_PROC_BIND=" << plan.ompProcBind << std::endl;
+    std::cout << "  " << prefix << "OMP_PLACES=\"" << plan.ompPlaces << "\"" << std::endl;
+    std::cout << "  " << prefix << "OMP_MAX_ACTIVE_LEVELS=2" << std::endl;
+}
@@ -3,10 +3,100 @@
 #include <iomanip>
 #include <algorithm>
 #include <sstream>
+#include <fstream>
+#include <cctype>
 
 // Windows-specific includes
 #ifdef _WIN32
 #include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+#ifndef _WIN32
+namespace {
+
+// Parse a sysfs CPU list such as "0-3,8,10-11"
+std::vector<int> parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream stream(list);
+    std::string range;
+    
+    while (std::getline(stream, range, ',')) {
+        if (range.empty() || !std::isdigit(static_cast<unsigned char>(range[0]))) {
+            continue;
+        }
+        size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; cpu++) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+// First line of a sysfs file, or "" if it cannot be read
+std::string readSysfsString(const std::string& path) {
+    std::ifstream file(path);
+    std::string line;
+    if (file.is_open()) {
+        std::getline(file, line);
+    }
+    return line;
+}
+
+int readSysfsInt(const std::string& path, int defaultValue) {
+    std::string value = readSysfsString(path);
+    try {
+        return value.empty() ? defaultValue : std::stoi(value);
+    } catch (const std::exception&) {
+        return defaultValue;
+    }
+}
+
+// Parse sizes like "48K", "2048K" or "32M" into bytes
+long long parseCacheSize(const std::string& text) {
+    if (text.empty()) {
+        return 0;
+    }
+    long long value = 0;
+    try {
+        value = std::stoll(text);
+    } catch (const std::exception&) {
+        return 0;
+    }
+    switch (std::toupper(static_cast<unsigned char>(text.back()))) {
+        case 'K': return value * 1024;
+        case 'M': return value * 1024 * 1024;
+        case 'G': return value * 1024 * 1024 * 1024;
+        default: return value;
+    }
+}
+
+// Numeric suffixes of directory entries named <prefix><number>, ascending
+std::vector<int> listNumberedEntries(const std::string& directory, const std::string& prefix) {
+    std::vector<int> numbers;
+    DIR* dir = opendir(directory.c_str());
+    if (dir == nullptr) {
+        return numbers;
+    }
+    
+    while (dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name.size() > prefix.size() && name.compare(0, prefix.size(), prefix) == 0 &&
+            std::all_of(name.begin() + prefix.size(), name.end(),
+                        [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; })) {
+            numbers.push_back(std::stoi(name.substr(prefix.size())));
+        }
+    }
+    closedir(dir);
+    
+    std::sort(numbers.begin(), numbers.end());
+    return numbers;
+}
+
+} // namespace
 #endif
 
 SystemTopology::SystemTopology()
@@ -23,8 +113,7 @@ bool SystemTopology::detectTopology() {
 #ifdef _WIN32
     return detectWindowsTopology();
 #else
-    std::cerr << "Topology detection is only supported on Windows." << std::endl;
-    return false;
+    return detectLinuxTopology();
 #endif
 }
 
@@ -113,6 +202,25 @@ bool SystemTopology::detectWindowsTopology() {
                 break;
             }
             
+            case RelationCache: {
+                // One cache instance and the processors sharing it
+                const CACHE_DESCRIPTOR& cache = buffer[i].Cache;
+                CacheInfo info;
+                info.level = cache.Level;
+                info.type = (cache.Type == CacheData) ? "Data" :
+                            (cache.Type == CacheInstruction) ? "Instruction" : "Unified";
+                info.sizeBytes = cache.Size;
+                info.lineSize = cache.LineSize;
+                
+                for (int lp = 0; lp < m_logicalProcessorCount; lp++) {
+                    if (buffer[i].ProcessorMask & (1ULL << lp)) {
+                        info.sharedProcessors.push_back(lp);
+                    }
+                }
+                m_caches.push_back(info);
+                break;
+            }
+            
             case RelationProcessorPackage: {
                 // This is a physical processor package
                 ULONG_PTR processorMask = buffer[i].ProcessorMask;
@@ -158,6 +266,10 @@ bool SystemTopology::detectWindowsTopology() {
     // Clean up
     delete[] buffer;
     
+    std::sort(m_caches.begin(), m_caches.end(), [](const CacheInfo& a, const CacheInfo& b) {
+        return a.level < b.level;
+    });
+    
     // If we didn't find NUMA information with GetLogicalProcessorInformation,
     // try to get it using the NUMA API
     if (m_numaNodeCount == 0) {
@@ -189,6 +301,113 @@ void SystemTopology::detectNumaTopology() {
 #endif
 }
 
+#ifndef _WIN32
+bool SystemTopology::detectLinuxTopology() {
+    const std::string cpuRoot = "/sys/devices/system/cpu/";
+    std::vector<int> cpus = parseCpuList(readSysfsString(cpuRoot + "online"));
+    if (cpus.empty()) {
+        cpus = listNumberedEntries(cpuRoot, "cpu");
+    }
+    if (cpus.empty()) {
+        std::cerr << "Failed to read CPU topology from " << cpuRoot << std::endl;
+        return false;
+    }
+    
+    // Logical IDs may be sparse (offline CPUs); unknown entries stay -1
+    m_logicalProcessorCount = cpus.back() + 1;
+    m_logicalToPackage.assign(m_logicalProcessorCount, -1);
+    m_logicalToPhysicalCore.assign(m_logicalProcessorCount, -1);
+    m_logicalToNumaNode.assign(m_logicalProcessorCount, -1);
+    m_caches.clear();
+    m_numaToLogical.clear();
+    
+    // core_id is only unique within a package, so number (package, core) pairs globally
+    std::map<std::pair<int, int>, int> globalCoreIds;
+    std::map<int, std::set<int>> coresPerPackage;
+    std::set<std::string> seenCaches;
+    
+    for (int cpu : cpus) {
+        std::string cpuDir = cpuRoot + "cpu" + std::to_string(cpu) + "/";
+        int package = readSysfsInt(cpuDir + "topology/physical_package_id", 0);
+        int core = readSysfsInt(cpuDir + "topology/core_id", cpu);
+        
+        auto key = std::make_pair(package, core);
+        auto it = globalCoreIds.find(key);
+        if (it == globalCoreIds.end()) {
+            it = globalCoreIds.emplace(key, static_cast<int>(globalCoreIds.size())).first;
+        }
+        
+        m_logicalToPackage[cpu] = package;
+        m_logicalToPhysicalCore[cpu] = it->second;
+        coresPerPackage[package].insert(core);
+        
+        // Cache instances: each shared group is listed by every member, keep it once
+        for (int index : listNumberedEntries(cpuDir + "cache", "index")) {
+            std::string cacheDir = cpuDir + "cache/index" + std::to_string(index) + "/";
+            CacheInfo info;
+            info.level = readSysfsInt(cacheDir + "level", 0);
+            info.type = readSysfsString(cacheDir + "type");
+            info.sizeBytes = parseCacheSize(readSysfsString(cacheDir + "size"));
+            info.lineSize = readSysfsInt(cacheDir + "coherency_line_size", 0);
+            
+            std::string sharedList = readSysfsString(cacheDir + "shared_cpu_list");
+            info.sharedProcessors = parseCpuList(sharedList);
+            if (info.sharedProcessors.empty()) {
+                info.sharedProcessors.push_back(cpu);
+                sharedList = std::to_string(cpu);
+            }
+            
+            std::string identity = std::to_string(info.level) + "/" + info.type + "/" + sharedList;
+            if (info.level > 0 && seenCaches.insert(identity).second) {
+                m_caches.push_back(info);
+            }
+        }
+    }
+    
+    m_physicalPackageCount = static_cast<int>(coresPerPackage.size());
+    if (m_physicalPackageCount > 0) {
+        int totalCores = 0;
+        for (const auto& pair : coresPerPackage) {
+            totalCores += static_cast<int>(pair.second.size());
+        }
+        m_coresPerPackage = totalCores / m_physicalPackageCount;
+    }
+    
+    std::stable_sort(m_caches.begin(), m_caches.end(), [](const CacheInfo& a, const CacheInfo& b) {
+        return a.level < b.level;
+    });
+    
+    detectLinuxNumaTopology();
+    return true;
+}
+
+void SystemTopology::detectLinuxNumaTopology() {
+    const std::string nodeRoot = "/sys/devices/system/node/";
+    
+    for (int node : listNumberedEntries(nodeRoot, "node")) {
+        std::vector<int> nodeCpus = parseCpuList(readSysfsString(nodeRoot + "node" + std::to_string(node) + "/cpulist"));
+        for (int cpu : nodeCpus) {
+            if (cpu >= 0 && cpu < m_logicalProcessorCount && m_logicalToPackage[cpu] >= 0) {
+                m_logicalToNumaNode[cpu] = node;
+                m_numaToLogical[node].push_back(cpu);
+            }
+        }
+    }
+    
+    // Kernels without NUMA support expose no node directories: one node holds everything
+    if (m_numaToLogical.empty()) {
+        for (int cpu = 0; cpu < m_logicalProcessorCount; cpu++) {
+            if (m_logicalToPackage[cpu] >= 0) {
+                m_logicalToNumaNode[cpu] = 0;
+                m_numaToLogical[0].push_back(cpu);
+            }
+        }
+    }
+    
+    m_numaNodeCount = static_cast<int>(m_numaToLogical.size());
+}
+#endif
+
 int SystemTopology::getLogicalProcessorCount() const {
     return m_logicalProcessorCount;
 }
@@ -209,18 +428,60 @@ void SystemTopology::displayProcessorMap() const {
     std::cout << "\n=== Processor Map ===" << std::endl;
     
     std::cout << std::setw(10) << "Logical" << std::setw(10) << "Package" 
-              << std::setw(10) << "Core" << std::setw(10) << "NUMA Node" << std::endl;
-    std::cout << std::string(40, '-') << std::endl;
+              << std::setw(10) << "Core" << std::setw(10) << "NUMA Node"
+              << "  SMT Siblings" << std::endl;
+    std::cout << std::string(54, '-') << std::endl;
     
     for (int i = 0; i < m_logicalProcessorCount; i++) {
+        if (m_logicalToPackage[i] < 0 && m_logicalToPhysicalCore[i] < 0) {
+            continue; // Offline or unknown processor
+        }
+        
+        std::ostringstream siblings;
+        std::vector<int> smt = getSmtSiblings(i);
+        for (size_t s = 0; s < smt.size(); s++) {
+            siblings << (s > 0 ? "," : "") << smt[s];
+        }
+        
         std::cout << std::setw(10) << i 
                   << std::setw(10) << m_logicalToPackage[i]
                   << std::setw(10) << m_logicalToPhysicalCore[i]
                   << std::setw(10) << m_logicalToNumaNode[i]
+                  << "  " << siblings.str()
                   << std::endl;
     }
 }
 
+void SystemTopology::displayCacheInfo() const {
+    if (m_caches.empty()) {
+        std::cout << "No cache information available." << std::endl;
+        return;
+    }
+    
+    std::cout << "\n=== Cache Hierarchy ===" << std::endl;
+    std::cout << std::setw(6) << "Level" << std::setw(13) << "Type" << std::setw(10) << "Size"
+              << std::setw(8) << "Line" << "  Shared by" << std::endl;
+    std::cout << std::string(60, '-') << std::endl;
+    
+    for (const auto& cache : m_caches) {
+        std::ostringstream size;
+        if (cache.sizeBytes >= 1024 * 1024 && cache.sizeBytes % (1024 * 1024) == 0) {
+            size << cache.sizeBytes / (1024 * 1024) << "M";
+        } else {
+            size << cache.sizeBytes / 1024 << "K";
+        }
+        
+        std::cout << std::setw(5) << "L" << cache.level
+                  << std::setw(13) << cache.type
+                  << std::setw(10) << size.str()
+                  << std::setw(8) << cache.lineSize << "  ";
+        for (size_t i = 0; i < cache.sharedProcessors.size(); i++) {
+            std::cout << (i > 0 ? "," : "") << cache.sharedProcessors[i];
+        }
+        std::cout << std::endl;
+    }
+}
+
 void SystemTopology::displayNumaInfo() const {
     if (m_numaNodeCount <= 0) {
         std::cout << "No NUMA information available." << std::endl;
@@ -273,4 +534,73 @@ std::vector<int> SystemTopology::getProcessorsForNumaNode(int numaNode) const {
         return it->second;
     }
     return std::vector<int>();
-}
\ No newline at end of file
+}
+
+std::vector<int> SystemTopology::getProcessorsForPackage(int packageId) const {
+    std::vector<int> processors;
+    for (int i = 0; i < m_logicalProcessorCount; i++) {
+        if (m_logicalToPackage[i] == packageId) {
+            processors.push_back(i);
+        }
+    }
+    return processors;
+}
+
+int SystemTopology::getPhysicalCoreCount() const {
+    std::set<int> cores;
+    for (int core : m_logicalToPhysicalCore) {
+        if (core >= 0) {
+            cores.insert(core);
+        }
+    }
+    return static_cast<int>(cores.size());
+}
+
+std::vector<int> SystemTopology::getSmtSiblings(int logicalProcessor) const {
+    std::vector<int> siblings;
+    int core = getPhysicalCoreId(logicalProcessor);
+    if (core < 0) {
+        return siblings;
+    }
+    for (int i = 0; i < m_logicalProcessorCount; i++) {
+        if (m_logicalToPhysicalCore[i] == core) {
+            siblings.push_back(i);
+        }
+    }
+    return siblings;
+}
+
+std::vector<int> SystemTopology::getProcessorsSharingCache(int logicalProcessor, int level) const {
+    for (const auto& cache : m_caches) {
+        if (cache.level != level || cache.type == "Instruction") {
+            continue;
+        }
+        if (std::find(cache.sharedProcessors.begin(), cache.sharedProcessors.end(), logicalProcessor) !=
+            cache.sharedProcessors.end()) {
+            return cache.sharedProcessors;
+        }
+    }
+    return std::vector<int>();
+}
+
+long long SystemTopology::getCacheSize(int level) const {
+    for (const auto& cache : m_caches) {
+        if (cache.level == level && cache.type != "Instruction") {
+            return cache.sizeBytes;
+        }
+    }
+    return 0;
+}
+
+int SystemTopology::getCacheLineSize() const {
+    for (const auto& cache : m_caches) {
+        if (cache.lineSize > 0) {
+            return cache.lineSize;
+        }
+    }
+    return 64;
+}
+
+const std::vector<CacheInfo>& SystemTopology::getCaches() const {
+    return m_caches;
+}
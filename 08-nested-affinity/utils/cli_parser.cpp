@@ -118,21 +118,70 @@ std::vector<std::string> CliParser::getPositionalArgs() const {
 }
 
 void CliParser::displayHelp() const {
+    // Each executable reads its own options; pick the section by program name
+    const std::string program = std::filesystem::path(m_programName).stem().string();
+    
     std::cout << "Usage: " << m_programName << " [options] [arguments]" << std::endl;
     std::cout << std::endl;
     std::cout << "Options:" << std::endl;
     std::cout << "  -h, --help                  Display this help message" << std::endl;
-    std::cout << "  --demo=N                    Run a specific demo (1-6)" << std::endl;
-    std::cout << "  --outer_threads=N           Set the number of threads for outer parallel regions" << std::endl;
-    std::cout << "  --inner_threads=N           Set the number of threads for inner parallel regions" << std::endl;
-    std::cout << "  --proc_bind=POLICY          Set OpenMP thread affinity policy (master, close, spread)" << std::endl;
-    std::cout << "  --max_levels=N              Set the maximum number of active parallel levels" << std::endl;
-    std::cout << "  --matrix_size=N             Set the size of matrices for matrix multiplication" << std::endl;
-    std::cout << "  --verbose                   Enable verbose output" << std::endl;
-    std::cout << std::endl;
-    std::cout << "Examples:" << std::endl;
-    std::cout << "  " << m_programName << " --demo=1                  Run system topology demo" << std::endl;
-    std::cout << "  " << m_programName << " --outer_threads=4 --inner_threads=2  Run with 4 outer and 2 inner threads" << std::endl;
-    std::cout << "  " << m_programName << " --proc_bind=spread        Run with 'spread' thread affinity policy" << std::endl;
+    
+    if (program == "matrix_multiplication") {
+        std::cout << "  --matrix_size=N             Matrix dimension (default: 1000)" << std::endl;
+        std::cout << "  --outer_threads=N           Threads in the outer parallel region (default: min(4, logical processors))" << std::endl;
+        std::cout << "  --inner_threads=N           Threads in each inner parallel region (default: 2)" << std::endl;
+        std::cout << "  --block_size=N              Tile size of the blocked multiply (default: 32)" << std::endl;
+        std::cout << "  --leaf_size=N               Leaf size of the recursive multiply (default: 128)" << std::endl;
+        std::cout << "  --strassen_threshold=N      Stop the Strassen recursion at or below this dimension (default: 512)" << std::endl;
+        std::cout << "  --monitor                   Track thread migrations during the parallel variants (default: off)" << std::endl;
+        std::cout << "  --monitor_interval_us=N     Migration monitor sampling interval in microseconds (default: 1000)" << std::endl;
+        std::cout << "  --numa_policy=POLICY        Compare NUMA placements: default, node, interleave, firsttouch or all (default: off)" << std::endl;
+        std::cout << "  --threads=N                 Threads for the NUMA placement comparison (default: OMP max threads)" << std::endl;
+        std::cout << std::endl;
+        std::cout << "Affinity sweep:" << std::endl;
+        std::cout << "  --sweep                     Re-run every variant under each OMP_PROC_BIND x OMP_PLACES setting (default: off)" << std::endl;
+        std::cout << "  --sweep_threads=N           Total threads, split into every outer x inner factorization (default: logical processors)" << std::endl;
+        std::cout << "  --sweep_bind=LIST           OMP_PROC_BIND values (default: close,spread,primary)" << std::endl;
+        std::cout << "  --sweep_places=LIST         OMP_PLACES values (default: threads,cores,sockets)" << std::endl;
+        std::cout << "  --sweep_variants=LIST       Multiply variants (default: basic,nested,register,recursive,strassen)" << std::endl;
+        std::cout << "  --sweep_csv=FILE            CSV output (default: affinity_sweep.csv)" << std::endl;
+        std::cout << "  --sweep_json=FILE           JSON output (default: affinity_sweep.json)" << std::endl;
+        std::cout << std::endl;
+        std::cout << "Examples:" << std::endl;
+        std::cout << "  " << m_programName << " --matrix_size=2048 --outer_threads=4 --inner_threads=2" << std::endl;
+        std::cout << "  " << m_programName << " --sweep --sweep_variants=register,strassen" << std::endl;
+    } else if (program == "team_creation_cost") {
+        std::cout << "  --max_depth=N               Deepest nesting level measured (default: 3)" << std::endl;
+        std::cout << "  --width=N                   Threads per team at each nesting level (default: 2)" << std::endl;
+        std::cout << "  --outer_threads=N           Threads in the outer parallel region (default: min(4, processors))" << std::endl;
+        std::cout << "  --inner_threads=N           Threads in each inner parallel region (default: 2)" << std::endl;
+        std::cout << "  --repetitions=N             Parallel regions opened per measurement (default: 2000)" << std::endl;
+        std::cout << "  --iterations=N              Iterations of the fresh/persistent team comparison (default: 10000)" << std::endl;
+        std::cout << "  --work_items=N              Work items per iteration in that comparison (default: 256)" << std::endl;
+        std::cout << "  --sweep                     Re-run under each runtime setting below (default: off)" << std::endl;
+        std::cout << "  --sweep_levels=LIST         OMP_MAX_ACTIVE_LEVELS values (default: 1,2,3)" << std::endl;
+        std::cout << "  --sweep_wait=LIST           OMP_WAIT_POLICY values (default: active,passive)" << std::endl;
+        std::cout << "  --sweep_hot_teams=LIST      KMP_HOT_TEAMS_MODE values (default: 0,1)" << std::endl;
+        std::cout << std::endl;
+        std::cout << "Examples:" << std::endl;
+        std::cout << "  " << m_programName << " --max_depth=2 --width=4" << std::endl;
+        std::cout << "  " << m_programName << " --sweep --sweep_wait=passive" << std::endl;
+    } else {
+        std::cout << "  --demo=N                    Run a specific demo (1-7) instead of the menu" << std::endl;
+        std::cout << "  --outer_threads=N           Set the number of threads for outer parallel regions (default: min(4, logical processors))" << std::endl;
+        std::cout << "  --inner_threads=N           Set the number of threads for inner parallel regions (default: 2)" << std::endl;
+        std::cout << "  --proc_bind=POLICY          Set OpenMP thread affinity policy (master, close, spread)" << std::endl;
+        std::cout << "  --max_levels=N              Set the maximum number of active parallel levels" << std::endl;
+        std::cout << "  --matrix_size=N             Set the size of matrices for matrix multiplication (default: 512)" << std::endl;
+        std::cout << "  --policy=POLICY             Placement planner policy: socket, spread, compact (default: socket)" << std::endl;
+        std::cout << "  --threads=N                 Threads for the hierarchical reduction demo (default: logical processors)" << std::endl;
+        std::cout << "  --iterations=N              Iterations of the hierarchical reduction demo (default: 20000)" << std::endl;
+        std::cout << "  --verbose                   Enable verbose output" << std::endl;
+        std::cout << std::endl;
+        std::cout << "Examples:" << std::endl;
+        std::cout << "  " << m_programName << " --demo=1                  Run system topology demo" << std::endl;
+        std::cout << "  " << m_programName << " --outer_threads=4 --inner_threads=2  Run with 4 outer and 2 inner threads" << std::endl;
+        std::cout << "  " << m_programName << " --proc_bind=spread        Run with 'spread' thread affinity policy" << std::endl;
+    }
     std::cout << std::endl;
-}
\ No newline at end of file
+}
@@ -0,0 +1,92 @@
+#include "../include/hierarchical_reduction.h"
+#include "../include/system_topology.h"
+#include "../include/thread_utils.h"
+#include <omp.h>
+#include <iostream>
+#include <algorithm>
+#include <map>
+
+HierarchicalReduction::HierarchicalReduction(const SystemTopology& topology, int numThreads)
+    : m_numThreads(std::max(1, numThreads)),
+      m_partials(m_numThreads),
+      m_groupOfThread(m_numThreads, -1) {
+    m_result.value = 0.0;
+
+    // Node of each thread as placed by the runtime for a team of this size
+    std::vector<int> nodeOfThread(m_numThreads, 0);
+    #pragma omp parallel num_threads(m_numThreads) shared(topology, nodeOfThread)
+    {
+        int tid = omp_get_thread_num();
+        int node = topology.getNumaNodeForProcessor(GetThreadCoreID());
+        if (tid < static_cast<int>(nodeOfThread.size())) {
+            nodeOfThread[tid] = node < 0 ? 0 : node;
+        }
+    }
+
+    std::map<int, std::vector<int>> membersOfNode;
+    for (int tid = 0; tid < m_numThreads; tid++) {
+        membersOfNode[nodeOfThread[tid]].push_back(tid);
+    }
+    for (const auto& pair : membersOfNode) {
+        NodeGroup group;
+        group.node = pair.first;
+        group.members = pair.second;
+        group.representative = pair.second.front();
+        m_groupOfThread[group.representative] = static_cast<int>(m_groups.size());
+        m_groups.push_back(group);
+    }
+    m_nodeSums.resize(m_groups.size());
+}
+
+double HierarchicalReduction::reduce(double partial) {
+    const int tid = omp_get_thread_num();
+    if (tid < m_numThreads) {
+        m_partials[tid].value = partial;
+    }
+
+    #pragma omp barrier
+
+    // Stage 1: each node's representative sums the lines written on its node
+    int group = tid < m_numThreads ? m_groupOfThread[tid] : -1;
+    if (group >= 0) {
+        double sum = 0.0;
+        for (int member : m_groups[group].members) {
+            sum += m_partials[member].value;
+        }
+        m_nodeSums[group].value = sum;
+    }
+
+    #pragma omp barrier
+
+    // Stage 2: one line per node crosses the interconnect
+    if (tid == 0) {
+        double sum = 0.0;
+        for (const PaddedValue& nodeSum : m_nodeSums) {
+            sum += nodeSum.value;
+        }
+        m_result.value = sum;
+    }
+
+    #pragma omp barrier
+    return m_result.value;
+}
+
+int HierarchicalReduction::getThreadCount() const {
+    return m_numThreads;
+}
+
+int HierarchicalReduction::getGroupCount() const {
+    return static_cast<int>(m_groups.size());
+}
+
+void HierarchicalReduction::displayGroups() const {
+    std::cout << "Reduction groups for " << m_numThreads << " threads:" << std::endl;
+    for (const NodeGroup& group : m_groups) {
+        std::cout << "  NUMA node " << group.node << ": representative " << group.representative
+                  << ", threads";
+        for (int member : group.members) {
+            std::cout << " " << member;
+        }
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,287 @@
+#include "../include/migration_monitor.h"
+#include "../include/system_topology.h"
+#include "../include/thread_utils.h"
+#include <omp.h>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <map>
+
+// Platform-specific includes
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::atomic<unsigned long long> g_nextInstanceId{1};
+
+// Slot of the calling thread in the monitor it registered with
+thread_local unsigned long long t_monitorId = 0;
+thread_local int t_slot = -1;
+
+long long CurrentOsThreadId() {
+#ifdef _WIN32
+    return static_cast<long long>(GetCurrentThreadId());
+#elif defined(SYS_gettid)
+    return static_cast<long long>(syscall(SYS_gettid));
+#else
+    return 0;
+#endif
+}
+
+} // namespace
+
+MigrationMonitor::MigrationMonitor(const SystemTopology& topology, int intervalMicros)
+    : m_topology(topology),
+      m_instanceId(g_nextInstanceId.fetch_add(1)),
+      m_interval(std::max(50, intervalMicros)),
+      m_slots(MAX_THREADS),
+      m_processMask(GetThreadAffinityMask()) {
+}
+
+MigrationMonitor::~MigrationMonitor() {
+    stop();
+}
+
+bool MigrationMonitor::samplesFromOs() {
+#ifdef __linux__
+    return true;
+#else
+    return false;
+#endif
+}
+
+int MigrationMonitor::registerCurrentThread() {
+    if (t_monitorId == m_instanceId) {
+        return t_slot;
+    }
+
+    std::lock_guard<std::mutex> lock(m_registerMutex);
+    int index = m_registered.load(std::memory_order_relaxed);
+    if (index >= MAX_THREADS) {
+        return -1;
+    }
+
+    ThreadSlot& slot = m_slots[index];
+    slot.osThreadId = CurrentOsThreadId();
+    slot.stats.ompThreadNum = omp_get_thread_num();
+    slot.stats.homeProcessor = GetThreadCoreID();
+    slot.stats.place = GetThreadAffinityMask();
+    slot.stats.pinned = !slot.stats.place.empty() && slot.stats.place.size() < m_processMask.size();
+    slot.stats.samples = 0;
+    slot.stats.migrations = 0;
+    slot.stats.offPlaceSeconds = 0.0;
+    slot.stats.smtSharedSeconds = 0.0;
+    slot.stats.processorsSeen.clear();
+    slot.lastProcessor = -1;
+    slot.publishedProcessor.store(slot.stats.homeProcessor, std::memory_order_relaxed);
+
+    // The sampler only reads slots below m_registered
+    m_registered.store(index + 1, std::memory_order_release);
+
+    t_monitorId = m_instanceId;
+    t_slot = index;
+    return index;
+}
+
+void MigrationMonitor::checkpoint() {
+    if (t_monitorId == m_instanceId && t_slot >= 0) {
+        m_slots[t_slot].publishedProcessor.store(GetThreadCoreID(), std::memory_order_relaxed);
+    }
+}
+
+void MigrationMonitor::start() {
+    if (m_running.exchange(true)) {
+        return;
+    }
+    m_sampledSeconds = 0.0;
+    m_samplesTaken = 0;
+    m_smtSamples = 0;
+    m_sampler = std::thread(&MigrationMonitor::samplerLoop, this);
+}
+
+void MigrationMonitor::stop() {
+    if (!m_running.exchange(false)) {
+        return;
+    }
+    if (m_sampler.joinable()) {
+        m_sampler.join();
+    }
+}
+
+int MigrationMonitor::readProcessor(ThreadSlot& slot, bool& running) const {
+    running = false;
+#ifdef __linux__
+    // Field 3 of /proc/<pid>/task/<tid>/stat is the scheduler state ('R' = running
+    // or runnable), field 39 the processor the task last ran on
+    std::ifstream file("/proc/self/task/" + std::to_string(slot.osThreadId) + "/stat");
+    std::string line;
+    if (!file.is_open() || !std::getline(file, line)) {
+        return -1;
+    }
+
+    // The command name (field 2) may contain spaces; fields resume after the last ')'
+    size_t close = line.rfind(')');
+    if (close == std::string::npos) {
+        return -1;
+    }
+    std::istringstream fields(line.substr(close + 1));
+    std::string field;
+    for (int index = 3; index <= 39 && fields >> field; index++) {
+        if (index == 3) {
+            running = field == "R";
+        } else if (index == 39) {
+            try {
+                return std::stoi(field);
+            } catch (const std::exception&) {
+                return -1;
+            }
+        }
+    }
+    return -1;
+#else
+    // checkpoint() publications carry no run state; treat the thread as running
+    running = true;
+    return slot.publishedProcessor.load(std::memory_order_relaxed);
+#endif
+}
+
+void MigrationMonitor::samplerLoop() {
+    auto last = std::chrono::steady_clock::now();
+    std::vector<int> current;
+    std::vector<bool> runningNow;
+
+    while (m_running.load(std::memory_order_relaxed)) {
+        std::this_thread::sleep_for(m_interval);
+
+        auto now = std::chrono::steady_clock::now();
+        double dt = std::chrono::duration<double>(now - last).count();
+        last = now;
+        m_sampledSeconds += dt;
+        m_samplesTaken++;
+
+        const int registered = m_registered.load(std::memory_order_acquire);
+        current.assign(registered, -1);
+        runningNow.assign(registered, false);
+
+        for (int i = 0; i < registered; i++) {
+            ThreadSlot& slot = m_slots[i];
+            bool running = false;
+            int processor = readProcessor(slot, running);
+            current[i] = processor;
+            runningNow[i] = running;
+            if (processor < 0) {
+                continue;
+            }
+
+            ThreadMigrationStats& stats = slot.stats;
+            stats.samples++;
+            if (slot.lastProcessor >= 0 && processor != slot.lastProcessor) {
+                stats.migrations++;
+            }
+            slot.lastProcessor = processor;
+
+            bool offPlace = stats.pinned
+                ? std::find(stats.place.begin(), stats.place.end(), processor) == stats.place.end()
+                : processor != stats.homeProcessor;
+            if (offPlace) {
+                stats.offPlaceSeconds += dt;
+            }
+
+            if (std::find(stats.processorsSeen.begin(), stats.processorsSeen.end(), processor) ==
+                stats.processorsSeen.end()) {
+                stats.processorsSeen.push_back(processor);
+            }
+        }
+
+        // Threads on different logical processors of one physical core compete for it;
+        // a sleeping thread still reports its last processor, so only running ones count
+        std::map<int, std::vector<int>> threadsPerCore;
+        for (int i = 0; i < registered; i++) {
+            if (current[i] >= 0 && runningNow[i]) {
+                threadsPerCore[m_topology.getPhysicalCoreId(current[i])].push_back(i);
+            }
+        }
+
+        bool coScheduled = false;
+        for (const auto& pair : threadsPerCore) {
+            if (pair.first < 0 || pair.second.size() < 2) {
+                continue;
+            }
+            int firstProcessor = current[pair.second[0]];
+            bool siblings = std::any_of(pair.second.begin(), pair.second.end(),
+                                        [&](int t) { return current[t] != firstProcessor; });
+            if (siblings) {
+                coScheduled = true;
+                for (int t : pair.second) {
+                    m_slots[t].stats.smtSharedSeconds += dt;
+                }
+            }
+        }
+        if (coScheduled) {
+            m_smtSamples++;
+        }
+    }
+}
+
+std::vector<ThreadMigrationStats> MigrationMonitor::getStats() const {
+    std::vector<ThreadMigrationStats> stats;
+    const int registered = m_registered.load(std::memory_order_acquire);
+    for (int i = 0; i < registered; i++) {
+        stats.push_back(m_slots[i].stats);
+    }
+    return stats;
+}
+
+double MigrationMonitor::getSampledSeconds() const {
+    return m_sampledSeconds;
+}
+
+long long MigrationMonitor::getSmtCoScheduledSamples() const {
+    return m_smtSamples;
+}
+
+void MigrationMonitor::displayReport(const std::string& label) const {
+    std::vector<ThreadMigrationStats> stats = getStats();
+
+    std::cout << "\n=== " << label << " ===" << std::endl;
+    std::cout << "Sampled " << std::fixed << std::setprecision(3) << m_sampledSeconds << " s every "
+              << m_interval.count() << " us (" << (samplesFromOs() ? "from /proc" : "from checkpoints")
+              << ")" << std::endl;
+
+    std::cout << std::setw(6) << "Slot" << std::setw(6) << "OMP" << std::setw(6) << "Home"
+              << std::setw(8) << "Pinned" << std::setw(10) << "Samples" << std::setw(12) << "Migrations"
+              << std::setw(15) << "Off-place(ms)" << std::setw(15) << "SMT-shared(ms)" << "  CPUs seen" << std::endl;
+    std::cout << std::string(90, '-') << std::endl;
+
+    long long totalMigrations = 0;
+    for (size_t i = 0; i < stats.size(); i++) {
+        const ThreadMigrationStats& s = stats[i];
+        totalMigrations += s.migrations;
+
+        std::ostringstream seen;
+        for (size_t p = 0; p < s.processorsSeen.size(); p++) {
+            seen << (p > 0 ? "," : "") << s.processorsSeen[p];
+        }
+
+        std::cout << std::setw(6) << i << std::setw(6) << s.ompThreadNum << std::setw(6) << s.homeProcessor
+                  << std::setw(8) << (s.pinned ? "yes" : "no") << std::setw(10) << s.samples
+                  << std::setw(12) << s.migrations
+                  << std::setw(15) << std::setprecision(1) << s.offPlaceSeconds * 1000.0
+                  << std::setw(15) << s.smtSharedSeconds * 1000.0 << "  " << seen.str() << std::endl;
+    }
+
+    std::cout << "Total migrations: " << totalMigrations << std::endl;
+    std::cout << "Samples with SMT siblings co-scheduled: " << m_smtSamples;
+    if (m_samplesTaken > 0) {
+        std::cout << " of " << m_samplesTaken << " (" << std::setprecision(1)
+                  << 100.0 * m_smtSamples / m_samplesTaken << "%)";
+    }
+    std::cout << std::endl;
+}
@@ -8,6 +8,9 @@
 #ifdef _WIN32
 #include <windows.h>
 #include <processthreadsapi.h>
+#else
+#include <sched.h>
+#include <pthread.h>
 #endif
 
 int GetThreadCoreID() {
@@ -17,8 +20,9 @@ int GetThreadCoreID() {
     
     // Get processor number where this thread is running
     return GetCurrentProcessorNumber();
+#elif defined(__linux__)
+    return sched_getcpu();
 #else
-    // For non-Windows platforms, return -1
     return -1;
 #endif
 }
@@ -35,8 +39,9 @@ bool SetThreadAffinity(int coreId) {
     DWORD_PTR prevMask = SetThreadAffinityMask(hThread, mask);
     
     return (prevMask != 0);
+#elif defined(__linux__)
+    return SetThreadAffinityMask(std::vector<int>{coreId});
 #else
-    // For non-Windows platforms, return false
     return false;
 #endif
 }
@@ -56,8 +61,21 @@ bool SetThreadAffinityMask(const std::vector<int>& coreIds) {
     DWORD_PTR prevMask = SetThreadAffinityMask(hThread, mask);
     
     return (prevMask != 0);
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int coreId : coreIds) {
+        if (coreId >= 0 && coreId < CPU_SETSIZE) {
+            CPU_SET(coreId, &set);
+        }
+    }
+    if (CPU_COUNT(&set) == 0) {
+        return false;
+    }
+    
+    // Applies to the calling thread only
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
 #else
-    // For non-Windows platforms, return false
     return false;
 #endif
 }
@@ -89,6 +107,16 @@ std::vector<int> GetThreadAffinityMask() {
             }
         }
     }
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+        for (int i = 0; i < CPU_SETSIZE; i++) {
+            if (CPU_ISSET(i, &set)) {
+                result.push_back(i);
+            }
+        }
+    }
 #endif
 
     return result;
@@ -31,4 +31,52 @@ void generateAnnotatedAsm(const std::string& inputFile, const std::string& outpu
 // Display assembly statistics
 void displayAsmStatistics(const std::vector<AsmInstruction>& instructions);
 
+// Microarchitectures with a built-in latency/throughput table (asm_throughput.cpp)
+enum class MicroArch {
+    Skylake,    // Intel Skylake/Cascade Lake: 4-wide, 2 FMA pipes
+    IceLake,    // Intel Ice Lake/Sapphire Rapids: 5-wide, 2 load + 2 store ports
+    Zen4        // AMD Zen 4: 6-wide, 512-bit ops split into two 256-bit halves
+};
+
+const char* microArchName(MicroArch arch);
+
+// Pick the table closest to the CPU we run on (vendor and AVX-512 support)
+MicroArch detectMicroArch();
+
+// Static estimate for one innermost loop (a backward branch to a label), in the
+// spirit of llvm-mca: the cycles per iteration are the largest of the front-end
+// issue bound, the busiest execution resource and the longest loop-carried
+// dependency chain. No cache misses or branch mispredictions are modelled.
+struct LoopEstimate {
+    std::string function;       // Nearest enclosing function label
+    std::string label;          // Branch target that starts the body
+    size_t firstInstruction;    // Body range in the parsed instruction list
+    size_t lastInstruction;
+    int instructionCount;
+    int vectorBits;             // Widest packed SIMD register in the body, 0 if none
+    bool scalarFloatingPoint;   // FP arithmetic only in scalar (ss/sd) form
+    int elementsPerIteration;   // Lanes times vector stores (or accumulators)
+    double frontEndCycles;
+    double resourceCycles;
+    double recurrenceCycles;
+    double cyclesPerIteration;
+    std::string bottleneck;     // Resource or chain that sets cyclesPerIteration
+    std::string widthWarning;   // Set when wider vectors were available
+    int floatingPointOps;       // FP arithmetic instructions, used to rank loops
+
+    double cyclesPerElement() const {
+        return elementsPerIteration > 0 ? cyclesPerIteration / elementsPerIteration : cyclesPerIteration;
+    }
+};
+
+// Find the innermost loops of a parsed file and estimate each one
+std::vector<LoopEstimate> estimateLoopThroughput(const std::vector<AsmInstruction>& instructions, MicroArch arch);
+
+// Table of loop estimates, hottest (most FP work) first
+void displayLoopEstimates(const std::vector<LoopEstimate>& loops, MicroArch arch);
+
+// Loop with the most floating-point work (within function, if given and present),
+// or nullptr if there are no loops
+const LoopEstimate* findHotLoop(const std::vector<LoopEstimate>& loops, const std::string& function = "");
+
 #endif // ASM_ANALYZER_H
\ No newline at end of file
@@ -13,6 +13,14 @@ struct BenchmarkResult {
     double timeVectorized; // Time in milliseconds for vectorized version
     double speedup;       // Computed speedup
     bool verified;        // Result verification status
+
+    // Work of one vectorized run, for the roofline report. Bytes count the data
+    // the kernel must read and write (no write-allocate traffic); zero FLOPs
+    // leaves the benchmark off the roofline.
+    double flops = 0.0;
+    double bytes = 0.0;
+    bool doublePrecision = false;  // Compare against the FP64 or the FP32 ceiling
+    int threads = 1;               // >1 uses the all-core ceilings
 };
 
 // Benchmark function for performance measurement
@@ -26,7 +34,17 @@ BenchmarkResult benchmarkAlignedAccess(size_t vectorSize);
 BenchmarkResult benchmarkMixedPrecision(size_t vectorSize);
 BenchmarkResult benchmarkSIMDParallelism(size_t vectorSize, int numThreads);
 
+// Time the dispatched kernels of every SIMD level this CPU supports
+void benchmarkKernelVariants(size_t vectorSize);
+
+// Sweep working sets around the last-level cache size, regular vs streaming stores
+void benchmarkStreamingStores();
+
+// std::complex arrays vs split real/imag arrays for multiply, add, magnitude and FFT
+void benchmarkComplexLayouts();
+
 // Utility functions for benchmarking
+// Median milliseconds of func under the shared repetition policy (bench_core.h, BENCH_* variables)
 double measureExecutionTime(std::function<void()> func);
 void displayBenchmarkResults(const std::vector<BenchmarkResult>& results);
 void generatePerformanceReport(const std::vector<BenchmarkResult>& results, const std::string& filename);
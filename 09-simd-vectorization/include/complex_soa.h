@@ -0,0 +1,50 @@
+#ifndef COMPLEX_SOA_H
+#define COMPLEX_SOA_H
+
+#include <complex>
+#include <cstddef>
+#include "aligned_allocator.h"
+
+// Split (structure-of-arrays) complex storage: real and imaginary parts in separate
+// aligned arrays, so a complex multiply is four multiplies and two adds per lane
+// with no shuffles. std::complex arrays interleave re/im (array-of-structures) and
+// need permutes to separate them inside vector registers.
+struct ComplexSoA {
+    AlignedVector<double> re;
+    AlignedVector<double> im;
+
+    ComplexSoA() = default;
+    explicit ComplexSoA(size_t size) : re(size), im(size) {}
+
+    size_t size() const { return re.size(); }
+    void resize(size_t size) {
+        re.resize(size);
+        im.resize(size);
+    }
+};
+
+using ComplexAoS = AlignedVector<std::complex<double>>;
+
+// Layout conversion
+void aosToSoA(const ComplexAoS& input, ComplexSoA& output);
+void soaToAoS(const ComplexSoA& input, ComplexAoS& output);
+
+// SoA kernels; output arrays must already have the input size
+void complexMultiplySoA(const ComplexSoA& a, const ComplexSoA& b, ComplexSoA& c);
+void complexAddSoA(const ComplexSoA& a, const ComplexSoA& b, ComplexSoA& c);
+void complexMagnitudeSoA(const ComplexSoA& a, AlignedVector<double>& magnitude);
+
+// One radix-2 butterfly group: for k < half, t = w[k] * x[half + k],
+// x[half + k] = x[k] - t, x[k] = x[k] + t
+void fftButterflySoA(double* re, double* im, const double* twiddleRe, const double* twiddleIm, size_t half);
+
+// In-place forward FFT (size must be a power of two)
+void fftSoA(ComplexSoA& data);
+
+// std::complex<double> reference versions of the same kernels
+void complexMultiplyAoS(const ComplexAoS& a, const ComplexAoS& b, ComplexAoS& c);
+void complexAddAoS(const ComplexAoS& a, const ComplexAoS& b, ComplexAoS& c);
+void complexMagnitudeAoS(const ComplexAoS& a, AlignedVector<double>& magnitude);
+void fftAoS(ComplexAoS& data);
+
+#endif // COMPLEX_SOA_H
@@ -1,10 +1,13 @@
 #ifndef CPU_FEATURES_H
 #define CPU_FEATURES_H
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
-// CPU feature detection structure
+// CPU feature detection structure. AVX, AVX2, FMA, F16C and the AVX-512 flags are only
+// reported when the OS also saves the wider registers (XGETBV), so a set flag
+// means the instructions can actually be executed.
 struct CPUFeatures {
     bool hasSSE;
     bool hasSSE2;
@@ -15,7 +18,11 @@ struct CPUFeatures {
     bool hasAVX;
     bool hasAVX2;
     bool hasAVX512F;
+    bool hasFMA;
+    bool hasF16C;        // Half-precision conversions (vcvtph2ps/vcvtps2ph)
+    bool hasAVX512BF16;  // bfloat16 dot products (vdpbf16ps)
     int maxSIMDWidth;
+    size_t lastLevelCacheBytes;  // Largest cache reported by CPUID (or the OS); 0 if unknown
     std::string cpuVendor;
     std::string cpuBrand;
 };
@@ -29,6 +36,9 @@ void displayCPUFeatures();
 // Get optimal SIMD width based on CPU capabilities
 int getOptimalSIMDWidth();
 
+// Last-level cache size in bytes, falling back to 8 MB when it cannot be detected
+size_t getLastLevelCacheSize();
+
 // Get CPU features structure
 CPUFeatures& getCPUFeatures();
 
@@ -0,0 +1,37 @@
+#ifndef REDUCED_PRECISION_H
+#define REDUCED_PRECISION_H
+
+#include <cstddef>
+#include <cstdint>
+#include "aligned_allocator.h"
+
+// Reduced-precision storage formats. Values are stored as raw bit patterns and
+// widened to FP32 on load by the dot kernels in the SIMD kernel table, so memory
+// traffic shrinks while the arithmetic stays in FP32.
+//   FP16 (IEEE binary16): 1 sign, 5 exponent, 10 mantissa bits; range +-65504
+//   BF16 (bfloat16):      1 sign, 8 exponent, 7 mantissa bits; FP32 range
+//   INT8 (block scaled):  int8 values with one FP32 scale per block
+
+// Round-to-nearest-even conversions
+uint16_t floatToHalf(float value);
+float halfToFloat(uint16_t half);
+uint16_t floatToBFloat16(float value);
+float bfloat16ToFloat(uint16_t value);
+
+void floatsToHalf(const float* input, uint16_t* output, size_t size);
+void floatsToBFloat16(const float* input, uint16_t* output, size_t size);
+
+// Block quantization used by dotInt8Blocks: each block of blockSize values gets
+// scale = max|x| / 127 and values round(x / scale)
+constexpr size_t INT8_BLOCK_SIZE = 32;
+
+struct Int8Blocks {
+    AlignedVector<int8_t> values;
+    AlignedVector<float> scales;
+    size_t blockSize = INT8_BLOCK_SIZE;
+};
+
+// input size must be a multiple of blockSize
+void quantizeInt8Blocks(const float* input, size_t size, size_t blockSize, Int8Blocks& output);
+
+#endif // REDUCED_PRECISION_H
@@ -0,0 +1,48 @@
+#ifndef ROOFLINE_H
+#define ROOFLINE_H
+
+#include <string>
+#include <vector>
+#include "benchmark_suite.h"
+
+// Machine ceilings for the roofline model, measured with the dispatched kernels:
+// peak FLOP/s from register-only FMA chains, bandwidth from a STREAM triad
+// (a[i] = b[i] + s * c[i]) over arrays larger than the last-level cache.
+struct MachinePeaks {
+    double gflopsFloat;        // One thread
+    double gflopsDouble;
+    double bandwidthGBs;
+    double gflopsFloatAll;     // All OpenMP threads
+    double gflopsDoubleAll;
+    double bandwidthGBsAll;
+    int threads;
+    std::string kernelName;    // Kernel table the peaks were measured with
+};
+
+// Measured on the first call (about a second), cached afterwards
+const MachinePeaks& getMachinePeaks();
+void displayMachinePeaks(const MachinePeaks& peaks);
+
+// FLOPs per byte of a benchmark, 0 when it has no counts
+double arithmeticIntensity(const BenchmarkResult& result);
+
+// Achieved GFLOP/s of the vectorized run
+double achievedGflops(const BenchmarkResult& result);
+
+// min(peak, intensity * bandwidth) with the ceilings matching the benchmark's
+// precision and thread count
+double attainableGflops(const BenchmarkResult& result, const MachinePeaks& peaks);
+
+// True when the benchmark sits left of the ridge point (peak / bandwidth)
+bool isMemoryBound(const BenchmarkResult& result, const MachinePeaks& peaks);
+
+// Console table: intensity, achieved vs attainable, bound and advice
+void displayRoofline(const std::vector<BenchmarkResult>& results, const MachinePeaks& peaks);
+
+// One row per benchmark plus the ceilings, for spreadsheets and plotting scripts
+void writeRooflineCSV(const std::vector<BenchmarkResult>& results, const MachinePeaks& peaks, const std::string& filename);
+
+// Standalone page with a log-log SVG roofline and the same table
+void writeRooflineHTML(const std::vector<BenchmarkResult>& results, const MachinePeaks& peaks, const std::string& filename);
+
+#endif // ROOFLINE_H
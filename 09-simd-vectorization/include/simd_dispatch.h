@@ -0,0 +1,86 @@
+#ifndef SIMD_DISPATCH_H
+#define SIMD_DISPATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Instruction sets the kernels are built for. Each level is compiled in its own
+// translation unit with the matching target flags (see CMakeLists.txt).
+enum class SIMDLevel {
+    SSE2,
+    AVX2,
+    AVX512
+};
+
+// One per-ISA build of every dispatched kernel
+struct SIMDKernelTable {
+    SIMDLevel level;
+    const char* name;     // "SSE2", "AVX2" or "AVX-512"
+    int registerBits;     // 128, 256 or 512
+
+    // c[i] = a[i] + b[i]
+    void (*addDouble)(const double* a, const double* b, double* c, size_t size);
+
+    // c[i] = a[i] * b[i]
+    void (*multiplyFloat)(const float* a, const float* b, float* c, size_t size);
+
+    // Sum of a[0..size)
+    float (*reduceFloat)(const float* a, size_t size);
+
+    // c[i] = a[i] * b[i] + a[i] / (b[i] + 0.01f), the SIMD width demo kernel
+    void (*widthOperation)(const float* a, const float* b, float* c, size_t size);
+
+    // widthOperation with 4, 8 or 16 lanes per step fixed at compile time and the
+    // remainder done with masked vector operations instead of a scalar loop
+    void (*widthOperationLanes[3])(const float* a, const float* b, float* c, size_t size);
+
+    // addDouble and multiplyFloat with non-temporal stores to c
+    void (*addDoubleStream)(const double* a, const double* b, double* c, size_t size);
+    void (*multiplyFloatStream)(const float* a, const float* b, float* c, size_t size);
+
+    // Dot products over reduced-precision storage, all accumulated in FP32.
+    // Halves are IEEE binary16 and bfloat16 values are raw bit patterns.
+    float (*dotFloat)(const float* a, const float* b, size_t size);
+    float (*dotHalf)(const uint16_t* a, const uint16_t* b, size_t size);
+    float (*dotBFloat16)(const uint16_t* a, const uint16_t* b, size_t size);
+
+    // Block-quantized int8: size is a multiple of blockSize, one scale per block
+    float (*dotInt8Blocks)(const int8_t* a, const float* aScales, const int8_t* b, const float* bScales,
+                           size_t size, size_t blockSize);
+
+    // Register-only multiply-add loops for measuring peak FLOP/s; flops receives
+    // the number of floating-point operations performed
+    float (*peakFlopsFloat)(size_t iterations, double& flops);
+    double (*peakFlopsDouble)(size_t iterations, double& flops);
+};
+
+// bfloat16 dot product: vdpbf16ps when the CPU has AVX512-BF16 and the compiler
+// could build it, otherwise getSIMDKernels().dotBFloat16. name receives "AVX512-BF16"
+// or the table's name.
+using BFloat16DotFunction = float (*)(const uint16_t* a, const uint16_t* b, size_t size);
+BFloat16DotFunction getBFloat16Dot(const char** name = nullptr);
+
+// Kernel table for the widest level this CPU and OS support. Selected once from
+// getCPUFeatures() on first use; call detectCPUFeatures() before that.
+const SIMDKernelTable& getSIMDKernels();
+
+// Kernel table for a specific level, or nullptr if the CPU cannot run it
+const SIMDKernelTable* getSIMDKernelsFor(SIMDLevel level);
+
+// All levels the CPU can run, narrowest first
+std::vector<const SIMDKernelTable*> getSupportedSIMDKernels();
+
+// True if a kernel touching workingSetBytes should use the streaming variants:
+// the data exceeds the last-level cache, so the output would be evicted anyway
+bool useStreamingStores(size_t workingSetBytes);
+
+// Level whose registers match a width in bits (128, 256, 512)
+SIMDLevel simdLevelForWidth(int registerBits);
+
+// Index into SIMDKernelTable::widthOperationLanes for 4, 8 or 16 lanes
+constexpr int widthLanesIndex(int lanes) {
+    return lanes >= 16 ? 2 : (lanes >= 8 ? 1 : 0);
+}
+
+#endif // SIMD_DISPATCH_H
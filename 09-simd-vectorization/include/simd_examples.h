@@ -2,19 +2,21 @@
 #define SIMD_EXAMPLES_H
 
 #include <vector>
+#include <cstddef>
+#include "aligned_allocator.h"
 
 // Basic SIMD operations
 void runBasicSIMD();
-double basicVectorAddition(const std::vector<double>& a, const std::vector<double>& b, std::vector<double>& c, bool useSimd);
+double basicVectorAddition(const AlignedVector<double>& a, const AlignedVector<double>& b, AlignedVector<double>& c, bool useSimd);
 
 // Array operations with SIMD
 void runArrayOperations();
-void arrayElementWiseMultiply(const std::vector<float>& a, const std::vector<float>& b, std::vector<float>& c, bool useSimd);
-float arrayReduction(const std::vector<float>& a, bool useSimd);
+void arrayElementWiseMultiply(const AlignedVector<float>& a, const AlignedVector<float>& b, AlignedVector<float>& c, bool useSimd);
+float arrayReduction(const AlignedVector<float>& a, bool useSimd);
 
 // Complex math operations
 void runComplexMath();
-void computeTranscendental(std::vector<double>& input, std::vector<double>& output, bool useSimd);
+void computeTranscendental(AlignedVector<double>& input, AlignedVector<double>& output, bool useSimd);
 
 // SIMD and memory alignment
 void runSIMDAlignment();
@@ -23,14 +25,16 @@ void alignedVsUnaligned(bool useAligned);
 // SIMD width adaptation
 void runSIMDWidth();
 void vectorizeWithDifferentWidths(int simdWidth);
+void benchmarkOddSizes();
 
 // Mixed precision operations
 void runMixedPrecision();
-void mixedTypeOperations(std::vector<float>& floatVec, std::vector<int>& intVec, std::vector<float>& result, bool useSimd);
+void mixedTypeOperations(AlignedVector<float>& floatVec, AlignedVector<int>& intVec, AlignedVector<float>& result, bool useSimd);
 
 // SIMD with thread parallelism
 void runSIMDParallelism();
 void simdWithThreads(int numThreads, size_t vectorSize);
+void compareKernelFusion(size_t vectorSize);
 
 // Assembly analysis
 void runASMAnalysis();
@@ -0,0 +1,489 @@
+// Kernel bodies shared by the per-ISA translation units.
+//
+// Deliberately has no include guard: simd_kernels_sse2.cpp, simd_kernels_avx2.cpp
+// and simd_kernels_avx512.cpp each define SIMD_KERNEL_NAMESPACE and include this
+// file once, and the compiler flags of that unit decide which instructions the
+// omp simd loops below are turned into.
+//
+// Keep these units free of calls into inline library code (std::vector members,
+// <cmath> helpers, ...): the linker keeps one copy of each inline function, and
+// it could be the AVX-512 one, which would then run on every CPU.
+
+#ifndef SIMD_KERNEL_NAMESPACE
+#error "Define SIMD_KERNEL_NAMESPACE before including simd_kernel_bodies.h"
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Vector type and intrinsics for the streaming and peak-throughput kernels, picked
+// from the ISA this unit is compiled for (MSVC on x64 implies SSE2 without defining
+// __SSE2__). SSE2 has no FMA, so there a multiply-add is two instructions.
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#define SIMD_VEC_BYTES 64
+#define SIMD_VEC_VD __m512d
+#define SIMD_VEC_VF __m512
+#define SIMD_VEC_LOADU_PD _mm512_loadu_pd
+#define SIMD_VEC_LOADU_PS _mm512_loadu_ps
+#define SIMD_VEC_ADD_PD _mm512_add_pd
+#define SIMD_VEC_MUL_PS _mm512_mul_ps
+#define SIMD_VEC_STORE_PD _mm512_stream_pd
+#define SIMD_VEC_STORE_PS _mm512_stream_ps
+#define SIMD_VEC_SET1_PS _mm512_set1_ps
+#define SIMD_VEC_SET1_PD _mm512_set1_pd
+#define SIMD_VEC_ADD_PS _mm512_add_ps
+#define SIMD_VEC_FMADD_PS _mm512_fmadd_ps
+#define SIMD_VEC_FMADD_PD _mm512_fmadd_pd
+#define SIMD_VEC_STOREU_PS _mm512_storeu_ps
+#define SIMD_VEC_STOREU_PD _mm512_storeu_pd
+#elif defined(__AVX__)
+#include <immintrin.h>
+#define SIMD_VEC_BYTES 32
+#define SIMD_VEC_VD __m256d
+#define SIMD_VEC_VF __m256
+#define SIMD_VEC_LOADU_PD _mm256_loadu_pd
+#define SIMD_VEC_LOADU_PS _mm256_loadu_ps
+#define SIMD_VEC_ADD_PD _mm256_add_pd
+#define SIMD_VEC_MUL_PS _mm256_mul_ps
+#define SIMD_VEC_STORE_PD _mm256_stream_pd
+#define SIMD_VEC_STORE_PS _mm256_stream_ps
+#define SIMD_VEC_SET1_PS _mm256_set1_ps
+#define SIMD_VEC_SET1_PD _mm256_set1_pd
+#define SIMD_VEC_ADD_PS _mm256_add_ps
+#if defined(__FMA__) || defined(__AVX2__)
+#define SIMD_VEC_FMADD_PS _mm256_fmadd_ps
+#define SIMD_VEC_FMADD_PD _mm256_fmadd_pd
+#else
+#define SIMD_VEC_FMADD_PS(a, b, c) _mm256_add_ps(_mm256_mul_ps(a, b), c)
+#define SIMD_VEC_FMADD_PD(a, b, c) _mm256_add_pd(_mm256_mul_pd(a, b), c)
+#endif
+#define SIMD_VEC_STOREU_PS _mm256_storeu_ps
+#define SIMD_VEC_STOREU_PD _mm256_storeu_pd
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SIMD_VEC_BYTES 16
+#define SIMD_VEC_VD __m128d
+#define SIMD_VEC_VF __m128
+#define SIMD_VEC_LOADU_PD _mm_loadu_pd
+#define SIMD_VEC_LOADU_PS _mm_loadu_ps
+#define SIMD_VEC_ADD_PD _mm_add_pd
+#define SIMD_VEC_MUL_PS _mm_mul_ps
+#define SIMD_VEC_STORE_PD _mm_stream_pd
+#define SIMD_VEC_STORE_PS _mm_stream_ps
+#define SIMD_VEC_SET1_PS _mm_set1_ps
+#define SIMD_VEC_SET1_PD _mm_set1_pd
+#define SIMD_VEC_ADD_PS _mm_add_ps
+#define SIMD_VEC_FMADD_PS(a, b, c) _mm_add_ps(_mm_mul_ps(a, b), c)
+#define SIMD_VEC_FMADD_PD(a, b, c) _mm_add_pd(_mm_mul_pd(a, b), c)
+#define SIMD_VEC_STOREU_PS _mm_storeu_ps
+#define SIMD_VEC_STOREU_PD _mm_storeu_pd
+#endif
+
+namespace SIMD_KERNEL_NAMESPACE {
+
+void addDouble(const double* __restrict a, const double* __restrict b, double* __restrict c, size_t size) {
+    const long long n = static_cast<long long>(size);
+    #pragma omp simd
+    for (long long i = 0; i < n; ++i) {
+        c[i] = a[i] + b[i];
+    }
+}
+
+void multiplyFloat(const float* __restrict a, const float* __restrict b, float* __restrict c, size_t size) {
+    const long long n = static_cast<long long>(size);
+    #pragma omp simd
+    for (long long i = 0; i < n; ++i) {
+        c[i] = a[i] * b[i];
+    }
+}
+
+float reduceFloat(const float* __restrict a, size_t size) {
+    const long long n = static_cast<long long>(size);
+    float sum = 0.0f;
+    #pragma omp simd reduction(+:sum)
+    for (long long i = 0; i < n; ++i) {
+        sum += a[i];
+    }
+    return sum;
+}
+
+void widthOperation(const float* __restrict a, const float* __restrict b, float* __restrict c, size_t size) {
+    const long long n = static_cast<long long>(size);
+    #pragma omp simd
+    for (long long i = 0; i < n; ++i) {
+        c[i] = a[i] * b[i] + a[i] / (b[i] + 0.01f);
+    }
+}
+
+// Last count (< 16) elements of the width demo kernel as masked vector steps, so
+// short and odd-length inputs never drop into a scalar loop. Masked-off lanes load
+// zero, which keeps b + 0.01f away from a division by zero.
+static void widthOperationMaskedTail(const float* __restrict a, const float* __restrict b, float* __restrict c, size_t count) {
+#if defined(__AVX512F__)
+    const __mmask16 mask = static_cast<__mmask16>((1u << count) - 1u);
+    const __m512 va = _mm512_maskz_loadu_ps(mask, a);
+    const __m512 vb = _mm512_maskz_loadu_ps(mask, b);
+    const __m512 quotient = _mm512_div_ps(va, _mm512_add_ps(vb, _mm512_set1_ps(0.01f)));
+    _mm512_mask_storeu_ps(c, mask, _mm512_add_ps(_mm512_mul_ps(va, vb), quotient));
+#elif defined(__AVX2__)
+    const __m256i laneIndex = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    for (size_t offset = 0; offset < count; offset += 8) {
+        const int remaining = static_cast<int>(count - offset);
+        const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(remaining), laneIndex);
+        const __m256 va = _mm256_maskload_ps(a + offset, mask);
+        const __m256 vb = _mm256_maskload_ps(b + offset, mask);
+        const __m256 quotient = _mm256_div_ps(va, _mm256_add_ps(vb, _mm256_set1_ps(0.01f)));
+        _mm256_maskstore_ps(c + offset, mask, _mm256_add_ps(_mm256_mul_ps(va, vb), quotient));
+    }
+#elif defined(SIMD_VEC_BYTES)
+    // SSE2 has no masked loads: whole 4-lane steps first, then one step on zero-padded copies
+    const __m128 offset = _mm_set1_ps(0.01f);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 va = _mm_loadu_ps(a + i);
+        const __m128 vb = _mm_loadu_ps(b + i);
+        _mm_storeu_ps(c + i, _mm_add_ps(_mm_mul_ps(va, vb), _mm_div_ps(va, _mm_add_ps(vb, offset))));
+    }
+    if (i < count) {
+        // Build the padded step in registers; storing lanes to a buffer and reloading
+        // it as a vector would stall on store forwarding
+        const size_t rest = count - i;
+        const __m128 va = _mm_setr_ps(a[i], rest > 1 ? a[i + 1] : 0.0f, rest > 2 ? a[i + 2] : 0.0f, 0.0f);
+        const __m128 vb = _mm_setr_ps(b[i], rest > 1 ? b[i + 1] : 0.0f, rest > 2 ? b[i + 2] : 0.0f, 0.0f);
+        float pc[4];
+        _mm_storeu_ps(pc, _mm_add_ps(_mm_mul_ps(va, vb), _mm_div_ps(va, _mm_add_ps(vb, offset))));
+        for (size_t k = 0; k < rest; ++k) {
+            c[i + k] = pc[k];
+        }
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        c[i] = a[i] * b[i] + a[i] / (b[i] + 0.01f);
+    }
+#endif
+}
+
+// Width demo kernel with the lane count fixed at compile time: Lanes elements per
+// step, an inner loop the compiler fully unrolls into Lanes / register-lanes
+// vectors, and the remainder handled by widthOperationMaskedTail
+template<int Lanes>
+static void widthOperationLanes(const float* __restrict a, const float* __restrict b, float* __restrict c, size_t size) {
+    static_assert(Lanes == 4 || Lanes == 8 || Lanes == 16, "Lanes must be 4, 8 or 16");
+    const size_t mainSize = size - size % Lanes;
+    for (size_t i = 0; i < mainSize; i += Lanes) {
+        #pragma omp simd
+        for (int k = 0; k < Lanes; ++k) {
+            c[i + k] = a[i + k] * b[i + k] + a[i + k] / (b[i + k] + 0.01f);
+        }
+    }
+    if (mainSize < size) {
+        widthOperationMaskedTail(a + mainSize, b + mainSize, c + mainSize, size - mainSize);
+    }
+}
+
+// FP32 dot product, the baseline for the reduced-precision kernels below
+float dotFloat(const float* __restrict a, const float* __restrict b, size_t size) {
+    const long long n = static_cast<long long>(size);
+    float sum = 0.0f;
+    #pragma omp simd reduction(+:sum)
+    for (long long i = 0; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+// IEEE half to float without a branch: shifting the exponent/mantissa into place and
+// scaling by 2^112 rebiases normals and normalizes subnormals in one multiply
+static inline float halfBitsToFloat(uint16_t half) {
+    uint32_t magnitude = static_cast<uint32_t>(half & 0x7fff) << 13;
+    float scaled;
+    std::memcpy(&scaled, &magnitude, sizeof(scaled));
+    scaled *= 5.192296858534828e+33f;  // 2^112
+    uint32_t bits;
+    std::memcpy(&bits, &scaled, sizeof(bits));
+    bits |= (half & 0x7c00) == 0x7c00 ? 0x7f800000u : 0u;  // Inf and NaN
+    bits |= static_cast<uint32_t>(half & 0x8000) << 16;
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Dot product of FP16 vectors with FP32 math: F16C (vcvtph2ps) converts on load where
+// this unit's ISA has it, otherwise the bit conversion above
+float dotHalf(const uint16_t* __restrict a, const uint16_t* __restrict b, size_t size) {
+    size_t i = 0;
+    float sum = 0.0f;
+#if defined(__AVX512F__)
+    __m512 acc = _mm512_setzero_ps();
+    for (; i + 16 <= size; i += 16) {
+        __m512 va = _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)));
+        __m512 vb = _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+        acc = _mm512_fmadd_ps(va, vb, acc);
+    }
+    sum = _mm512_reduce_add_ps(acc);
+#elif defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+    __m256 acc = _mm256_setzero_ps();
+    for (; i + 8 <= size; i += 8) {
+        __m256 va = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+        __m256 vb = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        acc = _mm256_fmadd_ps(va, vb, acc);
+    }
+    __m128 half4 = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    half4 = _mm_add_ps(half4, _mm_movehl_ps(half4, half4));
+    half4 = _mm_add_ss(half4, _mm_shuffle_ps(half4, half4, 1));
+    sum = _mm_cvtss_f32(half4);
+#endif
+    const long long n = static_cast<long long>(size);
+    #pragma omp simd reduction(+:sum)
+    for (long long j = static_cast<long long>(i); j < n; ++j) {
+        sum += halfBitsToFloat(a[j]) * halfBitsToFloat(b[j]);
+    }
+    return sum;
+}
+
+// Dot product of bfloat16 vectors with FP32 math; bfloat16 is the top half of a
+// float, so the conversion is a 16-bit shift that vectorizes on every ISA
+float dotBFloat16(const uint16_t* __restrict a, const uint16_t* __restrict b, size_t size) {
+    const long long n = static_cast<long long>(size);
+    float sum = 0.0f;
+    #pragma omp simd reduction(+:sum)
+    for (long long i = 0; i < n; ++i) {
+        uint32_t aBits = static_cast<uint32_t>(a[i]) << 16;
+        uint32_t bBits = static_cast<uint32_t>(b[i]) << 16;
+        float aValue;
+        float bValue;
+        std::memcpy(&aValue, &aBits, sizeof(aValue));
+        std::memcpy(&bValue, &bBits, sizeof(bValue));
+        sum += aValue * bValue;
+    }
+    return sum;
+}
+
+// Dot product of int8 vectors quantized in blocks of blockSize values, each block
+// with its own scale: sum over blocks of scaleA * scaleB * (integer dot of the block)
+float dotInt8Blocks(const int8_t* __restrict a, const float* __restrict aScales,
+                    const int8_t* __restrict b, const float* __restrict bScales,
+                    size_t size, size_t blockSize) {
+    const size_t blocks = size / blockSize;
+    size_t block = 0;
+    float sum = 0.0f;
+#if defined(__AVX2__)
+    if (blockSize == 32) {
+        // One 32-byte block per register. vpmaddubsw needs an unsigned operand, so
+        // multiply |a| by b with a's sign moved onto it (values are within +-127,
+        // so the int16 pair sums cannot saturate), then widen pairs to int32.
+        // The block sums stay in vector lanes and are scaled with one FMA each.
+        const __m256i ones = _mm256_set1_epi16(1);
+        __m256 acc = _mm256_setzero_ps();
+        for (; block < blocks; ++block) {
+            __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + block * 32));
+            __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + block * 32));
+            __m256i pairs = _mm256_maddubs_epi16(_mm256_sign_epi8(va, va), _mm256_sign_epi8(vb, va));
+            __m256 partial = _mm256_cvtepi32_ps(_mm256_madd_epi16(pairs, ones));
+            acc = _mm256_fmadd_ps(_mm256_set1_ps(aScales[block] * bScales[block]), partial, acc);
+        }
+        __m128 quad = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+        quad = _mm_add_ps(quad, _mm_movehl_ps(quad, quad));
+        quad = _mm_add_ss(quad, _mm_shuffle_ps(quad, quad, 1));
+        sum = _mm_cvtss_f32(quad);
+    }
+#endif
+    const long long n = static_cast<long long>(blockSize);
+    for (; block < blocks; ++block) {
+        const int8_t* blockA = a + block * blockSize;
+        const int8_t* blockB = b + block * blockSize;
+        int blockSum = 0;
+        #pragma omp simd reduction(+:blockSum)
+        for (long long i = 0; i < n; ++i) {
+            blockSum += static_cast<int>(blockA[i]) * static_cast<int>(blockB[i]);
+        }
+        sum += aScales[block] * bScales[block] * static_cast<float>(blockSum);
+    }
+    return sum;
+}
+
+// Streaming (non-temporal) variants: the output bypasses the caches, so lines of
+// c are not read for ownership first. Only worth it when c is not reused soon,
+// i.e. when the arrays do not fit in the last-level cache.
+#ifdef SIMD_VEC_BYTES
+
+void addDoubleStream(const double* __restrict a, const double* __restrict b, double* __restrict c, size_t size) {
+    const size_t lanes = SIMD_VEC_BYTES / sizeof(double);
+    size_t i = 0;
+    // Non-temporal stores need a register-aligned address
+    for (; i < size && (reinterpret_cast<uintptr_t>(c + i) & (SIMD_VEC_BYTES - 1)) != 0; ++i) {
+        c[i] = a[i] + b[i];
+    }
+    for (; i + lanes <= size; i += lanes) {
+        SIMD_VEC_VD sum = SIMD_VEC_ADD_PD(SIMD_VEC_LOADU_PD(a + i), SIMD_VEC_LOADU_PD(b + i));
+        SIMD_VEC_STORE_PD(c + i, sum);
+    }
+    for (; i < size; ++i) {
+        c[i] = a[i] + b[i];
+    }
+    // Streaming stores are weakly ordered; make them visible before returning
+    _mm_sfence();
+}
+
+void multiplyFloatStream(const float* __restrict a, const float* __restrict b, float* __restrict c, size_t size) {
+    const size_t lanes = SIMD_VEC_BYTES / sizeof(float);
+    size_t i = 0;
+    for (; i < size && (reinterpret_cast<uintptr_t>(c + i) & (SIMD_VEC_BYTES - 1)) != 0; ++i) {
+        c[i] = a[i] * b[i];
+    }
+    for (; i + lanes <= size; i += lanes) {
+        SIMD_VEC_VF product = SIMD_VEC_MUL_PS(SIMD_VEC_LOADU_PS(a + i), SIMD_VEC_LOADU_PS(b + i));
+        SIMD_VEC_STORE_PS(c + i, product);
+    }
+    for (; i < size; ++i) {
+        c[i] = a[i] * b[i];
+    }
+    _mm_sfence();
+}
+
+#else
+
+// No streaming stores on this target; regular stores
+void addDoubleStream(const double* __restrict a, const double* __restrict b, double* __restrict c, size_t size) {
+    addDouble(a, b, c, size);
+}
+
+void multiplyFloatStream(const float* __restrict a, const float* __restrict b, float* __restrict c, size_t size) {
+    multiplyFloat(a, b, c, size);
+}
+
+#endif
+
+// Peak arithmetic throughput: ten independent multiply-add chains per call keep
+// both FMA ports busy through the instruction latency. x = x * m + c converges to
+// c / (1 - m) = 1, so the values never overflow or turn subnormal. The result only
+// keeps the compiler from dropping the loop; flops receives the operation count.
+#define SIMD_PEAK_CHAINS 10
+#ifdef SIMD_VEC_BYTES
+
+float peakFlopsFloat(size_t iterations, double& flops) {
+    const SIMD_VEC_VF m = SIMD_VEC_SET1_PS(0.999999f);
+    const SIMD_VEC_VF c = SIMD_VEC_SET1_PS(1e-6f);
+    SIMD_VEC_VF x[SIMD_PEAK_CHAINS];
+    for (int k = 0; k < SIMD_PEAK_CHAINS; ++k) {
+        x[k] = SIMD_VEC_SET1_PS(1.0f + 0.01f * k);
+    }
+    for (size_t it = 0; it < iterations; ++it) {
+        x[0] = SIMD_VEC_FMADD_PS(x[0], m, c);
+        x[1] = SIMD_VEC_FMADD_PS(x[1], m, c);
+        x[2] = SIMD_VEC_FMADD_PS(x[2], m, c);
+        x[3] = SIMD_VEC_FMADD_PS(x[3], m, c);
+        x[4] = SIMD_VEC_FMADD_PS(x[4], m, c);
+        x[5] = SIMD_VEC_FMADD_PS(x[5], m, c);
+        x[6] = SIMD_VEC_FMADD_PS(x[6], m, c);
+        x[7] = SIMD_VEC_FMADD_PS(x[7], m, c);
+        x[8] = SIMD_VEC_FMADD_PS(x[8], m, c);
+        x[9] = SIMD_VEC_FMADD_PS(x[9], m, c);
+    }
+    for (int k = 1; k < SIMD_PEAK_CHAINS; ++k) {
+        x[0] = SIMD_VEC_ADD_PS(x[0], x[k]);
+    }
+    float lanes[SIMD_VEC_BYTES / sizeof(float)];
+    SIMD_VEC_STOREU_PS(lanes, x[0]);
+    float sum = 0.0f;
+    for (size_t i = 0; i < SIMD_VEC_BYTES / sizeof(float); ++i) {
+        sum += lanes[i];
+    }
+    flops = 2.0 * SIMD_PEAK_CHAINS * (SIMD_VEC_BYTES / sizeof(float)) * static_cast<double>(iterations);
+    return sum;
+}
+
+double peakFlopsDouble(size_t iterations, double& flops) {
+    const SIMD_VEC_VD m = SIMD_VEC_SET1_PD(0.999999);
+    const SIMD_VEC_VD c = SIMD_VEC_SET1_PD(1e-6);
+    SIMD_VEC_VD x[SIMD_PEAK_CHAINS];
+    for (int k = 0; k < SIMD_PEAK_CHAINS; ++k) {
+        x[k] = SIMD_VEC_SET1_PD(1.0 + 0.01 * k);
+    }
+    for (size_t it = 0; it < iterations; ++it) {
+        x[0] = SIMD_VEC_FMADD_PD(x[0], m, c);
+        x[1] = SIMD_VEC_FMADD_PD(x[1], m, c);
+        x[2] = SIMD_VEC_FMADD_PD(x[2], m, c);
+        x[3] = SIMD_VEC_FMADD_PD(x[3], m, c);
+        x[4] = SIMD_VEC_FMADD_PD(x[4], m, c);
+        x[5] = SIMD_VEC_FMADD_PD(x[5], m, c);
+        x[6] = SIMD_VEC_FMADD_PD(x[6], m, c);
+        x[7] = SIMD_VEC_FMADD_PD(x[7], m, c);
+        x[8] = SIMD_VEC_FMADD_PD(x[8], m, c);
+        x[9] = SIMD_VEC_FMADD_PD(x[9], m, c);
+    }
+    for (int k = 1; k < SIMD_PEAK_CHAINS; ++k) {
+        x[0] = SIMD_VEC_ADD_PD(x[0], x[k]);
+    }
+    double lanes[SIMD_VEC_BYTES / sizeof(double)];
+    SIMD_VEC_STOREU_PD(lanes, x[0]);
+    double sum = 0.0;
+    for (size_t i = 0; i < SIMD_VEC_BYTES / sizeof(double); ++i) {
+        sum += lanes[i];
+    }
+    flops = 2.0 * SIMD_PEAK_CHAINS * (SIMD_VEC_BYTES / sizeof(double)) * static_cast<double>(iterations);
+    return sum;
+}
+
+#else
+
+// No vector intrinsics on this target; scalar chains
+float peakFlopsFloat(size_t iterations, double& flops) {
+    float x[SIMD_PEAK_CHAINS];
+    for (int k = 0; k < SIMD_PEAK_CHAINS; ++k) {
+        x[k] = 1.0f + 0.01f * k;
+    }
+    for (size_t it = 0; it < iterations; ++it) {
+        for (int k = 0; k < SIMD_PEAK_CHAINS; ++k) {
+            x[k] = x[k] * 0.999999f + 1e-6f;
+        }
+    }
+    float sum = 0.0f;
+    for (float value : x) {
+        sum += value;
+    }
+    flops = 2.0 * SIMD_PEAK_CHAINS * static_cast<double>(iterations);
+    return sum;
+}
+
+double peakFlopsDouble(size_t iterations, double& flops) {
+    double x[SIMD_PEAK_CHAINS];
+    for (int k = 0; k < SIMD_PEAK_CHAINS; ++k) {
+        x[k] = 1.0 + 0.01 * k;
+    }
+    for (size_t it = 0; it < iterations; ++it) {
+        for (int k = 0; k < SIMD_PEAK_CHAINS; ++k) {
+            x[k] = x[k] * 0.999999 + 1e-6;
+        }
+    }
+    double sum = 0.0;
+    for (double value : x) {
+        sum += value;
+    }
+    flops = 2.0 * SIMD_PEAK_CHAINS * static_cast<double>(iterations);
+    return sum;
+}
+
+#endif
+#undef SIMD_PEAK_CHAINS
+
+} // namespace SIMD_KERNEL_NAMESPACE
+
+#undef SIMD_VEC_BYTES
+#undef SIMD_VEC_VD
+#undef SIMD_VEC_VF
+#undef SIMD_VEC_LOADU_PD
+#undef SIMD_VEC_LOADU_PS
+#undef SIMD_VEC_ADD_PD
+#undef SIMD_VEC_MUL_PS
+#undef SIMD_VEC_STORE_PD
+#undef SIMD_VEC_STORE_PS
+#undef SIMD_VEC_SET1_PS
+#undef SIMD_VEC_SET1_PD
+#undef SIMD_VEC_ADD_PS
+#undef SIMD_VEC_FMADD_PS
+#undef SIMD_VEC_FMADD_PD
+#undef SIMD_VEC_STOREU_PS
+#undef SIMD_VEC_STOREU_PD
@@ -0,0 +1,264 @@
+#ifndef SIMD_MATH_H
+#define SIMD_MATH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+// Branch-free double-precision sin, cos, exp, log and tanh built from range
+// reduction plus a polynomial, so that calls inside a `#pragma omp simd` loop are
+// inlined and vectorized instead of falling back to one libm call per element.
+// Special cases are handled with bit-blend selects, which vectorize as blends.
+// GCC needs AVX2 or later (-mavx2, /arch:AVX2) to vectorize them; with plain SSE2 it
+// lacks the 64-bit lane compares and the calls stay scalar (still branch-free).
+// The polynomial kernels are the fdlibm minimax ones.
+//
+// Accuracy targets, checked against a long double libm reference by
+// checkSIMDMathAccuracy() (menu option 3, or --math-accuracy):
+//
+//   Function    Domain                         Target
+//   simdSin     |x| <= 1e5                     <= 2 ULP
+//   simdCos     |x| <= 1e5                     <= 2 ULP
+//   simdExp     -708 <= x <= 709               <= 2 ULP
+//   simdLog     0 < x < inf (incl. subnormal)  <= 2 ULP
+//   simdTanh    all finite x                   <= 4 ULP
+//
+// sin/cos reduce with a three-part Cody-Waite pi/2, exact for |x| up to about
+// 1.6e6; beyond that the results lose accuracy (no Payne-Hanek reduction).
+// The targets assume strict IEEE evaluation (GCC/Clang default, MSVC /fp:precise);
+// /fp:fast may reassociate the compensated steps and loosen them.
+
+namespace simd_math_detail {
+
+inline double bitsToDouble(uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline uint64_t doubleToBits(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// 2^n for -1022 <= n <= 1023
+inline double pow2(int n) {
+    return bitsToDouble((static_cast<uint64_t>(n) + 1023) << 52);
+}
+
+// Nearest integer k of t (ties to even) as a double, with its low 32 bits in n.
+// Exact for |t| < 2^51 without a float-to-int conversion, which would stop GCC
+// from if-converting the surrounding selects.
+inline double roundToNearest(double t, int& n) {
+    const double SHIFTER = 6755399441055744.0;  // 1.5 * 2^52
+    double shifted = t + SHIFTER;
+    n = static_cast<int>(static_cast<uint32_t>(doubleToBits(shifted)));
+    return shifted - SHIFTER;
+}
+
+// cond ? a : b as a bit blend. A plain ternary lets GCC sink the arm that is not
+// always needed into a branch, which it then cannot if-convert under the default
+// -ftrapping-math, so the loop is not vectorized.
+inline double select(bool cond, double a, double b) {
+    uint64_t mask = 0 - static_cast<uint64_t>(cond);
+    return bitsToDouble((doubleToBits(a) & mask) | (doubleToBits(b) & ~mask));
+}
+
+// x with its sign flipped when negate is set
+inline double flipSign(double x, bool negate) {
+    return bitsToDouble(doubleToBits(x) ^ (static_cast<uint64_t>(negate) << 63));
+}
+
+// t if |t| < 2^30, otherwise (including inf and NaN) 0
+inline double zeroIfHuge(double t) {
+    double magnitude = bitsToDouble(doubleToBits(t) & 0x7fffffffffffffffULL);
+    return select(magnitude < 1073741824.0, t, 0.0);
+}
+
+// sin(r + tail) for |r| <= pi/4, |tail| <= ulp(r) / 2
+inline double sinKernel(double r, double tail) {
+    const double S1 = -1.66666666666666324348e-01;
+    const double S2 = 8.33333333332248946124e-03;
+    const double S3 = -1.98412698298579493134e-04;
+    const double S4 = 2.75573137070700676789e-06;
+    const double S5 = -2.50507602534068634195e-08;
+    const double S6 = 1.58969099521155010221e-10;
+    double z = r * r;
+    double v = z * r;
+    double p = S2 + z * (S3 + z * (S4 + z * (S5 + z * S6)));
+    return r - ((z * (0.5 * tail - v * p) - tail) - v * S1);
+}
+
+// cos(r + tail) for |r| <= pi/4; 1 - z/2 is split so its rounding error is added back
+inline double cosKernel(double r, double tail) {
+    const double C1 = 4.16666666666666019037e-02;
+    const double C2 = -1.38888888888741095749e-03;
+    const double C3 = 2.48015872894767294178e-05;
+    const double C4 = -2.75573143513906633035e-07;
+    const double C5 = 2.08757232129817482790e-09;
+    const double C6 = -1.13596475577881948265e-11;
+    double z = r * r;
+    double p = z * (C1 + z * (C2 + z * (C3 + z * (C4 + z * (C5 + z * C6)))));
+    double hz = 0.5 * z;
+    double w = 1.0 - hz;
+    return w + (((1.0 - w) - hz) + (z * p - r * tail));
+}
+
+// Reduce x to r + tail, r in [-pi/4, pi/4], with x = q * pi/2 + r + tail
+inline double reducePiOver2(double x, int& q, double& tail) {
+    const double TWO_OVER_PI = 6.36619772367581382433e-01;
+    // pi/2 in three 33-bit pieces: q * piece is exact for |q| < 2^20
+    const double PIO2_1 = 1.57079632673412561417e+00;
+    const double PIO2_2 = 6.07710050630396597660e-11;
+    const double PIO2_3 = 2.02226624871116645580e-21;
+
+    // Huge and NaN inputs reduce by 0; NaN still propagates through r
+    double scaled = zeroIfHuge(x * TWO_OVER_PI);
+    double k = roundToNearest(scaled, q);
+    // x - k * PIO2_1 is exact; the rounding error of the next step is kept (Fast2Sum)
+    double r0 = x - k * PIO2_1;
+    double t = k * PIO2_2;
+    double r1 = r0 - t;
+    double lo = ((r0 - r1) - t) - k * PIO2_3;
+    double r = r1 + lo;
+    tail = (r1 - r) + lo;
+    return r;
+}
+
+} // namespace simd_math_detail
+
+// Sine, <= 2 ULP for |x| <= 1e5
+#pragma omp declare simd
+inline double simdSin(double x) {
+    int q;
+    double tail;
+    double r = simd_math_detail::reducePiOver2(x, q, tail);
+    double s = simd_math_detail::sinKernel(r, tail);
+    double c = simd_math_detail::cosKernel(r, tail);
+    int quadrant = q & 3;
+    double result = simd_math_detail::select((quadrant & 1) != 0, c, s);
+    return simd_math_detail::flipSign(result, (quadrant & 2) != 0);
+}
+
+// Cosine, <= 2 ULP for |x| <= 1e5
+#pragma omp declare simd
+inline double simdCos(double x) {
+    int q;
+    double tail;
+    double r = simd_math_detail::reducePiOver2(x, q, tail);
+    double s = simd_math_detail::sinKernel(r, tail);
+    double c = simd_math_detail::cosKernel(r, tail);
+    int quadrant = q & 3;
+    double result = simd_math_detail::select((quadrant & 1) != 0, s, c);
+    return simd_math_detail::flipSign(result, (quadrant == 1) | (quadrant == 2));
+}
+
+// e^x, <= 2 ULP for -708 <= x <= 709; overflows to inf and underflows through
+// subnormals to 0 like libm
+#pragma omp declare simd
+inline double simdExp(double x) {
+    const double LOG2E = 1.44269504088896338700e+00;
+    const double LN2_HI = 6.93147180369123816490e-01;
+    const double LN2_LO = 1.90821492927058770002e-10;
+    const double P1 = 1.66666666666666019037e-01;
+    const double P2 = -2.77777777770155933842e-03;
+    const double P3 = 6.61375632143793436117e-05;
+    const double P4 = -1.65339022054652515390e-06;
+    const double P5 = 4.13813679705723846039e-08;
+    const double OVERFLOW_X = 7.09782712893383973096e+02;
+    const double UNDERFLOW_X = -7.45133219101941108420e+02;
+
+    // Clamped copy keeps k in range; NaN is patched up at the end
+    double xc = simd_math_detail::select(x < UNDERFLOW_X, UNDERFLOW_X, x);
+    xc = simd_math_detail::select(xc > OVERFLOW_X, OVERFLOW_X, xc);
+
+    int k;
+    double kd = simd_math_detail::roundToNearest(xc * LOG2E, k);
+    double hi = xc - kd * LN2_HI;
+    double lo = kd * LN2_LO;
+    double r = hi - lo;
+
+    double t = r * r;
+    double c = r - t * (P1 + t * (P2 + t * (P3 + t * (P4 + t * P5))));
+    double y = 1.0 - ((lo - (r * c) / (2.0 - c)) - hi);
+
+    // Two half-size scalings keep both factors normal for k up to 1024 and down to -1075
+    int k1 = k / 2;
+    int k2 = k - k1;
+    y = y * simd_math_detail::pow2(k1) * simd_math_detail::pow2(k2);
+
+    y = simd_math_detail::select(x > OVERFLOW_X, std::numeric_limits<double>::infinity(), y);
+    y = simd_math_detail::select(x < UNDERFLOW_X, 0.0, y);
+    return simd_math_detail::select(x != x, x, y);
+}
+
+// Natural logarithm, <= 2 ULP for all positive x; log(0) = -inf, log(x < 0) = NaN
+#pragma omp declare simd
+inline double simdLog(double x) {
+    const double LN2_HI = 6.93147180369123816490e-01;
+    const double LN2_LO = 1.90821492927058770002e-10;
+    const double SQRT2 = 1.41421356237309504880;
+    const double LG1 = 6.666666666666735130e-01;
+    const double LG2 = 3.999999999940941908e-01;
+    const double LG3 = 2.857142874366239149e-01;
+    const double LG4 = 2.222219843214978396e-01;
+    const double LG5 = 1.818357216161805012e-01;
+    const double LG6 = 1.531383769920937332e-01;
+    const double LG7 = 1.479819860511658591e-01;
+    const double TWO54 = 1.80143985094819840000e+16;
+
+    // Subnormals are scaled into the normal range first
+    bool subnormal = x < std::numeric_limits<double>::min();
+    double xs = simd_math_detail::select(subnormal, x * TWO54, x);
+
+    uint64_t bits = simd_math_detail::doubleToBits(xs);
+    int e = static_cast<int>((bits >> 52) & 0x7ff) - 1023 - (subnormal ? 54 : 0);
+    double m = simd_math_detail::bitsToDouble((bits & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL);
+
+    // m in [sqrt(2)/2, sqrt(2)) keeps f = m - 1 small
+    bool high = m > SQRT2;
+    m = simd_math_detail::select(high, m * 0.5, m);
+    e += high ? 1 : 0;
+
+    double f = m - 1.0;
+    double dk = static_cast<double>(e);
+    double s = f / (2.0 + f);
+    double z = s * s;
+    double w = z * z;
+    double t1 = w * (LG2 + w * (LG4 + w * LG6));
+    double t2 = z * (LG1 + w * (LG3 + w * (LG5 + w * LG7)));
+    double R = t2 + t1;
+    double hfsq = 0.5 * f * f;
+    double result = dk * LN2_HI - ((hfsq - (s * (hfsq + R) + dk * LN2_LO)) - f);
+
+    result = simd_math_detail::select(x == std::numeric_limits<double>::infinity(), x, result);
+    result = simd_math_detail::select(x == 0.0, -std::numeric_limits<double>::infinity(), result);
+    return simd_math_detail::select((x < 0.0) | (x != x), std::numeric_limits<double>::quiet_NaN(), result);
+}
+
+// Hyperbolic tangent, <= 4 ULP for all finite x
+#pragma omp declare simd
+inline double simdTanh(double x) {
+    double ax = simd_math_detail::flipSign(x, x < 0.0);
+    // Beyond 22, tanh rounds to +-1
+    double clamped = simd_math_detail::select(ax < 22.0, ax, 22.0);
+    double y = 2.0 * clamped;
+
+    // expm1(y) = (u - 1) * y / log(u) with u = e^y (Kahan); exact y when u rounds to 1
+    double u = simdExp(y);
+    double kahan = (u - 1.0) * y / simdLog(u);
+    double em1 = simd_math_detail::select(u == 1.0, y, kahan);
+
+    double t = em1 / (em1 + 2.0);
+    t = simd_math_detail::select(ax >= 22.0, 1.0, t);
+    t = simd_math_detail::flipSign(t, x < 0.0);
+    return simd_math_detail::select(x != x, x, t);
+}
+
+// Check every function against libm over its domain and print max / mean ULP.
+// Returns true if all functions meet their targets.
+bool checkSIMDMathAccuracy(size_t samplesPerDomain = 1000000);
+
+#endif // SIMD_MATH_H
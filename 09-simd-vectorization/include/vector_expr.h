@@ -0,0 +1,199 @@
+#ifndef VECTOR_EXPR_H
+#define VECTOR_EXPR_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <omp.h>
+#include "aligned_allocator.h"
+
+// Expression templates for element-wise double arithmetic. An expression such as
+// c = a * b + d * k builds a tree of lightweight nodes at compile time; nothing is
+// computed until it is assigned to an ExprVector, which then runs one fused loop
+// (threads split the range, each chunk is an omp simd loop) with no temporaries.
+// Separate passes would read and write every intermediate array through memory.
+//
+// Every node is only indexed at position i while writing position i, so the target
+// may also appear in the expression (a = a * b + c).
+
+// Below this many elements the fused loop stays on the calling thread
+constexpr size_t FUSION_PARALLEL_THRESHOLD = 32768;
+
+template<typename Derived>
+struct VectorExpression {
+    const Derived& self() const { return static_cast<const Derived&>(*this); }
+};
+
+// Leaf node for a vector operand: a raw pointer, so the fused loop does not reload
+// the vector's begin pointer after every store
+struct VectorRef : VectorExpression<VectorRef> {
+    const double* values;
+    size_t count;
+
+    VectorRef(const double* values, size_t count) : values(values), count(count) {}
+    double operator[](size_t i) const { return values[i]; }
+    size_t size() const { return count; }
+};
+
+// Leaf node for a scalar operand, broadcast to every element; size 0 matches any vector
+struct ScalarExpr : VectorExpression<ScalarExpr> {
+    double value;
+
+    explicit ScalarExpr(double value) : value(value) {}
+    double operator[](size_t) const { return value; }
+    size_t size() const { return 0; }
+};
+
+struct AddOp { static double apply(double a, double b) { return a + b; } };
+struct SubtractOp { static double apply(double a, double b) { return a - b; } };
+struct MultiplyOp { static double apply(double a, double b) { return a * b; } };
+struct DivideOp { static double apply(double a, double b) { return a / b; } };
+struct NegateOp { static double apply(double a) { return -a; } };
+
+class ExprVector;
+
+// How a node stores an operand: vectors by pointer, sub-expressions by value
+template<typename E>
+struct ExprOperand { using type = E; };
+
+template<>
+struct ExprOperand<ExprVector> { using type = VectorRef; };
+
+template<typename Op, typename L, typename R>
+struct BinaryExpr : VectorExpression<BinaryExpr<Op, L, R>> {
+    typename ExprOperand<L>::type left;
+    typename ExprOperand<R>::type right;
+
+    BinaryExpr(const L& left, const R& right) : left(operandOf(left)), right(operandOf(right)) {
+        assert(this->left.size() == 0 || this->right.size() == 0 || this->left.size() == this->right.size());
+    }
+    double operator[](size_t i) const { return Op::apply(left[i], right[i]); }
+    size_t size() const { return std::max(left.size(), right.size()); }
+};
+
+template<typename Op, typename E>
+struct UnaryExpr : VectorExpression<UnaryExpr<Op, E>> {
+    typename ExprOperand<E>::type operand;
+
+    explicit UnaryExpr(const E& operand) : operand(operandOf(operand)) {}
+    double operator[](size_t i) const { return Op::apply(operand[i]); }
+    size_t size() const { return operand.size(); }
+};
+
+// Vector of doubles that evaluates expressions on assignment
+class ExprVector : public VectorExpression<ExprVector> {
+public:
+    ExprVector() = default;
+    explicit ExprVector(size_t size, double value = 0.0) : values_(size, value) {}
+
+    template<typename E>
+    ExprVector(const VectorExpression<E>& expr) : values_(expr.self().size()) {
+        assign(expr.self());
+    }
+
+    template<typename E>
+    ExprVector& operator=(const VectorExpression<E>& expr) {
+        // A target that is also an operand already has the expression's size, so this
+        // never reallocates storage the expression reads
+        if (values_.size() != expr.self().size()) {
+            values_.resize(expr.self().size());
+        }
+        assign(expr.self());
+        return *this;
+    }
+
+    double operator[](size_t i) const { return values_[i]; }
+    double& operator[](size_t i) { return values_[i]; }
+    size_t size() const { return values_.size(); }
+    double* data() { return values_.data(); }
+    const double* data() const { return values_.data(); }
+
+private:
+    template<typename E>
+    void assign(const E& expr) {
+        double* out = values_.data();
+        const int size = static_cast<int>(values_.size());
+
+        // OpenMP 2.0 has no "parallel for simd": each thread takes a contiguous chunk
+        // (a multiple of 8 elements, so chunks start on a 64-byte boundary) and
+        // vectorizes it with omp simd
+        #pragma omp parallel if(values_.size() >= FUSION_PARALLEL_THRESHOLD)
+        {
+            const int threads = omp_get_num_threads();
+            const int thread = omp_get_thread_num();
+            const int chunk = ((size + threads - 1) / threads + 7) & ~7;
+            const int begin = std::min(size, thread * chunk);
+            const int end = std::min(size, begin + chunk);
+
+            #pragma omp simd
+            for (int i = begin; i < end; ++i) {
+                out[i] = expr[i];
+            }
+        }
+    }
+
+    AlignedVector<double> values_;
+};
+
+inline VectorRef operandOf(const ExprVector& vector) {
+    return VectorRef(vector.data(), vector.size());
+}
+
+template<typename E>
+const E& operandOf(const E& expr) {
+    return expr;
+}
+
+// Sum of all elements of an expression, fused the same way as assignment
+template<typename E>
+double sum(const VectorExpression<E>& expression) {
+    const typename ExprOperand<E>::type expr = operandOf(expression.self());
+    const int size = static_cast<int>(expr.size());
+    double total = 0.0;
+
+    #pragma omp parallel if(expr.size() >= FUSION_PARALLEL_THRESHOLD) reduction(+:total)
+    {
+        const int threads = omp_get_num_threads();
+        const int thread = omp_get_thread_num();
+        const int chunk = ((size + threads - 1) / threads + 7) & ~7;
+        const int begin = std::min(size, thread * chunk);
+        const int end = std::min(size, begin + chunk);
+
+        double partial = 0.0;
+        #pragma omp simd reduction(+:partial)
+        for (int i = begin; i < end; ++i) {
+            partial += expr[i];
+        }
+        total += partial;
+    }
+    return total;
+}
+
+// Operators: expression with expression, and expression with scalar on either side
+#define VECTOR_EXPR_BINARY_OPERATOR(symbol, Op)                                                    \
+    template<typename L, typename R>                                                               \
+    BinaryExpr<Op, L, R> operator symbol(const VectorExpression<L>& left, const VectorExpression<R>& right) { \
+        return BinaryExpr<Op, L, R>(left.self(), right.self());                                    \
+    }                                                                                              \
+    template<typename L>                                                                           \
+    BinaryExpr<Op, L, ScalarExpr> operator symbol(const VectorExpression<L>& left, double right) { \
+        return BinaryExpr<Op, L, ScalarExpr>(left.self(), ScalarExpr(right));                      \
+    }                                                                                              \
+    template<typename R>                                                                           \
+    BinaryExpr<Op, ScalarExpr, R> operator symbol(double left, const VectorExpression<R>& right) { \
+        return BinaryExpr<Op, ScalarExpr, R>(ScalarExpr(left), right.self());                      \
+    }
+
+VECTOR_EXPR_BINARY_OPERATOR(+, AddOp)
+VECTOR_EXPR_BINARY_OPERATOR(-, SubtractOp)
+VECTOR_EXPR_BINARY_OPERATOR(*, MultiplyOp)
+VECTOR_EXPR_BINARY_OPERATOR(/, DivideOp)
+
+#undef VECTOR_EXPR_BINARY_OPERATOR
+
+template<typename E>
+UnaryExpr<NegateOp, E> operator-(const VectorExpression<E>& operand) {
+    return UnaryExpr<NegateOp, E>(operand.self());
+}
+
+#endif // VECTOR_EXPR_H
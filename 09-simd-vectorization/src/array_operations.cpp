@@ -1,4 +1,5 @@
 #include "../include/simd_examples.h"
+#include "../include/simd_dispatch.h"
 #include <iostream>
 #include <vector>
 #include <chrono>
@@ -8,30 +9,26 @@
 #include <cassert>
 
 // Element-wise array multiplication without SIMD
-void scalarArrayMultiply(const std::vector<float>& a, const std::vector<float>& b, std::vector<float>& c) {
+void scalarArrayMultiply(const AlignedVector<float>& a, const AlignedVector<float>& b, AlignedVector<float>& c) {
     const int size = static_cast<int>(a.size());
     for (int i = 0; i < size; ++i) {
         c[i] = a[i] * b[i];
     }
 }
 
-// Element-wise array multiplication with SIMD
-void simdArrayMultiply(const std::vector<float>& a, const std::vector<float>& b, std::vector<float>& c) {
-    const int size = static_cast<int>(a.size());
-    
-    // Ensure we tell the compiler the arrays don't alias
-    const float* __restrict a_ptr = a.data();
-    const float* __restrict b_ptr = b.data();
-    float* __restrict c_ptr = c.data();
-    
-    #pragma omp simd
-    for (int i = 0; i < size; ++i) {
-        c_ptr[i] = a_ptr[i] * b_ptr[i];
+// Element-wise array multiplication with SIMD (dispatched per-ISA build); streaming
+// stores once the three arrays outgrow the last-level cache
+void simdArrayMultiply(const AlignedVector<float>& a, const AlignedVector<float>& b, AlignedVector<float>& c) {
+    const SIMDKernelTable& kernels = getSIMDKernels();
+    if (useStreamingStores(3 * a.size() * sizeof(float))) {
+        kernels.multiplyFloatStream(a.data(), b.data(), c.data(), a.size());
+    } else {
+        kernels.multiplyFloat(a.data(), b.data(), c.data(), a.size());
     }
 }
 
 // Array reduction without SIMD
-float scalarArrayReduction(const std::vector<float>& a) {
+float scalarArrayReduction(const AlignedVector<float>& a) {
     float sum = 0.0f;
     const int size = static_cast<int>(a.size());
     
@@ -42,24 +39,13 @@ float scalarArrayReduction(const std::vector<float>& a) {
     return sum;
 }
 
-// Array reduction with SIMD
-float simdArrayReduction(const std::vector<float>& a) {
-    float sum = 0.0f;
-    const int size = static_cast<int>(a.size());
-    
-    // Use const pointer to help vectorization
-    const float* __restrict a_ptr = a.data();
-    
-    #pragma omp simd reduction(+:sum)
-    for (int i = 0; i < size; ++i) {
-        sum += a_ptr[i];
-    }
-    
-    return sum;
+// Array reduction with SIMD (dispatched per-ISA build)
+float simdArrayReduction(const AlignedVector<float>& a) {
+    return getSIMDKernels().reduceFloat(a.data(), a.size());
 }
 
 // Element-wise array multiply function exposed to other modules
-void arrayElementWiseMultiply(const std::vector<float>& a, const std::vector<float>& b, std::vector<float>& c, bool useSimd) {
+void arrayElementWiseMultiply(const AlignedVector<float>& a, const AlignedVector<float>& b, AlignedVector<float>& c, bool useSimd) {
     // Make sure arrays are the same size
     assert(a.size() == b.size() && a.size() == c.size());
     
@@ -71,7 +57,7 @@ void arrayElementWiseMultiply(const std::vector<float>& a, const std::vector<flo
 }
 
 // Array reduction function exposed to other modules
-float arrayReduction(const std::vector<float>& a, bool useSimd) {
+float arrayReduction(const AlignedVector<float>& a, bool useSimd) {
     if (useSimd) {
         return simdArrayReduction(a);
     } else {
@@ -89,10 +75,10 @@ void runArrayOperations() {
     std::cout << "Initializing arrays with " << size << " elements..." << std::endl;
     
     // Initialize input vectors with random data
-    std::vector<float> a(size);
-    std::vector<float> b(size);
-    std::vector<float> c_scalar(size, 0.0f);
-    std::vector<float> c_simd(size, 0.0f);
+    AlignedVector<float> a(size);
+    AlignedVector<float> b(size);
+    AlignedVector<float> c_scalar(size, 0.0f);
+    AlignedVector<float> c_simd(size, 0.0f);
     
     // Initialize random number generator
     std::random_device rd;
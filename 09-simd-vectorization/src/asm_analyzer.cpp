@@ -253,6 +253,32 @@ void compareVectorizedAssembly(const std::string& vectorizedFile, const std::str
                   << (diff < 0 ? "fewer" : "more") << " instructions in vectorized code" << std::endl;
     }
     
+    // Predicted speedup of the hottest loop, from the static throughput model
+    MicroArch arch = detectMicroArch();
+    auto vecLoops = estimateLoopThroughput(vecInstructions, arch);
+    auto scalarLoops = estimateLoopThroughput(scalarInstructions, arch);
+    std::cout << "\nVectorized file:";
+    displayLoopEstimates(vecLoops, arch);
+    std::cout << "\nScalar file:";
+    displayLoopEstimates(scalarLoops, arch);
+    
+    const LoopEstimate* vecHot = findHotLoop(vecLoops);
+    // Compare like with like: the same function's loop in the scalar file if it has one
+    const LoopEstimate* scalarHot = findHotLoop(scalarLoops, vecHot != nullptr ? vecHot->function : "");
+    if (vecHot != nullptr && scalarHot != nullptr) {
+        std::cout << "\nHottest loops (most FP work): " << vecHot->function << " vs " << scalarHot->function << std::endl;
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "- Vectorized: " << vecHot->cyclesPerElement() << " cycles/element ("
+                  << vecHot->bottleneck << ")" << std::endl;
+        std::cout << "- Scalar: " << scalarHot->cyclesPerElement() << " cycles/element ("
+                  << scalarHot->bottleneck << ")" << std::endl;
+        std::cout << "- Predicted speedup: " << scalarHot->cyclesPerElement() / vecHot->cyclesPerElement()
+                  << "x (compute only; memory-bound loops gain less)" << std::endl;
+        if (!vecHot->widthWarning.empty()) {
+            std::cout << "- Note: " << vecHot->widthWarning << std::endl;
+        }
+    }
+    
     // SIMD instruction usage
     int vecSIMDCount = 0;
     int scalarSIMDCount = 0;
@@ -392,7 +418,9 @@ void runASMAnalysis() {
     // Find available assembly files
     std::vector<std::string> asmFiles;
     for (const auto& entry : fs::directory_iterator("asm_output")) {
-        if (entry.path().extension() == ".asm") {
+        // .asm from MSVC /FA, .s from GCC/Clang -S
+        if ((entry.path().extension() == ".asm" || entry.path().extension() == ".s") &&
+            entry.path().filename().string().rfind("annotated_", 0) != 0) {
             asmFiles.push_back(entry.path().string());
         }
     }
@@ -418,6 +446,7 @@ void runASMAnalysis() {
         auto instructions = parseAsmFile(file);
         identifySIMDInstructions(instructions);
         displayAsmStatistics(instructions);
+        displayLoopEstimates(estimateLoopThroughput(instructions, detectMicroArch()), detectMicroArch());
         
         // Generate annotated version
         std::string outputFile = "asm_output/annotated_" + fs::path(file).filename().string();
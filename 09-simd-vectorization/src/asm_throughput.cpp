@@ -0,0 +1,677 @@
+#include "../include/asm_analyzer.h"
+#include "../include/cpu_features.h"
+#include <algorithm>
+#include <cctype>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Static loop throughput model. Instructions are grouped into classes whose
+// latency and reciprocal throughput come from per-microarchitecture tables
+// (representative values from uops.info and Agner Fog's tables for 256-bit
+// forms). Each class runs on one execution resource; a resource's cycles per
+// iteration are the sum of the reciprocal throughputs issued to it.
+
+namespace {
+
+enum class Resource {
+    VectorALU,
+    Shuffle,
+    Divider,
+    Load,
+    Store,
+    ScalarALU,
+    Count
+};
+
+const char* resourceName(Resource resource) {
+    switch (resource) {
+        case Resource::VectorALU: return "vector ALU";
+        case Resource::Shuffle: return "shuffle port";
+        case Resource::Divider: return "divider";
+        case Resource::Load: return "load ports";
+        case Resource::Store: return "store port";
+        case Resource::ScalarALU: return "scalar ALU/branch";
+        case Resource::Count: break;
+    }
+    return "?";
+}
+
+enum class OpClass {
+    FpAdd,
+    FpMul,
+    Fma,
+    FpDiv,
+    FpSqrt,
+    Convert,
+    VecInt,
+    VecIntMul,
+    Shuffle,
+    Gather,
+    Load,
+    Store,
+    Move,
+    ScalarAlu,
+    ScalarMul,
+    ScalarDiv,
+    Branch,
+    Other
+};
+
+struct OpCost {
+    double latency;
+    double reciprocalThroughput;
+    Resource resource;
+};
+
+struct MicroArchTable {
+    double issueWidth;      // Instructions issued per cycle
+    double wideFactor;      // Throughput multiplier for 512-bit vector instructions
+    std::map<OpClass, OpCost> costs;
+};
+
+const MicroArchTable& tableFor(MicroArch arch) {
+    static const MicroArchTable skylake = {4.0, 1.0, {
+        {OpClass::FpAdd, {4, 0.5, Resource::VectorALU}},
+        {OpClass::FpMul, {4, 0.5, Resource::VectorALU}},
+        {OpClass::Fma, {4, 0.5, Resource::VectorALU}},
+        {OpClass::FpDiv, {13, 5.0, Resource::Divider}},
+        {OpClass::FpSqrt, {15, 6.0, Resource::Divider}},
+        {OpClass::Convert, {4, 1.0, Resource::VectorALU}},
+        {OpClass::VecInt, {1, 0.33, Resource::VectorALU}},
+        {OpClass::VecIntMul, {10, 1.0, Resource::VectorALU}},
+        {OpClass::Shuffle, {3, 1.0, Resource::Shuffle}},
+        {OpClass::Gather, {20, 5.0, Resource::Load}},
+        {OpClass::Load, {5, 0.5, Resource::Load}},
+        {OpClass::Store, {1, 1.0, Resource::Store}},
+        {OpClass::Move, {0, 0.0, Resource::ScalarALU}},
+        {OpClass::ScalarAlu, {1, 0.25, Resource::ScalarALU}},
+        {OpClass::ScalarMul, {3, 1.0, Resource::ScalarALU}},
+        {OpClass::ScalarDiv, {26, 6.0, Resource::Divider}},
+        {OpClass::Branch, {1, 0.5, Resource::ScalarALU}},
+        {OpClass::Other, {1, 0.5, Resource::ScalarALU}},
+    }};
+    static const MicroArchTable iceLake = {5.0, 1.0, {
+        {OpClass::FpAdd, {4, 0.5, Resource::VectorALU}},
+        {OpClass::FpMul, {4, 0.5, Resource::VectorALU}},
+        {OpClass::Fma, {4, 0.5, Resource::VectorALU}},
+        {OpClass::FpDiv, {13, 4.0, Resource::Divider}},
+        {OpClass::FpSqrt, {15, 6.0, Resource::Divider}},
+        {OpClass::Convert, {4, 0.5, Resource::VectorALU}},
+        {OpClass::VecInt, {1, 0.33, Resource::VectorALU}},
+        {OpClass::VecIntMul, {10, 1.0, Resource::VectorALU}},
+        {OpClass::Shuffle, {3, 1.0, Resource::Shuffle}},
+        {OpClass::Gather, {20, 5.0, Resource::Load}},
+        {OpClass::Load, {5, 0.5, Resource::Load}},
+        {OpClass::Store, {1, 0.5, Resource::Store}},
+        {OpClass::Move, {0, 0.0, Resource::ScalarALU}},
+        {OpClass::ScalarAlu, {1, 0.25, Resource::ScalarALU}},
+        {OpClass::ScalarMul, {3, 1.0, Resource::ScalarALU}},
+        {OpClass::ScalarDiv, {14, 6.0, Resource::Divider}},
+        {OpClass::Branch, {1, 0.5, Resource::ScalarALU}},
+        {OpClass::Other, {1, 0.5, Resource::ScalarALU}},
+    }};
+    static const MicroArchTable zen4 = {6.0, 2.0, {
+        {OpClass::FpAdd, {3, 0.5, Resource::VectorALU}},
+        {OpClass::FpMul, {3, 0.5, Resource::VectorALU}},
+        {OpClass::Fma, {4, 0.5, Resource::VectorALU}},
+        {OpClass::FpDiv, {11, 4.0, Resource::Divider}},
+        {OpClass::FpSqrt, {15, 6.0, Resource::Divider}},
+        {OpClass::Convert, {3, 1.0, Resource::VectorALU}},
+        {OpClass::VecInt, {1, 0.25, Resource::VectorALU}},
+        {OpClass::VecIntMul, {3, 0.5, Resource::VectorALU}},
+        {OpClass::Shuffle, {2, 0.5, Resource::Shuffle}},
+        {OpClass::Gather, {16, 4.0, Resource::Load}},
+        {OpClass::Load, {7, 0.33, Resource::Load}},
+        {OpClass::Store, {1, 1.0, Resource::Store}},
+        {OpClass::Move, {0, 0.0, Resource::ScalarALU}},
+        {OpClass::ScalarAlu, {1, 0.25, Resource::ScalarALU}},
+        {OpClass::ScalarMul, {3, 1.0, Resource::ScalarALU}},
+        {OpClass::ScalarDiv, {14, 7.0, Resource::Divider}},
+        {OpClass::Branch, {1, 0.5, Resource::ScalarALU}},
+        {OpClass::Other, {1, 0.5, Resource::ScalarALU}},
+    }};
+    switch (arch) {
+        case MicroArch::Skylake: return skylake;
+        case MicroArch::IceLake: return iceLake;
+        case MicroArch::Zen4: return zen4;
+    }
+    return skylake;
+}
+
+bool startsWith(const std::string& text, const char* prefix) {
+    return text.rfind(prefix, 0) == 0;
+}
+
+bool endsWith(const std::string& text, const char* suffix) {
+    const size_t length = std::char_traits<char>::length(suffix);
+    return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+bool contains(const std::string& text, const char* part) {
+    return text.find(part) != std::string::npos;
+}
+
+std::string toLower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+    return text;
+}
+
+// One instruction of a loop body, decoded enough for the model
+struct DecodedInstruction {
+    std::string opcode;
+    OpClass opClass;
+    int vectorBits;          // Widest vector register operand, 0 if none
+    bool packed;             // Packed SIMD form (ps/pd/integer vector)
+    bool floatingPoint;      // FP arithmetic (add/mul/fma/div/sqrt)
+    int elementBits;         // 32 or 64 for FP, 32 assumed for integer vectors
+    bool memorySource;       // Loads through a non-move instruction
+    bool memoryDestination;  // Writes memory
+    std::string destination; // Register written, normalized ("v3", "rax"), or empty
+    bool selfDependent;      // Reads the register it writes (loop-carried if repeated)
+};
+
+// Split operands at top-level commas (not inside () or [])
+std::vector<std::string> splitOperands(const std::string& operands) {
+    std::vector<std::string> parts;
+    std::string current;
+    int depth = 0;
+    for (char ch : operands) {
+        if (ch == '(' || ch == '[') {
+            ++depth;
+        } else if (ch == ')' || ch == ']') {
+            --depth;
+        }
+        if (ch == ',' && depth == 0) {
+            parts.push_back(current);
+            current.clear();
+        } else {
+            current += ch;
+        }
+    }
+    if (!current.empty()) {
+        parts.push_back(current);
+    }
+    for (auto& part : parts) {
+        part = std::regex_replace(part, std::regex("^\\s+|\\s+$"), "");
+    }
+    return parts;
+}
+
+bool isMemoryOperand(const std::string& operand) {
+    return operand.find('(') != std::string::npos || operand.find('[') != std::string::npos;
+}
+
+// Registers named in an operand, normalized so xmm3/ymm3/zmm3 -> v3 and eax -> rax
+std::vector<std::string> registersIn(const std::string& operand) {
+    static const std::regex registerPattern("\\b([xyz]mm([0-9]+)|r([0-9]+)[dwb]?|[re]?([abcd])x|[re]?(si|di|bp|sp))\\b");
+    std::vector<std::string> registers;
+    std::string text = toLower(operand);
+    text.erase(std::remove(text.begin(), text.end(), '%'), text.end());
+    for (std::sregex_iterator it(text.begin(), text.end(), registerPattern), end; it != end; ++it) {
+        const std::smatch& match = *it;
+        if (match[2].matched) {
+            registers.push_back("v" + match[2].str());
+        } else if (match[3].matched) {
+            registers.push_back("r" + match[3].str());
+        } else if (match[4].matched) {
+            registers.push_back("r" + match[4].str() + "x");
+        } else {
+            registers.push_back("r" + match[5].str());
+        }
+    }
+    return registers;
+}
+
+int vectorBitsOf(const std::string& operands) {
+    std::string text = toLower(operands);
+    if (contains(text.c_str(), "zmm")) return 512;
+    if (contains(text.c_str(), "ymm")) return 256;
+    if (contains(text.c_str(), "xmm")) return 128;
+    return 0;
+}
+
+OpClass classify(const std::string& op, bool memorySource, bool memoryDestination) {
+    if (op[0] == 'j' || startsWith(op, "call") || startsWith(op, "ret") || startsWith(op, "loop")) return OpClass::Branch;
+    if (contains(op, "gather")) return OpClass::Gather;
+    if (startsWith(op, "prefetch")) return OpClass::Load;
+    if (startsWith(op, "vfmadd") || startsWith(op, "vfmsub") || startsWith(op, "vfnmadd") || startsWith(op, "vfnmsub")) return OpClass::Fma;
+    if (startsWith(op, "idiv") || op == "div" || startsWith(op, "divq") || startsWith(op, "divl")) return OpClass::ScalarDiv;
+    if (contains(op, "sqrt")) return OpClass::FpSqrt;
+    if (contains(op, "div")) return OpClass::FpDiv;
+    if (startsWith(op, "imul") || (startsWith(op, "mul") && !contains(op, "mulp") && !contains(op, "muls"))) return OpClass::ScalarMul;
+    if (contains(op, "cvt")) return OpClass::Convert;
+    if (contains(op, "shuf") || contains(op, "perm") || contains(op, "unpck") || contains(op, "extract") ||
+        contains(op, "insert") || contains(op, "broadcast") || contains(op, "pack") || contains(op, "alignr") ||
+        startsWith(op, "vpmov") || startsWith(op, "pmov") || contains(op, "movhl") || contains(op, "movlh") || contains(op, "movshdup") || contains(op, "movsldup")) return OpClass::Shuffle;
+    if (startsWith(op, "vpmul") || startsWith(op, "pmul") || startsWith(op, "vpmadd") || startsWith(op, "pmadd") ||
+        startsWith(op, "vpdp")) return OpClass::VecIntMul;
+    if (contains(op, "mulp") || contains(op, "muls")) return OpClass::FpMul;
+    if (contains(op, "addp") || contains(op, "adds") || contains(op, "subp") || contains(op, "subs") ||
+        contains(op, "minp") || contains(op, "mins") || contains(op, "maxp") || contains(op, "maxs")) {
+        // "adds"/"subs" also match the integer saturating vpadds*/vpsubs*
+        return startsWith(op, "vp") || startsWith(op, "p") ? OpClass::VecInt : OpClass::FpAdd;
+    }
+    if (contains(op, "mov") && !startsWith(op, "cmov")) {
+        if (memoryDestination) return OpClass::Store;
+        if (memorySource) return OpClass::Load;
+        return OpClass::Move;
+    }
+    if (startsWith(op, "vp") || (op[0] == 'p' && op != "push" && op != "pop") || contains(op, "andp") ||
+        contains(op, "andnp") || contains(op, "orp") || contains(op, "xorp") || contains(op, "blend") ||
+        contains(op, "cmpp") || startsWith(op, "vcmp") || startsWith(op, "kmov") || startsWith(op, "kor") ||
+        startsWith(op, "kand")) return OpClass::VecInt;
+    if (startsWith(op, "nop") || op == "npad") return OpClass::Move;
+    if (std::isalpha(static_cast<unsigned char>(op[0]))) return OpClass::ScalarAlu;
+    return OpClass::Other;
+}
+
+// FP arithmetic form: packed unless the opcode ends in the scalar ss/sd suffix
+// (vaddss, mulsd, vfmadd231ss)
+bool isScalarFloatingPointForm(const std::string& op) {
+    return endsWith(op, "ss") || endsWith(op, "sd");
+}
+
+DecodedInstruction decode(const AsmInstruction& instr) {
+    DecodedInstruction decoded;
+    decoded.opcode = toLower(instr.opcode);
+    std::string operandText = instr.operands;
+    size_t comment = operandText.find(';');
+    if (comment != std::string::npos) {
+        operandText = operandText.substr(0, comment);
+    }
+    std::vector<std::string> operands = splitOperands(operandText);
+    const bool attSyntax = operandText.find('%') != std::string::npos;
+
+    // AT&T writes the destination last, Intel/MASM first
+    std::string destinationOperand;
+    std::vector<std::string> sourceOperands;
+    if (!operands.empty()) {
+        size_t destinationIndex = attSyntax ? operands.size() - 1 : 0;
+        destinationOperand = operands[destinationIndex];
+        for (size_t i = 0; i < operands.size(); ++i) {
+            if (i != destinationIndex) {
+                sourceOperands.push_back(operands[i]);
+            }
+        }
+    }
+
+    const std::string& op = decoded.opcode;
+    const bool isBranch = op[0] == 'j';
+    const bool isCompare = startsWith(op, "cmp") || startsWith(op, "test") || startsWith(op, "ucomis") ||
+                           startsWith(op, "vucomis") || startsWith(op, "comis") || startsWith(op, "vcomis");
+    decoded.memoryDestination = !isBranch && !isCompare && operands.size() >= 2 && isMemoryOperand(destinationOperand);
+    decoded.memorySource = false;
+    for (const auto& source : sourceOperands) {
+        decoded.memorySource = decoded.memorySource || isMemoryOperand(source);
+    }
+    if (isCompare && isMemoryOperand(destinationOperand)) {
+        decoded.memorySource = true;
+    }
+
+    decoded.opClass = classify(op, decoded.memorySource, decoded.memoryDestination);
+    decoded.vectorBits = vectorBitsOf(operandText);
+    decoded.floatingPoint = decoded.opClass == OpClass::FpAdd || decoded.opClass == OpClass::FpMul ||
+                            decoded.opClass == OpClass::Fma || decoded.opClass == OpClass::FpDiv ||
+                            decoded.opClass == OpClass::FpSqrt;
+    decoded.elementBits = (endsWith(op, "pd") || endsWith(op, "sd")) ? 64 : 32;
+
+    // Packed forms: FP and moves by suffix, integer vector ops apart from the
+    // GPR<->vector moves, conversions unless they involve a scalar type
+    switch (decoded.opClass) {
+        case OpClass::FpAdd:
+        case OpClass::FpMul:
+        case OpClass::Fma:
+        case OpClass::FpDiv:
+        case OpClass::FpSqrt:
+            decoded.packed = decoded.vectorBits > 0 && !isScalarFloatingPointForm(op);
+            break;
+        case OpClass::Load:
+        case OpClass::Store:
+        case OpClass::Move:
+            decoded.packed = decoded.vectorBits > 0 && (endsWith(op, "ps") || endsWith(op, "pd") ||
+                              contains(op, "dqu") || contains(op, "dqa"));
+            break;
+        case OpClass::Convert:
+            decoded.packed = decoded.vectorBits > 0 && !contains(op, "ss") && !contains(op, "sd") && !contains(op, "si");
+            break;
+        case OpClass::VecInt:
+        case OpClass::VecIntMul:
+        case OpClass::Shuffle:
+        case OpClass::Gather:
+            decoded.packed = decoded.vectorBits > 0 && !endsWith(op, "movd") && !endsWith(op, "movq");
+            break;
+        default:
+            decoded.packed = false;
+    }
+
+    // Loop-carried dependencies only through registers
+    decoded.selfDependent = false;
+    if (!isBranch && !isCompare && !decoded.memoryDestination && !destinationOperand.empty()) {
+        std::vector<std::string> written = registersIn(destinationOperand);
+        if (written.size() == 1) {
+            decoded.destination = written[0];
+            std::vector<std::string> read;
+            for (const auto& source : sourceOperands) {
+                for (const auto& reg : registersIn(source)) {
+                    read.push_back(reg);
+                }
+            }
+            const bool readsDestination = std::find(read.begin(), read.end(), decoded.destination) != read.end();
+            // Zero idioms (xor x, x, x) break dependencies
+            const bool zeroIdiom = (contains(op, "xor") || startsWith(op, "sub") || startsWith(op, "vpsub")) &&
+                                   !read.empty() && std::all_of(read.begin(), read.end(),
+                                       [&](const std::string& reg) { return reg == decoded.destination; });
+            // Two-operand legacy forms (add %xmm1, %xmm0 / add rax, 8) read the destination implicitly;
+            // FMA always accumulates into it
+            const bool implicitRead = op[0] != 'v' && operands.size() == 2 &&
+                                      decoded.opClass != OpClass::Move && decoded.opClass != OpClass::Load &&
+                                      decoded.opClass != OpClass::Convert && !startsWith(op, "lea");
+            decoded.selfDependent = !zeroIdiom && (readsDestination || implicitRead || decoded.opClass == OpClass::Fma);
+        }
+    }
+    return decoded;
+}
+
+bool isInstruction(const AsmInstruction& instr) {
+    if (instr.opcode.empty()) {
+        return false;
+    }
+    const char first = instr.opcode[0];
+    if (first == '.' || first == ';' || first == '$' || first == '_' || !std::isalpha(static_cast<unsigned char>(first))) {
+        return false;
+    }
+    std::string operands = toLower(instr.operands);
+    // MASM directives and PROC/ENDP lines
+    static const std::set<std::string> directives = {"proc", "endp", "segment", "ends", "db", "dw", "dd", "dq",
+                                                     "include", "includelib", "public", "extrn", "end", "title"};
+    std::string firstOperand = operands.substr(0, operands.find_first_of(" \t,"));
+    return directives.count(firstOperand) == 0 && directives.count(toLower(instr.opcode)) == 0;
+}
+
+// Label defined by a line ("name:" in GAS and MASM), empty if none
+std::string labelOf(const AsmInstruction& instr) {
+    if (!instr.address.empty() && instr.opcode.empty() && instr.address.back() == ':') {
+        return std::regex_replace(instr.address.substr(0, instr.address.size() - 1), std::regex("^\\s+|\\s+$"), "");
+    }
+    return "";
+}
+
+// Function names: GAS labels that are not local (.L...), MASM "name PROC"
+std::string functionOf(const AsmInstruction& instr) {
+    std::string label = labelOf(instr);
+    if (!label.empty() && label[0] != '.' && label[0] != '$') {
+        return label;
+    }
+    if (!instr.opcode.empty() && startsWith(toLower(instr.operands), "proc")) {
+        return instr.opcode;
+    }
+    return "";
+}
+
+// Branch target label, skipping MASM's SHORT/NEAR qualifiers
+std::string branchTarget(const AsmInstruction& instr) {
+    std::istringstream stream(instr.operands);
+    std::string token;
+    while (stream >> token) {
+        std::string lower = toLower(token);
+        if (lower != "short" && lower != "near" && lower != "ptr") {
+            return token;
+        }
+    }
+    return "";
+}
+
+} // namespace
+
+const char* microArchName(MicroArch arch) {
+    switch (arch) {
+        case MicroArch::Skylake: return "Skylake";
+        case MicroArch::IceLake: return "Ice Lake / Sapphire Rapids";
+        case MicroArch::Zen4: return "Zen 4";
+    }
+    return "Unknown";
+}
+
+MicroArch detectMicroArch() {
+    const CPUFeatures& features = getCPUFeatures();
+    if (features.cpuVendor == "AuthenticAMD" || features.cpuVendor == "HygonGenuine") {
+        return MicroArch::Zen4;
+    }
+    return features.hasAVX512F ? MicroArch::IceLake : MicroArch::Skylake;
+}
+
+std::vector<LoopEstimate> estimateLoopThroughput(const std::vector<AsmInstruction>& instructions, MicroArch arch) {
+    const MicroArchTable& table = tableFor(arch);
+
+    // Label positions and the function each line belongs to
+    std::map<std::string, size_t> labels;
+    std::vector<std::string> functions(instructions.size());
+    std::string currentFunction;
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        std::string function = functionOf(instructions[i]);
+        if (!function.empty()) {
+            currentFunction = function;
+        }
+        functions[i] = currentFunction;
+        std::string label = labelOf(instructions[i]);
+        if (!label.empty()) {
+            labels[label] = i;
+        }
+    }
+
+    // Backward branches delimit loop bodies
+    std::vector<std::pair<size_t, size_t>> bodies;
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        std::string op = toLower(instructions[i].opcode);
+        if (op.empty() || op[0] != 'j' || !isInstruction(instructions[i])) {
+            continue;
+        }
+        auto target = labels.find(branchTarget(instructions[i]));
+        if (target != labels.end() && target->second < i) {
+            bodies.push_back({target->second, i});
+        }
+    }
+
+    // Keep innermost loops: no other body nested strictly inside
+    std::vector<LoopEstimate> loops;
+    const CPUFeatures& features = getCPUFeatures();
+    for (const auto& body : bodies) {
+        bool hasInner = std::any_of(bodies.begin(), bodies.end(), [&](const std::pair<size_t, size_t>& other) {
+            return other != body && other.first >= body.first && other.second <= body.second;
+        });
+        if (hasInner) {
+            continue;
+        }
+
+        LoopEstimate loop;
+        loop.function = functions[body.first];
+        loop.label = labelOf(instructions[body.first]);
+        loop.firstInstruction = body.first;
+        loop.lastInstruction = body.second;
+        loop.instructionCount = 0;
+        loop.vectorBits = 0;
+        loop.floatingPointOps = 0;
+
+        double resourceCycles[static_cast<int>(Resource::Count)] = {};
+        std::map<std::string, double> chains;
+        std::set<std::string> accumulators;
+        std::set<std::string> overwritten;
+        bool packedFloatingPoint = false;
+        bool scalarFloatingPoint = false;
+        int elementBits = 32;
+        int wideStores = 0;
+        int scalarStores = 0;
+        std::vector<DecodedInstruction> decodedBody;
+
+        for (size_t i = body.first + 1; i <= body.second; ++i) {
+            if (!isInstruction(instructions[i])) {
+                continue;
+            }
+            DecodedInstruction decoded = decode(instructions[i]);
+            decodedBody.push_back(decoded);
+            loop.instructionCount++;
+
+            const OpCost& cost = table.costs.at(decoded.opClass);
+            double factor = (decoded.vectorBits == 512 && cost.resource != Resource::ScalarALU) ? table.wideFactor : 1.0;
+            resourceCycles[static_cast<int>(cost.resource)] += cost.reciprocalThroughput * factor;
+
+            // Folded memory operands add a load (and a store for read-modify-write)
+            if (decoded.memorySource && decoded.opClass != OpClass::Load && decoded.opClass != OpClass::Gather) {
+                resourceCycles[static_cast<int>(Resource::Load)] += table.costs.at(OpClass::Load).reciprocalThroughput * factor;
+            }
+            if (decoded.memoryDestination && decoded.opClass != OpClass::Store) {
+                resourceCycles[static_cast<int>(Resource::Store)] += table.costs.at(OpClass::Store).reciprocalThroughput * factor;
+                resourceCycles[static_cast<int>(Resource::Load)] += table.costs.at(OpClass::Load).reciprocalThroughput * factor;
+            }
+
+            // A register carries a value across iterations until something in the body
+            // overwrites it without reading it; updates of a carried register chain up
+            if (!decoded.destination.empty()) {
+                if (!decoded.selfDependent) {
+                    overwritten.insert(decoded.destination);
+                } else if (overwritten.count(decoded.destination) == 0) {
+                    chains[decoded.destination] += cost.latency;
+                    if (decoded.floatingPoint && decoded.packed) {
+                        accumulators.insert(decoded.destination);
+                    }
+                }
+            }
+
+            if (decoded.floatingPoint) {
+                loop.floatingPointOps++;
+                if (decoded.packed) {
+                    packedFloatingPoint = true;
+                    elementBits = decoded.elementBits;
+                } else {
+                    scalarFloatingPoint = true;
+                }
+            }
+            if (decoded.packed) {
+                loop.vectorBits = std::max(loop.vectorBits, decoded.vectorBits);
+            }
+        }
+
+        for (const auto& decoded : decodedBody) {
+            if (decoded.opClass != OpClass::Store) {
+                continue;
+            }
+            if (decoded.packed && decoded.vectorBits == loop.vectorBits) {
+                wideStores++;
+            } else if (!decoded.packed) {
+                scalarStores++;
+            }
+        }
+
+        loop.scalarFloatingPoint = scalarFloatingPoint && !packedFloatingPoint;
+        if (loop.vectorBits > 0) {
+            int lanes = loop.vectorBits / elementBits;
+            int vectorsPerIteration = wideStores > 0 ? wideStores : std::max<int>(1, static_cast<int>(accumulators.size()));
+            loop.elementsPerIteration = lanes * vectorsPerIteration;
+        } else {
+            loop.elementsPerIteration = std::max(1, scalarStores);
+        }
+
+        // The three bounds; the largest one is the estimate
+        loop.frontEndCycles = loop.instructionCount / table.issueWidth;
+        loop.resourceCycles = 0.0;
+        Resource busiest = Resource::ScalarALU;
+        for (int r = 0; r < static_cast<int>(Resource::Count); ++r) {
+            if (resourceCycles[r] > loop.resourceCycles) {
+                loop.resourceCycles = resourceCycles[r];
+                busiest = static_cast<Resource>(r);
+            }
+        }
+        loop.recurrenceCycles = 0.0;
+        std::string chainRegister;
+        for (const auto& chain : chains) {
+            if (chain.second > loop.recurrenceCycles) {
+                loop.recurrenceCycles = chain.second;
+                chainRegister = chain.first;
+            }
+        }
+
+        // Ties go to the front end, then the resource: a loop counter's one-cycle
+        // chain is rarely what limits a loop that also issues at one cycle
+        loop.cyclesPerIteration = std::max({loop.frontEndCycles, loop.resourceCycles, loop.recurrenceCycles});
+        if (loop.cyclesPerIteration == loop.frontEndCycles) {
+            loop.bottleneck = "front end";
+        } else if (loop.cyclesPerIteration == loop.resourceCycles) {
+            loop.bottleneck = resourceName(busiest);
+        } else {
+            loop.bottleneck = "dependency chain (" + chainRegister + ")";
+        }
+
+        // Wider registers were available on this CPU
+        if (loop.vectorBits > 0 && loop.vectorBits < features.maxSIMDWidth) {
+            loop.widthWarning = "vectorized at " + std::to_string(loop.vectorBits) + "-bit; CPU supports " +
+                                std::to_string(features.maxSIMDWidth) + "-bit";
+        } else if (loop.scalarFloatingPoint) {
+            loop.widthWarning = "scalar FP: not vectorized";
+        }
+
+        loops.push_back(loop);
+    }
+
+    // Most FP work first; among equals the widest vectors, which puts the main
+    // vector loop ahead of its scalar remainder loop
+    std::stable_sort(loops.begin(), loops.end(), [](const LoopEstimate& a, const LoopEstimate& b) {
+        if (a.floatingPointOps != b.floatingPointOps) {
+            return a.floatingPointOps > b.floatingPointOps;
+        }
+        return a.vectorBits > b.vectorBits;
+    });
+    return loops;
+}
+
+const LoopEstimate* findHotLoop(const std::vector<LoopEstimate>& loops, const std::string& function) {
+    // Already sorted by FP work
+    if (!function.empty()) {
+        for (const auto& loop : loops) {
+            if (loop.function == function) {
+                return &loop;
+            }
+        }
+    }
+    return loops.empty() ? nullptr : &loops.front();
+}
+
+void displayLoopEstimates(const std::vector<LoopEstimate>& loops, MicroArch arch) {
+    std::cout << "\nLoop throughput estimate (" << microArchName(arch) << " model, "
+              << loops.size() << " innermost loops):" << std::endl;
+    if (loops.empty()) {
+        std::cout << "No backward branches found." << std::endl;
+        return;
+    }
+
+    std::cout << std::left << std::setw(28) << "Function" << std::right << std::setw(6) << "Instr"
+              << std::setw(7) << "Bits" << std::setw(7) << "Elems" << std::setw(9) << "Cyc/it"
+              << std::setw(10) << "Cyc/elem" << "  " << std::left << "Bottleneck" << std::endl;
+    std::cout << std::string(96, '-') << std::endl;
+
+    const size_t maxRows = 12;
+    for (size_t i = 0; i < loops.size() && i < maxRows; ++i) {
+        const LoopEstimate& loop = loops[i];
+        std::string name = loop.function.empty() ? loop.label : loop.function;
+        if (name.length() > 27) {
+            name = name.substr(0, 24) + "...";
+        }
+        std::cout << std::left << std::setw(28) << name << std::right << std::setw(6) << loop.instructionCount
+                  << std::setw(7) << (loop.vectorBits > 0 ? std::to_string(loop.vectorBits) : "-")
+                  << std::setw(7) << loop.elementsPerIteration << std::fixed << std::setprecision(2)
+                  << std::setw(9) << loop.cyclesPerIteration << std::setw(10) << loop.cyclesPerElement()
+                  << "  " << std::left << loop.bottleneck;
+        if (!loop.widthWarning.empty()) {
+            std::cout << "  [" << loop.widthWarning << "]";
+        }
+        std::cout << std::endl;
+    }
+    if (loops.size() > maxRows) {
+        std::cout << "... " << loops.size() - maxRows << " more loops with less FP work" << std::endl;
+    }
+}
@@ -1,4 +1,5 @@
 #include "../include/simd_examples.h"
+#include "../include/simd_dispatch.h"
 #include <iostream>
 #include <vector>
 #include <chrono>
@@ -6,7 +7,7 @@
 #include <omp.h>
 
 // Basic vector addition without SIMD explicitly enabled
-double scalarVectorAddition(const std::vector<double>& a, const std::vector<double>& b, std::vector<double>& c) {
+double scalarVectorAddition(const AlignedVector<double>& a, const AlignedVector<double>& b, AlignedVector<double>& c) {
     auto start = std::chrono::high_resolution_clock::now();
     
     const size_t size = a.size();
@@ -18,16 +19,16 @@ double scalarVectorAddition(const std::vector<double>& a, const std::vector<doub
     return std::chrono::duration<double, std::milli>(end - start).count();
 }
 
-// Vector addition with OpenMP SIMD directive
-double simdVectorAddition(const std::vector<double>& a, const std::vector<double>& b, std::vector<double>& c) {
+// Vector addition with OpenMP SIMD directive, using the per-ISA build picked at startup;
+// arrays larger than the last-level cache are written with streaming stores
+double simdVectorAddition(const AlignedVector<double>& a, const AlignedVector<double>& b, AlignedVector<double>& c) {
     auto start = std::chrono::high_resolution_clock::now();
     
-    const size_t size = a.size();
-    
-    // Using OpenMP SIMD directive to vectorize the loop
-    #pragma omp simd
-    for (size_t i = 0; i < size; ++i) {
-        c[i] = a[i] + b[i];
+    const SIMDKernelTable& kernels = getSIMDKernels();
+    if (useStreamingStores(3 * a.size() * sizeof(double))) {
+        kernels.addDoubleStream(a.data(), b.data(), c.data(), a.size());
+    } else {
+        kernels.addDouble(a.data(), b.data(), c.data(), a.size());
     }
     
     auto end = std::chrono::high_resolution_clock::now();
@@ -35,7 +36,7 @@ double simdVectorAddition(const std::vector<double>& a, const std::vector<double
 }
 
 // Basic vector addition entry point
-double basicVectorAddition(const std::vector<double>& a, const std::vector<double>& b, std::vector<double>& c, bool useSimd) {
+double basicVectorAddition(const AlignedVector<double>& a, const AlignedVector<double>& b, AlignedVector<double>& c, bool useSimd) {
     if (useSimd) {
         return simdVectorAddition(a, b, c);
     } else {
@@ -53,10 +54,10 @@ void runBasicSIMD() {
     std::cout << "Initializing vectors with " << size << " elements..." << std::endl;
     
     // Initialize input vectors
-    std::vector<double> a(size, 1.0);
-    std::vector<double> b(size, 2.0);
-    std::vector<double> c_scalar(size, 0.0);
-    std::vector<double> c_simd(size, 0.0);
+    AlignedVector<double> a(size, 1.0);
+    AlignedVector<double> b(size, 2.0);
+    AlignedVector<double> c_scalar(size, 0.0);
+    AlignedVector<double> c_simd(size, 0.0);
     
     // Warm up the cache
     for (size_t i = 0; i < 100; ++i) {
@@ -67,7 +68,7 @@ void runBasicSIMD() {
     std::cout << "\nRunning scalar (non-vectorized) addition..." << std::endl;
     double timeScalar = scalarVectorAddition(a, b, c_scalar);
     
-    std::cout << "Running SIMD (vectorized) addition..." << std::endl;
+    std::cout << "Running SIMD (vectorized) addition with the " << getSIMDKernels().name << " kernels..." << std::endl;
     double timeSimd = simdVectorAddition(a, b, c_simd);
     
     // Verify results
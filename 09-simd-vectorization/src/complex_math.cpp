@@ -1,11 +1,16 @@
 #include "../include/simd_examples.h"
+#include "../include/simd_math.h"
+#include "../include/complex_soa.h"
 #include <iostream>
 #include <vector>
 #include <chrono>
 #include <iomanip>
 #include <cmath>
 #include <random>
+#include <sstream>
 #include <omp.h>
+#include <algorithm>
+#include <limits>
 
 // Define M_PI if not already defined
 #ifndef M_PI
@@ -13,7 +18,7 @@
 #endif
 
 // Transcendental math operations without SIMD
-void scalarTranscendental(const std::vector<double>& input, std::vector<double>& output) {
+void scalarTranscendental(const AlignedVector<double>& input, AlignedVector<double>& output) {
     const size_t size = input.size();
     for (size_t i = 0; i < size; ++i) {
         // Combine several transcendental functions: sin(x) + cos(x*2) / exp(x/4)
@@ -23,7 +28,7 @@ void scalarTranscendental(const std::vector<double>& input, std::vector<double>&
 }
 
 // Transcendental math operations with SIMD
-void simdTranscendental(const std::vector<double>& input, std::vector<double>& output) {
+void simdTranscendental(const AlignedVector<double>& input, AlignedVector<double>& output) {
     const size_t size = input.size();
     
     #pragma omp simd
@@ -34,24 +39,28 @@ void simdTranscendental(const std::vector<double>& input, std::vector<double>& o
     }
 }
 
-// Custom polynomial approximation of sin function - used to show custom math with SIMD
-// This is a simplified Taylor series approximation
-double customSin(double x) {
-    // Normalize to -PI..PI range
-    while (x > M_PI) x -= 2 * M_PI;
-    while (x < -M_PI) x += 2 * M_PI;
-    
-    // Taylor series approximation: x - x^3/3! + x^5/5! - x^7/7!
-    double x2 = x * x;
-    double x3 = x2 * x;
-    double x5 = x3 * x2;
-    double x7 = x5 * x2;
+// Polynomial transcendental version: same expression with the simd_math.h functions,
+// which the compiler can inline and vectorize
+void polynomialTranscendental(const AlignedVector<double>& input, AlignedVector<double>& output) {
+    const long long size = static_cast<long long>(input.size());
+    const double* __restrict in = input.data();
+    double* __restrict out = output.data();
     
-    return x - (x3 / 6.0) + (x5 / 120.0) - (x7 / 5040.0);
+    #pragma omp simd
+    for (long long i = 0; i < size; ++i) {
+        double x = in[i];
+        out[i] = simdSin(x) + simdCos(x * 2.0) / simdExp(x / 4.0);
+    }
+}
+
+// Custom sin: range reduction plus minimax polynomial from simd_math.h
+// (replaces the earlier 4-term Taylor series, which was off by up to 7.5e-2 at +-pi)
+double customSin(double x) {
+    return simdSin(x);
 }
 
 // Custom math without SIMD
-void scalarCustomMath(const std::vector<double>& input, std::vector<double>& output) {
+void scalarCustomMath(const AlignedVector<double>& input, AlignedVector<double>& output) {
     const size_t size = input.size();
     for (size_t i = 0; i < size; ++i) {
         // Use our custom sin function
@@ -61,7 +70,7 @@ void scalarCustomMath(const std::vector<double>& input, std::vector<double>& out
 }
 
 // Custom math with SIMD
-void simdCustomMath(const std::vector<double>& input, std::vector<double>& output) {
+void simdCustomMath(const AlignedVector<double>& input, AlignedVector<double>& output) {
     const size_t size = input.size();
     
     #pragma omp simd
@@ -72,15 +81,403 @@ void simdCustomMath(const std::vector<double>& input, std::vector<double>& outpu
     }
 }
 
-// Compute transcendental functions (exposed to other modules)
-void computeTranscendental(std::vector<double>& input, std::vector<double>& output, bool useSimd) {
+// Compute transcendental functions (exposed to other modules); the SIMD path uses
+// the vectorizable polynomial library
+void computeTranscendental(AlignedVector<double>& input, AlignedVector<double>& output, bool useSimd) {
     if (useSimd) {
-        simdTranscendental(input, output);
+        polynomialTranscendental(input, output);
     } else {
         scalarTranscendental(input, output);
     }
 }
 
+// Split interleaved std::complex data into real and imaginary arrays; std::complex
+// is layout-compatible with double[2], so this is a stride-2 gather
+void aosToSoA(const ComplexAoS& input, ComplexSoA& output) {
+    const long long n = static_cast<long long>(input.size());
+    const double* __restrict in = reinterpret_cast<const double*>(input.data());
+    double* __restrict re = output.re.data();
+    double* __restrict im = output.im.data();
+    
+    #pragma omp simd
+    for (long long i = 0; i < n; ++i) {
+        re[i] = in[2 * i];
+        im[i] = in[2 * i + 1];
+    }
+}
+
+// Interleave real and imaginary arrays back into std::complex data
+void soaToAoS(const ComplexSoA& input, ComplexAoS& output) {
+    const long long n = static_cast<long long>(input.size());
+    const double* __restrict re = input.re.data();
+    const double* __restrict im = input.im.data();
+    double* __restrict out = reinterpret_cast<double*>(output.data());
+    
+    #pragma omp simd
+    for (long long i = 0; i < n; ++i) {
+        out[2 * i] = re[i];
+        out[2 * i + 1] = im[i];
+    }
+}
+
+// c = a * b on split arrays: (ar*br - ai*bi) + i(ar*bi + ai*br), no shuffles
+void complexMultiplySoA(const ComplexSoA& a, const ComplexSoA& b, ComplexSoA& c) {
+    const long long n = static_cast<long long>(a.size());
+    const double* __restrict ar = a.re.data();
+    const double* __restrict ai = a.im.data();
+    const double* __restrict br = b.re.data();
+    const double* __restrict bi = b.im.data();
+    double* __restrict cr = c.re.data();
+    double* __restrict ci = c.im.data();
+    
+    #pragma omp simd
+    for (long long i = 0; i < n; ++i) {
+        cr[i] = ar[i] * br[i] - ai[i] * bi[i];
+        ci[i] = ar[i] * bi[i] + ai[i] * br[i];
+    }
+}
+
+// c = a + b on split arrays
+void complexAddSoA(const ComplexSoA& a, const ComplexSoA& b, ComplexSoA& c) {
+    const long long n = static_cast<long long>(a.size());
+    const double* __restrict ar = a.re.data();
+    const double* __restrict ai = a.im.data();
+    const double* __restrict br = b.re.data();
+    const double* __restrict bi = b.im.data();
+    double* __restrict cr = c.re.data();
+    double* __restrict ci = c.im.data();
+    
+    #pragma omp simd
+    for (long long i = 0; i < n; ++i) {
+        cr[i] = ar[i] + br[i];
+        ci[i] = ai[i] + bi[i];
+    }
+}
+
+// |a| on split arrays; plain sqrt(re^2 + im^2), without std::abs's overflow scaling
+void complexMagnitudeSoA(const ComplexSoA& a, AlignedVector<double>& magnitude) {
+    const long long n = static_cast<long long>(a.size());
+    const double* __restrict ar = a.re.data();
+    const double* __restrict ai = a.im.data();
+    double* __restrict out = magnitude.data();
+    
+    #pragma omp simd
+    for (long long i = 0; i < n; ++i) {
+        out[i] = std::sqrt(ar[i] * ar[i] + ai[i] * ai[i]);
+    }
+}
+
+// Radix-2 butterflies over one group; the k loop is contiguous in every array
+void fftButterflySoA(double* re, double* im, const double* twiddleRe, const double* twiddleIm, size_t half) {
+    double* __restrict loRe = re;
+    double* __restrict loIm = im;
+    double* __restrict hiRe = re + half;
+    double* __restrict hiIm = im + half;
+    const double* __restrict wr = twiddleRe;
+    const double* __restrict wi = twiddleIm;
+    const long long n = static_cast<long long>(half);
+    
+    #pragma omp simd
+    for (long long k = 0; k < n; ++k) {
+        double tr = wr[k] * hiRe[k] - wi[k] * hiIm[k];
+        double ti = wr[k] * hiIm[k] + wi[k] * hiRe[k];
+        hiRe[k] = loRe[k] - tr;
+        hiIm[k] = loIm[k] - ti;
+        loRe[k] = loRe[k] + tr;
+        loIm[k] = loIm[k] + ti;
+    }
+}
+
+// Reorder the elements of an FFT input into bit-reversed index order
+template<typename Swap>
+static void bitReversePermute(size_t n, Swap swapElements) {
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            swapElements(i, j);
+        }
+    }
+}
+
+// Iterative in-place radix-2 FFT on split arrays. Each stage gets its own contiguous
+// twiddle table, so the butterfly loop never gathers strided twiddles.
+void fftSoA(ComplexSoA& data) {
+    const size_t n = data.size();
+    bitReversePermute(n, [&](size_t i, size_t j) {
+        std::swap(data.re[i], data.re[j]);
+        std::swap(data.im[i], data.im[j]);
+    });
+    
+    AlignedVector<double> twiddleRe(n / 2 + 1);
+    AlignedVector<double> twiddleIm(n / 2 + 1);
+    for (size_t length = 2; length <= n; length *= 2) {
+        const size_t half = length / 2;
+        for (size_t k = 0; k < half; ++k) {
+            double angle = -2.0 * M_PI * static_cast<double>(k) / static_cast<double>(length);
+            twiddleRe[k] = std::cos(angle);
+            twiddleIm[k] = std::sin(angle);
+        }
+        for (size_t start = 0; start < n; start += length) {
+            fftButterflySoA(data.re.data() + start, data.im.data() + start,
+                            twiddleRe.data(), twiddleIm.data(), half);
+        }
+    }
+}
+
+// std::complex reference kernels
+void complexMultiplyAoS(const ComplexAoS& a, const ComplexAoS& b, ComplexAoS& c) {
+    const size_t n = a.size();
+    #pragma omp simd
+    for (size_t i = 0; i < n; ++i) {
+        c[i] = a[i] * b[i];
+    }
+}
+
+void complexAddAoS(const ComplexAoS& a, const ComplexAoS& b, ComplexAoS& c) {
+    const size_t n = a.size();
+    #pragma omp simd
+    for (size_t i = 0; i < n; ++i) {
+        c[i] = a[i] + b[i];
+    }
+}
+
+void complexMagnitudeAoS(const ComplexAoS& a, AlignedVector<double>& magnitude) {
+    const size_t n = a.size();
+    #pragma omp simd
+    for (size_t i = 0; i < n; ++i) {
+        magnitude[i] = std::abs(a[i]);
+    }
+}
+
+void fftAoS(ComplexAoS& data) {
+    const size_t n = data.size();
+    bitReversePermute(n, [&](size_t i, size_t j) {
+        std::swap(data[i], data[j]);
+    });
+    
+    ComplexAoS twiddles(n / 2 + 1);
+    for (size_t length = 2; length <= n; length *= 2) {
+        const size_t half = length / 2;
+        for (size_t k = 0; k < half; ++k) {
+            twiddles[k] = std::polar(1.0, -2.0 * M_PI * static_cast<double>(k) / static_cast<double>(length));
+        }
+        for (size_t start = 0; start < n; start += length) {
+            std::complex<double>* lo = data.data() + start;
+            std::complex<double>* hi = lo + half;
+            for (size_t k = 0; k < half; ++k) {
+                std::complex<double> t = twiddles[k] * hi[k];
+                hi[k] = lo[k] - t;
+                lo[k] = lo[k] + t;
+            }
+        }
+    }
+}
+
+// Check the SoA kernels against std::complex and print the largest differences
+static void runComplexLayoutDemo() {
+    std::cout << "\n--- Complex Numbers: Split (SoA) vs std::complex (AoS) ---" << std::endl;
+    const size_t size = 1 << 16;
+    
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dis(-1.0, 1.0);
+    ComplexAoS aosA(size);
+    ComplexAoS aosB(size);
+    for (size_t i = 0; i < size; ++i) {
+        aosA[i] = std::complex<double>(dis(gen), dis(gen));
+        aosB[i] = std::complex<double>(dis(gen), dis(gen));
+    }
+    
+    ComplexSoA soaA(size);
+    ComplexSoA soaB(size);
+    ComplexSoA soaC(size);
+    aosToSoA(aosA, soaA);
+    aosToSoA(aosB, soaB);
+    
+    ComplexAoS aosC(size);
+    ComplexAoS roundTrip(size);
+    AlignedVector<double> aosMagnitude(size);
+    AlignedVector<double> soaMagnitude(size);
+    
+    auto maxDifference = [&](const ComplexAoS& reference, const ComplexSoA& split) {
+        soaToAoS(split, roundTrip);
+        double worst = 0.0;
+        for (size_t i = 0; i < size; ++i) {
+            worst = std::max(worst, std::abs(reference[i] - roundTrip[i]));
+        }
+        return worst;
+    };
+    
+    complexMultiplyAoS(aosA, aosB, aosC);
+    complexMultiplySoA(soaA, soaB, soaC);
+    double multiplyError = maxDifference(aosC, soaC);
+    
+    complexAddAoS(aosA, aosB, aosC);
+    complexAddSoA(soaA, soaB, soaC);
+    double addError = maxDifference(aosC, soaC);
+    
+    complexMagnitudeAoS(aosA, aosMagnitude);
+    complexMagnitudeSoA(soaA, soaMagnitude);
+    double magnitudeError = 0.0;
+    for (size_t i = 0; i < size; ++i) {
+        magnitudeError = std::max(magnitudeError, std::abs(aosMagnitude[i] - soaMagnitude[i]));
+    }
+    
+    ComplexAoS aosSignal = aosA;
+    ComplexSoA soaSignal = soaA;
+    fftAoS(aosSignal);
+    fftSoA(soaSignal);
+    double fftError = maxDifference(aosSignal, soaSignal);
+    
+    std::cout << "Max |SoA - std::complex| over " << size << " elements:" << std::endl;
+    std::cout << std::scientific << std::setprecision(2);
+    std::cout << "  multiply:  " << multiplyError << std::endl;
+    std::cout << "  add:       " << addError << std::endl;
+    std::cout << "  magnitude: " << magnitudeError << std::endl;
+    std::cout << "  FFT:       " << fftError << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Timings across sizes are part of the benchmark suite (--benchmark)." << std::endl;
+}
+
+// Error of value in units of the last place of the correctly rounded reference
+static double ulpError(double value, long double reference) {
+    if (std::isnan(value) && std::isnan(static_cast<double>(reference))) {
+        return 0.0;
+    }
+    double rounded = static_cast<double>(reference);
+    if (std::isinf(rounded) || std::isinf(value)) {
+        return value == rounded ? 0.0 : std::numeric_limits<double>::infinity();
+    }
+    double magnitude = std::fabs(rounded);
+    double ulp = std::nextafter(magnitude, std::numeric_limits<double>::infinity()) - magnitude;
+    if (ulp == 0.0 || !std::isfinite(ulp)) {
+        ulp = std::numeric_limits<double>::denorm_min();
+    }
+    return static_cast<double>(std::fabs(static_cast<long double>(value) - reference) / ulp);
+}
+
+// Sample a domain uniformly, or log-uniformly for positive ranges spanning many decades
+static AlignedVector<double> sampleDomain(double low, double high, bool logarithmic, size_t samples) {
+    AlignedVector<double> points(samples);
+    std::mt19937_64 gen(12345);
+    if (logarithmic) {
+        std::uniform_real_distribution<double> dis(std::log(low), std::log(high));
+        for (auto& p : points) {
+            p = std::exp(dis(gen));
+        }
+    } else {
+        std::uniform_real_distribution<double> dis(low, high);
+        for (auto& p : points) {
+            p = dis(gen);
+        }
+    }
+    return points;
+}
+
+bool checkSIMDMathAccuracy(size_t samplesPerDomain) {
+    struct Domain {
+        const char* function;
+        double low;
+        double high;
+        bool logarithmic;
+        double targetUlp;
+    };
+    const Domain domains[] = {
+        {"sin", -M_PI, M_PI, false, 2.0},
+        {"sin", -1.0e5, 1.0e5, false, 2.0},
+        {"cos", -M_PI, M_PI, false, 2.0},
+        {"cos", -1.0e5, 1.0e5, false, 2.0},
+        {"exp", -1.0, 1.0, false, 2.0},
+        {"exp", -708.0, 709.0, false, 2.0},
+        {"log", 0.5, 2.0, false, 2.0},
+        {"log", 1.0e-310, 1.0e300, true, 2.0},
+        {"tanh", -1.0, 1.0, false, 4.0},
+        {"tanh", -25.0, 25.0, false, 4.0},
+    };
+    
+    std::cout << "\n--- Polynomial Math Accuracy (vs long double libm) ---" << std::endl;
+#if defined(_MSC_VER)
+    std::cout << "Note: long double is double on MSVC, so the reference is libm itself." << std::endl;
+#endif
+    std::cout << std::left << std::setw(8) << "Func" << std::setw(28) << "Domain"
+              << std::right << std::setw(12) << "Max ULP" << std::setw(12) << "Mean ULP"
+              << std::setw(10) << "Target" << std::setw(8) << "Result" << std::endl;
+    std::cout << std::string(78, '-') << std::endl;
+    
+    bool allPassed = true;
+    AlignedVector<double> output(samplesPerDomain);
+    for (const Domain& domain : domains) {
+        AlignedVector<double> input = sampleDomain(domain.low, domain.high, domain.logarithmic, samplesPerDomain);
+        const std::string name = domain.function;
+        const long long n = static_cast<long long>(input.size());
+        const double* __restrict in = input.data();
+        double* __restrict out = output.data();
+        
+        // Evaluate in vectorized loops so the checked code is the code benchmarks run
+        if (name == "sin") {
+            #pragma omp simd
+            for (long long i = 0; i < n; ++i) out[i] = simdSin(in[i]);
+        } else if (name == "cos") {
+            #pragma omp simd
+            for (long long i = 0; i < n; ++i) out[i] = simdCos(in[i]);
+        } else if (name == "exp") {
+            #pragma omp simd
+            for (long long i = 0; i < n; ++i) out[i] = simdExp(in[i]);
+        } else if (name == "log") {
+            #pragma omp simd
+            for (long long i = 0; i < n; ++i) out[i] = simdLog(in[i]);
+        } else {
+            #pragma omp simd
+            for (long long i = 0; i < n; ++i) out[i] = simdTanh(in[i]);
+        }
+        
+        double maxUlp = 0.0;
+        double sumUlp = 0.0;
+        double worstInput = 0.0;
+        for (long long i = 0; i < n; ++i) {
+            long double x = in[i];
+            long double reference = name == "sin" ? std::sin(x)
+                                  : name == "cos" ? std::cos(x)
+                                  : name == "exp" ? std::exp(x)
+                                  : name == "log" ? std::log(x)
+                                  : std::tanh(x);
+            double error = ulpError(out[i], reference);
+            sumUlp += error;
+            if (error > maxUlp) {
+                maxUlp = error;
+                worstInput = in[i];
+            }
+        }
+        
+        bool passed = maxUlp <= domain.targetUlp;
+        allPassed = allPassed && passed;
+        
+        std::ostringstream range;
+        range << "[" << std::setprecision(3) << domain.low << ", " << domain.high << "]";
+        std::cout << std::left << std::setw(8) << domain.function << std::setw(28) << range.str()
+                  << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(12) << maxUlp << std::setw(12) << sumUlp / static_cast<double>(n)
+                  << std::setw(10) << domain.targetUlp << std::setw(8) << (passed ? "PASS" : "FAIL");
+        if (!passed) {
+            std::cout << "  (worst at x = " << std::scientific << std::setprecision(17) << worstInput << ")";
+        }
+        std::cout << std::defaultfloat << std::endl;
+    }
+    
+    // Special values
+    bool specialsOk = std::isinf(simdExp(1000.0)) && simdExp(-1000.0) == 0.0 &&
+                      std::isnan(simdLog(-1.0)) && std::isinf(simdLog(0.0)) && simdLog(0.0) < 0.0 &&
+                      simdLog(1.0) == 0.0 && simdTanh(100.0) == 1.0 && simdTanh(-100.0) == -1.0 &&
+                      std::isnan(simdExp(std::numeric_limits<double>::quiet_NaN())) &&
+                      std::isnan(simdTanh(std::numeric_limits<double>::quiet_NaN()));
+    std::cout << "Special values (inf, 0, NaN, +-1): " << (specialsOk ? "PASS" : "FAIL") << std::endl;
+    
+    return allPassed && specialsOk;
+}
+
 // Run complex math demo
 void runComplexMath() {
     std::cout << "\n=== Complex Math Functions with SIMD Demo ===" << std::endl;
@@ -96,16 +493,16 @@ void runComplexMath() {
     std::uniform_real_distribution<double> dis(-M_PI, M_PI);
     
     // Initialize input vector with random angles
-    std::vector<double> input(size);
+    AlignedVector<double> input(size);
     for (auto& val : input) {
         val = dis(gen);
     }
     
     // Output vectors
-    std::vector<double> output_scalar_trans(size, 0.0);
-    std::vector<double> output_simd_trans(size, 0.0);
-    std::vector<double> output_scalar_custom(size, 0.0);
-    std::vector<double> output_simd_custom(size, 0.0);
+    AlignedVector<double> output_scalar_trans(size, 0.0);
+    AlignedVector<double> output_simd_trans(size, 0.0);
+    AlignedVector<double> output_scalar_custom(size, 0.0);
+    AlignedVector<double> output_simd_custom(size, 0.0);
     
     // Measure standard transcendental performance
     std::cout << "\n--- Standard Transcendental Functions ---" << std::endl;
@@ -178,6 +575,26 @@ void runComplexMath() {
     std::cout << "Speedup: " << speedupCustom << "x" << std::endl;
     std::cout << "Results verification: " << (customResultsMatch ? "PASSED" : "FAILED") << std::endl;
     
+    // Same expression through the polynomial library
+    std::cout << "\n--- Polynomial Math Library (simd_math.h) ---" << std::endl;
+    AlignedVector<double> output_poly(size, 0.0);
+    start = std::chrono::high_resolution_clock::now();
+    polynomialTranscendental(input, output_poly);
+    end = std::chrono::high_resolution_clock::now();
+    double timePoly = std::chrono::duration<double, std::milli>(end - start).count();
+    
+    double maxPolyDifference = 0.0;
+    for (size_t i = 0; i < size; ++i) {
+        maxPolyDifference = std::max(maxPolyDifference, std::abs(output_scalar_trans[i] - output_poly[i]));
+    }
+    std::cout << "Polynomial SIMD time: " << timePoly << " ms" << std::endl;
+    std::cout << "Speedup over scalar libm: " << timeScalarTrans / timePoly << "x" << std::endl;
+    std::cout << "Max difference from libm: " << std::scientific << maxPolyDifference << std::fixed << std::endl;
+    
+    checkSIMDMathAccuracy(200000);
+    
+    runComplexLayoutDemo();
+    
     // Compare standard vs custom sin implementation
     std::cout << "\n--- Standard vs Custom Sin Implementation ---" << std::endl;
     double standardSin = std::sin(0.5);
@@ -206,7 +623,7 @@ void runComplexMath() {
     
     std::cout << "\n2. Custom Math Functions:" << std::endl;
     std::cout << "   - Polynomial approximations are well-suited for SIMD" << std::endl;
-    std::cout << "   - Our custom sin uses basic arithmetic operations:" << std::endl;
+    std::cout << "   - Our custom sin (simdSin) reduces the argument, then uses basic arithmetic:" << std::endl;
     std::cout << "     * Addition/subtraction" << std::endl;
     std::cout << "     * Multiplication/division" << std::endl;
     std::cout << "     * No branching in the core calculation" << std::endl;
@@ -1,13 +1,68 @@
 #include "../include/cpu_features.h"
+#include "../include/simd_dispatch.h"
 #include <iostream>
 #include <string>
 #include <vector>
 #include <iomanip>
+#include <cstring>
 
 // Windows-specific headers for CPU detection
 #ifdef _WIN32
 #include <windows.h>
 #include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#if defined(_WIN32) || defined(__x86_64__) || defined(__i386__)
+#define CPU_FEATURES_X86 1
+
+// CPUID leaf/subleaf into {eax, ebx, ecx, edx}
+static void cpuidQuery(int info[4], int leaf, int subleaf) {
+#ifdef _WIN32
+    __cpuidex(info, leaf, subleaf);
+#else
+    unsigned int a = 0, b = 0, c = 0, d = 0;
+    __cpuid_count(leaf, subleaf, a, b, c, d);
+    info[0] = static_cast<int>(a);
+    info[1] = static_cast<int>(b);
+    info[2] = static_cast<int>(c);
+    info[3] = static_cast<int>(d);
+#endif
+}
+
+// XCR0: which register states the OS saves on a context switch
+static unsigned long long readXCR0() {
+#ifdef _WIN32
+    return _xgetbv(0);
+#else
+    unsigned int eax = 0, edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+}
+
+// Largest cache described by a deterministic cache parameters leaf (4 on Intel,
+// 0x8000001D on AMD); each subleaf describes one cache until type 0
+static size_t largestCacheFromLeaf(int leaf) {
+    size_t largest = 0;
+    int info[4] = {0};
+    for (int subleaf = 0; subleaf < 16; ++subleaf) {
+        cpuidQuery(info, leaf, subleaf);
+        if ((info[0] & 0x1f) == 0) {
+            break;
+        }
+        size_t ways = ((static_cast<unsigned int>(info[1]) >> 22) & 0x3ff) + 1;
+        size_t partitions = ((static_cast<unsigned int>(info[1]) >> 12) & 0x3ff) + 1;
+        size_t lineSize = (static_cast<unsigned int>(info[1]) & 0xfff) + 1;
+        size_t sets = static_cast<unsigned int>(info[2]) + 1;
+        size_t bytes = ways * partitions * lineSize * sets;
+        if (bytes > largest) {
+            largest = bytes;
+        }
+    }
+    return largest;
+}
 #endif
 
 // Static instance of CPU features
@@ -25,29 +80,34 @@ void detectCPUFeatures() {
     g_cpuFeatures.hasAVX = false;
     g_cpuFeatures.hasAVX2 = false;
     g_cpuFeatures.hasAVX512F = false;
+    g_cpuFeatures.hasFMA = false;
+    g_cpuFeatures.hasF16C = false;
+    g_cpuFeatures.hasAVX512BF16 = false;
     g_cpuFeatures.maxSIMDWidth = 0;
+    g_cpuFeatures.lastLevelCacheBytes = 0;
     
     // Use CPUID to detect CPU features
-#ifdef _WIN32
+#ifdef CPU_FEATURES_X86
     int cpuInfo[4] = {0};
     
     // Get vendor ID
-    __cpuid(cpuInfo, 0);
+    cpuidQuery(cpuInfo, 0, 0);
+    int maxBasicId = cpuInfo[0];
     char vendor[13];
-    *reinterpret_cast<int*>(vendor) = cpuInfo[1];
-    *reinterpret_cast<int*>(vendor+4) = cpuInfo[3];
-    *reinterpret_cast<int*>(vendor+8) = cpuInfo[2];
+    memcpy(vendor, &cpuInfo[1], 4);
+    memcpy(vendor + 4, &cpuInfo[3], 4);
+    memcpy(vendor + 8, &cpuInfo[2], 4);
     vendor[12] = '\0';
     g_cpuFeatures.cpuVendor = vendor;
     
     // Get brand string
     char brand[49];
-    __cpuid(cpuInfo, 0x80000000);
+    cpuidQuery(cpuInfo, static_cast<int>(0x80000000), 0);
     unsigned int maxExtendedId = cpuInfo[0];
     if (maxExtendedId >= 0x80000004) {
         brand[0] = '\0';
-        for (int i = 0x80000002; i <= 0x80000004; ++i) {
-            __cpuid(cpuInfo, i);
+        for (unsigned int i = 0x80000002; i <= 0x80000004; ++i) {
+            cpuidQuery(cpuInfo, static_cast<int>(i), 0);
             memcpy(brand + (i - 0x80000002) * 16, cpuInfo, sizeof(cpuInfo));
         }
         brand[48] = '\0';
@@ -57,21 +117,51 @@ void detectCPUFeatures() {
     }
     
     // Check for basic SIMD features
-    __cpuid(cpuInfo, 1);
+    cpuidQuery(cpuInfo, 1, 0);
     g_cpuFeatures.hasSSE = (cpuInfo[3] & (1 << 25)) != 0;
     g_cpuFeatures.hasSSE2 = (cpuInfo[3] & (1 << 26)) != 0;
     g_cpuFeatures.hasSSE3 = (cpuInfo[2] & (1 << 0)) != 0;
     g_cpuFeatures.hasSSSE3 = (cpuInfo[2] & (1 << 9)) != 0;
     g_cpuFeatures.hasSSE41 = (cpuInfo[2] & (1 << 19)) != 0;
     g_cpuFeatures.hasSSE42 = (cpuInfo[2] & (1 << 20)) != 0;
-    g_cpuFeatures.hasAVX = (cpuInfo[2] & (1 << 28)) != 0;
+    bool cpuHasAVX = (cpuInfo[2] & (1 << 28)) != 0;
+    bool cpuHasFMA = (cpuInfo[2] & (1 << 12)) != 0;
+    bool cpuHasF16C = (cpuInfo[2] & (1 << 29)) != 0;
+    bool osXSave = (cpuInfo[2] & (1 << 27)) != 0;
+    
+    // The OS must save XMM/YMM (XCR0 bits 1-2) for AVX, and also opmask/ZMM (bits 5-7) for AVX-512
+    unsigned long long xcr0 = osXSave ? readXCR0() : 0;
+    bool osSavesYMM = (xcr0 & 0x6) == 0x6;
+    bool osSavesZMM = (xcr0 & 0xE6) == 0xE6;
+    g_cpuFeatures.hasAVX = cpuHasAVX && osSavesYMM;
+    g_cpuFeatures.hasFMA = cpuHasFMA && osSavesYMM;
+    g_cpuFeatures.hasF16C = cpuHasF16C && osSavesYMM;
     
-    // Check for AVX2
-    if (maxExtendedId >= 7) {
-        __cpuidex(cpuInfo, 7, 0);
-        g_cpuFeatures.hasAVX2 = (cpuInfo[1] & (1 << 5)) != 0;
-        g_cpuFeatures.hasAVX512F = (cpuInfo[1] & (1 << 16)) != 0;
+    // Check for AVX2 and AVX-512F
+    if (maxBasicId >= 7) {
+        cpuidQuery(cpuInfo, 7, 0);
+        g_cpuFeatures.hasAVX2 = osSavesYMM && (cpuInfo[1] & (1 << 5)) != 0;
+        g_cpuFeatures.hasAVX512F = osSavesZMM && (cpuInfo[1] & (1 << 16)) != 0;
+        int maxLeaf7Subleaf = cpuInfo[0];
+        if (maxLeaf7Subleaf >= 1) {
+            cpuidQuery(cpuInfo, 7, 1);
+            g_cpuFeatures.hasAVX512BF16 = g_cpuFeatures.hasAVX512F && (cpuInfo[0] & (1 << 5)) != 0;
+        }
     }
+    
+    // Cache sizes; AMD reports them on the extended leaf when topology extensions are present
+    if (g_cpuFeatures.cpuVendor == "AuthenticAMD" || g_cpuFeatures.cpuVendor == "HygonGenuine") {
+        cpuidQuery(cpuInfo, static_cast<int>(0x80000001), 0);
+        bool topologyExtensions = maxExtendedId >= 0x8000001D && (cpuInfo[2] & (1 << 22)) != 0;
+        if (topologyExtensions) {
+            g_cpuFeatures.lastLevelCacheBytes = largestCacheFromLeaf(static_cast<int>(0x8000001D));
+        }
+    } else if (maxBasicId >= 4) {
+        g_cpuFeatures.lastLevelCacheBytes = largestCacheFromLeaf(4);
+    }
+#else
+    g_cpuFeatures.cpuVendor = "Unknown";
+    g_cpuFeatures.cpuBrand = "Non-x86 processor";
 #endif
     
     // Determine maximum SIMD width based on detected features
@@ -107,9 +197,18 @@ void displayCPUFeatures() {
     std::cout << std::left << std::setw(15) << "SSE4.2" << std::setw(10) << (g_cpuFeatures.hasSSE42 ? "Yes" : "No") << std::endl;
     std::cout << std::left << std::setw(15) << "AVX" << std::setw(10) << (g_cpuFeatures.hasAVX ? "Yes" : "No") << std::endl;
     std::cout << std::left << std::setw(15) << "AVX2" << std::setw(10) << (g_cpuFeatures.hasAVX2 ? "Yes" : "No") << std::endl;
+    std::cout << std::left << std::setw(15) << "FMA" << std::setw(10) << (g_cpuFeatures.hasFMA ? "Yes" : "No") << std::endl;
+    std::cout << std::left << std::setw(15) << "F16C" << std::setw(10) << (g_cpuFeatures.hasF16C ? "Yes" : "No") << std::endl;
     std::cout << std::left << std::setw(15) << "AVX-512F" << std::setw(10) << (g_cpuFeatures.hasAVX512F ? "Yes" : "No") << std::endl;
+    std::cout << std::left << std::setw(15) << "AVX-512 BF16" << std::setw(10) << (g_cpuFeatures.hasAVX512BF16 ? "Yes" : "No") << std::endl;
     std::cout << std::string(25, '-') << std::endl;
     std::cout << "Maximum SIMD Width: " << g_cpuFeatures.maxSIMDWidth << " bits" << std::endl;
+    if (g_cpuFeatures.lastLevelCacheBytes > 0) {
+        std::cout << "Last-level cache: " << g_cpuFeatures.lastLevelCacheBytes / 1024 << " KB" << std::endl;
+    } else {
+        std::cout << "Last-level cache: unknown (assuming " << getLastLevelCacheSize() / 1024 << " KB)" << std::endl;
+    }
+    std::cout << "Dispatched kernel variant: " << getSIMDKernels().name << std::endl;
     
     // Additional information
     std::cout << "\nSIMD Instruction Set Notes:" << std::endl;
@@ -121,7 +220,10 @@ void displayCPUFeatures() {
     
     // Recommendations based on CPU capabilities
     std::cout << "\nRecommendations for this CPU:" << std::endl;
-    if (g_cpuFeatures.hasAVX2) {
+    if (g_cpuFeatures.hasAVX512F) {
+        std::cout << "- Optimal SIMD width: 512 bits (16 floats or 8 doubles per operation)" << std::endl;
+        std::cout << "- Compiler flags: /arch:AVX512" << std::endl;
+    } else if (g_cpuFeatures.hasAVX2) {
         std::cout << "- Optimal SIMD width: 256 bits (8 floats or 4 doubles per operation)" << std::endl;
         std::cout << "- Compiler flags: /arch:AVX2" << std::endl;
     } else if (g_cpuFeatures.hasAVX) {
@@ -140,6 +242,12 @@ int getOptimalSIMDWidth() {
     return g_cpuFeatures.maxSIMDWidth;
 }
 
+// Last-level cache size used to pick between regular and streaming stores
+size_t getLastLevelCacheSize() {
+    const size_t fallback = 8 * 1024 * 1024;
+    return g_cpuFeatures.lastLevelCacheBytes > 0 ? g_cpuFeatures.lastLevelCacheBytes : fallback;
+}
+
 // Get a reference to the CPU features structure
 CPUFeatures& getCPUFeatures() {
     return g_cpuFeatures;
@@ -7,6 +7,7 @@
 #include "../include/benchmark_suite.h"
 #include "../include/simd_verifier.h"
 #include "../include/asm_analyzer.h"
+#include "../include/simd_math.h"
 
 void printMenu() {
     std::cout << "\n=== OpenMP SIMD Vectorization Demo Menu ===\n";
@@ -44,6 +45,10 @@ void processCommandLine(int argc, char* argv[]) {
         runASMAnalysis();
         exit(0);
     }
+    else if (arg == "--math-accuracy" || arg == "-m") {
+        std::cout << "Checking polynomial math accuracy...\n";
+        exit(checkSIMDMathAccuracy() ? 0 : 1);
+    }
     else if (arg == "--cpu-info" || arg == "-c") {
         std::cout << "Displaying CPU information...\n";
         displayCPUFeatures();
@@ -55,6 +60,7 @@ void processCommandLine(int argc, char* argv[]) {
         std::cout << "  --benchmark, -b    Run benchmark suite\n";
         std::cout << "  --verify, -v       Run SIMD verification\n";
         std::cout << "  --asm-analysis, -a Run assembly analysis\n";
+        std::cout << "  --math-accuracy, -m Check simd_math.h accuracy against libm\n";
         std::cout << "  --cpu-info, -c     Display CPU information\n";
         std::cout << "  --help, -h         Display this help message\n";
         exit(0);
@@ -1,4 +1,9 @@
 #include "../include/simd_examples.h"
+#include "../include/reduced_precision.h"
+#include "../include/simd_dispatch.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <iostream>
 #include <vector>
 #include <chrono>
@@ -7,9 +12,9 @@
 #include <omp.h>
 
 // Mixed type operations without SIMD
-void scalarMixedTypeOperations(const std::vector<float>& floatVec, 
-                              const std::vector<int>& intVec, 
-                              std::vector<float>& result) {
+void scalarMixedTypeOperations(const AlignedVector<float>& floatVec, 
+                              const AlignedVector<int>& intVec, 
+                              AlignedVector<float>& result) {
     const size_t size = floatVec.size();
     for (size_t i = 0; i < size; ++i) {
         // Mix float and int operations
@@ -18,9 +23,9 @@ void scalarMixedTypeOperations(const std::vector<float>& floatVec,
 }
 
 // Mixed type operations with SIMD
-void simdMixedTypeOperations(const std::vector<float>& floatVec, 
-                            const std::vector<int>& intVec, 
-                            std::vector<float>& result) {
+void simdMixedTypeOperations(const AlignedVector<float>& floatVec, 
+                            const AlignedVector<int>& intVec, 
+                            AlignedVector<float>& result) {
     const size_t size = floatVec.size();
     
     #pragma omp simd
@@ -31,8 +36,8 @@ void simdMixedTypeOperations(const std::vector<float>& floatVec,
 }
 
 // Int to float conversion without SIMD
-void scalarIntToFloatConversion(const std::vector<int>& intVec, 
-                               std::vector<float>& floatVec) {
+void scalarIntToFloatConversion(const AlignedVector<int>& intVec, 
+                               AlignedVector<float>& floatVec) {
     const size_t size = intVec.size();
     for (size_t i = 0; i < size; ++i) {
         floatVec[i] = static_cast<float>(intVec[i]);
@@ -40,8 +45,8 @@ void scalarIntToFloatConversion(const std::vector<int>& intVec,
 }
 
 // Int to float conversion with SIMD
-void simdIntToFloatConversion(const std::vector<int>& intVec, 
-                             std::vector<float>& floatVec) {
+void simdIntToFloatConversion(const AlignedVector<int>& intVec, 
+                             AlignedVector<float>& floatVec) {
     const size_t size = intVec.size();
     
     #pragma omp simd
@@ -51,8 +56,8 @@ void simdIntToFloatConversion(const std::vector<int>& intVec,
 }
 
 // Float to int conversion (with rounding) without SIMD
-void scalarFloatToIntConversion(const std::vector<float>& floatVec, 
-                               std::vector<int>& intVec) {
+void scalarFloatToIntConversion(const AlignedVector<float>& floatVec, 
+                               AlignedVector<int>& intVec) {
     const size_t size = floatVec.size();
     for (size_t i = 0; i < size; ++i) {
         intVec[i] = static_cast<int>(floatVec[i] + 0.5f); // Round to nearest
@@ -60,8 +65,8 @@ void scalarFloatToIntConversion(const std::vector<float>& floatVec,
 }
 
 // Float to int conversion (with rounding) with SIMD
-void simdFloatToIntConversion(const std::vector<float>& floatVec, 
-                             std::vector<int>& intVec) {
+void simdFloatToIntConversion(const AlignedVector<float>& floatVec, 
+                             AlignedVector<int>& intVec) {
     const size_t size = floatVec.size();
     
     #pragma omp simd
@@ -71,8 +76,8 @@ void simdFloatToIntConversion(const std::vector<float>& floatVec,
 }
 
 // Mixed precision operations function exposed to other modules
-void mixedTypeOperations(std::vector<float>& floatVec, std::vector<int>& intVec, 
-                        std::vector<float>& result, bool useSimd) {
+void mixedTypeOperations(AlignedVector<float>& floatVec, AlignedVector<int>& intVec, 
+                        AlignedVector<float>& result, bool useSimd) {
     if (useSimd) {
         simdMixedTypeOperations(floatVec, intVec, result);
     } else {
@@ -80,6 +85,198 @@ void mixedTypeOperations(std::vector<float>& floatVec, std::vector<int>& intVec,
     }
 }
 
+static uint32_t floatBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float bitsToFloat(uint32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Float to IEEE half with round-to-nearest-even; overflow goes to infinity and
+// values below the smallest half subnormal flush to zero
+uint16_t floatToHalf(float value) {
+    uint32_t bits = floatBits(value);
+    const uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+
+    uint32_t half;
+    if (bits >= (143u << 23)) {
+        // Too large for a half (exponent >= 16), infinity or NaN
+        half = bits > (255u << 23) ? 0x7e00u : 0x7c00u;
+    } else if (bits < (113u << 23)) {
+        // Half subnormal or zero: adding 0.5 aligns the mantissa so the FPU does the rounding
+        const uint32_t denormMagic = 126u << 23;
+        half = floatBits(bitsToFloat(bits) + bitsToFloat(denormMagic)) - denormMagic;
+    } else {
+        // Normal: rebias the exponent and round the 13 dropped mantissa bits to even
+        const uint32_t mantissaOdd = (bits >> 13) & 1u;
+        bits -= 112u << 23;
+        bits += 0xfffu + mantissaOdd;
+        half = bits >> 13;
+    }
+    return static_cast<uint16_t>(half | (sign >> 16));
+}
+
+float halfToFloat(uint16_t half) {
+    const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+    const uint32_t exponent = (half >> 10) & 0x1fu;
+    const uint32_t mantissa = half & 0x3ffu;
+    if (exponent == 0x1fu) {
+        return bitsToFloat(sign | 0x7f800000u | (mantissa << 13));
+    }
+    // 2^112 rebiases normals from 15 to 127 and normalizes subnormals
+    float magnitude = bitsToFloat(static_cast<uint32_t>(half & 0x7fffu) << 13) * 5.192296858534828e+33f;
+    return bitsToFloat(floatBits(magnitude) | sign);
+}
+
+// Float to bfloat16 with round-to-nearest-even; NaNs stay quiet NaNs
+uint16_t floatToBFloat16(float value) {
+    uint32_t bits = floatBits(value);
+    if ((bits & 0x7fffffffu) > 0x7f800000u) {
+        return static_cast<uint16_t>((bits >> 16) | 0x40u);
+    }
+    bits += 0x7fffu + ((bits >> 16) & 1u);
+    return static_cast<uint16_t>(bits >> 16);
+}
+
+float bfloat16ToFloat(uint16_t value) {
+    return bitsToFloat(static_cast<uint32_t>(value) << 16);
+}
+
+void floatsToHalf(const float* input, uint16_t* output, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        output[i] = floatToHalf(input[i]);
+    }
+}
+
+void floatsToBFloat16(const float* input, uint16_t* output, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        output[i] = floatToBFloat16(input[i]);
+    }
+}
+
+void quantizeInt8Blocks(const float* input, size_t size, size_t blockSize, Int8Blocks& output) {
+    const size_t blocks = size / blockSize;
+    output.blockSize = blockSize;
+    output.values.resize(blocks * blockSize);
+    output.scales.resize(blocks);
+    for (size_t block = 0; block < blocks; ++block) {
+        const float* values = input + block * blockSize;
+        float maxAbs = 0.0f;
+        for (size_t i = 0; i < blockSize; ++i) {
+            maxAbs = std::max(maxAbs, std::abs(values[i]));
+        }
+        const float scale = maxAbs > 0.0f ? maxAbs / 127.0f : 1.0f;
+        output.scales[block] = scale;
+        for (size_t i = 0; i < blockSize; ++i) {
+            output.values[block * blockSize + i] = static_cast<int8_t>(std::lround(values[i] / scale));
+        }
+    }
+}
+
+// Best of several runs of a dot kernel, in milliseconds
+template<typename Kernel>
+static double timeDot(Kernel kernel, float& result, int repetitions) {
+    double best = 0.0;
+    for (int rep = 0; rep < repetitions; ++rep) {
+        auto start = std::chrono::high_resolution_clock::now();
+        result = kernel();
+        auto end = std::chrono::high_resolution_clock::now();
+        double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+        if (rep == 0 || elapsed < best) {
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+// FP32 compute over FP16, BF16 and INT8 storage: the dot product is memory bound,
+// so halving or quartering the bytes per element should show up as speedup
+static void runReducedPrecisionDots() {
+    std::cout << "\n--- Reduced-Precision Storage, FP32 Compute (dot product) ---" << std::endl;
+
+    const size_t size = 16 * 1024 * 1024;
+    const int repetitions = 10;
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> dis(0.0f, 1.0f);
+    AlignedVector<float> a(size);
+    AlignedVector<float> b(size);
+    for (size_t i = 0; i < size; ++i) {
+        a[i] = dis(gen);
+        b[i] = dis(gen);
+    }
+
+    double reference = 0.0;
+    for (size_t i = 0; i < size; ++i) {
+        reference += static_cast<double>(a[i]) * static_cast<double>(b[i]);
+    }
+
+    AlignedVector<uint16_t> aHalf(size);
+    AlignedVector<uint16_t> bHalf(size);
+    AlignedVector<uint16_t> aBFloat(size);
+    AlignedVector<uint16_t> bBFloat(size);
+    floatsToHalf(a.data(), aHalf.data(), size);
+    floatsToHalf(b.data(), bHalf.data(), size);
+    floatsToBFloat16(a.data(), aBFloat.data(), size);
+    floatsToBFloat16(b.data(), bBFloat.data(), size);
+    Int8Blocks aInt8;
+    Int8Blocks bInt8;
+    quantizeInt8Blocks(a.data(), size, INT8_BLOCK_SIZE, aInt8);
+    quantizeInt8Blocks(b.data(), size, INT8_BLOCK_SIZE, bInt8);
+
+    const SIMDKernelTable& kernels = getSIMDKernels();
+    const char* bfloatPath = nullptr;
+    BFloat16DotFunction bfloatDot = getBFloat16Dot(&bfloatPath);
+    const bool nativeBFloat = std::strcmp(bfloatPath, kernels.name) != 0;
+    const bool hardwareHalf = kernels.level != SIMDLevel::SSE2;
+
+    struct Row {
+        const char* format;
+        const char* path;
+        size_t bytes;
+        double time;
+        float result;
+    };
+    Row rows[4] = {
+        {"FP32", kernels.name, 2 * size * sizeof(float), 0.0, 0.0f},
+        {"FP16", hardwareHalf ? "F16C" : "software", 2 * size * sizeof(uint16_t), 0.0, 0.0f},
+        {"BF16", nativeBFloat ? bfloatPath : "shift + FMA", 2 * size * sizeof(uint16_t), 0.0, 0.0f},
+        {"INT8", "int32 blocks", 2 * (size + aInt8.scales.size() * sizeof(float)), 0.0, 0.0f}
+    };
+    rows[0].time = timeDot([&]() { return kernels.dotFloat(a.data(), b.data(), size); }, rows[0].result, repetitions);
+    rows[1].time = timeDot([&]() { return kernels.dotHalf(aHalf.data(), bHalf.data(), size); }, rows[1].result, repetitions);
+    rows[2].time = timeDot([&]() { return bfloatDot(aBFloat.data(), bBFloat.data(), size); }, rows[2].result, repetitions);
+    rows[3].time = timeDot([&]() {
+        return kernels.dotInt8Blocks(aInt8.values.data(), aInt8.scales.data(),
+                                     bInt8.values.data(), bInt8.scales.data(), size, INT8_BLOCK_SIZE);
+    }, rows[3].result, repetitions);
+
+    std::cout << "Elements: " << size << ", best of " << repetitions << " runs, kernels: " << kernels.name << std::endl;
+    std::cout << std::left << std::setw(8) << "Format" << std::setw(16) << "Conversion"
+              << std::right << std::setw(12) << "Storage MB" << std::setw(12) << "Time (ms)"
+              << std::setw(10) << "GB/s" << std::setw(10) << "Speedup" << std::setw(14) << "Rel. error" << std::endl;
+    std::cout << std::string(82, '-') << std::endl;
+    for (const Row& row : rows) {
+        double relativeError = std::abs(static_cast<double>(row.result) - reference) / std::abs(reference);
+        std::cout << std::left << std::setw(8) << row.format << std::setw(16) << row.path << std::right
+                  << std::fixed << std::setprecision(1) << std::setw(12) << row.bytes / (1024.0 * 1024.0)
+                  << std::setprecision(3) << std::setw(12) << row.time
+                  << std::setprecision(2) << std::setw(10) << row.bytes / (row.time * 1e6)
+                  << std::setw(9) << rows[0].time / row.time << "x"
+                  << std::scientific << std::setprecision(2) << std::setw(14) << relativeError
+                  << std::fixed << std::endl;
+    }
+    std::cout << "Relative error is against a double-precision dot of the FP32 inputs; FP32 itself" << std::endl;
+    std::cout << "only shows accumulation error. FP16 and BF16 add rounding of the stored values" << std::endl;
+    std::cout << "(11 and 8 significant bits), INT8 the quantization step of each block." << std::endl;
+}
+
 // Run mixed precision operations demo
 void runMixedPrecision() {
     std::cout << "\n=== Mixed Precision Operations Demo ===" << std::endl;
@@ -96,10 +293,10 @@ void runMixedPrecision() {
     std::uniform_int_distribution<int> intDis(1, 100);
     
     // Initialize input vectors
-    std::vector<float> floatVec(size);
-    std::vector<int> intVec(size);
-    std::vector<float> result_scalar(size, 0.0f);
-    std::vector<float> result_simd(size, 0.0f);
+    AlignedVector<float> floatVec(size);
+    AlignedVector<int> intVec(size);
+    AlignedVector<float> result_scalar(size, 0.0f);
+    AlignedVector<float> result_simd(size, 0.0f);
     
     // Fill vectors with random values
     for (size_t i = 0; i < size; ++i) {
@@ -144,8 +341,8 @@ void runMixedPrecision() {
     std::cout << "Results verification: " << (mixedResultsMatch ? "PASSED" : "FAILED") << std::endl;
     
     // Temporary vectors for conversion tests
-    std::vector<float> floatResult(size);
-    std::vector<int> intResult(size);
+    AlignedVector<float> floatResult(size);
+    AlignedVector<int> intResult(size);
     
     // Measure int to float conversion performance
     std::cout << "\n--- Integer to Float Conversion ---" << std::endl;
@@ -193,6 +390,9 @@ void runMixedPrecision() {
     std::cout << "SIMD float to int conversion time: " << timeSimdFloatToInt << " ms" << std::endl;
     std::cout << "Speedup: " << speedupFloatToInt << "x" << std::endl;
     
+    // Narrow storage formats
+    runReducedPrecisionDots();
+    
     // Mixed precision explanation
     std::cout << "\n=== Mixed Precision SIMD Explained ===" << std::endl;
     
@@ -211,6 +411,11 @@ void runMixedPrecision() {
     std::cout << "   - Minimize conversions by using consistent types where possible" << std::endl;
     std::cout << "   - Different rounding modes can affect float-to-int conversions" << std::endl;
     
+    std::cout << "\n4. Reduced-Precision Storage:" << std::endl;
+    std::cout << "   - FP16/BF16 halve and INT8 quarters the bytes read per element" << std::endl;
+    std::cout << "   - Widening to FP32 on load (F16C, a shift for BF16) keeps the math accurate" << std::endl;
+    std::cout << "   - Bandwidth-bound loops gain more from fewer bytes than they lose to conversions" << std::endl;
+    
     std::cout << "\nBest Practices:" << std::endl;
     std::cout << "- Use the same data type within a SIMD loop when possible" << std::endl;
     std::cout << "- If conversions are necessary, batch them together" << std::endl;
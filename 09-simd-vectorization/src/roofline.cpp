@@ -0,0 +1,361 @@
+#include "../include/roofline.h"
+#include "../include/simd_dispatch.h"
+#include "../include/cpu_features.h"
+#include "aligned_allocator.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <omp.h>
+
+// Register-only loop length; about 1-6 GFLOP per call depending on the ISA
+static const size_t PEAK_ITERATIONS = 20000000;
+static const int PEAK_REPETITIONS = 3;
+static const int TRIAD_REPETITIONS = 5;
+
+// Best-of-N GFLOP/s of a peak kernel, on one thread or on every thread at once
+template<typename Kernel>
+static double measurePeakGflops(Kernel kernel, bool allThreads) {
+    double best = 0.0;
+    for (int rep = 0; rep < PEAK_REPETITIONS; ++rep) {
+        double totalFlops = 0.0;
+        double sink = 0.0;
+        auto start = std::chrono::high_resolution_clock::now();
+        if (allThreads) {
+            #pragma omp parallel reduction(+:totalFlops, sink)
+            {
+                double flops = 0.0;
+                sink += kernel(PEAK_ITERATIONS, flops);
+                totalFlops += flops;
+            }
+        } else {
+            double flops = 0.0;
+            sink = kernel(PEAK_ITERATIONS, flops);
+            totalFlops = flops;
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+        // The sink is always finite; the check only keeps the result alive
+        if (std::isfinite(sink)) {
+            best = std::max(best, totalFlops / seconds * 1e-9);
+        }
+    }
+    return best;
+}
+
+// STREAM triad bandwidth in GB/s, counting 3 x 8 bytes per element like STREAM does
+static double measureTriadBandwidth(size_t elements, bool allThreads) {
+    AlignedVector<double> a(elements);
+    AlignedVector<double> b(elements);
+    AlignedVector<double> c(elements);
+    const long long n = static_cast<long long>(elements);
+    double* __restrict pa = a.data();
+    const double* __restrict pb = b.data();
+    const double* __restrict pc = c.data();
+    const double scalar = 3.0;
+
+    // Touch the pages from the threads that use them
+    #pragma omp parallel for schedule(static) if(allThreads)
+    for (long long i = 0; i < n; ++i) {
+        a[i] = 0.0;
+        b[i] = 1.0;
+        c[i] = 2.0;
+    }
+
+    double best = 0.0;
+    for (int rep = 0; rep < TRIAD_REPETITIONS; ++rep) {
+        auto start = std::chrono::high_resolution_clock::now();
+        if (allThreads) {
+            #pragma omp parallel for schedule(static)
+            for (long long i = 0; i < n; ++i) {
+                pa[i] = pb[i] + scalar * pc[i];
+            }
+        } else {
+            #pragma omp simd
+            for (long long i = 0; i < n; ++i) {
+                pa[i] = pb[i] + scalar * pc[i];
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+        best = std::max(best, 3.0 * sizeof(double) * elements / seconds * 1e-9);
+    }
+    return best;
+}
+
+const MachinePeaks& getMachinePeaks() {
+    static const MachinePeaks peaks = []() {
+        const SIMDKernelTable& kernels = getSIMDKernels();
+        MachinePeaks measured;
+        measured.kernelName = kernels.name;
+        measured.threads = omp_get_max_threads();
+        measured.gflopsFloat = measurePeakGflops(kernels.peakFlopsFloat, false);
+        measured.gflopsDouble = measurePeakGflops(kernels.peakFlopsDouble, false);
+        measured.gflopsFloatAll = measurePeakGflops(kernels.peakFlopsFloat, true);
+        measured.gflopsDoubleAll = measurePeakGflops(kernels.peakFlopsDouble, true);
+
+        // Each array at least four times the last-level cache (32-128 MB), so the
+        // triad streams from DRAM instead of a cache level
+        const size_t arrayBytes = std::min<size_t>(std::max<size_t>(4 * getLastLevelCacheSize(), 32u << 20), 128u << 20);
+        const size_t elements = arrayBytes / sizeof(double);
+        measured.bandwidthGBs = measureTriadBandwidth(elements, false);
+        measured.bandwidthGBsAll = measureTriadBandwidth(elements, true);
+        return measured;
+    }();
+    return peaks;
+}
+
+void displayMachinePeaks(const MachinePeaks& peaks) {
+    std::cout << "\n=== Machine Ceilings (roofline) ===" << std::endl;
+    std::cout << "Measured with the " << peaks.kernelName << " kernels" << std::endl;
+    std::cout << std::left << std::setw(22) << "" << std::right << std::setw(14) << "1 thread"
+              << std::setw(14) << ("all (" + std::to_string(peaks.threads) + ")") << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::left << std::setw(22) << "Peak FP32 (GFLOP/s)" << std::right << std::setw(14) << peaks.gflopsFloat
+              << std::setw(14) << peaks.gflopsFloatAll << std::endl;
+    std::cout << std::left << std::setw(22) << "Peak FP64 (GFLOP/s)" << std::right << std::setw(14) << peaks.gflopsDouble
+              << std::setw(14) << peaks.gflopsDoubleAll << std::endl;
+    std::cout << std::left << std::setw(22) << "Triad (GB/s)" << std::right << std::setw(14) << peaks.bandwidthGBs
+              << std::setw(14) << peaks.bandwidthGBsAll << std::endl;
+    std::cout << "Ridge point (FP64, 1 thread): " << peaks.gflopsDouble / peaks.bandwidthGBs << " FLOP/byte" << std::endl;
+}
+
+// Ceilings for a benchmark's precision and thread count
+static double peakFor(const BenchmarkResult& result, const MachinePeaks& peaks) {
+    if (result.threads > 1) {
+        return result.doublePrecision ? peaks.gflopsDoubleAll : peaks.gflopsFloatAll;
+    }
+    return result.doublePrecision ? peaks.gflopsDouble : peaks.gflopsFloat;
+}
+
+static double bandwidthFor(const BenchmarkResult& result, const MachinePeaks& peaks) {
+    return result.threads > 1 ? peaks.bandwidthGBsAll : peaks.bandwidthGBs;
+}
+
+double arithmeticIntensity(const BenchmarkResult& result) {
+    return result.bytes > 0.0 ? result.flops / result.bytes : 0.0;
+}
+
+double achievedGflops(const BenchmarkResult& result) {
+    return result.timeVectorized > 0.0 ? result.flops / (result.timeVectorized * 1e6) : 0.0;
+}
+
+double attainableGflops(const BenchmarkResult& result, const MachinePeaks& peaks) {
+    return std::min(peakFor(result, peaks), arithmeticIntensity(result) * bandwidthFor(result, peaks));
+}
+
+bool isMemoryBound(const BenchmarkResult& result, const MachinePeaks& peaks) {
+    return arithmeticIntensity(result) < peakFor(result, peaks) / bandwidthFor(result, peaks);
+}
+
+// What to try next for a kernel, from where it sits under its roof
+static std::string rooflineAdvice(const BenchmarkResult& result, const MachinePeaks& peaks) {
+    double efficiency = achievedGflops(result) / attainableGflops(result, peaks);
+    if (isMemoryBound(result, peaks)) {
+        return efficiency > 0.5 ? "cut memory traffic (fusion, narrower types, blocking)"
+                                : "memory bound but far below bandwidth: check access pattern";
+    }
+    return efficiency > 0.5 ? "near compute peak: reduce FLOPs"
+                            : "compute bound: more vectorization/ILP headroom";
+}
+
+static std::vector<const BenchmarkResult*> rooflineEntries(const std::vector<BenchmarkResult>& results) {
+    std::vector<const BenchmarkResult*> entries;
+    for (const auto& result : results) {
+        if (result.flops > 0.0 && result.bytes > 0.0 && result.timeVectorized > 0.0) {
+            entries.push_back(&result);
+        }
+    }
+    return entries;
+}
+
+void displayRoofline(const std::vector<BenchmarkResult>& results, const MachinePeaks& peaks) {
+    std::cout << "\n=== Roofline Placement ===" << std::endl;
+    std::cout << std::left << std::setw(30) << "Benchmark" << std::right << std::setw(10) << "FLOP/B"
+              << std::setw(12) << "GFLOP/s" << std::setw(12) << "Roof" << std::setw(8) << "Eff."
+              << "  " << std::left << std::setw(8) << "Bound" << "Next step" << std::endl;
+    std::cout << std::string(110, '-') << std::endl;
+    for (const BenchmarkResult* result : rooflineEntries(results)) {
+        double attainable = attainableGflops(*result, peaks);
+        std::cout << std::left << std::setw(30) << result->name << std::right << std::fixed
+                  << std::setprecision(3) << std::setw(10) << arithmeticIntensity(*result)
+                  << std::setprecision(2) << std::setw(12) << achievedGflops(*result)
+                  << std::setw(12) << attainable
+                  << std::setprecision(0) << std::setw(7) << 100.0 * achievedGflops(*result) / attainable << "%"
+                  << "  " << std::left << std::setw(8) << (isMemoryBound(*result, peaks) ? "memory" : "compute")
+                  << rooflineAdvice(*result, peaks) << std::endl;
+    }
+    std::cout << "Roof = min(peak, intensity x bandwidth) for the benchmark's precision and threads" << std::endl;
+}
+
+void writeRooflineCSV(const std::vector<BenchmarkResult>& results, const MachinePeaks& peaks, const std::string& filename) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << " for writing." << std::endl;
+        return;
+    }
+
+    file << "# kernels," << peaks.kernelName << ",threads," << peaks.threads << std::endl;
+    file << "# peak_fp32_gflops," << peaks.gflopsFloat << ",peak_fp64_gflops," << peaks.gflopsDouble
+         << ",bandwidth_gbs," << peaks.bandwidthGBs << std::endl;
+    file << "# peak_fp32_gflops_all," << peaks.gflopsFloatAll << ",peak_fp64_gflops_all," << peaks.gflopsDoubleAll
+         << ",bandwidth_gbs_all," << peaks.bandwidthGBsAll << std::endl;
+    file << "benchmark,precision,threads,flops,bytes,intensity,time_ms,gflops,gbs,roof_gflops,efficiency,bound" << std::endl;
+    for (const BenchmarkResult* result : rooflineEntries(results)) {
+        double attainable = attainableGflops(*result, peaks);
+        file << '"' << result->name << '"' << ',' << (result->doublePrecision ? "fp64" : "fp32") << ','
+             << result->threads << ',' << result->flops << ',' << result->bytes << ','
+             << arithmeticIntensity(*result) << ',' << result->timeVectorized << ','
+             << achievedGflops(*result) << ',' << result->bytes / (result->timeVectorized * 1e6) << ','
+             << attainable << ',' << achievedGflops(*result) / attainable << ','
+             << (isMemoryBound(*result, peaks) ? "memory" : "compute") << std::endl;
+    }
+
+    std::cout << "Roofline data written to " << filename << std::endl;
+}
+
+// Plot area of the SVG roofline, in pixels
+static const double PLOT_LEFT = 70.0;
+static const double PLOT_TOP = 20.0;
+static const double PLOT_WIDTH = 640.0;
+static const double PLOT_HEIGHT = 400.0;
+
+struct LogAxis {
+    double minDecade;
+    double maxDecade;
+    double pixelStart;
+    double pixelLength;
+    bool flipped;  // SVG y grows downwards
+
+    double map(double value) const {
+        double t = (std::log10(value) - minDecade) / (maxDecade - minDecade);
+        return flipped ? pixelStart + pixelLength * (1.0 - t) : pixelStart + pixelLength * t;
+    }
+};
+
+static std::string escapeHTML(const std::string& text) {
+    std::string escaped;
+    for (char ch : text) {
+        switch (ch) {
+            case '<': escaped += "&lt;"; break;
+            case '>': escaped += "&gt;"; break;
+            case '&': escaped += "&amp;"; break;
+            case '"': escaped += "&quot;"; break;
+            default: escaped += ch;
+        }
+    }
+    return escaped;
+}
+
+// One roof: the bandwidth slope up to the ridge point, then the flat peak
+static void writeRoof(std::ostream& svg, const LogAxis& x, const LogAxis& y, double peak, double bandwidth,
+                      const char* color, const std::string& label) {
+    double xMin = std::pow(10.0, x.minDecade);
+    double xMax = std::pow(10.0, x.maxDecade);
+    double ridge = peak / bandwidth;
+    svg << "<polyline fill=\"none\" stroke=\"" << color << "\" stroke-width=\"2\" points=\""
+        << x.map(xMin) << ',' << y.map(std::max(xMin * bandwidth, std::pow(10.0, y.minDecade))) << ' '
+        << x.map(ridge) << ',' << y.map(peak) << ' ' << x.map(xMax) << ',' << y.map(peak) << "\"/>\n";
+    svg << "<text x=\"" << x.map(xMax) - 4 << "\" y=\"" << y.map(peak) - 5 << "\" text-anchor=\"end\" fill=\""
+        << color << "\">" << escapeHTML(label) << "</text>\n";
+}
+
+void writeRooflineHTML(const std::vector<BenchmarkResult>& results, const MachinePeaks& peaks, const std::string& filename) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << " for writing." << std::endl;
+        return;
+    }
+
+    std::vector<const BenchmarkResult*> entries = rooflineEntries(results);
+
+    // Axis ranges in whole decades around the ceilings and the points
+    double minIntensity = 1.0 / 64.0;
+    double maxIntensity = 64.0;
+    double minGflops = peaks.bandwidthGBs * minIntensity;
+    double maxGflops = std::max(peaks.gflopsFloat, peaks.gflopsFloatAll);
+    for (const BenchmarkResult* result : entries) {
+        minIntensity = std::min(minIntensity, arithmeticIntensity(*result));
+        maxIntensity = std::max(maxIntensity, arithmeticIntensity(*result));
+        minGflops = std::min(minGflops, achievedGflops(*result));
+    }
+    LogAxis x = {std::floor(std::log10(minIntensity)), std::ceil(std::log10(maxIntensity)), PLOT_LEFT, PLOT_WIDTH, false};
+    LogAxis y = {std::floor(std::log10(minGflops)), std::ceil(std::log10(maxGflops * 1.5)), PLOT_TOP, PLOT_HEIGHT, true};
+
+    std::ostringstream svg;
+    svg << std::fixed << std::setprecision(1);
+    svg << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << PLOT_LEFT + PLOT_WIDTH + 20
+        << "\" height=\"" << PLOT_TOP + PLOT_HEIGHT + 50 << "\" font-family=\"sans-serif\" font-size=\"12\">\n";
+    svg << "<rect x=\"" << PLOT_LEFT << "\" y=\"" << PLOT_TOP << "\" width=\"" << PLOT_WIDTH << "\" height=\""
+        << PLOT_HEIGHT << "\" fill=\"none\" stroke=\"#444\"/>\n";
+    for (double decade = x.minDecade; decade <= x.maxDecade; decade += 1.0) {
+        double px = x.map(std::pow(10.0, decade));
+        svg << "<line x1=\"" << px << "\" y1=\"" << PLOT_TOP << "\" x2=\"" << px << "\" y2=\"" << PLOT_TOP + PLOT_HEIGHT
+            << "\" stroke=\"#ddd\"/>\n";
+        svg << "<text x=\"" << px << "\" y=\"" << PLOT_TOP + PLOT_HEIGHT + 16 << "\" text-anchor=\"middle\">1e"
+            << static_cast<int>(decade) << "</text>\n";
+    }
+    for (double decade = y.minDecade; decade <= y.maxDecade; decade += 1.0) {
+        double py = y.map(std::pow(10.0, decade));
+        svg << "<line x1=\"" << PLOT_LEFT << "\" y1=\"" << py << "\" x2=\"" << PLOT_LEFT + PLOT_WIDTH << "\" y2=\"" << py
+            << "\" stroke=\"#ddd\"/>\n";
+        svg << "<text x=\"" << PLOT_LEFT - 6 << "\" y=\"" << py + 4 << "\" text-anchor=\"end\">1e"
+            << static_cast<int>(decade) << "</text>\n";
+    }
+    svg << "<text x=\"" << PLOT_LEFT + PLOT_WIDTH / 2 << "\" y=\"" << PLOT_TOP + PLOT_HEIGHT + 36
+        << "\" text-anchor=\"middle\">Arithmetic intensity (FLOP/byte)</text>\n";
+    svg << "<text transform=\"rotate(-90)\" x=\"" << -(PLOT_TOP + PLOT_HEIGHT / 2) << "\" y=\"18\" text-anchor=\"middle\">GFLOP/s</text>\n";
+
+    std::ostringstream label;
+    label << std::fixed << std::setprecision(1);
+    label << "FP32 " << peaks.gflopsFloat << " GFLOP/s, " << peaks.bandwidthGBs << " GB/s";
+    writeRoof(svg, x, y, peaks.gflopsFloat, peaks.bandwidthGBs, "#1f77b4", label.str());
+    label.str("");
+    label << "FP64 " << peaks.gflopsDouble << " GFLOP/s";
+    writeRoof(svg, x, y, peaks.gflopsDouble, peaks.bandwidthGBs, "#ff7f0e", label.str());
+    if (peaks.threads > 1) {
+        label.str("");
+        label << "FP32, " << peaks.threads << " threads";
+        writeRoof(svg, x, y, peaks.gflopsFloatAll, peaks.bandwidthGBsAll, "#2ca02c", label.str());
+    }
+
+    int index = 1;
+    for (const BenchmarkResult* result : entries) {
+        double px = x.map(arithmeticIntensity(*result));
+        double py = y.map(achievedGflops(*result));
+        svg << "<circle cx=\"" << px << "\" cy=\"" << py << "\" r=\"5\" fill=\""
+            << (isMemoryBound(*result, peaks) ? "#d62728" : "#9467bd") << "\"><title>"
+            << escapeHTML(result->name) << "</title></circle>\n";
+        svg << "<text x=\"" << px + 7 << "\" y=\"" << py + 4 << "\">" << index++ << "</text>\n";
+    }
+    svg << "</svg>\n";
+
+    file << "<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"utf-8\">\n"
+         << "<title>OpenMP SIMD Vectorization Roofline</title>\n"
+         << "<style>body{font-family:sans-serif;margin:2em}table{border-collapse:collapse}"
+         << "td,th{border:1px solid #ccc;padding:4px 8px;text-align:right}td:nth-child(2),td:last-child{text-align:left}</style>\n"
+         << "</head>\n<body>\n<h1>Roofline: OpenMP SIMD Vectorization Benchmarks</h1>\n";
+    file << "<p>Ceilings measured with the " << escapeHTML(peaks.kernelName) << " kernels: register-only FMA chains for "
+         << "peak FLOP/s, a STREAM triad for bandwidth. Red points are memory bound (left of their ridge point), "
+         << "purple points compute bound.</p>\n";
+    file << svg.str();
+    file << "<table>\n<tr><th>#</th><th>Benchmark</th><th>FLOP/byte</th><th>GFLOP/s</th><th>Roof GFLOP/s</th>"
+         << "<th>Efficiency</th><th>Bound</th><th>Next step</th></tr>\n";
+    file << std::fixed;
+    index = 1;
+    for (const BenchmarkResult* result : entries) {
+        double attainable = attainableGflops(*result, peaks);
+        file << "<tr><td>" << index++ << "</td><td>" << escapeHTML(result->name) << "</td><td>"
+             << std::setprecision(3) << arithmeticIntensity(*result) << "</td><td>" << std::setprecision(2)
+             << achievedGflops(*result) << "</td><td>" << attainable << "</td><td>" << std::setprecision(0)
+             << 100.0 * achievedGflops(*result) / attainable << "%</td><td>"
+             << (isMemoryBound(*result, peaks) ? "memory" : "compute") << "</td><td>"
+             << escapeHTML(rooflineAdvice(*result, peaks)) << "</td></tr>\n";
+    }
+    file << "</table>\n</body>\n</html>\n";
+
+    std::cout << "Roofline plot written to " << filename << std::endl;
+}
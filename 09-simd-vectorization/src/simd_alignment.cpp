@@ -7,28 +7,7 @@
 #include <random>
 #include <omp.h>
 #include <memory>
-
-// Aligned memory allocation function - allocates memory aligned to the specified boundary
-template<typename T>
-T* alignedAlloc(size_t size, size_t alignment) {
-#ifdef _WIN32
-    return static_cast<T*>(_aligned_malloc(size * sizeof(T), alignment));
-#else
-    T* ptr = nullptr;
-    posix_memalign(reinterpret_cast<void**>(&ptr), alignment, size * sizeof(T));
-    return ptr;
-#endif
-}
-
-// Aligned memory deallocation
-template<typename T>
-void alignedFree(T* ptr) {
-#ifdef _WIN32
-    _aligned_free(ptr);
-#else
-    free(ptr);
-#endif
-}
+#include "aligned_allocator.h"
 
 // Unaligned vector operation
 void unalignedVectorOperation(const float* a, const float* b, float* c, int size) {
@@ -40,11 +19,10 @@ void unalignedVectorOperation(const float* a, const float* b, float* c, int size
 
 // Aligned vector operation with alignment hint for the compiler
 void alignedVectorOperation(const float* __restrict a, const float* __restrict b, float* __restrict c, int size) {
-    // Tell the compiler the arrays are aligned (alignment value depends on SIMD width)
-    int alignmentBytes = getOptimalSIMDWidth() / 8; // Convert bits to bytes
-    
+    // Tell the compiler the arrays are aligned; the clause needs a constant, and
+    // alignedVsUnaligned allocates on 64 bytes, which covers every SIMD width
     // Use a simple operation that benefits from aligned loads/stores
-    #pragma omp simd aligned(a, b, c: alignmentBytes)
+    #pragma omp simd aligned(a, b, c: 64)
     for (int i = 0; i < size; ++i) {
         c[i] = a[i] * b[i] + a[i];
     }
@@ -53,21 +31,18 @@ void alignedVectorOperation(const float* __restrict a, const float* __restrict b
 // Function to compare aligned vs unaligned memory access
 void alignedVsUnaligned(bool useAligned) {
     const int size = 50000000; // 50 million elements
-    const size_t alignment = 64;  // Align to 64-byte boundary (AVX-512 register size)
+    const size_t alignment = SIMD_ALIGNMENT;  // 64-byte boundary (AVX-512 register size)
     
-    float *a, *b, *c;
+    // One spare element lets the unaligned run start a float past the boundary,
+    // so every vector load and store straddles it regardless of the allocator
+    AlignedVector<float> bufferA(size + 1);
+    AlignedVector<float> bufferB(size + 1);
+    AlignedVector<float> bufferC(size + 1);
     
-    if (useAligned) {
-        // Allocate aligned memory
-        a = alignedAlloc<float>(size, alignment);
-        b = alignedAlloc<float>(size, alignment);
-        c = alignedAlloc<float>(size, alignment);
-    } else {
-        // Use standard allocation (potentially unaligned)
-        a = new float[size];
-        b = new float[size];
-        c = new float[size];
-    }
+    const int offset = useAligned ? 0 : 1;
+    float* a = bufferA.data() + offset;
+    float* b = bufferB.data() + offset;
+    float* c = bufferC.data() + offset;
     
     // Initialize with random data
     std::random_device rd;
@@ -97,19 +72,8 @@ void alignedVsUnaligned(bool useAligned) {
     double executionTime = std::chrono::duration<double, std::milli>(end - start).count();
     
     // Print results
-    std::cout << "Memory alignment: " << (useAligned ? "Aligned to " + std::to_string(alignment) + " bytes" : "Unaligned") << std::endl;
+    std::cout << "Memory alignment: " << (useAligned ? "Aligned to " + std::to_string(alignment) + " bytes" : "Unaligned (offset by 4 bytes)") << std::endl;
     std::cout << "Execution time: " << executionTime << " ms" << std::endl;
-    
-    // Free memory
-    if (useAligned) {
-        alignedFree(a);
-        alignedFree(b);
-        alignedFree(c);
-    } else {
-        delete[] a;
-        delete[] b;
-        delete[] c;
-    }
 }
 
 // Run SIMD alignment demo
@@ -153,7 +117,7 @@ void runSIMDAlignment() {
     std::cout << "- AVX-512 (512-bit): 64-byte alignment" << std::endl;
     
     std::cout << "\nHow to ensure proper alignment:" << std::endl;
-    std::cout << "1. Use aligned memory allocation (as demonstrated)" << std::endl;
+    std::cout << "1. Use aligned memory allocation (AlignedVector<T> in aligned_allocator.h)" << std::endl;
     std::cout << "2. Provide alignment hints to the compiler with directives" << std::endl;
     std::cout << "3. For dynamic arrays, ensure the starting address is properly aligned" << std::endl;
     
@@ -0,0 +1,96 @@
+#include "../include/simd_dispatch.h"
+#include "../include/cpu_features.h"
+
+// Per-ISA tables, defined in simd_kernels_*.cpp
+extern const SIMDKernelTable g_sse2Kernels;
+extern const SIMDKernelTable g_avx2Kernels;
+extern const SIMDKernelTable g_avx512Kernels;
+
+// Check whether the CPU (and OS) can run a level
+static bool isLevelSupported(SIMDLevel level) {
+    const CPUFeatures& features = getCPUFeatures();
+    switch (level) {
+        case SIMDLevel::SSE2:
+            // SSE2 is the x86-64 baseline; on other targets the SSE2 unit is a generic build
+            return true;
+        case SIMDLevel::AVX2:
+            // The AVX2 unit is also built with F16C, which every AVX2 CPU has
+            return features.hasAVX2 && features.hasFMA && features.hasF16C;
+        case SIMDLevel::AVX512:
+            return features.hasAVX512F && features.hasAVX2 && features.hasFMA && features.hasF16C;
+    }
+    return false;
+}
+
+const SIMDKernelTable* getSIMDKernelsFor(SIMDLevel level) {
+    if (!isLevelSupported(level)) {
+        return nullptr;
+    }
+    switch (level) {
+        case SIMDLevel::SSE2:
+            return &g_sse2Kernels;
+        case SIMDLevel::AVX2:
+            return &g_avx2Kernels;
+        case SIMDLevel::AVX512:
+            return &g_avx512Kernels;
+    }
+    return nullptr;
+}
+
+const SIMDKernelTable& getSIMDKernels() {
+    // Chosen once; later calls are a single load
+    static const SIMDKernelTable* selected = []() {
+        for (SIMDLevel level : {SIMDLevel::AVX512, SIMDLevel::AVX2}) {
+            if (const SIMDKernelTable* table = getSIMDKernelsFor(level)) {
+                return table;
+            }
+        }
+        return &g_sse2Kernels;
+    }();
+    return *selected;
+}
+
+std::vector<const SIMDKernelTable*> getSupportedSIMDKernels() {
+    std::vector<const SIMDKernelTable*> tables;
+    for (SIMDLevel level : {SIMDLevel::SSE2, SIMDLevel::AVX2, SIMDLevel::AVX512}) {
+        if (const SIMDKernelTable* table = getSIMDKernelsFor(level)) {
+            tables.push_back(table);
+        }
+    }
+    return tables;
+}
+
+#ifdef SIMD_HAVE_AVX512BF16_KERNELS
+// Defined in simd_kernels_avx512bf16.cpp, only built when the compiler supports it
+float dotBFloat16Native(const uint16_t* a, const uint16_t* b, size_t size);
+#endif
+
+BFloat16DotFunction getBFloat16Dot(const char** name) {
+#ifdef SIMD_HAVE_AVX512BF16_KERNELS
+    if (getCPUFeatures().hasAVX512BF16) {
+        if (name != nullptr) {
+            *name = "AVX512-BF16";
+        }
+        return dotBFloat16Native;
+    }
+#endif
+    const SIMDKernelTable& kernels = getSIMDKernels();
+    if (name != nullptr) {
+        *name = kernels.name;
+    }
+    return kernels.dotBFloat16;
+}
+
+bool useStreamingStores(size_t workingSetBytes) {
+    return workingSetBytes > getLastLevelCacheSize();
+}
+
+SIMDLevel simdLevelForWidth(int registerBits) {
+    if (registerBits >= 512) {
+        return SIMDLevel::AVX512;
+    }
+    if (registerBits >= 256) {
+        return SIMDLevel::AVX2;
+    }
+    return SIMDLevel::SSE2;
+}
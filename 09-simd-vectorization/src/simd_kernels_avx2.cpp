@@ -0,0 +1,26 @@
+// AVX2 build of the dispatched kernels; CMakeLists.txt compiles this file with
+// the AVX2 target flags, so only call it through getSIMDKernels().
+#include "../include/simd_dispatch.h"
+
+#define SIMD_KERNEL_NAMESPACE simd_avx2
+#include "../include/simd_kernel_bodies.h"
+#undef SIMD_KERNEL_NAMESPACE
+
+extern const SIMDKernelTable g_avx2Kernels = {
+    SIMDLevel::AVX2,
+    "AVX2",
+    256,
+    simd_avx2::addDouble,
+    simd_avx2::multiplyFloat,
+    simd_avx2::reduceFloat,
+    simd_avx2::widthOperation,
+    {simd_avx2::widthOperationLanes<4>, simd_avx2::widthOperationLanes<8>, simd_avx2::widthOperationLanes<16>},
+    simd_avx2::addDoubleStream,
+    simd_avx2::multiplyFloatStream,
+    simd_avx2::dotFloat,
+    simd_avx2::dotHalf,
+    simd_avx2::dotBFloat16,
+    simd_avx2::dotInt8Blocks,
+    simd_avx2::peakFlopsFloat,
+    simd_avx2::peakFlopsDouble
+};
@@ -0,0 +1,26 @@
+// AVX-512 build of the dispatched kernels; CMakeLists.txt compiles this file with
+// the AVX-512 target flags, so only call it through getSIMDKernels().
+#include "../include/simd_dispatch.h"
+
+#define SIMD_KERNEL_NAMESPACE simd_avx512
+#include "../include/simd_kernel_bodies.h"
+#undef SIMD_KERNEL_NAMESPACE
+
+extern const SIMDKernelTable g_avx512Kernels = {
+    SIMDLevel::AVX512,
+    "AVX-512",
+    512,
+    simd_avx512::addDouble,
+    simd_avx512::multiplyFloat,
+    simd_avx512::reduceFloat,
+    simd_avx512::widthOperation,
+    {simd_avx512::widthOperationLanes<4>, simd_avx512::widthOperationLanes<8>, simd_avx512::widthOperationLanes<16>},
+    simd_avx512::addDoubleStream,
+    simd_avx512::multiplyFloatStream,
+    simd_avx512::dotFloat,
+    simd_avx512::dotHalf,
+    simd_avx512::dotBFloat16,
+    simd_avx512::dotInt8Blocks,
+    simd_avx512::peakFlopsFloat,
+    simd_avx512::peakFlopsDouble
+};
@@ -0,0 +1,28 @@
+// AVX512-BF16 dot product; CMakeLists.txt adds this file (with -mavx512bf16) only
+// when the compiler supports the flag, so only call it through getBFloat16Dot().
+#include "../include/simd_dispatch.h"
+
+#include <immintrin.h>
+
+float dotBFloat16Native(const uint16_t* a, const uint16_t* b, size_t size) {
+    // vdpbf16ps multiplies pairs of bfloat16 values and accumulates each pair into
+    // one FP32 lane, so a 512-bit step consumes 32 elements of each input
+    __m512 acc = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m512bh va = (__m512bh)_mm512_loadu_si512(a + i);
+        __m512bh vb = (__m512bh)_mm512_loadu_si512(b + i);
+        acc = _mm512_dpbf16_ps(acc, va, vb);
+    }
+    float sum = _mm512_reduce_add_ps(acc);
+    for (; i < size; ++i) {
+        uint32_t aBits = static_cast<uint32_t>(a[i]) << 16;
+        uint32_t bBits = static_cast<uint32_t>(b[i]) << 16;
+        float aValue;
+        float bValue;
+        __builtin_memcpy(&aValue, &aBits, sizeof(aValue));
+        __builtin_memcpy(&bValue, &bBits, sizeof(bValue));
+        sum += aValue * bValue;
+    }
+    return sum;
+}
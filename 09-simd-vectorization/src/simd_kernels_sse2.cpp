@@ -0,0 +1,26 @@
+// SSE2 build of the dispatched kernels; CMakeLists.txt compiles this file with
+// the SSE2 target flags, so only call it through getSIMDKernels().
+#include "../include/simd_dispatch.h"
+
+#define SIMD_KERNEL_NAMESPACE simd_sse2
+#include "../include/simd_kernel_bodies.h"
+#undef SIMD_KERNEL_NAMESPACE
+
+extern const SIMDKernelTable g_sse2Kernels = {
+    SIMDLevel::SSE2,
+    "SSE2",
+    128,
+    simd_sse2::addDouble,
+    simd_sse2::multiplyFloat,
+    simd_sse2::reduceFloat,
+    simd_sse2::widthOperation,
+    {simd_sse2::widthOperationLanes<4>, simd_sse2::widthOperationLanes<8>, simd_sse2::widthOperationLanes<16>},
+    simd_sse2::addDoubleStream,
+    simd_sse2::multiplyFloatStream,
+    simd_sse2::dotFloat,
+    simd_sse2::dotHalf,
+    simd_sse2::dotBFloat16,
+    simd_sse2::dotInt8Blocks,
+    simd_sse2::peakFlopsFloat,
+    simd_sse2::peakFlopsDouble
+};
@@ -1,6 +1,7 @@
 #define _USE_MATH_DEFINES
 #include <cmath>
 #include "../include/simd_examples.h"
+#include "../include/vector_expr.h"
 #include <iostream>
 #include <vector>
 #include <chrono>
@@ -8,10 +9,11 @@
 #include <random>
 #include <omp.h>
 #include <limits>
+#include <algorithm>
 
 // Sequential operation (no parallelism, no SIMD)
-void sequentialOperation(const std::vector<double>& a, const std::vector<double>& b, 
-                        std::vector<double>& c) {
+void sequentialOperation(const AlignedVector<double>& a, const AlignedVector<double>& b, 
+                        AlignedVector<double>& c) {
     const size_t size = a.size();
     for (size_t i = 0; i < size; ++i) {
         double x = a[i];
@@ -28,8 +30,8 @@ void sequentialOperation(const std::vector<double>& a, const std::vector<double>
 }
 
 // SIMD-only operation (vectorization but no thread parallelism)
-void simdOnlyOperation(const std::vector<double>& a, const std::vector<double>& b, 
-                      std::vector<double>& c) {
+void simdOnlyOperation(const AlignedVector<double>& a, const AlignedVector<double>& b, 
+                      AlignedVector<double>& c) {
     const size_t size = a.size();
     
     #pragma omp simd
@@ -47,8 +49,8 @@ void simdOnlyOperation(const std::vector<double>& a, const std::vector<double>&
 }
 
 // Thread-parallel-only operation (no explicit vectorization)
-void parallelOnlyOperation(const std::vector<double>& a, const std::vector<double>& b, 
-                          std::vector<double>& c, int numThreads) {
+void parallelOnlyOperation(const AlignedVector<double>& a, const AlignedVector<double>& b, 
+                          AlignedVector<double>& c, int numThreads) {
     const size_t size = a.size();
     
     #pragma omp parallel for num_threads(numThreads)
@@ -66,8 +68,8 @@ void parallelOnlyOperation(const std::vector<double>& a, const std::vector<doubl
 }
 
 // Combined SIMD and thread parallelism (separate directives for OpenMP 2.0 compatibility)
-void simdParallelOperation(const std::vector<double>& a, const std::vector<double>& b, 
-                          std::vector<double>& c, int numThreads) {
+void simdParallelOperation(const AlignedVector<double>& a, const AlignedVector<double>& b, 
+                          AlignedVector<double>& c, int numThreads) {
     const size_t size = a.size();
     
     // In OpenMP 2.0 we can't use combined "parallel for simd", so we use nested directives
@@ -91,9 +93,9 @@ void simdParallelOperation(const std::vector<double>& a, const std::vector<doubl
 // SIMD with threads function exposed to other modules
 void simdWithThreads(int numThreads, size_t vectorSize) {
     // Initialize vectors
-    std::vector<double> a(vectorSize);
-    std::vector<double> b(vectorSize);
-    std::vector<double> c(vectorSize);
+    AlignedVector<double> a(vectorSize);
+    AlignedVector<double> b(vectorSize);
+    AlignedVector<double> c(vectorSize);
     
     // Initialize with random data
     std::random_device rd;
@@ -155,6 +157,100 @@ void simdWithThreads(int numThreads, size_t vectorSize) {
     std::cout << "Actual combined efficiency: " << actualEfficiency << "%" << std::endl;
 }
 
+// One pass of c = a op b, the way a pipeline of separate kernels runs
+static void multiplyPass(const double* a, const double* b, double* c, int size) {
+    #pragma omp parallel for
+    for (int i = 0; i < size; ++i) {
+        c[i] = a[i] * b[i];
+    }
+}
+
+static void scalePass(const double* a, double k, double* c, int size) {
+    #pragma omp parallel for
+    for (int i = 0; i < size; ++i) {
+        c[i] = a[i] * k;
+    }
+}
+
+static void addPass(const double* a, const double* b, double* c, int size) {
+    #pragma omp parallel for
+    for (int i = 0; i < size; ++i) {
+        c[i] = a[i] + b[i];
+    }
+}
+
+// Compare c = a * b + d * k as three separate passes through temporaries against
+// the single loop the expression template generates
+void compareKernelFusion(size_t vectorSize) {
+    const double k = 0.75;
+    const int size = static_cast<int>(vectorSize);
+    const int runs = 5;
+
+    ExprVector a(vectorSize), b(vectorSize), d(vectorSize);
+    ExprVector separate(vectorSize), fused(vectorSize), handFused(vectorSize);
+    ExprVector product(vectorSize), scaled(vectorSize);
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dis(0.0, 1.0);
+    for (size_t i = 0; i < vectorSize; ++i) {
+        a[i] = dis(gen);
+        b[i] = dis(gen);
+        d[i] = dis(gen);
+    }
+
+    double timeSeparate = std::numeric_limits<double>::max();
+    double timeFused = std::numeric_limits<double>::max();
+    double timeHandFused = std::numeric_limits<double>::max();
+
+    for (int run = 0; run < runs; ++run) {
+        auto start = std::chrono::high_resolution_clock::now();
+        multiplyPass(a.data(), b.data(), product.data(), size);
+        scalePass(d.data(), k, scaled.data(), size);
+        addPass(product.data(), scaled.data(), separate.data(), size);
+        auto end = std::chrono::high_resolution_clock::now();
+        timeSeparate = std::min(timeSeparate, std::chrono::duration<double, std::milli>(end - start).count());
+
+        start = std::chrono::high_resolution_clock::now();
+        fused = a * b + d * k;
+        end = std::chrono::high_resolution_clock::now();
+        timeFused = std::min(timeFused, std::chrono::duration<double, std::milli>(end - start).count());
+
+        const double* pa = a.data();
+        const double* pb = b.data();
+        const double* pd = d.data();
+        double* pc = handFused.data();
+        start = std::chrono::high_resolution_clock::now();
+        #pragma omp parallel for
+        for (int i = 0; i < size; ++i) {
+            pc[i] = pa[i] * pb[i] + pd[i] * k;
+        }
+        end = std::chrono::high_resolution_clock::now();
+        timeHandFused = std::min(timeHandFused, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+
+    double maxDifference = 0.0;
+    for (size_t i = 0; i < vectorSize; ++i) {
+        maxDifference = std::max(maxDifference, std::abs(fused[i] - separate[i]));
+    }
+
+    // 3 passes: 5 arrays read, 3 written; fused: 3 read, 1 written
+    const double megabytes = static_cast<double>(vectorSize) * sizeof(double) / (1024.0 * 1024.0);
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Vector size: " << vectorSize << " doubles (" << megabytes << " MB per array), best of "
+              << runs << " runs" << std::endl;
+    std::cout << "Separate passes (3 loops, 2 temporaries): " << timeSeparate << " ms, "
+              << 8.0 * megabytes / timeSeparate << " GB/s moved" << std::endl;
+    std::cout << "Expression template (1 fused loop):       " << timeFused << " ms, "
+              << 4.0 * megabytes / timeFused << " GB/s moved (Speedup: " << timeSeparate / timeFused << "x)" << std::endl;
+    std::cout << "Hand-written fused loop:                  " << timeHandFused << " ms (Speedup: "
+              << timeSeparate / timeHandFused << "x)" << std::endl;
+    std::cout << std::scientific << std::setprecision(2);
+    std::cout << "Max difference fused vs separate: " << maxDifference << std::endl;
+    std::cout << std::fixed;
+    std::cout << "Fused sum(a * b + d * k) = " << sum(a * b + d * k) << std::endl;
+}
+
 // Run SIMD with thread parallelism demo
 void runSIMDParallelism() {
     std::cout << "\n=== SIMD with Thread Parallelism Demo ===" << std::endl;
@@ -207,9 +303,9 @@ void runSIMDParallelism() {
         }
         
         // Create temporary vectors for this test
-        std::vector<double> a(vectorSize);
-        std::vector<double> b(vectorSize);
-        std::vector<double> c(vectorSize);
+        AlignedVector<double> a(vectorSize);
+        AlignedVector<double> b(vectorSize);
+        AlignedVector<double> c(vectorSize);
         
         // Initialize with random data
         std::random_device rd;
@@ -238,6 +334,10 @@ void runSIMDParallelism() {
     std::cout << "\nOptimal thread count for this workload: " << optimalThreads << " threads" << std::endl;
     std::cout << "Best execution time: " << bestTime << " ms" << std::endl;
     
+    // Chained element-wise operations
+    std::cout << "\n--- Kernel Fusion with Expression Templates ---" << std::endl;
+    compareKernelFusion(8 * 1024 * 1024);
+    
     // SIMD + parallelism explanation
     std::cout << "\n=== SIMD + Thread Parallelism Explained ===" << std::endl;
     
@@ -261,6 +361,12 @@ void runSIMDParallelism() {
     std::cout << "   - #pragma omp parallel for - Thread parallelism only" << std::endl;
     std::cout << "   - Nested directives used for combined parallelism in OpenMP 2.0" << std::endl;
     
+    std::cout << "\n5. Kernel Fusion:" << std::endl;
+    std::cout << "   - Chaining separate element-wise kernels sends every intermediate through memory" << std::endl;
+    std::cout << "   - Expression templates (vector_expr.h) build c = a * b + d * k as a type and" << std::endl;
+    std::cout << "     evaluate it in one vectorized, thread-parallel loop with no temporaries" << std::endl;
+    std::cout << "   - For memory-bound chains the speedup follows the reduction in bytes moved" << std::endl;
+    
     std::cout << "\nNote: In newer OpenMP versions, you can use the combined directive" << std::endl;
     std::cout << "      #pragma omp parallel for simd for maximum performance." << std::endl;
 }
\ No newline at end of file
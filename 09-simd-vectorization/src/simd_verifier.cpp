@@ -1,5 +1,6 @@
 #include "../include/simd_verifier.h"
 #include "../include/cpu_features.h"
+#include "aligned_allocator.h"
 #include <iostream>
 #include <iomanip>
 #include <vector>
@@ -55,9 +56,9 @@ public:
 // Vectorization test case for simple array addition
 bool testSimpleVectorization() {
     const size_t size = 10000000; // 10 million elements
-    std::vector<float> a(size, 1.0f);
-    std::vector<float> b(size, 2.0f);
-    std::vector<float> c(size, 0.0f);
+    AlignedVector<float> a(size, 1.0f);
+    AlignedVector<float> b(size, 2.0f);
+    AlignedVector<float> c(size, 0.0f);
     
     Timer timer;
     
@@ -101,9 +102,9 @@ bool testSimpleVectorization() {
 // Vectorization test case for complex array operations
 bool testComplexVectorization() {
     const size_t size = 1000000; // 1 million elements
-    std::vector<double> a(size);
-    std::vector<double> b(size);
-    std::vector<double> c(size);
+    AlignedVector<double> a(size);
+    AlignedVector<double> b(size);
+    AlignedVector<double> c(size);
     
     // Initialize with some values
     for (size_t i = 0; i < size; ++i) {
@@ -151,9 +152,9 @@ bool testComplexVectorization() {
 // Vectorization test case for operations with conditionals
 bool testConditionalVectorization() {
     const size_t size = 10000000; // 10 million elements
-    std::vector<float> a(size);
-    std::vector<float> b(size);
-    std::vector<float> c(size);
+    AlignedVector<float> a(size);
+    AlignedVector<float> b(size);
+    AlignedVector<float> c(size);
     
     // Initialize with some values
     for (size_t i = 0; i < size; ++i) {
@@ -209,9 +210,9 @@ bool testConditionalVectorization() {
 // Vectorization test case for memory gather/scatter operations
 bool testMemoryGatherScatter() {
     const size_t size = 1000000; // 1 million elements
-    std::vector<float> a(size);
-    std::vector<float> b(size);
-    std::vector<int> indices(size);
+    AlignedVector<float> a(size);
+    AlignedVector<float> b(size);
+    AlignedVector<int> indices(size);
     
     // Initialize with some values
     for (size_t i = 0; i < size; ++i) {
@@ -283,9 +284,9 @@ bool detectSIMDUsage() {
     // speedup, we'll assume SIMD instructions are being used
     
     const size_t size = 10000000; // 10 million elements
-    std::vector<float> a(size, 1.0f);
-    std::vector<float> b(size, 2.0f);
-    std::vector<float> c(size, 0.0f);
+    AlignedVector<float> a(size, 1.0f);
+    AlignedVector<float> b(size, 2.0f);
+    AlignedVector<float> c(size, 0.0f);
     
     Timer timer;
     
@@ -1,58 +1,53 @@
 #include "../include/simd_examples.h"
 #include "../include/cpu_features.h"
+#include "../include/simd_dispatch.h"
 #include <iostream>
 #include <vector>
 #include <chrono>
 #include <iomanip>
 #include <random>
 #include <omp.h>
+#include <algorithm>
+#include <cmath>
 
-// Default vector operation without explicit SIMD width
+// Default vector operation: the per-ISA build selected at startup
 void defaultWidthVectorOperation(const float* __restrict a, const float* __restrict b, float* __restrict c, int size) {
-    #pragma omp simd
-    for (int i = 0; i < size; ++i) {
-        c[i] = a[i] * b[i] + a[i] / (b[i] + 0.01f); // Add small value to avoid division by zero
-    }
+    getSIMDKernels().widthOperation(a, b, c, static_cast<size_t>(size));
 }
 
-// Vector operation with specific SIMD width hint
-void explicitWidthVectorOperation(const float* __restrict a, const float* __restrict b, float* __restrict c, int size, int simdWidth) {
-    int simdLength = simdWidth / (8 * sizeof(float)); // Number of floats per SIMD register
-    
-    // Use safelen clause to hint about SIMD width
-    #pragma omp simd safelen(simdLength)
-    for (int i = 0; i < size; ++i) {
-        c[i] = a[i] * b[i] + a[i] / (b[i] + 0.01f);
-    }
+// Kernel table whose registers hold Lanes floats (4 = SSE2, 8 = AVX2, 16 = AVX-512),
+// or the widest one this CPU can run if it cannot run that build
+template<int Lanes>
+const SIMDKernelTable& kernelsForLanes() {
+    const SIMDKernelTable* kernels = getSIMDKernelsFor(simdLevelForWidth(Lanes * 8 * static_cast<int>(sizeof(float))));
+    return kernels != nullptr ? *kernels : getSIMDKernels();
 }
 
-// Vector operation with remainder handling for non-multiple sizes
-void remainderHandlingVectorOperation(const float* __restrict a, const float* __restrict b, float* __restrict c, int size, int simdWidth) {
-    int simdLength = simdWidth / (8 * sizeof(float)); // Number of floats per SIMD register
-    
-    // Calculate the largest multiple of simdLength less than or equal to size
-    int mainPortionSize = (size / simdLength) * simdLength;
-    
-    // Process the main portion that's a multiple of SIMD width
-    #pragma omp simd safelen(simdLength)
-    for (int i = 0; i < mainPortionSize; ++i) {
-        c[i] = a[i] * b[i] + a[i] / (b[i] + 0.01f);
-    }
-    
-    // Handle the remainder portion sequentially
-    for (int i = mainPortionSize; i < size; ++i) {
-        c[i] = a[i] * b[i] + a[i] / (b[i] + 0.01f);
-    }
+// Vector operation built for a specific register width; the compiler picks the
+// unrolling and finishes with its own scalar epilogue
+template<int Lanes>
+void explicitWidthVectorOperation(const float* __restrict a, const float* __restrict b, float* __restrict c, int size) {
+    kernelsForLanes<Lanes>().widthOperation(a, b, c, static_cast<size_t>(size));
 }
 
-// Function to run vector operation with different SIMD widths
-void vectorizeWithDifferentWidths(int simdWidth) {
+// Vector operation with Lanes elements per step fixed at compile time and the
+// remainder handled by masked vector operations (AVX-512 mask registers, AVX2
+// maskload/maskstore, or a zero-padded step on SSE2)
+template<int Lanes>
+void remainderHandlingVectorOperation(const float* __restrict a, const float* __restrict b, float* __restrict c, int size) {
+    kernelsForLanes<Lanes>().widthOperationLanes[widthLanesIndex(Lanes)](a, b, c, static_cast<size_t>(size));
+}
+
+// Time the default, explicit-width and remainder-handling kernels for one width
+template<int Lanes>
+static void compareWidthKernels() {
+    const int simdWidth = Lanes * 8 * static_cast<int>(sizeof(float));
     const int size = 50000000; // 50 million elements
     
     // Allocate and initialize arrays
-    std::vector<float> a(size);
-    std::vector<float> b(size);
-    std::vector<float> c(size);
+    AlignedVector<float> a(size);
+    AlignedVector<float> b(size);
+    AlignedVector<float> c(size);
     
     // Initialize with random data
     std::random_device rd;
@@ -77,21 +72,25 @@ void vectorizeWithDifferentWidths(int simdWidth) {
     
     // Measure execution time with explicit width
     start = std::chrono::high_resolution_clock::now();
-    explicitWidthVectorOperation(a.data(), b.data(), c.data(), size, simdWidth);
+    explicitWidthVectorOperation<Lanes>(a.data(), b.data(), c.data(), size);
     end = std::chrono::high_resolution_clock::now();
     double explicitTime = std::chrono::duration<double, std::milli>(end - start).count();
     
     // Measure execution time with remainder handling
     start = std::chrono::high_resolution_clock::now();
-    remainderHandlingVectorOperation(a.data(), b.data(), c.data(), size, simdWidth);
+    remainderHandlingVectorOperation<Lanes>(a.data(), b.data(), c.data(), size);
     end = std::chrono::high_resolution_clock::now();
     double remainderTime = std::chrono::duration<double, std::milli>(end - start).count();
     
     // Print results
     std::cout << std::fixed << std::setprecision(3);
     std::cout << "Default SIMD width execution time: " << defaultTime << " ms" << std::endl;
-    std::cout << "Explicit SIMD width (" << simdWidth << " bits) execution time: " << explicitTime << " ms" << std::endl;
-    std::cout << "SIMD with remainder handling execution time: " << remainderTime << " ms" << std::endl;
+    const SIMDKernelTable* widthKernels = getSIMDKernelsFor(simdLevelForWidth(simdWidth));
+    std::cout << "Explicit SIMD width (" << simdWidth << " bits, "
+              << (widthKernels != nullptr ? widthKernels->name : "unsupported, using default")
+              << " build) execution time: " << explicitTime << " ms" << std::endl;
+    std::cout << "SIMD with remainder handling (" << Lanes << " lanes, masked tail) execution time: "
+              << remainderTime << " ms" << std::endl;
     
     // Calculate speedups
     double defaultVsExplicitSpeedup = defaultTime / explicitTime;
@@ -100,6 +99,86 @@ void vectorizeWithDifferentWidths(int simdWidth) {
     std::cout << "Speedup with remainder handling: " << defaultVsRemainderSpeedup << "x" << std::endl;
 }
 
+// Function to run vector operation with different SIMD widths; the runtime width
+// only picks the instantiation, inside it the lane count is a constant
+void vectorizeWithDifferentWidths(int simdWidth) {
+    const int lanes = simdWidth / (8 * static_cast<int>(sizeof(float)));
+    if (lanes >= 16) {
+        compareWidthKernels<16>();
+    } else if (lanes >= 8) {
+        compareWidthKernels<8>();
+    } else {
+        compareWidthKernels<4>();
+    }
+}
+
+// Short, odd-length inputs: the compiler's loop with a scalar epilogue against
+// the fixed-lane kernel with a masked remainder
+template<int Lanes>
+static void benchmarkOddSizesForLanes() {
+    const int sizes[] = {3, 7, 13, 31, 67, 131, 1021, 4099};
+    const int maxSize = 4099;
+    const long long elementsPerSize = 20000000;
+    const SIMDKernelTable& kernels = kernelsForLanes<Lanes>();
+    
+    AlignedVector<float> a(maxSize);
+    AlignedVector<float> b(maxSize);
+    AlignedVector<float> c(maxSize);
+    AlignedVector<float> reference(maxSize);
+    
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> dis(1.0f, 2.0f);
+    for (int i = 0; i < maxSize; ++i) {
+        a[i] = dis(gen);
+        b[i] = dis(gen);
+        reference[i] = a[i] * b[i] + a[i] / (b[i] + 0.01f);
+    }
+    
+    std::cout << "\n" << kernels.name << " build, " << Lanes << " lanes:" << std::endl;
+    std::cout << std::setw(8) << "Size" << std::setw(18) << "Scalar tail (ns)" << std::setw(18) << "Masked tail (ns)"
+              << std::setw(10) << "Speedup" << std::setw(14) << "Max error" << std::endl;
+    
+    for (int size : sizes) {
+        const long long repetitions = std::max(1LL, elementsPerSize / size);
+        
+        auto start = std::chrono::high_resolution_clock::now();
+        for (long long r = 0; r < repetitions; ++r) {
+            explicitWidthVectorOperation<Lanes>(a.data(), b.data(), c.data(), size);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double scalarTailTime = std::chrono::duration<double, std::nano>(end - start).count() / repetitions;
+        
+        start = std::chrono::high_resolution_clock::now();
+        for (long long r = 0; r < repetitions; ++r) {
+            remainderHandlingVectorOperation<Lanes>(a.data(), b.data(), c.data(), size);
+        }
+        end = std::chrono::high_resolution_clock::now();
+        double maskedTailTime = std::chrono::duration<double, std::nano>(end - start).count() / repetitions;
+        
+        float maxError = 0.0f;
+        for (int i = 0; i < size; ++i) {
+            maxError = std::max(maxError, std::abs(c[i] - reference[i]));
+        }
+        
+        std::cout << std::setw(8) << size << std::fixed << std::setprecision(1)
+                  << std::setw(18) << scalarTailTime << std::setw(18) << maskedTailTime
+                  << std::setprecision(2) << std::setw(9) << scalarTailTime / maskedTailTime << "x"
+                  << std::scientific << std::setw(14) << maxError << std::fixed << std::endl;
+    }
+}
+
+void benchmarkOddSizes() {
+    std::cout << "\n--- Odd-Length Vectors: Scalar Tail vs Masked Remainder ---" << std::endl;
+    const int simdWidth = getOptimalSIMDWidth();
+    benchmarkOddSizesForLanes<4>();
+    if (simdWidth >= 256) {
+        benchmarkOddSizesForLanes<8>();
+    }
+    if (simdWidth >= 512) {
+        benchmarkOddSizesForLanes<16>();
+    }
+}
+
 // Run SIMD width adaptation demo
 void runSIMDWidth() {
     std::cout << "\n=== SIMD Width Adaptation Demo ===" << std::endl;
@@ -107,6 +186,7 @@ void runSIMDWidth() {
     // Get the optimal SIMD width for the current CPU
     int simdWidth = getOptimalSIMDWidth();
     std::cout << "Detected optimal SIMD width: " << simdWidth << " bits" << std::endl;
+    std::cout << "Kernel variant selected at startup: " << getSIMDKernels().name << std::endl;
     
     // Run tests with different SIMD widths
     std::cout << "\n--- Testing with 128-bit SIMD Width (SSE) ---" << std::endl;
@@ -126,6 +206,9 @@ void runSIMDWidth() {
     std::cout << "\n--- Testing with Optimal SIMD Width (" << simdWidth << " bits) ---" << std::endl;
     vectorizeWithDifferentWidths(simdWidth);
     
+    // Short vectors, where the remainder is a large share of the work
+    benchmarkOddSizes();
+    
     // SIMD width explanation
     std::cout << "\n=== Understanding SIMD Width Adaptation ===" << std::endl;
     
@@ -136,8 +219,11 @@ void runSIMDWidth() {
     
     std::cout << "\nAdapting to different SIMD widths:" << std::endl;
     std::cout << "1. Runtime detection allows using the widest supported instructions" << std::endl;
-    std::cout << "2. The safelen clause hints the compiler about vector length" << std::endl;
+    std::cout << "2. Each width runs its own build of the kernel (SSE2, AVX2 or AVX-512 flags)" << std::endl;
     std::cout << "3. Remainder handling ensures correct results for arbitrary sizes" << std::endl;
+    std::cout << "4. Masked loads and stores (AVX2, AVX-512) finish the remainder in vector steps;" << std::endl;
+    std::cout << "   on short vectors a scalar tail can cost as much as the vector loop itself." << std::endl;
+    std::cout << "   SSE2 has no masked loads, so its padded last step only helps longer tails" << std::endl;
     
     std::cout << "\nImportant considerations:" << std::endl;
     std::cout << "- Wider SIMD doesn't always mean better performance" << std::endl;
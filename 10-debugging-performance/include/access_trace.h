@@ -0,0 +1,259 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+#include "happens_before.h"
+
+/**
+ * @brief Kind of an access trace record
+ */
+enum class AccessTraceKind : uint32_t {
+    Read,
+    Write,
+    Fork,           // parallelBegin on the master; address = team size
+    Join,           // parallelEnd on the master
+    BarrierArrive,  // address = barrier generation within the region
+    BarrierLeave,
+    Acquire,        // address = sync object
+    Release
+};
+
+/**
+ * @brief One record of an access trace (16 bytes)
+ *
+ * Accesses carry the address, the location ID and the segment of the thread
+ * that made them. A thread starts a new segment at every synchronization
+ * event that changes its vector clock, so all accesses of one segment are
+ * ordered the same way against other threads. Synchronization records carry
+ * their argument in address and a global sequence number in location. The
+ * sequence numbers give the order the events took effect in.
+ */
+struct AccessTraceRecord {
+    uint64_t address;
+    uint32_t location;
+    uint32_t info;              // kind << 28 | segment
+
+    static const uint32_t kSegmentMask = (1u << 28) - 1;
+
+    AccessTraceKind kind() const { return static_cast<AccessTraceKind>(info >> 28); }
+    uint32_t segment() const { return info & kSegmentMask; }
+    bool isAccess() const { return kind() == AccessTraceKind::Read || kind() == AccessTraceKind::Write; }
+};
+
+static_assert(sizeof(AccessTraceRecord) == 16, "AccessTraceRecord is part of the trace format");
+
+/**
+ * @brief A named array whose layout the offline analysis reports on
+ *
+ * A region covers the accesses made after the previous region was declared,
+ * like an in-process analysis followed by CustomRaceDetector::clear.
+ */
+struct AccessTraceRegion {
+    std::string name;
+    uint64_t start = 0;
+    uint64_t elementSize = 1;
+    uint64_t count = 0;
+    uint64_t sequence = 0;      // Sync sequence number when declared
+};
+
+/**
+ * @class AccessTraceWriter
+ * @brief Records accesses and synchronization to a binary trace
+ *
+ * The hot path only appends a record to the calling thread's buffer. A full
+ * buffer (64K records) is written to the file as one block under a lock. No
+ * shadow memory or clocks are kept, so the instrumented run costs about as
+ * much as the logging itself. HappensBeforeDetector::startRecording routes
+ * its hooks here.
+ *
+ * Threads are identified by the thread number passed in; numbers of
+ * maxThreads and above are ignored.
+ */
+class AccessTraceWriter {
+public:
+    AccessTraceWriter() = default;
+    ~AccessTraceWriter();
+
+    AccessTraceWriter(const AccessTraceWriter&) = delete;
+    AccessTraceWriter& operator=(const AccessTraceWriter&) = delete;
+
+    /**
+     * @brief Create the trace file
+     * @param path Trace file, truncated
+     * @param maxThreads Largest team size to record
+     * @return false if the file cannot be created
+     */
+    bool open(const std::string& path, int maxThreads);
+
+    bool isOpen() const { return m_file.is_open(); }
+
+    void read(int thread, const void* address, uint32_t location) {
+        append(thread, AccessTraceKind::Read, reinterpret_cast<uint64_t>(address), location);
+    }
+
+    void write(int thread, const void* address, uint32_t location) {
+        append(thread, AccessTraceKind::Write, reinterpret_cast<uint64_t>(address), location);
+    }
+
+    /**
+     * @brief Fork and join edges, called by the master outside the region
+     */
+    void parallelBegin(int numThreads);
+    void parallelEnd();
+
+    /**
+     * @brief Team barrier: records the arrival, waits at #pragma omp barrier, records the departure
+     */
+    void barrier(int thread);
+
+    void acquire(int thread, const void* sync);
+    void release(int thread, const void* sync);
+
+    /**
+     * @brief Name an array for the layout analyses (false sharing, access pattern)
+     *
+     * Call outside parallel regions, after the accesses it should cover.
+     */
+    void region(const std::string& name, const void* start, size_t elementSize, size_t count);
+
+    /**
+     * @brief Flush every buffer, write the location and region tables and close
+     * @param locations Location labels; label i has ID i + 1
+     */
+    void close(const std::vector<std::string>& locations);
+
+    /**
+     * @brief Records written or buffered so far
+     */
+    uint64_t recordCount() const;
+
+private:
+    static const size_t kBufferRecords = 1 << 16;
+
+    struct alignas(64) ThreadBuffer {
+        std::vector<AccessTraceRecord> records;
+        uint32_t segment = 0;
+        uint64_t barriers = 0;
+        uint64_t flushed = 0;
+    };
+
+    void append(int thread, AccessTraceKind kind, uint64_t address, uint32_t location) {
+        if (thread < 0 || thread >= m_maxThreads) {
+            return;
+        }
+        ThreadBuffer& buffer = m_threads[thread];
+        buffer.records.push_back({address, location, (static_cast<uint32_t>(kind) << 28) | buffer.segment});
+        if (buffer.records.size() >= kBufferRecords) {
+            flush(thread);
+        }
+    }
+
+    void appendSync(int thread, AccessTraceKind kind, uint64_t argument);
+    void nextSegment(int thread);
+    void flush(int thread);
+
+    std::ofstream m_file;
+    std::mutex m_fileMutex;
+    int m_maxThreads = 0;
+    std::vector<ThreadBuffer> m_threads;
+    std::atomic<uint32_t> m_sequence{0};
+    std::vector<AccessTraceRegion> m_regions;
+};
+
+/**
+ * @brief Layout analysis of one traced region
+ */
+struct AccessTraceRegionAnalysis {
+    AccessTraceRegion region;
+    std::vector<std::set<int>> readThreads;                         // Per element
+    std::vector<std::set<int>> writeThreads;
+    std::vector<std::map<int, std::pair<int, int>>> lineAccess;     // Per cache line: thread -> {reads, writes}
+};
+
+/**
+ * @brief Result of analyzing an access trace
+ */
+struct AccessTraceAnalysis {
+    int threads = 0;
+    int workers = 0;
+    uint64_t accesses = 0;
+    uint64_t syncEvents = 0;
+    uint64_t segments = 0;
+    uint64_t shadowWords = 0;
+    uint64_t raceCount = 0;
+    std::vector<HBRace> races;                      // At most one per word, by address
+    std::vector<std::string> locations;
+    std::vector<AccessTraceRegionAnalysis> regions;
+    double replaySeconds = 0.0;                     // Rebuilding vector clocks from the sync events
+    double analyzeSeconds = 0.0;                    // Parallel race and layout analysis
+
+    std::string locationName(uint32_t id) const {
+        return (id == 0 || id > locations.size()) ? std::string("[Unknown]") : locations[id - 1];
+    }
+};
+
+/**
+ * @class AccessTraceReader
+ * @brief Memory-maps an access trace and analyzes it offline
+ *
+ * analyze() first replays the synchronization records in sequence order to
+ * rebuild the vector clock of every thread segment. It then walks the
+ * segments in an order consistent with happens-before, which is all a
+ * FastTrack-style check needs. The address space is cut into 4 KB ranges
+ * dealt round-robin to the workers. Each worker reads the whole mapped trace
+ * but keeps shadow state only for its own ranges, so workers share nothing
+ * and analysis scales with the number of workers. Array elements and cache
+ * lines of traced regions are split the same way, in runs of 512 elements
+ * and 64 lines.
+ */
+class AccessTraceReader {
+public:
+    AccessTraceReader() = default;
+    ~AccessTraceReader();
+
+    AccessTraceReader(const AccessTraceReader&) = delete;
+    AccessTraceReader& operator=(const AccessTraceReader&) = delete;
+
+    /**
+     * @brief Map a trace written by AccessTraceWriter
+     * @return false if the file cannot be mapped or is not an access trace
+     */
+    bool open(const std::string& path);
+
+    void close();
+
+    /**
+     * @brief Run race, false-sharing and access pattern analysis
+     * @param workers Threads to analyze with
+     */
+    AccessTraceAnalysis analyze(int workers) const;
+
+    int threads() const { return m_threads; }
+
+private:
+    struct Block {
+        int thread;
+        const AccessTraceRecord* records;
+        size_t count;
+    };
+
+    bool parse(const std::string& path);
+
+    const char* m_base = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+    int m_threads = 0;
+    std::vector<Block> m_blocks;
+    std::vector<std::string> m_locations;
+    std::vector<AccessTraceRegion> m_regions;
+};
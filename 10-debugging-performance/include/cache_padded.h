@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <omp.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Smallest distance in bytes that keeps two objects off the same cache line
+ *
+ * std::hardware_destructive_interference_size where the standard library
+ * provides it (it follows the compiler's CPU tuning), otherwise 64.
+ */
+#if defined(__cpp_lib_hardware_interference_size)
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 12
+#pragma GCC diagnostic push
+// The value may change with -mtune; it only sizes padding here, never an ABI
+#pragma GCC diagnostic ignored "-Winterference-size"
+#endif
+constexpr size_t CACHE_LINE_SIZE = std::hardware_destructive_interference_size;
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 12
+#pragma GCC diagnostic pop
+#endif
+#else
+constexpr size_t CACHE_LINE_SIZE = 64;
+#endif
+
+/**
+ * @brief Padding that also defeats the adjacent-line prefetcher
+ *
+ * Intel cores from Sandy Bridge on fetch cache lines in aligned 128-byte
+ * pairs, so two threads writing neighbouring 64-byte lines can still slow
+ * each other down. Padding to 128 bytes keeps every slot in its own pair.
+ */
+constexpr size_t PREFETCH_PAIR_SIZE = 128;
+
+/**
+ * @brief Cache line size of the running CPU
+ * @return L1 data cache line size in bytes, or CACHE_LINE_SIZE if unknown
+ */
+inline size_t detectCacheLineSize() {
+#if defined(__linux__) && defined(_SC_LEVEL1_DCACHE_LINESIZE)
+    long size = sysconf(_SC_LEVEL1_DCACHE_LINESIZE);
+    if (size > 0) {
+        return static_cast<size_t>(size);
+    }
+#endif
+    return CACHE_LINE_SIZE;
+}
+
+/**
+ * @struct CachePadded
+ * @brief A value alone on its cache line (or line pair)
+ *
+ * Aligned and padded to Alignment bytes, so an array of CachePadded values
+ * puts each element on its own line and writes to one never invalidate
+ * another. Use PREFETCH_PAIR_SIZE as Alignment for data written by different
+ * threads at a high rate.
+ *
+ * @tparam T Value type
+ * @tparam Alignment Alignment and size granule in bytes (power of two)
+ */
+template<typename T, size_t Alignment = CACHE_LINE_SIZE>
+struct alignas(Alignment) CachePadded {
+    T value;
+
+    CachePadded() : value() {}
+    explicit CachePadded(const T& initial) : value(initial) {}
+
+    T& operator*() { return value; }
+    const T& operator*() const { return value; }
+    T* operator->() { return &value; }
+    const T* operator->() const { return &value; }
+};
+
+/**
+ * @class PerThread
+ * @brief One cache-padded slot per OpenMP thread
+ *
+ * Replaces std::vector<T> indexed by omp_get_thread_num() for per-thread
+ * partial results, counters and statistics: each slot sits on its own line,
+ * so threads updating their slots never share a line. Combine the slots after
+ * the parallel region (or after a barrier).
+ *
+ * @tparam T Slot type
+ * @tparam Alignment Slot alignment in bytes (CACHE_LINE_SIZE or PREFETCH_PAIR_SIZE)
+ */
+template<typename T, size_t Alignment = CACHE_LINE_SIZE>
+class PerThread {
+public:
+    using Slot = CachePadded<T, Alignment>;
+
+    /**
+     * @brief Create the slots
+     * @param numThreads Number of slots, one per thread of the team
+     * @param initial Initial value of every slot
+     */
+    explicit PerThread(int numThreads = omp_get_max_threads(), const T& initial = T())
+        : m_slots(static_cast<size_t>(numThreads > 0 ? numThreads : 1), Slot(initial)) {}
+
+    /**
+     * @brief Slot of the calling thread
+     */
+    T& local() { return m_slots[static_cast<size_t>(omp_get_thread_num())].value; }
+
+    T& operator[](int thread) { return m_slots[static_cast<size_t>(thread)].value; }
+    const T& operator[](int thread) const { return m_slots[static_cast<size_t>(thread)].value; }
+
+    /**
+     * @brief Number of slots
+     */
+    int size() const { return static_cast<int>(m_slots.size()); }
+
+    /**
+     * @brief Set every slot to value
+     */
+    void fill(const T& value) {
+        for (auto& slot : m_slots) {
+            slot.value = value;
+        }
+    }
+
+    /**
+     * @brief Fold the slots in thread order
+     * @param init Starting value
+     * @param op Called as op(accumulated, slot)
+     */
+    template<typename Result, typename Op>
+    Result combine(Result init, Op op) const {
+        for (const auto& slot : m_slots) {
+            init = op(init, slot.value);
+        }
+        return init;
+    }
+
+    /**
+     * @brief Copy the slots into a plain vector, e.g. for reporting
+     */
+    std::vector<T> values() const {
+        std::vector<T> result;
+        result.reserve(m_slots.size());
+        for (const auto& slot : m_slots) {
+            result.push_back(slot.value);
+        }
+        return result;
+    }
+
+private:
+    std::vector<Slot> m_slots;
+};
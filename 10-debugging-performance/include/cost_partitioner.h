@@ -0,0 +1,150 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include <omp.h>
+#include "cache_padded.h"
+
+/**
+ * @class CostPartitioner
+ * @brief Cost-aware static partitioning with work stealing for OpenMP loops
+ *
+ * plan() assigns the items of a range to threads by longest-processing-time
+ * first: items are sorted by cost, heaviest first, and each goes to the thread
+ * with the least cost so far. With accurate costs this alone balances the
+ * loop to within one item.
+ *
+ * execute() then runs the plan. Each thread works through its own queue from
+ * the heaviest item down. A thread whose queue is empty steals from the light
+ * end of the queue with the most items left, so wrong cost estimates only
+ * cost a few steals instead of an idle tail. Every item runs exactly once.
+ *
+ * Usage:
+ *   CostPartitioner partitioner;
+ *   partitioner.plan(items.begin(), items.end(), [](const Item& item) { return item.cost; }, numThreads);
+ *   #pragma omp parallel num_threads(numThreads)
+ *   partitioner.execute([&](size_t i) { process(items[i]); });
+ */
+class CostPartitioner {
+public:
+    CostPartitioner() = default;
+
+    CostPartitioner(const CostPartitioner&) = delete;
+    CostPartitioner& operator=(const CostPartitioner&) = delete;
+
+    /**
+     * @brief Assign items to threads by longest-processing-time first
+     * @param costs Known or estimated cost of each item; item i is costs[i]
+     * @param numThreads Number of threads that will call execute
+     */
+    void plan(const std::vector<double>& costs, int numThreads);
+
+    /**
+     * @brief Assign the items of a range to threads
+     * @param first Start of the range
+     * @param last End of the range
+     * @param costOf Estimated cost of one element
+     * @param numThreads Number of threads that will call execute
+     *
+     * Item indices passed to execute are offsets from first.
+     */
+    template<typename Iterator, typename CostFunc>
+    void plan(Iterator first, Iterator last, CostFunc&& costOf, int numThreads) {
+        std::vector<double> costs;
+        costs.reserve(static_cast<size_t>(std::distance(first, last)));
+        for (Iterator it = first; it != last; ++it) {
+            costs.push_back(static_cast<double>(costOf(*it)));
+        }
+        plan(costs, numThreads);
+    }
+
+    /**
+     * @brief Run every planned item once; call from each thread of the team
+     * @param body Called as body(index) for each item
+     *
+     * The team must have as many threads as were planned for. Ends with an
+     * implicit barrier, so the results are complete when it returns.
+     */
+    template<typename Body>
+    void execute(Body&& body);
+
+    /**
+     * @brief Re-arm the queues so the same plan can run again
+     *
+     * Must not be called while execute is running.
+     */
+    void rewind();
+
+    /**
+     * @brief Number of threads planned for
+     */
+    int numThreads() const { return m_numThreads; }
+
+    /**
+     * @brief Planned cost of a thread's queue
+     */
+    double plannedCost(int thread) const;
+
+    /**
+     * @brief Largest planned thread cost over the average (1.0 is perfect)
+     */
+    double plannedImbalance() const;
+
+    /**
+     * @brief Items a thread ran in the last execute, including stolen ones
+     */
+    size_t executedCount(int thread) const;
+
+    /**
+     * @brief Items a thread stole from other queues in the last execute
+     */
+    size_t stolenCount(int thread) const;
+
+private:
+    // One queue per thread: the owner pops from head, thieves from tail. Both
+    // ends live in one word so a pop is a single compare-and-swap.
+    struct alignas(CACHE_LINE_SIZE) Queue {
+        std::atomic<uint64_t> bounds{0};    // head << 32 | tail, as offsets into m_order
+        uint32_t begin = 0;
+        uint32_t end = 0;
+        double plannedCost = 0.0;
+        size_t executed = 0;                // Written by the executing thread only
+        size_t stolen = 0;
+    };
+
+    static uint64_t packBounds(uint32_t head, uint32_t tail) { return (static_cast<uint64_t>(head) << 32) | tail; }
+
+    bool popOwn(Queue& queue, uint32_t& item);
+    bool stealFrom(Queue& queue, uint32_t& item);
+    bool steal(int thief, uint32_t& item);
+
+    int m_numThreads = 0;
+    std::vector<uint32_t> m_order;          // Item indices, grouped by queue
+    std::unique_ptr<Queue[]> m_queues;
+};
+
+template<typename Body>
+void CostPartitioner::execute(Body&& body) {
+    const int thread = omp_get_thread_num();
+    if (thread < m_numThreads) {
+        Queue& own = m_queues[thread];
+        own.executed = 0;
+        own.stolen = 0;
+
+        uint32_t item;
+        while (popOwn(own, item)) {
+            body(static_cast<size_t>(item));
+            own.executed++;
+        }
+        while (steal(thread, item)) {
+            body(static_cast<size_t>(item));
+            own.executed++;
+            own.stolen++;
+        }
+    }
+    #pragma omp barrier
+}
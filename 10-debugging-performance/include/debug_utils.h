@@ -9,6 +9,9 @@
 #include <omp.h>
 #include <map>
 #include <set>
+#include <atomic>
+#include <cstdint>
+#include <ctime>
 
 // Define log levels
 enum LogLevel {
@@ -19,9 +22,49 @@ enum LogLevel {
     CRITICAL
 };
 
+/**
+ * @brief What the asynchronous logger does when a thread's buffer is full
+ */
+enum class LogOverflowPolicy {
+    DropNewest,     ///< Discard the new message and count it; the caller never waits
+    Block           ///< Wait until the flusher has made room; nothing is lost
+};
+
+/**
+ * @brief One argument of a deferred-format message, kept unformatted until flush
+ *
+ * Strings are stored by pointer, so only pass strings that outlive the flush
+ * (literals, names with static storage). Use log() for built strings.
+ */
+struct LogArg {
+    enum Type : uint8_t { None, Int, UInt, Double, CString };
+
+    Type type = None;
+    union {
+        long long i;
+        unsigned long long u;
+        double d;
+        const char* s;
+    };
+
+    LogArg() : i(0) {}
+    LogArg(bool value) : type(Int), i(value ? 1 : 0) {}
+    LogArg(int value) : type(Int), i(value) {}
+    LogArg(long value) : type(Int), i(value) {}
+    LogArg(long long value) : type(Int), i(value) {}
+    LogArg(unsigned value) : type(UInt), u(value) {}
+    LogArg(unsigned long value) : type(UInt), u(value) {}
+    LogArg(unsigned long long value) : type(UInt), u(value) {}
+    LogArg(double value) : type(Double), d(value) {}
+    LogArg(const char* value) : type(CString), s(value) {}
+};
+
 // Debug logger class
 class DebugLogger {
 public:
+    using FormatId = uint32_t;
+    static constexpr size_t MAX_LOG_ARGS = 6;
+
     static DebugLogger& getInstance();
     void log(LogLevel level, const std::string& message, int threadId = -1);
     void debug(const std::string& message);
@@ -36,21 +79,80 @@ public:
     void clear();
     std::vector<std::string> getLogEntries() const;
 
+    /**
+     * @brief Register a format string once, for logFormat
+     * @param format Text with one "{}" per argument
+     * @return ID to pass to logFormat; registering the same text again returns the same ID
+     */
+    static FormatId registerFormat(const std::string& format);
+
+    /**
+     * @brief Log a registered format with up to MAX_LOG_ARGS scalar arguments
+     *
+     * In async mode only the format ID and the raw arguments are stored; the
+     * text is built by the flusher thread, off the caller's critical path.
+     */
+    template<typename... Args>
+    void logFormat(LogLevel level, FormatId format, Args... args) {
+        static_assert(sizeof...(Args) <= MAX_LOG_ARGS, "too many log arguments");
+        if (level < m_logLevel.load(std::memory_order_relaxed)) {
+            return;
+        }
+        const LogArg packed[] = {LogArg(args)..., LogArg()};
+        logDeferred(level, format, packed, sizeof...(Args));
+    }
+
+    /**
+     * @brief Switch between synchronous logging and the asynchronous backend
+     *
+     * Async mode gives each thread a fixed-size lock-free ring of unformatted
+     * records. A background thread drains the rings every flushIntervalMs (or
+     * sooner when a ring is three quarters full), formats the records in time
+     * order and writes each batch with one call per output. Call outside
+     * parallel regions; disabling flushes everything first.
+     *
+     * @param enabled true for async mode
+     * @param bufferEntries Records per thread (rounded up to a power of two); bounds memory
+     * @param policy What a full ring does with a new record
+     * @param flushIntervalMs Longest time a record waits for the flusher
+     */
+    void setAsync(bool enabled, size_t bufferEntries = 4096,
+                  LogOverflowPolicy policy = LogOverflowPolicy::DropNewest, int flushIntervalMs = 10);
+    bool isAsync() const;
+
+    /**
+     * @brief Write out every record logged so far (no-op in synchronous mode)
+     */
+    void flush();
+
+    /**
+     * @brief Records discarded because a ring was full, since async mode was enabled
+     */
+    uint64_t getDroppedCount() const;
+
 private:
     DebugLogger();
     ~DebugLogger();
     DebugLogger(const DebugLogger&) = delete;
     DebugLogger& operator=(const DebugLogger&) = delete;
 
-    LogLevel m_logLevel;
+    struct AsyncState;      // Rings and flusher thread, defined in debug_utils.cpp
+
+    std::atomic<LogLevel> m_logLevel;
     bool m_fileOutput;
     bool m_consoleOutput;
     bool m_includeThreadId;
     std::string m_filename;
     std::vector<std::string> m_logEntries;
     mutable std::mutex m_mutex;
+    std::atomic<AsyncState*> m_async;
 
     std::string levelToString(LogLevel level) const;
+    std::string formatEntry(LogLevel level, std::time_t time, int threadId, const std::string& message) const;
+    void logDeferred(LogLevel level, FormatId format, const LogArg* args, size_t count);
+    void enqueue(AsyncState& async, LogLevel level, FormatId format, const LogArg* args, size_t count,
+                 const std::string* text, int threadId);
+    void drain(AsyncState& async);
 };
 
 // Race detector class
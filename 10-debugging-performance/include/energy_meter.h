@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Energy and frequency counters of the whole machine
+ *
+ * Values are cumulative when read and become interval values when one
+ * reading is subtracted from a later one. Energy is summed over all packages,
+ * APERF and MPERF over all logical CPUs.
+ */
+struct EnergySample {
+    double seconds = 0.0;           // Since the first reading
+    double packageJoules = 0.0;     // RAPL package domain (cores, caches, uncore)
+    double dramJoules = 0.0;        // RAPL DRAM domain, 0 where the CPU has none
+    uint64_t aperf = 0;             // Actual cycles while not halted
+    uint64_t mperf = 0;             // Cycles at base frequency while not halted
+    double currentMHz = 0.0;        // Average cpufreq of the CPUs at reading time, if APERF/MPERF are unreadable
+    bool valid = false;             // Energy was read
+    bool frequencyValid = false;    // APERF/MPERF were read
+
+    double joules() const { return packageJoules + dramJoules; }
+
+    /**
+     * @brief Average power over an interval sample
+     */
+    double watts() const { return seconds > 0.0 ? joules() / seconds : 0.0; }
+
+    /**
+     * @brief Average frequency of the busy cores over an interval sample
+     * @param baseMHz Base (nominal) frequency, see EnergyMeter::baseFrequencyMHz
+     *
+     * Turbo shows up as a frequency above base; thermal or power throttling
+     * under many busy cores as a lower one.
+     */
+    double effectiveMHz(double baseMHz) const {
+        if (frequencyValid && mperf > 0) {
+            return baseMHz * static_cast<double>(aperf) / static_cast<double>(mperf);
+        }
+        return currentMHz;
+    }
+
+    EnergySample operator-(const EnergySample& start) const {
+        EnergySample delta;
+        delta.seconds = seconds - start.seconds;
+        delta.packageJoules = packageJoules - start.packageJoules;
+        delta.dramJoules = dramJoules - start.dramJoules;
+        delta.aperf = aperf - start.aperf;
+        delta.mperf = mperf - start.mperf;
+        delta.currentMHz = currentMHz;
+        delta.valid = valid && start.valid;
+        delta.frequencyValid = frequencyValid && start.frequencyValid;
+        return delta;
+    }
+};
+
+/**
+ * @class EnergyMeter
+ * @brief RAPL energy and APERF/MPERF effective frequency
+ *
+ * On Linux, energy is read from the powercap sysfs zones
+ * (/sys/class/powercap/intel-rapl:*, also used by AMD's RAPL driver). When
+ * those cannot be read, the meter falls back to the RAPL MSRs through
+ * /dev/cpu/N/msr (msr module, root). APERF/MPERF need the MSRs as well;
+ * without them the frequency is the cpufreq average at reading time. The
+ * hardware counters wrap (the 32-bit package counter after a few minutes at
+ * full load), so read at least every minute. The profiler's metric thread
+ * does that.
+ *
+ * Other platforms have no backend yet; every sample is invalid.
+ */
+class EnergyMeter {
+public:
+    /**
+     * @brief Whether RAPL energy can be read (probed once)
+     */
+    static bool isAvailable();
+
+    /**
+     * @brief Why energy is unavailable, empty if it is available
+     */
+    static std::string unavailableReason();
+
+    /**
+     * @brief Cumulative energy and frequency counters; thread-safe
+     *
+     * Each call handles counter wraparound since the previous one.
+     */
+    static EnergySample read();
+
+    /**
+     * @brief Base frequency that MPERF counts at, in MHz (0 if unknown)
+     */
+    static double baseFrequencyMHz();
+
+    /**
+     * @brief Name of the energy backend, e.g. "powercap" or "msr"
+     */
+    static const char* backendName();
+};
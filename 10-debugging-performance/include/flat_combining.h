@@ -0,0 +1,230 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <omp.h>
+#include "cache_padded.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @struct FlatCombiningStats
+ * @brief How much work each combiner pass did
+ */
+struct FlatCombiningStats {
+    uint64_t operations = 0;    ///< Operations applied
+    uint64_t combines = 0;      ///< Times a thread took the combiner lock
+    uint64_t maxBatch = 0;      ///< Most operations applied under one lock hold
+
+    /**
+     * @brief Average operations per combiner lock hold
+     */
+    double averageBatch() const {
+        return combines > 0 ? static_cast<double>(operations) / static_cast<double>(combines) : 0.0;
+    }
+};
+
+/**
+ * @class FlatCombining
+ * @brief Sequential data structure shared through flat combining
+ *
+ * Each thread publishes its operation in its own cache-padded slot and then
+ * waits. Whichever waiting thread gets the combiner lock applies every pending
+ * operation in one pass and hands the results back. The structure is touched
+ * by one thread at a time, and it stays in that thread's cache for the whole
+ * batch. Under contention one lock hold serves many threads. A critical
+ * section per operation would instead move the lock and the structure between
+ * cores for every operation.
+ *
+ * Any sequential container works: std::map, std::priority_queue, std::deque
+ * and so on. Operations are callables taking Structure& and are applied in an
+ * unspecified order across threads. Each thread's own operations are applied
+ * in program order.
+ *
+ * Slots are indexed by omp_get_thread_num(). Call apply() from a single-level
+ * team of at most numThreads threads, or from outside any parallel region.
+ *
+ * @tparam Structure Sequential data structure
+ */
+template<typename Structure>
+class FlatCombining {
+public:
+    /**
+     * @brief Create an empty structure
+     * @param numThreads Number of request slots (team size)
+     */
+    explicit FlatCombining(int numThreads = omp_get_max_threads())
+        : FlatCombining(numThreads, Structure()) {}
+
+    /**
+     * @brief Take over an existing structure
+     * @param numThreads Number of request slots (team size)
+     * @param structure Initial contents
+     */
+    FlatCombining(int numThreads, Structure structure)
+        : m_structure(std::move(structure)),
+          m_numSlots(numThreads > 0 ? numThreads : 1),
+          m_slots(new Slot[static_cast<size_t>(m_numSlots)]) {}
+
+    FlatCombining(const FlatCombining&) = delete;
+    FlatCombining& operator=(const FlatCombining&) = delete;
+
+    /**
+     * @brief Apply op to the structure and return its result
+     *
+     * Blocks until op has been applied, either by this thread as combiner or
+     * by another one. An exception thrown by op is rethrown here, in the
+     * thread that submitted it.
+     *
+     * @param op Called once as op(structure)
+     * @return Whatever op returns
+     */
+    template<typename Op>
+    std::invoke_result_t<Op&, Structure&> apply(Op&& op) {
+        using Result = std::invoke_result_t<Op&, Structure&>;
+        using Callable = std::remove_reference_t<Op>;
+
+        if constexpr (std::is_void_v<Result>) {
+            run(&op, [](Structure& structure, void* context) {
+                (*static_cast<Callable*>(context))(structure);
+            });
+        } else {
+            struct Call {
+                Callable* op;
+                std::optional<Result> result;
+            };
+            Call call{&op, std::nullopt};
+            run(&call, [](Structure& structure, void* context) {
+                Call& pending = *static_cast<Call*>(context);
+                pending.result.emplace((*pending.op)(structure));
+            });
+            return std::move(*call.result);
+        }
+    }
+
+    /**
+     * @brief The structure itself, for use while no thread calls apply()
+     */
+    Structure& unsafeGet() { return m_structure; }
+    const Structure& unsafeGet() const { return m_structure; }
+
+    /**
+     * @brief Combiner statistics (read while no thread calls apply())
+     */
+    const FlatCombiningStats& stats() const { return m_stats; }
+
+    void resetStats() { m_stats = FlatCombiningStats(); }
+
+    /**
+     * @brief Scans of the slots per lock hold
+     *
+     * The combiner rescans while a scan still finds requests, up to this many
+     * times, so threads that publish during a pass are served by it too.
+     */
+    void setMaxPasses(int passes) { m_maxPasses = passes > 0 ? passes : 1; }
+
+private:
+    using Invoke = void (*)(Structure&, void*);
+
+    enum : int { Empty = 0, Pending = 1, Done = 2 };
+
+    struct Request {
+        std::atomic<int> state{Empty};
+        Invoke invoke = nullptr;
+        void* context = nullptr;
+        std::exception_ptr error;
+    };
+
+    using Slot = CachePadded<Request>;
+
+    static void cpuRelax() {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    void run(void* context, Invoke invoke) {
+        const int thread = omp_get_thread_num();
+        assert(thread < m_numSlots && "FlatCombining: more threads than request slots");
+        Request& request = m_slots[thread].value;
+        request.invoke = invoke;
+        request.context = context;
+        request.state.store(Pending, std::memory_order_release);
+
+        unsigned spins = 0;
+        while (request.state.load(std::memory_order_acquire) != Done) {
+            // Read before exchanging, so waiting threads do not bounce the lock line
+            if (!m_lock->load(std::memory_order_relaxed) &&
+                !m_lock->exchange(true, std::memory_order_acquire)) {
+                combine();
+                m_lock->store(false, std::memory_order_release);
+            } else if (++spins % 256 == 0) {
+                // Oversubscribed teams: let the combiner run
+                std::this_thread::yield();
+            } else {
+                cpuRelax();
+            }
+        }
+
+        request.state.store(Empty, std::memory_order_relaxed);
+        if (request.error) {
+            std::exception_ptr error = std::move(request.error);
+            request.error = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+    // Called with the combiner lock held
+    void combine() {
+        uint64_t batch = 0;
+        for (int pass = 0; pass < m_maxPasses; pass++) {
+            uint64_t found = 0;
+            for (int i = 0; i < m_numSlots; i++) {
+                Request& request = m_slots[i].value;
+                if (request.state.load(std::memory_order_acquire) != Pending) {
+                    continue;
+                }
+                try {
+                    request.invoke(m_structure, request.context);
+                } catch (...) {
+                    request.error = std::current_exception();
+                }
+                request.state.store(Done, std::memory_order_release);
+                found++;
+            }
+            batch += found;
+            if (found == 0) {
+                break;
+            }
+        }
+        if (batch == 0) {
+            return;     // Our request was served by the previous combiner
+        }
+        m_stats.operations += batch;
+        m_stats.combines++;
+        if (batch > m_stats.maxBatch) {
+            m_stats.maxBatch = batch;
+        }
+    }
+
+    Structure m_structure;
+    int m_numSlots;
+    std::unique_ptr<Slot[]> m_slots;
+    CachePadded<std::atomic<bool>> m_lock;
+    FlatCombiningStats m_stats;
+    int m_maxPasses = 3;
+};
@@ -0,0 +1,251 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
+#include <omp.h>
+
+class AccessTraceWriter;
+
+/**
+ * @brief Kind of conflicting access pair
+ */
+enum class HBRaceKind {
+    WriteWrite,     // A write not ordered after an earlier write
+    WriteRead,      // A read not ordered after an earlier write
+    ReadWrite       // A write not ordered after an earlier read
+};
+
+/**
+ * @brief One reported race, the first found on an 8-byte word
+ */
+struct HBRace {
+    uintptr_t address;          // Address of the word
+    HBRaceKind kind;
+    int firstThread;            // Thread of the earlier access
+    int secondThread;           // Thread of the access that raced with it
+    uint32_t firstLocation;     // Location IDs (see HappensBeforeDetector::location)
+    uint32_t secondLocation;
+};
+
+/**
+ * @class HappensBeforeDetector
+ * @brief FastTrack-style happens-before data race detector for OpenMP teams
+ *
+ * Every team thread carries a vector clock. Each 8-byte word of instrumented
+ * memory carries a shadow entry with the epoch (thread, clock) of its last
+ * write and of its last read; the reads only inflate to a full vector clock
+ * while several threads read the word concurrently. Two accesses race when
+ * neither happens before the other, so accesses ordered by fork/join,
+ * barriers, locks or critical sections are not reported.
+ *
+ * Each thread checks its own accesses as they happen. The shadow entries are
+ * sharded over independently locked hash maps, so checking runs on all
+ * threads at once and costs O(1) per access on the epoch fast path (O(threads)
+ * only when reads are shared or at synchronization).
+ *
+ * Synchronization is reported through hooks:
+ *   - parallelBegin(n) / parallelEnd() around each parallel region (master)
+ *   - barrier() in place of #pragma omp barrier
+ *   - acquire(obj) after taking a lock or entering a critical section,
+ *     release(obj) before leaving it; obj is any address naming the lock
+ *
+ * startRecording() switches to record-then-analyze: the same hooks only
+ * append compact records to a trace file, and AccessTraceReader
+ * (access_trace.h) finds the races offline.
+ *
+ * Threads are identified by omp_get_thread_num(); nested teams are not tracked.
+ * Shadow state is per 8-byte word, so two threads writing different smaller
+ * variables in one word are reported as racing.
+ */
+class HappensBeforeDetector {
+public:
+    /**
+     * @brief Construct a detector
+     * @param maxThreads Largest team size to track (at most 256)
+     */
+    explicit HappensBeforeDetector(int maxThreads = omp_get_max_threads());
+    ~HappensBeforeDetector();
+
+    HappensBeforeDetector(const HappensBeforeDetector&) = delete;
+    HappensBeforeDetector& operator=(const HappensBeforeDetector&) = delete;
+
+    /**
+     * @brief Forget all shadow state, clocks and races
+     * @param maxThreads Largest team size to track from now on
+     */
+    void reset(int maxThreads);
+
+    /**
+     * @brief Intern a source location label
+     * @param label Label such as "file.cpp:42"
+     * @return ID to pass to read/write; takes a lock, so keep it per call site
+     */
+    uint32_t location(const std::string& label);
+
+    /**
+     * @brief Label of an interned location
+     * @param id ID returned by location, or 0 for unknown
+     */
+    std::string locationName(uint32_t id) const;
+
+    /**
+     * @brief Fork edge: called by the master thread before a parallel region
+     * @param numThreads Team size of the region
+     */
+    void parallelBegin(int numThreads);
+
+    /**
+     * @brief Join edge: called by the master thread after a parallel region
+     */
+    void parallelEnd();
+
+    /**
+     * @brief Team barrier; call from every thread instead of #pragma omp barrier
+     */
+    void barrier();
+
+    /**
+     * @brief Acquire edge: called after taking the lock named by sync
+     * @param sync Address identifying the lock or critical section
+     */
+    void acquire(const void* sync);
+
+    /**
+     * @brief Release edge: called before releasing the lock named by sync
+     * @param sync Address identifying the lock or critical section
+     */
+    void release(const void* sync);
+
+    /**
+     * @brief Check a read of the word containing address
+     * @param address Address read
+     * @param location Location ID of the read
+     */
+    void read(const void* address, uint32_t location = 0);
+
+    /**
+     * @brief Check a write to the word containing address
+     * @param address Address written
+     * @param location Location ID of the write
+     */
+    void write(const void* address, uint32_t location = 0);
+
+    /**
+     * @brief Write accesses and synchronization to a trace instead of checking them
+     *
+     * Until stopRecording, read/write and the synchronization hooks append
+     * 16-byte records to per-thread buffers that are flushed to path. No
+     * shadow state is kept and no races are reported during the run; analyze
+     * the trace afterwards with AccessTraceReader (analysis_tools analyze).
+     * Call outside parallel regions.
+     *
+     * @param path Trace file
+     * @return false if the file cannot be created
+     */
+    bool startRecording(const std::string& path);
+
+    /**
+     * @brief Flush the trace, write its location table and close it
+     * @return Records written
+     */
+    uint64_t stopRecording();
+
+    bool isRecording() const { return m_recorder != nullptr; }
+
+    /**
+     * @brief Name an array in the trace for the offline layout analyses
+     * @param name Array name used in the report
+     * @param start First element
+     * @param elementSize Element size in bytes
+     * @param count Number of elements
+     */
+    void recordRegion(const std::string& name, const void* start, size_t elementSize, size_t count);
+
+    /**
+     * @brief Races found so far, by address
+     * @return At most one race per word; see raceCount for the total
+     */
+    std::vector<HBRace> races() const;
+
+    /**
+     * @brief Number of words with a race
+     */
+    uint64_t raceCount() const;
+
+    /**
+     * @brief Number of accesses checked
+     */
+    uint64_t accessCount() const;
+
+    /**
+     * @brief Number of words with shadow state
+     */
+    uint64_t shadowWords() const;
+
+private:
+    using Clock = uint32_t;
+    using Epoch = uint64_t;             // clock << 8 | thread; 0 is "none"
+
+    static const Epoch kSharedReads = ~0ULL;
+    static const size_t kShards = 256;
+    static const size_t kMaxRacesPerShard = 64;
+
+    struct ShadowWord {
+        Epoch write = 0;
+        Epoch read = 0;                 // kSharedReads when readers holds the reads
+        std::unique_ptr<Clock[]> readers;
+        uint32_t writeLocation = 0;
+        uint32_t readLocation = 0;
+        bool reported = false;
+    };
+
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::unordered_map<uintptr_t, ShadowWord> words;
+        std::vector<HBRace> races;
+        uint64_t raceCount = 0;
+    };
+
+    // Written by its own thread, or by the master outside parallel regions
+    struct alignas(64) ThreadState {
+        std::vector<Clock> clock;
+        uint64_t accesses = 0;
+        uint64_t barriers = 0;
+    };
+
+    static Epoch makeEpoch(int thread, Clock clock) { return (static_cast<Epoch>(clock) << 8) | static_cast<Epoch>(thread); }
+    static int epochThread(Epoch e) { return static_cast<int>(e & 0xFF); }
+    static Clock epochClock(Epoch e) { return static_cast<Clock>(e >> 8); }
+    static bool happensBefore(Epoch e, const std::vector<Clock>& clock) {
+        return epochClock(e) <= clock[epochThread(e)];
+    }
+    static void join(std::vector<Clock>& into, const std::vector<Clock>& from);
+
+    ThreadState* currentThread(int& thread);
+    Shard& shardFor(uintptr_t word);
+    void reportRace(Shard& shard, ShadowWord& shadow, uintptr_t word, HBRaceKind kind,
+                    int firstThread, uint32_t firstLocation, int secondThread, uint32_t secondLocation);
+
+    int m_maxThreads;
+    std::vector<ThreadState> m_threads;
+    std::unique_ptr<AccessTraceWriter> m_recorder;
+    std::unique_ptr<Shard[]> m_shards;
+
+    // Clocks of locks and critical sections
+    std::mutex m_syncMutex;
+    std::unordered_map<const void*, std::vector<Clock>> m_syncClocks;
+
+    // Three barrier slots: a slot is cleared two barriers after its use, when
+    // every thread has certainly read it
+    std::vector<Clock> m_barrierClocks[3];
+
+    mutable std::mutex m_locationMutex;
+    std::deque<std::string> m_locations;
+    std::unordered_map<std::string, uint32_t> m_locationIds;
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Hardware counter values of one thread (or a sum over threads)
+ *
+ * Values are cumulative when read and become interval counts when one
+ * reading is subtracted from a later one.
+ */
+struct CounterSample {
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t llcMisses = 0;         // Last-level cache read misses
+    uint64_t branchMisses = 0;
+    uint64_t dtlbMisses = 0;        // Data TLB read misses
+    bool valid = false;
+
+    /**
+     * @brief Instructions per cycle
+     */
+    double ipc() const { return cycles > 0 ? static_cast<double>(instructions) / cycles : 0.0; }
+
+    /**
+     * @brief Misses per thousand instructions
+     */
+    static double perKiloInstruction(uint64_t events, uint64_t instructions) {
+        return instructions > 0 ? 1000.0 * events / instructions : 0.0;
+    }
+    double llcMpki() const { return perKiloInstruction(llcMisses, instructions); }
+    double branchMpki() const { return perKiloInstruction(branchMisses, instructions); }
+    double dtlbMpki() const { return perKiloInstruction(dtlbMisses, instructions); }
+
+    CounterSample operator-(const CounterSample& start) const {
+        CounterSample delta;
+        delta.cycles = cycles - start.cycles;
+        delta.instructions = instructions - start.instructions;
+        delta.llcMisses = llcMisses - start.llcMisses;
+        delta.branchMisses = branchMisses - start.branchMisses;
+        delta.dtlbMisses = dtlbMisses - start.dtlbMisses;
+        delta.valid = valid && start.valid;
+        return delta;
+    }
+
+    CounterSample& operator+=(const CounterSample& other) {
+        cycles += other.cycles;
+        instructions += other.instructions;
+        llcMisses += other.llcMisses;
+        branchMisses += other.branchMisses;
+        dtlbMisses += other.dtlbMisses;
+        valid = valid || other.valid;
+        return *this;
+    }
+};
+
+/**
+ * @class HardwareCounters
+ * @brief Per-thread grouped hardware counters
+ *
+ * On Linux each thread opens one perf_event group on first use: cycles as the
+ * leader, then instructions, LLC read misses, branch misses and dTLB read
+ * misses, counted in user mode only. The group is read with one read() call,
+ * so the five values cover the same interval; if the kernel multiplexed the
+ * group, the values are scaled by time enabled / time running. Events the CPU
+ * does not support read as zero.
+ *
+ * Other platforms have no backend yet; every sample is invalid.
+ */
+class HardwareCounters {
+public:
+    /**
+     * @brief Whether counters can be opened (tried once, on the calling thread)
+     */
+    static bool isAvailable();
+
+    /**
+     * @brief Why counters are unavailable, empty if they are available
+     */
+    static std::string unavailableReason();
+
+    /**
+     * @brief Cumulative counts of the calling thread
+     * @return Invalid sample if the counters could not be opened
+     */
+    static CounterSample readThread();
+
+    /**
+     * @brief Cumulative counts summed over every thread that has read its counters
+     *
+     * Includes threads that have exited since.
+     */
+    static CounterSample readProcess();
+
+    /**
+     * @brief Name of the backend, e.g. "perf_event"
+     */
+    static const char* backendName();
+};
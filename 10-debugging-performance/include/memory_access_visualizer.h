@@ -6,6 +6,9 @@
 #include <map>
 #include <set>
 #include <chrono>
+#include <atomic>
+#include <memory>
+#include <cstdint>
 #include <omp.h>
 #include <iostream>
 
@@ -16,21 +19,29 @@
  * This class provides functionality to track memory accesses in OpenMP
  * parallel regions and generate visualizations to help identify patterns
  * and potential issues like false sharing.
+ *
+ * Each thread writes its accesses into its own fixed-size ring of packed
+ * records, with no lock; when the ring is full the oldest records are
+ * overwritten. With a sampling rate of N only about one access in N is
+ * recorded (at randomized intervals, so strided loops do not alias), and
+ * the reports scale counts back up by N. Regions must be tracked before the
+ * parallel work starts, and reports read after it ends.
  */
 
-// Structure to track memory access information
-struct MemoryAccess {
-    void* address;
-    int threadId;
-    bool isWrite;
-    std::chrono::steady_clock::time_point timestamp;
+// One recorded access, packed into 16 bytes
+struct TraceRecord {
+    uint32_t offset;    // Byte offset into the region
+    uint16_t region;    // Index of the tracked region
+    uint8_t threadId;   // Thread ID (saturates at 255)
+    uint8_t isWrite;    // 1 for a write, 0 for a read
+    uint64_t ticks;     // Timestamp counter at the access
 };
 
 // Structure to track cache line information
 struct CacheLineInfo {
     size_t lineNumber;
-    size_t accessCount;
-    size_t writeCount;
+    size_t accessCount;     // Estimated accesses (samples times the sampling rate)
+    size_t writeCount;      // Estimated writes
     std::set<int> threads;
     bool hasFalseSharing;
 };
@@ -128,6 +139,24 @@ public:
      */
     void analyzeFalseSharing(std::ostream& out = std::cout);
 
+    /**
+     * @brief Record about one access in N
+     * @param rate N; 1 records every access
+     */
+    void setSamplingRate(uint32_t rate);
+
+    /**
+     * @brief Get the sampling rate
+     * @return N, where about one access in N is recorded
+     */
+    uint32_t getSamplingRate() const;
+
+    /**
+     * @brief Set the ring size for threads that have not recorded yet
+     * @param records Records per thread (16 bytes each)
+     */
+    void setTraceCapacity(size_t records);
+
     /**
      * @brief Reset the tracker, clearing all tracked arrays and accesses
      */
@@ -162,22 +191,45 @@ private:
         std::string name;
     };
 
+    // Written only by its owning thread
+    struct alignas(64) ThreadTrace {
+        std::vector<TraceRecord> ring;
+        uint64_t written = 0;       // Records ever written; the ring keeps the last ring.size()
+        uint64_t countdown = 1;     // Accesses until the next sample
+        uint64_t rngState = 0;      // xorshift state for the sampling interval
+    };
+
+    // Regions are stored in a vector reserved up front, so recording threads can
+    // read the first m_regionCount entries while no region is being added
+    static const size_t kMaxRegions = 1024;
+    static const size_t kDefaultTraceCapacity = 1 << 18;
+
     std::vector<TrackedRegion> m_trackedRegions;
-    std::vector<MemoryAccess> m_accesses;
+    std::atomic<size_t> m_regionCount;
+    std::vector<std::unique_ptr<ThreadTrace>> m_traces;
     mutable std::mutex m_mutex;
     size_t m_cacheLineSize;
-    bool m_enabled;
+    std::atomic<bool> m_enabled;
+    std::atomic<uint32_t> m_samplingRate;
+    size_t m_traceCapacity;
     std::chrono::steady_clock::time_point m_startTime;
+    uint64_t m_startTicks;
 
     // Helper methods
+    ThreadTrace& localTrace();
+    static uint64_t readTicks();
+    uint64_t nextSampleInterval(ThreadTrace& trace) const;
+    std::vector<TraceRecord> collectTrace() const;
+    double ticksPerMicrosecond() const;
     bool isAddressInRegion(void* address, const TrackedRegion& region) const;
     size_t getCacheLineNumber(void* address) const;
-    std::string getRegionName(void* address) const;
-    std::map<size_t, CacheLineInfo> analyzeCacheLineUsage() const;
+    size_t getCacheLineNumber(const TraceRecord& record) const;
+    std::map<size_t, CacheLineInfo> analyzeCacheLineUsage(const std::vector<TraceRecord>& trace) const;
     void generateHeatmap(std::ostream& out, const TrackedRegion& region, 
                          const std::map<size_t, CacheLineInfo>& cacheLines) const;
-    void generateAccessTimeline(std::ostream& out) const;
-    void generateSummary(std::ostream& out, const std::map<size_t, CacheLineInfo>& cacheLines) const;
+    void generateAccessTimeline(std::ostream& out, const std::vector<TraceRecord>& trace) const;
+    void generateSummary(std::ostream& out, const std::vector<TraceRecord>& trace,
+                         const std::map<size_t, CacheLineInfo>& cacheLines) const;
 };
 
 // Helper macros for memory access tracking
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @enum StreamKernel
+ * @brief The four STREAM kernels (McCalpin)
+ */
+enum class StreamKernel {
+    Copy,   ///< c[i] = a[i]            (16 bytes per element)
+    Scale,  ///< b[i] = s * c[i]        (16 bytes per element)
+    Add,    ///< c[i] = a[i] + b[i]     (24 bytes per element)
+    Triad   ///< a[i] = b[i] + s * c[i] (24 bytes per element)
+};
+
+/**
+ * @brief Bandwidth of the STREAM kernels for one thread count and placement
+ *
+ * Bandwidths are in MB/s (1 MB = 2^20 bytes, as elsewhere in this project) and
+ * count only the bytes the kernel names: reads plus writes, no write-allocate
+ * traffic. The best trial is reported, as STREAM does.
+ */
+struct StreamResult {
+    int threads = 0;
+    int cpuNode = -1;           // Node the threads were bound to, -1 if unbound
+    int memNode = -1;           // Node the arrays were placed on, -1 for first touch
+    size_t arrayBytes = 0;      // Size of each of the three arrays
+    double copyMBps = 0.0;
+    double scaleMBps = 0.0;
+    double addMBps = 0.0;
+    double triadMBps = 0.0;
+
+    /**
+     * @brief Bandwidth of one kernel
+     */
+    double bandwidth(StreamKernel kernel) const;
+};
+
+/**
+ * @brief Latency of one dependent load at one working-set size
+ */
+struct LatencyPoint {
+    size_t workingSetBytes = 0;
+    double nsPerLoad = 0.0;
+};
+
+/**
+ * @brief A plateau of the latency curve, i.e. one level of the memory hierarchy
+ */
+struct LatencyLevel {
+    std::string name;           // "L1", "L2", "L3", ... with the last level "DRAM"
+    size_t upToBytes = 0;       // Largest working set measured on this plateau
+    double nsPerLoad = 0.0;     // Median latency of the plateau
+};
+
+/**
+ * @brief Measured limits of the machine that access patterns are judged against
+ */
+struct MemoryLimits {
+    std::vector<StreamResult> threadSweep;     // Threads first-touching their own data
+    std::vector<StreamResult> nodePairs;       // Every (cpu node, memory node) pair; empty on one node
+    std::vector<LatencyPoint> latencyCurve;
+    std::vector<LatencyLevel> latencyLevels;
+
+    /**
+     * @brief Best triad bandwidth of the thread sweep with at most numThreads threads
+     */
+    double triadMBps(int numThreads) const;
+
+    /**
+     * @brief Best triad bandwidth of the whole thread sweep
+     */
+    double peakTriadMBps() const;
+
+    /**
+     * @brief Latency of the last plateau (DRAM), or 0 if not measured
+     */
+    double dramLatencyNs() const;
+};
+
+/**
+ * @class MemoryProbes
+ * @brief Calibrated bandwidth and latency probes
+ *
+ * runStream() is STREAM: three double arrays, the four kernels over a static
+ * schedule, with pages first touched by the thread that later streams them
+ * (or bound to one node for node pairings). Arrays should be at least four
+ * times the last-level cache so the kernels measure memory, not cache.
+ *
+ * pointerChase() follows a random cyclic permutation of cache lines, so each
+ * load depends on the previous one and neither the prefetcher nor
+ * memory-level parallelism can hide the latency. Plotted over working-set
+ * sizes it shows one plateau per level of the hierarchy.
+ */
+class MemoryProbes {
+public:
+    /**
+     * @brief Printable kernel name, e.g. "Triad"
+     */
+    static const char* kernelName(StreamKernel kernel);
+
+    /**
+     * @brief Run the four STREAM kernels
+     * @param arrayBytes Size of each of the three arrays
+     * @param numThreads Number of threads
+     * @param trials Number of timed repetitions; the best one counts
+     * @param cpuNode NUMA node to bind the threads to, -1 to leave them unbound
+     * @param memNode NUMA node to place the arrays on, -1 for first touch
+     */
+    static StreamResult runStream(size_t arrayBytes, int numThreads, int trials = 5,
+                                  int cpuNode = -1, int memNode = -1);
+
+    /**
+     * @brief STREAM at 1, 2, 4, ... threads and at maxThreads
+     */
+    static std::vector<StreamResult> sweepThreads(size_t arrayBytes, int maxThreads, int trials = 5);
+
+    /**
+     * @brief STREAM for every pairing of thread node and memory node
+     * @return One result per pair, local pairs included; empty on a single-node system
+     */
+    static std::vector<StreamResult> sweepNodePairs(size_t arrayBytes, int numThreads, int trials = 5);
+
+    /**
+     * @brief Dependent-load latency at working-set sizes from minBytes to maxBytes
+     * @param minBytes Smallest working set
+     * @param maxBytes Largest working set
+     * @param pointsPerOctave Sizes measured per doubling of the working set
+     */
+    static std::vector<LatencyPoint> pointerChase(size_t minBytes, size_t maxBytes, int pointsPerOctave = 2);
+
+    /**
+     * @brief Split a latency curve into plateaus at each jump in latency
+     * @param curve Curve from pointerChase, smallest working set first
+     * @param jumpRatio Latency ratio between neighbouring sizes that starts a new level
+     */
+    static std::vector<LatencyLevel> findLevels(const std::vector<LatencyPoint>& curve, double jumpRatio = 1.4);
+
+    /**
+     * @brief Run the thread sweep, the node pairings and the latency curve
+     * @param arrayBytes Size of each STREAM array; also the largest chased working set
+     * @param maxThreads Largest thread count
+     * @param verbose Print each result as it is measured
+     */
+    static MemoryLimits measure(size_t arrayBytes, int maxThreads, bool verbose = false);
+
+    /**
+     * @brief Print the STREAM tables, the latency curve and its levels
+     */
+    static void printLimits(const MemoryLimits& limits);
+
+    /**
+     * @brief Last-level cache size reported by the OS, 0 if unknown
+     */
+    static size_t lastLevelCacheBytes();
+};
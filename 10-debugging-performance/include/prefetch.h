@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+#if defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+/**
+ * @brief Default number of items a gather prefetches ahead
+ *
+ * Enough loads in flight to cover DRAM latency on current cores (about 10-20
+ * outstanding L1 misses each) without evicting lines before they are used.
+ */
+constexpr size_t DEFAULT_PREFETCH_DISTANCE = 16;
+
+/**
+ * @brief Hint that a line will be read soon
+ */
+inline void prefetchRead(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+    (void)address;
+#endif
+}
+
+/**
+ * @brief Hint that a line will be written soon
+ */
+inline void prefetchWrite(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address, 1, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+    (void)address;
+#endif
+}
+
+/**
+ * @brief Apply op to data[indices[i]] for each i, prefetching distance items ahead
+ *
+ * The hardware prefetcher cannot follow an index list, so without help every
+ * element costs a full miss. Prefetching the element distance positions
+ * ahead keeps that many misses in flight while the current one is used.
+ *
+ * @param data Array gathered from
+ * @param indices Positions in data, in access order
+ * @param count Number of indices
+ * @param distance Items to prefetch ahead (0 disables prefetching)
+ * @param op Called as op(data[indices[i]])
+ */
+template<typename T, typename Index, typename Op>
+void prefetchedGather(T* data, const Index* indices, size_t count, size_t distance, Op op) {
+    const size_t ahead = std::min(distance, count);
+    size_t i = 0;
+    if (distance > 0) {
+        for (; i + ahead < count; i++) {
+            prefetchWrite(&data[indices[i + ahead]]);
+            op(data[indices[i]]);
+        }
+    }
+    for (; i < count; i++) {
+        op(data[indices[i]]);
+    }
+}
+
+/**
+ * @brief Apply op to data[indices[i]] in groups: prefetch a whole group, then use it
+ *
+ * Group prefetching: the first pass over a group issues all its prefetches
+ * back to back, the second pass finds the lines arriving or present. Fewer
+ * branches per item than prefetchedGather, but the misses of one group are
+ * not overlapped with the work of the previous one.
+ *
+ * @param data Array gathered from
+ * @param indices Positions in data, in access order
+ * @param count Number of indices
+ * @param groupSize Items per group
+ * @param op Called as op(data[indices[i]])
+ */
+template<typename T, typename Index, typename Op>
+void groupPrefetchedGather(T* data, const Index* indices, size_t count, size_t groupSize, Op op) {
+    groupSize = std::max<size_t>(groupSize, 1);
+    for (size_t group = 0; group < count; group += groupSize) {
+        const size_t end = std::min(group + groupSize, count);
+        for (size_t i = group; i < end; i++) {
+            prefetchWrite(&data[indices[i]]);
+        }
+        for (size_t i = group; i < end; i++) {
+            op(data[indices[i]]);
+        }
+    }
+}
+
+/**
+ * @brief Run many independent pointer-chasing lookups interleaved (AMAC)
+ *
+ * Asynchronous memory access chaining: up to width lookups are in flight, each
+ * a small state machine. Every step uses the line prefetched by that lookup's
+ * previous step, then prefetches its next line and yields to the next lookup,
+ * so the misses of different lookups overlap even though the steps within one
+ * lookup are dependent. A finished lookup's slot immediately takes the next
+ * request, so lookups of different lengths (chain walks, probe sequences) do
+ * not stall each other.
+ *
+ * Lookup must provide:
+ *   - a State type;
+ *   - void begin(size_t request, State& state): start a request and prefetch its first line;
+ *   - bool advance(State& state): take one step; return true when the lookup is complete,
+ *     otherwise prefetch the next line and return false.
+ *
+ * @param lookup The lookup state machine
+ * @param count Number of requests, numbered 0 to count - 1
+ * @param width Lookups kept in flight
+ */
+template<typename Lookup>
+void interleavedLookup(Lookup& lookup, size_t count, size_t width) {
+    using State = typename Lookup::State;
+    width = std::max<size_t>(std::min(width, count), 1);
+    std::vector<State> states(width);
+    std::vector<char> busy(width, 0);
+
+    size_t next = 0;
+    size_t active = 0;
+    for (size_t slot = 0; slot < width && next < count; slot++) {
+        lookup.begin(next++, states[slot]);
+        busy[slot] = 1;
+        active++;
+    }
+
+    while (active > 0) {
+        for (size_t slot = 0; slot < width; slot++) {
+            if (!busy[slot] || !lookup.advance(states[slot])) {
+                continue;
+            }
+            if (next < count) {
+                lookup.begin(next++, states[slot]);
+            } else {
+                busy[slot] = 0;
+                active--;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Repeated strided sweeps over [begin, end), one cache-sized tile at a time
+ *
+ * A loop that makes passes strided sweeps over a large range misses on every
+ * access of every pass. Running all passes over one tile before moving to the
+ * next keeps the tile's lines in cache after the first pass. Each index is
+ * visited passes times, as in the untiled loop; only the order across
+ * indices changes, so op must not depend on that order.
+ *
+ * @param begin First index
+ * @param end One past the last index
+ * @param stride Distance between visited indices
+ * @param passes Number of sweeps
+ * @param tileElements Tile length in elements (rounded up to a multiple of stride)
+ * @param op Called as op(index)
+ */
+template<typename Op>
+void tiledStridedSweep(size_t begin, size_t end, size_t stride, size_t passes, size_t tileElements, Op op) {
+    stride = std::max<size_t>(stride, 1);
+    // Whole strides per tile keep every tile on the untiled loop's index grid
+    const size_t tile = std::max<size_t>((tileElements + stride - 1) / stride, 1) * stride;
+    for (size_t tileBegin = begin; tileBegin < end; tileBegin += tile) {
+        const size_t tileEnd = std::min(tileBegin + tile, end);
+        for (size_t pass = 0; pass < passes; pass++) {
+            for (size_t i = tileBegin; i < tileEnd; i += stride) {
+                op(i);
+            }
+        }
+    }
+}
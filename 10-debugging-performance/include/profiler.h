@@ -2,10 +2,14 @@
 
 #include <string>
 #include <vector>
+#include <deque>
+#include <memory>
+#include <atomic>
 #include <chrono>
 #include <mutex>
 #include <unordered_map>
 #include <omp.h>
+#include "hardware_counters.h"
 
 /**
  * @class Profiler
@@ -13,16 +17,53 @@
  * 
  * This class provides simple timing and profiling functionality for tracking
  * performance of code regions, particularly in multi-threaded OpenMP applications.
+ *
+ * Section names are interned once into integer IDs. Each thread records its
+ * events into its own buffer, so starting and ending a section by ID takes no
+ * lock, shares no cache line and allocates only when the buffer grows. The
+ * buffers are merged when results are read, which must happen after the
+ * profiled threads have finished.
+ *
+ * With setHardwareCounters(true), each section also records the hardware
+ * counter deltas (cycles, instructions, cache, branch and TLB misses) of its
+ * thread; see HardwareCounters.
+ *
+ * Nested sections form call paths. A section a worker starts outside any
+ * other section of its own is placed under the section the forking thread
+ * had open, so work inside parallel regions and tasks appears under the code
+ * that started it. A task run by another thread of the team goes under the
+ * section its parallel region was forked from, because OpenMP cannot say
+ * which section created the task. getCallTree and saveFoldedStacks report
+ * these paths.
  */
 class Profiler {
 public:
+    using SectionId = int;
+    using Clock = std::chrono::high_resolution_clock;
+
     struct ProfilePoint {
         std::string name;                          // Name of the profile point
-        std::chrono::high_resolution_clock::time_point startTime;  // Start time
-        std::chrono::high_resolution_clock::time_point endTime;    // End time
+        Clock::time_point startTime;               // Start time
+        Clock::time_point endTime;                 // End time
         double duration;                           // Duration in milliseconds
         int threadId;                              // Thread ID
         int level;                                 // Nesting level
+        CounterSample counters;                    // Counter deltas; valid only if counters were on
+    };
+
+    /**
+     * @brief One call path of nested sections, with its callees
+     *
+     * Times sum over calls and threads, so a parent whose callees ran on
+     * several threads has less inclusive time than its callees together.
+     * Exclusive time is the part not spent in callees on the same thread.
+     */
+    struct CallPathNode {
+        std::string name;
+        int calls = 0;
+        double inclusive = 0.0;                    // Milliseconds
+        double exclusive = 0.0;                    // Milliseconds
+        std::vector<CallPathNode> children;        // By inclusive time, largest first
     };
 
     /**
@@ -31,6 +72,29 @@ public:
      */
     static Profiler& getInstance();
 
+    /**
+     * @brief Intern a section name
+     * @param name Name of the section
+     * @return ID that is the same for every call with this name
+     *
+     * Takes a lock; call it once per call site and keep the ID (PROFILE_SCOPE
+     * does this in a function-local static).
+     */
+    static SectionId internSection(const std::string& name);
+
+    /**
+     * @brief Name of an interned section
+     * @param id ID returned by internSection
+     */
+    static const std::string& sectionName(SectionId id);
+
+    /**
+     * @brief Start a profiling section by interned ID (fast path)
+     * @param id ID returned by internSection
+     * @return Token for the matching endSection call, or -1 if disabled
+     */
+    int startSection(SectionId id);
+
     /**
      * @brief Start a profiling section
      * @param name Name of the section to profile
@@ -41,6 +105,8 @@ public:
     /**
      * @brief End a profiling section
      * @param id ID returned from the matching startSection call
+     *
+     * Must be called on the thread that started the section.
      */
     void endSection(int id);
 
@@ -55,13 +121,17 @@ public:
      * @brief End an event for profiling
      * @param name Name of the event
      * @param threadId ID of the thread
-     * @param durationMicros Duration in microseconds
+     * @param durationMicros Ignored; the recorded start and end times are used
      */
     void endEvent(const std::string& name, int threadId, double durationMicros);
 
     /**
      * @brief Start collecting system metrics
      * @param intervalMs Interval in milliseconds
+     *
+     * Where RAPL is readable (see EnergyMeter), each sample also records
+     * package and DRAM energy and the effective core frequency. The report
+     * then gives joules per run and per section.
      */
     void startSystemMetricCollection(int intervalMs = 500);
 
@@ -73,9 +143,22 @@ public:
     /**
      * @brief Generate a report of profiling data
      * @param filename Filename to save the report
+     *
+     * Includes energy per run, average power, effective frequency and
+     * performance per watt when system metrics were collected with RAPL.
      */
     void generateReport(const std::string& filename);
 
+    /**
+     * @brief Profile a function or code block with automatic timing
+     * @param id Interned section ID
+     * @param function Function to profile (typically a lambda)
+     * @return The result of the function call
+     */
+    template<typename Func, typename... Args>
+    auto profileFunction(SectionId id, Func&& function, Args&&... args) 
+        -> decltype(function(std::forward<Args>(args)...));
+
     /**
      * @brief Profile a function or code block with automatic timing
      * @param name Name of the section to profile
@@ -85,18 +168,47 @@ public:
     template<typename Func, typename... Args>
     auto profileFunction(const std::string& name, Func&& function, Args&&... args) 
         -> decltype(function(std::forward<Args>(args)...)) {
-        int id = startSection(name);
-        auto result = function(std::forward<Args>(args)...);
-        endSection(id);
-        return result;
+        return profileFunction(internSection(name), std::forward<Func>(function), std::forward<Args>(args)...);
     }
 
     /**
      * @brief Get all collected profile points
-     * @return Vector of all profile points
+     * @return Vector of all profile points, merged from the thread buffers
      */
     const std::vector<ProfilePoint>& getProfilePoints() const;
 
+    /**
+     * @brief Call-path tree of nested sections
+     * @param thread Index of a thread buffer (see getThreadCount), or -1 for all threads merged
+     * @return Root node named "all" whose children are the outermost sections and
+     *         whose inclusive time is the thread time of all sections
+     */
+    CallPathNode getCallTree(int thread = -1) const;
+
+    /**
+     * @brief Number of threads that recorded sections
+     */
+    int getThreadCount() const;
+
+    /**
+     * @brief Save call paths in folded-stack format (flamegraph.pl, speedscope)
+     * @param filename Output file; one "outer;inner;leaf microseconds" line per path
+     * @param perThread Start every stack with a "thread N" frame instead of merging threads
+     * @return true if successful
+     *
+     * The value of each line is the exclusive time of its path.
+     */
+    bool saveFoldedStacks(const std::string& filename, bool perThread = false) const;
+
+    /**
+     * @brief Print the merged call-path tree to stdout
+     * @param minPercent Hide paths below this share of the total thread time
+     *
+     * The share of a path counts its callees on every thread, as its width in
+     * a flame graph does.
+     */
+    void printCallTree(double minPercent = 0.5) const;
+
     /**
      * @brief Save collected profile data to a CSV file
      * @param filename Name of the CSV file to create
@@ -115,6 +227,13 @@ public:
      */
     void printSummary(bool sortByTime = true) const;
 
+    /**
+     * @brief Measure the cost of one start/end pair on the fast path
+     * @param pairs Number of pairs to time
+     * @return Nanoseconds per pair; the probe events are discarded
+     */
+    double measureProbeOverhead(int pairs = 100000);
+
     /**
      * @brief Enable or disable the profiler
      * @param enabled Whether profiling is enabled
@@ -127,6 +246,20 @@ public:
      */
     bool isEnabled() const;
 
+    /**
+     * @brief Record hardware counter deltas for each section
+     * @param enabled Whether to read the counters at section start and end
+     * @return true if counters are now being recorded (false if unavailable)
+     *
+     * Each read is a system call, so sections get noticeably more expensive.
+     */
+    bool setHardwareCounters(bool enabled);
+
+    /**
+     * @brief Check if hardware counters are recorded for sections
+     */
+    bool hardwareCountersEnabled() const;
+
 private:
     // Private constructor for singleton pattern
     Profiler();
@@ -136,15 +269,45 @@ private:
     Profiler(const Profiler&) = delete;
     Profiler& operator=(const Profiler&) = delete;
 
-    std::vector<ProfilePoint> m_profilePoints;
-    std::mutex m_mutex;
-    int m_nextId;
-    bool m_enabled;
-    std::unordered_map<int, int> m_activePoints;  // Thread ID -> Profile Point ID
-    
-    // Implementation details
+    struct Event {
+        SectionId section;
+        int threadId;
+        int level;
+        int ompLevel;               // omp_get_level() at start
+        int forkThread;             // At level 0 of the buffer: forking thread's number one OpenMP level up
+        Clock::time_point startTime;
+        Clock::time_point endTime;
+        CounterSample counters;     // Reading at start, delta once ended
+    };
+
+    struct OpenEvent {
+        SectionId section;
+        int token;
+    };
+
+    // Written only by its owning thread
+    struct alignas(64) ThreadBuffer {
+        std::vector<Event> events;
+        std::vector<OpenEvent> openEvents;  // startEvent/endEvent pairs by name
+        int depth = 0;                      // Sections currently open
+    };
+
+    ThreadBuffer& localBuffer();
+
+    // Call paths of every recorded section; m_mutex held
+    struct CallPaths;
+    void buildCallPaths(CallPaths& paths) const;
+
+    mutable std::vector<ProfilePoint> m_profilePoints;
+    mutable std::mutex m_mutex;  // Guards m_buffers and m_profilePoints
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+    std::atomic<bool> m_enabled;
+    std::atomic<bool> m_countersEnabled;
+    double m_probeOverheadNs;
+
+    // System metrics and the HTML report (custom_profiler)
     class ProfilerImpl;
-    ProfilerImpl* impl;
+    static ProfilerImpl& impl();
 };
 
 /**
@@ -156,6 +319,12 @@ private:
  */
 class ScopedProfile {
 public:
+    /**
+     * @brief Construct a new Scoped Profile object (fast path)
+     * @param id Interned section ID
+     */
+    explicit ScopedProfile(Profiler::SectionId id);
+
     /**
      * @brief Construct a new Scoped Profile object
      * @param name Name of the profile section
@@ -167,15 +336,39 @@ public:
      */
     ~ScopedProfile();
 
+    ScopedProfile(const ScopedProfile&) = delete;
+    ScopedProfile& operator=(const ScopedProfile&) = delete;
+
 private:
     int m_id;
 };
 
-// Convenience macro for scoped profiling
+template<typename Func, typename... Args>
+auto Profiler::profileFunction(SectionId id, Func&& function, Args&&... args) 
+    -> decltype(function(std::forward<Args>(args)...)) {
+    ScopedProfile scope(id);
+    return function(std::forward<Args>(args)...);
+}
+
+// Convenience macro for scoped profiling; the name is interned on first use
+#define PROFILER_CONCAT_INNER(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_INNER(a, b)
+
+// Profiled scopes are also VTune tasks or Nsight ranges in PERF_MARKERS=ITT/NVTX builds
+#include "perf_markers.h"
+#if defined(PERF_MARKERS_ITT) || defined(PERF_MARKERS_NVTX)
+    #define PROFILE_MARKER(name) PERF_SCOPE(name)
+#else
+    #define PROFILE_MARKER(name)
+#endif
+
 #ifdef PROFILE
-    #define PROFILE_SCOPE(name) ScopedProfile profiler_##__LINE__(name)
-    #define PROFILE_FUNCTION() ScopedProfile profiler_function(__FUNCTION__)
+    #define PROFILE_SCOPE(name) \
+        static const Profiler::SectionId PROFILER_CONCAT(profiler_section_, __LINE__) = Profiler::internSection(name); \
+        ScopedProfile PROFILER_CONCAT(profiler_scope_, __LINE__)(PROFILER_CONCAT(profiler_section_, __LINE__)); \
+        PROFILE_MARKER(name)
+    #define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
 #else
-    #define PROFILE_SCOPE(name)
-    #define PROFILE_FUNCTION()
-#endif
\ No newline at end of file
+    #define PROFILE_SCOPE(name) PROFILE_MARKER(name)
+    #define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+#endif
@@ -13,36 +13,67 @@
 #include <atomic>
 #include <memory>
 #include <iomanip>
+#include <cmath>
+#include <filesystem>
 #include <omp.h>
+#ifdef _WIN32
 #include <Windows.h>
 
 // Define min/max macros to avoid conflicts with std::min/std::max
 #undef min
 #undef max
+#else
+#include <unistd.h>
+#endif
 
 #include "profiler.h"
 #include "debug_utils.h"
 #include "cli_parser.h"
-
-// Thread access analyzer for detecting race conditions
+#include "happens_before.h"
+#include "hardware_counters.h"
+#include "access_trace.h"
+#include "bench_core.h"
+
+// Thread access analyzer for detecting race conditions. Races are found by a
+// happens-before detector (see happens_before.h), so accesses ordered by the
+// synchronization hooks are not reported; a compact per-thread log of the
+// accesses feeds the array layout analyses. In recording mode the accesses
+// only go to a trace file and the same reports are produced offline by
+// "analysis_tools analyze <trace>" (see analyzeTrace).
 class CustomRaceDetector {
 private:
     struct MemoryAccess {
         void* address;
         int threadId;
-        std::string accessType; // "read", "write"
-        std::chrono::steady_clock::time_point timestamp;
-        std::string sourceLocation;
+        bool isWrite;
+    };
+
+    // Appended to only by its own thread
+    struct alignas(64) ThreadLog {
+        std::vector<MemoryAccess> accesses;
     };
 
-    std::vector<MemoryAccess> accesses;
-    std::mutex accessMutex;
+    std::vector<ThreadLog> logs;
+    HappensBeforeDetector hb;
     std::atomic<bool> enabled;
 
+    template<typename Func>
+    void forEachAccess(Func&& func) const {
+        for (const auto& log : logs) {
+            for (const auto& access : log.accesses) {
+                func(access);
+            }
+        }
+    }
+
 public:
-    CustomRaceDetector() : enabled(false) {}
+    CustomRaceDetector() : logs(omp_get_max_threads()), enabled(false) {}
 
     void enable() {
+        // Size the clocks for the current team size
+        if (logs.size() != static_cast<size_t>(omp_get_max_threads())) {
+            clear();
+        }
         enabled = true;
     }
 
@@ -54,37 +85,61 @@ public:
         return enabled;
     }
 
-    void recordAccess(void* address, int threadId, const std::string& accessType, const std::string& sourceLocation) {
+    // Synchronization hooks and location IDs; see HappensBeforeDetector
+    HappensBeforeDetector& happensBefore() {
+        return hb;
+    }
+
+    uint32_t location(const std::string& sourceLocation) {
+        return hb.location(sourceLocation);
+    }
+
+    // Record-then-analyze: accesses go to a trace file, nothing is checked in process
+    bool startRecording(const std::string& traceFile) {
+        // Size the trace for the current team size
+        clear();
+        return hb.startRecording(traceFile);
+    }
+
+    uint64_t stopRecording() {
+        return hb.stopRecording();
+    }
+
+    bool isRecording() const {
+        return hb.isRecording();
+    }
+
+    void recordAccess(void* address, int threadId, bool isWrite, uint32_t location) {
         if (!enabled) {
             return;
         }
         
-        std::lock_guard<std::mutex> lock(accessMutex);
-        
-        MemoryAccess access;
-        access.address = address;
-        access.threadId = threadId;
-        access.accessType = accessType;
-        access.timestamp = std::chrono::steady_clock::now();
-        access.sourceLocation = sourceLocation;
-        
-        accesses.push_back(access);
+        if (hb.isRecording()) {
+            // Only the trace; the layout analyses run offline
+        } else if (threadId >= 0 && threadId < static_cast<int>(logs.size())) {
+            logs[threadId].accesses.push_back({address, threadId, isWrite});
+        }
+        if (isWrite) {
+            hb.write(address, location);
+        } else {
+            hb.read(address, location);
+        }
     }
     
     void clear() {
-        std::lock_guard<std::mutex> lock(accessMutex);
-        accesses.clear();
+        int maxThreads = omp_get_max_threads();
+        logs = std::vector<ThreadLog>(maxThreads);
+        hb.reset(maxThreads);
     }
     
     void analyzeArrayAccess(void* arrayStart, size_t elementSize, size_t numElements, int threads) {
-        std::lock_guard<std::mutex> lock(accessMutex);
-        
+
         // Create maps to track which threads accessed which elements
         std::vector<std::set<int>> readThreads(numElements);
         std::vector<std::set<int>> writeThreads(numElements);
         
         // Identify array elements from raw memory addresses
-        for (const auto& access : accesses) {
+        forEachAccess([&](const MemoryAccess& access) {
             // Calculate if this access was within our array bounds
             uintptr_t accessAddr = reinterpret_cast<uintptr_t>(access.address);
             uintptr_t arrayAddr = reinterpret_cast<uintptr_t>(arrayStart);
@@ -97,15 +152,23 @@ public:
                 size_t elemIndex = elemOffset / elementSize;
                 
                 if (elemIndex < numElements) {
-                    if (access.accessType == "read") {
-                        readThreads[elemIndex].insert(access.threadId);
-                    } else if (access.accessType == "write") {
+                    if (access.isWrite) {
                         writeThreads[elemIndex].insert(access.threadId);
+                    } else {
+                        readThreads[elemIndex].insert(access.threadId);
                     }
                 }
             }
-        }
+        });
         
+        reportArrayAccess(readThreads, writeThreads, numElements, threads);
+    }
+    
+    // Print which threads touched which elements and count elements written by
+    // one thread while another thread also accessed them
+    static void reportArrayAccess(const std::vector<std::set<int>>& readThreads,
+                                  const std::vector<std::set<int>>& writeThreads,
+                                  size_t numElements, int threads) {
         // Analyze the access patterns
         std::cout << "Array access pattern analysis:\n";
         
@@ -128,7 +191,7 @@ public:
             const auto& elements = threadElements[threadId];
             if (!elements.empty()) {
                 std::cout << "  Thread " << threadId << " accessed " << elements.size() 
-                          << " elements (" << (elements.size() * 100 / numElements) << "% of array)\n";
+                          << " elements (" << (elements.size() * 100 / std::max<size_t>(numElements, 1)) << "% of array)\n";
                 
                 // Print range information if it's a continuous chunk
                 if (elements.size() > 1) {
@@ -204,13 +267,12 @@ public:
     
     void detectFalseSharing(void* arrayStart, size_t elementSize, size_t numElements, int threads) {
         const size_t CACHE_LINE_SIZE = 64; // Typical cache line size in bytes
-        std::lock_guard<std::mutex> lock(accessMutex);
         
         // Build a map of which threads access which cache lines
         size_t numCacheLines = (elementSize * numElements + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE;
         std::vector<std::map<int, std::pair<int, int>>> cacheLineAccess(numCacheLines); // threadId -> {reads, writes}
         
-        for (const auto& access : accesses) {
+        forEachAccess([&](const MemoryAccess& access) {
             // Calculate if this access was within our array bounds
             uintptr_t accessAddr = reinterpret_cast<uintptr_t>(access.address);
             uintptr_t arrayAddr = reinterpret_cast<uintptr_t>(arrayStart);
@@ -224,14 +286,22 @@ public:
                 
                 if (cacheLineIndex < numCacheLines) {
                     auto& threadStats = cacheLineAccess[cacheLineIndex][access.threadId];
-                    if (access.accessType == "read") {
-                        threadStats.first++;
-                    } else if (access.accessType == "write") {
+                    if (access.isWrite) {
                         threadStats.second++;
+                    } else {
+                        threadStats.first++;
                     }
                 }
             }
-        }
+        });
+        
+        reportFalseSharing(cacheLineAccess, elementSize, numElements, CACHE_LINE_SIZE);
+    }
+    
+    // Print the cache lines that more than one thread wrote to
+    static void reportFalseSharing(const std::vector<std::map<int, std::pair<int, int>>>& cacheLineAccess,
+                                   size_t elementSize, size_t numElements, size_t lineSize) {
+        const size_t numCacheLines = cacheLineAccess.size();
         
         // Analyze cache lines for false sharing
         std::cout << "False sharing analysis:\n";
@@ -257,8 +327,8 @@ public:
                 falseSharingLines++;
                 
                 // Calculate which array elements are in this cache line
-                size_t startElement = (i * CACHE_LINE_SIZE) / elementSize;
-                size_t endElement = std::min((((i + 1) * CACHE_LINE_SIZE) - 1) / elementSize, numElements - 1);
+                size_t startElement = (i * lineSize) / elementSize;
+                size_t endElement = std::min((((i + 1) * lineSize) - 1) / elementSize, numElements - 1);
                 
                 std::cout << "  Cache line " << i << " (elements " << startElement << "-" << endElement 
                           << ") has potential false sharing:\n";
@@ -281,175 +351,71 @@ public:
         std::cout << std::endl;
     }
     
+    struct RaceCondition {
+        void* address;
+        int thread1;
+        int thread2;
+        std::string access1Type;
+        std::string access2Type;
+        std::string location1;
+        std::string location2;
+    };
+
     void analyzeRaceConditions() {
-        std::lock_guard<std::mutex> lock(accessMutex);
+        reportRaces(detectRaces(), hb.raceCount(), hb.accessCount(), hb.shadowWords());
+    }
+    
+    static void reportRaces(const std::vector<RaceCondition>& races, uint64_t raceCount,
+                            uint64_t accessCount, uint64_t shadowWords) {
+        std::cout << "\nRace condition analysis (happens-before):\n";
         
-        // Group accesses by memory address
-        std::map<void*, std::vector<MemoryAccess>> addressMap;
-        for (const auto& access : accesses) {
-            addressMap[access.address].push_back(access);
+        for (const auto& race : races) {
+            std::cout << "  Race condition at address " << race.address 
+                      << " (" << race.location2 << "):\n"
+                      << "    Thread " << race.thread1 << " " << race.access1Type << " at " << race.location1 << "\n"
+                      << "    Thread " << race.thread2 << " " << race.access2Type << " at " << race.location2
+                      << ", not ordered after it\n";
         }
         
-        std::cout << "\nRace condition analysis:\n";
-        
-        int raceCount = 0;
-        for (const auto& entry : addressMap) {
-            void* address = entry.first;
-            const auto& addressAccesses = entry.second;
-            
-            // Count read and write access by thread
-            std::map<int, std::pair<int, int>> threadAccess; // threadId -> {reads, writes}
-            for (const auto& access : addressAccesses) {
-                auto& stats = threadAccess[access.threadId];
-                if (access.accessType == "read") {
-                    stats.first++;
-                } else if (access.accessType == "write") {
-                    stats.second++;
-                }
-            }
-            
-            // Check for race conditions
-            bool hasRace = false;
-            
-            // Count threads that write to this address
-            int writingThreads = 0;
-            for (const auto& thread : threadAccess) {
-                if (thread.second.second > 0) {
-                    writingThreads++;
-                }
-            }
-            
-            // Multiple threads writing = race condition
-            if (writingThreads > 1) {
-                hasRace = true;
-            }
-            
-            // One thread writing, others reading = race condition
-            if (writingThreads == 1 && threadAccess.size() > 1) {
-                int writerThread = -1;
-                for (const auto& thread : threadAccess) {
-                    if (thread.second.second > 0) {
-                        writerThread = thread.first;
-                        break;
-                    }
-                }
-                
-                for (const auto& thread : threadAccess) {
-                    if (thread.first != writerThread && thread.second.first > 0) {
-                        hasRace = true;
-                        break;
-                    }
-                }
-            }
-            
-            if (hasRace) {
-                raceCount++;
-                
-                // Find a sample access to get the source location
-                std::string location = "[Unknown]";
-                for (const auto& access : addressAccesses) {
-                    if (!access.sourceLocation.empty()) {
-                        location = access.sourceLocation;
-                        break;
-                    }
-                }
-                
-                std::cout << "  Race condition at address " << address 
-                          << " (" << location << "):\n";
-                
-                for (const auto& thread : threadAccess) {
-                    std::cout << "    Thread " << thread.first << ": " 
-                              << thread.second.first << " reads, " 
-                              << thread.second.second << " writes\n";
-                }
-            }
-        }
-        
-        if (raceCount == 0) {
+        if (races.empty()) {
             std::cout << "  No race conditions detected\n";
         } else {
             std::cout << "  Detected " << raceCount << " potential race conditions\n";
         }
+        std::cout << "  (" << accessCount << " accesses checked on " << shadowWords << " words)\n";
         
         std::cout << std::endl;
     }
 
-    struct RaceCondition {
-        void* address;
-        int thread1;
-        int thread2;
-        std::string access1Type;
-        std::string access2Type;
-        std::string location1;
-        std::string location2;
-        double timeGapMs;
-    };
-
+    // One race per 8-byte word: two accesses, at least one a write, that no
+    // fork/join, barrier, lock or critical section orders
     std::vector<RaceCondition> detectRaces() {
-        std::vector<RaceCondition> races;
-        std::lock_guard<std::mutex> lock(accessMutex);
-
-        // Group by memory address
-        std::unordered_map<void*, std::vector<MemoryAccess>> accessesByAddress;
-        for (const auto& access : accesses) {
-            accessesByAddress[access.address].push_back(access);
-        }
-
-        // Check each memory address for potential races
-        for (const auto& [address, addressAccesses] : accessesByAddress) {
-            // Sort by timestamp
-            auto sortedAccesses = addressAccesses;
-            std::sort(sortedAccesses.begin(), sortedAccesses.end(),
-                [](const MemoryAccess& a, const MemoryAccess& b) {
-                    return a.timestamp < b.timestamp;
-                });
-
-            // Look for write-read, read-write, or write-write accesses from different threads
-            for (size_t i = 0; i < sortedAccesses.size() - 1; i++) {
-                for (size_t j = i + 1; j < sortedAccesses.size(); j++) {
-                    const auto& access1 = sortedAccesses[i];
-                    const auto& access2 = sortedAccesses[j];
-
-                    // Skip if same thread
-                    if (access1.threadId == access2.threadId) {
-                        continue;
-                    }
-
-                    // At least one access must be a write to have a race
-                    if (access1.accessType != "write" && access2.accessType != "write") {
-                        continue;
-                    }
+        return describeRaces(hb.races(), [this](uint32_t id) { return hb.locationName(id); });
+    }
 
-                    // Calculate time gap
-                    auto timeGap = std::chrono::duration_cast<std::chrono::microseconds>(
-                        access2.timestamp - access1.timestamp).count() / 1000.0;
-
-                    // If accesses are close in time, potential race condition
-                    if (timeGap < 100.0) { // 100ms threshold for considering a race
-                        RaceCondition race;
-                        race.address = address;
-                        race.thread1 = access1.threadId;
-                        race.thread2 = access2.threadId;
-                        race.access1Type = access1.accessType;
-                        race.access2Type = access2.accessType;
-                        race.location1 = access1.sourceLocation;
-                        race.location2 = access2.sourceLocation;
-                        race.timeGapMs = timeGap;
-                        races.push_back(race);
-
-                        // Break after finding the first race for this pair
-                        break;
-                    }
-                }
-            }
+    template<typename LocationName>
+    static std::vector<RaceCondition> describeRaces(const std::vector<HBRace>& hbRaces, LocationName locationName) {
+        std::vector<RaceCondition> races;
+        for (const auto& found : hbRaces) {
+            RaceCondition race;
+            race.address = reinterpret_cast<void*>(found.address);
+            race.thread1 = found.firstThread;
+            race.thread2 = found.secondThread;
+            race.access1Type = found.kind == HBRaceKind::ReadWrite ? "read" : "write";
+            race.access2Type = found.kind == HBRaceKind::WriteRead ? "read" : "write";
+            race.location1 = locationName(found.firstLocation);
+            race.location2 = locationName(found.secondLocation);
+            races.push_back(race);
         }
-
         return races;
     }
 
     void generateReport(const std::string& filename) {
-        auto races = detectRaces();
+        writeRaceReport(filename, detectRaces(), hb.accessCount(), hb.raceCount());
+    }
 
+    static void writeRaceReport(const std::string& filename, const std::vector<RaceCondition>& races,
+                                uint64_t accessCount, uint64_t raceCount) {
         std::ofstream report(filename);
         if (!report.is_open()) {
             std::cerr << "Failed to open file for writing: " << filename << std::endl;
@@ -480,8 +446,8 @@ public:
         // Summary
         report << "    <div class=\"summary\">\n"
                << "        <h2>Summary</h2>\n"
-               << "        <p>Total memory accesses tracked: " << accesses.size() << "</p>\n"
-               << "        <p>Potential race conditions detected: " << races.size() << "</p>\n"
+               << "        <p>Total memory accesses tracked: " << accessCount << "</p>\n"
+               << "        <p>Potential race conditions detected: " << raceCount << "</p>\n"
                << "    </div>\n";
 
         // Race conditions table
@@ -496,17 +462,14 @@ public:
                    << "            <th>Thread 2</th>\n"
                    << "            <th>Access 2</th>\n"
                    << "            <th>Location 2</th>\n"
-                   << "            <th>Time Gap (ms)</th>\n"
                    << "            <th>Severity</th>\n"
                    << "        </tr>\n";
 
             for (const auto& race : races) {
-                // Determine severity based on access types and time gap
+                // Determine severity based on access types
                 std::string severityClass = "medium";
-                if (race.access1Type == "write" && race.access2Type == "write" && race.timeGapMs < 1.0) {
-                    severityClass = "high"; // Two writes very close in time
-                } else if (race.timeGapMs > 10.0) {
-                    severityClass = "low"; // Larger time gap
+                if (race.access1Type == "write" && race.access2Type == "write") {
+                    severityClass = "high"; // Lost updates
                 }
 
                 report << "        <tr class=\"" << severityClass << "\">\n"
@@ -517,7 +480,6 @@ public:
                        << "            <td>" << race.thread2 << "</td>\n"
                        << "            <td>" << race.access2Type << "</td>\n"
                        << "            <td>" << race.location2 << "</td>\n"
-                       << "            <td>" << std::fixed << std::setprecision(3) << race.timeGapMs << "</td>\n"
                        << "            <td>" << (severityClass == "high" ? "High" : (severityClass == "medium" ? "Medium" : "Low")) << "</td>\n"
                        << "        </tr>\n";
             }
@@ -547,90 +509,333 @@ public:
 // Global race detector instance
 CustomRaceDetector raceDetector;
 
-// Macros for simplified access tracking
+// Macros for simplified access tracking; each call site interns its location once
+#define TRACK_STRINGIFY_INNER(x) #x
+#define TRACK_STRINGIFY(x) TRACK_STRINGIFY_INNER(x)
+#define TRACK_LOCATION __FILE__ ":" TRACK_STRINGIFY(__LINE__)
+
 #define TRACK_READ(addr, loc) \
-    raceDetector.recordAccess(addr, omp_get_thread_num(), "read", loc)
+    do { \
+        static const uint32_t trackLocation = raceDetector.location(loc); \
+        raceDetector.recordAccess(addr, omp_get_thread_num(), false, trackLocation); \
+    } while (0)
 
 #define TRACK_WRITE(addr, loc) \
-    raceDetector.recordAccess(addr, omp_get_thread_num(), "write", loc)
-
-// Performance regression testing framework
+    do { \
+        static const uint32_t trackLocation = raceDetector.location(loc); \
+        raceDetector.recordAccess(addr, omp_get_thread_num(), true, trackLocation); \
+    } while (0)
+
+// Performance regression testing framework. Every run's samples are appended
+// to a JSON Lines history file, one record per benchmark, keyed by benchmark
+// name, host fingerprint and thread count. A benchmark regresses when its
+// current samples are slower than the pooled samples of the recent runs with
+// the same key by a one-sided Mann-Whitney U test, and the median moved by
+// more than a minimum effect size.
 class PerformanceRegression {
 private:
-    struct BenchmarkResult {
-        std::string name;
-        double executionTime; // in milliseconds
-        std::chrono::system_clock::time_point timestamp;
+    struct RunRecord {
+        std::string benchmark;
+        std::string host;
+        int threads = 0;
+        std::string runId;
+        long long timestamp = 0;            // seconds since the epoch
+        std::vector<double> samples;        // in milliseconds
     };
 
-    std::vector<BenchmarkResult> benchmarkHistory;
-    std::map<std::string, std::vector<double>> benchmarkStats;
+    std::string storePath;
+    std::string hostFingerprint;
+    std::string runId;
+    std::vector<RunRecord> history;                 // Earlier runs, oldest first
+    std::map<std::string, RunRecord> currentRuns;   // This run, by benchmark name
+
+    static const size_t kBaselineRuns = 5;          // Recent runs pooled into the baseline
+    static const size_t kMinSamples = 5;            // Per side, for the test to mean anything
+
+    static std::string makeHostFingerprint() {
+        char name[256] = {0};
+#ifdef _WIN32
+        DWORD size = sizeof(name);
+        if (!GetComputerNameA(name, &size)) {
+            name[0] = '\0';
+        }
+#else
+        if (gethostname(name, sizeof(name) - 1) != 0) {
+            name[0] = '\0';
+        }
+#endif
+        std::ostringstream fingerprint;
+        fingerprint << (name[0] ? name : "unknown") << "/" << std::thread::hardware_concurrency() << "cpu";
+        return fingerprint.str();
+    }
 
-public:
-    void recordBenchmark(const std::string& name, double executionTime) {
-        BenchmarkResult result;
-        result.name = name;
-        result.executionTime = executionTime;
-        result.timestamp = std::chrono::system_clock::now();
+    static std::string escapeJson(const std::string& text) {
+        std::string escaped;
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    // Reads the records this class writes; not a general JSON parser
+    static bool findString(const std::string& line, const std::string& key, std::string& value) {
+        size_t pos = line.find("\"" + key + "\":\"");
+        if (pos == std::string::npos) {
+            return false;
+        }
+        value.clear();
+        for (pos += key.size() + 4; pos < line.size() && line[pos] != '"'; pos++) {
+            if (line[pos] == '\\' && pos + 1 < line.size()) {
+                pos++;
+            }
+            value += line[pos];
+        }
+        return true;
+    }
+
+    static bool findNumber(const std::string& line, const std::string& key, double& value) {
+        size_t pos = line.find("\"" + key + "\":");
+        if (pos == std::string::npos) {
+            return false;
+        }
+        value = std::strtod(line.c_str() + pos + key.size() + 3, nullptr);
+        return true;
+    }
+
+    static bool parseRecord(const std::string& line, RunRecord& record) {
+        double threads = 0.0;
+        double timestamp = 0.0;
+        if (!findString(line, "benchmark", record.benchmark) || !findString(line, "host", record.host) ||
+            !findNumber(line, "threads", threads) || !findString(line, "run", record.runId) ||
+            !findNumber(line, "timestamp", timestamp)) {
+            return false;
+        }
+        record.threads = static_cast<int>(threads);
+        record.timestamp = static_cast<long long>(timestamp);
+
+        size_t open = line.find("\"samples\":[");
+        size_t close = line.find(']', open);
+        if (open == std::string::npos || close == std::string::npos) {
+            return false;
+        }
+        record.samples.clear();
+        const char* cursor = line.c_str() + open + 11;
+        const char* end = line.c_str() + close;
+        while (cursor < end) {
+            char* next = nullptr;
+            double sample = std::strtod(cursor, &next);
+            if (next == cursor) {
+                break;
+            }
+            record.samples.push_back(sample);
+            cursor = next;
+            while (cursor < end && (*cursor == ',' || *cursor == ' ')) {
+                cursor++;
+            }
+        }
+        return !record.samples.empty();
+    }
+
+    static double median(std::vector<double> values) {
+        if (values.empty()) {
+            return 0.0;
+        }
+        std::sort(values.begin(), values.end());
+        size_t mid = values.size() / 2;
+        return values.size() % 2 ? values[mid] : (values[mid - 1] + values[mid]) / 2.0;
+    }
+
+    // One-sided Mann-Whitney U test, normal approximation with tie and
+    // continuity corrections: p-value for "current tends to be larger"
+    static double mannWhitneyGreaterP(const std::vector<double>& baseline, const std::vector<double>& current) {
+        const size_t n1 = current.size();
+        const size_t n2 = baseline.size();
+        const size_t n = n1 + n2;
+
+        std::vector<std::pair<double, bool>> pooled; // value, is current
+        for (double v : current) pooled.push_back({v, true});
+        for (double v : baseline) pooled.push_back({v, false});
+        std::sort(pooled.begin(), pooled.end());
+
+        double currentRankSum = 0.0;
+        double tieTerm = 0.0;
+        for (size_t i = 0; i < n;) {
+            size_t j = i;
+            while (j < n && pooled[j].first == pooled[i].first) {
+                j++;
+            }
+            double rank = (i + 1 + j) / 2.0; // Average of ranks i+1 .. j
+            for (size_t k = i; k < j; k++) {
+                if (pooled[k].second) {
+                    currentRankSum += rank;
+                }
+            }
+            double t = static_cast<double>(j - i);
+            tieTerm += t * t * t - t;
+            i = j;
+        }
+
+        double u = currentRankSum - n1 * (n1 + 1) / 2.0;
+        double mean = n1 * n2 / 2.0;
+        double variance = n1 * n2 / 12.0 * ((n + 1) - tieTerm / (static_cast<double>(n) * (n - 1)));
+        if (variance <= 0.0) {
+            return 1.0;
+        }
+        double z = (u - mean - 0.5) / std::sqrt(variance);
+        return 0.5 * std::erfc(z / std::sqrt(2.0));
+    }
+
+    // The most recent runs with the same key as current, oldest first
+    std::vector<const RunRecord*> baselineRuns(const RunRecord& current, size_t maxRuns) const {
+        std::vector<const RunRecord*> runs;
+        for (auto it = history.rbegin(); it != history.rend() && runs.size() < maxRuns; ++it) {
+            if (it->benchmark == current.benchmark && it->host == current.host && it->threads == current.threads) {
+                runs.push_back(&*it);
+            }
+        }
+        std::reverse(runs.begin(), runs.end());
+        return runs;
+    }
 
-        benchmarkHistory.push_back(result);
-        benchmarkStats[name].push_back(executionTime);
+    std::vector<double> baselineSamples(const RunRecord& current) const {
+        std::vector<double> samples;
+        for (const RunRecord* run : baselineRuns(current, kBaselineRuns)) {
+            samples.insert(samples.end(), run->samples.begin(), run->samples.end());
+        }
+        return samples;
     }
 
+public:
     struct RegressionResult {
         std::string benchmarkName;
-        double baselineAvg;
-        double currentAvg;
+        double baselineMedian;
+        double currentMedian;
         double percentChange;
+        double pValue;
+        size_t baselineSamples;
+        size_t currentSamples;
         bool isRegression;
+        bool isImprovement;
     };
 
-    std::vector<RegressionResult> detectRegressions(double thresholdPercent = 5.0) {
-        std::vector<RegressionResult> regressions;
+    PerformanceRegression() : storePath("benchmark_history.jsonl"), hostFingerprint(makeHostFingerprint()) {
+        runId = std::to_string(std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    }
 
-        for (const auto& [name, times] : benchmarkStats) {
-            // Need at least 2 runs to compare
-            if (times.size() < 2) {
-                continue;
+    // Use the history file at path; runId labels this run (for example a commit hash)
+    void setStore(const std::string& path, const std::string& id) {
+        storePath = path;
+        if (!id.empty()) {
+            runId = id;
+        }
+        loadHistory();
+    }
+
+    bool loadHistory() {
+        history.clear();
+        std::ifstream file(storePath);
+        if (!file.is_open()) {
+            return false;
+        }
+        std::string line;
+        while (std::getline(file, line)) {
+            RunRecord record;
+            if (parseRecord(line, record)) {
+                history.push_back(record);
             }
+        }
+        return true;
+    }
 
-            // Calculate averages for baseline (first half) and current (second half)
-            size_t midpoint = times.size() / 2;
-            
-            double baselineSum = 0.0;
-            for (size_t i = 0; i < midpoint; i++) {
-                baselineSum += times[i];
+    // Append this run to the history file
+    bool saveRun() const {
+        std::ofstream file(storePath, std::ios::app);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open benchmark history: " << storePath << std::endl;
+            return false;
+        }
+        for (const auto& [name, record] : currentRuns) {
+            file << "{\"benchmark\":\"" << escapeJson(record.benchmark) << "\""
+                 << ",\"host\":\"" << escapeJson(record.host) << "\""
+                 << ",\"threads\":" << record.threads
+                 << ",\"run\":\"" << escapeJson(record.runId) << "\""
+                 << ",\"timestamp\":" << record.timestamp
+                 << ",\"samples\":[";
+            for (size_t i = 0; i < record.samples.size(); i++) {
+                if (i > 0) file << ",";
+                file << std::setprecision(6) << record.samples[i];
             }
-            double baselineAvg = baselineSum / midpoint;
+            file << "]}\n";
+            // Also into the shared results file (BENCH_RESULTS) for bench_dashboard
+            bench::record(record.benchmark, "", 0, record.threads, record.samples);
+        }
+        return true;
+    }
 
-            double currentSum = 0.0;
-            for (size_t i = midpoint; i < times.size(); i++) {
-                currentSum += times[i];
+    void recordBenchmark(const std::string& name, double executionTime) {
+        RunRecord& record = currentRuns[name];
+        if (record.samples.empty()) {
+            record.benchmark = name;
+            record.host = hostFingerprint;
+            record.threads = omp_get_max_threads();
+            record.runId = runId;
+            record.timestamp = std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+        record.samples.push_back(executionTime);
+    }
+
+    // Compare every benchmark of this run with its baseline; benchmarks
+    // without enough baseline samples are skipped
+    std::vector<RegressionResult> compareWithBaseline(double alpha = 0.01, double minChangePercent = 2.0) const {
+        std::vector<RegressionResult> results;
+
+        for (const auto& [name, current] : currentRuns) {
+            std::vector<double> baseline = baselineSamples(current);
+            if (baseline.size() < kMinSamples || current.samples.size() < kMinSamples) {
+                continue;
             }
-            double currentAvg = currentSum / (times.size() - midpoint);
 
-            // Calculate percent change
-            double percentChange = ((currentAvg - baselineAvg) / baselineAvg) * 100.0;
+            RegressionResult result;
+            result.benchmarkName = name;
+            result.baselineMedian = median(baseline);
+            result.currentMedian = median(current.samples);
+            result.percentChange = result.baselineMedian > 0.0
+                ? ((result.currentMedian - result.baselineMedian) / result.baselineMedian) * 100.0 : 0.0;
+            result.pValue = mannWhitneyGreaterP(baseline, current.samples);
+            result.baselineSamples = baseline.size();
+            result.currentSamples = current.samples.size();
+            result.isRegression = result.pValue < alpha && result.percentChange > minChangePercent;
+            result.isImprovement = mannWhitneyGreaterP(current.samples, baseline) < alpha &&
+                                   result.percentChange < -minChangePercent;
+            results.push_back(result);
+        }
 
-            // Check if it's a regression (slower)
-            bool isRegression = (percentChange > thresholdPercent);
+        return results;
+    }
 
-            if (isRegression) {
-                RegressionResult result;
-                result.benchmarkName = name;
-                result.baselineAvg = baselineAvg;
-                result.currentAvg = currentAvg;
-                result.percentChange = percentChange;
-                result.isRegression = true;
+    std::vector<RegressionResult> detectRegressions(double alpha = 0.01, double minChangePercent = 2.0) const {
+        std::vector<RegressionResult> regressions;
+        for (const auto& result : compareWithBaseline(alpha, minChangePercent)) {
+            if (result.isRegression) {
                 regressions.push_back(result);
             }
         }
-
         return regressions;
     }
 
     void generateReport(const std::string& filename) {
-        auto regressions = detectRegressions();
+        auto results = compareWithBaseline();
+        size_t regressionCount = 0;
+        for (const auto& result : results) {
+            if (result.isRegression) {
+                regressionCount++;
+            }
+        }
 
         std::ofstream report(filename);
         if (!report.is_open()) {
@@ -663,9 +868,11 @@ public:
         // Summary
         report << "    <div class=\"summary\">\n"
                << "        <h2>Summary</h2>\n"
-               << "        <p>Total benchmarks tracked: " << benchmarkStats.size() << "</p>\n"
-               << "        <p>Total runs: " << benchmarkHistory.size() << "</p>\n"
-               << "        <p>Regressions detected: " << regressions.size() << "</p>\n"
+               << "        <p>Run: " << runId << " on " << hostFingerprint << "</p>\n"
+               << "        <p>Total benchmarks tracked: " << currentRuns.size() << "</p>\n"
+               << "        <p>Earlier runs in history: " << history.size() << " (" << storePath << ")</p>\n"
+               << "        <p>Regressions detected: " << regressionCount
+               << " (one-sided Mann-Whitney U, p &lt; 0.01, median change &gt; 2%)</p>\n"
                << "    </div>\n";
 
         // Benchmark results table
@@ -673,88 +880,84 @@ public:
                << "    <table>\n"
                << "        <tr>\n"
                << "            <th>Benchmark</th>\n"
-               << "            <th>Baseline Avg (ms)</th>\n"
-               << "            <th>Current Avg (ms)</th>\n"
+               << "            <th>Baseline Median (ms)</th>\n"
+               << "            <th>Current Median (ms)</th>\n"
                << "            <th>Change (%)</th>\n"
+               << "            <th>p-value</th>\n"
+               << "            <th>Samples (baseline / current)</th>\n"
                << "            <th>Status</th>\n"
                << "        </tr>\n";
 
-        for (const auto& [name, times] : benchmarkStats) {
-            // Calculate stats
-            size_t midpoint = std::max(size_t(1), times.size() / 2);
-            
-            double baselineSum = 0.0;
-            for (size_t i = 0; i < midpoint; i++) {
-                baselineSum += times[i];
-            }
-            double baselineAvg = baselineSum / midpoint;
-
-            double currentSum = 0.0;
-            size_t currentCount = 0;
-            for (size_t i = midpoint; i < times.size(); i++) {
-                currentSum += times[i];
-                currentCount++;
-            }
-            double currentAvg = (currentCount > 0) ? currentSum / currentCount : baselineAvg;
-
-            // Calculate percent change
-            double percentChange = ((currentAvg - baselineAvg) / baselineAvg) * 100.0;
-
+        for (const auto& result : results) {
             // Determine status
             std::string statusClass = "normal";
             std::string status = "Stable";
-            if (percentChange > 5.0) {
+            if (result.isRegression) {
                 statusClass = "regression";
                 status = "Regression";
-            } else if (percentChange < -5.0) {
+            } else if (result.isImprovement) {
                 statusClass = "improvement";
                 status = "Improvement";
             }
 
             report << "        <tr class=\"" << statusClass << "\">\n"
-                   << "            <td>" << name << "</td>\n"
-                   << "            <td>" << std::fixed << std::setprecision(2) << baselineAvg << "</td>\n"
-                   << "            <td>" << std::fixed << std::setprecision(2) << currentAvg << "</td>\n"
-                   << "            <td>" << std::fixed << std::setprecision(2) << percentChange << "%</td>\n"
+                   << "            <td>" << result.benchmarkName << "</td>\n"
+                   << "            <td>" << std::fixed << std::setprecision(2) << result.baselineMedian << "</td>\n"
+                   << "            <td>" << std::fixed << std::setprecision(2) << result.currentMedian << "</td>\n"
+                   << "            <td>" << std::fixed << std::setprecision(2) << result.percentChange << "%</td>\n"
+                   << "            <td>" << std::setprecision(4) << result.pValue << "</td>\n"
+                   << "            <td>" << result.baselineSamples << " / " << result.currentSamples << "</td>\n"
                    << "            <td>" << status << "</td>\n"
                    << "        </tr>\n";
         }
 
         report << "    </table>\n";
 
-        // Charts for each benchmark
-        for (const auto& [name, times] : benchmarkStats) {
-            if (times.size() < 2) continue;
+        // Trend charts: median and range of every run with this key, then this run
+        int chartIndex = 0;
+        for (const auto& [name, current] : currentRuns) {
+            auto runs = baselineRuns(current, history.size());
+            runs.push_back(&current);
 
-            report << "    <h3>Benchmark: " << name << "</h3>\n"
+            report << "    <h3>Benchmark: " << name << " (" << current.threads << " threads)</h3>\n"
                    << "    <div class=\"chart-container\">\n"
-                   << "        <canvas id=\"chart_" << name << "\"></canvas>\n"
+                   << "        <canvas id=\"trend_" << chartIndex << "\"></canvas>\n"
                    << "    </div>\n"
                    << "    <script>\n"
-                   << "        new Chart(document.getElementById('chart_" << name << "'), {\n"
+                   << "        new Chart(document.getElementById('trend_" << chartIndex << "'), {\n"
                    << "            type: 'line',\n"
                    << "            data: {\n"
                    << "                labels: [";
+            chartIndex++;
 
-            for (size_t i = 0; i < times.size(); i++) {
+            for (size_t i = 0; i < runs.size(); i++) {
                 if (i > 0) report << ", ";
-                report << "'" << i + 1 << "'";
+                report << "'" << escapeJson(runs[i]->runId) << "'";
             }
 
-            report << "],\n"
-                   << "                datasets: [{\n"
-                   << "                    label: '" << name << " Execution Time (ms)',\n"
-                   << "                    data: [";
-
-            for (size_t i = 0; i < times.size(); i++) {
-                if (i > 0) report << ", ";
-                report << times[i];
-            }
+            auto series = [&](const char* label, const char* color, bool dashed, auto value) {
+                report << "{\n"
+                       << "                    label: '" << label << "',\n"
+                       << "                    data: [";
+                for (size_t i = 0; i < runs.size(); i++) {
+                    if (i > 0) report << ", ";
+                    report << std::fixed << std::setprecision(3) << value(runs[i]->samples);
+                }
+                report << "],\n"
+                       << "                    borderColor: '" << color << "',\n"
+                       << (dashed ? "                    borderDash: [5, 5],\n" : "")
+                       << "                    fill: false\n"
+                       << "                }";
+            };
 
             report << "],\n"
-                   << "                    borderColor: '#4CAF50',\n"
-                   << "                    fill: false\n"
-                   << "                }]\n"
+                   << "                datasets: [";
+            series("Median (ms)", "#4CAF50", false, [](const std::vector<double>& v) { return median(v); });
+            report << ", ";
+            series("Min (ms)", "#9E9E9E", true, [](const std::vector<double>& v) { return *std::min_element(v.begin(), v.end()); });
+            report << ", ";
+            series("Max (ms)", "#9E9E9E", true, [](const std::vector<double>& v) { return *std::max_element(v.begin(), v.end()); });
+            report << "]\n"
                    << "            },\n"
                    << "            options: {\n"
                    << "                responsive: true,\n"
@@ -791,6 +994,7 @@ public:
         LoadImbalance,
         ExcessiveSynchronization,
         MemoryIssue,
+        BranchMisprediction,
         Unknown
     };
 
@@ -801,27 +1005,114 @@ public:
         std::string recommendation;
     };
 
+    static std::string patternName(PatternType type) {
+        switch (type) {
+            case PatternType::RaceCondition: return "Race Condition";
+            case PatternType::FalseSharing: return "False Sharing";
+            case PatternType::LoadImbalance: return "Load Imbalance";
+            case PatternType::ExcessiveSynchronization: return "Excessive Synchronization";
+            case PatternType::MemoryIssue: return "Memory Issue";
+            case PatternType::BranchMisprediction: return "Branch Misprediction";
+            default: return "Unknown";
+        }
+    }
+
+    // Diagnoses from hardware counters when threadCounters holds valid samples
+    // (one interval per thread), otherwise from thread times alone; returns the
+    // candidate with the highest confidence
     RecognizedPattern analyzePerformancePattern(const std::map<int, double>& threadTimes, 
                                               const std::map<std::string, int>& syncPoints,
-                                              double totalTime) {
-        RecognizedPattern pattern;
-        pattern.type = PatternType::Unknown;
-        pattern.confidence = 0.0;
+                                              double totalTime,
+                                              const std::map<int, CounterSample>& threadCounters = {}) {
+        std::vector<RecognizedPattern> candidates;
 
         // Calculate statistics for thread times
         double minTime = std::numeric_limits<double>::max();
         double maxTime = 0.0;
-        double avgTime = 0.0;
         
         for (const auto& [threadId, time] : threadTimes) {
             minTime = std::min(minTime, time);
             maxTime = std::max(maxTime, time);
-            avgTime += time;
         }
-        avgTime /= threadTimes.size();
 
         // Calculate imbalance ratio
-        double imbalanceRatio = maxTime / minTime;
+        double imbalanceRatio = (threadTimes.size() > 1 && minTime > 0) ? maxTime / minTime : 1.0;
+        
+        // Sum the counters and find the spread of work between threads
+        CounterSample total;
+        uint64_t minInstructions = std::numeric_limits<uint64_t>::max();
+        uint64_t maxInstructions = 0;
+        for (const auto& [threadId, counters] : threadCounters) {
+            if (!counters.valid) continue;
+            total += counters;
+            minInstructions = std::min(minInstructions, counters.instructions);
+            maxInstructions = std::max(maxInstructions, counters.instructions);
+        }
+        bool haveCounters = total.valid && total.instructions > 0;
+        
+        // Detect load imbalance; with counters, tell unequal work from unequal speed
+        if (imbalanceRatio > 1.5) {
+            RecognizedPattern pattern;
+            pattern.confidence = std::min(1.0, (imbalanceRatio - 1.0) / 2.0);
+            double workRatio = (haveCounters && minInstructions > 0) ?
+                static_cast<double>(maxInstructions) / minInstructions : 0.0;
+            if (haveCounters && workRatio < 1.2) {
+                pattern.type = PatternType::MemoryIssue;
+                pattern.description = "Thread times differ " + format(imbalanceRatio, 1) +
+                    "x but instruction counts only " + format(workRatio, 2) +
+                    "x: the slow threads stall rather than do more work";
+                pattern.recommendation = "Check data placement (first-touch initialization by the using thread) "
+                                         "and thread binding (OMP_PROC_BIND, OMP_PLACES)";
+            } else {
+                pattern.type = PatternType::LoadImbalance;
+                pattern.description = haveCounters ?
+                    "Threads retire " + format(workRatio, 1) + "x different instruction counts, "
+                    "so work is unevenly divided (times differ " + format(imbalanceRatio, 1) + "x)" :
+                    "Thread execution times vary significantly, indicating load imbalance";
+                pattern.recommendation = "Consider using dynamic scheduling or manually balancing workload";
+            }
+            candidates.push_back(pattern);
+        }
+        
+        if (haveCounters) {
+            // Memory bound: many LLC misses per instruction and few instructions per cycle
+            double ipc = total.ipc();
+            double llcMpki = total.llcMpki();
+            if (llcMpki > 10.0 && ipc < 1.0) {
+                RecognizedPattern pattern;
+                pattern.type = PatternType::MemoryIssue;
+                pattern.description = "Memory bound: " + format(llcMpki, 1) + " LLC misses per 1000 instructions at IPC " +
+                                      format(ipc, 2);
+                pattern.confidence = std::min(1.0, llcMpki / 30.0);
+                pattern.recommendation = "Improve locality: block or tile loops, use contiguous (structure of arrays) layouts, "
+                                         "or shrink the working set";
+                candidates.push_back(pattern);
+            }
+            
+            // TLB bound: page walks dominate when the access pattern spans many pages
+            double dtlbMpki = total.dtlbMpki();
+            if (dtlbMpki > 1.0) {
+                RecognizedPattern pattern;
+                pattern.type = PatternType::MemoryIssue;
+                pattern.description = "TLB bound: " + format(dtlbMpki, 1) + " dTLB misses per 1000 instructions";
+                pattern.confidence = std::min(1.0, dtlbMpki / 5.0);
+                pattern.recommendation = "Use huge pages (transparent huge pages or large-page allocation) "
+                                         "or visit memory page by page";
+                candidates.push_back(pattern);
+            }
+            
+            double branchMpki = total.branchMpki();
+            if (branchMpki > 10.0) {
+                RecognizedPattern pattern;
+                pattern.type = PatternType::BranchMisprediction;
+                pattern.description = format(branchMpki, 1) + " branch mispredictions per 1000 instructions at IPC " +
+                                      format(ipc, 2);
+                pattern.confidence = std::min(1.0, branchMpki / 25.0);
+                pattern.recommendation = "Make branches predictable: sort or partition the data, "
+                                         "or replace data-dependent branches with arithmetic";
+                candidates.push_back(pattern);
+            }
+        }
         
         // Count sync operations
         int totalSyncOps = 0;
@@ -829,28 +1120,35 @@ public:
             totalSyncOps += count;
         }
         
-        // Detect load imbalance
-        if (imbalanceRatio > 1.5 && threadTimes.size() > 1) {
-            pattern.type = PatternType::LoadImbalance;
-            pattern.description = "Thread execution times vary significantly, indicating load imbalance";
-            pattern.confidence = std::min(1.0, (imbalanceRatio - 1.0) / 2.0);
-            pattern.recommendation = "Consider using dynamic scheduling or manually balancing workload";
-            return pattern;
-        }
-        
         // Detect excessive synchronization
         double syncRatio = (totalTime > 0) ? totalSyncOps / totalTime : 0;
         if (syncRatio > 0.1) {
+            RecognizedPattern pattern;
             pattern.type = PatternType::ExcessiveSynchronization;
             pattern.description = "High frequency of synchronization operations detected";
             pattern.confidence = std::min(1.0, syncRatio * 5.0);
             pattern.recommendation = "Reduce barriers/critical sections or reorganize algorithm to require less synchronization";
-            return pattern;
+            candidates.push_back(pattern);
+        }
+        
+        if (!candidates.empty()) {
+            return *std::max_element(candidates.begin(), candidates.end(),
+                [](const RecognizedPattern& a, const RecognizedPattern& b) {
+                    return a.confidence < b.confidence;
+                });
         }
         
         // If no specific pattern detected
-        pattern.description = "No clear performance pattern detected";
-        pattern.recommendation = "Collect more detailed metrics for further analysis";
+        RecognizedPattern pattern;
+        pattern.type = PatternType::Unknown;
+        pattern.confidence = 0.0;
+        if (haveCounters) {
+            pattern.description = "No clear performance pattern detected (IPC " + format(total.ipc(), 2) + ")";
+            pattern.recommendation = "Profile hot sections individually to narrow down the bottleneck";
+        } else {
+            pattern.description = "No clear performance pattern detected";
+            pattern.recommendation = "Collect hardware counters for further analysis";
+        }
         
         return pattern;
     }
@@ -909,18 +1207,8 @@ public:
                     confidenceClass = "low";
                 }
 
-                std::string patternName;
-                switch (pattern.type) {
-                    case PatternType::RaceCondition: patternName = "Race Condition"; break;
-                    case PatternType::FalseSharing: patternName = "False Sharing"; break;
-                    case PatternType::LoadImbalance: patternName = "Load Imbalance"; break;
-                    case PatternType::ExcessiveSynchronization: patternName = "Excessive Synchronization"; break;
-                    case PatternType::MemoryIssue: patternName = "Memory Issue"; break;
-                    default: patternName = "Unknown"; break;
-                }
-
                 report << "        <tr class=\"" << confidenceClass << "\">\n"
-                       << "            <td>" << patternName << "</td>\n"
+                       << "            <td>" << patternName(pattern.type) << "</td>\n"
                        << "            <td>" << pattern.description << "</td>\n"
                        << "            <td>" << std::fixed << std::setprecision(2) << (pattern.confidence * 100.0) << "%</td>\n"
                        << "            <td>" << pattern.recommendation << "</td>\n"
@@ -940,6 +1228,7 @@ public:
                << "        <li><strong>Load Imbalance:</strong> Use dynamic or guided scheduling for uneven workloads</li>\n"
                << "        <li><strong>Synchronization:</strong> Minimize barriers and critical sections for better scalability</li>\n"
                << "        <li><strong>Memory:</strong> Be aware of NUMA effects and organize data for better locality</li>\n"
+               << "        <li><strong>Branches:</strong> Keep data-dependent branches predictable in hot loops</li>\n"
                << "    </ul>\n";
 
         report << "</body>\n</html>\n";
@@ -947,6 +1236,13 @@ public:
         report.close();
         std::cout << "Pattern recognition report generated: " << filename << std::endl;
     }
+
+private:
+    static std::string format(double value, int precision) {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(precision) << value;
+        return out.str();
+    }
 };
 
 // Demonstrate race detection with a simple example
@@ -955,11 +1251,13 @@ void demonstrateRaceDetection() {
     
     const int arraySize = 100;
     std::vector<int> sharedArray(arraySize, 0);
+    HappensBeforeDetector& hb = raceDetector.happensBefore();
     
     // Enable race detection
     raceDetector.enable();
     
     // Parallel code with race conditions
+    hb.parallelBegin(4);
     #pragma omp parallel num_threads(4)
     {
         int tid = omp_get_thread_num();
@@ -968,28 +1266,92 @@ void demonstrateRaceDetection() {
         for (int i = 0; i < arraySize; i++) {
             // Read the current value
             int value = sharedArray[i];
-            TRACK_READ(&sharedArray[i], "demonstrateRaceDetection:line321");
+            TRACK_READ(&sharedArray[i], TRACK_LOCATION);
             
             // Simulate some work
             std::this_thread::sleep_for(std::chrono::microseconds(tid + 1));
             
             // Write back the incremented value (race condition)
             sharedArray[i] = value + 1;
-            TRACK_WRITE(&sharedArray[i], "demonstrateRaceDetection:line328");
+            TRACK_WRITE(&sharedArray[i], TRACK_LOCATION);
         }
     }
+    hb.parallelEnd();
+    
+    // The same increments made safe: a critical section, then a barrier before
+    // each thread reads what its neighbour wrote. Nothing here is reported.
+    std::vector<long long> owned(4, 0);  // One 8-byte shadow word per thread
+    static const char criticalTag = 0;  // Names the critical section for the detector
+    hb.parallelBegin(4);
+    #pragma omp parallel num_threads(4)
+    {
+        int tid = omp_get_thread_num();
+        
+        for (int i = 0; i < arraySize; i++) {
+            #pragma omp critical
+            {
+                hb.acquire(&criticalTag);
+                TRACK_READ(&sharedArray[i], TRACK_LOCATION);
+                sharedArray[i]++;
+                TRACK_WRITE(&sharedArray[i], TRACK_LOCATION);
+                hb.release(&criticalTag);
+            }
+        }
+        
+        TRACK_WRITE(&owned[tid], TRACK_LOCATION);
+        owned[tid] = tid;
+        hb.barrier();
+        TRACK_READ(&owned[(tid + 1) % 4], TRACK_LOCATION);
+    }
+    hb.parallelEnd();
     
     // Disable race detection
     raceDetector.disable();
+    if (raceDetector.isRecording()) {
+        // Races are found offline from the trace
+        return;
+    }
+    raceDetector.analyzeRaceConditions();
     
     // Generate race detection report
     std::string reportsDir = "../reports";
-    CreateDirectoryA(reportsDir.c_str(), NULL);
+    std::error_code dirError;
+    std::filesystem::create_directories(reportsDir, dirError);
     raceDetector.generateReport("../reports/race_detection.html");
+    raceDetector.clear();
+    
+    // Detection cost per access stays flat as the trace grows
+    std::cout << "Happens-before detector throughput:" << std::endl;
+    const int threads = omp_get_max_threads();
+    std::vector<double> data(1 << 20, 0.0);
+    for (long long accesses : {1000000LL, 10000000LL}) {
+        HappensBeforeDetector detector(threads);
+        auto start = std::chrono::steady_clock::now();
+        
+        detector.parallelBegin(threads);
+        #pragma omp parallel for num_threads(threads) schedule(static)
+        for (long long i = 0; i < accesses; i++) {
+            // Each thread works in its own slice of the array: no races
+            size_t slice = data.size() / threads;
+            size_t index = omp_get_thread_num() * slice + static_cast<size_t>(i % slice);
+            if (i & 1) {
+                detector.write(&data[index]);
+            } else {
+                detector.read(&data[index]);
+            }
+        }
+        detector.parallelEnd();
+        
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "  " << std::setw(9) << accesses << " accesses: " << std::fixed << std::setprecision(3)
+                  << seconds << " s (" << std::setprecision(1) << (seconds * 1e9 / accesses) << " ns/access, "
+                  << detector.raceCount() << " races)" << std::endl;
+    }
 }
 
-// Demonstrate performance regression testing
-void demonstratePerformanceRegression() {
+// Demonstrate performance regression testing against the stored history.
+// Returns the number of regressions, for gating.
+int demonstratePerformanceRegression(const std::string& historyPath, const std::string& runId, int slowdownPercent) {
     std::cout << "Demonstrating performance regression testing..." << std::endl;
     
     // Function to benchmark
@@ -1009,28 +1371,69 @@ void demonstratePerformanceRegression() {
         
         // End timing
         auto end = std::chrono::high_resolution_clock::now();
-        double duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
-        
-        // Return execution time
-        return duration;
+        return std::chrono::duration<double, std::milli>(end - start).count();
     };
     
-    // Baseline runs
-    for (int i = 0; i < 5; i++) {
-        double time = benchmarkFunction(1000, 100);
+    perfRegression.setStore(historyPath, runId);
+    
+    // Repeated samples of this build; --slowdown adds work to see the gate trip
+    const int iterations = 400 * (100 + slowdownPercent) / 100;
+    benchmarkFunction(2000, iterations); // Warm-up
+    for (int i = 0; i < 15; i++) {
+        double time = benchmarkFunction(2000, iterations);
         perfRegression.recordBenchmark("Trigonometry", time);
     }
     
-    // Regression runs (intentionally slower)
-    for (int i = 0; i < 5; i++) {
-        double time = benchmarkFunction(1000, 120); // 20% more iterations
-        perfRegression.recordBenchmark("Trigonometry", time);
+    auto results = perfRegression.compareWithBaseline();
+    if (results.empty()) {
+        std::cout << "  No baseline for this host and thread count yet; this run becomes the baseline." << std::endl;
+    }
+    int regressions = 0;
+    for (const auto& result : results) {
+        std::cout << "  " << result.benchmarkName << ": median " << std::fixed << std::setprecision(2)
+                  << result.baselineMedian << " -> " << result.currentMedian << " ms ("
+                  << std::showpos << result.percentChange << std::noshowpos << "%, p = "
+                  << std::setprecision(4) << result.pValue << ")"
+                  << (result.isRegression ? "  REGRESSION" : "") << std::endl;
+        if (result.isRegression) {
+            regressions++;
+        }
     }
     
     // Generate regression report
     std::string reportsDir = "../reports";
-    CreateDirectoryA(reportsDir.c_str(), NULL);
+    std::error_code dirError;
+    std::filesystem::create_directories(reportsDir, dirError);
     perfRegression.generateReport("../reports/performance_regression.html");
+    perfRegression.saveRun();
+    
+    return regressions;
+}
+
+// Run work(tid) on every thread of a team, recording each thread's time (ms)
+// and hardware counter deltas
+template<typename Work>
+void measureThreads(Work&& work, std::map<int, double>& threadTimes, std::map<int, CounterSample>& threadCounters) {
+    threadTimes.clear();
+    threadCounters.clear();
+    #pragma omp parallel
+    {
+        int tid = omp_get_thread_num();
+        CounterSample start = HardwareCounters::readThread();
+        auto startTime = std::chrono::steady_clock::now();
+        
+        work(tid);
+        
+        double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        CounterSample delta = HardwareCounters::readThread() - start;
+        #pragma omp critical
+        {
+            threadTimes[tid] = elapsedMs;
+            if (delta.valid) {
+                threadCounters[tid] = delta;
+            }
+        }
+    }
 }
 
 // Demonstrate pattern recognition
@@ -1041,24 +1444,55 @@ void demonstratePatternRecognition() {
     PatternRecognizer recognizer;
     std::vector<PatternRecognizer::RecognizedPattern> patterns;
     
-    // Simulate load imbalance pattern
-    std::map<int, double> threadTimes = {
-        {0, 100.0},
-        {1, 150.0},
-        {2, 90.0},
-        {3, 200.0}
-    };
+    if (!HardwareCounters::isAvailable()) {
+        std::cout << "  Hardware counters unavailable (" << HardwareCounters::unavailableReason()
+                  << "); diagnosing from thread times only" << std::endl;
+    }
     
-    std::map<std::string, int> syncPoints = {
-        {"barrier", 4},
-        {"critical", 10}
+    auto report = [&](const std::string& workload, const PatternRecognizer::RecognizedPattern& pattern) {
+        std::cout << "  " << workload << ": " << PatternRecognizer::patternName(pattern.type)
+                  << " (" << std::fixed << std::setprecision(0) << pattern.confidence * 100.0 << "%) - "
+                  << pattern.description << std::endl;
+        patterns.push_back(pattern);
     };
     
-    double totalTime = 200.0;
+    std::map<int, double> threadTimes;
+    std::map<int, CounterSample> threadCounters;
+    std::map<std::string, int> noSyncPoints;
     
-    // Analyze the pattern
-    auto pattern = recognizer.analyzePerformancePattern(threadTimes, syncPoints, totalTime);
-    patterns.push_back(pattern);
+    // Uneven compute: thread t runs t + 1 times the iterations of thread 0
+    std::vector<double> results(omp_get_max_threads(), 0.0);
+    auto wallStart = std::chrono::steady_clock::now();
+    measureThreads([&](int tid) {
+        double x = 1.0;
+        const long iterations = 20000000L * (tid + 1);
+        for (long i = 0; i < iterations; i++) {
+            x = x * 1.0000001 + 1e-9;
+        }
+        results[tid] = x;
+    }, threadTimes, threadCounters);
+    double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count();
+    report("Uneven compute", recognizer.analyzePerformancePattern(threadTimes, noSyncPoints, wallMs, threadCounters));
+    
+    // Random gather over 64 MB: nearly every load misses the last-level cache and the TLB
+    const size_t tableSize = size_t(1) << 23;
+    std::vector<uint64_t> table(tableSize);
+    for (size_t i = 0; i < tableSize; i++) {
+        table[i] = i * 0x9E3779B97F4A7C15ULL;
+    }
+    wallStart = std::chrono::steady_clock::now();
+    measureThreads([&](int tid) {
+        uint64_t index = static_cast<uint64_t>(tid) + 1;
+        uint64_t sum = 0;
+        for (int i = 0; i < 4000000; i++) {
+            // Each load's address depends on the previous value, so misses do not overlap
+            index = (index * 6364136223846793005ULL + table[index & (tableSize - 1)]) >> 1;
+            sum += index;
+        }
+        results[tid] = static_cast<double>(sum);
+    }, threadTimes, threadCounters);
+    wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count();
+    report("Random gather", recognizer.analyzePerformancePattern(threadTimes, noSyncPoints, wallMs, threadCounters));
     
     // Simulate excessive synchronization pattern
     threadTimes = {
@@ -1068,40 +1502,20 @@ void demonstratePatternRecognition() {
         {3, 122.0}
     };
     
-    syncPoints = {
+    std::map<std::string, int> syncPoints = {
         {"barrier", 20},
         {"critical", 50}
     };
     
-    totalTime = 130.0;
-    
-    // Analyze the pattern
-    pattern = recognizer.analyzePerformancePattern(threadTimes, syncPoints, totalTime);
-    patterns.push_back(pattern);
+    report("Simulated synchronization", recognizer.analyzePerformancePattern(threadTimes, syncPoints, 130.0));
     
     // Generate pattern recognition report
     std::string reportsDir = "../reports";
-    CreateDirectoryA(reportsDir.c_str(), NULL);
+    std::error_code dirError;
+    std::filesystem::create_directories(reportsDir, dirError);
     recognizer.generateReport("../reports/pattern_recognition.html", patterns);
 }
 
-// Add more functions to record access in the detector call
-void recordRead(void* address, const char* file, int line) {
-    if (raceDetector.isEnabled()) {
-        std::stringstream location;
-        location << file << ":" << line;
-        raceDetector.recordAccess(address, omp_get_thread_num(), "read", location.str());
-    }
-}
-
-void recordWrite(void* address, const char* file, int line) {
-    if (raceDetector.isEnabled()) {
-        std::stringstream location;
-        location << file << ":" << line;
-        raceDetector.recordAccess(address, omp_get_thread_num(), "write", location.str());
-    }
-}
-
 // Function to analyze race conditions in arrays
 void analyzeArrayAccess(const char* arrayName, void* arrayStart, size_t elementSize, 
                         size_t numElements, int threads, bool detectFalseSharing = true) {
@@ -1113,6 +1527,13 @@ void analyzeArrayAccess(const char* arrayName, void* arrayStart, size_t elementS
     std::cout << "  - Elements: " << numElements << "\n";
     std::cout << "  - Total size: " << (elementSize * numElements) << " bytes\n\n";
     
+    if (raceDetector.isRecording()) {
+        // The layout analyses run on the trace
+        raceDetector.happensBefore().recordRegion(arrayName, arrayStart, elementSize, numElements);
+        std::cout << "Recorded as a region of the access trace\n";
+        return;
+    }
+    
     // Enable race detection
     raceDetector.enable();
     
@@ -1137,6 +1558,7 @@ void analyzeDataRaces(int numElements, int numThreads, bool dynamicSchedule) {
     // Example of a race condition on a shared variable
     int sharedSum = 0;
     
+    raceDetector.happensBefore().parallelBegin(numThreads);
     #pragma omp parallel num_threads(numThreads)
     {
         int threadId = omp_get_thread_num();
@@ -1147,47 +1569,105 @@ void analyzeDataRaces(int numElements, int numThreads, bool dynamicSchedule) {
             for (int i = 0; i < numElements; i++) {
                 // Race condition: multiple threads writing to shared variable
                 if (i % 2 == 0) {
-                    recordRead(&sharedSum, __FILE__, __LINE__);
+                    TRACK_READ(&sharedSum, TRACK_LOCATION);
                     sharedSum += 1;  // Race condition
-                    recordWrite(&sharedSum, __FILE__, __LINE__);
+                    TRACK_WRITE(&sharedSum, TRACK_LOCATION);
                 }
                 
                 // Array access - each thread writes to its own chunk
-                recordRead(&data[i], __FILE__, __LINE__);
+                TRACK_READ(&data[i], TRACK_LOCATION);
                 data[i] = threadId;
-                recordWrite(&data[i], __FILE__, __LINE__);
+                TRACK_WRITE(&data[i], TRACK_LOCATION);
             }
         } else {
             #pragma omp for schedule(static)
             for (int i = 0; i < numElements; i++) {
                 // Race condition: multiple threads writing to shared variable
                 if (i % 2 == 0) {
-                    recordRead(&sharedSum, __FILE__, __LINE__);
+                    TRACK_READ(&sharedSum, TRACK_LOCATION);
                     sharedSum += 1;  // Race condition
-                    recordWrite(&sharedSum, __FILE__, __LINE__);
+                    TRACK_WRITE(&sharedSum, TRACK_LOCATION);
                 }
                 
                 // Array access - each thread writes to its own chunk
-                recordRead(&data[i], __FILE__, __LINE__);
+                TRACK_READ(&data[i], TRACK_LOCATION);
                 data[i] = threadId;
-                recordWrite(&data[i], __FILE__, __LINE__);
+                TRACK_WRITE(&data[i], TRACK_LOCATION);
             }
         }
     }
     
-    raceDetector.analyzeRaceConditions();
+    raceDetector.happensBefore().parallelEnd();
     raceDetector.disable();
+    
+    if (!raceDetector.isRecording()) {
+        raceDetector.analyzeRaceConditions();
+    }
+    analyzeArrayAccess("data", data.data(), sizeof(int), numElements, numThreads);
     raceDetector.clear();
     
     // Use the result to avoid optimization
     std::cout << "  Final sum: " << sharedSum << std::endl;
 }
 
+// Offline analysis of a trace recorded with --record: the same race, false
+// sharing and access pattern reports, computed by several threads after the run
+int analyzeTrace(const std::string& traceFile, int workers) {
+    std::cout << "Analyzing access trace " << traceFile << " with " << workers << " threads..." << std::endl;
+    
+    AccessTraceReader reader;
+    if (!reader.open(traceFile)) {
+        return 2;
+    }
+    AccessTraceAnalysis analysis = reader.analyze(workers);
+    
+    std::cout << "  " << analysis.accesses << " accesses and " << analysis.syncEvents << " sync events from "
+              << analysis.threads << " threads, " << analysis.segments << " segments" << std::endl;
+    std::cout << "  Clock replay: " << std::fixed << std::setprecision(3) << analysis.replaySeconds << " s, "
+              << "analysis: " << analysis.analyzeSeconds << " s" << std::endl;
+    
+    auto races = CustomRaceDetector::describeRaces(analysis.races, [&analysis](uint32_t id) {
+        return analysis.locationName(id);
+    });
+    CustomRaceDetector::reportRaces(races, analysis.raceCount, analysis.accesses, analysis.shadowWords);
+    
+    for (const auto& region : analysis.regions) {
+        std::cout << "=== Array Access Analysis for '" << region.region.name << "' ===\n";
+        std::cout << "  - Elements: " << region.region.count << " of " << region.region.elementSize << " bytes\n\n";
+        CustomRaceDetector::reportArrayAccess(region.readThreads, region.writeThreads,
+                                              static_cast<size_t>(region.region.count), analysis.threads);
+        CustomRaceDetector::reportFalseSharing(region.lineAccess, static_cast<size_t>(region.region.elementSize),
+                                               static_cast<size_t>(region.region.count), 64);
+    }
+    
+    std::string reportsDir = "../reports";
+    std::error_code dirError;
+    std::filesystem::create_directories(reportsDir, dirError);
+    CustomRaceDetector::writeRaceReport("../reports/race_detection_offline.html", races,
+                                        analysis.accesses, analysis.raceCount);
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
     CliParser parser(argc, argv);
-    parser.addOption("demo", 'd', "Demo to run (race, regression, pattern, all)", true);
+    parser.addOption("demo", 'd', "Demo to run (race, access, regression, pattern, all)", true);
     parser.addOption("threads", 't', "Number of threads to use (default: system cores)", true);
+    parser.addOption("history", 'H', "Benchmark history file (default: ../reports/benchmark_history.jsonl)", true);
+    parser.addOption("run-id", 'r', "Label for this run in the history, e.g. a commit hash (default: time)", true);
+    parser.addOption("slowdown", 's', "Extra work in percent for the regression benchmark (default: 0)", true);
+    parser.addOption("record", 'R', "Write an access trace instead of analyzing in process (race and access demos)", true);
+    parser.addOption("workers", 'w', "Threads for 'analyze <trace>' (default: system cores)", true);
     parser.parse();
+    
+    // analysis_tools analyze <trace>: offline analysis of a --record trace
+    std::vector<std::string> positional = parser.getPositionalArgs();
+    if (!positional.empty() && positional[0] == "analyze") {
+        if (positional.size() < 2) {
+            std::cerr << "Usage: analysis_tools analyze <trace> [--workers N]" << std::endl;
+            return 2;
+        }
+        return analyzeTrace(positional[1], parser.getIntValue("workers", omp_get_num_procs()));
+    }
 
     // Set the number of threads
     int numThreads = parser.getIntValue("threads", omp_get_num_procs());
@@ -1201,14 +1681,38 @@ int main(int argc, char* argv[]) {
     
     // Create reports directory if it doesn't exist
     std::string reportsDir = "../reports";
-    CreateDirectoryA(reportsDir.c_str(), NULL);
+    std::error_code dirError;
+    std::filesystem::create_directories(reportsDir, dirError);
+    
+    // Record-then-analyze: the instrumented demos only write the trace
+    std::string traceFile = parser.getStringValue("record", "");
+    if (!traceFile.empty() && !raceDetector.startRecording(traceFile)) {
+        return 2;
+    }
     
     if (demo == "race" || demo == "all") {
         demonstrateRaceDetection();
     }
     
+    if (demo == "access" || demo == "all") {
+        std::cout << "Analyzing array accesses (static schedule)..." << std::endl;
+        analyzeDataRaces(10000, numThreads, false);
+        std::cout << "Analyzing array accesses (dynamic schedule)..." << std::endl;
+        analyzeDataRaces(10000, numThreads, true);
+    }
+    
+    if (raceDetector.isRecording()) {
+        uint64_t records = raceDetector.stopRecording();
+        std::cout << "Recorded " << records << " records to " << traceFile
+                  << "; run 'analysis_tools analyze " << traceFile << "' to analyze them" << std::endl;
+    }
+    
+    int regressions = 0;
     if (demo == "regression" || demo == "all") {
-        demonstratePerformanceRegression();
+        regressions = demonstratePerformanceRegression(
+            parser.getStringValue("history", "../reports/benchmark_history.jsonl"),
+            parser.getStringValue("run-id", ""),
+            parser.getIntValue("slowdown", 0));
     }
     
     if (demo == "pattern" || demo == "all") {
@@ -1217,5 +1721,10 @@ int main(int argc, char* argv[]) {
     
     std::cout << "\nAnalysis complete! Check reports in the '../reports' directory." << std::endl;
     
+    // Non-zero exit code so a CI step can gate on performance regressions
+    if (regressions > 0) {
+        std::cout << "Performance gate failed: " << regressions << " regression(s)" << std::endl;
+        return 1;
+    }
     return 0;
 } 
\ No newline at end of file
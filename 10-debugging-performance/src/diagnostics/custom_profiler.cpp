@@ -8,10 +8,13 @@
 #include <sstream>
 #include <iomanip>
 #include <map>
+#include <set>
 #include <algorithm>
 #include <memory>
 #include <limits>
+#include <filesystem>
 #include <omp.h>
+#ifdef _WIN32
 #include <Windows.h>
 #include <Pdh.h>
 #include <PdhMsg.h>
@@ -20,12 +23,15 @@
 #undef min
 #undef max
 
+#pragma comment(lib, "pdh.lib")
+#endif
+
 #include "profiler.h"
+#include "hardware_counters.h"
+#include "energy_meter.h"
 #include "debug_utils.h"
 #include "cli_parser.h"
 
-#pragma comment(lib, "pdh.lib")
-
 // Define chart colors
 const std::vector<std::string> colors = {
     "rgba(75, 192, 192, 1)",
@@ -37,23 +43,22 @@ const std::vector<std::string> colors = {
     "rgba(199, 199, 199, 1)"
 };
 
-// Custom Timer implementation to measure code segments
+// Custom Timer implementation to measure code segments; records into the calling
+// thread's profiler buffer, so timing a hot loop body takes no lock
 class ScopedTimer {
 private:
-    const std::string name;
-    std::chrono::high_resolution_clock::time_point startTime;
+    int token;
     bool finished;
-    int threadId;
 
 public:
-    ScopedTimer(const std::string& timerName) 
-        : name(timerName), 
-          startTime(std::chrono::high_resolution_clock::now()), 
-          finished(false),
-          threadId(omp_get_thread_num()) {
-        
-        // Register the start event
-        Profiler::getInstance().startEvent(name, threadId);
+    explicit ScopedTimer(Profiler::SectionId section)
+        : token(Profiler::getInstance().startSection(section)),
+          finished(false) {
+    }
+
+    // Interns the name on every call; keep an ID for timers in loops
+    explicit ScopedTimer(const std::string& timerName)
+        : ScopedTimer(Profiler::internSection(timerName)) {
     }
 
     ~ScopedTimer() {
@@ -64,18 +69,14 @@ public:
 
     void stop() {
         if (!finished) {
-            auto endTime = std::chrono::high_resolution_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
-            
-            // Register the end event
-            Profiler::getInstance().endEvent(name, threadId, duration);
-            
+            Profiler::getInstance().endSection(token);
             finished = true;
         }
     }
 };
 
-// Performance counters for hardware metrics
+#ifdef _WIN32
+// Performance counters for system metrics (PDH)
 class PerformanceCounters {
 private:
     PDH_HQUERY queryHandle;
@@ -185,19 +186,107 @@ public:
         return result;
     }
 };
+#else
+// Performance counters for hardware metrics (perf_event); values are rates over
+// the interval between two collectData calls, summed over every thread that has
+// read its counters
+class PerformanceCounters {
+private:
+    using Metric = double (*)(const CounterSample&);
+
+    std::map<std::string, Metric> counters;
+    CounterSample lastSample;
+    CounterSample interval;
+    bool initialized;
+
+public:
+    PerformanceCounters() : initialized(false) {
+        initialize();
+    }
+
+    bool initialize() {
+        if (!HardwareCounters::isAvailable()) {
+            std::cerr << "Hardware counters unavailable: " << HardwareCounters::unavailableReason() << std::endl;
+            return false;
+        }
+        initialized = true;
+
+        // Add common performance counters
+        addCounter("Hardware", "IPC");
+        addCounter("Hardware", "LLC MPKI");
+        addCounter("Hardware", "Branch MPKI");
+        addCounter("Hardware", "dTLB MPKI");
+
+        lastSample = HardwareCounters::readProcess();
+        return true;
+    }
+
+    bool addCounter(const std::string& object, const std::string& counter, const std::string& instance = "") {
+        if (!initialized) return false;
+
+        static const std::map<std::string, Metric> metrics = {
+            {"Cycles", [](const CounterSample& s) { return static_cast<double>(s.cycles); }},
+            {"Instructions", [](const CounterSample& s) { return static_cast<double>(s.instructions); }},
+            {"LLC Misses", [](const CounterSample& s) { return static_cast<double>(s.llcMisses); }},
+            {"Branch Misses", [](const CounterSample& s) { return static_cast<double>(s.branchMisses); }},
+            {"dTLB Misses", [](const CounterSample& s) { return static_cast<double>(s.dtlbMisses); }},
+            {"IPC", [](const CounterSample& s) { return s.ipc(); }},
+            {"LLC MPKI", [](const CounterSample& s) { return s.llcMpki(); }},
+            {"Branch MPKI", [](const CounterSample& s) { return s.branchMpki(); }},
+            {"dTLB MPKI", [](const CounterSample& s) { return s.dtlbMpki(); }}
+        };
+
+        auto metric = metrics.find(counter);
+        if (object != "Hardware" || metric == metrics.end()) {
+            std::cerr << "Failed to add counter: \\" << object << "\\" << counter
+                      << ". Not a " << HardwareCounters::backendName() << " metric" << std::endl;
+            return false;
+        }
+
+        // Create a shorter name for this counter
+        std::string shortName = object + "." + counter;
+        if (!instance.empty()) {
+            shortName += "." + instance;
+        }
+
+        counters[shortName] = metric->second;
+        return true;
+    }
+
+    bool collectData() {
+        if (!initialized) return false;
+
+        CounterSample now = HardwareCounters::readProcess();
+        interval = now - lastSample;
+        lastSample = now;
+        return interval.valid;
+    }
+
+    double getCounterValue(const std::string& name) {
+        if (!initialized || counters.find(name) == counters.end()) {
+            return -1.0;
+        }
+        return counters[name](interval);
+    }
+
+    std::map<std::string, double> getAllCounterValues() {
+        std::map<std::string, double> result;
+        if (!initialized) return result;
+
+        collectData();
+
+        for (const auto& counter : counters) {
+            result[counter.first] = getCounterValue(counter.first);
+        }
+
+        return result;
+    }
+};
+#endif
 
 // Implementation of the ProfilerImpl class
 class Profiler::ProfilerImpl {
 private:
-    struct ProfileEvent {
-        std::string name;
-        int threadId;
-        std::chrono::high_resolution_clock::time_point startTime;
-        std::chrono::high_resolution_clock::time_point endTime;
-        double duration; // in microseconds
-        bool complete;
-    };
-
     struct ThreadMetrics {
         int threadId;
         double totalTime; // in microseconds
@@ -207,15 +296,114 @@ private:
         std::map<std::string, double> eventTotals;
     };
 
-    std::vector<ProfileEvent> events;
-    std::map<int, std::map<std::string, std::chrono::high_resolution_clock::time_point>> activeEvents;
-    std::mutex eventsMutex;
+    // Cumulative energy reading at a point on the profiler's clock
+    struct EnergyPoint {
+        Profiler::Clock::time_point time;
+        EnergySample sample;
+    };
+
+    struct SectionEnergy {
+        int calls = 0;
+        double activeSeconds = 0.0;     // Union of the section's intervals over all threads
+        EnergySample energy;            // Interval values while the section was active
+    };
+
+    std::mutex samplesMutex;
     std::chrono::high_resolution_clock::time_point profilingStartTime;
     std::shared_ptr<PerformanceCounters> perfCounters;
     std::vector<std::map<std::string, double>> systemMetricSamples;
+    std::vector<EnergyPoint> energySamples;
     bool collectingSystemMetrics;
     std::thread metricCollectionThread;
 
+    void sampleEnergy(std::map<std::string, double>& metrics) {
+        if (!EnergyMeter::isAvailable()) {
+            return;
+        }
+        EnergyPoint point{Profiler::Clock::now(), EnergyMeter::read()};
+        std::lock_guard<std::mutex> lock(samplesMutex);
+        if (!energySamples.empty()) {
+            EnergySample interval = point.sample - energySamples.back().sample;
+            metrics["Power.Package (W)"] = interval.seconds > 0.0 ? interval.packageJoules / interval.seconds : 0.0;
+            metrics["Power.DRAM (W)"] = interval.seconds > 0.0 ? interval.dramJoules / interval.seconds : 0.0;
+            const double mhz = interval.effectiveMHz(EnergyMeter::baseFrequencyMHz());
+            if (mhz > 0.0) {
+                metrics["Frequency.Effective (MHz)"] = mhz;
+            }
+        }
+        energySamples.push_back(point);
+    }
+
+    static std::string formatMHz(double mhz) {
+        if (mhz <= 0.0) {
+            return "n/a";
+        }
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(0) << mhz << " MHz";
+        return text.str();
+    }
+
+    // Cumulative energy at a time, interpolated linearly between the samples
+    EnergySample energyAt(Profiler::Clock::time_point time) const {
+        auto after = std::lower_bound(energySamples.begin(), energySamples.end(), time,
+                                      [](const EnergyPoint& point, Profiler::Clock::time_point t) { return point.time < t; });
+        if (after == energySamples.begin()) {
+            return energySamples.front().sample;
+        }
+        if (after == energySamples.end()) {
+            return energySamples.back().sample;
+        }
+        const EnergyPoint& before = *(after - 1);
+        const double span = std::chrono::duration<double>(after->time - before.time).count();
+        const double f = span > 0.0 ? std::chrono::duration<double>(time - before.time).count() / span : 0.0;
+        EnergySample result = before.sample;
+        const EnergySample delta = after->sample - before.sample;
+        result.seconds += f * delta.seconds;
+        result.packageJoules += f * delta.packageJoules;
+        result.dramJoules += f * delta.dramJoules;
+        result.aperf += static_cast<uint64_t>(f * delta.aperf);
+        result.mperf += static_cast<uint64_t>(f * delta.mperf);
+        result.valid = before.sample.valid && after->sample.valid;
+        result.frequencyValid = before.sample.frequencyValid && after->sample.frequencyValid;
+        return result;
+    }
+
+    // Energy while each section was running on any thread; overlapping calls count once
+    std::map<std::string, SectionEnergy> getSectionEnergy(const std::vector<Profiler::ProfilePoint>& points) const {
+        std::map<std::string, std::vector<std::pair<Profiler::Clock::time_point, Profiler::Clock::time_point>>> intervals;
+        for (const auto& point : points) {
+            if (point.endTime != Profiler::Clock::time_point()) {
+                intervals[point.name].emplace_back(point.startTime, point.endTime);
+            }
+        }
+
+        std::map<std::string, SectionEnergy> result;
+        for (auto& [sectionName, spans] : intervals) {
+            std::sort(spans.begin(), spans.end());
+            SectionEnergy& section = result[sectionName];
+            section.calls = static_cast<int>(spans.size());
+            section.energy.valid = true;
+            section.energy.frequencyValid = true;
+            for (size_t i = 0; i < spans.size();) {
+                auto begin = spans[i].first;
+                auto end = spans[i].second;
+                for (i++; i < spans.size() && spans[i].first <= end; i++) {
+                    end = std::max(end, spans[i].second);
+                }
+                const EnergySample delta = energyAt(end) - energyAt(begin);
+                section.activeSeconds += std::chrono::duration<double>(end - begin).count();
+                section.energy.seconds += delta.seconds;
+                section.energy.packageJoules += delta.packageJoules;
+                section.energy.dramJoules += delta.dramJoules;
+                section.energy.aperf += delta.aperf;
+                section.energy.mperf += delta.mperf;
+                section.energy.valid = section.energy.valid && delta.valid;
+                section.energy.frequencyValid = section.energy.frequencyValid && delta.frequencyValid;
+            }
+        }
+        return result;
+    }
+
 public:
     ProfilerImpl() : 
         profilingStartTime(std::chrono::high_resolution_clock::now()),
@@ -226,56 +414,20 @@ public:
         stopSystemMetricCollection();
     }
 
-    void startEvent(const std::string& name, int threadId) {
-        std::lock_guard<std::mutex> lock(eventsMutex);
-        activeEvents[threadId][name] = std::chrono::high_resolution_clock::now();
-    }
-
-    void endEvent(const std::string& name, int threadId, double durationMicros) {
-        std::lock_guard<std::mutex> lock(eventsMutex);
-        
-        auto now = std::chrono::high_resolution_clock::now();
-        
-        // Check if the event was started
-        auto& threadEvents = activeEvents[threadId];
-        auto it = threadEvents.find(name);
-        
-        if (it != threadEvents.end()) {
-            // Calculate duration
-            auto start = it->second;
-            double calculatedDuration = 0.0;
-            
-            if (durationMicros <= 0) {
-                calculatedDuration = std::chrono::duration_cast<std::chrono::microseconds>(now - start).count();
-            } else {
-                calculatedDuration = durationMicros;
-            }
-            
-            // Create event
-            ProfileEvent event;
-            event.name = name;
-            event.threadId = threadId;
-            event.startTime = start;
-            event.endTime = now;
-            event.duration = calculatedDuration;
-            event.complete = true;
-            
-            events.push_back(event);
-            
-            // Remove from active events
-            threadEvents.erase(it);
-        }
-    }
-
     void startSystemMetricCollection(int intervalMs = 500) {
         if (collectingSystemMetrics) return;
         
         collectingSystemMetrics = true;
+        {
+            std::lock_guard<std::mutex> lock(samplesMutex);
+            energySamples.clear();
+        }
         metricCollectionThread = std::thread([this, intervalMs]() {
             while (collectingSystemMetrics) {
                 auto metrics = perfCounters->getAllCounterValues();
+                sampleEnergy(metrics);
                 {
-                    std::lock_guard<std::mutex> lock(eventsMutex);
+                    std::lock_guard<std::mutex> lock(samplesMutex);
                     systemMetricSamples.push_back(metrics);
                 }
                 std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
@@ -290,17 +442,20 @@ public:
         if (metricCollectionThread.joinable()) {
             metricCollectionThread.join();
         }
+
+        // Close the last interval so sections ending after the last sample are covered
+        std::map<std::string, double> metrics;
+        sampleEnergy(metrics);
     }
 
-    std::map<int, ThreadMetrics> getThreadMetrics() {
+    std::map<int, ThreadMetrics> getThreadMetrics(const std::vector<Profiler::ProfilePoint>& points) {
         std::map<int, ThreadMetrics> result;
         
-        std::lock_guard<std::mutex> lock(eventsMutex);
-        
-        for (const auto& event : events) {
-            if (!event.complete) continue;
+        for (const auto& point : points) {
+            if (point.endTime == Profiler::Clock::time_point()) continue;
             
-            int threadId = event.threadId;
+            int threadId = point.threadId;
+            double duration = point.duration * 1000.0;  // in microseconds
             
             if (result.find(threadId) == result.end()) {
                 ThreadMetrics metrics;
@@ -313,25 +468,26 @@ public:
             }
             
             auto& metrics = result[threadId];
-            metrics.totalTime += event.duration;
+            metrics.totalTime += duration;
             metrics.eventCount++;
-            metrics.maxDuration = std::max(metrics.maxDuration, event.duration);
-            metrics.minDuration = std::min(metrics.minDuration, event.duration);
+            metrics.maxDuration = std::max(metrics.maxDuration, duration);
+            metrics.minDuration = std::min(metrics.minDuration, duration);
             
-            metrics.eventTotals[event.name] += event.duration;
+            metrics.eventTotals[point.name] += duration;
         }
         
         return result;
     }
 
-    void generateReport(const std::string& filename) {
+    void generateReport(const std::string& filename, double probeOverheadNs) {
         std::ofstream report(filename);
         if (!report.is_open()) {
             std::cerr << "Failed to open file for writing: " << filename << std::endl;
             return;
         }
         
-        auto threadMetrics = getThreadMetrics();
+        const auto& points = Profiler::getInstance().getProfilePoints();
+        auto threadMetrics = getThreadMetrics(points);
         auto totalDuration = std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::high_resolution_clock::now() - profilingStartTime).count();
         
@@ -360,9 +516,98 @@ public:
                << "        <h2>Summary</h2>\n"
                << "        <p>Total profiling time: " << totalDuration << " ms</p>\n"
                << "        <p>Number of threads: " << threadMetrics.size() << "</p>\n"
-               << "        <p>Total events recorded: " << events.size() << "</p>\n"
+               << "        <p>Total events recorded: " << points.size() << "</p>\n"
+               << "        <p>Probe overhead: " << std::fixed << std::setprecision(1) << probeOverheadNs
+               << " ns per section (target &lt; 50 ns)</p>\n"
                << "    </div>\n";
         
+        // Hardware counters per section, when the profiler recorded them
+        std::map<std::string, CounterSample> sectionCounters;
+        for (const auto& point : points) {
+            if (point.counters.valid) {
+                sectionCounters[point.name] += point.counters;
+            }
+        }
+        if (!sectionCounters.empty()) {
+            report << "    <h2>Hardware Counters by Section</h2>\n"
+                   << "    <table>\n"
+                   << "        <tr>\n"
+                   << "            <th>Section</th>\n"
+                   << "            <th>Cycles</th>\n"
+                   << "            <th>Instructions</th>\n"
+                   << "            <th>IPC</th>\n"
+                   << "            <th>LLC MPKI</th>\n"
+                   << "            <th>Branch MPKI</th>\n"
+                   << "            <th>dTLB MPKI</th>\n"
+                   << "        </tr>\n";
+            for (const auto& [sectionName, counters] : sectionCounters) {
+                report << "        <tr>\n"
+                       << "            <td>" << sectionName << "</td>\n"
+                       << "            <td>" << counters.cycles << "</td>\n"
+                       << "            <td>" << counters.instructions << "</td>\n"
+                       << "            <td>" << std::fixed << std::setprecision(2) << counters.ipc() << "</td>\n"
+                       << "            <td>" << std::fixed << std::setprecision(2) << counters.llcMpki() << "</td>\n"
+                       << "            <td>" << std::fixed << std::setprecision(2) << counters.branchMpki() << "</td>\n"
+                       << "            <td>" << std::fixed << std::setprecision(2) << counters.dtlbMpki() << "</td>\n"
+                       << "        </tr>\n";
+            }
+            report << "    </table>\n";
+        }
+        
+        // Energy and frequency, when RAPL was sampled during the run
+        {
+            std::lock_guard<std::mutex> lock(samplesMutex);
+            if (energySamples.size() >= 2) {
+                const double baseMHz = EnergyMeter::baseFrequencyMHz();
+                const EnergySample run = energySamples.back().sample - energySamples.front().sample;
+                const double runsPerKilojoule = run.joules() > 0.0 ? 1000.0 / run.joules() : 0.0;
+
+                report << "    <h2>Energy and Frequency</h2>\n"
+                       << "    <div class=\"summary\">\n"
+                       << "        <p>Energy per run: " << std::fixed << std::setprecision(2) << run.joules()
+                       << " J (package " << run.packageJoules << " J, DRAM " << run.dramJoules << " J) over "
+                       << run.seconds << " s, via " << EnergyMeter::backendName() << "</p>\n"
+                       << "        <p>Average power: " << std::fixed << std::setprecision(1) << run.watts() << " W</p>\n"
+                       << "        <p>Effective frequency: " << formatMHz(run.effectiveMHz(baseMHz))
+                       << (run.frequencyValid ? " (APERF/MPERF, base " + formatMHz(baseMHz) + ")" : " (cpufreq snapshot)")
+                       << "</p>\n"
+                       << "        <p>Performance per watt: " << std::fixed << std::setprecision(2) << runsPerKilojoule
+                       << " runs per kJ</p>\n"
+                       << "    </div>\n"
+                       << "    <table>\n"
+                       << "        <tr>\n"
+                       << "            <th>Section</th>\n"
+                       << "            <th>Calls</th>\n"
+                       << "            <th>Active Time (ms)</th>\n"
+                       << "            <th>Package (J)</th>\n"
+                       << "            <th>DRAM (J)</th>\n"
+                       << "            <th>Average Power (W)</th>\n"
+                       << "            <th>Effective Frequency</th>\n"
+                       << "            <th>Calls per J</th>\n"
+                       << "        </tr>\n";
+                for (const auto& [sectionName, section] : getSectionEnergy(points)) {
+                    const double joules = section.energy.joules();
+                    report << "        <tr>\n"
+                           << "            <td>" << sectionName << "</td>\n"
+                           << "            <td>" << section.calls << "</td>\n"
+                           << "            <td>" << std::fixed << std::setprecision(2) << section.activeSeconds * 1000.0 << "</td>\n"
+                           << "            <td>" << std::fixed << std::setprecision(3) << section.energy.packageJoules << "</td>\n"
+                           << "            <td>" << std::fixed << std::setprecision(3) << section.energy.dramJoules << "</td>\n"
+                           << "            <td>" << std::fixed << std::setprecision(1) << section.energy.watts() << "</td>\n"
+                           << "            <td>" << formatMHz(section.energy.effectiveMHz(baseMHz)) << "</td>\n"
+                           << "            <td>" << std::fixed << std::setprecision(2) << (joules > 0.0 ? section.calls / joules : 0.0) << "</td>\n"
+                           << "        </tr>\n";
+                }
+                report << "    </table>\n"
+                       << "    <p>Energy is whole-machine RAPL energy while the section ran on any thread, interpolated "
+                       << "between metric samples; use a short collection interval for short sections.</p>\n";
+
+                std::cout << "Energy: " << std::fixed << std::setprecision(2) << run.joules() << " J over "
+                          << run.seconds << " s (" << std::setprecision(1) << run.watts() << " W average, "
+                          << formatMHz(run.effectiveMHz(baseMHz)) << " effective)" << std::endl;
+            }
+        }
+        
         // Thread metrics section
         report << "    <h2>Thread Metrics</h2>\n"
                << "    <table>\n"
@@ -476,6 +721,7 @@ public:
         }
         
         // System metrics section
+        std::lock_guard<std::mutex> lock(samplesMutex);
         if (!systemMetricSamples.empty()) {
             report << "    <h2>System Performance Metrics</h2>\n"
                    << "    <div class=\"chart-container\">\n"
@@ -495,11 +741,19 @@ public:
             report << "],\n"
                    << "                datasets: [";
             
-            // Assume all samples have the same metrics
             if (!systemMetricSamples.empty()) {
                 bool firstMetric = true;
+                int colorIndex = 0;
+                
+                // Power and frequency start with the second sample
+                std::set<std::string> metricNames;
+                for (const auto& sample : systemMetricSamples) {
+                    for (const auto& [metricName, value] : sample) {
+                        metricNames.insert(metricName);
+                    }
+                }
                 
-                for (const auto& [metricName, value] : systemMetricSamples[0]) {
+                for (const std::string& metricName : metricNames) {
                     if (!firstMetric) report << ", ";
                     
                     report << "{\n"
@@ -515,9 +769,8 @@ public:
                         firstValue = false;
                     }
                     
-                    int colorIndex = firstMetric ? 0 : 1;
                     report << "],\n"
-                           << "                    borderColor: '" << colors[colorIndex % colors.size()] << "',\n"
+                           << "                    borderColor: '" << colors[colorIndex++ % colors.size()] << "',\n"
                            << "                    fill: false\n"
                            << "                }";
                     
@@ -549,59 +802,50 @@ public:
     }
 };
 
-// Initialize the global Profiler instance
-Profiler& Profiler::getInstance() {
-    static Profiler instance;
+// System metrics and reporting live beside the counters they sample
+Profiler::ProfilerImpl& Profiler::impl() {
+    static ProfilerImpl instance;
     return instance;
 }
 
-// Profiler implementation
-Profiler::Profiler() : m_nextId(0), m_enabled(true), impl(new ProfilerImpl()) {
-}
-
-Profiler::~Profiler() {
-    delete impl;
-}
-
-void Profiler::startEvent(const std::string& name, int threadId) {
-    if (impl) {
-        impl->startEvent(name, threadId);
-    }
-}
-
-void Profiler::endEvent(const std::string& name, int threadId, double durationMicros) {
-    if (impl) {
-        impl->endEvent(name, threadId, durationMicros);
-    }
-}
-
 void Profiler::startSystemMetricCollection(int intervalMs) {
-    if (impl) {
-        impl->startSystemMetricCollection(intervalMs);
-    }
+    impl().startSystemMetricCollection(intervalMs);
 }
 
 void Profiler::stopSystemMetricCollection() {
-    if (impl) {
-        impl->stopSystemMetricCollection();
-    }
+    impl().stopSystemMetricCollection();
 }
 
 void Profiler::generateReport(const std::string& filename) {
-    if (impl) {
-        impl->generateReport(filename);
-    }
+    double overheadNs = m_probeOverheadNs >= 0.0 ? m_probeOverheadNs : measureProbeOverhead();
+    impl().generateReport(filename, overheadNs);
 }
 
 // Example workload to demonstrate custom profiling
 void demoWorkload() {
     const int numThreads = omp_get_max_threads();
     
+    // Record hardware counters per section where the platform has them
+    if (!Profiler::getInstance().setHardwareCounters(true)) {
+        std::cout << "Hardware counters unavailable: " << HardwareCounters::unavailableReason() << std::endl;
+    }
+    
+    // Energy and frequency are sampled with the system metrics where RAPL is readable
+    if (!EnergyMeter::isAvailable()) {
+        std::cout << "Energy metering unavailable: " << EnergyMeter::unavailableReason() << std::endl;
+    }
+    
     // Start collecting system metrics
     Profiler::getInstance().startSystemMetricCollection(1000);
     
     std::cout << "Running demo workload with " << numThreads << " threads..." << std::endl;
     
+    // Intern the section names once, outside the timed regions
+    const Profiler::SectionId threadInitialization = Profiler::internSection("ThreadInitialization");
+    const Profiler::SectionId processingItem = Profiler::internSection("ProcessingItem");
+    const Profiler::SectionId extraProcessing = Profiler::internSection("ExtraProcessing");
+    const Profiler::SectionId threadFinalization = Profiler::internSection("ThreadFinalization");
+    
     // Perform a computationally intensive task
     ScopedTimer mainTimer("TotalExecution");
     
@@ -611,7 +855,7 @@ void demoWorkload() {
         
         // Simulate different work per thread
         {
-            ScopedTimer timer("ThreadInitialization");
+            ScopedTimer timer(threadInitialization);
             std::this_thread::sleep_for(std::chrono::milliseconds(50 + tid * 10));
         }
         
@@ -620,7 +864,7 @@ void demoWorkload() {
         // Parallel loop with different work patterns
         #pragma omp for schedule(dynamic)
         for (int i = 0; i < 100; i++) {
-            ScopedTimer loopTimer("ProcessingItem");
+            ScopedTimer loopTimer(processingItem);
             
             // Different processing times based on item and thread
             int processingTime = 10 + (i % 20) + (tid % 4) * 5;
@@ -628,18 +872,20 @@ void demoWorkload() {
             
             // Some additional work for certain items
             if (i % 10 == 0) {
-                ScopedTimer extraTimer("ExtraProcessing");
+                ScopedTimer extraTimer(extraProcessing);
                 std::this_thread::sleep_for(std::chrono::milliseconds(25));
             }
         }
         
         // Thread finalization
         {
-            ScopedTimer timer("ThreadFinalization");
+            ScopedTimer timer(threadFinalization);
             std::this_thread::sleep_for(std::chrono::milliseconds(30 + (numThreads - tid) * 5));
         }
     }
     
+    mainTimer.stop();
+    
     // Stop system metric collection
     Profiler::getInstance().stopSystemMetricCollection();
 }
@@ -648,11 +894,13 @@ int main(int argc, char* argv[]) {
     CliParser parser(argc, argv);
     parser.addOption("threads", 't', "Number of threads to use (default: system cores)", true);
     parser.addOption("output", 'o', "Output HTML report file name (default: profiler_report.html)", true);
+    parser.addOption("folded", 'f', "Folded-stack file for flamegraph.pl/speedscope (default: profiler_stacks.folded)", true);
     parser.parse();
 
     // Set parameters
     int numThreads = parser.getIntValue("threads", omp_get_num_procs());
     std::string outputFile = parser.getStringValue("output", "profiler_report.html");
+    std::string foldedFile = parser.getStringValue("folded", "profiler_stacks.folded");
     
     omp_set_num_threads(numThreads);
     
@@ -669,11 +917,24 @@ int main(int argc, char* argv[]) {
     std::string reportPath = "../reports/" + outputFile;
     
     // Ensure reports directory exists
-    std::string reportsDir = "../reports";
-    CreateDirectoryA(reportsDir.c_str(), NULL);
+    std::error_code error;
+    std::filesystem::create_directories("../reports", error);
+    
+    double overheadNs = Profiler::getInstance().measureProbeOverhead();
+    std::cout << "Profiler overhead: " << std::fixed << std::setprecision(1) << overheadNs
+              << " ns per start/end pair (target < 50 ns)" << std::endl;
     
     Profiler::getInstance().generateReport(reportPath);
     
+    // Where the time went inside the parallel region, by call path
+    std::cout << std::endl;
+    Profiler::getInstance().printCallTree();
+    std::string foldedPath = "../reports/" + foldedFile;
+    if (Profiler::getInstance().saveFoldedStacks(foldedPath)) {
+        std::cout << "Folded stacks saved to " << foldedPath << " (flamegraph.pl " << foldedPath
+                  << " > flame.svg, or open in speedscope)" << std::endl;
+    }
+    
     std::cout << "\nProfiling complete! Open " << reportPath << " in a web browser to view the results." << std::endl;
     
     return 0;
@@ -21,6 +21,11 @@
  * 3. Enable collection of custom hardware events
  * 4. Analyze different types of threading issues with VTune
  * 
+ * The raw ITT calls below show what the API does. Elsewhere, kernels use the
+ * PERF_* macros of perf_markers.h (and PROFILE_SCOPE), which become the same
+ * ITT tasks, frames and counters when configured with -DPERF_MARKERS=ITT,
+ * which also defines INTEL_VTUNE_AVAILABLE for this file.
+ *
  * Note: This requires Intel VTune Profiler to be installed.
  * Intel VTune is part of the oneAPI toolkit and can be downloaded from:
  * https://www.intel.com/content/www/us/en/developer/tools/oneapi/toolkits.html
@@ -10,9 +10,13 @@
 #include <random>
 #include <algorithm>
 #include <numeric>
+#include <cmath>
+#include <map>
+#include <queue>
 #include "../../include/cli_parser.h"
 #include "../../include/profiler.h"
 #include "../../include/debug_utils.h"
+#include "../../include/flat_combining.h"
 
 /**
  * @file excessive_synchronization_fixed.cpp
@@ -23,6 +27,8 @@
  * 2. Using atomic operations for simple counter updates
  * 3. Minimizing the use of barriers
  * 4. Batching updates to reduce synchronization frequency
+ * 5. Logging through per-thread buffers instead of a shared lock (--mode=logging)
+ * 6. Flat combining for shared maps and priority queues (--mode=combining)
  */
 
 // Global variables
@@ -362,6 +368,212 @@ double demoBatchedUpdates(int numThreads, int elements, bool verbose) {
     return duration;
 }
 
+// Shared data structures that every thread updates
+using SharedMap = std::map<int, long long>;
+using SharedQueue = std::priority_queue<long long>;
+
+// How threads reach the shared structure
+enum class SharedAccess {
+    FineCritical,       // One critical section per operation (as in demoFineCritical)
+    CoarseCritical,     // Operations queued locally, one critical section per thread (as in demoCoarseCritical)
+    FlatCombining       // Operations published to FlatCombining and applied in batches
+};
+
+struct SharedAccessResult {
+    std::string workload;
+    std::string strategy;
+    double totalMs;
+    uint64_t lockHolds;         // Critical sections entered, or combiner lock holds
+    double averageBatch;        // Operations applied per lock hold
+    bool consistent;
+};
+
+// Work done between two operations on the shared structure
+double doTinyWork(int i) {
+    double result = 0.0;
+    for (int j = 0; j < 32; j++) {
+        result += std::sin(i + j);
+    }
+    return result;
+}
+
+// Map workload: three of four operations add to a key, the fourth looks one up.
+// Returns how much the operation added to the sum of all values.
+long long mapOperation(SharedMap& map, int i) {
+    const int key = static_cast<int>((static_cast<uint32_t>(i) * 2654435761u) % 4096u);
+    if (i % 4 == 3) {
+        auto it = map.find(key);
+        return (it != map.end() && it->second < 0) ? it->second : 0;
+    }
+    const long long value = i % 1000 + 1;
+    map[key] += value;
+    return value;
+}
+
+// Priority queue workload: pushes alternate with pops of the largest element.
+// Returns how much the operation added to the sum of all queued values.
+long long queueOperation(SharedQueue& queue, int i) {
+    if (i % 2 == 1) {
+        if (queue.empty()) {
+            return 0;
+        }
+        const long long top = queue.top();
+        queue.pop();
+        return -top;
+    }
+    const long long value = (static_cast<uint32_t>(i) * 2654435761u) % 100000u;
+    queue.push(value);
+    return value;
+}
+
+long long structureTotal(const SharedMap& map) {
+    long long total = 0;
+    for (const auto& entry : map) {
+        total += entry.second;
+    }
+    return total;
+}
+
+long long structureTotal(SharedQueue queue) {
+    long long total = 0;
+    for (; !queue.empty(); queue.pop()) {
+        total += queue.top();
+    }
+    return total;
+}
+
+// Run elements operations on one shared structure with the given access strategy
+template<typename Structure, typename Operation>
+SharedAccessResult measureSharedAccess(const std::string& workload, SharedAccess access, int numThreads,
+                                       int elements, Operation operation, bool verbose) {
+    static const char* strategyNames[] = {"Fine critical", "Coarse critical", "Flat combining"};
+    const std::string strategy = strategyNames[static_cast<int>(access)];
+    
+    std::cout << "Running " << workload << " workload (" << strategy << ") with " << numThreads
+              << " threads and " << elements << " operations..." << std::endl;
+    
+    PROFILE_SCOPE("SharedStructureAccess");
+    
+    Structure shared;
+    FlatCombining<Structure> combined(numThreads);
+    long long delta = 0;
+    uint64_t criticalCount = 0;
+    
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    #pragma omp parallel num_threads(numThreads) reduction(+:delta, criticalCount)
+    {
+        std::vector<int> deferred;
+        
+        #pragma omp for
+        for (int i = 0; i < elements; i++) {
+            double result = doTinyWork(i);
+            
+            if (access == SharedAccess::FineCritical) {
+                #pragma omp critical(shared_structure)
+                {
+                    delta += operation(shared, i);
+                    criticalCount++;
+                }
+            } else if (access == SharedAccess::CoarseCritical) {
+                // Results of lookups and pops only become available at the merge
+                deferred.push_back(i);
+            } else {
+                delta += combined.apply([&operation, i](Structure& structure) { return operation(structure, i); });
+            }
+            
+            // Use the result to avoid optimization
+            if (result < -1e9 && verbose) {
+                #pragma omp critical
+                {
+                    std::cout << "Thread " << omp_get_thread_num() << " processed element " << i << std::endl;
+                }
+            }
+        }
+        
+        if (access == SharedAccess::CoarseCritical) {
+            #pragma omp critical(shared_structure)
+            {
+                for (int i : deferred) {
+                    delta += operation(shared, i);
+                }
+                criticalCount++;
+            }
+        }
+    }
+    
+    auto endTime = std::chrono::high_resolution_clock::now();
+    
+    SharedAccessResult result;
+    result.workload = workload;
+    result.strategy = strategy;
+    result.totalMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    if (access == SharedAccess::FlatCombining) {
+        result.lockHolds = combined.stats().combines;
+        result.averageBatch = combined.stats().averageBatch();
+        result.consistent = structureTotal(combined.unsafeGet()) == delta;
+    } else {
+        result.lockHolds = criticalCount;
+        result.averageBatch = criticalCount > 0 ? static_cast<double>(elements) / criticalCount : 0.0;
+        result.consistent = structureTotal(shared) == delta;
+    }
+    
+    std::cout << "Completed in " << std::fixed << std::setprecision(1) << result.totalMs << " ms" << std::endl;
+    return result;
+}
+
+// Compare critical sections with flat combining on a shared map and priority queue
+void compareSharedStructures(int numThreads, int elements, bool verbose, const std::string& reportFile) {
+    const SharedAccess strategies[] = {SharedAccess::FineCritical, SharedAccess::CoarseCritical,
+                                       SharedAccess::FlatCombining};
+    std::vector<SharedAccessResult> results;
+    
+    for (SharedAccess access : strategies) {
+        results.push_back(measureSharedAccess<SharedMap>("std::map", access, numThreads, elements,
+                                                         mapOperation, verbose));
+    }
+    for (SharedAccess access : strategies) {
+        results.push_back(measureSharedAccess<SharedQueue>("priority_queue", access, numThreads, elements,
+                                                           queueOperation, verbose));
+    }
+    
+    std::cout << "\n=== Shared Structure Access ===\n";
+    std::cout << std::left << std::setw(16) << "Workload"
+              << std::left << std::setw(18) << "Strategy"
+              << std::right << std::setw(12) << "Time (ms)"
+              << std::right << std::setw(12) << "Mops/s"
+              << std::right << std::setw(12) << "Lock holds"
+              << std::right << std::setw(12) << "Ops/hold"
+              << std::right << std::setw(8) << "Check" << std::endl;
+    std::cout << std::string(90, '-') << std::endl;
+    for (const auto& result : results) {
+        std::cout << std::left << std::setw(16) << result.workload
+                  << std::left << std::setw(18) << result.strategy
+                  << std::right << std::setw(12) << std::fixed << std::setprecision(1) << result.totalMs
+                  << std::right << std::setw(12) << std::fixed << std::setprecision(2)
+                  << elements / std::max(1e-3, result.totalMs) / 1000.0
+                  << std::right << std::setw(12) << result.lockHolds
+                  << std::right << std::setw(12) << std::fixed << std::setprecision(1) << result.averageBatch
+                  << std::right << std::setw(8) << (result.consistent ? "OK" : "FAIL") << std::endl;
+    }
+    std::cout << "Coarse critical sections defer every result to the end of the loop;"
+              << " fine critical sections and flat combining return each one immediately." << std::endl;
+    
+    if (!reportFile.empty()) {
+        std::ofstream file(reportFile);
+        if (file.is_open()) {
+            file << "Workload,Strategy,Time (ms),Lock holds,Ops per hold,Consistent" << std::endl;
+            for (const auto& result : results) {
+                file << result.workload << "," << result.strategy << ","
+                     << std::fixed << std::setprecision(2) << result.totalMs << ","
+                     << result.lockHolds << "," << result.averageBatch << ","
+                     << (result.consistent ? "yes" : "no") << std::endl;
+            }
+            std::cout << "Performance report saved to: " << reportFile << std::endl;
+        }
+    }
+}
+
 // Display synchronization statistics
 void displaySyncStats(int numThreads) {
     // Calculate totals and averages
@@ -408,6 +620,133 @@ void displaySyncStats(int numThreads) {
     std::cout << std::endl;
 }
 
+// Per-call latency of one DebugLogger backend with every thread logging from a parallel region
+struct LoggingLatency {
+    std::string backend;
+    double p50Ns;
+    double p99Ns;
+    double maxNs;
+    double totalMs;
+    size_t written;
+    uint64_t dropped;
+};
+
+LoggingLatency measureLoggingLatency(const std::string& backend, int numThreads, int messagesPerThread,
+                                     bool async, bool deferred, LogOverflowPolicy policy,
+                                     const std::string& logFile) {
+    DebugLogger& logger = DebugLogger::getInstance();
+    logger.setConsoleOutput(false);
+    logger.setFileOutput(true, logFile);
+    logger.setLogLevel(INFO);
+    logger.clear();
+    if (async) {
+        logger.setAsync(true, 4096, policy);
+    }
+    
+    static const DebugLogger::FormatId format = DebugLogger::registerFormat("Processed element {} of {}, partial {}");
+    
+    std::cout << "Running logging benchmark (" << backend << ") with " << numThreads 
+              << " threads and " << messagesPerThread << " messages per thread..." << std::endl;
+    
+    std::vector<std::vector<double>> latencies(numThreads);
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    #pragma omp parallel num_threads(numThreads)
+    {
+        int threadId = omp_get_thread_num();
+        std::vector<double>& samples = latencies[threadId];
+        samples.reserve(messagesPerThread);
+        
+        for (int i = 0; i < messagesPerThread; i++) {
+            double result = doSmallWork();
+            
+            auto callStart = std::chrono::steady_clock::now();
+            if (deferred) {
+                logger.logFormat(INFO, format, i, messagesPerThread, result);
+            } else {
+                logger.info("Processed element " + std::to_string(i) + " of " + std::to_string(messagesPerThread) +
+                            ", partial " + std::to_string(result));
+            }
+            auto callEnd = std::chrono::steady_clock::now();
+            samples.push_back(std::chrono::duration<double, std::nano>(callEnd - callStart).count());
+        }
+    }
+    
+    auto endTime = std::chrono::high_resolution_clock::now();
+    
+    LoggingLatency result;
+    result.backend = backend;
+    result.totalMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    result.dropped = logger.getDroppedCount();
+    result.written = logger.getLogEntries().size();
+    logger.setAsync(false);
+    logger.setFileOutput(false);
+    logger.setConsoleOutput(true);
+    
+    std::vector<double> all;
+    for (const auto& samples : latencies) {
+        all.insert(all.end(), samples.begin(), samples.end());
+    }
+    std::sort(all.begin(), all.end());
+    auto percentile = [&all](double p) {
+        return all.empty() ? 0.0 : all[std::min(all.size() - 1, static_cast<size_t>(p * all.size()))];
+    };
+    result.p50Ns = percentile(0.50);
+    result.p99Ns = percentile(0.99);
+    result.maxNs = all.empty() ? 0.0 : all.back();
+    
+    std::cout << "Completed in " << std::fixed << std::setprecision(1) << result.totalMs << " ms" << std::endl;
+    return result;
+}
+
+// Compare the synchronous logger with the asynchronous backend
+void compareLoggingBackends(int numThreads, int messagesPerThread, const std::string& reportFile) {
+    const std::string logFile = "logging_benchmark.log";
+    std::vector<LoggingLatency> results;
+    
+    results.push_back(measureLoggingLatency("Synchronous", numThreads, messagesPerThread,
+                                            false, false, LogOverflowPolicy::DropNewest, logFile));
+    results.push_back(measureLoggingLatency("Async, text", numThreads, messagesPerThread,
+                                            true, false, LogOverflowPolicy::DropNewest, logFile));
+    results.push_back(measureLoggingLatency("Async, deferred format", numThreads, messagesPerThread,
+                                            true, true, LogOverflowPolicy::DropNewest, logFile));
+    results.push_back(measureLoggingLatency("Async, deferred, blocking", numThreads, messagesPerThread,
+                                            true, true, LogOverflowPolicy::Block, logFile));
+    
+    std::cout << "\n=== Logging Latency per Call ===\n";
+    std::cout << std::left << std::setw(28) << "Backend"
+              << std::right << std::setw(12) << "p50 (ns)"
+              << std::right << std::setw(12) << "p99 (ns)"
+              << std::right << std::setw(12) << "Max (us)"
+              << std::right << std::setw(12) << "Total (ms)"
+              << std::right << std::setw(10) << "Written"
+              << std::right << std::setw(10) << "Dropped" << std::endl;
+    std::cout << std::string(96, '-') << std::endl;
+    for (const auto& result : results) {
+        std::cout << std::left << std::setw(28) << result.backend
+                  << std::right << std::setw(12) << std::fixed << std::setprecision(0) << result.p50Ns
+                  << std::right << std::setw(12) << std::fixed << std::setprecision(0) << result.p99Ns
+                  << std::right << std::setw(12) << std::fixed << std::setprecision(1) << result.maxNs / 1000.0
+                  << std::right << std::setw(12) << std::fixed << std::setprecision(1) << result.totalMs
+                  << std::right << std::setw(10) << result.written
+                  << std::right << std::setw(10) << result.dropped << std::endl;
+    }
+    
+    if (!reportFile.empty()) {
+        std::ofstream file(reportFile);
+        if (file.is_open()) {
+            file << "Backend,p50 (ns),p99 (ns),Max (ns),Total (ms),Written,Dropped" << std::endl;
+            for (const auto& result : results) {
+                file << result.backend << "," << std::fixed << std::setprecision(0) << result.p50Ns << ","
+                     << result.p99Ns << "," << result.maxNs << ","
+                     << std::fixed << std::setprecision(2) << result.totalMs << ","
+                     << result.written << "," << result.dropped << std::endl;
+            }
+            std::cout << "Performance report saved to: " << reportFile << std::endl;
+        }
+    }
+}
+
 // Run all optimized synchronization approaches and compare
 void compareOptimizedApproaches(int numThreads, int elements, bool verbose, const std::string& reportFile) {
     // Initialize statistics
@@ -552,6 +891,12 @@ int main(int argc, char* argv[]) {
     if (mode == "all") {
         compareOptimizedApproaches(threads, elements, verbose, reportFile);
     }
+    else if (mode == "combining" || mode == "flat-combining") {
+        compareSharedStructures(threads, elements, verbose, reportFile);
+    }
+    else if (mode == "logging") {
+        compareLoggingBackends(threads, parser.getIntOption("messages", 2000), reportFile);
+    }
     else if (mode == "local" || mode == "thread-local") {
         double time = demoThreadLocalStorage(threads, elements, verbose);
         displaySyncStats(threads);
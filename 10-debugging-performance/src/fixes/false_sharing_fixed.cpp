@@ -10,6 +10,8 @@
 #include "../../include/cli_parser.h"
 #include "../../include/profiler.h"
 #include "../../include/debug_utils.h"
+#include "aligned_allocator.h"
+#include "../../include/cache_padded.h"
 
 /**
  * @file false_sharing_fixed.cpp
@@ -19,38 +21,24 @@
  * 1. Padding arrays to ensure each thread uses data in separate cache lines
  * 2. Using thread-local variables to avoid shared data completely
  * 3. Using array-of-structs vs. struct-of-arrays approach
+ *
+ * The padded layouts come from cache_padded.h (CachePadded, PerThread), which
+ * takes the line size from the compiler instead of assuming 64 bytes.
  */
 
-// Default cache line size (in bytes) - typically 64 bytes on modern CPUs
-constexpr int DEFAULT_CACHE_LINE_SIZE = 64;
-
-// Structure with padding to avoid false sharing
-struct PaddedData {
-    alignas(DEFAULT_CACHE_LINE_SIZE) int counter;
-    char padding[DEFAULT_CACHE_LINE_SIZE - sizeof(int)]; // Pad to cache line size
-};
-
-// Structure with explicit alignment - another approach
-struct alignas(DEFAULT_CACHE_LINE_SIZE) AlignedData {
-    int counter;
-    // No explicit padding, but align the whole struct
-};
-
 // Benchmark function for the padded solution
 double benchmarkPadded(int numThreads, int iterations, int cacheLineSize, bool verbose) {
-    // Allocate array of padded data structures
-    std::vector<PaddedData> data(numThreads);
-    for (int i = 0; i < numThreads; i++) {
-        data[i].counter = 0;
-    }
+    // One counter per thread, each on its own cache line
+    PerThread<int> data(numThreads, 0);
     
     std::cout << "Running padded benchmark with " << numThreads 
               << " threads and " << iterations << " iterations..." << std::endl;
     
     // Show padded data structure details
     if (verbose) {
-        std::cout << "PaddedData size: " << sizeof(PaddedData) << " bytes" << std::endl;
-        std::cout << "Each counter is aligned to " << cacheLineSize << " bytes" << std::endl;
+        std::cout << "PerThread slot size: " << sizeof(PerThread<int>::Slot) << " bytes" << std::endl;
+        std::cout << "Each counter is aligned to " << alignof(PerThread<int>::Slot)
+                  << " bytes (running CPU: " << cacheLineSize << ")" << std::endl;
     }
     
     // Start profiling
@@ -65,14 +53,14 @@ double benchmarkPadded(int numThreads, int iterations, int cacheLineSize, bool v
         
         // Each thread repeatedly increments its own counter
         for (int i = 0; i < iterations; i++) {
-            data[threadId].counter++;
+            data[threadId]++;
         }
         
         if (verbose) {
             #pragma omp critical
             {
                 std::cout << "Thread " << threadId << " counter value: " 
-                          << data[threadId].counter << std::endl;
+                          << data[threadId] << std::endl;
             }
         }
     }
@@ -86,10 +74,10 @@ double benchmarkPadded(int numThreads, int iterations, int cacheLineSize, bool v
     // Verify results
     bool correct = true;
     for (int i = 0; i < numThreads; i++) {
-        if (data[i].counter != iterations) {
+        if (data[i] != iterations) {
             correct = false;
             std::cout << "Error: Counter " << i << " value is " 
-                      << data[i].counter << ", expected " << iterations << std::endl;
+                      << data[i] << ", expected " << iterations << std::endl;
         }
     }
     
@@ -102,19 +90,16 @@ double benchmarkPadded(int numThreads, int iterations, int cacheLineSize, bool v
 
 // Benchmark function for the aligned solution
 double benchmarkAligned(int numThreads, int iterations, int cacheLineSize, bool verbose) {
-    // Allocate array of aligned data structures
-    std::vector<AlignedData> data(numThreads);
-    for (int i = 0; i < numThreads; i++) {
-        data[i].counter = 0;
-    }
+    // Array of aligned counters: the alignment also pads each element to a full line
+    std::vector<CachePadded<int>> data(numThreads, CachePadded<int>(0));
     
     std::cout << "Running aligned benchmark with " << numThreads 
               << " threads and " << iterations << " iterations..." << std::endl;
     
     // Show aligned data structure details
     if (verbose) {
-        std::cout << "AlignedData size: " << sizeof(AlignedData) << " bytes" << std::endl;
-        std::cout << "AlignedData alignment: " << alignof(AlignedData) << " bytes" << std::endl;
+        std::cout << "CachePadded<int> size: " << sizeof(CachePadded<int>) << " bytes" << std::endl;
+        std::cout << "CachePadded<int> alignment: " << alignof(CachePadded<int>) << " bytes" << std::endl;
     }
     
     // Start profiling
@@ -129,14 +114,14 @@ double benchmarkAligned(int numThreads, int iterations, int cacheLineSize, bool
         
         // Each thread repeatedly increments its own counter
         for (int i = 0; i < iterations; i++) {
-            data[threadId].counter++;
+            data[threadId].value++;
         }
         
         if (verbose) {
             #pragma omp critical
             {
                 std::cout << "Thread " << threadId << " counter value: " 
-                          << data[threadId].counter << std::endl;
+                          << data[threadId].value << std::endl;
             }
         }
     }
@@ -150,10 +135,10 @@ double benchmarkAligned(int numThreads, int iterations, int cacheLineSize, bool
     // Verify results
     bool correct = true;
     for (int i = 0; i < numThreads; i++) {
-        if (data[i].counter != iterations) {
+        if (data[i].value != iterations) {
             correct = false;
             std::cout << "Error: Counter " << i << " value is " 
-                      << data[i].counter << ", expected " << iterations << std::endl;
+                      << data[i].value << ", expected " << iterations << std::endl;
         }
     }
     
@@ -166,8 +151,8 @@ double benchmarkAligned(int numThreads, int iterations, int cacheLineSize, bool
 
 // Benchmark function for the thread-local approach
 double benchmarkThreadLocal(int numThreads, int iterations, bool verbose) {
-    // Array to store final results
-    std::vector<int> results(numThreads, 0);
+    // Final results, one padded slot per thread
+    PerThread<int> results(numThreads, 0);
     
     std::cout << "Running thread-local benchmark with " << numThreads 
               << " threads and " << iterations << " iterations..." << std::endl;
@@ -225,11 +210,13 @@ double benchmarkThreadLocal(int numThreads, int iterations, bool verbose) {
 
 // Benchmark function for manual array indexing
 double benchmarkArrayIndexing(int numThreads, int iterations, int cacheLineSize, bool verbose) {
-    // Calculate how many integers we can fit in a cache line
+    // Calculate how many integers we can fit in a cache line; the stride is
+    // chosen at run time, so it follows the detected line size
     int intsPerCacheLine = cacheLineSize / sizeof(int);
     
-    // Allocate array with space for each thread in a separate cache line
-    std::vector<int> data(numThreads * intsPerCacheLine, 0);
+    // Allocate array with space for each thread in a separate cache line; the
+    // padding only separates the slots if the array itself starts on a line boundary
+    AlignedVector<int> data(numThreads * intsPerCacheLine, 0);
     
     std::cout << "Running array indexing benchmark with " << numThreads 
               << " threads and " << iterations << " iterations..." << std::endl;
@@ -290,6 +277,56 @@ double benchmarkArrayIndexing(int numThreads, int iterations, int cacheLineSize,
     return duration;
 }
 
+// Time per-thread counters padded to Alignment bytes; the volatile reference
+// turns every increment into a real load and store
+template<size_t Alignment>
+double timePaddedCounters(int numThreads, int iterations) {
+    PerThread<long, Alignment> counters(numThreads, 0);
+    
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    #pragma omp parallel num_threads(numThreads)
+    {
+        volatile long& counter = counters.local();
+        for (int i = 0; i < iterations; i++) {
+            counter = counter + 1;
+        }
+    }
+    
+    auto endTime = std::chrono::high_resolution_clock::now();
+    
+    long expected = static_cast<long>(iterations) * numThreads;
+    long total = counters.combine(0L, [](long sum, long value) { return sum + value; });
+    if (total != expected) {
+        std::cout << "Error: counters sum to " << total << ", expected " << expected << std::endl;
+    }
+    
+    return std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
+}
+
+// Benchmark padding to one cache line against padding to an adjacent-line
+// prefetch pair (128 bytes)
+std::pair<double, double> benchmarkPaddingWidth(int numThreads, int iterations, bool verbose) {
+    std::cout << "Running padding width benchmark with " << numThreads
+              << " threads and " << iterations << " iterations..." << std::endl;
+    
+    if (verbose) {
+        std::cout << "Line-padded slot: " << sizeof(PerThread<long>::Slot) << " bytes, "
+                  << "pair-padded slot: " << sizeof(PerThread<long, PREFETCH_PAIR_SIZE>::Slot) << " bytes" << std::endl;
+    }
+    
+    // Start profiling
+    PROFILE_SCOPE("PaddingWidth");
+    
+    double lineTime = timePaddedCounters<CACHE_LINE_SIZE>(numThreads, iterations);
+    double pairTime = timePaddedCounters<PREFETCH_PAIR_SIZE>(numThreads, iterations);
+    
+    std::cout << "Padded to " << CACHE_LINE_SIZE << " bytes: " << lineTime << " ms, to "
+              << PREFETCH_PAIR_SIZE << " bytes: " << pairTime << " ms" << std::endl;
+    
+    return {lineTime, pairTime};
+}
+
 // Visualize memory layout for educational purposes
 void visualizeFixedLayouts(int numThreads, int cacheLineSize) {
     std::cout << "=== Memory Layout Visualization for Fixed Approaches ===\n";
@@ -354,6 +391,11 @@ void compareApproaches(int numThreads, int iterations, int cacheLineSize, bool v
     std::cout << std::endl;
     
     double arrayIndexingTime = benchmarkArrayIndexing(numThreads, iterations, cacheLineSize, verbose);
+    std::cout << std::endl;
+    
+    auto paddingTimes = benchmarkPaddingWidth(numThreads, iterations, verbose);
+    std::string lineLabel = "Volatile, " + std::to_string(CACHE_LINE_SIZE) + "B";
+    std::string pairLabel = "Volatile, " + std::to_string(PREFETCH_PAIR_SIZE) + "B";
     
     // Print comparison
     std::cout << "\n=== Performance Summary ===\n";
@@ -385,6 +427,18 @@ void compareApproaches(int numThreads, int iterations, int cacheLineSize, bool v
               << std::right << std::setw(15) << std::fixed << std::setprecision(2) 
               << bestTime / arrayIndexingTime << "x" << std::endl;
     
+    // Volatile counters do a load and store per increment, so compare them
+    // with each other rather than with the rows above
+    std::cout << std::left << std::setw(20) << lineLabel
+              << std::right << std::setw(15) << paddingTimes.first
+              << std::right << std::setw(15) << std::fixed << std::setprecision(2)
+              << std::min(paddingTimes.first, paddingTimes.second) / paddingTimes.first << "x" << std::endl;
+    
+    std::cout << std::left << std::setw(20) << pairLabel
+              << std::right << std::setw(15) << paddingTimes.second
+              << std::right << std::setw(15) << std::fixed << std::setprecision(2)
+              << std::min(paddingTimes.first, paddingTimes.second) / paddingTimes.second << "x" << std::endl;
+    
     // Save report to CSV if specified
     if (!reportFile.empty()) {
         std::ofstream file(reportFile);
@@ -394,6 +448,10 @@ void compareApproaches(int numThreads, int iterations, int cacheLineSize, bool v
             file << "Aligned Structs," << alignedTime << "," << std::fixed << std::setprecision(2) << bestTime / alignedTime << std::endl;
             file << "Thread-local," << threadLocalTime << "," << std::fixed << std::setprecision(2) << bestTime / threadLocalTime << std::endl;
             file << "Array Indexing," << arrayIndexingTime << "," << std::fixed << std::setprecision(2) << bestTime / arrayIndexingTime << std::endl;
+            file << lineLabel << "," << paddingTimes.first << "," << std::fixed << std::setprecision(2)
+                 << std::min(paddingTimes.first, paddingTimes.second) / paddingTimes.first << std::endl;
+            file << pairLabel << "," << paddingTimes.second << "," << std::fixed << std::setprecision(2)
+                 << std::min(paddingTimes.first, paddingTimes.second) / paddingTimes.second << std::endl;
             
             std::cout << "Performance report saved to: " << reportFile << std::endl;
         }
@@ -417,7 +475,7 @@ int main(int argc, char* argv[]) {
     // Get parameters
     int threads = parser.getIntOption("threads", std::min(4, omp_get_max_threads()));
     int iterations = parser.getIntOption("iterations", 100000000);
-    int cacheLineSize = parser.getIntOption("cache-line", DEFAULT_CACHE_LINE_SIZE);
+    int cacheLineSize = parser.getIntOption("cache-line", static_cast<int>(detectCacheLineSize()));
     bool verbose = parser.getBoolOption("verbose", false);
     bool quiet = parser.getBoolOption("quiet", false);
     std::string reportFile = parser.getStringOption("report", "");
@@ -432,7 +490,8 @@ int main(int argc, char* argv[]) {
         std::cout << "=== OpenMP False Sharing Fixed Demo ===" << std::endl;
         std::cout << "Threads: " << threads << std::endl;
         std::cout << "Iterations: " << iterations << std::endl;
-        std::cout << "Cache Line Size: " << cacheLineSize << " bytes" << std::endl;
+        std::cout << "Cache Line Size: " << cacheLineSize << " bytes (compiled padding: "
+                  << CACHE_LINE_SIZE << " bytes)" << std::endl;
         std::cout << std::endl;
     }
     
@@ -452,6 +511,9 @@ int main(int argc, char* argv[]) {
     else if (mode == "array") {
         benchmarkArrayIndexing(threads, iterations, cacheLineSize, verbose);
     }
+    else if (mode == "padding") {
+        benchmarkPaddingWidth(threads, iterations, verbose);
+    }
     else {
         if (!quiet) {
             std::cout << "Unknown mode: " << mode << ". Running all benchmarks." << std::endl;
@@ -12,6 +12,7 @@
 #include "../../include/cli_parser.h"
 #include "../../include/profiler.h"
 #include "../../include/debug_utils.h"
+#include "../../include/cost_partitioner.h"
 
 /**
  * @file load_imbalance_fixed.cpp
@@ -21,7 +22,8 @@
  * 1. Dynamic scheduling - assigns iterations to threads on demand
  * 2. Guided scheduling - starts with large chunks, decreases over time
  * 3. Auto scheduling - lets OpenMP runtime choose the best strategy
- * 4. Custom scheduling with manual work distribution
+ * 4. Custom scheduling: longest-processing-time-first assignment on item
+ *    complexity with work stealing (CostPartitioner)
  */
 
 // Structure to hold work item data
@@ -98,6 +100,15 @@ std::vector<WorkItem> generateImbalancedWorkload(int size, int maxComplexity, in
             workload.emplace_back(i, complexity);
         }
     }
+    else if (pattern == 6) {
+        // Pattern 6: Heavy tail (Pareto): most items are light, a few reach maxComplexity
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+        for (int i = 0; i < size; i++) {
+            double tail = std::pow(1.0 - dist(rng), -1.0 / 1.1);
+            int complexity = std::min(maxComplexity, static_cast<int>(tail));
+            workload.emplace_back(i, complexity);
+        }
+    }
     else {
         // Default: Exponential distribution
         std::exponential_distribution<double> dist(1.5);
@@ -284,107 +295,56 @@ double processWorkloadAuto(std::vector<WorkItem>& workload, int numThreads, bool
     return duration;
 }
 
-// Process workload with complexity-aware scheduling
-double processWorkloadComplexityAware(std::vector<WorkItem>& workload, int numThreads, bool verbose) {
+// Process workload with complexity-aware scheduling: longest-processing-time-first
+// assignment on the estimated complexities, then work stealing
+double processWorkloadComplexityAware(std::vector<WorkItem>& workload, int numThreads, bool verbose,
+                                      double estimateError = 0.0) {
     // Reset thread statistics
     g_stats.reset();
     
     std::cout << "Processing workload with " << workload.size() << " items using "
-              << numThreads << " threads and COMPLEXITY-AWARE scheduling..." << std::endl;
+              << numThreads << " threads and COMPLEXITY-AWARE scheduling";
+    if (estimateError > 0.0) {
+        std::cout << " (estimates off by up to " << std::fixed << std::setprecision(0)
+                  << estimateError * 100.0 << "%)";
+    }
+    std::cout << "..." << std::endl;
     
     // Start profiling
     PROFILE_SCOPE("ComplexityAwareScheduling");
     
-    // First, calculate the total complexity
-    int totalComplexity = 0;
-    for (const auto& item : workload) {
-        totalComplexity += item.complexity;
-    }
-    
-    // Calculate target complexity per thread
-    int targetComplexity = totalComplexity / numThreads;
-    
-    if (verbose) {
-        std::cout << "Total workload complexity: " << totalComplexity << std::endl;
-        std::cout << "Target complexity per thread: " << targetComplexity << std::endl;
-    }
-    
-    // Sort workload by complexity (descending)
-    std::sort(workload.begin(), workload.end(), 
-              [](const WorkItem& a, const WorkItem& b) {
-                  return a.complexity > b.complexity;
-              });
-    
-    // Assign start and end indices for each thread
-    std::vector<std::pair<int, int>> threadRanges(numThreads);
-    
-    // Greedy partitioning algorithm
-    std::vector<int> threadComplexity(numThreads, 0);
-    int currentThread = 0;
-    threadRanges[0].first = 0;  // First thread starts at index 0
-    
-    for (size_t i = 0; i < workload.size(); i++) {
-        // Add current item to current thread
-        threadComplexity[currentThread] += workload[i].complexity;
-        
-        // Check if we've reached target complexity for this thread
-        if (threadComplexity[currentThread] >= targetComplexity && currentThread < numThreads - 1) {
-            // Set end index for current thread
-            threadRanges[currentThread].second = i + 1;
-            
-            // Move to next thread
-            currentThread++;
-            threadRanges[currentThread].first = i + 1;
-        }
-    }
-    
-    // Set end index for last thread
-    threadRanges[currentThread].second = workload.size();
-    
-    // Fill in any empty threads (might happen with small workloads)
-    for (int t = currentThread + 1; t < numThreads; t++) {
-        threadRanges[t].first = workload.size();
-        threadRanges[t].second = workload.size();
-    }
+    // Cost estimates; with estimateError each is scaled by a random factor in
+    // [1 / (1 + error), 1 + error] to model a poor cost model
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> logFactor(-std::log1p(estimateError), std::log1p(estimateError));
+    CostPartitioner partitioner;
+    partitioner.plan(workload.begin(), workload.end(), [&](const WorkItem& item) {
+        return item.complexity * (estimateError > 0.0 ? std::exp(logFactor(rng)) : 1.0);
+    }, numThreads);
     
     if (verbose) {
         for (int t = 0; t < numThreads; t++) {
-            std::cout << "Thread " << t << " assigned items " 
-                      << threadRanges[t].first << " to " << threadRanges[t].second - 1
-                      << " (complexity: " << threadComplexity[t] << ")" << std::endl;
+            std::cout << "Thread " << t << " planned complexity: " << partitioner.plannedCost(t) << std::endl;
         }
+        std::cout << "Planned imbalance: " << partitioner.plannedImbalance() << "x" << std::endl;
     }
     
     auto startTime = std::chrono::high_resolution_clock::now();
     
-    // Process workload with custom complexity-aware scheduling
+    // Each thread runs its own queue heaviest first, then steals
     #pragma omp parallel num_threads(numThreads)
     {
         int threadId = omp_get_thread_num();
         auto threadStartTime = std::chrono::high_resolution_clock::now();
         
-        // Get assigned range for this thread
-        int start = threadRanges[threadId].first;
-        int end = threadRanges[threadId].second;
-        
-        // Process assigned items
-        for (int i = start; i < end; i++) {
+        partitioner.execute([&](size_t i) {
             // Track work processed by this thread
             g_stats.itemsProcessed[threadId]++;
             g_stats.totalComplexity[threadId] += workload[i].complexity;
             
             // Do the work based on item complexity
             workload[i].result = doWork(workload[i].complexity);
-            
-            if (verbose && i % 1000 == 0) {
-                #pragma omp critical
-                {
-                    std::cout << "Thread " << threadId << " processed item " 
-                              << workload[i].id << " with complexity " 
-                              << workload[i].complexity << std::endl;
-                }
-            }
-        }
+        });
         
         auto threadEndTime = std::chrono::high_resolution_clock::now();
         g_stats.timeSpent[threadId] = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -395,7 +355,12 @@ double processWorkloadComplexityAware(std::vector<WorkItem>& workload, int numTh
     double duration = std::chrono::duration_cast<std::chrono::milliseconds>(
         endTime - startTime).count();
     
-    std::cout << "Complexity-aware scheduling completed in " << duration << " ms" << std::endl;
+    size_t stolen = 0;
+    for (int t = 0; t < numThreads; t++) {
+        stolen += partitioner.stolenCount(t);
+    }
+    std::cout << "Complexity-aware scheduling completed in " << duration << " ms ("
+              << stolen << " items stolen)" << std::endl;
     
     return duration;
 }
@@ -485,6 +450,13 @@ void compareSchedulingStrategies(std::vector<WorkItem>& workload, int numThreads
     std::vector<int> complexityAwareItems = g_stats.itemsProcessed;
     std::vector<double> complexityAwareTimes = g_stats.timeSpent;
     displayThreadStats(numThreads);
+    std::cout << std::endl;
+    
+    // Same with estimates off by up to 2x either way; stealing absorbs the error
+    double noisyTime = processWorkloadComplexityAware(workload, numThreads, verbose, 1.0);
+    std::vector<int> noisyItems = g_stats.itemsProcessed;
+    std::vector<double> noisyTimes = g_stats.timeSpent;
+    displayThreadStats(numThreads);
     
     // Print comparison
     std::cout << "\n=== Performance Summary ===\n";
@@ -494,7 +466,7 @@ void compareSchedulingStrategies(std::vector<WorkItem>& workload, int numThreads
     std::cout << std::string(55, '-') << std::endl;
     
     // Calculate the best time for relative comparison
-    double bestTime = std::min({dynamicTime, guidedTime, autoTime, complexityAwareTime});
+    double bestTime = std::min({dynamicTime, guidedTime, autoTime, complexityAwareTime, noisyTime});
     
     std::cout << std::left << std::setw(25) << "Dynamic" 
               << std::right << std::setw(15) << dynamicTime 
@@ -516,6 +488,11 @@ void compareSchedulingStrategies(std::vector<WorkItem>& workload, int numThreads
               << std::right << std::setw(15) << std::fixed << std::setprecision(2) 
               << (bestTime == 0 ? 1.0 : bestTime / complexityAwareTime) << "x" << std::endl;
     
+    std::cout << std::left << std::setw(25) << "Complexity-Aware (noisy)" 
+              << std::right << std::setw(15) << noisyTime
+              << std::right << std::setw(15) << std::fixed << std::setprecision(2) 
+              << (bestTime == 0 ? 1.0 : bestTime / noisyTime) << "x" << std::endl;
+    
     // Save report to CSV if specified
     if (!reportFile.empty()) {
         std::ofstream file(reportFile);
@@ -529,6 +506,8 @@ void compareSchedulingStrategies(std::vector<WorkItem>& workload, int numThreads
                  << (bestTime == 0 ? 1.0 : bestTime / autoTime) << std::endl;
             file << "Complexity-Aware," << complexityAwareTime << "," << std::fixed << std::setprecision(2) 
                  << (bestTime == 0 ? 1.0 : bestTime / complexityAwareTime) << std::endl;
+            file << "Complexity-Aware (noisy)," << noisyTime << "," << std::fixed << std::setprecision(2) 
+                 << (bestTime == 0 ? 1.0 : bestTime / noisyTime) << std::endl;
             
             // Add thread work statistics
             file << "\nDynamic Thread Statistics" << std::endl;
@@ -555,6 +534,12 @@ void compareSchedulingStrategies(std::vector<WorkItem>& workload, int numThreads
                 file << i << "," << complexityAwareItems[i] << "," << complexityAwareTimes[i] << std::endl;
             }
             
+            file << "\nComplexity-Aware (noisy) Thread Statistics" << std::endl;
+            file << "Thread,Items,Time (ms)" << std::endl;
+            for (int i = 0; i < numThreads; i++) {
+                file << i << "," << noisyItems[i] << "," << noisyTimes[i] << std::endl;
+            }
+            
             std::cout << "Performance report saved to: " << reportFile << std::endl;
         }
     }
@@ -9,9 +9,14 @@
 #include <algorithm>
 #include <cstring>
 #include <numeric>
+#include <cmath>
+#include <cstdint>
 #include "../../include/cli_parser.h"
 #include "../../include/profiler.h"
 #include "../../include/debug_utils.h"
+#include "aligned_allocator.h"
+#include "../../include/cache_padded.h"
+#include "../../include/prefetch.h"
 
 /**
  * @file memory_issues_fixed.cpp
@@ -22,36 +27,26 @@
  * 2. Memory bandwidth optimization
  * 3. NUMA-aware allocation and access
  * 4. Cache-oblivious algorithms
+ * 5. Software prefetching and AMAC for gathers and hash probes, tiling for strided sweeps
  */
 
-// Constants for memory tests
-constexpr int CACHE_LINE_SIZE = 64;    // Typical cache line size in bytes
+// Constants for memory tests (CACHE_LINE_SIZE comes from cache_padded.h)
 constexpr int KB = 1024;
 constexpr int MB = 1024 * KB;
 
 // Cache line aligned array structure
 struct AlignedArray {
+    AlignedVector<int, CACHE_LINE_SIZE> storage;
     int* data;
     size_t size;
     
-    AlignedArray(size_t size_) : size(size_) {
-        // Allocate cache-aligned memory
-        #ifdef _WIN32
-        data = (int*)_aligned_malloc(size * sizeof(int), CACHE_LINE_SIZE);
-        #else
-        posix_memalign((void**)&data, CACHE_LINE_SIZE, size * sizeof(int));
-        #endif
-        
-        std::memset(data, 0, size * sizeof(int));
-    }
+    AlignedArray(size_t size_) : storage(size_, 0), data(storage.data()), size(size_) {}
     
-    ~AlignedArray() {
-        #ifdef _WIN32
-        _aligned_free(data);
-        #else
-        free(data);
-        #endif
-    }
+    // Moving keeps the buffer, so data stays valid; a copy would not
+    AlignedArray(const AlignedArray&) = delete;
+    AlignedArray& operator=(const AlignedArray&) = delete;
+    AlignedArray(AlignedArray&&) = default;
+    AlignedArray& operator=(AlignedArray&&) = default;
 };
 
 // Structure for memory performance statistics
@@ -66,7 +61,7 @@ struct MemoryStats {
 template<typename T>
 class BlockedArray {
 private:
-    std::vector<T> data;
+    AlignedVector<T, CACHE_LINE_SIZE> data;
     size_t rows;
     size_t cols;
     size_t blockSize;
@@ -337,13 +332,13 @@ MemoryStats measureCacheObliviousTranspose(int numThreads, int matrixSize, bool
               << "..." << std::endl;
     
     // Allocate matrices
-    std::vector<int> matrixA(matrixSize * matrixSize, 1);
-    std::vector<int> matrixB(matrixSize * matrixSize, 0);
+    AlignedVector<int, CACHE_LINE_SIZE> matrixA(matrixSize * matrixSize, 1);
+    AlignedVector<int, CACHE_LINE_SIZE> matrixB(matrixSize * matrixSize, 0);
     
     // Helper function for recursive transpose
     auto transposeRecursive = [&](auto&& self, int startRow, int startCol, 
                                   int numRows, int numCols, 
-                                  const std::vector<int>& src, std::vector<int>& dst) -> void {
+                                  const AlignedVector<int, CACHE_LINE_SIZE>& src, AlignedVector<int, CACHE_LINE_SIZE>& dst) -> void {
         // Base case: small enough to transpose directly
         if (numRows <= 32 && numCols <= 32) {
             for (int i = 0; i < numRows; i++) {
@@ -481,8 +476,359 @@ MemoryStats measureSoftwarePrefetching(int* data, size_t size, int numThreads, b
     return stats;
 }
 
+// Passes over the data for the random-access tests; each pass misses on almost every element
+constexpr size_t RANDOM_ITERATIONS = 10;
+
+// Shuffled indices per thread, each within the thread's own chunk (the pattern of memory_issues.cpp)
+std::vector<std::vector<int>> generateThreadRandomIndices(size_t size, int numThreads) {
+    std::vector<std::vector<int>> threadIndices(numThreads);
+    for (int t = 0; t < numThreads; t++) {
+        size_t startIdx = t * (size / numThreads);
+        size_t endIdx = (t == numThreads - 1) ? size : startIdx + size / numThreads;
+        threadIndices[t].resize(endIdx - startIdx);
+        std::iota(threadIndices[t].begin(), threadIndices[t].end(), static_cast<int>(startIdx));
+        std::mt19937 rng(42 + t);  // Fixed seed for reproducibility
+        std::shuffle(threadIndices[t].begin(), threadIndices[t].end(), rng);
+    }
+    return threadIndices;
+}
+
+// Print and package the result of a test that read and wrote `elements` ints
+MemoryStats reportAccessTest(const std::string& name, double duration, double elements, double missRate) {
+    double bandwidthMBps = (elements * sizeof(int) * 2 / MB) / duration;  // Read + Write
+    
+    std::cout << name << " completed in " << std::fixed << std::setprecision(3) << duration << " seconds, "
+              << std::fixed << std::setprecision(2) << bandwidthMBps << " MB/s" << std::endl;
+    
+    MemoryStats stats;
+    stats.totalTime = duration;
+    stats.bandwidthMBps = bandwidthMBps;
+    stats.elementsPerSecond = elements / duration;
+    stats.missRate = missRate;
+    return stats;
+}
+
+// Gather with one of three strategies: 0 = plain loop, otherwise prefetch `distance` ahead
+// (grouped = false) or in groups of `distance` (grouped = true)
+MemoryStats measureRandomGather(int* data, const std::vector<std::vector<int>>& threadIndices,
+                                int numThreads, size_t distance, bool grouped, bool verbose) {
+    std::string name = distance == 0 ? "Random access baseline" :
+                       grouped ? "Group-prefetched gather (group " + std::to_string(distance) + ")" :
+                                 "Prefetched gather (distance " + std::to_string(distance) + ")";
+    size_t elements = 0;
+    for (const auto& indices : threadIndices) {
+        elements += indices.size();
+    }
+    
+    std::cout << "Running " << name << " with " << numThreads << " threads and "
+              << (elements * sizeof(int) / MB) << " MB of data..." << std::endl;
+    
+    PROFILE_SCOPE("RandomGather");
+    
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    #pragma omp parallel num_threads(numThreads)
+    {
+        int threadId = omp_get_thread_num();
+        const auto& indices = threadIndices[threadId];
+        auto increment = [](int& value) { value = value + 1; };
+        
+        for (size_t iter = 0; iter < RANDOM_ITERATIONS; iter++) {
+            if (distance == 0) {
+                for (size_t i = 0; i < indices.size(); i++) {
+                    data[indices[i]] = data[indices[i]] + 1;
+                }
+            } else if (grouped) {
+                groupPrefetchedGather(data, indices.data(), indices.size(), distance, increment);
+            } else {
+                prefetchedGather(data, indices.data(), indices.size(), distance, increment);
+            }
+            
+            if (verbose && iter % 5 == 0) {
+                #pragma omp critical
+                {
+                    std::cout << "Thread " << threadId << " completed iteration " << iter << std::endl;
+                }
+            }
+        }
+    }
+    
+    auto endTime = std::chrono::high_resolution_clock::now();
+    double duration = std::chrono::duration<double>(endTime - startTime).count();
+    
+    // Prefetching does not remove the misses, it overlaps them
+    return reportAccessTest(name, duration, static_cast<double>(elements) * RANDOM_ITERATIONS, 0.9);
+}
+
+// Chained hash table whose nodes sit in random memory order, so every hop is a miss
+class ChainedHashTable {
+public:
+    struct Node {
+        uint64_t key;
+        uint64_t value;
+        const Node* next;
+    };
+    
+    explicit ChainedHashTable(size_t numKeys) {
+        size_t bucketCount = 1;
+        while (bucketCount < numKeys) {
+            bucketCount <<= 1;
+        }
+        m_mask = bucketCount - 1;
+        m_buckets.assign(bucketCount, nullptr);
+        m_nodes.resize(numKeys);
+        m_keys.resize(numKeys);
+        
+        std::mt19937_64 rng(7);
+        std::vector<size_t> slots(numKeys);
+        std::iota(slots.begin(), slots.end(), size_t(0));
+        std::shuffle(slots.begin(), slots.end(), rng);
+        
+        for (size_t k = 0; k < numKeys; k++) {
+            uint64_t key = rng();
+            Node& node = m_nodes[slots[k]];
+            node.key = key;
+            node.value = k;
+            const Node*& head = m_buckets[hash(key) & m_mask];
+            node.next = head;
+            head = &node;
+            m_keys[k] = key;
+        }
+    }
+    
+    // Murmur3 finalizer
+    static uint64_t hash(uint64_t key) {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        key *= 0xc4ceb9fe1a85ec53ULL;
+        key ^= key >> 33;
+        return key;
+    }
+    
+    const Node* const* bucketFor(uint64_t key) const { return &m_buckets[hash(key) & m_mask]; }
+    
+    // Value of key, or 0 if absent
+    uint64_t find(uint64_t key) const {
+        for (const Node* node = *bucketFor(key); node != nullptr; node = node->next) {
+            if (node->key == key) {
+                return node->value;
+            }
+        }
+        return 0;
+    }
+    
+    const std::vector<uint64_t>& keys() const { return m_keys; }
+    size_t bytes() const { return m_buckets.size() * sizeof(Node*) + m_nodes.size() * sizeof(Node); }
+    
+private:
+    std::vector<const Node*> m_buckets;
+    std::vector<Node> m_nodes;
+    std::vector<uint64_t> m_keys;
+    uint64_t m_mask = 0;
+};
+
+// One hash probe as an AMAC state machine: bucket head, then one node per step
+struct HashProbeLookup {
+    struct State {
+        uint64_t key = 0;
+        const ChainedHashTable::Node* const* bucket = nullptr;
+        const ChainedHashTable::Node* node = nullptr;
+    };
+    
+    const ChainedHashTable& table;
+    const uint64_t* probes;
+    uint64_t sum = 0;
+    
+    void begin(size_t request, State& state) {
+        state.key = probes[request];
+        state.bucket = table.bucketFor(state.key);
+        state.node = nullptr;
+        prefetchRead(state.bucket);
+    }
+    
+    bool advance(State& state) {
+        if (state.bucket != nullptr) {
+            state.node = *state.bucket;
+            state.bucket = nullptr;
+        } else if (state.node->key == state.key) {
+            sum += state.node->value;
+            return true;
+        } else {
+            state.node = state.node->next;
+        }
+        if (state.node == nullptr) {
+            return true;
+        }
+        prefetchRead(state.node);
+        return false;
+    }
+};
+
+// Hash probes one at a time (width 0) or interleaved with AMAC (width lookups in flight)
+MemoryStats measureHashProbes(const ChainedHashTable& table, const std::vector<uint64_t>& probes,
+                              int numThreads, size_t width, uint64_t& checksum, bool verbose) {
+    std::string name = width == 0 ? "Hash probes, one at a time" :
+                                     "Hash probes, AMAC (width " + std::to_string(width) + ")";
+    std::cout << "Running " << name << " with " << numThreads << " threads over a "
+              << (table.bytes() / MB) << " MB table..." << std::endl;
+    
+    PROFILE_SCOPE("HashProbes");
+    
+    uint64_t sum = 0;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    #pragma omp parallel num_threads(numThreads) reduction(+:sum)
+    {
+        int threadId = omp_get_thread_num();
+        size_t perThread = probes.size() / numThreads;
+        size_t startIdx = threadId * perThread;
+        size_t endIdx = (threadId == numThreads - 1) ? probes.size() : startIdx + perThread;
+        
+        if (width == 0) {
+            for (size_t i = startIdx; i < endIdx; i++) {
+                sum += table.find(probes[i]);
+            }
+        } else {
+            HashProbeLookup lookup{table, probes.data() + startIdx};
+            interleavedLookup(lookup, endIdx - startIdx, width);
+            sum += lookup.sum;
+        }
+        
+        if (verbose) {
+            #pragma omp critical
+            {
+                std::cout << "Thread " << threadId << " completed " << (endIdx - startIdx) << " probes" << std::endl;
+            }
+        }
+    }
+    
+    auto endTime = std::chrono::high_resolution_clock::now();
+    double duration = std::chrono::duration<double>(endTime - startTime).count();
+    checksum = sum;
+    
+    // Elements are probes; each reads a bucket and at least one node
+    return reportAccessTest(name, duration, static_cast<double>(probes.size()), 0.9);
+}
+
+// Repeated strided sweeps, untiled (tileElements == 0) or one tile at a time
+MemoryStats measureStridedSweeps(int* data, size_t size, size_t stride, int numThreads,
+                                 size_t tileElements, bool verbose) {
+    const size_t iterations = 100;
+    std::string name = tileElements == 0 ? "Strided access baseline (stride " + std::to_string(stride) + ")" :
+                       "Tile-blocked strided access (" + std::to_string(tileElements * sizeof(int) / KB) + " KB tiles)";
+    
+    std::cout << "Running " << name << " with " << numThreads << " threads and "
+              << (size * sizeof(int) / MB) << " MB of data..." << std::endl;
+    
+    PROFILE_SCOPE("StridedSweeps");
+    
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    #pragma omp parallel num_threads(numThreads)
+    {
+        int threadId = omp_get_thread_num();
+        size_t perThread = size / numThreads;
+        size_t startIdx = threadId * perThread;
+        size_t endIdx = (threadId == numThreads - 1) ? size : startIdx + perThread;
+        
+        if (tileElements == 0) {
+            for (size_t iter = 0; iter < iterations; iter++) {
+                for (size_t i = startIdx; i < endIdx; i += stride) {
+                    data[i] = data[i] + 1;
+                }
+            }
+        } else {
+            tiledStridedSweep(startIdx, endIdx, stride, iterations, tileElements,
+                              [data](size_t i) { data[i] = data[i] + 1; });
+        }
+        
+        if (verbose) {
+            #pragma omp critical
+            {
+                std::cout << "Thread " << threadId << " completed " << iterations << " sweeps" << std::endl;
+            }
+        }
+    }
+    
+    auto endTime = std::chrono::high_resolution_clock::now();
+    double duration = std::chrono::duration<double>(endTime - startTime).count();
+    
+    // Elements actually touched: one per stride; tiled, only the first pass over a tile misses
+    double touched = static_cast<double>((size + stride - 1) / stride) * iterations;
+    return reportAccessTest(name, duration, touched, tileElements == 0 ? 1.0 : 1.0 / iterations);
+}
+
+// A technique for random or strided access next to the plain loop it replaces
+struct EngineResult {
+    std::string technique;
+    std::string baseline;
+    MemoryStats stats;
+    double speedup;             // Baseline time / technique time
+};
+
+// Benchmark the prefetching and blocking engines against their plain loops
+std::vector<EngineResult> compareAccessEngines(int* data, size_t size, int numThreads, size_t prefetchDistance,
+                                               size_t lookupWidth, size_t tileBytes, bool verbose) {
+    std::vector<EngineResult> results;
+    auto add = [&](const std::string& technique, const std::string& baseline,
+                   const MemoryStats& stats, const MemoryStats& reference) {
+        results.push_back({technique, baseline, stats, reference.totalTime / stats.totalTime});
+    };
+    
+    // Gathers: the same shuffled indices for every variant
+    auto threadIndices = generateThreadRandomIndices(size, numThreads);
+    auto randomBaseline = measureRandomGather(data, threadIndices, numThreads, 0, false, verbose);
+    auto prefetched = measureRandomGather(data, threadIndices, numThreads, prefetchDistance, false, verbose);
+    auto grouped = measureRandomGather(data, threadIndices, numThreads, prefetchDistance, true, verbose);
+    add("Random Access (baseline)", "-", randomBaseline, randomBaseline);
+    add("Prefetched Gather", "Random Access", prefetched, randomBaseline);
+    add("Group-Prefetched Gather", "Random Access", grouped, randomBaseline);
+    std::cout << std::endl;
+    
+    // Hash probes: a table about half the test size, every probe a hit
+    ChainedHashTable table(std::max<size_t>(size * sizeof(int) / 2 / 32, 1024));
+    std::vector<uint64_t> probes = table.keys();
+    std::shuffle(probes.begin(), probes.end(), std::mt19937_64(11));
+    uint64_t naiveSum = 0;
+    uint64_t amacSum = 0;
+    auto naive = measureHashProbes(table, probes, numThreads, 0, naiveSum, verbose);
+    auto amac = measureHashProbes(table, probes, numThreads, lookupWidth, amacSum, verbose);
+    if (naiveSum != amacSum) {
+        std::cerr << "Warning: AMAC probes returned a different checksum (" << amacSum
+                  << " vs " << naiveSum << ")" << std::endl;
+    }
+    add("Hash Probes (baseline)", "-", naive, naive);
+    add("Hash Probes (AMAC)", "Hash Probes", amac, naive);
+    std::cout << std::endl;
+    
+    // Strided sweeps: one int per cache line, as in memory_issues.cpp
+    const size_t stride = 16;
+    auto strided = measureStridedSweeps(data, size, stride, numThreads, 0, verbose);
+    auto tiled = measureStridedSweeps(data, size, stride, numThreads, tileBytes / sizeof(int), verbose);
+    add("Strided Access (baseline)", "-", strided, strided);
+    add("Tile-Blocked Strided", "Strided Access", tiled, strided);
+    
+    std::cout << "\n=== Random/Strided Access Engines ===\n";
+    std::cout << std::left << std::setw(30) << "Technique"
+              << std::right << std::setw(15) << "Time (s)"
+              << std::right << std::setw(20) << "Elements/s"
+              << std::right << std::setw(20) << "Speedup" << std::endl;
+    std::cout << std::string(85, '-') << std::endl;
+    for (const auto& result : results) {
+        std::cout << std::left << std::setw(30) << result.technique
+                  << std::right << std::setw(15) << std::fixed << std::setprecision(3) << result.stats.totalTime
+                  << std::right << std::setw(20) << std::scientific << std::setprecision(3) << result.stats.elementsPerSecond
+                  << std::right << std::setw(19) << std::fixed << std::setprecision(2) << result.speedup << "x" << std::endl;
+    }
+    
+    return results;
+}
+
 // Run all optimized memory tests and compare
-void compareOptimizedMemoryTests(int numThreads, size_t sizeInMB, bool verbose, const std::string& reportFile) {
+void compareOptimizedMemoryTests(int numThreads, size_t sizeInMB, bool verbose, const std::string& reportFile,
+                                 size_t prefetchDistance = DEFAULT_PREFETCH_DISTANCE, size_t lookupWidth = 16,
+                                 size_t tileBytes = 256 * KB) {
     size_t sizeInElements = (sizeInMB * MB) / sizeof(int);
     
     std::cout << "=== Optimized Memory Access Pattern Comparison ===" << std::endl;
@@ -512,6 +858,10 @@ void compareOptimizedMemoryTests(int numThreads, size_t sizeInMB, bool verbose,
     std::cout << std::endl;
     
     auto prefetchStats = measureSoftwarePrefetching(array.data, sizeInElements, numThreads, verbose);
+    std::cout << std::endl;
+    
+    auto engineResults = compareAccessEngines(array.data, sizeInElements, numThreads, prefetchDistance,
+                                              lookupWidth, tileBytes, verbose);
     
     // Print comparison
     std::cout << "\n=== Optimized Memory Performance Summary ===\n";
@@ -592,6 +942,14 @@ void compareOptimizedMemoryTests(int numThreads, size_t sizeInMB, bool verbose,
                  << std::fixed << std::setprecision(2) << prefetchStats.bandwidthMBps / maxBandwidth << ","
                  << std::fixed << std::setprecision(2) << prefetchStats.missRate << std::endl;
             
+            file << std::endl << "Technique,Baseline,Time (s),Elements/s,Speedup" << std::endl;
+            for (const auto& result : engineResults) {
+                file << result.technique << "," << result.baseline << ","
+                     << std::fixed << std::setprecision(3) << result.stats.totalTime << ","
+                     << std::fixed << std::setprecision(2) << result.stats.elementsPerSecond << ","
+                     << std::fixed << std::setprecision(2) << result.speedup << std::endl;
+            }
+            
             std::cout << "Performance report saved to: " << reportFile << std::endl;
         }
     }
@@ -618,6 +976,10 @@ int main(int argc, char* argv[]) {
     bool quiet = parser.getBoolOption("quiet", false);
     std::string reportFile = parser.getStringOption("report", "");
     std::string mode = parser.getStringOption("mode", "all");
+    size_t prefetchDistance = static_cast<size_t>(std::max(0, parser.getIntOption("prefetch-distance",
+                                                                                  static_cast<int>(DEFAULT_PREFETCH_DISTANCE))));
+    size_t lookupWidth = static_cast<size_t>(std::max(1, parser.getIntOption("amac-width", 16)));
+    size_t tileBytes = static_cast<size_t>(std::max(1, parser.getIntOption("tile-kb", 256))) * KB;
     
     // Enable profiling in profile build
     #ifdef PROFILE
@@ -636,7 +998,11 @@ int main(int argc, char* argv[]) {
     
     // Run selected optimization
     if (mode == "all") {
-        compareOptimizedMemoryTests(threads, sizeInMB, verbose, reportFile);
+        compareOptimizedMemoryTests(threads, sizeInMB, verbose, reportFile, prefetchDistance, lookupWidth, tileBytes);
+    }
+    else if (mode == "engines" || mode == "gather") {
+        AlignedArray array(sizeInElements);
+        compareAccessEngines(array.data, array.size, threads, prefetchDistance, lookupWidth, tileBytes, verbose);
     }
     else if (mode == "cache" || mode == "sequential") {
         AlignedArray array(sizeInElements);
@@ -731,7 +1097,7 @@ int main(int argc, char* argv[]) {
         if (!quiet) {
             std::cout << "Unknown optimization: " << mode << ". Using 'all'." << std::endl;
         }
-        compareOptimizedMemoryTests(threads, sizeInMB, verbose, reportFile);
+        compareOptimizedMemoryTests(threads, sizeInMB, verbose, reportFile, prefetchDistance, lookupWidth, tileBytes);
     }
     
     return 0;
@@ -12,6 +12,8 @@
 #include "../include/cli_parser.h"
 #include "../include/profiler.h"
 #include "../include/debug_utils.h"
+#include "numa_allocator.h"
+#include "../include/memory_probes.h"
 
 /**
  * @file memory_issues.cpp
@@ -22,6 +24,9 @@
  * 2. Memory bandwidth saturation
  * 3. NUMA effects on Windows
  * 4. Cache thrashing from multiple threads
+ *
+ * The summary judges each pattern against calibrated limits of the machine:
+ * STREAM bandwidth and the dependent-load latency of each cache level.
  */
 
 // Constants for memory tests
@@ -374,6 +379,90 @@ MemoryStats demonstrateNUMAEffects(int* data, size_t size, int numThreads, bool
     return stats;
 }
 
+// Run the partitioned and cross-thread kernels on buffers placed with each NUMA policy.
+// The partitioned kernel gains from first-touch placement, the cross-thread one from interleaving.
+void compareNUMAPlacement(int numThreads, size_t sizeInMB, const std::string& policyName) {
+    size_t sizeInElements = (sizeInMB * MB) / sizeof(int);
+    
+    std::vector<NumaPolicy> policies;
+    NumaPolicy requested;
+    if (policyName == "all") {
+        policies = {NumaPolicy::Default, NumaPolicy::Node, NumaPolicy::Interleave, NumaPolicy::FirstTouch};
+    } else if (ParseNumaPolicy(policyName, requested)) {
+        policies.push_back(requested);
+    } else {
+        std::cerr << "Unknown NUMA policy: " << policyName
+                  << " (use default, node, interleave, firsttouch or all)" << std::endl;
+        return;
+    }
+    
+    NumaAllocator allocator;
+    std::cout << "=== NUMA Placement Comparison ===" << std::endl;
+    std::cout << "NUMA nodes: " << allocator.getNodeCount()
+              << ", explicit binding " << (allocator.isBindingSupported() ? "available" : "unavailable")
+              << std::endl << std::endl;
+    
+    struct PlacementResult {
+        NumaPolicy policy;
+        MemoryStats partitioned;
+        MemoryStats crossThread;
+    };
+    std::vector<PlacementResult> results;
+    
+    for (NumaPolicy policy : policies) {
+        NumaBuffer<int> buffer(allocator, sizeInElements, policy, 0, 0, numThreads);
+        if (buffer.empty()) {
+            std::cerr << "Allocation failed for policy " << NumaPolicyName(policy) << std::endl;
+            continue;
+        }
+        
+        std::cout << "--- Policy: " << NumaPolicyName(policy) << " ---" << std::endl;
+        allocator.displayPlacement(buffer.data(), buffer.bytes(), "Pages");
+        
+        PlacementResult result;
+        result.policy = policy;
+        result.partitioned = measureSequentialMemory(buffer.data(), buffer.size(), numThreads, false);
+        result.crossThread = demonstrateNUMAEffects(buffer.data(), buffer.size(), numThreads, false);
+        results.push_back(result);
+        std::cout << std::endl;
+    }
+    
+    std::cout << std::left << std::setw(15) << "Policy"
+              << std::right << std::setw(25) << "Partitioned (MB/s)"
+              << std::right << std::setw(25) << "Cross-thread (MB/s)" << std::endl;
+    std::cout << std::string(65, '-') << std::endl;
+    for (const auto& result : results) {
+        std::cout << std::left << std::setw(15) << NumaPolicyName(result.policy)
+                  << std::right << std::setw(25) << std::fixed << std::setprecision(2) << result.partitioned.bandwidthMBps
+                  << std::right << std::setw(25) << std::fixed << std::setprecision(2) << result.crossThread.bandwidthMBps
+                  << std::endl;
+    }
+}
+
+// Share of the STREAM triad bandwidth the same thread count reached
+double fractionOfStream(const MemoryStats& stats, const MemoryLimits& limits, int numThreads) {
+    double stream = limits.triadMBps(numThreads);
+    return stream > 0.0 ? stats.bandwidthMBps / stream : 0.0;
+}
+
+// Judge a pattern against the measured limits rather than a guessed miss rate
+std::string judgeAgainstLimits(const MemoryStats& stats, const MemoryLimits& limits, int numThreads) {
+    double fraction = fractionOfStream(stats, limits, numThreads);
+    if (fraction > 1.1) {
+        return "cache resident";
+    }
+    if (fraction >= 0.7) {
+        return "at bandwidth limit";
+    }
+    // Time per element on one thread, against one trip to DRAM
+    double nsPerElement = stats.elementsPerSecond > 0.0 ? 1e9 * numThreads / stats.elementsPerSecond : 0.0;
+    double dram = limits.dramLatencyNs();
+    if (dram > 0.0 && nsPerElement >= 0.5 * dram) {
+        return "latency bound";
+    }
+    return "below bandwidth limit";
+}
+
 // Run all memory tests and compare
 void compareAllMemoryTests(int numThreads, size_t sizeInMB, bool verbose, const std::string& reportFile) {
     size_t sizeInElements = (sizeInMB * MB) / sizeof(int);
@@ -387,6 +476,12 @@ void compareAllMemoryTests(int numThreads, size_t sizeInMB, bool verbose, const
     // Reset profiler
     Profiler::getInstance().reset();
     
+    // Calibrate first: STREAM over three arrays of a third of the test size each
+    std::cout << "Measuring machine limits..." << std::endl;
+    MemoryLimits limits = MemoryProbes::measure(sizeInMB * MB / 3, numThreads, verbose);
+    MemoryProbes::printLimits(limits);
+    std::cout << std::endl;
+    
     // Run memory tests
     auto seqStats = measureSequentialMemory(array.data, sizeInElements, numThreads, verbose);
     std::cout << std::endl;
@@ -406,82 +501,82 @@ void compareAllMemoryTests(int numThreads, size_t sizeInMB, bool verbose, const
     auto numaStats = demonstrateNUMAEffects(array.data, sizeInElements, numThreads, verbose);
     
     // Print comparison
-    std::cout << "\n=== Memory Performance Summary ===\n";
-    std::cout << std::left << std::setw(25) << "Access Pattern" 
-              << std::right << std::setw(15) << "Time (s)" 
-              << std::right << std::setw(20) << "Bandwidth (MB/s)"
-              << std::right << std::setw(20) << "Relative" << std::endl;
-    std::cout << std::string(80, '-') << std::endl;
+    struct PatternRow {
+        const char* name;
+        const MemoryStats& stats;
+    };
+    const PatternRow rows[] = {
+        {"Sequential Access", seqStats},
+        {"Strided Access", stridedStats},
+        {"Random Access", randomStats},
+        {"Cache Thrashing", thrashingStats},
+        {"NUMA Effects", numaStats},
+    };
     
     // Calculate relative performance based on bandwidth
     double maxBandwidth = std::max({seqStats.bandwidthMBps, stridedStats.bandwidthMBps, 
                                    randomStats.bandwidthMBps, thrashingStats.bandwidthMBps, 
                                    numaStats.bandwidthMBps});
+    double streamMBps = limits.triadMBps(numThreads);
     
-    std::cout << std::left << std::setw(25) << "Sequential Access" 
-              << std::right << std::setw(15) << std::fixed << std::setprecision(2) << seqStats.totalTime
-              << std::right << std::setw(20) << std::fixed << std::setprecision(2) << seqStats.bandwidthMBps
-              << std::right << std::setw(20) << std::fixed << std::setprecision(2) 
-              << seqStats.bandwidthMBps / maxBandwidth << "x" << std::endl;
-    
-    std::cout << std::left << std::setw(25) << "Strided Access" 
-              << std::right << std::setw(15) << std::fixed << std::setprecision(2) << stridedStats.totalTime
-              << std::right << std::setw(20) << std::fixed << std::setprecision(2) << stridedStats.bandwidthMBps
-              << std::right << std::setw(20) << std::fixed << std::setprecision(2) 
-              << stridedStats.bandwidthMBps / maxBandwidth << "x" << std::endl;
-    
-    std::cout << std::left << std::setw(25) << "Random Access" 
-              << std::right << std::setw(15) << std::fixed << std::setprecision(2) << randomStats.totalTime
-              << std::right << std::setw(20) << std::fixed << std::setprecision(2) << randomStats.bandwidthMBps
-              << std::right << std::setw(20) << std::fixed << std::setprecision(2) 
-              << randomStats.bandwidthMBps / maxBandwidth << "x" << std::endl;
-    
-    std::cout << std::left << std::setw(25) << "Cache Thrashing" 
-              << std::right << std::setw(15) << std::fixed << std::setprecision(2) << thrashingStats.totalTime
-              << std::right << std::setw(20) << std::fixed << std::setprecision(2) << thrashingStats.bandwidthMBps
-              << std::right << std::setw(20) << std::fixed << std::setprecision(2) 
-              << thrashingStats.bandwidthMBps / maxBandwidth << "x" << std::endl;
-    
-    std::cout << std::left << std::setw(25) << "NUMA Effects" 
-              << std::right << std::setw(15) << std::fixed << std::setprecision(2) << numaStats.totalTime
-              << std::right << std::setw(20) << std::fixed << std::setprecision(2) << numaStats.bandwidthMBps
-              << std::right << std::setw(20) << std::fixed << std::setprecision(2) 
-              << numaStats.bandwidthMBps / maxBandwidth << "x" << std::endl;
+    std::cout << "\n=== Memory Performance Summary ===\n";
+    std::cout << "STREAM triad with " << numThreads << " threads: " << std::fixed << std::setprecision(2)
+              << streamMBps << " MB/s";
+    if (limits.dramLatencyNs() > 0.0) {
+        std::cout << ", DRAM latency: " << std::fixed << std::setprecision(1) << limits.dramLatencyNs() << " ns";
+    }
+    std::cout << std::endl;
+    std::cout << std::left << std::setw(25) << "Access Pattern" 
+              << std::right << std::setw(15) << "Time (s)" 
+              << std::right << std::setw(20) << "Bandwidth (MB/s)"
+              << std::right << std::setw(12) << "Relative"
+              << std::right << std::setw(12) << "% STREAM"
+              << std::right << std::setw(24) << "Verdict" << std::endl;
+    std::cout << std::string(108, '-') << std::endl;
+    
+    for (const auto& row : rows) {
+        std::cout << std::left << std::setw(25) << row.name 
+                  << std::right << std::setw(15) << std::fixed << std::setprecision(2) << row.stats.totalTime
+                  << std::right << std::setw(20) << std::fixed << std::setprecision(2) << row.stats.bandwidthMBps
+                  << std::right << std::setw(11) << std::fixed << std::setprecision(2) 
+                  << row.stats.bandwidthMBps / maxBandwidth << "x"
+                  << std::right << std::setw(11) << std::fixed << std::setprecision(1)
+                  << 100.0 * fractionOfStream(row.stats, limits, numThreads) << "%"
+                  << std::right << std::setw(24) << judgeAgainstLimits(row.stats, limits, numThreads) << std::endl;
+    }
     
     // Save report to CSV if specified
     if (!reportFile.empty()) {
         std::ofstream file(reportFile);
         if (file.is_open()) {
-            file << "Access Pattern,Time (s),Bandwidth (MB/s),Elements/s,Relative,Est. Miss Rate" << std::endl;
-            file << "Sequential Access," << std::fixed << std::setprecision(2) << seqStats.totalTime << ","
-                 << std::fixed << std::setprecision(2) << seqStats.bandwidthMBps << ","
-                 << std::fixed << std::setprecision(2) << seqStats.elementsPerSecond << ","
-                 << std::fixed << std::setprecision(2) << seqStats.bandwidthMBps / maxBandwidth << ","
-                 << std::fixed << std::setprecision(2) << seqStats.missRate << std::endl;
-            
-            file << "Strided Access," << std::fixed << std::setprecision(2) << stridedStats.totalTime << ","
-                 << std::fixed << std::setprecision(2) << stridedStats.bandwidthMBps << ","
-                 << std::fixed << std::setprecision(2) << stridedStats.elementsPerSecond << ","
-                 << std::fixed << std::setprecision(2) << stridedStats.bandwidthMBps / maxBandwidth << ","
-                 << std::fixed << std::setprecision(2) << stridedStats.missRate << std::endl;
-            
-            file << "Random Access," << std::fixed << std::setprecision(2) << randomStats.totalTime << ","
-                 << std::fixed << std::setprecision(2) << randomStats.bandwidthMBps << ","
-                 << std::fixed << std::setprecision(2) << randomStats.elementsPerSecond << ","
-                 << std::fixed << std::setprecision(2) << randomStats.bandwidthMBps / maxBandwidth << ","
-                 << std::fixed << std::setprecision(2) << randomStats.missRate << std::endl;
-            
-            file << "Cache Thrashing," << std::fixed << std::setprecision(2) << thrashingStats.totalTime << ","
-                 << std::fixed << std::setprecision(2) << thrashingStats.bandwidthMBps << ","
-                 << std::fixed << std::setprecision(2) << thrashingStats.elementsPerSecond << ","
-                 << std::fixed << std::setprecision(2) << thrashingStats.bandwidthMBps / maxBandwidth << ","
-                 << std::fixed << std::setprecision(2) << thrashingStats.missRate << std::endl;
+            file << "Access Pattern,Time (s),Bandwidth (MB/s),Elements/s,Relative,Est. Miss Rate,"
+                 << "STREAM Triad (MB/s),Fraction of STREAM,Verdict" << std::endl;
+            for (const auto& row : rows) {
+                file << row.name << "," << std::fixed << std::setprecision(2) << row.stats.totalTime << ","
+                     << std::fixed << std::setprecision(2) << row.stats.bandwidthMBps << ","
+                     << std::fixed << std::setprecision(2) << row.stats.elementsPerSecond << ","
+                     << std::fixed << std::setprecision(2) << row.stats.bandwidthMBps / maxBandwidth << ","
+                     << std::fixed << std::setprecision(2) << row.stats.missRate << ","
+                     << std::fixed << std::setprecision(2) << streamMBps << ","
+                     << std::fixed << std::setprecision(3) << fractionOfStream(row.stats, limits, numThreads) << ","
+                     << judgeAgainstLimits(row.stats, limits, numThreads) << std::endl;
+            }
             
-            file << "NUMA Effects," << std::fixed << std::setprecision(2) << numaStats.totalTime << ","
-                 << std::fixed << std::setprecision(2) << numaStats.bandwidthMBps << ","
-                 << std::fixed << std::setprecision(2) << numaStats.elementsPerSecond << ","
-                 << std::fixed << std::setprecision(2) << numaStats.bandwidthMBps / maxBandwidth << ","
-                 << std::fixed << std::setprecision(2) << numaStats.missRate << std::endl;
+            // The calibration itself, so reports from different machines can be compared
+            file << std::endl << "Threads,CPU Node,Memory Node,Copy (MB/s),Scale (MB/s),Add (MB/s),Triad (MB/s)" << std::endl;
+            std::vector<StreamResult> streams = limits.threadSweep;
+            streams.insert(streams.end(), limits.nodePairs.begin(), limits.nodePairs.end());
+            for (const auto& result : streams) {
+                file << result.threads << "," << result.cpuNode << "," << result.memNode << ","
+                     << std::fixed << std::setprecision(2) << result.copyMBps << ","
+                     << std::fixed << std::setprecision(2) << result.scaleMBps << ","
+                     << std::fixed << std::setprecision(2) << result.addMBps << ","
+                     << std::fixed << std::setprecision(2) << result.triadMBps << std::endl;
+            }
+            file << std::endl << "Working Set (bytes),Latency (ns)" << std::endl;
+            for (const auto& point : limits.latencyCurve) {
+                file << point.workingSetBytes << "," << std::fixed << std::setprecision(2) << point.nsPerLoad << std::endl;
+            }
             
             std::cout << "Performance report saved to: " << reportFile << std::endl;
         }
@@ -597,6 +692,13 @@ int main(int argc, char* argv[]) {
             }
         }
     }
+    else if (mode == "probes") {
+        MemoryLimits limits = MemoryProbes::measure(static_cast<size_t>(sizeInMB) * MB / 3, threads, true);
+        MemoryProbes::printLimits(limits);
+    }
+    else if (mode == "numa_placement") {
+        compareNUMAPlacement(threads, sizeInMB, parser.getStringOption("numa_policy", "all"));
+    }
     else if (mode == "numa") {
         SimpleArray array(sizeInElements);
         auto stats = demonstrateNUMAEffects(array.data, array.size, threads, verbose);
@@ -1,9 +1,27 @@
 #include "../../include/memory_access_visualizer.h"
+#include "../../include/cli_parser.h"
 #include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
 #include <cmath>
+#include <limits>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <intrin.h>
+    #define MEMORY_TRACKER_HAS_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+    #define MEMORY_TRACKER_HAS_RDTSC 1
+#endif
+
+namespace {
+
+// Reports stay readable however large the tracked regions are
+const size_t kMaxHeatmapCells = 4096;
+const size_t kMaxTimelinePoints = 2000;
+
+} // namespace
 
 // Singleton instance getter
 MemoryAccessTracker& MemoryAccessTracker::getInstance() {
@@ -13,8 +31,11 @@ MemoryAccessTracker& MemoryAccessTracker::getInstance() {
 
 // Constructor
 MemoryAccessTracker::MemoryAccessTracker() 
-    : m_cacheLineSize(64), m_enabled(true) {
+    : m_regionCount(0), m_cacheLineSize(64), m_enabled(true), m_samplingRate(1),
+      m_traceCapacity(kDefaultTraceCapacity) {
+    m_trackedRegions.reserve(kMaxRegions);
     m_startTime = std::chrono::steady_clock::now();
+    m_startTicks = readTicks();
 }
 
 // Track a memory region
@@ -29,31 +50,46 @@ void MemoryAccessTracker::trackMemoryRegion(void* baseAddress, size_t size, cons
             return; // Already tracking this region
         }
     }
+
+    // Records hold a 32-bit offset, and recording threads rely on the reserved capacity
+    if (size > std::numeric_limits<uint32_t>::max() || m_trackedRegions.size() >= kMaxRegions) {
+        std::cerr << "MemoryAccessTracker: cannot track region " << name
+                  << " (regions are limited to 4 GiB and " << kMaxRegions << " in number)" << std::endl;
+        return;
+    }
     
     TrackedRegion region = {baseAddress, size, name};
     m_trackedRegions.push_back(region);
+    m_regionCount.store(m_trackedRegions.size(), std::memory_order_release);
 }
 
 // Record a memory access
 void MemoryAccessTracker::recordAccess(void* address, int threadId, bool isWrite) {
-    if (!m_enabled) return;
+    if (!m_enabled.load(std::memory_order_relaxed)) return;
+    
+    // Skipped accesses cost a decrement
+    ThreadTrace& trace = localTrace();
+    if (--trace.countdown != 0) return;
+    trace.countdown = nextSampleInterval(trace);
     
     if (threadId == -1) {
         threadId = omp_get_thread_num();
     }
     
-    std::lock_guard<std::mutex> lock(m_mutex);
-    
     // Only record accesses to tracked regions
-    for (const auto& region : m_trackedRegions) {
+    const size_t regionCount = m_regionCount.load(std::memory_order_acquire);
+    for (size_t r = 0; r < regionCount; r++) {
+        const TrackedRegion& region = m_trackedRegions[r];
         if (isAddressInRegion(address, region)) {
-            MemoryAccess access = {
-                address,
-                threadId,
-                isWrite,
-                std::chrono::steady_clock::now()
-            };
-            m_accesses.push_back(access);
+            TraceRecord record;
+            record.offset = static_cast<uint32_t>(
+                static_cast<char*>(address) - static_cast<char*>(region.baseAddress));
+            record.region = static_cast<uint16_t>(r);
+            record.threadId = static_cast<uint8_t>(std::min(std::max(threadId, 0), 255));
+            record.isWrite = isWrite ? 1 : 0;
+            record.ticks = readTicks();
+            trace.ring[trace.written % trace.ring.size()] = record;
+            trace.written++;
             return;
         }
     }
@@ -61,12 +97,13 @@ void MemoryAccessTracker::recordAccess(void* address, int threadId, bool isWrite
 
 // Generate HTML visualization
 void MemoryAccessTracker::generateVisualization(const std::string& filename) {
-    if (!m_enabled || m_trackedRegions.empty() || m_accesses.empty()) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    auto trace = collectTrace();
+    if (!m_enabled || m_trackedRegions.empty() || trace.empty()) {
         return;
     }
     
-    std::lock_guard<std::mutex> lock(m_mutex);
-    
     std::string outputFile = filename.empty() ? "memory_access.html" : filename;
     std::ofstream file(outputFile);
     
@@ -75,7 +112,7 @@ void MemoryAccessTracker::generateVisualization(const std::string& filename) {
     }
     
     // Analyze cache line usage
-    auto cacheLineInfo = analyzeCacheLineUsage();
+    auto cacheLineInfo = analyzeCacheLineUsage(trace);
     
     // Generate HTML
     file << "<!DOCTYPE html>\n"
@@ -109,7 +146,7 @@ void MemoryAccessTracker::generateVisualization(const std::string& filename) {
     file << "    <div class='container'>\n"
          << "        <h2>Summary</h2>\n";
     
-    generateSummary(file, cacheLineInfo);
+    generateSummary(file, trace, cacheLineInfo);
     
     // Generate heatmaps for each tracked region
     file << "    <div class='container'>\n"
@@ -137,7 +174,7 @@ void MemoryAccessTracker::generateVisualization(const std::string& filename) {
          << "            <div class='legend-item'><div class='legend-color write'></div>Write</div>\n"
          << "        </div>\n";
     
-    generateAccessTimeline(file);
+    generateAccessTimeline(file, trace);
     
     file << "    </div>\n"
          << "</body>\n"
@@ -148,19 +185,23 @@ void MemoryAccessTracker::generateVisualization(const std::string& filename) {
 
 // Analyze for false sharing
 void MemoryAccessTracker::analyzeFalseSharing(std::ostream& out) {
-    if (!m_enabled || m_trackedRegions.empty() || m_accesses.empty()) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    auto trace = collectTrace();
+    if (!m_enabled || m_trackedRegions.empty() || trace.empty()) {
         out << "No data available for false sharing analysis." << std::endl;
         return;
     }
     
-    std::lock_guard<std::mutex> lock(m_mutex);
-    
-    auto cacheLineInfo = analyzeCacheLineUsage();
+    auto cacheLineInfo = analyzeCacheLineUsage(trace);
+    const uint32_t rate = m_samplingRate.load();
     
     out << "=== False Sharing Analysis ===" << std::endl;
     out << "Cache line size: " << m_cacheLineSize << " bytes" << std::endl;
     out << "Total memory regions tracked: " << m_trackedRegions.size() << std::endl;
-    out << "Total memory accesses recorded: " << m_accesses.size() << std::endl << std::endl;
+    out << "Sampling rate: 1 in " << rate << std::endl;
+    out << "Total memory accesses recorded: " << trace.size()
+        << " (about " << trace.size() * rate << " accesses)" << std::endl << std::endl;
     
     bool foundFalseSharing = false;
     
@@ -195,9 +236,14 @@ void MemoryAccessTracker::analyzeFalseSharing(std::ostream& out) {
 // Reset the tracker
 void MemoryAccessTracker::reset() {
     std::lock_guard<std::mutex> lock(m_mutex);
+    m_regionCount.store(0, std::memory_order_release);
     m_trackedRegions.clear();
-    m_accesses.clear();
+    // Rings stay allocated; their threads keep pointers to them
+    for (auto& trace : m_traces) {
+        trace->written = 0;
+    }
     m_startTime = std::chrono::steady_clock::now();
+    m_startTicks = readTicks();
 }
 
 // Set cache line size
@@ -206,18 +252,99 @@ void MemoryAccessTracker::setCacheLineSize(size_t size) {
     m_cacheLineSize = size;
 }
 
+// Set the sampling rate
+void MemoryAccessTracker::setSamplingRate(uint32_t rate) {
+    m_samplingRate = std::max<uint32_t>(rate, 1);
+}
+
+// Get the sampling rate
+uint32_t MemoryAccessTracker::getSamplingRate() const {
+    return m_samplingRate;
+}
+
+// Set the ring size for new threads
+void MemoryAccessTracker::setTraceCapacity(size_t records) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_traceCapacity = std::max<size_t>(records, 1);
+}
+
 // Enable/disable tracking
 void MemoryAccessTracker::setEnabled(bool enabled) {
-    std::lock_guard<std::mutex> lock(m_mutex);
     m_enabled = enabled;
 }
 
 // Get tracking status
 bool MemoryAccessTracker::isEnabled() const {
-    std::lock_guard<std::mutex> lock(m_mutex);
     return m_enabled;
 }
 
+// The calling thread's ring, allocated on its first access
+MemoryAccessTracker::ThreadTrace& MemoryAccessTracker::localTrace() {
+    thread_local ThreadTrace* trace = nullptr;
+    if (!trace) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::unique_ptr<ThreadTrace> created(new ThreadTrace());
+        created->ring.resize(m_traceCapacity);
+        created->rngState = 0x9E3779B97F4A7C15ULL * (m_traces.size() + 1);
+        trace = created.get();
+        m_traces.push_back(std::move(created));
+    }
+    return *trace;
+}
+
+// Timestamp counter, or steady_clock nanoseconds where there is none
+uint64_t MemoryAccessTracker::readTicks() {
+#ifdef MEMORY_TRACKER_HAS_RDTSC
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// Accesses until the next sample: uniform in [1, 2N - 1], so the mean is N
+// and a loop with a stride that divides N is not sampled at one phase only
+uint64_t MemoryAccessTracker::nextSampleInterval(ThreadTrace& trace) const {
+    const uint32_t rate = m_samplingRate.load(std::memory_order_relaxed);
+    if (rate <= 1) {
+        return 1;
+    }
+    uint64_t x = trace.rngState;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    trace.rngState = x;
+    return 1 + x % (2ULL * rate - 1);
+}
+
+// Records still held in every ring, oldest first
+std::vector<TraceRecord> MemoryAccessTracker::collectTrace() const {
+    std::vector<TraceRecord> trace;
+    for (const auto& thread : m_traces) {
+        const size_t capacity = thread->ring.size();
+        const size_t kept = static_cast<size_t>(std::min<uint64_t>(thread->written, capacity));
+        const size_t oldest = static_cast<size_t>(thread->written - kept) % capacity;
+        for (size_t i = 0; i < kept; i++) {
+            trace.push_back(thread->ring[(oldest + i) % capacity]);
+        }
+    }
+    std::sort(trace.begin(), trace.end(), [](const TraceRecord& a, const TraceRecord& b) {
+        return a.ticks < b.ticks;
+    });
+    return trace;
+}
+
+// Timestamp ticks per microsecond, measured since the tracker started
+double MemoryAccessTracker::ticksPerMicrosecond() const {
+    auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - m_startTime).count();
+    uint64_t elapsedTicks = readTicks() - m_startTicks;
+    if (elapsedUs <= 0 || elapsedTicks == 0) {
+        return 1.0;
+    }
+    return static_cast<double>(elapsedTicks) / elapsedUs;
+}
+
 // Check if address is in region
 bool MemoryAccessTracker::isAddressInRegion(void* address, const TrackedRegion& region) const {
     char* addrPtr = static_cast<char*>(address);
@@ -232,39 +359,40 @@ size_t MemoryAccessTracker::getCacheLineNumber(void* address) const {
     return reinterpret_cast<uintptr_t>(address) / m_cacheLineSize;
 }
 
-// Get region name for address
-std::string MemoryAccessTracker::getRegionName(void* address) const {
-    for (const auto& region : m_trackedRegions) {
-        if (isAddressInRegion(address, region)) {
-            return region.name;
-        }
-    }
-    return "Unknown";
+// Get cache line number for a recorded access
+size_t MemoryAccessTracker::getCacheLineNumber(const TraceRecord& record) const {
+    return (reinterpret_cast<uintptr_t>(m_trackedRegions[record.region].baseAddress) + record.offset)
+           / m_cacheLineSize;
 }
 
 // Analyze cache line usage
-std::map<size_t, CacheLineInfo> MemoryAccessTracker::analyzeCacheLineUsage() const {
+std::map<size_t, CacheLineInfo> MemoryAccessTracker::analyzeCacheLineUsage(const std::vector<TraceRecord>& trace) const {
     std::map<size_t, CacheLineInfo> cacheLines;
     
-    // Count accesses per cache line
-    for (const auto& access : m_accesses) {
-        size_t lineNumber = getCacheLineNumber(access.address);
+    // Count sampled accesses per cache line
+    for (const auto& record : trace) {
+        size_t lineNumber = getCacheLineNumber(record);
         
-        if (cacheLines.find(lineNumber) == cacheLines.end()) {
-            cacheLines[lineNumber] = {lineNumber, 0, 0, {}, false};
+        auto it = cacheLines.find(lineNumber);
+        if (it == cacheLines.end()) {
+            it = cacheLines.emplace(lineNumber, CacheLineInfo{lineNumber, 0, 0, {}, false}).first;
         }
         
-        cacheLines[lineNumber].accessCount++;
-        if (access.isWrite) {
-            cacheLines[lineNumber].writeCount++;
+        it->second.accessCount++;
+        if (record.isWrite) {
+            it->second.writeCount++;
         }
-        cacheLines[lineNumber].threads.insert(access.threadId);
+        it->second.threads.insert(record.threadId);
     }
     
-    // Detect potential false sharing
+    const size_t rate = m_samplingRate.load();
     for (auto& entry : cacheLines) {
         auto& info = entry.second;
         
+        // Scale samples up to estimated accesses
+        info.accessCount *= rate;
+        info.writeCount *= rate;
+        
         // Potential false sharing if:
         // 1. Multiple threads access the same cache line
         // 2. At least one thread is writing
@@ -277,98 +405,109 @@ std::map<size_t, CacheLineInfo> MemoryAccessTracker::analyzeCacheLineUsage() con
     return cacheLines;
 }
 
-// Generate heatmap
+// Generate heatmap; large regions fold several cache lines into each cell
 void MemoryAccessTracker::generateHeatmap(std::ostream& out, const TrackedRegion& region, 
                                          const std::map<size_t, CacheLineInfo>& cacheLines) const {
     out << "        <div class='heatmap'>\n";
     
     size_t startLine = getCacheLineNumber(region.baseAddress);
     size_t endLine = getCacheLineNumber(static_cast<char*>(region.baseAddress) + region.size - 1);
+    size_t lineCount = endLine - startLine + 1;
+    size_t linesPerCell = (lineCount + kMaxHeatmapCells - 1) / kMaxHeatmapCells;
     
-    for (size_t lineNum = startLine; lineNum <= endLine; lineNum++) {
+    for (size_t firstLine = startLine; firstLine <= endLine; firstLine += linesPerCell) {
+        size_t lastLine = std::min(firstLine + linesPerCell - 1, endLine);
         out << "            <div class='cache-line'>\n";
         
-        // Find cache line info
-        auto it = cacheLines.find(lineNum);
-        bool hasFalseSharing = (it != cacheLines.end() && it->second.hasFalseSharing);
-        size_t accessCount = (it != cacheLines.end()) ? it->second.accessCount : 0;
+        // Sum the cache lines this cell covers
+        bool hasFalseSharing = false;
+        size_t accessCount = 0;
+        for (auto it = cacheLines.lower_bound(firstLine); it != cacheLines.end() && it->first <= lastLine; ++it) {
+            hasFalseSharing = hasFalseSharing || it->second.hasFalseSharing;
+            accessCount += it->second.accessCount;
+        }
+        size_t perLine = accessCount / (lastLine - firstLine + 1);
         
-        // Calculate color based on access count
+        // Calculate color based on access count per line
         std::string color;
         if (hasFalseSharing) {
             color = "#d50000"; // Red for false sharing
         } else if (accessCount == 0) {
             color = "#e0f7fa"; // Very light blue for no access
-        } else if (accessCount < 10) {
+        } else if (perLine < 10) {
             color = "#4fc3f7"; // Light blue for low access
-        } else if (accessCount < 50) {
+        } else if (perLine < 50) {
             color = "#0277bd"; // Medium blue for medium access
         } else {
             color = "#01579b"; // Dark blue for high access
         }
         
         // Display cache line number and access count
-        out << "                <div class='cell' style='background-color: " << color << ";' "
-            << "title='Cache line " << lineNum << ": " << accessCount << " accesses";
+        out << "                <div class='cell' style='background-color: " << color << ";' title='";
+        if (lastLine == firstLine) {
+            out << "Cache line " << firstLine;
+        } else {
+            out << "Cache lines " << firstLine << "-" << lastLine;
+        }
+        out << ": " << accessCount << " accesses";
         
         if (hasFalseSharing) {
             out << " (Potential false sharing)";
         }
         
-        out << "'>" << lineNum << "</div>\n";
+        out << "'>" << (firstLine - startLine) << "</div>\n";
         out << "            </div>\n";
     }
     
     out << "        </div>\n";
 }
 
-// Generate access timeline
-void MemoryAccessTracker::generateAccessTimeline(std::ostream& out) const {
-    if (m_accesses.empty()) {
+// Generate access timeline from an even subset of the trace
+void MemoryAccessTracker::generateAccessTimeline(std::ostream& out, const std::vector<TraceRecord>& trace) const {
+    if (trace.empty()) {
         out << "        <p>No access data available for timeline.</p>\n";
         return;
     }
     
     // Find time range
-    auto startTime = m_startTime;
-    auto endTime = startTime;
-    
-    for (const auto& access : m_accesses) {
-        if (access.timestamp > endTime) {
-            endTime = access.timestamp;
-        }
-    }
+    const double ticksPerUs = ticksPerMicrosecond();
+    uint64_t startTicks = std::min(m_startTicks, trace.front().ticks);
+    uint64_t endTicks = trace.back().ticks;
     
     // Add a small buffer to the end time
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+    double duration = (endTicks - startTicks) / ticksPerUs;
     duration += duration * 0.1; // Add 10% buffer
+    if (duration <= 0.0) {
+        duration = 1.0;
+    }
     
     // Generate timeline
     out << "        <div class='timeline' id='timeline'>\n";
     
     // Generate access points
     int maxThreads = 0;
-    for (const auto& access : m_accesses) {
-        if (access.threadId > maxThreads) {
-            maxThreads = access.threadId;
+    for (const auto& record : trace) {
+        if (record.threadId > maxThreads) {
+            maxThreads = record.threadId;
         }
     }
     maxThreads++; // Convert to count
     
-    for (const auto& access : m_accesses) {
-        auto timeOffset = std::chrono::duration_cast<std::chrono::microseconds>(
-            access.timestamp - startTime).count();
+    size_t stride = (trace.size() + kMaxTimelinePoints - 1) / kMaxTimelinePoints;
+    for (size_t i = 0; i < trace.size(); i += stride) {
+        const auto& record = trace[i];
+        double timeOffset = (record.ticks - startTicks) / ticksPerUs;
         
-        double xPercent = (static_cast<double>(timeOffset) / duration) * 100.0;
-        double yPercent = (static_cast<double>(access.threadId) / maxThreads) * 100.0;
+        double xPercent = (timeOffset / duration) * 100.0;
+        double yPercent = (static_cast<double>(record.threadId) / maxThreads) * 100.0;
         
-        std::string accessClass = access.isWrite ? "write" : "read";
-        std::string regionName = getRegionName(access.address);
+        std::string accessClass = record.isWrite ? "write" : "read";
+        const std::string& regionName = m_trackedRegions[record.region].name;
         
         out << "            <div class='access " << accessClass << "' "
             << "style='left: " << xPercent << "%; top: " << yPercent << "%;' "
-            << "title='Thread " << access.threadId << " " 
-            << (access.isWrite ? "write" : "read") << " to " << regionName << "'></div>\n";
+            << "title='Thread " << static_cast<int>(record.threadId) << " " 
+            << (record.isWrite ? "write" : "read") << " to " << regionName << "'></div>\n";
     }
     
     out << "        </div>\n";
@@ -376,7 +515,11 @@ void MemoryAccessTracker::generateAccessTimeline(std::ostream& out) const {
     // Add timeline labels
     out << "        <div style='display: flex; justify-content: space-between; margin-top: 5px;'>\n"
         << "            <div>Start</div>\n"
-        << "            <div>Time (total: " << (duration / 1000.0) << " ms)</div>\n"
+        << "            <div>Time (total: " << (duration / 1000.0) << " ms";
+    if (stride > 1) {
+        out << ", every " << stride << "th recorded access shown";
+    }
+    out << ")</div>\n"
         << "            <div>End</div>\n"
         << "        </div>\n";
     
@@ -391,19 +534,29 @@ void MemoryAccessTracker::generateAccessTimeline(std::ostream& out) const {
 }
 
 // Generate summary
-void MemoryAccessTracker::generateSummary(std::ostream& out, const std::map<size_t, CacheLineInfo>& cacheLines) const {
-    // Count total accesses and writes
-    size_t totalAccesses = m_accesses.size();
-    size_t totalWrites = 0;
+void MemoryAccessTracker::generateSummary(std::ostream& out, const std::vector<TraceRecord>& trace,
+                                          const std::map<size_t, CacheLineInfo>& cacheLines) const {
+    // Count recorded accesses and writes
+    size_t recorded = trace.size();
+    size_t recordedWrites = 0;
     std::set<int> uniqueThreads;
     
-    for (const auto& access : m_accesses) {
-        if (access.isWrite) {
-            totalWrites++;
+    for (const auto& record : trace) {
+        if (record.isWrite) {
+            recordedWrites++;
         }
-        uniqueThreads.insert(access.threadId);
+        uniqueThreads.insert(record.threadId);
+    }
+    
+    uint64_t overwritten = 0;
+    for (const auto& thread : m_traces) {
+        overwritten += thread->written - std::min<uint64_t>(thread->written, thread->ring.size());
     }
     
+    const size_t rate = m_samplingRate.load();
+    size_t totalAccesses = recorded * rate;
+    size_t totalWrites = recordedWrites * rate;
+    
     // Count cache lines with potential false sharing
     size_t falseSharingLines = 0;
     for (const auto& entry : cacheLines) {
@@ -416,9 +569,12 @@ void MemoryAccessTracker::generateSummary(std::ostream& out, const std::map<size
     out << "        <table>\n"
         << "            <tr><th>Metric</th><th>Value</th></tr>\n"
         << "            <tr><td>Total memory regions tracked</td><td>" << m_trackedRegions.size() << "</td></tr>\n"
-        << "            <tr><td>Total memory accesses</td><td>" << totalAccesses << "</td></tr>\n"
-        << "            <tr><td>Read accesses</td><td>" << (totalAccesses - totalWrites) << "</td></tr>\n"
-        << "            <tr><td>Write accesses</td><td>" << totalWrites << "</td></tr>\n"
+        << "            <tr><td>Sampling rate</td><td>1 in " << rate << "</td></tr>\n"
+        << "            <tr><td>Accesses recorded</td><td>" << recorded << "</td></tr>\n"
+        << "            <tr><td>Records overwritten (ring full)</td><td>" << overwritten << "</td></tr>\n"
+        << "            <tr><td>Total memory accesses (estimated)</td><td>" << totalAccesses << "</td></tr>\n"
+        << "            <tr><td>Read accesses (estimated)</td><td>" << (totalAccesses - totalWrites) << "</td></tr>\n"
+        << "            <tr><td>Write accesses (estimated)</td><td>" << totalWrites << "</td></tr>\n"
         << "            <tr><td>Unique threads</td><td>" << uniqueThreads.size() << "</td></tr>\n"
         << "            <tr><td>Cache line size</td><td>" << m_cacheLineSize << " bytes</td></tr>\n"
         << "            <tr><td>Cache lines accessed</td><td>" << cacheLines.size() << "</td></tr>\n";
@@ -445,9 +601,15 @@ void MemoryAccessTracker::generateSummary(std::ostream& out, const std::map<size
     out << "    </div>\n";
 }
 
-// Simple demonstration of memory access visualization
+// Demonstration of memory access visualization on a large array, sampled
 int main(int argc, char* argv[]) {
-    const int arraySize = 1000;
+    CliParser parser(argc, argv);
+    parser.addOption("size", 's', "Number of ints in the tracked array (default: 16M)", false);
+    parser.addOption("sample", 'r', "Record about one access in N (default: 64)", false);
+    parser.parse();
+    
+    const int arraySize = parser.getIntValue("size", 16 * 1024 * 1024);
+    const int samplingRate = parser.getIntValue("sample", 64);
     int* testArray = new int[arraySize];
     
     // Initialize array
@@ -457,10 +619,13 @@ int main(int argc, char* argv[]) {
     
     // Get the tracker instance
     auto& tracker = MemoryAccessTracker::getInstance();
+    tracker.setSamplingRate(static_cast<uint32_t>(std::max(samplingRate, 1)));
     
     // Track our test array
     tracker.trackMemoryRegion(testArray, arraySize * sizeof(int), "TestArray");
     
+    auto start = std::chrono::steady_clock::now();
+    
     // Simulate memory accesses with OpenMP
     #pragma omp parallel num_threads(4)
     {
@@ -483,7 +648,7 @@ int main(int argc, char* argv[]) {
         
         // Pattern 2: False sharing (bad)
         int index = threadId;
-        for (int i = 0; i < 100; i++) {
+        for (int i = 0; i < 100000; i++) {
             tracker.recordAccess(&testArray[index], threadId, false); // Read
             testArray[index] = testArray[index] + 1;
             tracker.recordAccess(&testArray[index], threadId, true);  // Write
@@ -493,6 +658,10 @@ int main(int argc, char* argv[]) {
         }
     }
     
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Instrumented loops over " << arraySize << " ints took " << std::fixed << std::setprecision(1)
+              << elapsed << " ms (sampling 1 in " << tracker.getSamplingRate() << ")" << std::endl;
+    
     // Generate visualization
     tracker.generateVisualization("memory_access.html");
     
@@ -505,4 +674,4 @@ int main(int argc, char* argv[]) {
     std::cout << "Memory access visualization completed. See memory_access.html for results." << std::endl;
     
     return 0;
-}
\ No newline at end of file
+}
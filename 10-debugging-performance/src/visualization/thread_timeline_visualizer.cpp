@@ -14,177 +14,706 @@
 #include <atomic>
 #include <ctime>
 #include <cstring>
-#include <Windows.h>
+#include <cstdint>
+#include <cmath>
+#include <filesystem>
 
 #include "profiler.h"
 #include "debug_utils.h"
 #include "cli_parser.h"
 
-// ThreadEvent represents a single event in the timeline
-struct ThreadEvent {
-    int threadId;
-    std::string eventType;  // "start", "end", "sync", "idle", "work"
-    std::chrono::steady_clock::time_point timestamp;
-    std::string description;
-    double duration; // in milliseconds
+// Kinds of timeline event; the order is part of the binary trace format
+enum class TimelineEventType : uint8_t {
+    Start,
+    End,
+    Sync,
+    Idle,
+    Work
 };
 
+const int NUM_EVENT_TYPES = 5;
+
+const char* eventTypeName(TimelineEventType type) {
+    static const char* names[NUM_EVENT_TYPES] = { "start", "end", "sync", "idle", "work" };
+    return names[static_cast<int>(type)];
+}
+
+TimelineEventType parseEventType(const std::string& name) {
+    for (int i = 0; i < NUM_EVENT_TYPES; i++) {
+        if (name == eventTypeName(static_cast<TimelineEventType>(i))) {
+            return static_cast<TimelineEventType>(i);
+        }
+    }
+    return TimelineEventType::Work;
+}
+
+// One timeline event as recorded and as stored in a binary trace.
+// Descriptions are interned: the record holds the id of its description and
+// an optional item number ("Task execution" #17), so millions of events need
+// only a handful of strings.
+struct TimelineRecord {
+    uint64_t startNs;          // Since the timeline started
+    uint64_t durationNs;
+    int32_t threadId;
+    uint32_t descriptionId;
+    int32_t item;              // -1 if none
+    uint8_t type;              // TimelineEventType
+    uint8_t reserved[3];
+};
+
+static_assert(sizeof(TimelineRecord) == 32, "TimelineRecord is part of the trace format");
+
+// Binary trace format (native byte order):
+//   8-byte magic "OMPTL01\0", then blocks, each starting with a 32-bit tag and a 32-bit value:
+//   'STRS' value = string id, followed by a 32-bit length and the string bytes
+//   'EVTS' value = record count, followed by that many TimelineRecords
+//   'TEND' value = 0, followed by the 64-bit total run time in ns (written by finalize)
+// A string is always written before the first record that uses it.
+const char TRACE_MAGIC[8] = { 'O', 'M', 'P', 'T', 'L', '0', '1', '\0' };
+const uint32_t TRACE_TAG_STRING = 0x53525453;  // "STRS"
+const uint32_t TRACE_TAG_EVENTS = 0x53545645;  // "EVTS"
+const uint32_t TRACE_TAG_END = 0x444E4554;     // "TEND"
+const size_t TRACE_BLOCK_RECORDS = 4096;
+const uint32_t TRACE_MAX_STRINGS = 1u << 20;   // Larger ids mean a corrupt trace
+
+// Writes a binary trace, one block of records at a time
+class TimelineTraceWriter {
+private:
+    std::ofstream file;
+    std::vector<TimelineRecord> block;
+
+    void writeBlockHeader(uint32_t tag, uint32_t value) {
+        file.write(reinterpret_cast<const char*>(&tag), sizeof(tag));
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+public:
+    bool open(const std::string& filename) {
+        file.open(filename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open trace file for writing: " << filename << std::endl;
+            return false;
+        }
+        file.write(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+        block.reserve(TRACE_BLOCK_RECORDS);
+        return true;
+    }
+
+    bool isOpen() const {
+        return file.is_open();
+    }
+
+    // Buffered records never use a new string, so it can go out ahead of them
+    void writeString(uint32_t id, const std::string& text) {
+        writeBlockHeader(TRACE_TAG_STRING, id);
+        uint32_t length = static_cast<uint32_t>(text.size());
+        file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        file.write(text.data(), length);
+    }
+
+    void write(const TimelineRecord& record) {
+        block.push_back(record);
+        if (block.size() >= TRACE_BLOCK_RECORDS) {
+            flush();
+        }
+    }
+
+    void flush() {
+        if (block.empty()) return;
+        writeBlockHeader(TRACE_TAG_EVENTS, static_cast<uint32_t>(block.size()));
+        file.write(reinterpret_cast<const char*>(block.data()), block.size() * sizeof(TimelineRecord));
+        block.clear();
+    }
+
+    void close(uint64_t totalNs) {
+        if (!file.is_open()) return;
+        flush();
+        writeBlockHeader(TRACE_TAG_END, 0);
+        file.write(reinterpret_cast<const char*>(&totalNs), sizeof(totalNs));
+        file.close();
+    }
+};
+
+// Reads a binary trace one block at a time; scan() can be repeated
+class TimelineTraceReader {
+private:
+    std::ifstream file;
+    std::string filename;
+    std::vector<std::string> strings;
+    std::vector<TimelineRecord> block;
+    uint64_t totalNs = 0;
+    uint64_t fileSize = 0;
+    bool warnedNoEnd = false;
+
+    // Bytes between the read position and the end of the file
+    uint64_t remaining() {
+        std::streamoff position = file.tellg();
+        return position < 0 ? 0 : fileSize - static_cast<uint64_t>(position);
+    }
+
+    bool truncated() {
+        std::cerr << "Truncated trace " << filename << ": the last block is incomplete" << std::endl;
+        return false;
+    }
+
+public:
+    bool open(const std::string& path) {
+        filename = path;
+        file.open(path, std::ios::binary | std::ios::ate);
+        if (file.is_open()) {
+            fileSize = static_cast<uint64_t>(file.tellg());
+            file.seekg(0);
+        }
+        char magic[sizeof(TRACE_MAGIC)] = {};
+        if (!file.is_open() || !file.read(magic, sizeof(magic)) ||
+            std::memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0) {
+            std::cerr << "Not a thread timeline trace: " << path << std::endl;
+            file.close();
+            return false;
+        }
+        return true;
+    }
+
+    // Call f(record) for every record in file order. Every block's size is
+    // checked against the bytes left in the file before it is read, so a
+    // truncated trace is an error instead of a silently partial timeline.
+    template<typename F>
+    bool scan(F f) {
+        file.clear();
+        file.seekg(sizeof(TRACE_MAGIC));
+        bool ended = false;
+        uint32_t header[2];
+        while (file.read(reinterpret_cast<char*>(header), sizeof(header))) {
+            if (header[0] == TRACE_TAG_EVENTS) {
+                if (static_cast<uint64_t>(header[1]) * sizeof(TimelineRecord) > remaining()) {
+                    return truncated();
+                }
+                block.resize(header[1]);
+                if (!file.read(reinterpret_cast<char*>(block.data()), block.size() * sizeof(TimelineRecord))) {
+                    return truncated();
+                }
+                for (const auto& record : block) {
+                    f(record);
+                }
+            } else if (header[0] == TRACE_TAG_STRING) {
+                uint32_t length = 0;
+                if (!file.read(reinterpret_cast<char*>(&length), sizeof(length)) || length > remaining()) {
+                    return truncated();
+                }
+                std::string text(length, '\0');
+                file.read(&text[0], length);
+                if (header[1] >= TRACE_MAX_STRINGS) {
+                    std::cerr << "Corrupt string id in trace " << filename << std::endl;
+                    return false;
+                }
+                if (header[1] >= strings.size()) {
+                    strings.resize(header[1] + 1);
+                }
+                strings[header[1]] = text;
+            } else if (header[0] == TRACE_TAG_END) {
+                if (!file.read(reinterpret_cast<char*>(&totalNs), sizeof(totalNs))) {
+                    return truncated();
+                }
+                ended = true;
+            } else {
+                std::cerr << "Corrupt block in trace " << filename << std::endl;
+                return false;
+            }
+        }
+        if (file.gcount() != 0) {
+            return truncated();
+        }
+        // A run that crashed leaves whole blocks but no end block; they are
+        // still usable, but the timeline may stop early
+        if (!ended && !warnedNoEnd) {
+            warnedNoEnd = true;
+            std::cerr << "Warning: trace " << filename << " has no end block; the run did not finish" << std::endl;
+        }
+        return true;
+    }
+
+    const std::string& description(uint32_t id) const {
+        static const std::string unknown;
+        return id < strings.size() ? strings[id] : unknown;
+    }
+
+    uint64_t totalDurationNs() const {
+        return totalNs;
+    }
+};
+
+// Report layout and the zoomed window shown in detail
+struct TimelineReportOptions {
+    int buckets = 1000;               // Columns of the downsampled overview
+    double zoomStartMs = 0.0;         // Detail window start
+    double zoomEndMs = -1.0;          // Detail window end, -1 for the end of the run
+    size_t maxDetailEvents = 20000;   // Events drawn individually; the rest are only counted
+    std::string traceFile;            // Shown in the regenerate hint when the input is a trace
+};
+
+namespace {
+
+// Utilization in the overview is split into these three; start/end are instants
+const int NUM_BUSY_KINDS = 3;
+
+int busyKind(uint8_t type) {
+    switch (static_cast<TimelineEventType>(type)) {
+        case TimelineEventType::Work: return 0;
+        case TimelineEventType::Sync: return 1;
+        case TimelineEventType::Idle: return 2;
+        default: return -1;
+    }
+}
+
+const char* recordTypeName(uint8_t type) {
+    return type < NUM_EVENT_TYPES ? eventTypeName(static_cast<TimelineEventType>(type)) : "work";
+}
+
+std::string escapeHtml(const std::string& text) {
+    std::string result;
+    result.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+            case '&': result += "&amp;"; break;
+            case '<': result += "&lt;"; break;
+            case '>': result += "&gt;"; break;
+            case '"': result += "&quot;"; break;
+            case '\'': result += "&#39;"; break;
+            default: result += c;
+        }
+    }
+    return result;
+}
+
+// Contents of a single-quoted JavaScript string inside a <script> element
+std::string escapeJsString(const std::string& text) {
+    std::string result;
+    for (char c : text) {
+        if (c == '\\' || c == '\'') {
+            result += '\\';
+            result += c;
+        } else if (c == '<') {
+            result += "\\x3C";
+        } else {
+            result += c;
+        }
+    }
+    return result;
+}
+
+// A 1, 2 or 5 times power-of-ten step giving about targetTicks ticks over span
+double niceStep(double span, int targetTicks) {
+    if (span <= 0.0) return 1.0;
+    double raw = span / targetTicks;
+    double magnitude = std::pow(10.0, std::floor(std::log10(raw)));
+    double fraction = raw / magnitude;
+    double nice = fraction < 1.5 ? 1.0 : fraction < 3.5 ? 2.0 : fraction < 7.5 ? 5.0 : 10.0;
+    return nice * magnitude;
+}
+
+void writeScale(std::ostream& out, double fromMs, double toMs) {
+    double span = toMs - fromMs;
+    double step = niceStep(span, 10);
+    out << "    <div class=\"timeline-scale\">\n";
+    for (double t = std::ceil(fromMs / step) * step; t <= toMs; t += step) {
+        double position = span > 0.0 ? (t - fromMs) / span * 100.0 : 0.0;
+        out << "        <div class=\"timeline-marker\" style=\"left: " << position << "%;\"></div>\n"
+            << "        <div class=\"timeline-marker-label\" style=\"left: " << position << "%\">" << t << " ms</div>\n";
+    }
+    out << "    </div>\n";
+}
+
+} // namespace
+
+/**
+ * Write the timeline report for any source of records, streaming.
+ *
+ * Source provides scan(f), calling f(const TimelineRecord&) for every record,
+ * description(id) and totalDurationNs(). The source is scanned three times:
+ * for the time span and the threads, to bin every event into per-thread
+ * utilization buckets, and to write the events of the zoomed window. Memory
+ * is threads x buckets, whatever the number of events.
+ */
+template<typename Source>
+bool writeTimelineReport(const std::string& filename, Source& source, const TimelineReportOptions& options) {
+    std::ofstream htmlFile(filename);
+    if (!htmlFile.is_open()) {
+        std::cerr << "Failed to open file for writing: " << filename << std::endl;
+        return false;
+    }
+
+    // Pass 1: span, threads and counts
+    uint64_t spanNs = source.totalDurationNs();
+    uint64_t eventCount = 0;
+    std::map<int, size_t> rows;
+    bool ok = source.scan([&](const TimelineRecord& record) {
+        spanNs = std::max(spanNs, record.startNs + record.durationNs);
+        rows.emplace(record.threadId, 0);
+        eventCount++;
+    });
+    if (!ok) return false;
+    size_t rowCount = 0;
+    for (auto& row : rows) {
+        row.second = rowCount++;
+    }
+    spanNs = std::max<uint64_t>(spanNs, 1);
+
+    uint64_t zoomStartNs = static_cast<uint64_t>(std::max(options.zoomStartMs, 0.0) * 1e6);
+    uint64_t zoomEndNs = options.zoomEndMs < 0.0 ? spanNs : static_cast<uint64_t>(options.zoomEndMs * 1e6);
+    if (zoomEndNs <= zoomStartNs || zoomStartNs >= spanNs) {
+        zoomStartNs = 0;
+        zoomEndNs = spanNs;
+    }
+    auto inZoom = [&](const TimelineRecord& record) {
+        uint64_t end = record.startNs + record.durationNs;
+        return record.startNs < zoomEndNs && (end > zoomStartNs || record.startNs >= zoomStartNs);
+    };
+
+    // Pass 2: busy time per thread, kind and bucket
+    const size_t buckets = static_cast<size_t>(std::max(options.buckets, 1));
+    const uint64_t bucketNs = (spanNs + buckets - 1) / buckets;
+    std::vector<double> busy(rowCount * NUM_BUSY_KINDS * buckets, 0.0);
+    uint64_t detailCount = 0;
+    source.scan([&](const TimelineRecord& record) {
+        if (inZoom(record)) {
+            detailCount++;
+        }
+        int kind = busyKind(record.type);
+        if (kind < 0 || record.durationNs == 0) return;
+        double* row = &busy[(rows[record.threadId] * NUM_BUSY_KINDS + kind) * buckets];
+        uint64_t end = std::min(record.startNs + record.durationNs, spanNs);
+        for (uint64_t t = record.startNs; t < end; ) {
+            size_t bucket = static_cast<size_t>(t / bucketNs);
+            uint64_t bucketEnd = std::min<uint64_t>((bucket + 1) * bucketNs, end);
+            row[bucket] += static_cast<double>(bucketEnd - t);
+            t = bucketEnd;
+        }
+    });
+
+    const double spanMs = spanNs / 1e6;
+    const double zoomStartMs = zoomStartNs / 1e6;
+    const double zoomEndMs = zoomEndNs / 1e6;
+    const double zoomSpanNs = static_cast<double>(zoomEndNs - zoomStartNs);
+    const int rowHeight = 45;
+
+    htmlFile << std::fixed << std::setprecision(3);
+    htmlFile << "<!DOCTYPE html>\n"
+             << "<html lang=\"en\">\n"
+             << "<head>\n"
+             << "    <meta charset=\"UTF-8\">\n"
+             << "    <meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0\">\n"
+             << "    <title>OpenMP Thread Timeline Visualization</title>\n"
+             << "    <style>\n"
+             << "        body { font-family: Arial, sans-serif; margin: 20px; }\n"
+             << "        .timeline-container { margin-top: 20px; position: relative; }\n"
+             << "        .thread-label { position: absolute; left: 0; width: 80px; height: 40px; line-height: 40px; }\n"
+             << "        .timeline { position: absolute; left: 100px; right: 0; top: 0; bottom: 0; }\n"
+             << "        .timeline-scale { height: 20px; border-bottom: 1px solid #ccc; position: relative; margin-bottom: 10px; margin-left: 100px; }\n"
+             << "        .timeline-marker { position: absolute; width: 1px; height: 5px; background: #888; bottom: 0; }\n"
+             << "        .timeline-marker-label { position: absolute; font-size: 10px; color: #888; }\n"
+             << "        .event { position: absolute; height: 30px; border-radius: 4px; min-width: 2px; }\n"
+             << "        .event-start { background-color: #4CAF50; }\n"
+             << "        .event-end { background-color: #F44336; }\n"
+             << "        .event-sync { background-color: #FF9800; }\n"
+             << "        .event-idle { background-color: #BDBDBD; }\n"
+             << "        .event-work { background-color: #2196F3; }\n"
+             << "        #overview { width: 100%; cursor: crosshair; }\n"
+             << "        .tooltip { display: none; position: absolute; background: #333; color: #fff; padding: 5px; border-radius: 3px; z-index: 100; font-size: 12px; }\n"
+             << "        h1 { color: #333; }\n"
+             << "        .summary { margin: 20px 0; }\n"
+             << "        .summary table { border-collapse: collapse; }\n"
+             << "        .summary td, .summary th { border: 1px solid #ccc; padding: 4px 10px; text-align: right; }\n"
+             << "        .note { color: #666; font-size: 13px; }\n"
+             << "        .legend { display: flex; margin-top: 20px; }\n"
+             << "        .legend-item { display: flex; align-items: center; margin-right: 20px; }\n"
+             << "        .legend-color { width: 20px; height: 20px; margin-right: 5px; border-radius: 3px; }\n"
+             << "    </style>\n"
+             << "</head>\n"
+             << "<body>\n"
+             << "    <h1>OpenMP Thread Timeline Visualization</h1>\n"
+             << "    <div class=\"summary\">\n"
+             << "        <p>Total execution time: " << spanMs << " ms</p>\n"
+             << "        <p>Number of threads: " << rowCount << "</p>\n"
+             << "        <p>Number of events: " << eventCount << "</p>\n"
+             << "        <table>\n"
+             << "            <tr><th>Thread</th><th>Work (ms)</th><th>Sync (ms)</th><th>Idle (ms)</th><th>Utilization</th></tr>\n";
+    for (const auto& row : rows) {
+        double totals[NUM_BUSY_KINDS] = {};
+        for (int kind = 0; kind < NUM_BUSY_KINDS; kind++) {
+            const double* series = &busy[(row.second * NUM_BUSY_KINDS + kind) * buckets];
+            for (size_t b = 0; b < buckets; b++) {
+                totals[kind] += series[b];
+            }
+        }
+        htmlFile << "            <tr><td>" << row.first << "</td><td>" << totals[0] / 1e6 << "</td><td>"
+                 << totals[1] / 1e6 << "</td><td>" << totals[2] / 1e6 << "</td><td>"
+                 << std::setprecision(1) << totals[0] / spanNs * 100.0 << "%</td></tr>\n"
+                 << std::setprecision(3);
+    }
+    htmlFile << "        </table>\n"
+             << "    </div>\n";
+
+    // Overview: per-thread utilization per bucket, drawn client-side from compact arrays
+    htmlFile << "    <h2>Overview</h2>\n"
+             << "    <p class=\"note\">Each column is " << bucketNs / 1e6 << " ms: work (blue), synchronization (orange) "
+             << "and idle (grey) time as a share of the column. Click a column, shift-click another, "
+             << "to get the command that draws that window in detail.</p>\n";
+    writeScale(htmlFile, 0.0, spanMs);
+    htmlFile << "    <canvas id=\"overview\" height=\"" << rowCount * 24 << "\"></canvas>\n"
+             << "    <p class=\"note\" id=\"zoom-hint\"></p>\n"
+             << "    <script>\n"
+             << "        const overview = { spanMs: " << spanMs << ", bucketMs: " << bucketNs / 1e6
+             << ", trace: '" << escapeJsString(options.traceFile) << "', threads: [";
+    for (const auto& row : rows) {
+        htmlFile << row.first << (row.second + 1 < rowCount ? "," : "");
+    }
+    htmlFile << "], busy: [\n";
+    for (size_t row = 0; row < rowCount; row++) {
+        htmlFile << "            [";
+        for (int kind = 0; kind < NUM_BUSY_KINDS; kind++) {
+            const double* series = &busy[(row * NUM_BUSY_KINDS + kind) * buckets];
+            htmlFile << "[";
+            for (size_t b = 0; b < buckets; b++) {
+                // Percent of the bucket, as integers to keep the page small
+                htmlFile << static_cast<int>(std::lround(series[b] / bucketNs * 100.0)) << (b + 1 < buckets ? "," : "");
+            }
+            htmlFile << "]" << (kind + 1 < NUM_BUSY_KINDS ? "," : "");
+        }
+        htmlFile << "]" << (row + 1 < rowCount ? "," : "") << "\n";
+    }
+    htmlFile << "        ] };\n"
+             << "    </script>\n";
+    busy.clear();
+    busy.shrink_to_fit();
+
+    // Detail: events of the zoomed window, streamed straight from the source
+    htmlFile << "    <h2>Detail: " << zoomStartMs << " - " << zoomEndMs << " ms</h2>\n";
+    if (detailCount > options.maxDetailEvents) {
+        htmlFile << "    <p class=\"note\">Showing the first " << options.maxDetailEvents << " of " << detailCount
+                 << " events in this window. Choose a narrower window in the overview.</p>\n";
+    }
+    writeScale(htmlFile, zoomStartMs, zoomEndMs);
+    htmlFile << "    <div class=\"timeline-container\" style=\"height: " << rowCount * rowHeight << "px;\">\n";
+    for (const auto& row : rows) {
+        htmlFile << "        <div class=\"thread-label\" style=\"top: " << row.second * rowHeight << "px;\">Thread "
+                 << row.first << "</div>\n";
+    }
+    htmlFile << "        <div class=\"timeline\" id=\"detail\">\n";
+    uint64_t written = 0;
+    source.scan([&](const TimelineRecord& record) {
+        if (written >= options.maxDetailEvents || !inZoom(record)) return;
+        written++;
+        uint64_t start = std::max(record.startNs, zoomStartNs);
+        uint64_t end = std::min(record.startNs + record.durationNs, zoomEndNs);
+        double position = (start - zoomStartNs) / zoomSpanNs * 100.0;
+        double width = end > start ? (end - start) / zoomSpanNs * 100.0 : 0.0;
+        std::string text = source.description(record.descriptionId);
+        if (record.item >= 0) {
+            text += " #" + std::to_string(record.item);
+        }
+        htmlFile << "            <div class=\"event event-" << recordTypeName(record.type) << "\" style=\"left: "
+                 << position << "%; width: " << width << "%; top: " << rows[record.threadId] * rowHeight + 5
+                 << "px;\" data-tip=\"" << escapeHtml(text) << " (" << record.durationNs / 1e6 << " ms)\"></div>\n";
+    });
+    htmlFile << "        </div>\n"
+             << "    </div>\n";
+
+    htmlFile << "    <div class=\"legend\">\n"
+             << "        <div class=\"legend-item\"><div class=\"legend-color event-start\"></div>Start</div>\n"
+             << "        <div class=\"legend-item\"><div class=\"legend-color event-end\"></div>End</div>\n"
+             << "        <div class=\"legend-item\"><div class=\"legend-color event-sync\"></div>Synchronization</div>\n"
+             << "        <div class=\"legend-item\"><div class=\"legend-color event-idle\"></div>Idle</div>\n"
+             << "        <div class=\"legend-item\"><div class=\"legend-color event-work\"></div>Work</div>\n"
+             << "    </div>\n";
+
+    htmlFile << "    <div class=\"tooltip\" id=\"tooltip\"></div>\n"
+             << "    <script>\n"
+             << "        const tooltip = document.getElementById('tooltip');\n"
+             << "        function showTooltip(event, text) {\n"
+             << "            tooltip.textContent = text;\n"
+             << "            tooltip.style.display = 'block';\n"
+             << "            tooltip.style.left = (event.pageX + 10) + 'px';\n"
+             << "            tooltip.style.top = (event.pageY + 10) + 'px';\n"
+             << "        }\n"
+             << "        function hideTooltip() {\n"
+             << "            tooltip.style.display = 'none';\n"
+             << "        }\n"
+             << "        const detail = document.getElementById('detail');\n"
+             << "        detail.addEventListener('mouseover', e => { if (e.target.dataset.tip) showTooltip(e, e.target.dataset.tip); });\n"
+             << "        detail.addEventListener('mouseout', hideTooltip);\n"
+             << "\n"
+             << "        const canvas = document.getElementById('overview');\n"
+             << "        const rowHeight = 24, labelWidth = 100;\n"
+             << "        const colors = ['#2196F3', '#FF9800', '#BDBDBD'];\n"
+             << "        function drawOverview() {\n"
+             << "            canvas.width = canvas.clientWidth;\n"
+             << "            const ctx = canvas.getContext('2d');\n"
+             << "            const columns = overview.busy.length ? overview.busy[0][0].length : 0;\n"
+             << "            const columnWidth = (canvas.width - labelWidth) / columns;\n"
+             << "            ctx.font = '12px Arial';\n"
+             << "            overview.busy.forEach((row, r) => {\n"
+             << "                const bottom = (r + 1) * rowHeight - 2;\n"
+             << "                ctx.fillStyle = '#333';\n"
+             << "                ctx.fillText('Thread ' + overview.threads[r], 0, bottom - 6);\n"
+             << "                for (let b = 0; b < columns; b++) {\n"
+             << "                    let y = bottom;\n"
+             << "                    for (let k = 0; k < 3; k++) {\n"
+             << "                        const h = row[k][b] / 100 * (rowHeight - 4);\n"
+             << "                        ctx.fillStyle = colors[k];\n"
+             << "                        ctx.fillRect(labelWidth + b * columnWidth, y - h, Math.max(columnWidth, 1), h);\n"
+             << "                        y -= h;\n"
+             << "                    }\n"
+             << "                }\n"
+             << "            });\n"
+             << "        }\n"
+             << "        function bucketAt(e) {\n"
+             << "            const rect = canvas.getBoundingClientRect();\n"
+             << "            const columns = overview.busy.length ? overview.busy[0][0].length : 0;\n"
+             << "            const b = Math.floor((e.clientX - rect.left - labelWidth) / (rect.width - labelWidth) * columns);\n"
+             << "            const r = Math.floor((e.clientY - rect.top) / rowHeight);\n"
+             << "            return (b >= 0 && b < columns && r >= 0 && r < overview.busy.length) ? { b, r } : null;\n"
+             << "        }\n"
+             << "        canvas.addEventListener('mousemove', e => {\n"
+             << "            const at = bucketAt(e);\n"
+             << "            if (!at) { hideTooltip(); return; }\n"
+             << "            const row = overview.busy[at.r];\n"
+             << "            const from = at.b * overview.bucketMs;\n"
+             << "            showTooltip(e, 'Thread ' + overview.threads[at.r] + ', ' + from.toFixed(3) + ' - ' +\n"
+             << "                (from + overview.bucketMs).toFixed(3) + ' ms: work ' + row[0][at.b] + '%, sync ' +\n"
+             << "                row[1][at.b] + '%, idle ' + row[2][at.b] + '%');\n"
+             << "        });\n"
+             << "        canvas.addEventListener('mouseout', hideTooltip);\n"
+             << "        let anchor = null;\n"
+             << "        canvas.addEventListener('click', e => {\n"
+             << "            const at = bucketAt(e);\n"
+             << "            if (!at) return;\n"
+             << "            if (!e.shiftKey || anchor === null) anchor = at.b;\n"
+             << "            const from = Math.min(anchor, at.b) * overview.bucketMs;\n"
+             << "            const to = (Math.max(anchor, at.b) + 1) * overview.bucketMs;\n"
+             << "            document.getElementById('zoom-hint').textContent = 'Detail for ' + from.toFixed(3) + ' - ' +\n"
+             << "                to.toFixed(3) + ' ms: thread_timeline_visualizer ' +\n"
+             << "                (overview.trace ? '--input=' + overview.trace + ' ' : '') +\n"
+             << "                '--zoom-start=' + from.toFixed(3) + ' --zoom-end=' + to.toFixed(3);\n"
+             << "        });\n"
+             << "        window.addEventListener('resize', drawOverview);\n"
+             << "        drawOverview();\n"
+             << "    </script>\n";
+
+    htmlFile << "</body>\n</html>\n";
+
+    htmlFile.close();
+    std::cout << "HTML timeline visualization generated: " << filename << " (" << eventCount << " events, "
+              << written << " drawn in detail)" << std::endl;
+    return true;
+}
+
 // Timeline class to track and visualize thread execution
 class ThreadTimeline {
 private:
-    std::vector<ThreadEvent> events;
+    std::vector<TimelineRecord> records;    // Empty while streaming to a trace file
+    std::vector<std::string> descriptions;
+    std::map<std::string, uint32_t> descriptionIds;
     std::chrono::steady_clock::time_point startTime;
     std::chrono::steady_clock::time_point endTime;
-    std::map<int, std::vector<ThreadEvent>> threadEvents;
+    TimelineTraceWriter trace;
+    std::string traceFile;
     std::mutex eventsMutex;
 
+    uint64_t nanosecondsSinceStart(std::chrono::steady_clock::time_point time) const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time - startTime).count());
+    }
+
 public:
     ThreadTimeline() {
         startTime = std::chrono::steady_clock::now();
+        endTime = startTime;
     }
 
-    void recordEvent(int threadId, const std::string& eventType, 
-                    const std::string& description, double duration = 0.0) {
-        ThreadEvent event;
-        event.threadId = threadId;
-        event.eventType = eventType;
-        event.timestamp = std::chrono::steady_clock::now();
-        event.description = description;
-        event.duration = duration;
-        
+    // Stream events to a binary trace instead of keeping them in memory.
+    // Call before recording; the report is then read back from the file.
+    bool setTraceFile(const std::string& filename) {
+        std::lock_guard<std::mutex> lock(eventsMutex);
+        if (!trace.open(filename)) {
+            return false;
+        }
+        traceFile = filename;
+        for (uint32_t id = 0; id < descriptions.size(); id++) {
+            trace.writeString(id, descriptions[id]);
+        }
+        for (const auto& record : records) {
+            trace.write(record);
+        }
+        records.clear();
+        records.shrink_to_fit();
+        return true;
+    }
+
+    // duration is in milliseconds and ends now; item numbers repeated events that
+    // share a description (e.g. loop iterations) without a new string for each
+    void recordEvent(int threadId, const std::string& eventType,
+                    const std::string& description, double duration = 0.0, int item = -1) {
+        uint64_t endNs = nanosecondsSinceStart(std::chrono::steady_clock::now());
+        uint64_t durationNs = static_cast<uint64_t>(std::max(duration, 0.0) * 1e6);
+
+        TimelineRecord record = {};
+        record.startNs = endNs > durationNs ? endNs - durationNs : 0;
+        record.durationNs = durationNs;
+        record.threadId = threadId;
+        record.item = item;
+        record.type = static_cast<uint8_t>(parseEventType(eventType));
+
         std::lock_guard<std::mutex> lock(eventsMutex);
-        events.push_back(event);
-        threadEvents[threadId].push_back(event);
+        auto found = descriptionIds.find(description);
+        if (found == descriptionIds.end()) {
+            uint32_t id = static_cast<uint32_t>(descriptions.size());
+            found = descriptionIds.emplace(description, id).first;
+            descriptions.push_back(description);
+            if (trace.isOpen()) {
+                trace.writeString(id, description);
+            }
+        }
+        record.descriptionId = found->second;
+
+        if (trace.isOpen()) {
+            trace.write(record);
+        } else {
+            records.push_back(record);
+        }
     }
 
     void finalize() {
+        std::lock_guard<std::mutex> lock(eventsMutex);
         endTime = std::chrono::steady_clock::now();
+        trace.close(nanosecondsSinceStart(endTime));
     }
 
-    void generateHTMLReport(const std::string& filename) {
-        std::ofstream htmlFile(filename);
-        if (!htmlFile.is_open()) {
-            std::cerr << "Failed to open file for writing: " << filename << std::endl;
-            return;
+    // Record source interface used by writeTimelineReport
+    template<typename F>
+    bool scan(F f) {
+        for (const auto& record : records) {
+            f(record);
         }
+        return true;
+    }
 
-        // Get total execution time in milliseconds
-        auto totalDuration = std::chrono::duration_cast<std::chrono::milliseconds>(
-            endTime - startTime).count();
-
-        // HTML header and styling
-        htmlFile << "<!DOCTYPE html>\n"
-                 << "<html lang=\"en\">\n"
-                 << "<head>\n"
-                 << "    <meta charset=\"UTF-8\">\n"
-                 << "    <meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0\">\n"
-                 << "    <title>OpenMP Thread Timeline Visualization</title>\n"
-                 << "    <style>\n"
-                 << "        body { font-family: Arial, sans-serif; margin: 20px; }\n"
-                 << "        .timeline-container { margin-top: 20px; }\n"
-                 << "        .thread-row { height: 40px; margin-bottom: 5px; position: relative; }\n"
-                 << "        .thread-label { position: absolute; left: 0; width: 80px; height: 40px; }\n"
-                 << "        .timeline { position: absolute; left: 100px; right: 0; height: 40px; }\n"
-                 << "        .timeline-scale { height: 20px; border-bottom: 1px solid #ccc; position: relative; margin-bottom: 10px; margin-left: 100px; }\n"
-                 << "        .timeline-marker { position: absolute; width: 1px; height: 5px; background: #888; bottom: 0; }\n"
-                 << "        .timeline-marker-label { position: absolute; font-size: 10px; color: #888; }\n"
-                 << "        .event { position: absolute; height: 30px; border-radius: 4px; top: 5px; }\n"
-                 << "        .event-start { background-color: #4CAF50; }\n"
-                 << "        .event-end { background-color: #F44336; }\n"
-                 << "        .event-sync { background-color: #FF9800; }\n"
-                 << "        .event-idle { background-color: #BDBDBD; }\n"
-                 << "        .event-work { background-color: #2196F3; }\n"
-                 << "        .tooltip { display: none; position: absolute; background: #333; color: #fff; padding: 5px; border-radius: 3px; z-index: 100; font-size: 12px; }\n"
-                 << "        h1 { color: #333; }\n"
-                 << "        .summary { margin: 20px 0; }\n"
-                 << "        .legend { display: flex; margin-top: 20px; }\n"
-                 << "        .legend-item { display: flex; align-items: center; margin-right: 20px; }\n"
-                 << "        .legend-color { width: 20px; height: 20px; margin-right: 5px; border-radius: 3px; }\n"
-                 << "    </style>\n"
-                 << "</head>\n"
-                 << "<body>\n"
-                 << "    <h1>OpenMP Thread Timeline Visualization</h1>\n"
-                 << "    <div class=\"summary\">\n"
-                 << "        <p>Total execution time: " << totalDuration << " ms</p>\n"
-                 << "        <p>Number of threads: " << threadEvents.size() << "</p>\n"
-                 << "    </div>\n";
-
-        // Create scale
-        htmlFile << "    <div class=\"timeline-scale\">\n";
-        
-        // Add scale markers every 100ms
-        for (int i = 0; i <= totalDuration; i += 100) {
-            double position = (i / (double)totalDuration) * 100;
-            htmlFile << "        <div class=\"timeline-marker\" style=\"left: " << position << "%;\"></div>\n";
-            htmlFile << "        <div class=\"timeline-marker-label\" style=\"left: " << position << "%\">" << i << " ms</div>\n";
-        }
-        
-        htmlFile << "    </div>\n";
+    const std::string& description(uint32_t id) const {
+        return descriptions[id];
+    }
 
-        // Create timeline container
-        htmlFile << "    <div class=\"timeline-container\">\n";
+    uint64_t totalDurationNs() const {
+        return nanosecondsSinceStart(endTime);
+    }
 
-        // Generate a row for each thread
-        for (const auto& thread : threadEvents) {
-            int threadId = thread.first;
-            
-            htmlFile << "        <div class=\"thread-row\">\n";
-            htmlFile << "            <div class=\"thread-label\">Thread " << threadId << "</div>\n";
-            htmlFile << "            <div class=\"timeline\">\n";
-
-            // Plot events for this thread
-            for (const auto& event : thread.second) {
-                auto eventTime = std::chrono::duration_cast<std::chrono::milliseconds>(
-                    event.timestamp - startTime).count();
-                
-                double position = (eventTime / (double)totalDuration) * 100;
-                double width = (event.duration / (double)totalDuration) * 100;
-                
-                // Minimum width for visibility
-                if (width < 0.5) width = 0.5;
-                
-                htmlFile << "                <div class=\"event event-" << event.eventType 
-                         << "\" style=\"left: " << position << "%; width: " << width << "%;\" "
-                         << "onmouseover=\"showTooltip(event, '" << event.description << " (" << event.duration << " ms)')\" "
-                         << "onmouseout=\"hideTooltip()\"></div>\n";
-            }
-            
-            htmlFile << "            </div>\n";
-            htmlFile << "        </div>\n";
+    void generateHTMLReport(const std::string& filename, TimelineReportOptions options = TimelineReportOptions()) {
+        if (traceFile.empty()) {
+            writeTimelineReport(filename, *this, options);
+            return;
+        }
+        TimelineTraceReader reader;
+        if (reader.open(traceFile)) {
+            options.traceFile = traceFile;
+            writeTimelineReport(filename, reader, options);
         }
-
-        // Close timeline container
-        htmlFile << "    </div>\n";
-
-        // Add legend
-        htmlFile << "    <div class=\"legend\">\n";
-        htmlFile << "        <div class=\"legend-item\"><div class=\"legend-color event-start\"></div>Start</div>\n";
-        htmlFile << "        <div class=\"legend-item\"><div class=\"legend-color event-end\"></div>End</div>\n";
-        htmlFile << "        <div class=\"legend-item\"><div class=\"legend-color event-sync\"></div>Synchronization</div>\n";
-        htmlFile << "        <div class=\"legend-item\"><div class=\"legend-color event-idle\"></div>Idle</div>\n";
-        htmlFile << "        <div class=\"legend-item\"><div class=\"legend-color event-work\"></div>Work</div>\n";
-        htmlFile << "    </div>\n";
-
-        // Add tooltip and JavaScript
-        htmlFile << "    <div class=\"tooltip\" id=\"tooltip\"></div>\n"
-                 << "    <script>\n"
-                 << "        function showTooltip(event, text) {\n"
-                 << "            const tooltip = document.getElementById('tooltip');\n"
-                 << "            tooltip.innerHTML = text;\n"
-                 << "            tooltip.style.display = 'block';\n"
-                 << "            tooltip.style.left = (event.pageX + 10) + 'px';\n"
-                 << "            tooltip.style.top = (event.pageY + 10) + 'px';\n"
-                 << "        }\n"
-                 << "        function hideTooltip() {\n"
-                 << "            document.getElementById('tooltip').style.display = 'none';\n"
-                 << "        }\n"
-                 << "    </script>\n";
-
-        // Close HTML
-        htmlFile << "</body>\n</html>\n";
-
-        htmlFile.close();
-        std::cout << "HTML timeline visualization generated: " << filename << std::endl;
     }
 };
 
@@ -220,13 +749,15 @@ void simulateWorkload() {
         std::this_thread::sleep_for(std::chrono::milliseconds(threadWork / 4));
         auto workEnd = std::chrono::steady_clock::now();
         
-        double workDuration = std::chrono::duration_cast<std::chrono::milliseconds>(
-            workEnd - workStart).count();
+        double workDuration = std::chrono::duration<double, std::milli>(workEnd - workStart).count();
         timeline.recordEvent(threadId, "work", "Initial work", workDuration);
         
         // Simulate a synchronization point
+        auto barrierStart = std::chrono::steady_clock::now();
         #pragma omp barrier
-        timeline.recordEvent(threadId, "sync", "Barrier synchronization", 0);
+        double barrierDuration = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - barrierStart).count();
+        timeline.recordEvent(threadId, "sync", "Barrier synchronization", barrierDuration);
         
         // Simulate threads waiting for slower ones (imbalance)
         if (threadId % 2 == 0) {
@@ -234,8 +765,7 @@ void simulateWorkload() {
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
             auto idleEnd = std::chrono::steady_clock::now();
             
-            double idleDuration = std::chrono::duration_cast<std::chrono::milliseconds>(
-                idleEnd - idleStart).count();
+            double idleDuration = std::chrono::duration<double, std::milli>(idleEnd - idleStart).count();
             timeline.recordEvent(threadId, "idle", "Waiting for work", idleDuration);
         }
         
@@ -246,12 +776,8 @@ void simulateWorkload() {
             std::this_thread::sleep_for(std::chrono::milliseconds(10 + (i % 30)));
             auto taskEnd = std::chrono::steady_clock::now();
             
-            double taskDuration = std::chrono::duration_cast<std::chrono::milliseconds>(
-                taskEnd - taskStart).count();
-            
-            std::stringstream desc;
-            desc << "Task " << i << " execution";
-            timeline.recordEvent(threadId, "work", desc.str(), taskDuration);
+            double taskDuration = std::chrono::duration<double, std::milli>(taskEnd - taskStart).count();
+            timeline.recordEvent(threadId, "work", "Task execution", taskDuration, i);
         }
         
         // Record thread end
@@ -262,10 +788,52 @@ void simulateWorkload() {
     timeline.recordEvent(0, "end", "Parallel region completed", 0);
 }
 
+// Record a large synthetic run (short tasks separated by barriers) without
+// sleeping, to exercise reports of production-size traces
+void simulateLargeTrace(int numEvents) {
+    const int numThreads = omp_get_max_threads();
+    const int tasksPerPhase = 64;
+
+    #pragma omp parallel
+    {
+        int threadId = omp_get_thread_num();
+        std::mt19937 rng(1234u + threadId);
+        std::uniform_int_distribution<int> work(20, 200);
+        int eventsPerThread = numEvents / numThreads;
+
+        for (int i = 0; i < eventsPerThread; i++) {
+            if (i % tasksPerPhase == tasksPerPhase - 1) {
+                auto barrierStart = std::chrono::steady_clock::now();
+                #pragma omp barrier
+                double barrierDuration = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - barrierStart).count();
+                timeline.recordEvent(threadId, "sync", "Phase barrier", barrierDuration, i / tasksPerPhase);
+                continue;
+            }
+            auto taskStart = std::chrono::steady_clock::now();
+            volatile double sink = 0.0;
+            int iterations = work(rng) * (threadId + 1);
+            for (int k = 0; k < iterations; k++) {
+                sink = sink + k * 0.5;
+            }
+            double taskDuration = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - taskStart).count();
+            timeline.recordEvent(threadId, "work", "Task execution", taskDuration, i);
+        }
+    }
+}
+
 int main(int argc, char* argv[]) {
     CliParser parser(argc, argv);
     parser.addOption("threads", 't', "Number of threads to use (default: system cores)", true);
     parser.addOption("output", 'o', "Output HTML file name (default: timeline.html)", true);
+    parser.addOption("trace", 'r', "Stream events to this binary trace file instead of memory", true);
+    parser.addOption("input", 'i', "Build the report from a binary trace instead of running the demo", true);
+    parser.addOption("synthetic", 's', "Record this many short synthetic events instead of the demo workload", true);
+    parser.addOption("buckets", 'b', "Columns of the downsampled overview (default: 1000)", true);
+    parser.addOption("zoom-start", 'z', "Start of the detail window in ms (default: 0)", true);
+    parser.addOption("zoom-end", 'e', "End of the detail window in ms (default: end of run)", true);
+    parser.addOption("max-detail", 'm', "Most events drawn individually in the detail view (default: 20000)", true);
     parser.parse();
 
     // Set the number of threads
@@ -273,28 +841,65 @@ int main(int argc, char* argv[]) {
     omp_set_num_threads(numThreads);
     
     std::string outputFile = parser.getStringValue("output", "timeline.html");
+    std::string traceFile = parser.getStringValue("trace", "");
+    std::string inputFile = parser.getStringValue("input", "");
+    int syntheticEvents = parser.getIntValue("synthetic", 0);
+
+    TimelineReportOptions options;
+    options.buckets = parser.getIntValue("buckets", 1000);
+    options.zoomStartMs = parser.getDoubleOption("zoom-start", 0.0);
+    options.zoomEndMs = parser.getDoubleOption("zoom-end", -1.0);
+    options.maxDetailEvents = static_cast<size_t>(std::max(parser.getIntValue("max-detail", 20000), 0));
     
     std::cout << "OpenMP Thread Timeline Visualizer" << std::endl;
     std::cout << "=================================" << std::endl;
-    std::cout << "Running with " << numThreads << " threads" << std::endl;
+    if (inputFile.empty()) {
+        std::cout << "Running with " << numThreads << " threads" << std::endl;
+    } else {
+        std::cout << "Reading trace: " << inputFile << std::endl;
+    }
     std::cout << "Output will be saved to: " << outputFile << std::endl;
     std::cout << std::endl;
     
-    // Run the simulation
-    simulateWorkload();
-    
-    // Finalize and generate the HTML report
-    timeline.finalize();
-    
     std::string htmlPath = "../reports/" + outputFile;
     
     // Ensure reports directory exists
     std::string reportsDir = "../reports";
-    CreateDirectoryA(reportsDir.c_str(), NULL);
-    
-    timeline.generateHTMLReport(htmlPath);
+    std::error_code dirError;
+    std::filesystem::create_directories(reportsDir, dirError);
+
+    auto reportStart = std::chrono::steady_clock::now();
+    if (!inputFile.empty()) {
+        TimelineTraceReader reader;
+        if (!reader.open(inputFile)) {
+            return 1;
+        }
+        options.traceFile = inputFile;
+        reportStart = std::chrono::steady_clock::now();
+        if (!writeTimelineReport(htmlPath, reader, options)) {
+            return 1;
+        }
+    } else {
+        if (!traceFile.empty() && !timeline.setTraceFile(traceFile)) {
+            return 1;
+        }
+
+        // Run the simulation
+        if (syntheticEvents > 0) {
+            simulateLargeTrace(syntheticEvents);
+        } else {
+            simulateWorkload();
+        }
+
+        // Finalize and generate the HTML report
+        timeline.finalize();
+        reportStart = std::chrono::steady_clock::now();
+        timeline.generateHTMLReport(htmlPath, options);
+    }
+    double reportSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - reportStart).count();
+    std::cout << "Report written in " << std::fixed << std::setprecision(2) << reportSeconds << " s" << std::endl;
     
     std::cout << "\nVisualization complete! Open " << htmlPath << " in a web browser to view the results." << std::endl;
     
     return 0;
-} 
\ No newline at end of file
+} 
@@ -0,0 +1,702 @@
+#include "../include/access_trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+#include <omp.h>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Binary trace format (native byte order):
+//   8-byte magic "OMPACC1\0", 32-bit max threads, 32 zero bits, then blocks, each
+//   starting with a 32-bit tag and a 32-bit value:
+//   'ABLK' value = thread, followed by a 64-bit record count and that many AccessTraceRecords
+//   'ALOC' value = label count, followed by a 32-bit length and the bytes of each label
+//   'AREG' value = region count, followed by the 64-bit start, element size, element
+//          count and sequence number, a 32-bit name length and the name of each region
+//   'AEND' value = 0
+// Every block header is 16 bytes before the tables, so mapped records stay aligned.
+const char ACCESS_TRACE_MAGIC[8] = { 'O', 'M', 'P', 'A', 'C', 'C', '1', '\0' };
+const uint32_t ACCESS_TAG_BLOCK = 0x4B4C4241;      // "ABLK"
+const uint32_t ACCESS_TAG_LOCATIONS = 0x434F4C41;  // "ALOC"
+const uint32_t ACCESS_TAG_REGIONS = 0x47455241;    // "AREG"
+const uint32_t ACCESS_TAG_END = 0x444E4541;        // "AEND"
+
+// Units of work dealt round-robin to the analysis workers
+const unsigned WORD_RANGE_SHIFT = 9;        // 512 words = 4 KB
+const unsigned ELEMENT_RANGE_SHIFT = 9;     // 512 elements
+const unsigned LINE_RANGE_SHIFT = 6;        // 64 cache lines
+const size_t LINE_SIZE = 64;                // Same line size as CustomRaceDetector::detectFalseSharing
+const size_t MAX_RACES_PER_WORKER = 1024;
+
+using Clock = uint32_t;
+using Epoch = uint64_t;                     // clock << 8 | thread; 0 is "none"
+const Epoch SHARED_READS = ~0ULL;
+
+Epoch makeEpoch(int thread, Clock clock) { return (static_cast<Epoch>(clock) << 8) | static_cast<Epoch>(thread); }
+int epochThread(Epoch e) { return static_cast<int>(e & 0xFF); }
+Clock epochClock(Epoch e) { return static_cast<Clock>(e >> 8); }
+bool happensBefore(Epoch e, const std::vector<Clock>& clock) { return epochClock(e) <= clock[epochThread(e)]; }
+
+void join(std::vector<Clock>& into, const std::vector<Clock>& from) {
+    for (size_t i = 0; i < into.size(); i++) {
+        into[i] = std::max(into[i], from[i]);
+    }
+}
+
+// Same shadow state as HappensBeforeDetector, owned by one worker so unlocked
+struct ShadowWord {
+    Epoch write = 0;
+    Epoch read = 0;
+    std::unique_ptr<Clock[]> readers;
+    uint32_t writeLocation = 0;
+    uint32_t readLocation = 0;
+    bool reported = false;
+};
+
+struct WorkerResult {
+    std::vector<HBRace> races;
+    uint64_t raceCount = 0;
+    uint64_t shadowWords = 0;
+};
+
+void reportRace(WorkerResult& result, ShadowWord& shadow, uint64_t word, HBRaceKind kind,
+                int firstThread, uint32_t firstLocation, int secondThread, uint32_t secondLocation) {
+    if (shadow.reported) {
+        return;
+    }
+    shadow.reported = true;
+    result.raceCount++;
+    if (result.races.size() < MAX_RACES_PER_WORKER) {
+        result.races.push_back({static_cast<uintptr_t>(word * 8), kind, firstThread, secondThread,
+                                firstLocation, secondLocation});
+    }
+}
+
+// FastTrack read and write checks, as in HappensBeforeDetector::read/write
+void checkRead(WorkerResult& result, ShadowWord& shadow, uint64_t word, int thread,
+               const std::vector<Clock>& clock, uint32_t location, int threads) {
+    const Epoch now = makeEpoch(thread, clock[thread]);
+    if (shadow.read == now) {
+        return;
+    }
+    if (shadow.write != 0 && !happensBefore(shadow.write, clock)) {
+        reportRace(result, shadow, word, HBRaceKind::WriteRead,
+                   epochThread(shadow.write), shadow.writeLocation, thread, location);
+    }
+    if (shadow.read == SHARED_READS) {
+        shadow.readers[thread] = clock[thread];
+    } else if (shadow.read == 0 || epochThread(shadow.read) == thread || happensBefore(shadow.read, clock)) {
+        shadow.read = now;
+    } else {
+        shadow.readers.reset(new Clock[threads]());
+        shadow.readers[epochThread(shadow.read)] = epochClock(shadow.read);
+        shadow.readers[thread] = clock[thread];
+        shadow.read = SHARED_READS;
+    }
+    shadow.readLocation = location;
+}
+
+void checkWrite(WorkerResult& result, ShadowWord& shadow, uint64_t word, int thread,
+                const std::vector<Clock>& clock, uint32_t location, int threads) {
+    const Epoch now = makeEpoch(thread, clock[thread]);
+    if (shadow.write == now) {
+        return;
+    }
+    if (shadow.write != 0 && !happensBefore(shadow.write, clock)) {
+        reportRace(result, shadow, word, HBRaceKind::WriteWrite,
+                   epochThread(shadow.write), shadow.writeLocation, thread, location);
+    }
+    if (shadow.read == SHARED_READS) {
+        for (int u = 0; u < threads; u++) {
+            if (u != thread && shadow.readers[u] > clock[u]) {
+                reportRace(result, shadow, word, HBRaceKind::ReadWrite, u, shadow.readLocation, thread, location);
+                break;
+            }
+        }
+        shadow.readers.reset();
+        shadow.read = 0;
+    } else if (shadow.read != 0 && !happensBefore(shadow.read, clock)) {
+        reportRace(result, shadow, word, HBRaceKind::ReadWrite,
+                   epochThread(shadow.read), shadow.readLocation, thread, location);
+    }
+    shadow.write = now;
+    shadow.writeLocation = location;
+}
+
+// Records of one thread from one segment, contiguous in the mapped file
+struct Piece {
+    int thread;
+    uint32_t segment;
+    const AccessTraceRecord* begin;
+    const AccessTraceRecord* end;
+};
+
+struct SyncEvent {
+    uint32_t sequence;
+    int thread;
+    AccessTraceKind kind;
+    uint64_t argument;
+};
+
+template<typename T>
+bool readValue(const char* base, size_t size, size_t& offset, T& value) {
+    if (offset + sizeof(T) > size) {
+        return false;
+    }
+    std::memcpy(&value, base + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+bool readString(const char* base, size_t size, size_t& offset, std::string& text) {
+    uint32_t length = 0;
+    if (!readValue(base, size, offset, length) || offset + length > size) {
+        return false;
+    }
+    text.assign(base + offset, length);
+    offset += length;
+    return true;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// AccessTraceWriter
+
+AccessTraceWriter::~AccessTraceWriter() {
+    if (isOpen()) {
+        close({});
+    }
+}
+
+bool AccessTraceWriter::open(const std::string& path, int maxThreads) {
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open()) {
+        std::cerr << "Failed to open access trace for writing: " << path << std::endl;
+        return false;
+    }
+    m_maxThreads = std::min(std::max(maxThreads, 1), 256);
+    m_threads = std::vector<ThreadBuffer>(m_maxThreads);
+    for (auto& buffer : m_threads) {
+        buffer.records.reserve(kBufferRecords);
+    }
+    m_sequence = 0;
+    m_regions.clear();
+
+    const uint32_t header[2] = { static_cast<uint32_t>(m_maxThreads), 0 };
+    m_file.write(ACCESS_TRACE_MAGIC, sizeof(ACCESS_TRACE_MAGIC));
+    m_file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    return true;
+}
+
+void AccessTraceWriter::appendSync(int thread, AccessTraceKind kind, uint64_t argument) {
+    // The sequence number is taken where the event takes effect: a release
+    // before the lock is given up, an acquire after it is taken
+    append(thread, kind, argument, m_sequence.fetch_add(1));
+}
+
+void AccessTraceWriter::nextSegment(int thread) {
+    uint32_t& segment = m_threads[thread].segment;
+    if (segment < AccessTraceRecord::kSegmentMask) {
+        segment++;
+    }
+}
+
+// The segment changes below mirror the clock changes of HappensBeforeDetector;
+// AccessTraceReader::analyze replays them from the sync records
+
+void AccessTraceWriter::parallelBegin(int numThreads) {
+    appendSync(0, AccessTraceKind::Fork, static_cast<uint64_t>(numThreads));
+    for (int t = 1; t < std::min(numThreads, m_maxThreads); t++) {
+        nextSegment(t);
+        m_threads[t].barriers = 0;
+    }
+    nextSegment(0);
+    m_threads[0].barriers = 0;
+}
+
+void AccessTraceWriter::parallelEnd() {
+    appendSync(0, AccessTraceKind::Join, 0);
+    for (int t = 1; t < m_maxThreads; t++) {
+        nextSegment(t);
+    }
+    nextSegment(0);
+}
+
+void AccessTraceWriter::barrier(int thread) {
+    if (thread < 0 || thread >= m_maxThreads) {
+        #pragma omp barrier
+        return;
+    }
+    const uint64_t generation = m_threads[thread].barriers++;
+    appendSync(thread, AccessTraceKind::BarrierArrive, generation);
+    #pragma omp barrier
+    appendSync(thread, AccessTraceKind::BarrierLeave, generation);
+    nextSegment(thread);
+}
+
+void AccessTraceWriter::acquire(int thread, const void* sync) {
+    if (thread < 0 || thread >= m_maxThreads) {
+        return;
+    }
+    appendSync(thread, AccessTraceKind::Acquire, reinterpret_cast<uint64_t>(sync));
+    nextSegment(thread);
+}
+
+void AccessTraceWriter::release(int thread, const void* sync) {
+    if (thread < 0 || thread >= m_maxThreads) {
+        return;
+    }
+    appendSync(thread, AccessTraceKind::Release, reinterpret_cast<uint64_t>(sync));
+    nextSegment(thread);
+}
+
+void AccessTraceWriter::region(const std::string& name, const void* start, size_t elementSize, size_t count) {
+    std::lock_guard<std::mutex> lock(m_fileMutex);
+    AccessTraceRegion region;
+    region.name = name;
+    region.start = reinterpret_cast<uint64_t>(start);
+    region.elementSize = std::max<size_t>(elementSize, 1);
+    region.count = count;
+    region.sequence = m_sequence.fetch_add(1);
+    m_regions.push_back(region);
+}
+
+void AccessTraceWriter::flush(int thread) {
+    ThreadBuffer& buffer = m_threads[thread];
+    if (buffer.records.empty()) {
+        return;
+    }
+    const uint32_t header[2] = { ACCESS_TAG_BLOCK, static_cast<uint32_t>(thread) };
+    const uint64_t count = buffer.records.size();
+    {
+        std::lock_guard<std::mutex> lock(m_fileMutex);
+        m_file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        m_file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        m_file.write(reinterpret_cast<const char*>(buffer.records.data()), count * sizeof(AccessTraceRecord));
+    }
+    buffer.flushed += count;
+    buffer.records.clear();
+}
+
+void AccessTraceWriter::close(const std::vector<std::string>& locations) {
+    if (!isOpen()) {
+        return;
+    }
+    for (int t = 0; t < m_maxThreads; t++) {
+        flush(t);
+    }
+
+    auto writeHeader = [this](uint32_t tag, uint32_t value) {
+        const uint32_t header[2] = { tag, value };
+        m_file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    };
+    auto writeString = [this](const std::string& text) {
+        const uint32_t length = static_cast<uint32_t>(text.size());
+        m_file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        m_file.write(text.data(), length);
+    };
+
+    writeHeader(ACCESS_TAG_LOCATIONS, static_cast<uint32_t>(locations.size()));
+    for (const auto& label : locations) {
+        writeString(label);
+    }
+    writeHeader(ACCESS_TAG_REGIONS, static_cast<uint32_t>(m_regions.size()));
+    for (const auto& region : m_regions) {
+        const uint64_t values[4] = { region.start, region.elementSize, region.count, region.sequence };
+        m_file.write(reinterpret_cast<const char*>(values), sizeof(values));
+        writeString(region.name);
+    }
+    writeHeader(ACCESS_TAG_END, 0);
+    m_file.close();
+}
+
+uint64_t AccessTraceWriter::recordCount() const {
+    uint64_t total = 0;
+    for (const auto& buffer : m_threads) {
+        total += buffer.flushed + buffer.records.size();
+    }
+    return total;
+}
+
+// ---------------------------------------------------------------------------
+// AccessTraceReader
+
+AccessTraceReader::~AccessTraceReader() {
+    close();
+}
+
+bool AccessTraceReader::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Cannot open access trace: " << path << std::endl;
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    HANDLE mapping = nullptr;
+    const char* base = nullptr;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping != nullptr) {
+            base = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        }
+    }
+    if (base == nullptr) {
+        if (mapping != nullptr) {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        std::cerr << "Cannot map access trace: " << path << std::endl;
+        return false;
+    }
+    m_file = file;
+    m_mapping = mapping;
+    m_base = base;
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Cannot open access trace: " << path << std::endl;
+        return false;
+    }
+    struct stat info;
+    void* mapped = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    // The mapping keeps the file alive
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Cannot map access trace: " << path << std::endl;
+        return false;
+    }
+    m_base = static_cast<const char*>(mapped);
+    m_size = static_cast<size_t>(info.st_size);
+#endif
+
+    if (!parse(path)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void AccessTraceReader::close() {
+    if (m_base != nullptr) {
+#ifdef _WIN32
+        UnmapViewOfFile(m_base);
+        CloseHandle(static_cast<HANDLE>(m_mapping));
+        CloseHandle(static_cast<HANDLE>(m_file));
+        m_mapping = nullptr;
+        m_file = nullptr;
+#else
+        munmap(const_cast<char*>(m_base), m_size);
+#endif
+    }
+    m_base = nullptr;
+    m_size = 0;
+    m_threads = 0;
+    m_blocks.clear();
+    m_locations.clear();
+    m_regions.clear();
+}
+
+bool AccessTraceReader::parse(const std::string& path) {
+    uint32_t header[2] = {};
+    size_t offset = sizeof(ACCESS_TRACE_MAGIC);
+    if (m_size < offset + sizeof(header) || std::memcmp(m_base, ACCESS_TRACE_MAGIC, sizeof(ACCESS_TRACE_MAGIC)) != 0) {
+        std::cerr << "Not an access trace: " << path << std::endl;
+        return false;
+    }
+    readValue(m_base, m_size, offset, header);
+    m_threads = static_cast<int>(header[0]);
+    if (m_threads < 1 || m_threads > 256) {
+        std::cerr << "Corrupt access trace header: " << path << std::endl;
+        return false;
+    }
+
+    while (readValue(m_base, m_size, offset, header)) {
+        bool ok = true;
+        if (header[0] == ACCESS_TAG_BLOCK) {
+            uint64_t count = 0;
+            ok = readValue(m_base, m_size, offset, count) && header[1] < static_cast<uint32_t>(m_threads) &&
+                 count <= (m_size - offset) / sizeof(AccessTraceRecord);
+            if (ok) {
+                m_blocks.push_back({ static_cast<int>(header[1]),
+                                     reinterpret_cast<const AccessTraceRecord*>(m_base + offset),
+                                     static_cast<size_t>(count) });
+                offset += static_cast<size_t>(count) * sizeof(AccessTraceRecord);
+            }
+        } else if (header[0] == ACCESS_TAG_LOCATIONS) {
+            m_locations.resize(header[1]);
+            for (uint32_t i = 0; ok && i < header[1]; i++) {
+                ok = readString(m_base, m_size, offset, m_locations[i]);
+            }
+        } else if (header[0] == ACCESS_TAG_REGIONS) {
+            m_regions.resize(header[1]);
+            for (uint32_t i = 0; ok && i < header[1]; i++) {
+                AccessTraceRegion& region = m_regions[i];
+                ok = readValue(m_base, m_size, offset, region.start) &&
+                     readValue(m_base, m_size, offset, region.elementSize) &&
+                     readValue(m_base, m_size, offset, region.count) &&
+                     readValue(m_base, m_size, offset, region.sequence) &&
+                     readString(m_base, m_size, offset, region.name) && region.elementSize > 0;
+            }
+        } else if (header[0] == ACCESS_TAG_END) {
+            return true;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cerr << "Corrupt block in access trace " << path << std::endl;
+            return false;
+        }
+    }
+    // A run that crashed leaves a trace without tables; its blocks are still usable
+    std::cerr << "Access trace " << path << " has no end block; analyzing the records it has" << std::endl;
+    return true;
+}
+
+AccessTraceAnalysis AccessTraceReader::analyze(int workers) const {
+    AccessTraceAnalysis result;
+    const int threads = m_threads;
+    result.threads = threads;
+    result.workers = std::max(workers, 1);
+    result.locations = m_locations;
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Split each thread's records into per-segment pieces and collect its sync events
+    std::vector<std::vector<Piece>> pieces(threads);
+    std::vector<std::vector<SyncEvent>> syncs(threads);
+    std::vector<uint64_t> accesses(threads, 0);
+
+    #pragma omp parallel for num_threads(result.workers) schedule(dynamic)
+    for (int t = 0; t < threads; t++) {
+        for (const Block& block : m_blocks) {
+            if (block.thread != t) {
+                continue;
+            }
+            for (const AccessTraceRecord* record = block.records; record != block.records + block.count; ++record) {
+                if (!record->isAccess()) {
+                    syncs[t].push_back({ record->location, t, record->kind(), record->address });
+                    continue;
+                }
+                accesses[t]++;
+                if (!pieces[t].empty() && pieces[t].back().segment == record->segment() && pieces[t].back().end == record) {
+                    pieces[t].back().end = record + 1;
+                } else {
+                    pieces[t].push_back({ t, record->segment(), record, record + 1 });
+                }
+            }
+        }
+    }
+
+    // Replay the sync events in the order they took effect, snapshotting the
+    // vector clock of every new segment. A segment's creation index orders
+    // segments consistently with happens-before.
+    std::vector<SyncEvent> events;
+    for (int t = 0; t < threads; t++) {
+        events.insert(events.end(), syncs[t].begin(), syncs[t].end());
+        result.accesses += accesses[t];
+    }
+    std::sort(events.begin(), events.end(), [](const SyncEvent& a, const SyncEvent& b) {
+        return a.sequence < b.sequence;
+    });
+    result.syncEvents = events.size();
+
+    std::vector<std::vector<Clock>> clock(threads, std::vector<Clock>(threads, 0));
+    std::vector<std::vector<std::vector<Clock>>> segmentClock(threads);
+    std::vector<std::vector<uint64_t>> segmentOrder(threads);
+    std::vector<std::vector<uint32_t>> segmentSequence(threads);    // Sync event that started the segment
+    uint64_t created = 0;
+    uint32_t sequence = 0;
+    auto newSegment = [&](int t) {
+        segmentClock[t].push_back(clock[t]);
+        segmentOrder[t].push_back(created++);
+        segmentSequence[t].push_back(sequence);
+    };
+    for (int t = 0; t < threads; t++) {
+        clock[t][t] = 1;
+        newSegment(t);
+    }
+
+    std::vector<Clock> barrierClocks[3];
+    for (auto& slot : barrierClocks) {
+        slot.assign(threads, 0);
+    }
+    std::unordered_map<uint64_t, std::vector<Clock>> syncClocks;
+
+    for (const SyncEvent& event : events) {
+        const int t = event.thread;
+        sequence = event.sequence;
+        switch (event.kind) {
+        case AccessTraceKind::Fork: {
+            const int team = static_cast<int>(std::min<uint64_t>(event.argument, static_cast<uint64_t>(threads)));
+            for (int u = 1; u < team; u++) {
+                join(clock[u], clock[0]);
+                clock[u][u]++;
+                newSegment(u);
+            }
+            clock[0][0]++;
+            newSegment(0);
+            for (auto& slot : barrierClocks) {
+                std::fill(slot.begin(), slot.end(), 0);
+            }
+            break;
+        }
+        case AccessTraceKind::Join:
+            for (int u = 1; u < threads; u++) {
+                join(clock[0], clock[u]);
+                clock[u][u]++;
+                newSegment(u);
+            }
+            clock[0][0]++;
+            newSegment(0);
+            break;
+        case AccessTraceKind::BarrierArrive:
+            join(barrierClocks[event.argument % 3], clock[t]);
+            if (t == 0) {
+                auto& stale = barrierClocks[(event.argument + 1) % 3];
+                std::fill(stale.begin(), stale.end(), 0);
+            }
+            break;
+        case AccessTraceKind::BarrierLeave:
+            join(clock[t], barrierClocks[event.argument % 3]);
+            clock[t][t]++;
+            newSegment(t);
+            break;
+        case AccessTraceKind::Acquire: {
+            auto it = syncClocks.find(event.argument);
+            if (it != syncClocks.end()) {
+                join(clock[t], it->second);
+            }
+            newSegment(t);
+            break;
+        }
+        case AccessTraceKind::Release:
+            syncClocks[event.argument] = clock[t];
+            clock[t][t]++;
+            newSegment(t);
+            break;
+        default:
+            break;
+        }
+    }
+    result.segments = created;
+
+    // Every piece in segment creation order; a thread's pieces of one segment keep program order
+    std::vector<Piece> order;
+    for (int t = 0; t < threads; t++) {
+        for (Piece& piece : pieces[t]) {
+            piece.segment = std::min<uint32_t>(piece.segment, static_cast<uint32_t>(segmentClock[t].size() - 1));
+            order.push_back(piece);
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [&](const Piece& a, const Piece& b) {
+        return segmentOrder[a.thread][a.segment] < segmentOrder[b.thread][b.segment];
+    });
+
+    result.replaySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+
+    // Regions in declaration order, with their analysis slots
+    std::vector<size_t> regionOrder(m_regions.size());
+    for (size_t r = 0; r < m_regions.size(); r++) {
+        regionOrder[r] = r;
+        AccessTraceRegionAnalysis analysis;
+        analysis.region = m_regions[r];
+        const uint64_t bytes = m_regions[r].elementSize * m_regions[r].count;
+        analysis.readThreads.resize(m_regions[r].count);
+        analysis.writeThreads.resize(m_regions[r].count);
+        analysis.lineAccess.resize((bytes + LINE_SIZE - 1) / LINE_SIZE);
+        result.regions.push_back(std::move(analysis));
+    }
+    std::sort(regionOrder.begin(), regionOrder.end(), [this](size_t a, size_t b) {
+        return m_regions[a].sequence < m_regions[b].sequence;
+    });
+
+    const int workerCount = result.workers;
+    std::vector<WorkerResult> workerResults(workerCount);
+
+    #pragma omp parallel for num_threads(workerCount) schedule(static, 1)
+    for (int w = 0; w < workerCount; w++) {
+        WorkerResult& mine = workerResults[w];
+        std::unordered_map<uint64_t, ShadowWord> shadow;
+        const uint64_t ranges = static_cast<uint64_t>(workerCount);
+
+        for (const Piece& piece : order) {
+            const std::vector<Clock>& segmentVector = segmentClock[piece.thread][piece.segment];
+            const uint64_t segmentStart = segmentSequence[piece.thread][piece.segment];
+            for (const AccessTraceRecord* record = piece.begin; record != piece.end; ++record) {
+                const uint64_t address = record->address;
+                const bool isWrite = record->kind() == AccessTraceKind::Write;
+
+                const uint64_t word = address / 8;
+                if ((word >> WORD_RANGE_SHIFT) % ranges == static_cast<uint64_t>(w)) {
+                    ShadowWord& entry = shadow[word];
+                    if (isWrite) {
+                        checkWrite(mine, entry, word, piece.thread, segmentVector, record->location, threads);
+                    } else {
+                        checkRead(mine, entry, word, piece.thread, segmentVector, record->location, threads);
+                    }
+                }
+
+                if (regionOrder.empty()) {
+                    continue;
+                }
+                // The first region declared after the segment started covers the access
+                auto it = std::upper_bound(regionOrder.begin(), regionOrder.end(), segmentStart,
+                                           [this](uint64_t value, size_t r) { return value < m_regions[r].sequence; });
+                if (it == regionOrder.end()) {
+                    continue;
+                }
+                AccessTraceRegionAnalysis& region = result.regions[*it];
+                const uint64_t offset = address - region.region.start;
+                if (address < region.region.start || offset >= region.region.elementSize * region.region.count) {
+                    continue;
+                }
+                const uint64_t element = offset / region.region.elementSize;
+                if ((element >> ELEMENT_RANGE_SHIFT) % ranges == static_cast<uint64_t>(w)) {
+                    (isWrite ? region.writeThreads : region.readThreads)[element].insert(piece.thread);
+                }
+                const uint64_t line = offset / LINE_SIZE;
+                if ((line >> LINE_RANGE_SHIFT) % ranges == static_cast<uint64_t>(w)) {
+                    auto& counts = region.lineAccess[line][piece.thread];
+                    (isWrite ? counts.second : counts.first)++;
+                }
+            }
+        }
+        mine.shadowWords = shadow.size();
+    }
+
+    for (const WorkerResult& worker : workerResults) {
+        result.races.insert(result.races.end(), worker.races.begin(), worker.races.end());
+        result.raceCount += worker.raceCount;
+        result.shadowWords += worker.shadowWords;
+    }
+    std::sort(result.races.begin(), result.races.end(), [](const HBRace& a, const HBRace& b) {
+        return a.address < b.address;
+    });
+
+    result.analyzeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
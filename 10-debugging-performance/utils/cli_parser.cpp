@@ -73,7 +73,8 @@ bool CliParser::hasOption(const std::string& option) const {
 
 std::string CliParser::getStringOption(const std::string& option, const std::string& defaultValue) const {
     auto it = m_options.find(option);
-    if (it != m_options.end()) {
+    // Options declared without a default hold an empty value until given
+    if (it != m_options.end() && !it->second.empty()) {
         return it->second;
     }
     return defaultValue;
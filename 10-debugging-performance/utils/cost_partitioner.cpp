@@ -0,0 +1,137 @@
+#include "../include/cost_partitioner.h"
+#include <algorithm>
+#include <numeric>
+#include <queue>
+#include <functional>
+#include <utility>
+
+void CostPartitioner::plan(const std::vector<double>& costs, int numThreads) {
+    m_numThreads = std::max(numThreads, 1);
+    m_queues.reset(new Queue[m_numThreads]);
+
+    // Heaviest first; ties keep the original order so plans are reproducible
+    std::vector<uint32_t> byCost(costs.size());
+    std::iota(byCost.begin(), byCost.end(), 0u);
+    std::stable_sort(byCost.begin(), byCost.end(), [&](uint32_t a, uint32_t b) {
+        return costs[a] > costs[b];
+    });
+
+    // Each item goes to the least-loaded thread so far
+    using Load = std::pair<double, int>;
+    std::priority_queue<Load, std::vector<Load>, std::greater<Load>> loads;
+    for (int t = 0; t < m_numThreads; t++) {
+        loads.push({0.0, t});
+    }
+    std::vector<int> owner(costs.size());
+    std::vector<uint32_t> queueSize(m_numThreads, 0);
+    for (uint32_t item : byCost) {
+        Load least = loads.top();
+        loads.pop();
+        owner[item] = least.second;
+        queueSize[least.second]++;
+        m_queues[least.second].plannedCost += costs[item];
+        loads.push({least.first + costs[item], least.second});
+    }
+
+    // Lay the queues out back to back, each still heaviest first
+    uint32_t offset = 0;
+    for (int t = 0; t < m_numThreads; t++) {
+        m_queues[t].begin = offset;
+        m_queues[t].end = offset;
+        offset += queueSize[t];
+    }
+    m_order.resize(costs.size());
+    for (uint32_t item : byCost) {
+        Queue& queue = m_queues[owner[item]];
+        m_order[queue.end++] = item;
+    }
+
+    rewind();
+}
+
+void CostPartitioner::rewind() {
+    for (int t = 0; t < m_numThreads; t++) {
+        Queue& queue = m_queues[t];
+        queue.bounds.store(packBounds(queue.begin, queue.end), std::memory_order_relaxed);
+        queue.executed = 0;
+        queue.stolen = 0;
+    }
+}
+
+bool CostPartitioner::popOwn(Queue& queue, uint32_t& item) {
+    uint64_t bounds = queue.bounds.load(std::memory_order_relaxed);
+    for (;;) {
+        uint32_t head = static_cast<uint32_t>(bounds >> 32);
+        uint32_t tail = static_cast<uint32_t>(bounds);
+        if (head >= tail) {
+            return false;
+        }
+        if (queue.bounds.compare_exchange_weak(bounds, packBounds(head + 1, tail), std::memory_order_relaxed)) {
+            item = m_order[head];
+            return true;
+        }
+    }
+}
+
+bool CostPartitioner::stealFrom(Queue& queue, uint32_t& item) {
+    uint64_t bounds = queue.bounds.load(std::memory_order_relaxed);
+    for (;;) {
+        uint32_t head = static_cast<uint32_t>(bounds >> 32);
+        uint32_t tail = static_cast<uint32_t>(bounds);
+        if (head >= tail) {
+            return false;
+        }
+        if (queue.bounds.compare_exchange_weak(bounds, packBounds(head, tail - 1), std::memory_order_relaxed)) {
+            item = m_order[tail - 1];
+            return true;
+        }
+    }
+}
+
+bool CostPartitioner::steal(int thief, uint32_t& item) {
+    for (;;) {
+        // Victim: the queue with the most items left
+        int victim = -1;
+        uint32_t mostLeft = 0;
+        for (int t = 0; t < m_numThreads; t++) {
+            if (t == thief) continue;
+            uint64_t bounds = m_queues[t].bounds.load(std::memory_order_relaxed);
+            uint32_t head = static_cast<uint32_t>(bounds >> 32);
+            uint32_t tail = static_cast<uint32_t>(bounds);
+            uint32_t left = head < tail ? tail - head : 0;
+            if (left > mostLeft) {
+                mostLeft = left;
+                victim = t;
+            }
+        }
+        if (victim < 0) {
+            return false;
+        }
+        if (stealFrom(m_queues[victim], item)) {
+            return true;
+        }
+        // Emptied by its owner or another thief in the meantime; look again
+    }
+}
+
+double CostPartitioner::plannedCost(int thread) const {
+    return (thread >= 0 && thread < m_numThreads) ? m_queues[thread].plannedCost : 0.0;
+}
+
+double CostPartitioner::plannedImbalance() const {
+    double total = 0.0;
+    double largest = 0.0;
+    for (int t = 0; t < m_numThreads; t++) {
+        total += m_queues[t].plannedCost;
+        largest = std::max(largest, m_queues[t].plannedCost);
+    }
+    return total > 0.0 ? largest / (total / m_numThreads) : 1.0;
+}
+
+size_t CostPartitioner::executedCount(int thread) const {
+    return (thread >= 0 && thread < m_numThreads) ? m_queues[thread].executed : 0;
+}
+
+size_t CostPartitioner::stolenCount(int thread) const {
+    return (thread >= 0 && thread < m_numThreads) ? m_queues[thread].stolen : 0;
+}
@@ -9,6 +9,10 @@
 #include <unordered_map>
 #include <utility>
 #include <limits>
+#include <memory>
+#include <thread>
+#include <condition_variable>
+#include "../include/cache_padded.h"
 
 // Undefine Windows macros to avoid conflicts
 #undef min
@@ -16,6 +20,141 @@
 
 // DebugLogger implementation
 
+namespace {
+
+// Format strings registered for deferred logging; IDs index into formats
+struct FormatRegistry {
+    std::mutex mutex;
+    std::vector<std::string> formats;
+    std::unordered_map<std::string, DebugLogger::FormatId> ids;
+};
+
+FormatRegistry& formatRegistry() {
+    static FormatRegistry registry;
+    return registry;
+}
+
+// Records carrying a ready-made message instead of a format
+const DebugLogger::FormatId kTextRecord = std::numeric_limits<DebugLogger::FormatId>::max();
+
+std::tm toLocalTime(std::time_t time) {
+    std::tm tm_buf;
+#ifdef _WIN32
+    localtime_s(&tm_buf, &time);
+#else
+    localtime_r(&time, &tm_buf);
+#endif
+    return tm_buf;
+}
+
+void appendArg(std::string& out, const LogArg& arg) {
+    switch (arg.type) {
+        case LogArg::Int:     out += std::to_string(arg.i); break;
+        case LogArg::UInt:    out += std::to_string(arg.u); break;
+        case LogArg::Double: {
+            std::ostringstream ss;
+            ss << arg.d;
+            out += ss.str();
+            break;
+        }
+        case LogArg::CString: out += arg.s ? arg.s : "(null)"; break;
+        case LogArg::None:    break;
+    }
+}
+
+// Replace each "{}" with the next argument
+std::string expandFormat(DebugLogger::FormatId format, const LogArg* args, size_t count) {
+    std::string pattern;
+    {
+        FormatRegistry& registry = formatRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        if (format < registry.formats.size()) {
+            pattern = registry.formats[format];
+        }
+    }
+
+    std::string out;
+    out.reserve(pattern.size() + 16 * count);
+    size_t next = 0;
+    for (size_t pos = 0; pos < pattern.size(); pos++) {
+        if (pattern[pos] == '{' && pos + 1 < pattern.size() && pattern[pos + 1] == '}' && next < count) {
+            appendArg(out, args[next++]);
+            pos++;
+        } else {
+            out += pattern[pos];
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+// One log call, stored unformatted
+struct LogRecord {
+    int64_t timestamp = 0;                      // system_clock ticks
+    LogLevel level = INFO;
+    int threadId = 0;
+    DebugLogger::FormatId format = kTextRecord;
+    uint8_t argCount = 0;
+    LogArg args[DebugLogger::MAX_LOG_ARGS];
+    std::string text;                           // Message of log(); capacity is reused slot to slot
+};
+
+// Single-producer (the owning thread), single-consumer (whoever holds drainMutex) ring
+struct LogRing {
+    explicit LogRing(size_t capacity) : slots(capacity), mask(capacity - 1) {}
+
+    std::vector<LogRecord> slots;
+    const uint64_t mask;
+    CachePadded<std::atomic<uint64_t>> head;        // Next record to drain; written by the consumer
+    CachePadded<std::atomic<uint64_t>> tail;        // Next free slot; written by the producer
+    std::atomic<uint64_t> dropped{0};
+    uint64_t droppedReported = 0;                   // Consumer only
+    int threadId = -1;                              // OpenMP thread number when the ring was created
+};
+
+struct DebugLogger::AsyncState {
+    size_t capacity = 0;
+    LogOverflowPolicy policy = LogOverflowPolicy::DropNewest;
+    std::chrono::milliseconds interval{10};
+    uint64_t generation = 0;
+
+    std::mutex ringsMutex;                          // Guards rings (the list, not the contents)
+    std::vector<std::unique_ptr<LogRing>> rings;
+
+    std::mutex drainMutex;                          // Makes the flusher and flush() one consumer
+    std::vector<LogRecord> batch;
+    std::ofstream file;
+    std::string fileName;
+    uint64_t droppedTotal = 0;
+
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::thread flusher;
+
+    // The calling thread's ring; registered on first use in each async session
+    LogRing& localRing() {
+        thread_local LogRing* ring = nullptr;
+        thread_local uint64_t ringGeneration = 0;
+        if (ring == nullptr || ringGeneration != generation) {
+            std::unique_ptr<LogRing> created(new LogRing(capacity));
+            created->threadId = omp_get_thread_num();
+            ring = created.get();
+            ringGeneration = generation;
+            std::lock_guard<std::mutex> lock(ringsMutex);
+            rings.push_back(std::move(created));
+        }
+        return *ring;
+    }
+};
+
+namespace {
+
+std::atomic<uint64_t> g_asyncGeneration{0};
+
+} // namespace
+
 DebugLogger& DebugLogger::getInstance() {
     static DebugLogger instance;
     return instance;
@@ -26,38 +165,44 @@ DebugLogger::DebugLogger()
       m_fileOutput(false), 
       m_consoleOutput(true),
       m_includeThreadId(true),
-      m_filename("debug.log") {
+      m_filename("debug.log"),
+      m_async(nullptr) {
 }
 
 DebugLogger::~DebugLogger() {
-    // Nothing to clean up
+    setAsync(false);
 }
 
-void DebugLogger::log(LogLevel level, const std::string& message, int threadId) {
-    if (level < m_logLevel) {
-        return;
-    }
-
-    std::lock_guard<std::mutex> lock(m_mutex);
-    
-    // Get current time
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
-    std::tm tm_buf;
-    localtime_s(&tm_buf, &time);
+std::string DebugLogger::formatEntry(LogLevel level, std::time_t time, int threadId, const std::string& message) const {
+    std::tm tm_buf = toLocalTime(time);
     
     std::stringstream ss;
     ss << "[" << std::put_time(&tm_buf, "%Y-%m-%d %H:%M:%S") << "] ";
     ss << "[" << levelToString(level) << "] ";
     
     if (m_includeThreadId) {
-        int tid = (threadId == -1) ? omp_get_thread_num() : threadId;
-        ss << "[Thread " << tid << "] ";
+        ss << "[Thread " << threadId << "] ";
     }
     
     ss << message;
+    return ss.str();
+}
+
+void DebugLogger::log(LogLevel level, const std::string& message, int threadId) {
+    if (level < m_logLevel.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    int tid = (threadId == -1) ? omp_get_thread_num() : threadId;
+    if (AsyncState* async = m_async.load(std::memory_order_acquire)) {
+        enqueue(*async, level, kTextRecord, nullptr, 0, &message, tid);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
     
-    std::string logEntry = ss.str();
+    std::string logEntry = formatEntry(level, std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()),
+                                       tid, message);
     m_logEntries.push_back(logEntry);
     
     if (m_consoleOutput) {
@@ -73,6 +218,206 @@ void DebugLogger::log(LogLevel level, const std::string& message, int threadId)
     }
 }
 
+DebugLogger::FormatId DebugLogger::registerFormat(const std::string& format) {
+    FormatRegistry& registry = formatRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto it = registry.ids.find(format);
+    if (it != registry.ids.end()) {
+        return it->second;
+    }
+    FormatId id = static_cast<FormatId>(registry.formats.size());
+    registry.formats.push_back(format);
+    registry.ids.emplace(format, id);
+    return id;
+}
+
+void DebugLogger::logDeferred(LogLevel level, FormatId format, const LogArg* args, size_t count) {
+    if (AsyncState* async = m_async.load(std::memory_order_acquire)) {
+        enqueue(*async, level, format, args, count, nullptr, omp_get_thread_num());
+    } else {
+        log(level, expandFormat(format, args, count));
+    }
+}
+
+void DebugLogger::enqueue(AsyncState& async, LogLevel level, FormatId format, const LogArg* args, size_t count,
+                          const std::string* text, int threadId) {
+    LogRing& ring = async.localRing();
+    const uint64_t tail = ring.tail->load(std::memory_order_relaxed);
+    uint64_t head = ring.head->load(std::memory_order_acquire);
+
+    if (tail - head >= async.capacity) {
+        if (async.policy == LogOverflowPolicy::DropNewest) {
+            ring.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // Block: hand the ring to the flusher and wait for room
+        do {
+            async.wake.notify_one();
+            std::this_thread::yield();
+            head = ring.head->load(std::memory_order_acquire);
+        } while (tail - head >= async.capacity);
+    }
+
+    LogRecord& record = ring.slots[tail & ring.mask];
+    record.timestamp = std::chrono::system_clock::now().time_since_epoch().count();
+    record.level = level;
+    record.threadId = threadId;
+    record.format = format;
+    record.argCount = static_cast<uint8_t>(count);
+    for (size_t i = 0; i < count; i++) {
+        record.args[i] = args[i];
+    }
+    if (text != nullptr) {
+        record.text.assign(*text);
+    }
+    ring.tail->store(tail + 1, std::memory_order_release);
+
+    // Wake the flusher early rather than let a burst fill the ring
+    if (tail + 1 - head == async.capacity - async.capacity / 4) {
+        async.wake.notify_one();
+    }
+}
+
+void DebugLogger::drain(AsyncState& async) {
+    std::lock_guard<std::mutex> drainLock(async.drainMutex);
+
+    std::vector<LogRing*> rings;
+    {
+        std::lock_guard<std::mutex> lock(async.ringsMutex);
+        for (const auto& ring : async.rings) {
+            rings.push_back(ring.get());
+        }
+    }
+
+    async.batch.clear();
+    std::vector<std::pair<int, uint64_t>> drops;
+    for (LogRing* ring : rings) {
+        const uint64_t head = ring->head->load(std::memory_order_relaxed);
+        const uint64_t tail = ring->tail->load(std::memory_order_acquire);
+        for (uint64_t i = head; i < tail; i++) {
+            async.batch.push_back(ring->slots[i & ring->mask]);
+        }
+        ring->head->store(tail, std::memory_order_release);
+
+        const uint64_t dropped = ring->dropped.load(std::memory_order_relaxed);
+        if (dropped != ring->droppedReported) {
+            drops.push_back({ring->threadId, dropped - ring->droppedReported});
+            async.droppedTotal += dropped - ring->droppedReported;
+            ring->droppedReported = dropped;
+        }
+    }
+    if (async.batch.empty() && drops.empty()) {
+        return;
+    }
+
+    // Merge the threads' records into time order
+    std::stable_sort(async.batch.begin(), async.batch.end(), [](const LogRecord& a, const LogRecord& b) {
+        return a.timestamp < b.timestamp;
+    });
+
+    // Formatting reads the output settings, so it runs under the same lock as the setters
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<std::string> entries;
+    entries.reserve(async.batch.size() + drops.size());
+    for (const LogRecord& record : async.batch) {
+        std::time_t time = std::chrono::system_clock::to_time_t(std::chrono::system_clock::time_point(
+            std::chrono::system_clock::duration(record.timestamp)));
+        std::string message = record.format == kTextRecord ? record.text :
+                              expandFormat(record.format, record.args, record.argCount);
+        entries.push_back(formatEntry(record.level, time, record.threadId, message));
+    }
+    for (const auto& drop : drops) {
+        entries.push_back(formatEntry(WARNING, std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()),
+                                      drop.first, std::to_string(drop.second) + " log messages dropped (buffer full)"));
+    }
+
+    // One write per output for the whole batch
+    std::string text;
+    for (const auto& entry : entries) {
+        text += entry;
+        text += '\n';
+    }
+
+    m_logEntries.insert(m_logEntries.end(), entries.begin(), entries.end());
+    if (m_consoleOutput) {
+        std::cout << text << std::flush;
+    }
+    if (m_fileOutput) {
+        if (!async.file.is_open() || async.fileName != m_filename) {
+            async.file.close();
+            async.file.open(m_filename, std::ios::app);
+            async.fileName = m_filename;
+        }
+        if (async.file.is_open()) {
+            async.file << text << std::flush;
+        }
+    }
+}
+
+void DebugLogger::setAsync(bool enabled, size_t bufferEntries, LogOverflowPolicy policy, int flushIntervalMs) {
+    AsyncState* current = m_async.load(std::memory_order_acquire);
+    if (current != nullptr) {
+        // Stop the flusher, then drain what it left behind
+        {
+            std::lock_guard<std::mutex> lock(current->wakeMutex);
+            current->stopping = true;
+        }
+        current->wake.notify_one();
+        current->flusher.join();
+        m_async.store(nullptr, std::memory_order_release);
+        drain(*current);
+        delete current;
+    }
+    if (!enabled) {
+        return;
+    }
+
+    size_t capacity = 2;
+    while (capacity < bufferEntries) {
+        capacity <<= 1;
+    }
+    AsyncState* async = new AsyncState();
+    async->capacity = capacity;
+    async->policy = policy;
+    async->interval = std::chrono::milliseconds(std::max(flushIntervalMs, 1));
+    async->generation = ++g_asyncGeneration;
+    async->flusher = std::thread([this, async]() {
+        std::unique_lock<std::mutex> lock(async->wakeMutex);
+        while (!async->stopping) {
+            async->wake.wait_for(lock, async->interval);
+            lock.unlock();
+            drain(*async);
+            lock.lock();
+        }
+    });
+    m_async.store(async, std::memory_order_release);
+}
+
+bool DebugLogger::isAsync() const {
+    return m_async.load(std::memory_order_acquire) != nullptr;
+}
+
+void DebugLogger::flush() {
+    if (AsyncState* async = m_async.load(std::memory_order_acquire)) {
+        drain(*async);
+    }
+}
+
+uint64_t DebugLogger::getDroppedCount() const {
+    AsyncState* async = m_async.load(std::memory_order_acquire);
+    if (async == nullptr) {
+        return 0;
+    }
+    // Reported drops plus any the flusher has not seen yet
+    std::lock_guard<std::mutex> drainLock(async->drainMutex);
+    std::lock_guard<std::mutex> lock(async->ringsMutex);
+    uint64_t total = async->droppedTotal;
+    for (const auto& ring : async->rings) {
+        total += ring->dropped.load(std::memory_order_relaxed) - ring->droppedReported;
+    }
+    return total;
+}
+
 void DebugLogger::debug(const std::string& message) {
     log(DEBUG, message);
 }
@@ -94,8 +439,7 @@ void DebugLogger::critical(const std::string& message) {
 }
 
 void DebugLogger::setLogLevel(LogLevel level) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_logLevel = level;
+    m_logLevel.store(level, std::memory_order_relaxed);
 }
 
 void DebugLogger::setFileOutput(bool enabled, const std::string& filename) {
@@ -117,6 +461,7 @@ void DebugLogger::setIncludeThreadId(bool enabled) {
 }
 
 void DebugLogger::clear() {
+    flush();
     std::lock_guard<std::mutex> lock(m_mutex);
     m_logEntries.clear();
     
@@ -127,6 +472,8 @@ void DebugLogger::clear() {
 }
 
 std::vector<std::string> DebugLogger::getLogEntries() const {
+    // Include records still in the rings; the logger is a singleton, never a const object
+    const_cast<DebugLogger*>(this)->flush();
     std::lock_guard<std::mutex> lock(m_mutex);
     return m_logEntries;
 }
@@ -0,0 +1,297 @@
+#include "../include/energy_meter.h"
+
+#ifdef __linux__
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+const uint32_t MSR_RAPL_POWER_UNIT = 0x606;
+const uint32_t MSR_PKG_ENERGY_STATUS = 0x611;
+const uint32_t MSR_DRAM_ENERGY_STATUS = 0x619;
+const uint32_t MSR_IA32_MPERF = 0xE7;
+const uint32_t MSR_IA32_APERF = 0xE8;
+const uint32_t MSR_PLATFORM_INFO = 0xCE;
+
+const std::string POWERCAP_ROOT = "/sys/class/powercap/intel-rapl:";
+const std::string CPU_ROOT = "/sys/devices/system/cpu/cpu";
+
+bool readFileValue(const std::string& path, uint64_t& value) {
+    std::ifstream in(path);
+    return static_cast<bool>(in >> value);
+}
+
+bool readFileString(const std::string& path, std::string& value) {
+    std::ifstream in(path);
+    return static_cast<bool>(std::getline(in, value));
+}
+
+bool readMsr(int fd, uint32_t reg, uint64_t& value) {
+    return fd >= 0 && pread(fd, &value, sizeof(value), reg) == static_cast<ssize_t>(sizeof(value));
+}
+
+int openMsr(int cpu) {
+    return ::open(("/dev/cpu/" + std::to_string(cpu) + "/msr").c_str(), O_RDONLY);
+}
+
+// One RAPL counter, accumulated across wraparounds into joules
+struct EnergyDomain {
+    bool dram = false;
+    std::string path;           // powercap energy_uj, or empty for an MSR
+    uint64_t range = 0;         // powercap: largest value before the counter wraps
+    int fd = -1;                // MSR: device of a CPU in the package (not owned)
+    uint32_t msr = 0;
+    double unit = 0.0;          // MSR: joules per count
+    uint64_t last = 0;
+    double total = 0.0;
+    bool started = false;
+
+    bool readRaw(uint64_t& raw) const {
+        if (!path.empty()) {
+            return readFileValue(path, raw);
+        }
+        if (!readMsr(fd, msr, raw)) {
+            return false;
+        }
+        raw &= 0xFFFFFFFFu;
+        return true;
+    }
+
+    bool update() {
+        uint64_t raw = 0;
+        if (!readRaw(raw)) {
+            return false;
+        }
+        if (started) {
+            if (!path.empty()) {
+                total += 1e-6 * static_cast<double>(raw >= last ? raw - last : range - last + raw);
+            } else {
+                total += unit * static_cast<double>((raw - last) & 0xFFFFFFFFu);
+            }
+        }
+        last = raw;
+        started = true;
+        return true;
+    }
+};
+
+struct Meter {
+    std::mutex mutex;
+    bool probed = false;
+    const char* backend = "none";
+    std::string error;
+    std::vector<EnergyDomain> domains;
+    std::vector<int> cpuFds;        // One MSR device per logical CPU, for APERF/MPERF
+    double baseMHz = 0.0;
+    int cpuCount = 0;
+    std::chrono::steady_clock::time_point start;
+
+    ~Meter() {
+        for (int fd : cpuFds) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+    }
+
+    bool probePowercap() {
+        for (int package = 0; ; package++) {
+            const std::string zone = POWERCAP_ROOT + std::to_string(package);
+            std::string name;
+            if (!readFileString(zone + "/name", name)) {
+                break;
+            }
+            for (int sub = -1; ; sub++) {
+                const std::string dir = sub < 0 ? zone : zone + ":" + std::to_string(sub);
+                if (sub >= 0 && !readFileString(dir + "/name", name)) {
+                    break;
+                }
+                if (sub >= 0 && name != "dram") {
+                    continue;   // core/uncore are already in the package domain
+                }
+                EnergyDomain domain;
+                domain.dram = sub >= 0;
+                domain.path = dir + "/energy_uj";
+                uint64_t raw = 0;
+                if (!readFileValue(dir + "/max_energy_range_uj", domain.range) || !domain.readRaw(raw)) {
+                    error = "cannot read " + domain.path + " (root-only since Linux 5.10)";
+                    domains.clear();
+                    return false;
+                }
+                domains.push_back(domain);
+            }
+        }
+        if (domains.empty() && error.empty()) {
+            error = "no powercap RAPL zones (intel_rapl driver not loaded, or inside a VM)";
+        }
+        return !domains.empty();
+    }
+
+    bool probeMsr() {
+        if (cpuFds.empty() || cpuFds[0] < 0) {
+            return false;
+        }
+        std::vector<bool> seenPackage;
+        for (int cpu = 0; cpu < cpuCount; cpu++) {
+            uint64_t package = 0;
+            readFileValue(CPU_ROOT + std::to_string(cpu) + "/topology/physical_package_id", package);
+            if (cpuFds[cpu] < 0 || (package < seenPackage.size() && seenPackage[package])) {
+                continue;
+            }
+            if (package >= seenPackage.size()) {
+                seenPackage.resize(package + 1, false);
+            }
+            seenPackage[package] = true;
+
+            uint64_t units = 0;
+            uint64_t raw = 0;
+            if (!readMsr(cpuFds[cpu], MSR_RAPL_POWER_UNIT, units) ||
+                !readMsr(cpuFds[cpu], MSR_PKG_ENERGY_STATUS, raw)) {
+                continue;
+            }
+            EnergyDomain domain;
+            domain.fd = cpuFds[cpu];
+            domain.msr = MSR_PKG_ENERGY_STATUS;
+            domain.unit = 1.0 / static_cast<double>(1ull << ((units >> 8) & 0x1F));
+            domains.push_back(domain);
+            // Some server parts count DRAM in a fixed unit instead; treat this as an estimate there
+            if (readMsr(cpuFds[cpu], MSR_DRAM_ENERGY_STATUS, raw) && raw != 0) {
+                domain.dram = true;
+                domain.msr = MSR_DRAM_ENERGY_STATUS;
+                domains.push_back(domain);
+            }
+        }
+        return !domains.empty();
+    }
+
+    void probeBaseFrequency() {
+        uint64_t kHz = 0;
+        uint64_t info = 0;
+        if (readFileValue(CPU_ROOT + "0/cpufreq/base_frequency", kHz)) {
+            baseMHz = kHz / 1000.0;
+        } else if (!cpuFds.empty() && readMsr(cpuFds[0], MSR_PLATFORM_INFO, info)) {
+            baseMHz = 100.0 * static_cast<double>((info >> 8) & 0xFF);    // Intel: max non-turbo ratio
+        }
+    }
+
+    void probe() {
+        probed = true;
+        start = std::chrono::steady_clock::now();
+        cpuCount = static_cast<int>(sysconf(_SC_NPROCESSORS_CONF));
+        for (int cpu = 0; cpu < cpuCount; cpu++) {
+            cpuFds.push_back(openMsr(cpu));
+        }
+
+        if (probePowercap()) {
+            backend = "powercap";
+        } else if (probeMsr()) {
+            backend = "msr";
+            error.clear();
+        } else if (cpuFds.empty() || cpuFds[0] < 0) {
+            error += "; /dev/cpu/0/msr not readable (modprobe msr, run as root)";
+        } else {
+            error += "; RAPL MSRs not readable on this CPU";
+        }
+        probeBaseFrequency();
+        update();       // Baseline for the wraparound tracking
+    }
+
+    EnergySample update() {
+        EnergySample sample;
+        sample.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        sample.valid = !domains.empty();
+        for (EnergyDomain& domain : domains) {
+            sample.valid = domain.update() && sample.valid;
+            (domain.dram ? sample.dramJoules : sample.packageJoules) += domain.total;
+        }
+
+        sample.frequencyValid = baseMHz > 0.0 && !cpuFds.empty();
+        for (int fd : cpuFds) {
+            uint64_t aperf = 0;
+            uint64_t mperf = 0;
+            if (!readMsr(fd, MSR_IA32_APERF, aperf) || !readMsr(fd, MSR_IA32_MPERF, mperf)) {
+                sample.frequencyValid = false;
+                break;
+            }
+            sample.aperf += aperf;
+            sample.mperf += mperf;
+        }
+        if (!sample.frequencyValid) {
+            double totalMHz = 0.0;
+            int counted = 0;
+            for (int cpu = 0; cpu < cpuCount; cpu++) {
+                uint64_t kHz = 0;
+                if (readFileValue(CPU_ROOT + std::to_string(cpu) + "/cpufreq/scaling_cur_freq", kHz)) {
+                    totalMHz += kHz / 1000.0;
+                    counted++;
+                }
+            }
+            sample.currentMHz = counted > 0 ? totalMHz / counted : 0.0;
+        }
+        return sample;
+    }
+};
+
+Meter& meter() {
+    static Meter instance;
+    std::lock_guard<std::mutex> lock(instance.mutex);
+    if (!instance.probed) {
+        instance.probe();
+    }
+    return instance;
+}
+
+} // namespace
+
+bool EnergyMeter::isAvailable() {
+    return !meter().domains.empty();
+}
+
+std::string EnergyMeter::unavailableReason() {
+    Meter& m = meter();
+    return m.domains.empty() ? m.error : "";
+}
+
+EnergySample EnergyMeter::read() {
+    Meter& m = meter();
+    std::lock_guard<std::mutex> lock(m.mutex);
+    return m.update();
+}
+
+double EnergyMeter::baseFrequencyMHz() {
+    return meter().baseMHz;
+}
+
+const char* EnergyMeter::backendName() {
+    return meter().backend;
+}
+
+#else
+
+bool EnergyMeter::isAvailable() {
+    return false;
+}
+
+std::string EnergyMeter::unavailableReason() {
+    return "no RAPL backend on this platform (powercap and the msr driver are Linux-only)";
+}
+
+EnergySample EnergyMeter::read() {
+    return EnergySample();
+}
+
+double EnergyMeter::baseFrequencyMHz() {
+    return 0.0;
+}
+
+const char* EnergyMeter::backendName() {
+    return "none";
+}
+
+#endif
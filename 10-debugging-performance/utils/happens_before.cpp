@@ -0,0 +1,354 @@
+#include "../include/happens_before.h"
+#include "../include/access_trace.h"
+#include <algorithm>
+
+namespace {
+
+// Mix the word index so neighbouring words land in different shards
+size_t shardIndex(uintptr_t word, size_t shards) {
+    uint64_t x = static_cast<uint64_t>(word);
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    return static_cast<size_t>(x % shards);
+}
+
+} // namespace
+
+HappensBeforeDetector::HappensBeforeDetector(int maxThreads) {
+    reset(maxThreads);
+}
+
+HappensBeforeDetector::~HappensBeforeDetector() {
+    stopRecording();
+}
+
+void HappensBeforeDetector::reset(int maxThreads) {
+    m_maxThreads = std::min(std::max(maxThreads, 1), 256);
+    m_threads = std::vector<ThreadState>(m_maxThreads);
+    for (int t = 0; t < m_maxThreads; t++) {
+        // Clocks start at 1 so that epoch 0 means "no access"
+        m_threads[t].clock.assign(m_maxThreads, 0);
+        m_threads[t].clock[t] = 1;
+    }
+    m_shards.reset(new Shard[kShards]);
+
+    std::lock_guard<std::mutex> lock(m_syncMutex);
+    m_syncClocks.clear();
+    for (auto& slot : m_barrierClocks) {
+        slot.assign(m_maxThreads, 0);
+    }
+}
+
+uint32_t HappensBeforeDetector::location(const std::string& label) {
+    std::lock_guard<std::mutex> lock(m_locationMutex);
+    auto it = m_locationIds.find(label);
+    if (it != m_locationIds.end()) {
+        return it->second;
+    }
+    // ID 0 is reserved for "unknown"
+    uint32_t id = static_cast<uint32_t>(m_locations.size()) + 1;
+    m_locations.push_back(label);
+    m_locationIds.emplace(label, id);
+    return id;
+}
+
+std::string HappensBeforeDetector::locationName(uint32_t id) const {
+    std::lock_guard<std::mutex> lock(m_locationMutex);
+    if (id == 0 || id > m_locations.size()) {
+        return "[Unknown]";
+    }
+    return m_locations[id - 1];
+}
+
+bool HappensBeforeDetector::startRecording(const std::string& path) {
+    stopRecording();
+    std::unique_ptr<AccessTraceWriter> recorder(new AccessTraceWriter());
+    if (!recorder->open(path, m_maxThreads)) {
+        return false;
+    }
+    m_recorder = std::move(recorder);
+    return true;
+}
+
+uint64_t HappensBeforeDetector::stopRecording() {
+    if (!m_recorder) {
+        return 0;
+    }
+    std::vector<std::string> labels;
+    {
+        std::lock_guard<std::mutex> lock(m_locationMutex);
+        labels.assign(m_locations.begin(), m_locations.end());
+    }
+    m_recorder->close(labels);
+    const uint64_t records = m_recorder->recordCount();
+    m_recorder.reset();
+    return records;
+}
+
+void HappensBeforeDetector::recordRegion(const std::string& name, const void* start, size_t elementSize, size_t count) {
+    if (m_recorder) {
+        m_recorder->region(name, start, elementSize, count);
+    }
+}
+
+void HappensBeforeDetector::join(std::vector<Clock>& into, const std::vector<Clock>& from) {
+    for (size_t i = 0; i < into.size(); i++) {
+        into[i] = std::max(into[i], from[i]);
+    }
+}
+
+HappensBeforeDetector::ThreadState* HappensBeforeDetector::currentThread(int& thread) {
+    thread = omp_get_thread_num();
+    return thread < m_maxThreads ? &m_threads[thread] : nullptr;
+}
+
+HappensBeforeDetector::Shard& HappensBeforeDetector::shardFor(uintptr_t word) {
+    return m_shards[shardIndex(word, kShards)];
+}
+
+void HappensBeforeDetector::parallelBegin(int numThreads) {
+    if (m_recorder) {
+        m_recorder->parallelBegin(numThreads);
+        return;
+    }
+
+    // Every team member starts after everything the master did so far
+    ThreadState& master = m_threads[0];
+    for (int t = 1; t < std::min(numThreads, m_maxThreads); t++) {
+        join(m_threads[t].clock, master.clock);
+        m_threads[t].clock[t]++;
+        m_threads[t].barriers = 0;
+    }
+    master.clock[0]++;
+    master.barriers = 0;
+
+    std::lock_guard<std::mutex> lock(m_syncMutex);
+    for (auto& slot : m_barrierClocks) {
+        std::fill(slot.begin(), slot.end(), 0);
+    }
+}
+
+void HappensBeforeDetector::parallelEnd() {
+    if (m_recorder) {
+        m_recorder->parallelEnd();
+        return;
+    }
+
+    // The master continues after everything the team did
+    ThreadState& master = m_threads[0];
+    for (int t = 1; t < m_maxThreads; t++) {
+        join(master.clock, m_threads[t].clock);
+        m_threads[t].clock[t]++;
+    }
+    master.clock[0]++;
+}
+
+void HappensBeforeDetector::barrier() {
+    int thread;
+    ThreadState* state = currentThread(thread);
+    if (!state) {
+        #pragma omp barrier
+        return;
+    }
+    if (m_recorder) {
+        m_recorder->barrier(thread);
+        return;
+    }
+
+    const uint64_t generation = state->barriers++;
+    std::vector<Clock>& slot = m_barrierClocks[generation % 3];
+    {
+        std::lock_guard<std::mutex> lock(m_syncMutex);
+        join(slot, state->clock);
+        // Everyone has left the barrier two generations back
+        if (thread == 0) {
+            auto& stale = m_barrierClocks[(generation + 1) % 3];
+            std::fill(stale.begin(), stale.end(), 0);
+        }
+    }
+
+    #pragma omp barrier
+
+    {
+        std::lock_guard<std::mutex> lock(m_syncMutex);
+        join(state->clock, slot);
+    }
+    state->clock[thread]++;
+}
+
+void HappensBeforeDetector::acquire(const void* sync) {
+    int thread;
+    ThreadState* state = currentThread(thread);
+    if (!state) {
+        return;
+    }
+    if (m_recorder) {
+        m_recorder->acquire(thread, sync);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_syncMutex);
+    auto it = m_syncClocks.find(sync);
+    if (it != m_syncClocks.end()) {
+        join(state->clock, it->second);
+    }
+}
+
+void HappensBeforeDetector::release(const void* sync) {
+    int thread;
+    ThreadState* state = currentThread(thread);
+    if (!state) {
+        return;
+    }
+    if (m_recorder) {
+        m_recorder->release(thread, sync);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_syncMutex);
+        m_syncClocks[sync] = state->clock;
+    }
+    state->clock[thread]++;
+}
+
+void HappensBeforeDetector::reportRace(Shard& shard, ShadowWord& shadow, uintptr_t word, HBRaceKind kind,
+                                       int firstThread, uint32_t firstLocation,
+                                       int secondThread, uint32_t secondLocation) {
+    if (shadow.reported) {
+        return;
+    }
+    shadow.reported = true;
+    shard.raceCount++;
+    if (shard.races.size() < kMaxRacesPerShard) {
+        shard.races.push_back({word * 8, kind, firstThread, secondThread, firstLocation, secondLocation});
+    }
+}
+
+void HappensBeforeDetector::read(const void* address, uint32_t location) {
+    int thread;
+    ThreadState* state = currentThread(thread);
+    if (!state) {
+        return;
+    }
+    state->accesses++;
+    if (m_recorder) {
+        m_recorder->read(thread, address, location);
+        return;
+    }
+
+    const std::vector<Clock>& clock = state->clock;
+    const Epoch now = makeEpoch(thread, clock[thread]);
+    const uintptr_t word = reinterpret_cast<uintptr_t>(address) / 8;
+    Shard& shard = shardFor(word);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    ShadowWord& shadow = shard.words[word];
+
+    // Same epoch: already checked
+    if (shadow.read == now) {
+        return;
+    }
+
+    if (shadow.write != 0 && !happensBefore(shadow.write, clock)) {
+        reportRace(shard, shadow, word, HBRaceKind::WriteRead,
+                   epochThread(shadow.write), shadow.writeLocation, thread, location);
+    }
+
+    if (shadow.read == kSharedReads) {
+        shadow.readers[thread] = clock[thread];
+    } else if (shadow.read == 0 || epochThread(shadow.read) == thread || happensBefore(shadow.read, clock)) {
+        shadow.read = now;
+    } else {
+        // Concurrent readers: keep one clock per thread until the next write
+        shadow.readers.reset(new Clock[m_maxThreads]());
+        shadow.readers[epochThread(shadow.read)] = epochClock(shadow.read);
+        shadow.readers[thread] = clock[thread];
+        shadow.read = kSharedReads;
+    }
+    shadow.readLocation = location;
+}
+
+void HappensBeforeDetector::write(const void* address, uint32_t location) {
+    int thread;
+    ThreadState* state = currentThread(thread);
+    if (!state) {
+        return;
+    }
+    state->accesses++;
+    if (m_recorder) {
+        m_recorder->write(thread, address, location);
+        return;
+    }
+
+    const std::vector<Clock>& clock = state->clock;
+    const Epoch now = makeEpoch(thread, clock[thread]);
+    const uintptr_t word = reinterpret_cast<uintptr_t>(address) / 8;
+    Shard& shard = shardFor(word);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    ShadowWord& shadow = shard.words[word];
+
+    // Same epoch: already checked
+    if (shadow.write == now) {
+        return;
+    }
+
+    if (shadow.write != 0 && !happensBefore(shadow.write, clock)) {
+        reportRace(shard, shadow, word, HBRaceKind::WriteWrite,
+                   epochThread(shadow.write), shadow.writeLocation, thread, location);
+    }
+
+    if (shadow.read == kSharedReads) {
+        for (int u = 0; u < m_maxThreads; u++) {
+            if (u != thread && shadow.readers[u] > clock[u]) {
+                reportRace(shard, shadow, word, HBRaceKind::ReadWrite, u, shadow.readLocation, thread, location);
+                break;
+            }
+        }
+        // Every read is now ordered before this write or reported
+        shadow.readers.reset();
+        shadow.read = 0;
+    } else if (shadow.read != 0 && !happensBefore(shadow.read, clock)) {
+        reportRace(shard, shadow, word, HBRaceKind::ReadWrite,
+                   epochThread(shadow.read), shadow.readLocation, thread, location);
+    }
+
+    shadow.write = now;
+    shadow.writeLocation = location;
+}
+
+std::vector<HBRace> HappensBeforeDetector::races() const {
+    std::vector<HBRace> result;
+    for (size_t s = 0; s < kShards; s++) {
+        std::lock_guard<std::mutex> lock(m_shards[s].mutex);
+        result.insert(result.end(), m_shards[s].races.begin(), m_shards[s].races.end());
+    }
+    std::sort(result.begin(), result.end(), [](const HBRace& a, const HBRace& b) {
+        return a.address < b.address;
+    });
+    return result;
+}
+
+uint64_t HappensBeforeDetector::raceCount() const {
+    uint64_t total = 0;
+    for (size_t s = 0; s < kShards; s++) {
+        std::lock_guard<std::mutex> lock(m_shards[s].mutex);
+        total += m_shards[s].raceCount;
+    }
+    return total;
+}
+
+uint64_t HappensBeforeDetector::accessCount() const {
+    uint64_t total = 0;
+    for (const auto& state : m_threads) {
+        total += state.accesses;
+    }
+    return total;
+}
+
+uint64_t HappensBeforeDetector::shadowWords() const {
+    uint64_t total = 0;
+    for (size_t s = 0; s < kShards; s++) {
+        std::lock_guard<std::mutex> lock(m_shards[s].mutex);
+        total += m_shards[s].words.size();
+    }
+    return total;
+}
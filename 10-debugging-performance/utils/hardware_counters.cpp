@@ -0,0 +1,226 @@
+#include "../include/hardware_counters.h"
+
+#ifdef __linux__
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+
+namespace {
+
+enum CounterSlot { Cycles, Instructions, LlcMisses, BranchMisses, DtlbMisses, SlotCount };
+
+uint64_t cacheMissConfig(uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+int openCounter(uint32_t type, uint64_t config, int groupFd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID |
+                       PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // This thread, any CPU
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+
+// The perf_event group of one thread
+struct ThreadGroup {
+    int fds[SlotCount];
+    uint64_t ids[SlotCount];
+    int members = 0;
+
+    ThreadGroup() {
+        std::fill(fds, fds + SlotCount, -1);
+        std::fill(ids, ids + SlotCount, 0);
+    }
+
+    bool open(std::string& error) {
+        const struct { uint32_t type; uint64_t config; } events[SlotCount] = {
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HW_CACHE, cacheMissConfig(PERF_COUNT_HW_CACHE_LL)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_HW_CACHE, cacheMissConfig(PERF_COUNT_HW_CACHE_DTLB)},
+        };
+        for (int slot = 0; slot < SlotCount; slot++) {
+            fds[slot] = openCounter(events[slot].type, events[slot].config, slot == 0 ? -1 : fds[0]);
+            if (fds[slot] < 0) {
+                if (slot == Cycles) {
+                    error = std::string("perf_event_open(cycles) failed: ") + std::strerror(errno);
+                    if (errno == EACCES || errno == EPERM) {
+                        error += " (check /proc/sys/kernel/perf_event_paranoid)";
+                    } else if (errno == ENOENT || errno == EOPNOTSUPP) {
+                        error += " (no hardware PMU, e.g. inside a VM)";
+                    }
+                    return false;
+                }
+                continue;   // Unsupported member: reads as zero
+            }
+            ioctl(fds[slot], PERF_EVENT_IOC_ID, &ids[slot]);
+            members++;
+        }
+        return true;
+    }
+
+    void close() {
+        for (int& fd : fds) {
+            if (fd >= 0) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+    }
+
+    CounterSample read() const {
+        CounterSample sample;
+        // nr, time_enabled, time_running, then {value, id} per member
+        uint64_t buffer[3 + 2 * SlotCount];
+        if (fds[0] < 0 || ::read(fds[0], buffer, sizeof(buffer)) <= 0) {
+            return sample;
+        }
+        const uint64_t count = std::min<uint64_t>(buffer[0], SlotCount);
+        const uint64_t enabled = buffer[1];
+        const uint64_t running = buffer[2];
+        const double scale = running > 0 && running < enabled ? static_cast<double>(enabled) / running : 1.0;
+
+        uint64_t values[SlotCount] = {0, 0, 0, 0, 0};
+        for (uint64_t i = 0; i < count; i++) {
+            const uint64_t value = buffer[3 + 2 * i];
+            const uint64_t id = buffer[4 + 2 * i];
+            for (int slot = 0; slot < SlotCount; slot++) {
+                if (fds[slot] >= 0 && ids[slot] == id) {
+                    values[slot] = static_cast<uint64_t>(value * scale);
+                }
+            }
+        }
+        sample.cycles = values[Cycles];
+        sample.instructions = values[Instructions];
+        sample.llcMisses = values[LlcMisses];
+        sample.branchMisses = values[BranchMisses];
+        sample.dtlbMisses = values[DtlbMisses];
+        sample.valid = running > 0;
+        return sample;
+    }
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<ThreadGroup*> live;
+    CounterSample retired;      // Final counts of exited threads
+    std::string error;
+    bool failed = false;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+// Owns the calling thread's group; folds its counts into the retired total on exit
+struct ThreadSlot {
+    std::unique_ptr<ThreadGroup> group;
+    bool tried = false;
+
+    ~ThreadSlot() {
+        if (!group) {
+            return;
+        }
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.retired += group->read();
+        reg.live.erase(std::remove(reg.live.begin(), reg.live.end(), group.get()), reg.live.end());
+        group->close();
+    }
+};
+
+ThreadGroup* threadGroup() {
+    thread_local ThreadSlot slot;
+    if (!slot.tried) {
+        slot.tried = true;
+        Registry& reg = registry();
+        std::unique_ptr<ThreadGroup> group(new ThreadGroup());
+        std::string error;
+        if (group->open(error)) {
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.live.push_back(group.get());
+            slot.group = std::move(group);
+        } else {
+            group->close();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.failed = true;
+            reg.error = error;
+        }
+    }
+    return slot.group.get();
+}
+
+} // namespace
+
+bool HardwareCounters::isAvailable() {
+    return threadGroup() != nullptr;
+}
+
+std::string HardwareCounters::unavailableReason() {
+    if (isAvailable()) {
+        return "";
+    }
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    return reg.error;
+}
+
+CounterSample HardwareCounters::readThread() {
+    ThreadGroup* group = threadGroup();
+    return group ? group->read() : CounterSample();
+}
+
+CounterSample HardwareCounters::readProcess() {
+    threadGroup();
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    CounterSample total = reg.retired;
+    for (const ThreadGroup* group : reg.live) {
+        total += group->read();
+    }
+    return total;
+}
+
+const char* HardwareCounters::backendName() {
+    return "perf_event";
+}
+
+#else
+
+bool HardwareCounters::isAvailable() {
+    return false;
+}
+
+std::string HardwareCounters::unavailableReason() {
+    return "no hardware counter backend on this platform (perf_event is Linux-only)";
+}
+
+CounterSample HardwareCounters::readThread() {
+    return CounterSample();
+}
+
+CounterSample HardwareCounters::readProcess() {
+    return CounterSample();
+}
+
+const char* HardwareCounters::backendName() {
+    return "none";
+}
+
+#endif
@@ -0,0 +1,414 @@
+#include "../include/memory_probes.h"
+#include "numa_allocator.h"
+#include "../include/cache_padded.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <random>
+#include <limits>
+#include <cmath>
+#include <omp.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr double kMB = 1024.0 * 1024.0;
+constexpr int kKernelCount = 4;
+
+// One STREAM kernel over a static schedule; called by every thread of the team
+template<typename Body>
+void timeKernel(long long n, Body body, Clock::time_point& start, double& seconds) {
+    #pragma omp single
+    start = Clock::now();
+
+    #pragma omp for schedule(static)
+    for (long long i = 0; i < n; i++) {
+        body(i);
+    }
+
+    #pragma omp single
+    seconds = std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// One node of the chase; a whole line so every load touches a new line
+struct alignas(CACHE_LINE_SIZE) ChaseLine {
+    ChaseLine* next;
+};
+
+ChaseLine* volatile g_chaseSink = nullptr;
+
+double median(std::vector<double> values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    size_t mid = values.size() / 2;
+    return values.size() % 2 ? values[mid] : 0.5 * (values[mid - 1] + values[mid]);
+}
+
+std::string formatBytes(size_t bytes) {
+    const bool mega = bytes >= 1024 * 1024;
+    const double value = static_cast<double>(bytes) / (mega ? kMB : 1024.0);
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(value == std::floor(value) ? 0 : 1) << value << (mega ? " MB" : " KB");
+    return text.str();
+}
+
+std::string nodeLabel(int node, const char* unbound) {
+    return node < 0 ? std::string(unbound) : std::to_string(node);
+}
+
+} // namespace
+
+double StreamResult::bandwidth(StreamKernel kernel) const {
+    switch (kernel) {
+        case StreamKernel::Copy: return copyMBps;
+        case StreamKernel::Scale: return scaleMBps;
+        case StreamKernel::Add: return addMBps;
+        case StreamKernel::Triad: return triadMBps;
+    }
+    return 0.0;
+}
+
+double MemoryLimits::triadMBps(int numThreads) const {
+    double best = 0.0;
+    for (const auto& result : threadSweep) {
+        if (result.threads <= numThreads) {
+            best = std::max(best, result.triadMBps);
+        }
+    }
+    return best;
+}
+
+double MemoryLimits::peakTriadMBps() const {
+    double best = 0.0;
+    for (const auto& result : threadSweep) {
+        best = std::max(best, result.triadMBps);
+    }
+    return best;
+}
+
+double MemoryLimits::dramLatencyNs() const {
+    if (!latencyLevels.empty() && latencyLevels.back().name == "DRAM") {
+        return latencyLevels.back().nsPerLoad;
+    }
+    return 0.0;
+}
+
+const char* MemoryProbes::kernelName(StreamKernel kernel) {
+    switch (kernel) {
+        case StreamKernel::Copy: return "Copy";
+        case StreamKernel::Scale: return "Scale";
+        case StreamKernel::Add: return "Add";
+        case StreamKernel::Triad: return "Triad";
+    }
+    return "Unknown";
+}
+
+StreamResult MemoryProbes::runStream(size_t arrayBytes, int numThreads, int trials, int cpuNode, int memNode) {
+    StreamResult result;
+    result.threads = std::max(numThreads, 1);
+    result.cpuNode = cpuNode;
+    result.memNode = memNode;
+
+    const size_t n = std::max<size_t>(arrayBytes / sizeof(double), 1);
+    result.arrayBytes = n * sizeof(double);
+    trials = std::max(trials, 1);
+
+    // Node placement binds the pages up front; otherwise the first touch below places them
+    NumaAllocator allocator;
+    const NumaPolicy policy = memNode >= 0 ? NumaPolicy::Node : NumaPolicy::FirstTouch;
+    const int node = std::max(memNode, 0);
+    double* a = static_cast<double*>(allocator.allocate(result.arrayBytes, policy, node));
+    double* b = static_cast<double*>(allocator.allocate(result.arrayBytes, policy, node));
+    double* c = static_cast<double*>(allocator.allocate(result.arrayBytes, policy, node));
+    if (a == nullptr || b == nullptr || c == nullptr) {
+        std::cerr << "STREAM: allocation of 3 x " << formatBytes(result.arrayBytes) << " failed" << std::endl;
+        allocator.deallocate(a, result.arrayBytes);
+        allocator.deallocate(b, result.arrayBytes);
+        allocator.deallocate(c, result.arrayBytes);
+        return result;
+    }
+
+    const long long count = static_cast<long long>(n);
+    const double scalar = 3.0;
+    double best[kKernelCount];
+    std::fill(best, best + kKernelCount, std::numeric_limits<double>::max());
+    double seconds[kKernelCount] = {};
+    Clock::time_point start;
+
+    #pragma omp parallel num_threads(result.threads)
+    {
+        ScopedNodeAffinity affinity(cpuNode);
+
+        // Each thread first touches the indices it streams later
+        #pragma omp for schedule(static)
+        for (long long i = 0; i < count; i++) {
+            a[i] = 1.0;
+            b[i] = 2.0;
+            c[i] = 0.0;
+        }
+
+        // Trial 0 warms up and is not counted
+        for (int trial = 0; trial <= trials; trial++) {
+            timeKernel(count, [=](long long i) { c[i] = a[i]; }, start, seconds[0]);
+            timeKernel(count, [=](long long i) { b[i] = scalar * c[i]; }, start, seconds[1]);
+            timeKernel(count, [=](long long i) { c[i] = a[i] + b[i]; }, start, seconds[2]);
+            timeKernel(count, [=](long long i) { a[i] = b[i] + scalar * c[i]; }, start, seconds[3]);
+
+            #pragma omp single
+            if (trial > 0) {
+                for (int k = 0; k < kKernelCount; k++) {
+                    best[k] = std::min(best[k], seconds[k]);
+                }
+            }
+        }
+    }
+
+    const double bytes2 = 2.0 * result.arrayBytes;
+    const double bytes3 = 3.0 * result.arrayBytes;
+    result.copyMBps = bytes2 / kMB / best[0];
+    result.scaleMBps = bytes2 / kMB / best[1];
+    result.addMBps = bytes3 / kMB / best[2];
+    result.triadMBps = bytes3 / kMB / best[3];
+
+    allocator.deallocate(a, result.arrayBytes);
+    allocator.deallocate(b, result.arrayBytes);
+    allocator.deallocate(c, result.arrayBytes);
+    return result;
+}
+
+std::vector<StreamResult> MemoryProbes::sweepThreads(size_t arrayBytes, int maxThreads, int trials) {
+    std::vector<StreamResult> results;
+    maxThreads = std::max(maxThreads, 1);
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        results.push_back(runStream(arrayBytes, threads, trials));
+    }
+    results.push_back(runStream(arrayBytes, maxThreads, trials));
+    return results;
+}
+
+std::vector<StreamResult> MemoryProbes::sweepNodePairs(size_t arrayBytes, int numThreads, int trials) {
+    std::vector<StreamResult> results;
+    NumaAllocator allocator;
+    const std::vector<int>& nodes = allocator.getNodes();
+    if (nodes.size() < 2) {
+        return results;
+    }
+    for (int cpuNode : nodes) {
+        for (int memNode : nodes) {
+            results.push_back(runStream(arrayBytes, numThreads, trials, cpuNode, memNode));
+        }
+    }
+    return results;
+}
+
+std::vector<LatencyPoint> MemoryProbes::pointerChase(size_t minBytes, size_t maxBytes, int pointsPerOctave) {
+    std::vector<LatencyPoint> curve;
+    const size_t lineBytes = sizeof(ChaseLine);
+    minBytes = std::max(minBytes, 2 * lineBytes);
+    maxBytes = std::max(maxBytes, minBytes);
+    pointsPerOctave = std::max(pointsPerOctave, 1);
+
+    std::vector<ChaseLine> lines(maxBytes / lineBytes);
+    std::vector<size_t> order;
+    std::mt19937_64 rng(42);
+    // Enough loads that the timer resolution and loop setup do not matter
+    const size_t minLoads = size_t(1) << 21;
+
+    for (int step = 0;; step++) {
+        const double scale = std::pow(2.0, static_cast<double>(step) / pointsPerOctave);
+        const size_t count = static_cast<size_t>(minBytes * scale) / lineBytes;
+        if (count * lineBytes > maxBytes) {
+            break;
+        }
+        if (!curve.empty() && count * lineBytes == curve.back().workingSetBytes) {
+            continue;
+        }
+
+        // Sattolo's shuffle: one cycle through every line, in random order
+        order.resize(count);
+        std::iota(order.begin(), order.end(), size_t(0));
+        for (size_t i = count - 1; i > 0; i--) {
+            std::swap(order[i], order[rng() % i]);
+        }
+        for (size_t i = 0; i < count; i++) {
+            lines[i].next = &lines[order[i]];
+        }
+
+        const size_t loads = std::max(count, minLoads);
+        ChaseLine* p = &lines[0];
+        for (size_t i = 0; i < std::min(count, loads); i++) {
+            p = p->next;
+        }
+
+        auto begin = Clock::now();
+        for (size_t i = 0; i < loads; i++) {
+            p = p->next;
+        }
+        auto end = Clock::now();
+
+        // Keep the chain observable so the loop is not removed
+        g_chaseSink = p;
+
+        LatencyPoint point;
+        point.workingSetBytes = count * lineBytes;
+        point.nsPerLoad = std::chrono::duration<double, std::nano>(end - begin).count() / loads;
+        curve.push_back(point);
+    }
+    return curve;
+}
+
+std::vector<LatencyLevel> MemoryProbes::findLevels(const std::vector<LatencyPoint>& curve, double jumpRatio) {
+    // Group neighbouring sizes whose latency stays within jumpRatio of the group's first point
+    std::vector<std::vector<const LatencyPoint*>> plateaus;
+    for (const auto& point : curve) {
+        if (plateaus.empty() || point.nsPerLoad > jumpRatio * plateaus.back().front()->nsPerLoad) {
+            plateaus.emplace_back();
+        }
+        plateaus.back().push_back(&point);
+    }
+
+    // A single point between two plateaus is the transition, not a level
+    std::vector<LatencyLevel> levels;
+    for (size_t i = 0; i < plateaus.size(); i++) {
+        const bool inner = i > 0 && i + 1 < plateaus.size();
+        if (inner && plateaus[i].size() < 2) {
+            continue;
+        }
+        std::vector<double> latencies;
+        for (const LatencyPoint* point : plateaus[i]) {
+            latencies.push_back(point->nsPerLoad);
+        }
+        LatencyLevel level;
+        level.upToBytes = plateaus[i].back()->workingSetBytes;
+        level.nsPerLoad = median(latencies);
+        level.name = "L" + std::to_string(levels.size() + 1);
+        levels.push_back(level);
+    }
+
+    // The last plateau is DRAM if the curve went past the last-level cache
+    if (levels.size() >= 2) {
+        const size_t llc = lastLevelCacheBytes();
+        if (llc == 0 || levels.back().upToBytes > llc) {
+            levels.back().name = "DRAM";
+        }
+    }
+    return levels;
+}
+
+MemoryLimits MemoryProbes::measure(size_t arrayBytes, int maxThreads, bool verbose) {
+    MemoryLimits limits;
+
+    const size_t llc = lastLevelCacheBytes();
+    if (llc > 0 && arrayBytes < 4 * llc) {
+        std::cout << "Note: STREAM arrays of " << formatBytes(arrayBytes) << " are less than 4x the "
+                  << formatBytes(llc) << " last-level cache; bandwidths will include cache hits" << std::endl;
+    }
+
+    if (verbose) {
+        std::cout << "Measuring STREAM bandwidth for 1.." << maxThreads << " threads..." << std::endl;
+    }
+    limits.threadSweep = sweepThreads(arrayBytes, maxThreads);
+
+    if (verbose) {
+        std::cout << "Measuring STREAM bandwidth per NUMA node pairing..." << std::endl;
+    }
+    limits.nodePairs = sweepNodePairs(arrayBytes, maxThreads);
+
+    if (verbose) {
+        std::cout << "Measuring dependent-load latency up to " << formatBytes(arrayBytes) << "..." << std::endl;
+    }
+    limits.latencyCurve = pointerChase(4 * 1024, arrayBytes);
+    limits.latencyLevels = findLevels(limits.latencyCurve);
+    return limits;
+}
+
+void MemoryProbes::printLimits(const MemoryLimits& limits) {
+    auto printStreamTable = [](const std::vector<StreamResult>& results) {
+        std::cout << std::right << std::setw(8) << "Threads"
+                  << std::setw(10) << "CPU node"
+                  << std::setw(10) << "Mem node"
+                  << std::setw(14) << "Copy (MB/s)"
+                  << std::setw(14) << "Scale (MB/s)"
+                  << std::setw(14) << "Add (MB/s)"
+                  << std::setw(14) << "Triad (MB/s)" << std::endl;
+        std::cout << std::string(84, '-') << std::endl;
+        for (const auto& result : results) {
+            std::cout << std::right << std::setw(8) << result.threads
+                      << std::setw(10) << nodeLabel(result.cpuNode, "any")
+                      << std::setw(10) << nodeLabel(result.memNode, "local")
+                      << std::fixed << std::setprecision(0)
+                      << std::setw(14) << result.copyMBps
+                      << std::setw(14) << result.scaleMBps
+                      << std::setw(14) << result.addMBps
+                      << std::setw(14) << result.triadMBps << std::endl;
+        }
+    };
+
+    std::cout << "=== STREAM Bandwidth (best trial, first-touch placement) ===" << std::endl;
+    if (!limits.threadSweep.empty()) {
+        std::cout << "Array size: " << formatBytes(limits.threadSweep.front().arrayBytes) << " x 3" << std::endl;
+    }
+    printStreamTable(limits.threadSweep);
+
+    if (!limits.nodePairs.empty()) {
+        std::cout << std::endl << "=== STREAM Bandwidth per NUMA Node Pairing ===" << std::endl;
+        printStreamTable(limits.nodePairs);
+    }
+
+    std::cout << std::endl << "=== Dependent-Load Latency (pointer chase) ===" << std::endl;
+    std::cout << std::right << std::setw(14) << "Working set" << std::setw(14) << "ns/load" << std::endl;
+    std::cout << std::string(28, '-') << std::endl;
+    for (const auto& point : limits.latencyCurve) {
+        std::cout << std::right << std::setw(14) << formatBytes(point.workingSetBytes)
+                  << std::setw(14) << std::fixed << std::setprecision(2) << point.nsPerLoad << std::endl;
+    }
+
+    std::cout << std::endl << "Latency levels:";
+    for (const auto& level : limits.latencyLevels) {
+        std::cout << "  " << level.name << " " << std::fixed << std::setprecision(1) << level.nsPerLoad
+                  << " ns (to " << formatBytes(level.upToBytes) << ")";
+    }
+    std::cout << std::endl;
+}
+
+size_t MemoryProbes::lastLevelCacheBytes() {
+#ifdef _WIN32
+    DWORD length = 0;
+    GetLogicalProcessorInformation(nullptr, &length);
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    if (info.empty() || !GetLogicalProcessorInformation(info.data(), &length)) {
+        return 0;
+    }
+    size_t size = 0;
+    BYTE level = 0;
+    for (const auto& entry : info) {
+        if (entry.Relationship == RelationCache && entry.Cache.Level >= level) {
+            level = entry.Cache.Level;
+            size = entry.Cache.Size;
+        }
+    }
+    return size;
+#else
+#if defined(_SC_LEVEL3_CACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE)
+    for (int name : {_SC_LEVEL3_CACHE_SIZE, _SC_LEVEL2_CACHE_SIZE}) {
+        long size = sysconf(name);
+        if (size > 0) {
+            return static_cast<size_t>(size);
+        }
+    }
+#endif
+    return 0;
+#endif
+}
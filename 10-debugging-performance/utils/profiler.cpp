@@ -5,71 +5,453 @@
 #include <algorithm>
 #include <numeric>
 #include <sstream>
+#include <cmath>
 #include <thread>
 #include <map>
+#include <functional>
+#include <limits>
+
+namespace {
+
+// Interned section names; IDs index into names, which never moves its strings
+struct SectionRegistry {
+    std::mutex mutex;
+    std::deque<std::string> names;
+    std::unordered_map<std::string, Profiler::SectionId> ids;
+};
+
+SectionRegistry& sectionRegistry() {
+    static SectionRegistry registry;
+    return registry;
+}
+
+// Initial events per thread buffer, so short runs never reallocate
+const size_t kInitialEventCapacity = 4096;
+
+const Profiler::Clock::time_point kNotEnded{};
+
+// Folded stacks separate frames with ';' and end with " count"
+std::string foldedFrame(const std::string& name) {
+    std::string frame = name;
+    std::replace(frame.begin(), frame.end(), ';', ':');
+    std::replace(frame.begin(), frame.end(), '\n', ' ');
+    return frame;
+}
+
+// Thread time of a path and every path below it: its width in a flame graph
+double subtreeTime(const Profiler::CallPathNode& node) {
+    double time = node.exclusive;
+    for (const auto& child : node.children) {
+        time += subtreeTime(child);
+    }
+    return time;
+}
+
+void printCallPath(const Profiler::CallPathNode& node, int depth, double total, double minPercent) {
+    const double percent = total > 0.0 ? 100.0 * subtreeTime(node) / total : 0.0;
+    if (percent < minPercent) {
+        return;
+    }
+    std::string label = std::string(2 * depth, ' ') + node.name;
+    if (label.size() > 40) {
+        label = label.substr(0, 37) + "...";
+    }
+    std::cout << std::left << std::setw(40) << label
+              << std::right << std::setw(10) << node.calls
+              << std::right << std::setw(15) << std::fixed << std::setprecision(3) << node.inclusive
+              << std::right << std::setw(15) << std::fixed << std::setprecision(3) << node.exclusive
+              << std::right << std::setw(9) << std::fixed << std::setprecision(1) << percent << "%"
+              << std::endl;
+    for (const auto& child : node.children) {
+        printCallPath(child, depth + 1, total, minPercent);
+    }
+}
+
+} // namespace
+
+// Path 0 is the root; every other path extends its parent by one section
+struct Profiler::CallPaths {
+    struct Path {
+        int parent;
+        SectionId section;
+    };
+
+    struct Stats {
+        int calls = 0;
+        double inclusive = 0.0;
+        double exclusive = 0.0;
+    };
+
+    std::vector<Path> paths;
+    std::vector<std::vector<Stats>> threads;    // Per thread buffer, indexed by path
+
+    std::vector<Stats> merged(int thread) const {
+        std::vector<Stats> total(paths.size());
+        for (size_t b = 0; b < threads.size(); b++) {
+            if (thread >= 0 && static_cast<size_t>(thread) != b) {
+                continue;
+            }
+            for (size_t path = 0; path < paths.size(); path++) {
+                total[path].calls += threads[b][path].calls;
+                total[path].inclusive += threads[b][path].inclusive;
+                total[path].exclusive += threads[b][path].exclusive;
+            }
+        }
+        return total;
+    }
+
+    std::string folded(int path) const {
+        std::string stack;
+        for (; path > 0; path = paths[path].parent) {
+            stack = stack.empty() ? foldedFrame(Profiler::sectionName(paths[path].section))
+                                  : foldedFrame(Profiler::sectionName(paths[path].section)) + ";" + stack;
+        }
+        return stack;
+    }
+};
 
 Profiler& Profiler::getInstance() {
     static Profiler instance;
     return instance;
 }
 
-Profiler::Profiler() : m_nextId(0), m_enabled(true) {
+Profiler::Profiler() : m_enabled(true), m_countersEnabled(false), m_probeOverheadNs(-1.0) {
 }
 
 Profiler::~Profiler() {
 }
 
-int Profiler::startSection(const std::string& name) {
-    if (!m_enabled) {
-        return -1;
+Profiler::SectionId Profiler::internSection(const std::string& name) {
+    SectionRegistry& registry = sectionRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto it = registry.ids.find(name);
+    if (it != registry.ids.end()) {
+        return it->second;
     }
+    SectionId id = static_cast<SectionId>(registry.names.size());
+    registry.names.push_back(name);
+    registry.ids.emplace(name, id);
+    return id;
+}
 
-    int id = -1;
-    {
+const std::string& Profiler::sectionName(SectionId id) {
+    SectionRegistry& registry = sectionRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return registry.names.at(static_cast<size_t>(id));
+}
+
+Profiler::ThreadBuffer& Profiler::localBuffer() {
+    // Registered once per thread; the profiler owns it so results outlive the thread
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        std::unique_ptr<ThreadBuffer> created(new ThreadBuffer());
+        created->events.reserve(kInitialEventCapacity);
+        buffer = created.get();
         std::lock_guard<std::mutex> lock(m_mutex);
-        id = m_nextId++;
-        
-        ProfilePoint point;
-        point.name = name;
-        point.startTime = std::chrono::high_resolution_clock::now();
-        point.threadId = omp_get_thread_num();
-        point.level = omp_in_parallel() ? 1 : 0;  // Simplified level tracking
-        
-        m_profilePoints.push_back(point);
-        m_activePoints[point.threadId] = id;
+        m_buffers.push_back(std::move(created));
     }
-    
-    return id;
+    return *buffer;
+}
+
+int Profiler::startSection(SectionId id) {
+    if (!m_enabled.load(std::memory_order_relaxed)) {
+        return -1;
+    }
+
+    ThreadBuffer& buffer = localBuffer();
+    Event event;
+    event.section = id;
+    event.threadId = omp_get_thread_num();
+    event.level = buffer.depth++;
+    event.ompLevel = omp_get_level();
+    event.forkThread = (event.level == 0 && event.ompLevel > 0) ? omp_get_ancestor_thread_num(event.ompLevel - 1) : -1;
+    if (m_countersEnabled.load(std::memory_order_relaxed)) {
+        event.counters = HardwareCounters::readThread();
+    }
+    event.startTime = Clock::now();
+    buffer.events.push_back(event);
+    return static_cast<int>(buffer.events.size()) - 1;
+}
+
+int Profiler::startSection(const std::string& name) {
+    if (!m_enabled.load(std::memory_order_relaxed)) {
+        return -1;
+    }
+    return startSection(internSection(name));
 }
 
 void Profiler::endSection(int id) {
-    if (!m_enabled || id < 0) {
+    if (id < 0) {
         return;
     }
 
-    auto endTime = std::chrono::high_resolution_clock::now();
+    auto endTime = Clock::now();
+    ThreadBuffer& buffer = localBuffer();
+    // A reset since the start leaves nothing to close
+    if (id < static_cast<int>(buffer.events.size()) && buffer.events[id].endTime == kNotEnded) {
+        Event& event = buffer.events[id];
+        event.endTime = endTime;
+        if (event.counters.valid) {
+            event.counters = HardwareCounters::readThread() - event.counters;
+        }
+        buffer.depth--;
+    }
+}
+
+void Profiler::startEvent(const std::string& name, int threadId) {
+    (void)threadId;  // Events are kept per calling thread
+    SectionId section = internSection(name);
+    int token = startSection(section);
+    if (token >= 0) {
+        localBuffer().openEvents.push_back({section, token});
+    }
+}
 
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        if (id < static_cast<int>(m_profilePoints.size())) {
-            m_profilePoints[id].endTime = endTime;
-            
-            // Calculate duration in milliseconds
-            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
-                m_profilePoints[id].endTime - m_profilePoints[id].startTime).count() / 1000.0;
-            
-            m_profilePoints[id].duration = duration;
-            
-            // Remove from active points
-            m_activePoints.erase(m_profilePoints[id].threadId);
+void Profiler::endEvent(const std::string& name, int threadId, double durationMicros) {
+    (void)threadId;
+    (void)durationMicros;
+    SectionId section = internSection(name);
+    auto& open = localBuffer().openEvents;
+    // Innermost open event with this name
+    for (auto it = open.rbegin(); it != open.rend(); ++it) {
+        if (it->section == section) {
+            endSection(it->token);
+            open.erase(std::next(it).base());
+            return;
         }
     }
 }
 
 const std::vector<Profiler::ProfilePoint>& Profiler::getProfilePoints() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_profilePoints.clear();
+    for (const auto& buffer : m_buffers) {
+        for (const auto& event : buffer->events) {
+            ProfilePoint point;
+            point.name = sectionName(event.section);
+            point.startTime = event.startTime;
+            point.endTime = event.endTime;
+            point.duration = event.endTime == kNotEnded ? 0.0 :
+                std::chrono::duration<double, std::milli>(event.endTime - event.startTime).count();
+            point.threadId = event.threadId;
+            point.level = event.level;
+            // An open event still holds its start reading
+            point.counters = event.endTime == kNotEnded ? CounterSample() : event.counters;
+            m_profilePoints.push_back(point);
+        }
+    }
+    std::sort(m_profilePoints.begin(), m_profilePoints.end(),
+             [](const ProfilePoint& a, const ProfilePoint& b) {
+                 return a.startTime < b.startTime;
+             });
     return m_profilePoints;
 }
 
+void Profiler::buildCallPaths(CallPaths& result) const {
+    struct Ref {
+        size_t buffer;
+        size_t index;
+    };
+    const size_t none = std::numeric_limits<size_t>::max();
+    const Clock::time_point open = Clock::time_point::max();
+    auto endOf = [&](const Event& event) { return event.endTime == kNotEnded ? open : event.endTime; };
+    auto durationOf = [](const Event& event) {
+        return event.endTime == kNotEnded ? 0.0 :
+            std::chrono::duration<double, std::milli>(event.endTime - event.startTime).count();
+    };
+
+    // Callers on the same thread follow from the nesting levels
+    std::vector<std::vector<Ref>> parents(m_buffers.size());
+    std::vector<std::vector<double>> calleeTime(m_buffers.size());
+    std::map<std::pair<int, int>, std::vector<Ref>> byTeamThread;  // (OpenMP level, thread number) -> events
+    std::map<std::pair<int, int>, std::vector<Ref>> forked;        // Outermost events, by the team thread that forked them
+    for (size_t b = 0; b < m_buffers.size(); b++) {
+        const auto& events = m_buffers[b]->events;
+        parents[b].assign(events.size(), {none, none});
+        calleeTime[b].assign(events.size(), 0.0);
+        std::vector<size_t> stack;
+        for (size_t i = 0; i < events.size(); i++) {
+            const Event& event = events[i];
+            stack.resize(std::min(stack.size(), static_cast<size_t>(std::max(event.level, 0))));
+            if (!stack.empty()) {
+                parents[b][i] = {b, stack.back()};
+                calleeTime[b][stack.back()] += durationOf(event);
+            } else if (event.ompLevel > 0) {
+                forked[{event.ompLevel - 1, event.forkThread}].push_back({b, i});
+            }
+            stack.push_back(i);
+            byTeamThread[{event.ompLevel, event.threadId}].push_back({b, i});
+        }
+    }
+
+    // An outermost event in a team belongs under the innermost event its forking thread had open
+    auto startOf = [this](const Ref& ref) { return m_buffers[ref.buffer]->events[ref.index].startTime; };
+    for (auto& [key, children] : forked) {
+        auto candidates = byTeamThread.find(key);
+        if (candidates == byTeamThread.end()) {
+            continue;
+        }
+        std::vector<Ref>& callers = candidates->second;
+        auto byStart = [&](const Ref& a, const Ref& b) { return startOf(a) < startOf(b); };
+        std::sort(callers.begin(), callers.end(), byStart);
+        std::sort(children.begin(), children.end(), byStart);
+
+        std::vector<Ref> active;    // Started callers that had not ended when the current child started
+        size_t next = 0;
+        for (const Ref& child : children) {
+            const Event& event = m_buffers[child.buffer]->events[child.index];
+            for (; next < callers.size() && startOf(callers[next]) <= event.startTime; next++) {
+                active.push_back(callers[next]);
+            }
+            active.erase(std::remove_if(active.begin(), active.end(), [&](const Ref& ref) {
+                return endOf(m_buffers[ref.buffer]->events[ref.index]) < event.startTime;
+            }), active.end());
+            for (auto it = active.rbegin(); it != active.rend(); ++it) {
+                if (it->buffer != child.buffer && endOf(m_buffers[it->buffer]->events[it->index]) >= endOf(event)) {
+                    parents[child.buffer][child.index] = *it;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Intern the path of every event, callers first
+    result.paths.assign(1, {-1, -1});
+    std::map<std::pair<int, SectionId>, int> pathIds;
+    std::vector<std::vector<int>> pathOf(m_buffers.size());
+    for (size_t b = 0; b < m_buffers.size(); b++) {
+        pathOf[b].assign(m_buffers[b]->events.size(), -1);
+    }
+    std::function<int(const Ref&)> resolve = [&](const Ref& ref) -> int {
+        int& path = pathOf[ref.buffer][ref.index];
+        if (path >= 0) {
+            return path;
+        }
+        if (path == -2) {
+            return 0;   // Events starting at the same instant can only form a cycle; cut it at the root
+        }
+        path = -2;
+        const Ref& parent = parents[ref.buffer][ref.index];
+        const int parentPath = parent.buffer == none ? 0 : resolve(parent);
+        const SectionId section = m_buffers[ref.buffer]->events[ref.index].section;
+        auto inserted = pathIds.emplace(std::make_pair(parentPath, section), static_cast<int>(result.paths.size()));
+        if (inserted.second) {
+            result.paths.push_back({parentPath, section});
+        }
+        pathOf[ref.buffer][ref.index] = inserted.first->second;
+        return inserted.first->second;
+    };
+
+    result.threads.assign(m_buffers.size(), {});
+    for (size_t b = 0; b < m_buffers.size(); b++) {
+        for (size_t i = 0; i < m_buffers[b]->events.size(); i++) {
+            resolve({b, i});
+        }
+    }
+    for (size_t b = 0; b < m_buffers.size(); b++) {
+        result.threads[b].assign(result.paths.size(), {});
+        const auto& events = m_buffers[b]->events;
+        for (size_t i = 0; i < events.size(); i++) {
+            if (events[i].endTime == kNotEnded) {
+                continue;
+            }
+            CallPaths::Stats& stats = result.threads[b][pathOf[b][i]];
+            const double duration = durationOf(events[i]);
+            stats.calls++;
+            stats.inclusive += duration;
+            stats.exclusive += std::max(0.0, duration - calleeTime[b][i]);
+        }
+    }
+}
+
+Profiler::CallPathNode Profiler::getCallTree(int thread) const {
+    CallPaths paths;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        buildCallPaths(paths);
+    }
+    const std::vector<CallPaths::Stats> stats = paths.merged(thread);
+
+    std::vector<std::vector<int>> children(paths.paths.size());
+    for (size_t path = 1; path < paths.paths.size(); path++) {
+        children[paths.paths[path].parent].push_back(static_cast<int>(path));
+    }
+
+    // Paths the selected threads never reached are dropped
+    std::function<bool(int, CallPathNode&)> build = [&](int path, CallPathNode& node) {
+        node.name = path == 0 ? "all" : sectionName(paths.paths[path].section);
+        node.calls = stats[path].calls;
+        node.inclusive = stats[path].inclusive;
+        node.exclusive = stats[path].exclusive;
+        for (int child : children[path]) {
+            CallPathNode callee;
+            if (build(child, callee)) {
+                node.children.push_back(std::move(callee));
+            }
+        }
+        std::sort(node.children.begin(), node.children.end(),
+                  [](const CallPathNode& a, const CallPathNode& b) { return a.inclusive > b.inclusive; });
+        return node.calls > 0 || !node.children.empty();
+    };
+
+    CallPathNode root;
+    build(0, root);
+    root.inclusive = subtreeTime(root);
+    return root;
+}
+
+int Profiler::getThreadCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<int>(m_buffers.size());
+}
+
+bool Profiler::saveFoldedStacks(const std::string& filename, bool perThread) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    CallPaths paths;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        buildCallPaths(paths);
+    }
+
+    auto writeStacks = [&](const std::vector<CallPaths::Stats>& stats, const std::string& prefix) {
+        for (size_t path = 1; path < paths.paths.size(); path++) {
+            const long long micros = std::llround(stats[path].exclusive * 1000.0);
+            if (micros > 0) {
+                file << prefix << paths.folded(static_cast<int>(path)) << " " << micros << "\n";
+            }
+        }
+    };
+
+    if (perThread) {
+        for (size_t b = 0; b < paths.threads.size(); b++) {
+            writeStacks(paths.threads[b], "thread " + std::to_string(b) + ";");
+        }
+    } else {
+        writeStacks(paths.merged(-1), "");
+    }
+    return static_cast<bool>(file);
+}
+
+void Profiler::printCallTree(double minPercent) const {
+    const CallPathNode root = getCallTree(-1);
+
+    std::cout << "=== Call Paths ===" << std::endl;
+    std::cout << std::left << std::setw(40) << "Section"
+              << std::right << std::setw(10) << "Calls"
+              << std::right << std::setw(15) << "Incl (ms)"
+              << std::right << std::setw(15) << "Excl (ms)"
+              << std::right << std::setw(10) << "Total %"
+              << std::endl;
+    std::cout << std::string(90, '-') << std::endl;
+    for (const auto& child : root.children) {
+        printCallPath(child, 0, root.inclusive, minPercent);
+    }
+}
+
 bool Profiler::saveToCSV(const std::string& filename) const {
     std::ofstream file(filename);
     if (!file.is_open()) {
@@ -80,8 +462,8 @@ bool Profiler::saveToCSV(const std::string& filename) const {
     file << "Name,Thread,Level,Duration (ms)" << std::endl;
     
     // Write data
-    for (const auto& point : m_profilePoints) {
-        if (point.endTime != std::chrono::high_resolution_clock::time_point()) {
+    for (const auto& point : getProfilePoints()) {
+        if (point.endTime != kNotEnded) {
             file << point.name << ","
                  << point.threadId << ","
                  << point.level << ","
@@ -95,8 +477,36 @@ bool Profiler::saveToCSV(const std::string& filename) const {
 void Profiler::reset() {
     std::lock_guard<std::mutex> lock(m_mutex);
     m_profilePoints.clear();
-    m_activePoints.clear();
-    m_nextId = 0;
+    for (auto& buffer : m_buffers) {
+        buffer->events.clear();
+        buffer->openEvents.clear();
+        buffer->depth = 0;
+    }
+}
+
+double Profiler::measureProbeOverhead(int pairs) {
+    if (pairs <= 0) {
+        return 0.0;
+    }
+    static const SectionId probe = internSection("ProfilerOverheadProbe");
+    const bool wasEnabled = m_enabled.exchange(true);
+    const bool countersWereEnabled = m_countersEnabled.exchange(false);
+
+    ThreadBuffer& buffer = localBuffer();
+    const size_t keep = buffer.events.size();
+    buffer.events.reserve(keep + static_cast<size_t>(pairs));
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < pairs; i++) {
+        endSection(startSection(probe));
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    buffer.events.resize(keep);
+    m_enabled = wasEnabled;
+    m_countersEnabled = countersWereEnabled;
+    m_probeOverheadNs = std::chrono::duration<double, std::nano>(end - begin).count() / pairs;
+    return m_probeOverheadNs;
 }
 
 void Profiler::printSummary(bool sortByTime) const {
@@ -104,10 +514,14 @@ void Profiler::printSummary(bool sortByTime) const {
     
     // Group by name and calculate total and average time
     std::map<std::string, std::vector<double>> timesByName;
+    std::map<std::string, CounterSample> countersByName;
     
-    for (const auto& point : m_profilePoints) {
-        if (point.endTime != std::chrono::high_resolution_clock::time_point()) {
+    for (const auto& point : getProfilePoints()) {
+        if (point.endTime != kNotEnded) {
             timesByName[point.name].push_back(point.duration);
+            if (point.counters.valid) {
+                countersByName[point.name] += point.counters;
+            }
         }
     }
     
@@ -168,6 +582,36 @@ void Profiler::printSummary(bool sortByTime) const {
                   << std::right << std::setw(15) << std::fixed << std::setprecision(3) << entry.maxTime
                   << std::endl;
     }
+
+    // Counter-derived rates per section, from summed counts
+    if (!countersByName.empty()) {
+        std::cout << std::endl;
+        std::cout << std::left << std::setw(30) << "Section"
+                  << std::right << std::setw(10) << "IPC"
+                  << std::right << std::setw(15) << "LLC MPKI"
+                  << std::right << std::setw(15) << "Branch MPKI"
+                  << std::right << std::setw(15) << "dTLB MPKI"
+                  << std::endl;
+        std::cout << std::string(85, '-') << std::endl;
+        for (const auto& entry : summaries) {
+            auto it = countersByName.find(entry.name);
+            if (it == countersByName.end()) {
+                continue;
+            }
+            const CounterSample& c = it->second;
+            std::cout << std::left << std::setw(30) << entry.name
+                      << std::right << std::setw(10) << std::fixed << std::setprecision(2) << c.ipc()
+                      << std::right << std::setw(15) << std::fixed << std::setprecision(2) << c.llcMpki()
+                      << std::right << std::setw(15) << std::fixed << std::setprecision(2) << c.branchMpki()
+                      << std::right << std::setw(15) << std::fixed << std::setprecision(2) << c.dtlbMpki()
+                      << std::endl;
+        }
+    }
+
+    if (m_probeOverheadNs >= 0.0) {
+        std::cout << "Probe overhead: " << std::fixed << std::setprecision(1) << m_probeOverheadNs
+                  << " ns per section (target < 50 ns)" << std::endl;
+    }
 }
 
 void Profiler::setEnabled(bool enabled) {
@@ -178,11 +622,24 @@ bool Profiler::isEnabled() const {
     return m_enabled;
 }
 
+bool Profiler::setHardwareCounters(bool enabled) {
+    m_countersEnabled = enabled && HardwareCounters::isAvailable();
+    return m_countersEnabled;
+}
+
+bool Profiler::hardwareCountersEnabled() const {
+    return m_countersEnabled;
+}
+
 // ScopedProfile implementation
+ScopedProfile::ScopedProfile(Profiler::SectionId id) {
+    m_id = Profiler::getInstance().startSection(id);
+}
+
 ScopedProfile::ScopedProfile(const std::string& name) {
     m_id = Profiler::getInstance().startSection(name);
 }
 
 ScopedProfile::~ScopedProfile() {
     Profiler::getInstance().endSection(m_id);
-}
\ No newline at end of file
+}
@@ -0,0 +1,23 @@
+# Shared clock, repetition policy and benchmark registry (common/include/bench_core.h).
+# Defines the static library bench_core; link it into every target that times work:
+#   target_link_libraries(<target> PRIVATE bench_core)
+# The repetition policy is read from BENCH_WARMUP, BENCH_REPS, BENCH_MAX_REPS,
+# BENCH_MIN_TIME_MS and BENCH_PIN at run time, so no options are needed here.
+# Results go to the JSONL file named by BENCH_RESULTS, tagged with the project
+# name; the bench_dashboard tool merges such files into one HTML page.
+
+if(NOT TARGET bench_core)
+    add_library(bench_core STATIC ${CMAKE_CURRENT_LIST_DIR}/../src/bench_core.cpp)
+    target_include_directories(bench_core PUBLIC ${CMAKE_CURRENT_LIST_DIR}/../include)
+    target_compile_features(bench_core PUBLIC cxx_std_17)
+
+    # OpenMP is only needed inside the library (thread pinning), so its flags
+    # do not leak into modules that set their own OpenMP flags
+    find_package(OpenMP REQUIRED)
+    find_package(Threads REQUIRED)
+    target_link_libraries(bench_core PRIVATE OpenMP::OpenMP_CXX Threads::Threads)
+    target_compile_definitions(bench_core PRIVATE BENCH_MODULE="${PROJECT_NAME}")
+
+    add_executable(bench_dashboard ${CMAKE_CURRENT_LIST_DIR}/../tools/bench_dashboard.cpp)
+    target_link_libraries(bench_dashboard PRIVATE bench_core)
+endif()
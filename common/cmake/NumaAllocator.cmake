@@ -0,0 +1,21 @@
+# NUMA-aware page allocator (common/include/numa_allocator.h): NumaAllocator,
+# NumaBuffer, ParallelFirstTouch and ScopedNodeAffinity. Defines the static
+# library numa_allocator; link it into every target that places memory:
+#   target_link_libraries(<target> PRIVATE numa_allocator)
+# Nodes are read from sysfs (Linux) or the NUMA API (Windows) and binding uses
+# the mbind system call directly, so libnuma is not required.
+
+if(NOT TARGET numa_allocator)
+    add_library(numa_allocator STATIC ${CMAKE_CURRENT_LIST_DIR}/../src/numa_allocator.cpp)
+    target_include_directories(numa_allocator PUBLIC ${CMAKE_CURRENT_LIST_DIR}/../include)
+    target_compile_features(numa_allocator PUBLIC cxx_std_17)
+
+    # ParallelFirstTouch in the header is an OpenMP loop
+    find_package(OpenMP REQUIRED)
+    target_link_libraries(numa_allocator PUBLIC OpenMP::OpenMP_CXX)
+
+    # QueryWorkingSetEx (page placement queries)
+    if(WIN32)
+        target_link_libraries(numa_allocator PUBLIC psapi)
+    endif()
+endif()
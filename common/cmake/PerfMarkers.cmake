@@ -0,0 +1,57 @@
+# Backend of common/include/perf_markers.h for every target defined after
+# this file is included:
+#   -DPERF_MARKERS=OFF       markers compile to nothing (default)
+#   -DPERF_MARKERS=ITT       Intel VTune; set VTUNE_PROFILER_DIR if not found
+#   -DPERF_MARKERS=NVTX      NVIDIA Nsight Systems; needs the CUDA toolkit headers
+#   -DPERF_MARKERS=PROFILER  Profiler of 10-debugging-performance (that module only)
+
+set(PERF_MARKERS "OFF" CACHE STRING "Profiler markers backend: OFF, ITT, NVTX or PROFILER")
+set_property(CACHE PERF_MARKERS PROPERTY STRINGS OFF ITT NVTX PROFILER)
+
+include_directories(${CMAKE_CURRENT_LIST_DIR}/../include)
+
+set(_PERF_MARKERS_PROGRAM_FILES_X86 "ProgramFiles(x86)")
+
+if(PERF_MARKERS STREQUAL "ITT")
+    find_path(ITT_INCLUDE_DIR ittnotify.h
+        HINTS
+            $ENV{VTUNE_PROFILER_DIR}/include
+            "$ENV{${_PERF_MARKERS_PROGRAM_FILES_X86}}/Intel/oneAPI/vtune/latest/include"
+            /opt/intel/oneapi/vtune/latest/include
+    )
+    find_library(ITT_LIBRARY NAMES libittnotify ittnotify
+        HINTS
+            $ENV{VTUNE_PROFILER_DIR}/lib64
+            "$ENV{${_PERF_MARKERS_PROGRAM_FILES_X86}}/Intel/oneAPI/vtune/latest/lib64"
+            /opt/intel/oneapi/vtune/latest/lib64
+    )
+    if(NOT ITT_INCLUDE_DIR OR NOT ITT_LIBRARY)
+        message(FATAL_ERROR "PERF_MARKERS=ITT: ittnotify not found, set VTUNE_PROFILER_DIR")
+    endif()
+    include_directories(${ITT_INCLUDE_DIR})
+    link_libraries(${ITT_LIBRARY} ${CMAKE_DL_LIBS})
+    # Code calling the ITT API directly (intel_vtune.cpp) checks this
+    add_compile_definitions(PERF_MARKERS_ITT INTEL_VTUNE_AVAILABLE)
+elseif(PERF_MARKERS STREQUAL "NVTX")
+    find_path(NVTX_INCLUDE_DIR nvtx3/nvToolsExt.h
+        HINTS
+            $ENV{CUDA_PATH}/include
+            /usr/local/cuda/include
+    )
+    if(NOT NVTX_INCLUDE_DIR)
+        message(FATAL_ERROR "PERF_MARKERS=NVTX: nvtx3/nvToolsExt.h not found, set CUDA_PATH")
+    endif()
+    # NVTX v3 is header-only and loads the tool library at run time
+    include_directories(${NVTX_INCLUDE_DIR})
+    link_libraries(${CMAKE_DL_LIBS})
+    add_compile_definitions(PERF_MARKERS_NVTX)
+elseif(PERF_MARKERS STREQUAL "PROFILER")
+    if(NOT EXISTS ${CMAKE_SOURCE_DIR}/include/profiler.h)
+        message(FATAL_ERROR "PERF_MARKERS=PROFILER is only available in 10-debugging-performance")
+    endif()
+    add_compile_definitions(PERF_MARKERS_PROFILER)
+elseif(NOT PERF_MARKERS STREQUAL "OFF")
+    message(FATAL_ERROR "PERF_MARKERS must be OFF, ITT, NVTX or PROFILER (got ${PERF_MARKERS})")
+endif()
+
+message(STATUS "Profiler markers: ${PERF_MARKERS}")
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <vector>
+
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+/**
+ * @brief Alignment covering AVX-512 registers and a cache line
+ */
+constexpr size_t SIMD_ALIGNMENT = 64;
+
+/**
+ * @brief Size of a transparent huge page on x86-64 Linux
+ */
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+/**
+ * @brief Allocate memory aligned to a power-of-two boundary
+ *
+ * With hugePages, allocations of at least HUGE_PAGE_SIZE bytes are aligned to 2 MB and,
+ * on Linux, advised for transparent huge pages. Windows large pages require the
+ * "Lock pages in memory" privilege, so there the request only raises the alignment.
+ *
+ * @param bytes Number of bytes
+ * @param alignment Boundary in bytes (power of two)
+ * @param hugePages Request huge-page backing for large blocks
+ * @return Pointer to the memory, or nullptr on failure
+ */
+inline void* alignedMemoryAllocate(size_t bytes, size_t alignment, bool hugePages = false) {
+    if (hugePages && bytes >= HUGE_PAGE_SIZE && alignment < HUGE_PAGE_SIZE) {
+        alignment = HUGE_PAGE_SIZE;
+    }
+    if (alignment < sizeof(void*)) {
+        alignment = sizeof(void*);
+    }
+    if (bytes == 0) {
+        bytes = alignment;
+    }
+
+#ifdef _WIN32
+    void* ptr = _aligned_malloc(bytes, alignment);
+#else
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, alignment, bytes) != 0) {
+        return nullptr;
+    }
+#ifdef MADV_HUGEPAGE
+    if (hugePages && alignment >= HUGE_PAGE_SIZE) {
+        // Only whole huge pages inside the block; the hint is best effort
+        madvise(ptr, bytes & ~(HUGE_PAGE_SIZE - 1), MADV_HUGEPAGE);
+    }
+#endif
+#endif
+    return ptr;
+}
+
+/**
+ * @brief Release memory returned by alignedMemoryAllocate
+ * @param ptr Pointer to release (may be nullptr)
+ */
+inline void alignedMemoryFree(void* ptr) {
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+/**
+ * @class AlignedAllocator
+ * @brief Standard-conforming allocator returning Alignment-byte aligned storage
+ *
+ * Stateless, so all instances with the same parameters compare equal and containers
+ * can move and swap buffers freely.
+ *
+ * @tparam T Element type
+ * @tparam Alignment Boundary in bytes (a power of two, e.g. 32 for AVX2, 64 for AVX-512)
+ * @tparam HugePages Back allocations of at least HUGE_PAGE_SIZE with huge pages
+ */
+template<typename T, size_t Alignment = SIMD_ALIGNMENT, bool HugePages = false>
+class AlignedAllocator {
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+    static_assert(Alignment >= alignof(T), "Alignment must not be below the type's own alignment");
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+
+    template<typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment, HugePages>;
+    };
+
+    static constexpr size_t alignment = Alignment;
+
+    AlignedAllocator() noexcept = default;
+
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment, HugePages>&) noexcept {}
+
+    /**
+     * @brief Allocate storage for count elements
+     * @throws std::bad_alloc if the memory cannot be allocated
+     */
+    T* allocate(size_t count) {
+        if (count > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        void* ptr = alignedMemoryAllocate(count * sizeof(T), Alignment, HugePages);
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(ptr);
+    }
+
+    /**
+     * @brief Release storage returned by allocate()
+     */
+    void deallocate(T* ptr, size_t) noexcept {
+        alignedMemoryFree(ptr);
+    }
+};
+
+template<typename T, typename U, size_t Alignment, bool HugePages>
+bool operator==(const AlignedAllocator<T, Alignment, HugePages>&, const AlignedAllocator<U, Alignment, HugePages>&) noexcept {
+    return true;
+}
+
+template<typename T, typename U, size_t Alignment, bool HugePages>
+bool operator!=(const AlignedAllocator<T, Alignment, HugePages>&, const AlignedAllocator<U, Alignment, HugePages>&) noexcept {
+    return false;
+}
+
+/**
+ * @brief std::vector whose data() is Alignment-byte aligned
+ */
+template<typename T, size_t Alignment = SIMD_ALIGNMENT>
+using AlignedVector = std::vector<T, AlignedAllocator<T, Alignment>>;
+
+/**
+ * @brief AlignedVector backed by huge pages once it reaches HUGE_PAGE_SIZE bytes
+ */
+template<typename T, size_t Alignment = SIMD_ALIGNMENT>
+using HugePageVector = std::vector<T, AlignedAllocator<T, Alignment, true>>;
+
+/**
+ * @brief Check whether an address sits on an alignment-byte boundary
+ */
+inline bool isAligned(const void* ptr, size_t alignment) {
+    return (reinterpret_cast<uintptr_t>(ptr) & (alignment - 1)) == 0;
+}
@@ -0,0 +1,363 @@
+#pragma once
+
+/**
+ * @file bench_core.h
+ * @brief Shared clock, timer, repetition policy and benchmark registry
+ *
+ * Every module times its kernels through this library, so numbers taken in
+ * different modules use the same clock, warmup and statistics and can be
+ * compared directly. Build it with common/cmake/BenchCore.cmake and link the
+ * bench_core target.
+ *
+ *   bench::Clock           calibrated invariant TSC, or steady_clock where there is none
+ *   bench::Timer           start/stop timer on that clock
+ *   bench::RunPolicy       warmup runs, repetitions, minimum time and thread pinning
+ *   bench::measure         runs a callable under a policy and returns bench::Stats
+ *   bench::ThreadPinning   pins the OpenMP threads to one CPU each while it lives
+ *   bench::Registry        named benchmarks, run and reported together
+ *   bench::record          appends a bench::Result to the shared JSONL results file
+ *
+ * The default policy can be changed without rebuilding through BENCH_WARMUP,
+ * BENCH_REPS, BENCH_MAX_REPS, BENCH_MIN_TIME_MS and BENCH_PIN (1 to pin).
+ * Results are written only when BENCH_RESULTS names a file; BENCH_RUN_ID
+ * labels the run (e.g. a commit hash) for the history in bench_dashboard.
+ */
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+/**
+ * @class Clock
+ * @brief Monotonic clock with the cheapest read the machine allows
+ *
+ * On x86 with an invariant TSC (constant rate, not stopped in sleep states),
+ * now() is a single rdtsc, calibrated once against steady_clock over about
+ * 20 ms on first use. Elsewhere it reads steady_clock in nanoseconds. Either
+ * way, ticks only have meaning as differences converted by toNanoseconds().
+ */
+class Clock {
+public:
+    using Ticks = uint64_t;
+
+    static Ticks now();
+
+    static double toNanoseconds(Ticks ticks);
+
+    static double toMilliseconds(Ticks ticks) { return toNanoseconds(ticks) * 1e-6; }
+
+    /**
+     * @brief Smallest nonzero difference between two successive reads, in nanoseconds
+     */
+    static double resolutionNanoseconds();
+
+    /**
+     * @brief Clock in use, e.g. "invariant TSC at 2.995 GHz" or "steady_clock"
+     */
+    static std::string description();
+
+    /**
+     * @brief Calibrate now instead of on the first read
+     */
+    static void calibrate();
+};
+
+/**
+ * @class Timer
+ * @brief Start/stop timer on bench::Clock
+ *
+ * elapsed* read the running time while started and the stopped interval
+ * after stop().
+ */
+class Timer {
+public:
+    Timer() = default;
+
+    void start() {
+        m_start = Clock::now();
+        m_running = true;
+    }
+
+    void stop() {
+        m_end = Clock::now();
+        m_running = false;
+    }
+
+    void reset() {
+        m_start = m_end = 0;
+        m_running = false;
+    }
+
+    bool isRunning() const { return m_running; }
+
+    double elapsedNanoseconds() const {
+        const Clock::Ticks end = m_running ? Clock::now() : m_end;
+        return Clock::toNanoseconds(end - m_start);
+    }
+
+    double elapsedMilliseconds() const { return elapsedNanoseconds() * 1e-6; }
+    double elapsedSeconds() const { return elapsedNanoseconds() * 1e-9; }
+
+private:
+    Clock::Ticks m_start = 0;
+    Clock::Ticks m_end = 0;
+    bool m_running = false;
+};
+
+/**
+ * @brief Summary of the timed repetitions of one measurement
+ */
+struct Stats {
+    int repetitions = 0;
+    double meanMs = 0.0;
+    double medianMs = 0.0;
+    double minMs = 0.0;
+    double maxMs = 0.0;
+    double stddevMs = 0.0;      // Sample standard deviation
+
+    /**
+     * @brief Coefficient of variation; above a few percent the machine was not quiet
+     */
+    double cv() const { return meanMs > 0.0 ? stddevMs / meanMs : 0.0; }
+};
+
+/**
+ * @brief Statistics of repetition times in milliseconds
+ */
+Stats summarize(std::vector<double> samplesMs);
+
+/**
+ * @brief How a measurement is repeated
+ *
+ * Warmup runs are not timed. Timed runs continue until at least
+ * minRepetitions have run and together took minTimeMs, or maxRepetitions
+ * have run.
+ */
+struct RunPolicy {
+    int warmup = 1;
+    int minRepetitions = 5;
+    int maxRepetitions = 100;
+    double minTimeMs = 0.0;
+    bool pinThreads = false;
+
+    /**
+     * @brief The defaults, overridden by the BENCH_* environment variables
+     */
+    static RunPolicy fromEnvironment();
+
+    /**
+     * @brief One timed run, no warmup, for kernels that take seconds
+     */
+    static RunPolicy once() {
+        RunPolicy policy = fromEnvironment();
+        policy.warmup = 0;
+        policy.minRepetitions = 1;
+        policy.maxRepetitions = 1;
+        policy.minTimeMs = 0.0;
+        return policy;
+    }
+
+    /**
+     * @brief Exactly the given number of timed runs, with the environment's warmup and pinning
+     */
+    static RunPolicy repetitions(int count) {
+        RunPolicy policy = fromEnvironment();
+        policy.minRepetitions = policy.maxRepetitions = count > 0 ? count : 1;
+        policy.minTimeMs = 0.0;
+        return policy;
+    }
+};
+
+/**
+ * @brief Time body under policy
+ * @param body Runs the work once; called warmup + repetitions times
+ * @param policy Repetition policy (RunPolicy::fromEnvironment() by default)
+ * @param samplesMs If not null, receives the time of every timed run
+ */
+Stats measure(const std::function<void()>& body, const RunPolicy& policy = RunPolicy::fromEnvironment(),
+              std::vector<double>* samplesMs = nullptr);
+
+/**
+ * @class ThreadPinning
+ * @brief Pins the calling thread and the OpenMP thread pool while it lives
+ *
+ * OpenMP thread i of a team of numThreads is pinned to the i-th CPU the
+ * process may run on, modulo the number of those CPUs. The OpenMP runtime
+ * reuses its threads across regions, so the pinning holds for the
+ * following parallel regions of that size. The previous affinity is
+ * restored on destruction. Nothing is changed when OMP_PROC_BIND already
+ * binds threads, or on platforms without an affinity API (macOS).
+ */
+class ThreadPinning {
+public:
+    /**
+     * @param numThreads Team size to pin; 0 for omp_get_max_threads()
+     */
+    explicit ThreadPinning(int numThreads = 0);
+    ~ThreadPinning();
+
+    ThreadPinning(const ThreadPinning&) = delete;
+    ThreadPinning& operator=(const ThreadPinning&) = delete;
+
+    /**
+     * @brief Whether threads were pinned
+     */
+    bool active() const { return m_active; }
+
+    /**
+     * @brief Why threads were not pinned, empty if they were
+     */
+    const std::string& reason() const { return m_reason; }
+
+private:
+    int m_numThreads = 0;
+    bool m_active = false;
+    std::string m_reason;
+    std::vector<std::vector<unsigned char>> m_saved;   // Previous affinity of each team thread, opaque
+};
+
+/**
+ * @brief Result of one registered benchmark
+ */
+struct BenchmarkResult {
+    std::string name;
+    Stats stats;
+    double workPerRun = 0.0;        // Units of work per run, e.g. elements or FLOPs; 0 if none
+    std::string workUnit;
+
+    /**
+     * @brief Work units per second at the median time, 0 if no work was declared
+     */
+    double throughput() const {
+        return workPerRun > 0.0 && stats.medianMs > 0.0 ? workPerRun / (stats.medianMs * 1e-3) : 0.0;
+    }
+};
+
+/**
+ * @class Registry
+ * @brief Named benchmarks of one program, run and reported together
+ *
+ * Benchmarks are added at startup (BENCH_REGISTER) or by the program
+ * itself, then run in registration order with a shared policy, so every
+ * kernel of a module is measured the same way.
+ */
+class Registry {
+public:
+    struct Benchmark {
+        std::string name;
+        std::function<void()> body;
+        double workPerRun;
+        std::string workUnit;
+    };
+
+    static Registry& instance();
+
+    /**
+     * @brief Add a benchmark
+     * @param name Unique name, e.g. "reduction/atomic"
+     * @param body Runs the work once
+     * @param workPerRun Work units per run for throughput, 0 for none
+     * @param workUnit Name of the work unit, e.g. "elements"
+     * @return true, so registration can initialize a static
+     */
+    bool add(const std::string& name, std::function<void()> body,
+             double workPerRun = 0.0, const std::string& workUnit = "");
+
+    const std::vector<Benchmark>& benchmarks() const { return m_benchmarks; }
+
+    /**
+     * @brief Run every benchmark whose name contains filter
+     */
+    std::vector<BenchmarkResult> run(const std::string& filter = "",
+                                     const RunPolicy& policy = RunPolicy::fromEnvironment()) const;
+
+    /**
+     * @brief Print results as a table with the clock and policy used
+     */
+    static void print(const std::vector<BenchmarkResult>& results, const RunPolicy& policy);
+
+    /**
+     * @brief Save results as CSV: name, repetitions, mean, median, min, max, stddev, throughput
+     * @return true if successful
+     */
+    static bool saveCsv(const std::vector<BenchmarkResult>& results, const std::string& filename);
+
+private:
+    std::vector<Benchmark> m_benchmarks;
+};
+
+/**
+ * @brief One measurement in the shared result schema
+ *
+ * Stored as one JSON object per line, so every run of every module appends
+ * to the same file and the file is the history:
+ *
+ *   {"schema":1,"module":"OpenMP_TaskParallelism","benchmark":"fibonacci","variant":"task",
+ *    "size":35,"threads":8,"host":"build01/16cpu","run":"3f2c1e0","timestamp":1760000000,
+ *    "samples":[412.5,409.8],"counters":{"speedup":5.21}}
+ *
+ * samples are milliseconds per run. counters hold derived numbers such as
+ * speedup, GFLOP/s or page faults.
+ */
+struct Result {
+    std::string module;             // Filled in by record()
+    std::string benchmark;
+    std::string variant;            // Implementation or configuration, may be empty
+    long long size = 0;             // Problem size, 0 if not applicable
+    int threads = 0;
+    std::string host;               // Filled in by record()
+    std::string run;                // Filled in by record()
+    long long timestamp = 0;        // Unix seconds, filled in by record()
+    std::vector<double> samplesMs;
+    std::map<std::string, double> counters;
+};
+
+/**
+ * @brief Whether results are being written (BENCH_RESULTS is set)
+ */
+bool recording();
+
+/**
+ * @brief Append result to the BENCH_RESULTS file; does nothing when it is not set
+ *
+ * Fills in module (the CMake project), host, run (BENCH_RUN_ID, or the
+ * process start time) and timestamp. Safe to call from several threads.
+ */
+void record(Result result);
+
+void record(const std::string& benchmark, const std::string& variant, long long size, int threads,
+            const std::vector<double>& samplesMs, const std::map<std::string, double>& counters = {});
+
+/**
+ * @brief Host name and logical CPU count, e.g. "build01/16cpu"
+ */
+std::string hostFingerprint();
+
+/**
+ * @brief One line of the results file
+ */
+std::string toJson(const Result& result);
+
+/**
+ * @brief Parse one line of a results file; unknown keys are skipped
+ * @return false if the line is not a result
+ */
+bool parseResult(const std::string& line, Result& result);
+
+/**
+ * @brief Every result in a results file, in file order; malformed lines are skipped
+ */
+std::vector<Result> loadResults(const std::string& filename);
+
+} // namespace bench
+
+#define BENCH_CONCAT_INNER(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_INNER(a, b)
+
+// Register a benchmark at static initialization: BENCH_REGISTER("name", [] { kernel(); });
+#define BENCH_REGISTER(name, ...) \
+    static const bool BENCH_CONCAT(bench_registered_, __LINE__) = ::bench::Registry::instance().add(name, __VA_ARGS__)
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <omp.h>
+
+/**
+ * @enum NumaPolicy
+ * @brief Where the pages of a NUMA-aware allocation are placed
+ */
+enum class NumaPolicy {
+    Default,    ///< Operating system default; pages land wherever they are first touched
+    Node,       ///< All pages preferred on one NUMA node
+    Interleave, ///< Pages distributed round-robin over all NUMA nodes
+    FirstTouch  ///< No binding; NumaBuffer initializes in parallel with a static schedule
+};
+
+/**
+ * @brief Get a printable name for a placement policy
+ * @param policy Policy to name
+ * @return "default", "node", "interleave" or "firsttouch"
+ */
+const char* NumaPolicyName(NumaPolicy policy);
+
+/**
+ * @brief Parse a placement policy name as printed by NumaPolicyName
+ * @param name Policy name
+ * @param policy Receives the parsed policy
+ * @return true if the name was recognized
+ */
+bool ParseNumaPolicy(const std::string& name, NumaPolicy& policy);
+
+/**
+ * @class NumaAllocator
+ * @brief Page-granular allocator that places memory on the system's NUMA nodes
+ *
+ * Allocations come straight from the operating system (VirtualAlloc/VirtualAllocExNuma on
+ * Windows, mmap/mbind on Linux), so they are page aligned and their pages are not touched
+ * until the caller writes them. When the system has a single node, or explicit binding is
+ * unavailable, every policy degrades to the default first-touch behaviour.
+ */
+class NumaAllocator {
+public:
+    /**
+     * @brief Construct an allocator, detecting the NUMA nodes that own processors
+     */
+    NumaAllocator();
+
+    /**
+     * @brief Allocate page-aligned memory with the given placement
+     * @param bytes Number of bytes to allocate
+     * @param policy Placement policy
+     * @param node NUMA node for NumaPolicy::Node (ignored otherwise)
+     * @return Pointer to the memory, or nullptr on failure
+     */
+    void* allocate(size_t bytes, NumaPolicy policy, int node = 0);
+
+    /**
+     * @brief Release memory returned by allocate()
+     * @param ptr Pointer returned by allocate()
+     * @param bytes Size passed to allocate()
+     */
+    void deallocate(void* ptr, size_t bytes);
+
+    /**
+     * @brief Get the number of NUMA nodes memory can be placed on
+     * @return Number of NUMA nodes (at least 1)
+     */
+    int getNodeCount() const;
+
+    /**
+     * @brief Get the IDs of the NUMA nodes memory can be placed on
+     * @return Node IDs in ascending order (not necessarily contiguous)
+     */
+    const std::vector<int>& getNodes() const;
+
+    /**
+     * @brief Check whether explicit node binding is available on this system
+     * @return true if Node and Interleave placement take effect
+     */
+    bool isBindingSupported() const;
+
+    /**
+     * @brief Get the operating system page size
+     * @return Page size in bytes
+     */
+    size_t getPageSize() const;
+
+    /**
+     * @brief Get the NUMA node currently backing an address
+     * @param address Address inside an allocation
+     * @return NUMA node, or -1 if the page is not resident or the query is unsupported
+     */
+    int getNodeOfAddress(const void* address) const;
+
+    /**
+     * @brief Count the pages of a range resident on each NUMA node
+     * @param ptr Start of the range
+     * @param bytes Length of the range
+     * @param maxSamples Maximum number of pages to query (evenly spaced)
+     * @return Map from NUMA node (-1 for unknown) to sampled page count
+     */
+    std::map<int, size_t> getPagePlacement(const void* ptr, size_t bytes, size_t maxSamples = 1024) const;
+
+    /**
+     * @brief Print the per-node page distribution of a range
+     * @param ptr Start of the range
+     * @param bytes Length of the range
+     * @param label Name printed in front of the distribution
+     */
+    void displayPlacement(const void* ptr, size_t bytes, const std::string& label) const;
+
+private:
+    int m_nodeCount;
+    std::vector<int> m_nodes;       ///< NUMA node IDs that have memory
+    size_t m_pageSize;
+    bool m_bindingSupported;
+    mutable bool m_bindingWarned;
+
+    size_t roundToPages(size_t bytes) const;
+    bool bindRange(void* ptr, size_t bytes, NumaPolicy policy, int node) const;
+};
+
+/**
+ * @class ScopedNodeAffinity
+ * @brief Restricts the calling thread to the processors of one NUMA node for its lifetime
+ *
+ * Used to pair threads on one node with memory on another. The previous affinity is
+ * restored by the destructor. Binding fails (and nothing changes) when the node has no
+ * processors or the platform offers no affinity control.
+ */
+class ScopedNodeAffinity {
+public:
+    /**
+     * @brief Bind the calling thread
+     * @param node NUMA node ID; a negative node leaves the thread unbound
+     */
+    explicit ScopedNodeAffinity(int node);
+    ~ScopedNodeAffinity();
+
+    ScopedNodeAffinity(const ScopedNodeAffinity&) = delete;
+    ScopedNodeAffinity& operator=(const ScopedNodeAffinity&) = delete;
+
+    /**
+     * @brief Check whether the thread is bound to the node
+     */
+    bool isBound() const { return m_bound; }
+
+private:
+    bool m_bound = false;
+    std::vector<unsigned char> m_previous;  ///< Saved platform affinity (cpu_set_t or GROUP_AFFINITY)
+};
+
+/**
+ * @brief Initialize an array in parallel so each page is first touched by the thread that will use it
+ *
+ * Uses schedule(static) over the whole range; consumer loops must use the same thread count
+ * and a static schedule over the same index space for the placement to match.
+ *
+ * @param data Array to initialize
+ * @param count Number of elements
+ * @param value Value written to every element
+ * @param numThreads Team size of the consumer loops
+ */
+template<typename T>
+void ParallelFirstTouch(T* data, size_t count, const T& value, int numThreads = omp_get_max_threads()) {
+    const long long n = static_cast<long long>(count);
+
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
+    for (long long i = 0; i < n; i++) {
+        data[i] = value;
+    }
+}
+
+/**
+ * @class NumaBuffer
+ * @brief Owning array of trivially copyable elements allocated through NumaAllocator
+ *
+ * FirstTouch buffers are initialized with ParallelFirstTouch; the other policies are
+ * initialized by the calling thread, which for Default places the whole buffer on
+ * that thread's node (the usual "master thread initializes" situation).
+ */
+template<typename T>
+class NumaBuffer {
+    static_assert(std::is_trivially_copyable<T>::value, "NumaBuffer holds trivially copyable types only");
+
+public:
+    NumaBuffer() = default;
+
+    /**
+     * @brief Allocate and initialize count elements
+     * @param allocator Allocator that must outlive the buffer
+     * @param count Number of elements
+     * @param policy Placement policy
+     * @param node NUMA node for NumaPolicy::Node
+     * @param value Initial value of every element
+     * @param numThreads Team size used for FirstTouch initialization
+     */
+    NumaBuffer(NumaAllocator& allocator, size_t count, NumaPolicy policy, int node = 0,
+               const T& value = T(), int numThreads = omp_get_max_threads())
+        : m_allocator(&allocator), m_size(count), m_policy(policy) {
+        m_data = static_cast<T*>(allocator.allocate(count * sizeof(T), policy, node));
+        if (m_data == nullptr) {
+            m_size = 0;
+            return;
+        }
+
+        if (policy == NumaPolicy::FirstTouch) {
+            ParallelFirstTouch(m_data, m_size, value, numThreads);
+        } else {
+            std::fill(m_data, m_data + m_size, value);
+        }
+    }
+
+    ~NumaBuffer() {
+        release();
+    }
+
+    NumaBuffer(const NumaBuffer&) = delete;
+    NumaBuffer& operator=(const NumaBuffer&) = delete;
+
+    NumaBuffer(NumaBuffer&& other) noexcept {
+        swap(other);
+    }
+
+    NumaBuffer& operator=(NumaBuffer&& other) noexcept {
+        if (this != &other) {
+            release();
+            swap(other);
+        }
+        return *this;
+    }
+
+    T* data() { return m_data; }
+    const T* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    size_t bytes() const { return m_size * sizeof(T); }
+    bool empty() const { return m_size == 0; }
+    NumaPolicy policy() const { return m_policy; }
+
+    T& operator[](size_t i) { return m_data[i]; }
+    const T& operator[](size_t i) const { return m_data[i]; }
+
+    T* begin() { return m_data; }
+    T* end() { return m_data + m_size; }
+    const T* begin() const { return m_data; }
+    const T* end() const { return m_data + m_size; }
+
+private:
+    NumaAllocator* m_allocator = nullptr;
+    T* m_data = nullptr;
+    size_t m_size = 0;
+    NumaPolicy m_policy = NumaPolicy::Default;
+
+    void swap(NumaBuffer& other) noexcept {
+        std::swap(m_allocator, other.m_allocator);
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        std::swap(m_policy, other.m_policy);
+    }
+
+    void release() {
+        if (m_data != nullptr && m_allocator != nullptr) {
+            m_allocator->deallocate(m_data, m_size * sizeof(T));
+        }
+        m_data = nullptr;
+        m_size = 0;
+    }
+};
@@ -0,0 +1,211 @@
+#pragma once
+
+/**
+ * @file perf_markers.h
+ * @brief Task, frame and counter markers for external profilers
+ *
+ * Kernels are annotated once and the build picks where the markers go:
+ *
+ *   PERF_MARKERS_ITT       Intel ITT API (VTune tasks, frames and counters)
+ *   PERF_MARKERS_NVTX      NVTX v3 (Nsight Systems ranges and marks)
+ *   PERF_MARKERS_PROFILER  Profiler sections of 10-debugging-performance
+ *   none of these          every macro expands to ((void)0)
+ *
+ * With no backend the macros emit no code and do not evaluate their
+ * arguments, so annotations stay in release builds. The CMake option
+ * PERF_MARKERS (common/cmake/PerfMarkers.cmake) defines one of the above.
+ *
+ *   PERF_SCOPE("name")               task covering the rest of the enclosing scope
+ *   PERF_TASK_BEGIN("name")          task start; ...
+ *   PERF_TASK_END()                  ... and end, on the same thread
+ *   PERF_FRAME_BEGIN("name")         frame start, e.g. one benchmark repetition; ...
+ *   PERF_FRAME_END("name")           ... and end, with the same name
+ *   PERF_COUNTER("name", value)      sample of a named counter (converted to double)
+ *
+ * Names must be string literals: each call site resolves its name to a
+ * backend handle once, in a function-local static. Markers cost a call into
+ * the backend, so put them around kernels and phases, not inside inner loops.
+ */
+
+#if (defined(PERF_MARKERS_ITT) + defined(PERF_MARKERS_NVTX) + defined(PERF_MARKERS_PROFILER)) > 1
+#error "Define at most one of PERF_MARKERS_ITT, PERF_MARKERS_NVTX and PERF_MARKERS_PROFILER"
+#endif
+
+#if defined(PERF_MARKERS_ITT) || defined(PERF_MARKERS_NVTX) || defined(PERF_MARKERS_PROFILER)
+#define PERF_MARKERS_ENABLED 1
+#else
+#define PERF_MARKERS_ENABLED 0
+#endif
+
+// Domain that tasks and counters are grouped under in the profiler
+#ifndef PERF_MARKERS_DOMAIN
+#define PERF_MARKERS_DOMAIN "OpenMP"
+#endif
+
+#if PERF_MARKERS_ENABLED
+
+#if defined(PERF_MARKERS_ITT)
+#include <ittnotify.h>
+#elif defined(PERF_MARKERS_NVTX)
+#include <nvtx3/nvToolsExt.h>
+#else
+#include <vector>
+#include "profiler.h"
+#endif
+
+namespace perf_markers {
+
+#if defined(PERF_MARKERS_ITT)
+
+inline __itt_domain* domain() {
+    static __itt_domain* instance = __itt_domain_create(PERF_MARKERS_DOMAIN);
+    return instance;
+}
+
+struct TaskHandle { __itt_string_handle* name; };
+struct FrameHandle { __itt_domain* domain; };      // VTune groups frames by domain
+struct CounterHandle { __itt_counter counter; };
+
+inline TaskHandle makeTask(const char* name) { return { __itt_string_handle_create(name) }; }
+inline void taskBegin(const TaskHandle& task) { __itt_task_begin(domain(), __itt_null, __itt_null, task.name); }
+inline void taskEnd() { __itt_task_end(domain()); }
+
+inline FrameHandle makeFrame(const char* name) { return { __itt_domain_create(name) }; }
+inline void frameBegin(const FrameHandle& frame) { __itt_frame_begin_v3(frame.domain, nullptr); }
+inline void frameEnd(const FrameHandle& frame) { __itt_frame_end_v3(frame.domain, nullptr); }
+
+inline CounterHandle makeCounter(const char* name) {
+    return { __itt_counter_create_typed(name, PERF_MARKERS_DOMAIN, __itt_metadata_double) };
+}
+inline void counterSet(const CounterHandle& counter, double value) { __itt_counter_set_value(counter.counter, &value); }
+
+#elif defined(PERF_MARKERS_NVTX)
+
+inline nvtxDomainHandle_t domain() {
+    static nvtxDomainHandle_t instance = nvtxDomainCreateA(PERF_MARKERS_DOMAIN);
+    return instance;
+}
+
+inline nvtxEventAttributes_t eventAttributes(nvtxStringHandle_t name) {
+    nvtxEventAttributes_t attributes = {};
+    attributes.version = NVTX_VERSION;
+    attributes.size = NVTX_EVENT_ATTRIB_STRUCT_SIZE;
+    attributes.messageType = NVTX_MESSAGE_TYPE_REGISTERED;
+    attributes.message.registered = name;
+    return attributes;
+}
+
+// Nsight has no separate frame track; frames are ranges like tasks
+struct TaskHandle { nvtxStringHandle_t name; };
+using FrameHandle = TaskHandle;
+using CounterHandle = TaskHandle;
+
+inline TaskHandle makeTask(const char* name) { return { nvtxDomainRegisterStringA(domain(), name) }; }
+inline void taskBegin(const TaskHandle& task) {
+    nvtxEventAttributes_t attributes = eventAttributes(task.name);
+    nvtxDomainRangePushEx(domain(), &attributes);
+}
+inline void taskEnd() { nvtxDomainRangePop(domain()); }
+
+inline FrameHandle makeFrame(const char* name) { return makeTask(name); }
+inline void frameBegin(const FrameHandle& frame) { taskBegin(frame); }
+inline void frameEnd(const FrameHandle&) { taskEnd(); }
+
+// Counter samples are marks carrying the value as payload
+inline CounterHandle makeCounter(const char* name) { return makeTask(name); }
+inline void counterSet(const CounterHandle& counter, double value) {
+    nvtxEventAttributes_t attributes = eventAttributes(counter.name);
+    attributes.payloadType = NVTX_PAYLOAD_TYPE_DOUBLE;
+    attributes.payload.dValue = value;
+    nvtxDomainMarkEx(domain(), &attributes);
+}
+
+#else // PERF_MARKERS_PROFILER
+
+// Open section tokens of this thread, innermost last
+inline std::vector<int>& openSections() {
+    thread_local std::vector<int> tokens;
+    return tokens;
+}
+
+struct TaskHandle { Profiler::SectionId section; };
+using FrameHandle = TaskHandle;
+struct CounterHandle {};
+
+inline TaskHandle makeTask(const char* name) { return { Profiler::internSection(name) }; }
+inline void taskBegin(const TaskHandle& task) { openSections().push_back(Profiler::getInstance().startSection(task.section)); }
+inline void taskEnd() {
+    std::vector<int>& tokens = openSections();
+    if (!tokens.empty()) {
+        Profiler::getInstance().endSection(tokens.back());
+        tokens.pop_back();
+    }
+}
+
+inline FrameHandle makeFrame(const char* name) { return makeTask(name); }
+inline void frameBegin(const FrameHandle& frame) { taskBegin(frame); }
+inline void frameEnd(const FrameHandle&) { taskEnd(); }
+
+// The Profiler records sections only; counters are dropped
+inline CounterHandle makeCounter(const char*) { return {}; }
+inline void counterSet(const CounterHandle&, double) {}
+
+#endif
+
+/**
+ * @brief Task for the lifetime of the object (PERF_SCOPE)
+ */
+class ScopedTask {
+public:
+    explicit ScopedTask(const TaskHandle& task) { taskBegin(task); }
+    ~ScopedTask() { taskEnd(); }
+
+    ScopedTask(const ScopedTask&) = delete;
+    ScopedTask& operator=(const ScopedTask&) = delete;
+};
+
+} // namespace perf_markers
+
+#define PERF_MARKERS_CONCAT_INNER(a, b) a##b
+#define PERF_MARKERS_CONCAT(a, b) PERF_MARKERS_CONCAT_INNER(a, b)
+
+#define PERF_SCOPE(name) \
+    static const ::perf_markers::TaskHandle PERF_MARKERS_CONCAT(perf_task_, __LINE__) = ::perf_markers::makeTask(name); \
+    ::perf_markers::ScopedTask PERF_MARKERS_CONCAT(perf_scope_, __LINE__)(PERF_MARKERS_CONCAT(perf_task_, __LINE__))
+
+#define PERF_TASK_BEGIN(name) \
+    do { \
+        static const ::perf_markers::TaskHandle perf_handle = ::perf_markers::makeTask(name); \
+        ::perf_markers::taskBegin(perf_handle); \
+    } while (0)
+
+#define PERF_TASK_END() ::perf_markers::taskEnd()
+
+#define PERF_FRAME_BEGIN(name) \
+    do { \
+        static const ::perf_markers::FrameHandle perf_handle = ::perf_markers::makeFrame(name); \
+        ::perf_markers::frameBegin(perf_handle); \
+    } while (0)
+
+#define PERF_FRAME_END(name) \
+    do { \
+        static const ::perf_markers::FrameHandle perf_handle = ::perf_markers::makeFrame(name); \
+        ::perf_markers::frameEnd(perf_handle); \
+    } while (0)
+
+#define PERF_COUNTER(name, value) \
+    do { \
+        static const ::perf_markers::CounterHandle perf_handle = ::perf_markers::makeCounter(name); \
+        ::perf_markers::counterSet(perf_handle, static_cast<double>(value)); \
+    } while (0)
+
+#else
+
+#define PERF_SCOPE(name) ((void)0)
+#define PERF_TASK_BEGIN(name) ((void)0)
+#define PERF_TASK_END() ((void)0)
+#define PERF_FRAME_BEGIN(name) ((void)0)
+#define PERF_FRAME_END(name) ((void)0)
+#define PERF_COUNTER(name, value) ((void)0)
+
+#endif
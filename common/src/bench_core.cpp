@@ -0,0 +1,840 @@
+#include "bench_core.h"
+
+#include <omp.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define BENCH_HAS_TSC 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#else
+#define BENCH_HAS_TSC 0
+#endif
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#else
+#include <unistd.h>
+#endif
+
+#ifndef BENCH_MODULE
+#define BENCH_MODULE "unknown"
+#endif
+
+namespace bench {
+
+namespace {
+
+struct ClockState {
+    std::once_flag calibrated;
+    bool useTsc = false;
+    double nsPerTick = 1.0;
+    double resolutionNs = 0.0;
+};
+
+ClockState& clockState() {
+    static ClockState state;
+    return state;
+}
+
+uint64_t steadyNanoseconds() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+Clock::Ticks readTicks(const ClockState& state) {
+#if BENCH_HAS_TSC
+    if (state.useTsc) {
+        return __rdtsc();
+    }
+#endif
+    return steadyNanoseconds();
+}
+
+#if BENCH_HAS_TSC
+bool hasInvariantTsc() {
+    unsigned int regs[4] = {0, 0, 0, 0};
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0x80000000);
+    if (static_cast<unsigned int>(info[0]) < 0x80000007u) {
+        return false;
+    }
+    __cpuid(info, 0x80000007);
+    regs[3] = static_cast<unsigned int>(info[3]);
+#else
+    if (__get_cpuid_max(0x80000000u, nullptr) < 0x80000007u) {
+        return false;
+    }
+    __get_cpuid(0x80000007u, &regs[0], &regs[1], &regs[2], &regs[3]);
+#endif
+    return (regs[3] & (1u << 8)) != 0;      // EDX bit 8: TSC runs at a constant rate in all states
+}
+#endif
+
+void calibrateClock(ClockState& state) {
+#if BENCH_HAS_TSC
+    if (hasInvariantTsc()) {
+        // Bracket a ~20 ms busy interval with both clocks; the start and end
+        // reads are each taken back to back so their skew is a few ns
+        const uint64_t ns0 = steadyNanoseconds();
+        const uint64_t tsc0 = __rdtsc();
+        uint64_t ns1 = ns0;
+        while (ns1 - ns0 < 20000000u) {
+            ns1 = steadyNanoseconds();
+        }
+        const uint64_t tsc1 = __rdtsc();
+        if (tsc1 > tsc0) {
+            state.useTsc = true;
+            state.nsPerTick = static_cast<double>(ns1 - ns0) / static_cast<double>(tsc1 - tsc0);
+        }
+    }
+#endif
+
+    double smallest = 0.0;
+    for (int i = 0; i < 1000; i++) {
+        const Clock::Ticks a = readTicks(state);
+        Clock::Ticks b = readTicks(state);
+        while (b == a) {
+            b = readTicks(state);
+        }
+        const double step = static_cast<double>(b - a) * state.nsPerTick;
+        smallest = i == 0 ? step : std::min(smallest, step);
+    }
+    state.resolutionNs = smallest;
+}
+
+ClockState& calibratedClock() {
+    ClockState& state = clockState();
+    std::call_once(state.calibrated, [&state] { calibrateClock(state); });
+    return state;
+}
+
+bool readEnvInt(const char* name, int& value) {
+    const char* text = std::getenv(name);
+    if (text == nullptr || *text == '\0') {
+        return false;
+    }
+    value = std::atoi(text);
+    return true;
+}
+
+// Affinity of the calling thread, saved as bytes so the header stays platform-neutral
+#ifdef __linux__
+bool getAffinity(std::vector<unsigned char>& saved) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        return false;
+    }
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&set);
+    saved.assign(bytes, bytes + sizeof(set));
+    return true;
+}
+
+void setAffinity(const std::vector<unsigned char>& saved) {
+    if (saved.size() == sizeof(cpu_set_t)) {
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t),
+                               reinterpret_cast<const cpu_set_t*>(saved.data()));
+    }
+}
+
+std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+    return cpus;
+}
+
+void pinToCpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+#elif defined(_WIN32)
+bool getAffinity(std::vector<unsigned char>& saved) {
+    DWORD_PTR processMask = 0;
+    DWORD_PTR systemMask = 0;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) {
+        return false;
+    }
+    // SetThreadAffinityMask returns the previous mask; set it straight back
+    const DWORD_PTR previous = SetThreadAffinityMask(GetCurrentThread(), processMask);
+    if (previous == 0) {
+        return false;
+    }
+    SetThreadAffinityMask(GetCurrentThread(), previous);
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&previous);
+    saved.assign(bytes, bytes + sizeof(previous));
+    return true;
+}
+
+void setAffinity(const std::vector<unsigned char>& saved) {
+    if (saved.size() == sizeof(DWORD_PTR)) {
+        SetThreadAffinityMask(GetCurrentThread(), *reinterpret_cast<const DWORD_PTR*>(saved.data()));
+    }
+}
+
+std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+    DWORD_PTR processMask = 0;
+    DWORD_PTR systemMask = 0;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) {
+        for (int cpu = 0; cpu < static_cast<int>(8 * sizeof(DWORD_PTR)); cpu++) {
+            if (processMask & (static_cast<DWORD_PTR>(1) << cpu)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+    return cpus;
+}
+
+void pinToCpu(int cpu) {
+    SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu);
+}
+#endif
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Clock
+// ---------------------------------------------------------------------------
+
+Clock::Ticks Clock::now() {
+    return readTicks(calibratedClock());
+}
+
+double Clock::toNanoseconds(Ticks ticks) {
+    return static_cast<double>(ticks) * calibratedClock().nsPerTick;
+}
+
+double Clock::resolutionNanoseconds() {
+    return calibratedClock().resolutionNs;
+}
+
+std::string Clock::description() {
+    const ClockState& state = calibratedClock();
+    std::ostringstream text;
+    if (state.useTsc) {
+        text << "invariant TSC at " << std::fixed << std::setprecision(3) << 1.0 / state.nsPerTick << " GHz";
+    } else {
+        text << "steady_clock";
+    }
+    text << ", resolution " << std::fixed << std::setprecision(1) << state.resolutionNs << " ns";
+    return text.str();
+}
+
+void Clock::calibrate() {
+    calibratedClock();
+}
+
+// ---------------------------------------------------------------------------
+// Statistics and measurement
+// ---------------------------------------------------------------------------
+
+Stats summarize(std::vector<double> samplesMs) {
+    Stats stats;
+    stats.repetitions = static_cast<int>(samplesMs.size());
+    if (samplesMs.empty()) {
+        return stats;
+    }
+    std::sort(samplesMs.begin(), samplesMs.end());
+    const size_t n = samplesMs.size();
+
+    double sum = 0.0;
+    for (double sample : samplesMs) {
+        sum += sample;
+    }
+    stats.meanMs = sum / n;
+    stats.medianMs = n % 2 ? samplesMs[n / 2] : 0.5 * (samplesMs[n / 2 - 1] + samplesMs[n / 2]);
+    stats.minMs = samplesMs.front();
+    stats.maxMs = samplesMs.back();
+
+    if (n > 1) {
+        double squares = 0.0;
+        for (double sample : samplesMs) {
+            squares += (sample - stats.meanMs) * (sample - stats.meanMs);
+        }
+        stats.stddevMs = std::sqrt(squares / (n - 1));
+    }
+    return stats;
+}
+
+RunPolicy RunPolicy::fromEnvironment() {
+    RunPolicy policy;
+    int value = 0;
+    if (readEnvInt("BENCH_WARMUP", value) && value >= 0) {
+        policy.warmup = value;
+    }
+    if (readEnvInt("BENCH_REPS", value) && value > 0) {
+        policy.minRepetitions = value;
+        policy.maxRepetitions = std::max(policy.maxRepetitions, value);
+    }
+    if (readEnvInt("BENCH_MAX_REPS", value) && value > 0) {
+        policy.maxRepetitions = value;
+        policy.minRepetitions = std::min(policy.minRepetitions, value);
+    }
+    if (readEnvInt("BENCH_MIN_TIME_MS", value) && value >= 0) {
+        policy.minTimeMs = value;
+    }
+    if (readEnvInt("BENCH_PIN", value)) {
+        policy.pinThreads = value != 0;
+    }
+    return policy;
+}
+
+Stats measure(const std::function<void()>& body, const RunPolicy& policy, std::vector<double>* samplesMs) {
+    Clock::calibrate();     // Keep the one-time calibration out of the first sample
+
+    std::unique_ptr<ThreadPinning> pinning;
+    if (policy.pinThreads) {
+        pinning.reset(new ThreadPinning());
+    }
+
+    for (int i = 0; i < policy.warmup; i++) {
+        body();
+    }
+
+    std::vector<double> samples;
+    double totalMs = 0.0;
+    const int maxRepetitions = std::max(policy.maxRepetitions, policy.minRepetitions);
+    while (static_cast<int>(samples.size()) < maxRepetitions &&
+           (static_cast<int>(samples.size()) < policy.minRepetitions || totalMs < policy.minTimeMs)) {
+        const Clock::Ticks start = Clock::now();
+        body();
+        const double elapsedMs = Clock::toMilliseconds(Clock::now() - start);
+        samples.push_back(elapsedMs);
+        totalMs += elapsedMs;
+    }
+
+    if (samplesMs != nullptr) {
+        *samplesMs = samples;
+    }
+    return summarize(samples);
+}
+
+// ---------------------------------------------------------------------------
+// Thread pinning
+// ---------------------------------------------------------------------------
+
+ThreadPinning::ThreadPinning(int numThreads)
+    : m_numThreads(numThreads > 0 ? numThreads : omp_get_max_threads()) {
+#if defined(__linux__) || defined(_WIN32)
+#if _OPENMP >= 201307
+    if (omp_get_proc_bind() != omp_proc_bind_false) {
+        m_reason = "OMP_PROC_BIND already binds threads";
+        return;
+    }
+#endif
+    const std::vector<int> cpus = allowedCpus();
+    if (cpus.empty()) {
+        m_reason = "cannot read the process affinity";
+        return;
+    }
+
+    m_saved.assign(m_numThreads, std::vector<unsigned char>());
+    bool saved = true;
+    #pragma omp parallel num_threads(m_numThreads) reduction(&&:saved)
+    {
+        const int thread = omp_get_thread_num();
+        saved = getAffinity(m_saved[thread]);
+        if (saved) {
+            pinToCpu(cpus[thread % cpus.size()]);
+        }
+    }
+    m_active = saved;
+    if (!saved) {
+        m_reason = "cannot read the thread affinity";
+    }
+#else
+    m_reason = "no thread affinity API on this platform";
+#endif
+}
+
+ThreadPinning::~ThreadPinning() {
+#if defined(__linux__) || defined(_WIN32)
+    if (m_saved.empty()) {
+        return;
+    }
+    #pragma omp parallel num_threads(m_numThreads)
+    {
+        setAffinity(m_saved[omp_get_thread_num()]);
+    }
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// Registry
+// ---------------------------------------------------------------------------
+
+Registry& Registry::instance() {
+    static Registry registry;
+    return registry;
+}
+
+bool Registry::add(const std::string& name, std::function<void()> body,
+                   double workPerRun, const std::string& workUnit) {
+    for (const Benchmark& benchmark : m_benchmarks) {
+        if (benchmark.name == name) {
+            std::cerr << "Warning: benchmark '" << name << "' registered twice, keeping the first" << std::endl;
+            return true;
+        }
+    }
+    m_benchmarks.push_back({name, std::move(body), workPerRun, workUnit});
+    return true;
+}
+
+std::vector<BenchmarkResult> Registry::run(const std::string& filter, const RunPolicy& policy) const {
+    std::vector<BenchmarkResult> results;
+    for (const Benchmark& benchmark : m_benchmarks) {
+        if (!filter.empty() && benchmark.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        BenchmarkResult result;
+        result.name = benchmark.name;
+        result.workPerRun = benchmark.workPerRun;
+        result.workUnit = benchmark.workUnit;
+        std::vector<double> samples;
+        result.stats = measure(benchmark.body, policy, &samples);
+        results.push_back(result);
+
+        std::map<std::string, double> counters;
+        if (result.throughput() > 0.0) {
+            counters[result.workUnit.empty() ? "throughput" : result.workUnit + "_per_s"] = result.throughput();
+        }
+        record(benchmark.name, "", 0, omp_get_max_threads(), samples, counters);
+    }
+    return results;
+}
+
+void Registry::print(const std::vector<BenchmarkResult>& results, const RunPolicy& policy) {
+    std::cout << "Clock: " << Clock::description() << std::endl;
+    std::cout << "Policy: " << policy.warmup << " warmup, " << policy.minRepetitions << "-"
+              << policy.maxRepetitions << " repetitions";
+    if (policy.minTimeMs > 0.0) {
+        std::cout << ", at least " << policy.minTimeMs << " ms";
+    }
+    std::cout << (policy.pinThreads ? ", threads pinned" : "") << std::endl;
+
+    size_t nameWidth = 10;
+    for (const BenchmarkResult& result : results) {
+        nameWidth = std::max(nameWidth, result.name.size() + 2);
+    }
+
+    std::cout << std::left << std::setw(static_cast<int>(nameWidth)) << "Benchmark"
+              << std::right << std::setw(6) << "Reps"
+              << std::setw(13) << "Median (ms)"
+              << std::setw(13) << "Min (ms)"
+              << std::setw(9) << "CV (%)"
+              << "  Throughput" << std::endl;
+    std::cout << std::string(nameWidth + 55, '-') << std::endl;
+
+    for (const BenchmarkResult& result : results) {
+        std::cout << std::left << std::setw(static_cast<int>(nameWidth)) << result.name
+                  << std::right << std::setw(6) << result.stats.repetitions
+                  << std::fixed << std::setprecision(4)
+                  << std::setw(13) << result.stats.medianMs
+                  << std::setw(13) << result.stats.minMs
+                  << std::setprecision(1) << std::setw(9) << 100.0 * result.stats.cv();
+        if (result.throughput() > 0.0) {
+            std::cout << "  " << std::setprecision(3) << std::scientific << result.throughput()
+                      << " " << result.workUnit << "/s" << std::defaultfloat;
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::defaultfloat;
+}
+
+bool Registry::saveCsv(const std::vector<BenchmarkResult>& results, const std::string& filename) {
+    std::ofstream file(filename);
+    if (!file) {
+        std::cerr << "Error: Could not open file " << filename << " for writing" << std::endl;
+        return false;
+    }
+    file << "name,repetitions,mean_ms,median_ms,min_ms,max_ms,stddev_ms,throughput,unit\n";
+    file << std::setprecision(9);
+    for (const BenchmarkResult& result : results) {
+        file << result.name << ',' << result.stats.repetitions << ','
+             << result.stats.meanMs << ',' << result.stats.medianMs << ','
+             << result.stats.minMs << ',' << result.stats.maxMs << ','
+             << result.stats.stddevMs << ',' << result.throughput() << ','
+             << result.workUnit << '\n';
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Results
+// ---------------------------------------------------------------------------
+
+namespace {
+
+const int RESULT_SCHEMA = 1;
+
+struct ResultLog {
+    std::mutex mutex;
+    std::string path;
+    std::string host;
+    std::string run;
+
+    ResultLog() {
+        const char* file = std::getenv("BENCH_RESULTS");
+        path = file != nullptr ? file : "";
+        host = hostFingerprint();
+        const char* id = std::getenv("BENCH_RUN_ID");
+        if (id != nullptr && *id != '\0') {
+            run = id;
+        } else {
+            run = std::to_string(std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+        }
+    }
+};
+
+ResultLog& resultLog() {
+    static ResultLog log;
+    return log;
+}
+
+void writeJsonString(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (c == '\n') {
+            out << "\\n";
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << ' ';
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+// Reads what toJson writes, skipping keys it does not know, so later schema
+// versions can add fields; not a general JSON parser (no unicode escapes)
+class LineReader {
+public:
+    explicit LineReader(const std::string& text) : m_text(text) {}
+
+    bool expect(char c) {
+        skipSpace();
+        if (m_pos < m_text.size() && m_text[m_pos] == c) {
+            m_pos++;
+            return true;
+        }
+        return false;
+    }
+
+    bool peek(char c) {
+        skipSpace();
+        return m_pos < m_text.size() && m_text[m_pos] == c;
+    }
+
+    bool readString(std::string& value) {
+        if (!expect('"')) {
+            return false;
+        }
+        value.clear();
+        while (m_pos < m_text.size() && m_text[m_pos] != '"') {
+            char c = m_text[m_pos++];
+            if (c == '\\' && m_pos < m_text.size()) {
+                c = m_text[m_pos++];
+                c = c == 'n' ? '\n' : c == 't' ? '\t' : c;
+            }
+            value += c;
+        }
+        return expect('"');
+    }
+
+    bool readNumber(double& value) {
+        skipSpace();
+        const char* start = m_text.c_str() + m_pos;
+        char* end = nullptr;
+        value = std::strtod(start, &end);
+        if (end == start) {
+            return false;
+        }
+        m_pos += end - start;
+        return true;
+    }
+
+    bool readNumbers(std::vector<double>& values) {
+        if (!expect('[')) {
+            return false;
+        }
+        values.clear();
+        while (!expect(']')) {
+            double value = 0.0;
+            if (!values.empty() && !expect(',')) {
+                return false;
+            }
+            if (!readNumber(value)) {
+                return false;
+            }
+            values.push_back(value);
+        }
+        return true;
+    }
+
+    bool readNumberMap(std::map<std::string, double>& values) {
+        if (!expect('{')) {
+            return false;
+        }
+        values.clear();
+        bool first = true;
+        while (!expect('}')) {
+            std::string key;
+            double value = 0.0;
+            if ((!first && !expect(',')) || !readString(key) || !expect(':') || !readNumber(value)) {
+                return false;
+            }
+            values[key] = value;
+            first = false;
+        }
+        return true;
+    }
+
+    // Skip one value of any type
+    bool skipValue() {
+        skipSpace();
+        if (m_pos >= m_text.size()) {
+            return false;
+        }
+        const char c = m_text[m_pos];
+        if (c == '"') {
+            std::string ignored;
+            return readString(ignored);
+        }
+        if (c == '[' || c == '{') {
+            const char close = c == '[' ? ']' : '}';
+            m_pos++;
+            bool first = true;
+            while (!expect(close)) {
+                if (!first && !expect(',')) {
+                    return false;
+                }
+                if (close == '}') {
+                    std::string key;
+                    if (!readString(key) || !expect(':')) {
+                        return false;
+                    }
+                }
+                if (!skipValue()) {
+                    return false;
+                }
+                first = false;
+            }
+            return true;
+        }
+        if (m_text.compare(m_pos, 4, "true") == 0 || m_text.compare(m_pos, 4, "null") == 0) {
+            m_pos += 4;
+            return true;
+        }
+        if (m_text.compare(m_pos, 5, "false") == 0) {
+            m_pos += 5;
+            return true;
+        }
+        double ignored = 0.0;
+        return readNumber(ignored);
+    }
+
+private:
+    void skipSpace() {
+        while (m_pos < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_pos]))) {
+            m_pos++;
+        }
+    }
+
+    const std::string& m_text;
+    size_t m_pos = 0;
+};
+
+} // namespace
+
+bool recording() {
+    return !resultLog().path.empty();
+}
+
+void record(Result result) {
+    ResultLog& log = resultLog();
+    if (log.path.empty()) {
+        return;
+    }
+    result.module = BENCH_MODULE;
+    result.host = log.host;
+    result.run = log.run;
+    result.timestamp = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    const std::string line = toJson(result);
+
+    std::lock_guard<std::mutex> lock(log.mutex);
+    std::ofstream file(log.path, std::ios::app);
+    if (!file) {
+        std::cerr << "Error: Could not open results file " << log.path << std::endl;
+        log.path.clear();       // Report once, not for every result
+        return;
+    }
+    file << line << '\n';
+}
+
+void record(const std::string& benchmark, const std::string& variant, long long size, int threads,
+            const std::vector<double>& samplesMs, const std::map<std::string, double>& counters) {
+    if (!recording()) {
+        return;
+    }
+    Result result;
+    result.benchmark = benchmark;
+    result.variant = variant;
+    result.size = size;
+    result.threads = threads;
+    result.samplesMs = samplesMs;
+    result.counters = counters;
+    record(std::move(result));
+}
+
+std::string hostFingerprint() {
+    char name[256] = {0};
+#ifdef _WIN32
+    DWORD length = sizeof(name);
+    if (!GetComputerNameA(name, &length)) {
+        name[0] = '\0';
+    }
+#else
+    if (gethostname(name, sizeof(name) - 1) != 0) {
+        name[0] = '\0';
+    }
+#endif
+    std::ostringstream fingerprint;
+    fingerprint << (name[0] ? name : "unknown") << "/" << std::thread::hardware_concurrency() << "cpu";
+    return fingerprint.str();
+}
+
+std::string toJson(const Result& result) {
+    std::ostringstream out;
+    out << std::setprecision(9);
+    out << "{\"schema\":" << RESULT_SCHEMA << ",\"module\":";
+    writeJsonString(out, result.module);
+    out << ",\"benchmark\":";
+    writeJsonString(out, result.benchmark);
+    out << ",\"variant\":";
+    writeJsonString(out, result.variant);
+    out << ",\"size\":" << result.size << ",\"threads\":" << result.threads << ",\"host\":";
+    writeJsonString(out, result.host);
+    out << ",\"run\":";
+    writeJsonString(out, result.run);
+    out << ",\"timestamp\":" << result.timestamp << ",\"samples\":[";
+    for (size_t i = 0; i < result.samplesMs.size(); i++) {
+        out << (i > 0 ? "," : "") << result.samplesMs[i];
+    }
+    out << "],\"counters\":{";
+    bool first = true;
+    for (const auto& counter : result.counters) {
+        if (!std::isfinite(counter.second)) {
+            continue;       // JSON has no NaN or infinity
+        }
+        out << (first ? "" : ",");
+        writeJsonString(out, counter.first);
+        out << ":" << counter.second;
+        first = false;
+    }
+    out << "}}";
+    return out.str();
+}
+
+bool parseResult(const std::string& line, Result& result) {
+    LineReader reader(line);
+    if (!reader.expect('{')) {
+        return false;
+    }
+    result = Result();
+    bool hasBenchmark = false;
+    bool hasSamples = false;
+    bool first = true;
+    while (!reader.expect('}')) {
+        std::string key;
+        if ((!first && !reader.expect(',')) || !reader.readString(key) || !reader.expect(':')) {
+            return false;
+        }
+        first = false;
+
+        double number = 0.0;
+        bool ok = true;
+        if (key == "module") {
+            ok = reader.readString(result.module);
+        } else if (key == "benchmark") {
+            ok = hasBenchmark = reader.readString(result.benchmark);
+        } else if (key == "variant") {
+            ok = reader.readString(result.variant);
+        } else if (key == "host") {
+            ok = reader.readString(result.host);
+        } else if (key == "run") {
+            ok = reader.readString(result.run);
+        } else if (key == "size" || key == "threads" || key == "timestamp") {
+            ok = reader.readNumber(number);
+            if (key == "size") {
+                result.size = static_cast<long long>(number);
+            } else if (key == "threads") {
+                result.threads = static_cast<int>(number);
+            } else {
+                result.timestamp = static_cast<long long>(number);
+            }
+        } else if (key == "samples") {
+            ok = hasSamples = reader.readNumbers(result.samplesMs);
+        } else if (key == "counters") {
+            ok = reader.readNumberMap(result.counters);
+        } else {
+            ok = reader.skipValue();
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return hasBenchmark && hasSamples;
+}
+
+std::vector<Result> loadResults(const std::string& filename) {
+    std::vector<Result> results;
+    std::ifstream file(filename);
+    std::string line;
+    while (std::getline(file, line)) {
+        Result result;
+        if (parseResult(line, result)) {
+            results.push_back(std::move(result));
+        }
+    }
+    return results;
+}
+
+} // namespace bench
@@ -0,0 +1,380 @@
+#include "numa_allocator.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+// Platform-specific includes
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <dirent.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#ifndef _WIN32
+namespace {
+
+// Memory policy modes from <linux/mempolicy.h>; defined here so libnuma is not required
+constexpr int MPOL_PREFERRED_MODE = 1;
+constexpr int MPOL_INTERLEAVE_MODE = 3;
+
+long SysMbind(void* addr, unsigned long len, int mode, const unsigned long* nodemask, unsigned long maxnode) {
+#ifdef SYS_mbind
+    return syscall(SYS_mbind, addr, len, mode, nodemask, maxnode, 0u);
+#else
+    (void)addr; (void)len; (void)mode; (void)nodemask; (void)maxnode;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+// Parse a sysfs CPU list such as "0-3,8-11"
+std::vector<int> ReadNodeCpus(int node) {
+    std::vector<int> cpus;
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    std::string list;
+    if (!std::getline(file, list)) {
+        return cpus;
+    }
+    std::stringstream ranges(list);
+    std::string range;
+    while (std::getline(ranges, range, ',')) {
+        if (range.empty() || range.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; cpu++) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+} // namespace
+#endif
+
+const char* NumaPolicyName(NumaPolicy policy) {
+    switch (policy) {
+        case NumaPolicy::Default: return "default";
+        case NumaPolicy::Node: return "node";
+        case NumaPolicy::Interleave: return "interleave";
+        case NumaPolicy::FirstTouch: return "firsttouch";
+    }
+    return "unknown";
+}
+
+bool ParseNumaPolicy(const std::string& name, NumaPolicy& policy) {
+    for (NumaPolicy candidate : {NumaPolicy::Default, NumaPolicy::Node,
+                                 NumaPolicy::Interleave, NumaPolicy::FirstTouch}) {
+        if (name == NumaPolicyName(candidate)) {
+            policy = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+NumaAllocator::NumaAllocator()
+    : m_nodeCount(1),
+      m_pageSize(4096),
+      m_bindingSupported(false),
+      m_bindingWarned(false) {
+
+#ifdef _WIN32
+    ULONG highestNode = 0;
+    if (GetNumaHighestNodeNumber(&highestNode)) {
+        for (ULONG node = 0; node <= highestNode; node++) {
+            ULONGLONG available = 0;
+            if (GetNumaAvailableMemoryNodeEx(static_cast<USHORT>(node), &available) && available > 0) {
+                m_nodes.push_back(static_cast<int>(node));
+            }
+        }
+    }
+#else
+    // Node IDs need not be contiguous; list the nodeN entries of sysfs
+    if (DIR* dir = opendir("/sys/devices/system/node")) {
+        while (dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+                name.find_first_not_of("0123456789", 4) == std::string::npos) {
+                m_nodes.push_back(std::stoi(name.substr(4)));
+            }
+        }
+        closedir(dir);
+        std::sort(m_nodes.begin(), m_nodes.end());
+    }
+#endif
+    if (m_nodes.empty()) {
+        m_nodes.push_back(0);
+    }
+    m_nodeCount = static_cast<int>(m_nodes.size());
+
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    m_pageSize = info.dwPageSize;
+    m_bindingSupported = true;
+#else
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (pageSize > 0) {
+        m_pageSize = static_cast<size_t>(pageSize);
+    }
+#ifdef SYS_mbind
+    m_bindingSupported = true;
+#endif
+#endif
+}
+
+size_t NumaAllocator::roundToPages(size_t bytes) const {
+    return ((std::max<size_t>(bytes, 1) + m_pageSize - 1) / m_pageSize) * m_pageSize;
+}
+
+void* NumaAllocator::allocate(size_t bytes, NumaPolicy policy, int node) {
+    const size_t length = roundToPages(bytes);
+    const bool bind = (policy == NumaPolicy::Node || policy == NumaPolicy::Interleave) && m_bindingSupported;
+
+#ifdef _WIN32
+    HANDLE process = GetCurrentProcess();
+
+    if (bind && policy == NumaPolicy::Node) {
+        void* ptr = VirtualAllocExNuma(process, nullptr, length, MEM_RESERVE | MEM_COMMIT,
+                                       PAGE_READWRITE, static_cast<DWORD>(node));
+        if (ptr != nullptr) {
+            return ptr;
+        }
+        std::cerr << "VirtualAllocExNuma failed for node " << node << ". Error: " << GetLastError() << std::endl;
+    }
+
+    if (bind && policy == NumaPolicy::Interleave) {
+        // Reserve once, then commit each page with its preferred node
+        void* ptr = VirtualAlloc(nullptr, length, MEM_RESERVE, PAGE_READWRITE);
+        if (ptr == nullptr) {
+            std::cerr << "VirtualAlloc reserve failed. Error: " << GetLastError() << std::endl;
+            return nullptr;
+        }
+        char* base = static_cast<char*>(ptr);
+        for (size_t offset = 0, page = 0; offset < length; offset += m_pageSize, page++) {
+            DWORD pageNode = static_cast<DWORD>(m_nodes[page % m_nodes.size()]);
+            if (VirtualAllocExNuma(process, base + offset, m_pageSize, MEM_COMMIT,
+                                   PAGE_READWRITE, pageNode) == nullptr) {
+                std::cerr << "VirtualAllocExNuma commit failed. Error: " << GetLastError() << std::endl;
+                VirtualFree(ptr, 0, MEM_RELEASE);
+                return nullptr;
+            }
+        }
+        return ptr;
+    }
+
+    void* ptr = VirtualAlloc(nullptr, length, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (ptr == nullptr) {
+        std::cerr << "VirtualAlloc failed. Error: " << GetLastError() << std::endl;
+    }
+    return ptr;
+#else
+    void* ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+        std::cerr << "mmap failed: " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+
+    // The policy is attached to the range before any page is touched
+    if (bind) {
+        bindRange(ptr, length, policy, node);
+    }
+    return ptr;
+#endif
+}
+
+bool NumaAllocator::bindRange(void* ptr, size_t bytes, NumaPolicy policy, int node) const {
+#ifdef _WIN32
+    (void)ptr; (void)bytes; (void)policy; (void)node;
+    return false;
+#else
+    const int bitsPerWord = static_cast<int>(sizeof(unsigned long) * 8);
+    int maxNode = std::max(node, *std::max_element(m_nodes.begin(), m_nodes.end()));
+    std::vector<unsigned long> mask(static_cast<size_t>(maxNode / bitsPerWord + 1), 0);
+
+    auto setBit = [&](int n) {
+        if (n >= 0) {
+            mask[n / bitsPerWord] |= 1UL << (n % bitsPerWord);
+        }
+    };
+
+    if (policy == NumaPolicy::Interleave) {
+        for (int n : m_nodes) {
+            setBit(n);
+        }
+    } else {
+        setBit(node);
+    }
+
+    int mode = (policy == NumaPolicy::Interleave) ? MPOL_INTERLEAVE_MODE : MPOL_PREFERRED_MODE;
+    // The kernel reads maxnode - 1 bits
+    unsigned long maxnode = static_cast<unsigned long>(mask.size() * bitsPerWord + 1);
+
+    if (SysMbind(ptr, bytes, mode, mask.data(), maxnode) != 0) {
+        if (!m_bindingWarned) {
+            std::cerr << "Warning: mbind failed (" << std::strerror(errno)
+                      << "); falling back to first-touch placement." << std::endl;
+            m_bindingWarned = true;
+        }
+        return false;
+    }
+    return true;
+#endif
+}
+
+void NumaAllocator::deallocate(void* ptr, size_t bytes) {
+    if (ptr == nullptr) {
+        return;
+    }
+#ifdef _WIN32
+    (void)bytes;
+    VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+    munmap(ptr, roundToPages(bytes));
+#endif
+}
+
+int NumaAllocator::getNodeCount() const {
+    return m_nodeCount;
+}
+
+const std::vector<int>& NumaAllocator::getNodes() const {
+    return m_nodes;
+}
+
+bool NumaAllocator::isBindingSupported() const {
+    return m_bindingSupported;
+}
+
+size_t NumaAllocator::getPageSize() const {
+    return m_pageSize;
+}
+
+int NumaAllocator::getNodeOfAddress(const void* address) const {
+#ifdef _WIN32
+    PSAPI_WORKING_SET_EX_INFORMATION info;
+    info.VirtualAddress = const_cast<void*>(address);
+    if (!QueryWorkingSetEx(GetCurrentProcess(), &info, sizeof(info)) || !info.VirtualAttributes.Valid) {
+        return -1;
+    }
+    return static_cast<int>(info.VirtualAttributes.Node);
+#elif defined(SYS_move_pages)
+    // move_pages with no target nodes only reports where each page lives
+    void* page = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(address) & ~(uintptr_t)(m_pageSize - 1));
+    int status = -1;
+    if (syscall(SYS_move_pages, 0, 1UL, &page, nullptr, &status, 0) != 0) {
+        return -1;
+    }
+    return status >= 0 ? status : -1;
+#else
+    (void)address;
+    return -1;
+#endif
+}
+
+std::map<int, size_t> NumaAllocator::getPagePlacement(const void* ptr, size_t bytes, size_t maxSamples) const {
+    std::map<int, size_t> placement;
+    if (ptr == nullptr || bytes == 0) {
+        return placement;
+    }
+
+    const size_t pages = (bytes + m_pageSize - 1) / m_pageSize;
+    const size_t samples = std::max<size_t>(1, std::min(pages, maxSamples));
+    const char* base = static_cast<const char*>(ptr);
+
+    for (size_t s = 0; s < samples; s++) {
+        size_t page = s * pages / samples;
+        placement[getNodeOfAddress(base + page * m_pageSize)]++;
+    }
+    return placement;
+}
+
+void NumaAllocator::displayPlacement(const void* ptr, size_t bytes, const std::string& label) const {
+    std::map<int, size_t> placement = getPagePlacement(ptr, bytes);
+    size_t total = 0;
+    for (const auto& pair : placement) {
+        total += pair.second;
+    }
+
+    std::cout << label << ":";
+    for (const auto& pair : placement) {
+        std::cout << "  ";
+        if (pair.first < 0) {
+            std::cout << "unknown";
+        } else {
+            std::cout << "node " << pair.first;
+        }
+        std::cout << " " << std::fixed << std::setprecision(1)
+                  << 100.0 * pair.second / std::max<size_t>(total, 1) << "%";
+    }
+    std::cout << std::endl;
+}
+
+ScopedNodeAffinity::ScopedNodeAffinity(int node) {
+    if (node < 0) {
+        return;
+    }
+#ifdef _WIN32
+    GROUP_AFFINITY affinity = {};
+    GROUP_AFFINITY previous = {};
+    if (!GetNumaNodeProcessorMaskEx(static_cast<USHORT>(node), &affinity) || affinity.Mask == 0) {
+        return;
+    }
+    if (!SetThreadGroupAffinity(GetCurrentThread(), &affinity, &previous)) {
+        return;
+    }
+    m_previous.resize(sizeof(previous));
+    std::memcpy(m_previous.data(), &previous, sizeof(previous));
+    m_bound = true;
+#else
+    std::vector<int> cpus = ReadNodeCpus(node);
+    if (cpus.empty()) {
+        return;
+    }
+    cpu_set_t previous;
+    CPU_ZERO(&previous);
+    if (sched_getaffinity(0, sizeof(previous), &previous) != 0) {
+        return;
+    }
+    cpu_set_t affinity;
+    CPU_ZERO(&affinity);
+    for (int cpu : cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &affinity);
+        }
+    }
+    if (sched_setaffinity(0, sizeof(affinity), &affinity) != 0) {
+        return;
+    }
+    m_previous.resize(sizeof(previous));
+    std::memcpy(m_previous.data(), &previous, sizeof(previous));
+    m_bound = true;
+#endif
+}
+
+ScopedNodeAffinity::~ScopedNodeAffinity() {
+    if (!m_bound) {
+        return;
+    }
+#ifdef _WIN32
+    GROUP_AFFINITY previous;
+    std::memcpy(&previous, m_previous.data(), sizeof(previous));
+    SetThreadGroupAffinity(GetCurrentThread(), &previous, nullptr);
+#else
+    cpu_set_t previous;
+    std::memcpy(&previous, m_previous.data(), sizeof(previous));
+    sched_setaffinity(0, sizeof(previous), &previous);
+#endif
+}
@@ -0,0 +1,385 @@
+/**
+ * @file bench_dashboard.cpp
+ * @brief Merges results files from any module into one HTML dashboard
+ *
+ * Usage: bench_dashboard [-o dashboard.html] results.jsonl [more.jsonl ...]
+ *
+ * Reads the JSONL results written by bench::record (BENCH_RESULTS=...) and
+ * writes one page with a section per module and benchmark:
+ *   - a table of the latest run: median, min, CV and speedup over 1 thread
+ *   - a scaling curve (median time against threads) when the latest run
+ *     covered more than one thread count
+ *   - a history chart (median time per run) when there is more than one run
+ * Runs from different hosts are kept apart, since their times do not compare.
+ */
+
+#include "bench_core.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+const char* const COLORS[] = {
+    "#1f77b4", "#ff7f0e", "#2ca02c", "#d62728", "#9467bd",
+    "#8c564b", "#e377c2", "#7f7f7f", "#bcbd22", "#17becf"
+};
+const size_t COLOR_COUNT = sizeof(COLORS) / sizeof(COLORS[0]);
+
+std::string escapeHtml(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        switch (c) {
+            case '<': escaped += "&lt;"; break;
+            case '>': escaped += "&gt;"; break;
+            case '&': escaped += "&amp;"; break;
+            case '"': escaped += "&quot;"; break;
+            default: escaped += c;
+        }
+    }
+    return escaped;
+}
+
+// String literal for the inline chart scripts
+std::string jsString(const std::string& text) {
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+        }
+        if (c == '<') {
+            quoted += "\\u003c";    // Keeps "</script>" out of the page
+            continue;
+        }
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+// Variant and size, e.g. "task, n=35"; a line in the scaling chart
+std::string seriesName(const bench::Result& result) {
+    std::ostringstream name;
+    name << (result.variant.empty() ? "default" : result.variant);
+    if (result.size > 0) {
+        name << ", n=" << result.size;
+    }
+    return name.str();
+}
+
+struct Benchmark {
+    std::string module;
+    std::string name;
+    std::string host;
+    std::vector<const bench::Result*> results;
+};
+
+class Dashboard {
+public:
+    void add(const std::vector<bench::Result>& results) {
+        m_results.insert(m_results.end(), results.begin(), results.end());
+    }
+
+    bool write(const std::string& filename) {
+        group();
+        std::ofstream out(filename);
+        if (!out) {
+            std::cerr << "Error: Could not open file " << filename << " for writing" << std::endl;
+            return false;
+        }
+
+        std::set<std::string> runs;
+        std::set<std::string> hosts;
+        std::set<std::string> modules;
+        for (const bench::Result& result : m_results) {
+            runs.insert(result.run);
+            hosts.insert(result.host);
+            modules.insert(result.module);
+        }
+
+        out << "<!DOCTYPE html>\n<html>\n<head>\n"
+            << "    <title>OpenMP Performance Dashboard</title>\n"
+            << "    <style>\n"
+            << "        body { font-family: Arial, sans-serif; margin: 20px; }\n"
+            << "        h1, h2, h3 { color: #333; }\n"
+            << "        table { border-collapse: collapse; margin-bottom: 20px; }\n"
+            << "        th, td { padding: 6px 10px; text-align: right; border: 1px solid #ddd; }\n"
+            << "        th { background-color: #4CAF50; color: white; }\n"
+            << "        td:first-child { text-align: left; }\n"
+            << "        tr:nth-child(even) { background-color: #f2f2f2; }\n"
+            << "        .noisy { color: #c62828; }\n"
+            << "        .charts { display: flex; flex-wrap: wrap; gap: 20px; }\n"
+            << "        .chart-container { width: 560px; height: 320px; }\n"
+            << "    </style>\n"
+            << "    <script src=\"https://cdn.jsdelivr.net/npm/chart.js\"></script>\n"
+            << "</head>\n<body>\n"
+            << "    <h1>OpenMP Performance Dashboard</h1>\n"
+            << "    <p>" << m_results.size() << " results from " << runs.size() << " runs of "
+            << modules.size() << " modules on " << hosts.size() << " hosts. Times are the median of "
+            << "each result's samples; CV above 5% is marked as noisy.</p>\n";
+
+        std::string currentModule;
+        for (size_t i = 0; i < m_benchmarks.size(); i++) {
+            const Benchmark& benchmark = m_benchmarks[i];
+            if (benchmark.module != currentModule) {
+                currentModule = benchmark.module;
+                out << "    <h2>" << escapeHtml(currentModule) << "</h2>\n";
+            }
+            writeBenchmark(out, benchmark, i);
+        }
+
+        out << "</body>\n</html>\n";
+        return true;
+    }
+
+private:
+    void group() {
+        std::map<std::tuple<std::string, std::string, std::string>, size_t> index;
+        m_benchmarks.clear();
+        for (const bench::Result& result : m_results) {
+            auto key = std::make_tuple(result.module, result.benchmark, result.host);
+            auto it = index.find(key);
+            if (it == index.end()) {
+                it = index.emplace(key, m_benchmarks.size()).first;
+                m_benchmarks.push_back({result.module, result.benchmark, result.host, {}});
+            }
+            m_benchmarks[it->second].results.push_back(&result);
+        }
+        std::stable_sort(m_benchmarks.begin(), m_benchmarks.end(), [](const Benchmark& a, const Benchmark& b) {
+            return std::tie(a.module, a.name, a.host) < std::tie(b.module, b.name, b.host);
+        });
+        for (Benchmark& benchmark : m_benchmarks) {
+            std::stable_sort(benchmark.results.begin(), benchmark.results.end(),
+                             [](const bench::Result* a, const bench::Result* b) { return a->timestamp < b->timestamp; });
+        }
+    }
+
+    // Runs of one benchmark, oldest first by their first result
+    static std::vector<std::string> runOrder(const Benchmark& benchmark) {
+        std::vector<std::string> order;
+        for (const bench::Result* result : benchmark.results) {
+            if (std::find(order.begin(), order.end(), result->run) == order.end()) {
+                order.push_back(result->run);
+            }
+        }
+        return order;
+    }
+
+    void writeBenchmark(std::ostream& out, const Benchmark& benchmark, size_t id) const {
+        const std::vector<std::string> runs = runOrder(benchmark);
+        const std::string& latestRun = runs.back();
+
+        // Latest run: one row per series and thread count; a repeated key
+        // within the run keeps the last result
+        std::map<std::pair<std::string, int>, const bench::Result*> latest;
+        for (const bench::Result* result : benchmark.results) {
+            if (result->run == latestRun) {
+                latest[{seriesName(*result), result->threads}] = result;
+            }
+        }
+
+        out << "    <h3>" << escapeHtml(benchmark.name) << " <small>(" << escapeHtml(benchmark.host)
+            << ", run " << escapeHtml(latestRun) << ")</small></h3>\n";
+        writeTable(out, latest);
+
+        out << "    <div class=\"charts\">\n";
+        std::set<int> threadCounts;
+        for (const auto& entry : latest) {
+            threadCounts.insert(entry.first.second);
+        }
+        if (threadCounts.size() > 1) {
+            writeScalingChart(out, latest, id);
+        }
+        if (runs.size() > 1) {
+            writeHistoryChart(out, benchmark, runs, id);
+        }
+        out << "    </div>\n";
+    }
+
+    static void writeTable(std::ostream& out, const std::map<std::pair<std::string, int>, const bench::Result*>& latest) {
+        std::set<std::string> counterNames;
+        for (const auto& entry : latest) {
+            for (const auto& counter : entry.second->counters) {
+                counterNames.insert(counter.first);
+            }
+        }
+
+        out << "    <table>\n        <tr><th>Variant</th><th>Threads</th><th>Samples</th>"
+            << "<th>Median (ms)</th><th>Min (ms)</th><th>CV (%)</th><th>Speedup</th>";
+        for (const std::string& name : counterNames) {
+            out << "<th>" << escapeHtml(name) << "</th>";
+        }
+        out << "</tr>\n";
+
+        out << std::fixed;
+        for (const auto& entry : latest) {
+            const bench::Result& result = *entry.second;
+            const bench::Stats stats = bench::summarize(result.samplesMs);
+
+            // Speedup over the single-thread result of the same series, if the run has one
+            auto serial = latest.find({entry.first.first, 1});
+            out << "        <tr><td>" << escapeHtml(entry.first.first) << "</td><td>" << result.threads
+                << "</td><td>" << stats.repetitions << "</td><td>" << std::setprecision(4) << stats.medianMs
+                << "</td><td>" << stats.minMs << "</td><td" << (stats.cv() > 0.05 ? " class=\"noisy\"" : "")
+                << ">" << std::setprecision(1) << 100.0 * stats.cv() << "</td><td>";
+            if (serial != latest.end() && stats.medianMs > 0.0) {
+                out << std::setprecision(2) << bench::summarize(serial->second->samplesMs).medianMs / stats.medianMs;
+            }
+            out << "</td>";
+            for (const std::string& name : counterNames) {
+                auto counter = result.counters.find(name);
+                out << "<td>";
+                if (counter != result.counters.end()) {
+                    out << std::defaultfloat << std::setprecision(4) << counter->second << std::fixed;
+                }
+                out << "</td>";
+            }
+            out << "</tr>\n";
+        }
+        out << std::defaultfloat << "    </table>\n";
+    }
+
+    static void writeScalingChart(std::ostream& out,
+                                  const std::map<std::pair<std::string, int>, const bench::Result*>& latest,
+                                  size_t id) {
+        // Map order groups each series and sorts it by thread count
+        std::map<std::string, std::vector<std::pair<int, double>>> series;
+        for (const auto& entry : latest) {
+            series[entry.first.first].push_back(
+                {entry.first.second, bench::summarize(entry.second->samplesMs).medianMs});
+        }
+
+        out << "        <div class=\"chart-container\"><canvas id=\"scaling" << id << "\"></canvas></div>\n"
+            << "        <script>\n"
+            << "        new Chart(document.getElementById('scaling" << id << "'), {\n"
+            << "            type: 'line',\n"
+            << "            data: { datasets: [\n";
+        size_t color = 0;
+        for (const auto& line : series) {
+            out << "                { label: " << jsString(line.first) << ", borderColor: '"
+                << COLORS[color++ % COLOR_COUNT] << "', fill: false, data: [";
+            for (size_t i = 0; i < line.second.size(); i++) {
+                out << (i > 0 ? ", " : "") << "{x: " << line.second[i].first << ", y: " << line.second[i].second << "}";
+            }
+            out << "] },\n";
+        }
+        out << "            ] },\n"
+            << "            options: {\n"
+            << "                maintainAspectRatio: false,\n"
+            << "                plugins: { title: { display: true, text: 'Scaling (latest run)' } },\n"
+            << "                scales: {\n"
+            << "                    x: { type: 'linear', title: { display: true, text: 'Threads' } },\n"
+            << "                    y: { type: 'logarithmic', title: { display: true, text: 'Median time (ms)' } }\n"
+            << "                }\n"
+            << "            }\n"
+            << "        });\n"
+            << "        </script>\n";
+    }
+
+    static void writeHistoryChart(std::ostream& out, const Benchmark& benchmark,
+                                  const std::vector<std::string>& runs, size_t id) {
+        // One line per series and thread count, one point per run
+        std::map<std::string, std::vector<double>> series;
+        for (const bench::Result* result : benchmark.results) {
+            std::ostringstream name;
+            name << seriesName(*result) << ", " << result->threads << "T";
+            std::vector<double>& points = series[name.str()];
+            points.resize(runs.size(), -1.0);
+            const size_t run = std::find(runs.begin(), runs.end(), result->run) - runs.begin();
+            points[run] = bench::summarize(result->samplesMs).medianMs;
+        }
+
+        out << "        <div class=\"chart-container\"><canvas id=\"history" << id << "\"></canvas></div>\n"
+            << "        <script>\n"
+            << "        new Chart(document.getElementById('history" << id << "'), {\n"
+            << "            type: 'line',\n"
+            << "            data: {\n"
+            << "                labels: [";
+        for (size_t i = 0; i < runs.size(); i++) {
+            out << (i > 0 ? ", " : "") << jsString(runs[i]);
+        }
+        out << "],\n                datasets: [\n";
+        size_t color = 0;
+        for (const auto& line : series) {
+            out << "                { label: " << jsString(line.first) << ", borderColor: '"
+                << COLORS[color++ % COLOR_COUNT] << "', fill: false, spanGaps: true, data: [";
+            for (size_t i = 0; i < line.second.size(); i++) {
+                out << (i > 0 ? ", " : "");
+                if (line.second[i] < 0.0) {
+                    out << "null";
+                } else {
+                    out << line.second[i];
+                }
+            }
+            out << "] },\n";
+        }
+        out << "            ] },\n"
+            << "            options: {\n"
+            << "                maintainAspectRatio: false,\n"
+            << "                plugins: { title: { display: true, text: 'History' } },\n"
+            << "                scales: {\n"
+            << "                    x: { title: { display: true, text: 'Run' } },\n"
+            << "                    y: { title: { display: true, text: 'Median time (ms)' } }\n"
+            << "                }\n"
+            << "            }\n"
+            << "        });\n"
+            << "        </script>\n";
+    }
+
+    std::vector<bench::Result> m_results;
+    std::vector<Benchmark> m_benchmarks;
+};
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [-o dashboard.html] results.jsonl [more.jsonl ...]\n"
+              << "Merges results written with BENCH_RESULTS=<file> into one HTML dashboard." << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string output = "bench_dashboard.html";
+    std::vector<std::string> inputs;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if ((arg == "-o" || arg == "--output") && i + 1 < argc) {
+            output = argv[++i];
+        } else if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    if (inputs.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    Dashboard dashboard;
+    size_t total = 0;
+    for (const std::string& input : inputs) {
+        const std::vector<bench::Result> results = bench::loadResults(input);
+        if (results.empty()) {
+            std::cerr << "Warning: no results in " << input << std::endl;
+        }
+        total += results.size();
+        dashboard.add(results);
+    }
+    if (total == 0) {
+        std::cerr << "Error: no results to show" << std::endl;
+        return 1;
+    }
+    if (!dashboard.write(output)) {
+        return 1;
+    }
+    std::cout << "Dashboard with " << total << " results written to " << output << std::endl;
+    return 0;
+}